@@ -0,0 +1,399 @@
+/**
+ * @file adc_iio.c
+ * @brief IIO 子系統 ADC 後端實作
+ * @version 1.0.0
+ */
+
+#define _POSIX_C_SOURCE 200809L  // O_CLOEXEC, opendir
+
+#include "adc_iio.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <dirent.h>
+
+// ========================================
+// 內部狀態
+// ========================================
+
+struct adc_iio_buffer {
+    int fd;
+    int device;
+    int channel;
+    adc_iio_scan_type_t type;
+    size_t scan_bytes;    // 每個 scan 的位元組數 (只啟用單一通道)
+    uint8_t *raw;         // read() 暫存區
+    int capacity;         // 暫存區可容納的樣本數
+};
+
+// 根目錄只佔路徑的一半,其餘留給 iio:deviceN/屬性名稱
+static char sysfs_root[ADC_IIO_PATH_MAX / 2] = ADC_IIO_SYSFS_ROOT;
+static char dev_root[ADC_IIO_PATH_MAX / 2] = ADC_IIO_DEV_ROOT;
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+static int read_sysfs(const char *path, char *buffer, size_t size) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return GAMING_ERROR_IO;
+    }
+
+    ssize_t n = read(fd, buffer, size - 1);
+    close(fd);
+    if (n < 0) {
+        return GAMING_ERROR_IO;
+    }
+
+    buffer[n] = '\0';
+    buffer[strcspn(buffer, "\n")] = '\0';
+    return GAMING_OK;
+}
+
+static int write_sysfs(const char *path, const char *value) {
+    int fd = open(path, O_WRONLY | O_TRUNC | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "ADC IIO: Failed to open %s: %s\n", path, strerror(errno));
+        return GAMING_ERROR_IO;
+    }
+
+    ssize_t n = write(fd, value, strlen(value));
+    close(fd);
+    if (n != (ssize_t)strlen(value)) {
+        fprintf(stderr, "ADC IIO: Failed to write %s: %s\n", path, strerror(errno));
+        return GAMING_ERROR_IO;
+    }
+
+    return GAMING_OK;
+}
+
+static int write_sysfs_int(const char *path, int value) {
+    char text[16];
+    snprintf(text, sizeof(text), "%d", value);
+    return write_sysfs(path, text);
+}
+
+static void device_path(char *out, size_t size, int device, const char *attr) {
+    snprintf(out, size, "%s/iio:device%d/%s", sysfs_root, device, attr);
+}
+
+static void scan_path(char *out, size_t size, int device, int channel,
+                      const char *suffix) {
+    snprintf(out, size, "%s/iio:device%d/scan_elements/in_voltage%d_%s",
+             sysfs_root, device, channel, suffix);
+}
+
+/**
+ * @brief 停用 scan_elements 中除了指定通道以外的所有 *_en
+ */
+static void disable_other_scan_elements(int device, int channel) {
+    char dir_path[ADC_IIO_PATH_MAX];
+    char keep[32];
+
+    device_path(dir_path, sizeof(dir_path), device, "scan_elements");
+    snprintf(keep, sizeof(keep), "in_voltage%d_en", channel);
+
+    DIR *dir = opendir(dir_path);
+    if (dir == NULL) {
+        return;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        size_t len = strlen(entry->d_name);
+        if (len < 3 || strcmp(entry->d_name + len - 3, "_en") != 0 ||
+            strcmp(entry->d_name, keep) == 0) {
+            continue;
+        }
+
+        char path[ADC_IIO_PATH_MAX * 2 + 2];
+        snprintf(path, sizeof(path), "%s/%s", dir_path, entry->d_name);
+        write_sysfs(path, "0");
+    }
+
+    closedir(dir);
+}
+
+// ========================================
+// 公開函數實作
+// ========================================
+
+void adc_iio_set_roots(const char *sysfs, const char *dev) {
+    snprintf(sysfs_root, sizeof(sysfs_root), "%s", sysfs ? sysfs : ADC_IIO_SYSFS_ROOT);
+    snprintf(dev_root, sizeof(dev_root), "%s", dev ? dev : ADC_IIO_DEV_ROOT);
+}
+
+int adc_iio_find_device(const char *name) {
+    if (name == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    DIR *dir = opendir(sysfs_root);
+    if (dir == NULL) {
+        return GAMING_ERROR_NOT_FOUND;
+    }
+
+    int found = GAMING_ERROR_NOT_FOUND;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        int device;
+        if (sscanf(entry->d_name, "iio:device%d", &device) != 1) {
+            continue;
+        }
+
+        char path[ADC_IIO_PATH_MAX];
+        char value[64];
+        device_path(path, sizeof(path), device, "name");
+        if (read_sysfs(path, value, sizeof(value)) == GAMING_OK &&
+            strcmp(value, name) == 0) {
+            found = device;
+            break;
+        }
+    }
+
+    closedir(dir);
+    return found;
+}
+
+int adc_iio_read_raw(int device, int channel) {
+    if (device < 0 || channel < 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    char path[ADC_IIO_PATH_MAX];
+    char attr[32];
+    char value[32];
+
+    snprintf(attr, sizeof(attr), "in_voltage%d_raw", channel);
+    device_path(path, sizeof(path), device, attr);
+
+    if (read_sysfs(path, value, sizeof(value)) != GAMING_OK) {
+        fprintf(stderr, "ADC IIO: Failed to read %s: %s\n", path, strerror(errno));
+        return GAMING_ERROR_IO;
+    }
+
+    char *end;
+    long raw = strtol(value, &end, 10);
+    if (end == value || raw < 0) {
+        return GAMING_ERROR_IO;
+    }
+
+    return (int)raw;
+}
+
+int adc_iio_parse_type(const char *text, adc_iio_scan_type_t *type) {
+    if (text == NULL || type == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    char endian[3];
+    char sign;
+    unsigned int realbits, storagebits, shift = 0;
+    int consumed = 0;
+
+    // 格式: [be|le]:[s|u]bits/storagebits[Xrepeat]>>shift
+    if (sscanf(text, "%2[bel]:%c%u/%u%n", endian, &sign, &realbits,
+               &storagebits, &consumed) != 4) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    const char *rest = strstr(text + consumed, ">>");
+    if (rest != NULL && sscanf(rest, ">>%u", &shift) != 1) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    if ((strcmp(endian, "be") != 0 && strcmp(endian, "le") != 0) ||
+        (sign != 's' && sign != 'u') ||
+        (storagebits != 8 && storagebits != 16 && storagebits != 32) ||
+        realbits == 0 || realbits > storagebits || shift >= storagebits) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    type->big_endian = (endian[0] == 'b');
+    type->is_signed = (sign == 's');
+    type->realbits = (uint8_t)realbits;
+    type->storagebits = (uint8_t)storagebits;
+    type->shift = (uint8_t)shift;
+
+    return GAMING_OK;
+}
+
+int adc_iio_decode_sample(const adc_iio_scan_type_t *type, const uint8_t *data) {
+    int bytes = type->storagebits / 8;
+    uint32_t value = 0;
+
+    for (int i = 0; i < bytes; i++) {
+        int index = type->big_endian ? i : bytes - 1 - i;
+        value = (value << 8) | data[index];
+    }
+
+    value >>= type->shift;
+    if (type->realbits < 32) {
+        value &= (1u << type->realbits) - 1;
+    }
+
+    if (type->is_signed && type->realbits < 32 &&
+        (value & (1u << (type->realbits - 1)))) {
+        return (int)value - (int)(1u << type->realbits);
+    }
+
+    return (int)value;
+}
+
+adc_iio_buffer_t* adc_iio_buffer_open(const adc_iio_buffer_config_t *config) {
+    if (config == NULL || config->device < 0 || config->channel < 0 ||
+        config->buffer_length < 0 || config->watermark < 0) {
+        return NULL;
+    }
+
+    int device = config->device;
+    int length = config->buffer_length ? config->buffer_length
+                                       : ADC_IIO_DEFAULT_BUFFER_LENGTH;
+    char path[ADC_IIO_PATH_MAX];
+    char value[64];
+
+    // 變更 scan elements 前必須先停用緩衝
+    device_path(path, sizeof(path), device, "buffer/enable");
+    if (write_sysfs(path, "0") != GAMING_OK) {
+        return NULL;
+    }
+
+    scan_path(path, sizeof(path), device, config->channel, "type");
+    adc_iio_scan_type_t type;
+    if (read_sysfs(path, value, sizeof(value)) != GAMING_OK ||
+        adc_iio_parse_type(value, &type) != GAMING_OK) {
+        fprintf(stderr, "ADC IIO: Unsupported scan type for channel %d\n",
+                config->channel);
+        return NULL;
+    }
+
+    // 只留下指定通道,每個 scan 就是單一樣本、沒有對齊間隙
+    disable_other_scan_elements(device, config->channel);
+    scan_path(path, sizeof(path), device, config->channel, "en");
+    if (write_sysfs(path, "1") != GAMING_OK) {
+        return NULL;
+    }
+
+    device_path(path, sizeof(path), device, "buffer/length");
+    if (write_sysfs_int(path, length) != GAMING_OK) {
+        return NULL;
+    }
+
+    if (config->watermark > 0) {
+        device_path(path, sizeof(path), device, "buffer/watermark");
+        write_sysfs_int(path, config->watermark);
+    }
+
+    adc_iio_buffer_t *buffer = calloc(1, sizeof(*buffer));
+    if (buffer == NULL) {
+        return NULL;
+    }
+
+    buffer->fd = -1;
+    buffer->device = device;
+    buffer->channel = config->channel;
+    buffer->type = type;
+    buffer->scan_bytes = type.storagebits / 8;
+    buffer->capacity = length;
+    buffer->raw = malloc((size_t)length * buffer->scan_bytes);
+    if (buffer->raw == NULL) {
+        free(buffer);
+        return NULL;
+    }
+
+    device_path(path, sizeof(path), device, "buffer/enable");
+    if (write_sysfs(path, "1") != GAMING_OK) {
+        adc_iio_buffer_close(buffer);
+        return NULL;
+    }
+
+    snprintf(path, sizeof(path), "%s/iio:device%d", dev_root, device);
+    buffer->fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (buffer->fd < 0) {
+        fprintf(stderr, "ADC IIO: Failed to open %s: %s\n", path, strerror(errno));
+        adc_iio_buffer_close(buffer);
+        return NULL;
+    }
+
+    #ifdef DEBUG
+    printf("ADC IIO: buffer open on iio:device%d channel %d (length=%d, %u-bit)\n",
+           device, config->channel, length, type.storagebits);
+    #endif
+
+    return buffer;
+}
+
+int adc_iio_buffer_read(adc_iio_buffer_t *buffer, int *samples, int max_samples,
+                        int timeout_ms) {
+    if (buffer == NULL || samples == NULL || max_samples <= 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    int want = (max_samples < buffer->capacity) ? max_samples : buffer->capacity;
+    size_t size = (size_t)want * buffer->scan_bytes;
+    ssize_t n;
+
+    for (;;) {
+        n = read(buffer->fd, buffer->raw, size);
+        if (n >= 0) {
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN) {
+            fprintf(stderr, "ADC IIO: Failed to read buffer: %s\n", strerror(errno));
+            return GAMING_ERROR_IO;
+        }
+        if (timeout_ms == 0) {
+            return 0;
+        }
+
+        // kfifo 為空: 等到達到 watermark 或逾時
+        struct pollfd pfd = { .fd = buffer->fd, .events = POLLIN };
+        int ret = poll(&pfd, 1, timeout_ms);
+        if (ret == 0) {
+            return 0;
+        }
+        if (ret < 0 && errno != EINTR) {
+            return GAMING_ERROR_IO;
+        }
+    }
+
+    int count = (int)((size_t)n / buffer->scan_bytes);
+    for (int i = 0; i < count; i++) {
+        samples[i] = adc_iio_decode_sample(&buffer->type,
+                                           buffer->raw + (size_t)i * buffer->scan_bytes);
+    }
+
+    return count;
+}
+
+const adc_iio_scan_type_t* adc_iio_buffer_get_type(const adc_iio_buffer_t *buffer) {
+    return buffer ? &buffer->type : NULL;
+}
+
+void adc_iio_buffer_close(adc_iio_buffer_t *buffer) {
+    if (buffer == NULL) {
+        return;
+    }
+
+    char path[ADC_IIO_PATH_MAX];
+
+    if (buffer->fd >= 0) {
+        close(buffer->fd);
+    }
+
+    device_path(path, sizeof(path), buffer->device, "buffer/enable");
+    write_sysfs(path, "0");
+    scan_path(path, sizeof(path), buffer->device, buffer->channel, "en");
+    write_sysfs(path, "0");
+
+    free(buffer->raw);
+    free(buffer);
+}
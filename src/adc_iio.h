@@ -0,0 +1,152 @@
+/**
+ * @file adc_iio.h
+ * @brief IIO 子系統 ADC 後端
+ * @version 1.0.0
+ *
+ * 主線核心的 ADC 驅動透過 IIO 子系統提供兩種介面:
+ * - sysfs: /sys/bus/iio/devices/iio:deviceN/in_voltageX_raw (單次讀取)
+ * - 緩衝字元裝置: /dev/iio:deviceN (觸發式連續取樣,資料經 kfifo 緩衝)
+ *
+ * 單次讀取使用 sysfs;連續取樣時啟用 scan_elements 與緩衝,
+ * 一次 read() 即可取回數百個樣本,而不是每個樣本一次系統呼叫。
+ *
+ * 緩衝模式需要裝置已綁定觸發器 (trigger/current_trigger),
+ * 或驅動本身支援無觸發器的緩衝模式
+ */
+
+#ifndef ADC_IIO_H
+#define ADC_IIO_H
+
+#include "gaming_common.h"
+
+// ========================================
+// IIO 配置
+// ========================================
+
+// 預設 sysfs 與字元裝置根目錄 (測試時可改為假的目錄樹)
+#define ADC_IIO_SYSFS_ROOT      "/sys/bus/iio/devices"
+#define ADC_IIO_DEV_ROOT        "/dev"
+
+// 預設 kfifo 長度 (樣本數)
+#define ADC_IIO_DEFAULT_BUFFER_LENGTH 256
+
+// 路徑長度上限
+#define ADC_IIO_PATH_MAX        256
+
+// ========================================
+// 資料格式
+// ========================================
+
+/**
+ * @brief scan_elements/in_voltageX_type 描述的樣本格式
+ *
+ * 例如 "le:u12/16>>4": little-endian, 無號, 12 個有效位元,
+ * 儲存為 16 位元, 右移 4 位元
+ */
+typedef struct {
+    bool big_endian;
+    bool is_signed;
+    uint8_t realbits;
+    uint8_t storagebits;
+    uint8_t shift;
+} adc_iio_scan_type_t;
+
+typedef struct {
+    int device;          ///< iio:deviceN 的 N
+    int channel;         ///< in_voltageX 的 X
+    int buffer_length;   ///< kfifo 長度,0 則使用 ADC_IIO_DEFAULT_BUFFER_LENGTH
+    int watermark;       ///< 喚醒 poll 的樣本數門檻,0 則不設定
+} adc_iio_buffer_config_t;
+
+typedef struct adc_iio_buffer adc_iio_buffer_t;
+
+// ========================================
+// IIO 公開函數
+// ========================================
+
+/**
+ * @brief 設定 sysfs 與字元裝置根目錄
+ *
+ * @param sysfs_root sysfs 根目錄,NULL 則恢復 ADC_IIO_SYSFS_ROOT
+ * @param dev_root 字元裝置根目錄,NULL 則恢復 ADC_IIO_DEV_ROOT
+ */
+void adc_iio_set_roots(const char *sysfs_root, const char *dev_root);
+
+/**
+ * @brief 依名稱尋找 IIO 裝置
+ *
+ * @param name 裝置名稱 (iio:deviceN/name 的內容)
+ * @return >= 0 裝置編號
+ * @return GAMING_ERROR_NOT_FOUND 找不到
+ */
+int adc_iio_find_device(const char *name);
+
+/**
+ * @brief 經由 sysfs 單次讀取原始值
+ *
+ * @param device 裝置編號
+ * @param channel 通道編號
+ * @return >= 0 原始值
+ * @return GAMING_ERROR_IO 讀取失敗
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ */
+int adc_iio_read_raw(int device, int channel);
+
+/**
+ * @brief 解析 scan_elements 的 type 字串
+ *
+ * @param text 例如 "le:u12/16>>4"
+ * @param type 輸出格式
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 格式錯誤
+ */
+int adc_iio_parse_type(const char *text, adc_iio_scan_type_t *type);
+
+/**
+ * @brief 將緩衝區中的一個樣本轉為整數
+ *
+ * @param type 樣本格式
+ * @param data 樣本起始位址 (storagebits / 8 bytes)
+ * @return 樣本值
+ */
+int adc_iio_decode_sample(const adc_iio_scan_type_t *type, const uint8_t *data);
+
+/**
+ * @brief 開啟緩衝模式
+ *
+ * 只啟用指定通道的 scan element (其他通道含 timestamp 一律停用),
+ * 設定 kfifo 長度後啟用緩衝,再開啟 /dev/iio:deviceN
+ *
+ * @param config 緩衝配置
+ * @return 緩衝控制代碼, NULL 表示失敗
+ */
+adc_iio_buffer_t* adc_iio_buffer_open(const adc_iio_buffer_config_t *config);
+
+/**
+ * @brief 讀取緩衝中的樣本
+ *
+ * 一次 read() 取回 kfifo 中所有可用樣本 (最多 max_samples 個)
+ *
+ * @param buffer 緩衝控制代碼
+ * @param samples 輸出樣本陣列
+ * @param max_samples 陣列大小
+ * @param timeout_ms 沒有資料時等待的毫秒數,0 不等待,< 0 無限等待
+ * @return > 0 取得的樣本數
+ * @return 0 逾時沒有資料
+ * @return GAMING_ERROR_IO 讀取失敗
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ */
+int adc_iio_buffer_read(adc_iio_buffer_t *buffer, int *samples, int max_samples,
+                        int timeout_ms);
+
+/**
+ * @brief 取得緩衝的樣本格式
+ */
+const adc_iio_scan_type_t* adc_iio_buffer_get_type(const adc_iio_buffer_t *buffer);
+
+/**
+ * @brief 停用緩衝並釋放資源
+ */
+void adc_iio_buffer_close(adc_iio_buffer_t *buffer);
+
+#endif // ADC_IIO_H
@@ -0,0 +1,397 @@
+/**
+ * @file adc_monitor.c
+ * @brief ADC 連續監測實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE  // eventfd
+
+#include "adc_monitor.h"
+#include "hal_interface.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+// ========================================
+// 內部狀態
+// ========================================
+
+// 每個 slot 以序號保護: 寫入中為奇數,寫完為 2n+2 (n 為樣本編號)
+// 欄位皆為 32 位元,在 32 位元 MIPS 上也能原生原子存取
+typedef struct {
+    uint32_t seq;
+    int32_t value;
+    uint32_t ts_lo;
+    uint32_t ts_hi;
+} adc_slot_t;
+
+typedef struct {
+    int threshold;
+    int hysteresis;
+    int state;           // -1 未知, 0 低於, 1 高於 (只有取樣執行緒存取)
+    adc_monitor_cb_t callback;
+    void *user_data;
+} adc_threshold_t;
+
+struct adc_monitor {
+    char device[128];
+    int interval_ms;
+    adc_monitor_read_fn read;
+    void *read_user_data;
+
+    adc_slot_t *slots;
+    uint32_t mask;
+    uint32_t head;       // 已寫入的樣本數 (只有取樣執行緒寫入)
+    uint32_t samples;
+    uint32_t errors;
+
+    adc_threshold_t thresholds[ADC_MONITOR_MAX_THRESHOLDS];
+    int threshold_count;
+
+    int running;
+    int wake_fd;
+    pthread_t thread;
+};
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+static uint32_t round_up_pow2(uint32_t v) {
+    uint32_t n = 1;
+    while (n < v) {
+        n <<= 1;
+    }
+    return n;
+}
+
+static int hal_read(const char *device, void *user_data) {
+    (void)user_data;
+    if (hal_ops == NULL || hal_ops->adc_read == NULL) {
+        return -1;
+    }
+    return hal_ops->adc_read(device);
+}
+
+static void publish_sample(adc_monitor_t *monitor, const adc_sample_t *sample) {
+    uint32_t n = monitor->head;
+    adc_slot_t *slot = &monitor->slots[n & monitor->mask];
+
+    __atomic_store_n(&slot->seq, 2 * n + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&slot->value, sample->value, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->ts_lo, (uint32_t)sample->timestamp_ms, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->ts_hi, (uint32_t)(sample->timestamp_ms >> 32), __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->seq, 2 * n + 2, __ATOMIC_RELEASE);
+
+    __atomic_store_n(&monitor->head, n + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief 讀取第 n 個樣本
+ * @return true 讀到一致的內容, false 該 slot 已被覆寫或尚未寫完
+ */
+static bool read_slot(const adc_monitor_t *monitor, uint32_t n, adc_sample_t *out) {
+    const adc_slot_t *slot = &monitor->slots[n & monitor->mask];
+    uint32_t expected = 2 * n + 2;
+
+    if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != expected) {
+        return false;
+    }
+
+    int32_t value = __atomic_load_n(&slot->value, __ATOMIC_RELAXED);
+    uint32_t lo = __atomic_load_n(&slot->ts_lo, __ATOMIC_RELAXED);
+    uint32_t hi = __atomic_load_n(&slot->ts_hi, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != expected) {
+        return false;
+    }
+
+    out->value = value;
+    out->timestamp_ms = ((uint64_t)hi << 32) | lo;
+    return true;
+}
+
+static void check_thresholds(adc_monitor_t *monitor, const adc_sample_t *sample) {
+    for (int i = 0; i < monitor->threshold_count; i++) {
+        adc_threshold_t *t = &monitor->thresholds[i];
+
+        if (t->state < 0) {
+            t->state = (sample->value >= t->threshold) ? 1 : 0;
+        } else if (t->state == 0 && sample->value >= t->threshold + t->hysteresis) {
+            t->state = 1;
+            t->callback(t->threshold, ADC_CROSS_RISING, sample, t->user_data);
+        } else if (t->state == 1 && sample->value < t->threshold - t->hysteresis) {
+            t->state = 0;
+            t->callback(t->threshold, ADC_CROSS_FALLING, sample, t->user_data);
+        }
+    }
+}
+
+static void *monitor_main(void *arg) {
+    adc_monitor_t *monitor = arg;
+    uint64_t next_ms = now_ms();
+
+    while (__atomic_load_n(&monitor->running, __ATOMIC_ACQUIRE)) {
+        int value = monitor->read(monitor->device, monitor->read_user_data);
+        uint64_t now = now_ms();
+
+        if (value >= 0) {
+            adc_sample_t sample = { .timestamp_ms = now, .value = value };
+            publish_sample(monitor, &sample);
+            __atomic_store_n(&monitor->samples, monitor->samples + 1, __ATOMIC_RELAXED);
+            check_thresholds(monitor, &sample);
+        } else {
+            __atomic_store_n(&monitor->errors, monitor->errors + 1, __ATOMIC_RELAXED);
+        }
+
+        // 以絕對時間排程,避免取樣耗時累積成頻率漂移;落後時不補取樣
+        next_ms += (uint64_t)monitor->interval_ms;
+        if (next_ms < now) {
+            next_ms = now;
+        }
+
+        struct pollfd pfd = { .fd = monitor->wake_fd, .events = POLLIN };
+        if (poll(&pfd, 1, (int)(next_ms - now)) > 0) {
+            uint64_t event;
+            if (read(monitor->wake_fd, &event, sizeof(event)) < 0 && errno != EAGAIN) {
+                fprintf(stderr, "ADC monitor: Failed to read wake event\n");
+            }
+        }
+    }
+
+    return NULL;
+}
+
+// ========================================
+// 公開函數實作
+// ========================================
+
+adc_monitor_t* adc_monitor_create(const adc_monitor_config_t *config) {
+    adc_monitor_config_t defaults = { 0 };
+    if (config == NULL) {
+        config = &defaults;
+    }
+
+    if (config->interval_ms < 0 || config->ring_size > ADC_MONITOR_MAX_RING_SIZE) {
+        return NULL;
+    }
+
+    adc_monitor_t *monitor = calloc(1, sizeof(*monitor));
+    if (monitor == NULL) {
+        return NULL;
+    }
+
+    uint32_t size = round_up_pow2(config->ring_size ? config->ring_size
+                                                    : ADC_MONITOR_DEFAULT_RING_SIZE);
+    monitor->slots = calloc(size, sizeof(adc_slot_t));
+    if (monitor->slots == NULL) {
+        free(monitor);
+        return NULL;
+    }
+
+    snprintf(monitor->device, sizeof(monitor->device), "%s",
+             config->device ? config->device : DEVICE_ADC);
+    monitor->interval_ms = config->interval_ms ? config->interval_ms
+                                               : ADC_MONITOR_DEFAULT_INTERVAL_MS;
+    monitor->read = config->read ? config->read : hal_read;
+    monitor->read_user_data = config->read_user_data;
+    monitor->mask = size - 1;
+    monitor->wake_fd = -1;
+
+    return monitor;
+}
+
+void adc_monitor_destroy(adc_monitor_t *monitor) {
+    if (monitor == NULL) {
+        return;
+    }
+
+    adc_monitor_stop(monitor);
+    free(monitor->slots);
+    free(monitor);
+}
+
+int adc_monitor_add_threshold(adc_monitor_t *monitor, int threshold, int hysteresis,
+                              adc_monitor_cb_t callback, void *user_data) {
+    if (monitor == NULL || callback == NULL || hysteresis < 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    if (__atomic_load_n(&monitor->running, __ATOMIC_ACQUIRE)) {
+        return GAMING_ERROR_ALREADY_EXISTS;
+    }
+    if (monitor->threshold_count >= ADC_MONITOR_MAX_THRESHOLDS) {
+        return GAMING_ERROR_NO_MEMORY;
+    }
+
+    adc_threshold_t *t = &monitor->thresholds[monitor->threshold_count++];
+    t->threshold = threshold;
+    t->hysteresis = hysteresis;
+    t->state = -1;
+    t->callback = callback;
+    t->user_data = user_data;
+
+    return GAMING_OK;
+}
+
+int adc_monitor_start(adc_monitor_t *monitor) {
+    if (monitor == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    if (__atomic_load_n(&monitor->running, __ATOMIC_ACQUIRE)) {
+        return GAMING_ERROR_ALREADY_EXISTS;
+    }
+    if (monitor->read == hal_read && hal_ops == NULL) {
+        fprintf(stderr, "ADC monitor: HAL not initialized\n");
+        return GAMING_ERROR_NOT_INITIALIZED;
+    }
+
+    monitor->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (monitor->wake_fd < 0) {
+        fprintf(stderr, "ADC monitor: eventfd failed: %s\n", strerror(errno));
+        return GAMING_ERROR;
+    }
+
+    // 重新啟動時由第一個樣本重新決定閾值狀態
+    for (int i = 0; i < monitor->threshold_count; i++) {
+        monitor->thresholds[i].state = -1;
+    }
+
+    __atomic_store_n(&monitor->running, 1, __ATOMIC_RELEASE);
+
+    int ret = pthread_create(&monitor->thread, NULL, monitor_main, monitor);
+    if (ret != 0) {
+        fprintf(stderr, "ADC monitor: pthread_create failed: %s\n", strerror(ret));
+        __atomic_store_n(&monitor->running, 0, __ATOMIC_RELEASE);
+        close(monitor->wake_fd);
+        monitor->wake_fd = -1;
+        return GAMING_ERROR;
+    }
+
+    #ifdef DEBUG
+    printf("ADC monitor started: %s every %d ms (ring=%u)\n",
+           monitor->device, monitor->interval_ms, monitor->mask + 1);
+    #endif
+
+    return GAMING_OK;
+}
+
+void adc_monitor_stop(adc_monitor_t *monitor) {
+    if (monitor == NULL || !__atomic_load_n(&monitor->running, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    __atomic_store_n(&monitor->running, 0, __ATOMIC_RELEASE);
+
+    uint64_t one = 1;
+    if (write(monitor->wake_fd, &one, sizeof(one)) < 0) {
+        fprintf(stderr, "ADC monitor: Failed to wake thread for stop\n");
+    }
+    pthread_join(monitor->thread, NULL);
+
+    close(monitor->wake_fd);
+    monitor->wake_fd = -1;
+}
+
+int adc_monitor_latest(const adc_monitor_t *monitor, adc_sample_t *sample) {
+    if (monitor == NULL || sample == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint32_t head = __atomic_load_n(&monitor->head, __ATOMIC_ACQUIRE);
+    if (head == 0 || !read_slot(monitor, head - 1, sample)) {
+        return GAMING_ERROR_NOT_FOUND;
+    }
+
+    return GAMING_OK;
+}
+
+int adc_monitor_snapshot(const adc_monitor_t *monitor, adc_sample_t *samples,
+                         int max_samples) {
+    if (monitor == NULL || samples == NULL || max_samples < 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint32_t head = __atomic_load_n(&monitor->head, __ATOMIC_ACQUIRE);
+    uint32_t available = (head < monitor->mask + 1) ? head : monitor->mask + 1;
+    uint32_t want = ((uint32_t)max_samples < available) ? (uint32_t)max_samples : available;
+
+    // 最舊的 slot 可能在複製期間被覆寫,略過即可
+    int count = 0;
+    for (uint32_t n = head - want; n != head; n++) {
+        if (read_slot(monitor, n, &samples[count])) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+int adc_monitor_get_stats(const adc_monitor_t *monitor, int window,
+                          adc_monitor_stats_t *stats) {
+    if (monitor == NULL || stats == NULL || window < 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint32_t head = __atomic_load_n(&monitor->head, __ATOMIC_ACQUIRE);
+    uint32_t available = (head < monitor->mask + 1) ? head : monitor->mask + 1;
+    uint32_t want = (window > 0 && (uint32_t)window < available) ? (uint32_t)window
+                                                                  : available;
+
+    memset(stats, 0, sizeof(*stats));
+    long long sum = 0;
+
+    for (uint32_t n = head - want; n != head; n++) {
+        adc_sample_t sample;
+        if (!read_slot(monitor, n, &sample)) {
+            continue;
+        }
+
+        if (stats->count == 0) {
+            stats->min = stats->max = sample.value;
+            stats->first_ms = sample.timestamp_ms;
+        }
+        if (sample.value < stats->min) {
+            stats->min = sample.value;
+        }
+        if (sample.value > stats->max) {
+            stats->max = sample.value;
+        }
+        stats->last_ms = sample.timestamp_ms;
+        sum += sample.value;
+        stats->count++;
+    }
+
+    if (stats->count == 0) {
+        return GAMING_ERROR_NOT_FOUND;
+    }
+
+    stats->mean = (int)((sum + stats->count / 2) / stats->count);
+    return GAMING_OK;
+}
+
+void adc_monitor_get_counters(const adc_monitor_t *monitor, uint32_t *samples,
+                              uint32_t *errors) {
+    if (monitor == NULL) {
+        return;
+    }
+    if (samples != NULL) {
+        *samples = __atomic_load_n(&monitor->samples, __ATOMIC_RELAXED);
+    }
+    if (errors != NULL) {
+        *errors = __atomic_load_n(&monitor->errors, __ATOMIC_RELAXED);
+    }
+}
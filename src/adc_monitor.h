@@ -0,0 +1,171 @@
+/**
+ * @file adc_monitor.h
+ * @brief ADC 連續監測 - 背景取樣執行緒
+ * @version 1.0.0
+ *
+ * 以固定頻率在背景執行緒取樣 (例如電源或配件電壓),
+ * 樣本連同時間戳記寫入無鎖環形緩衝區。
+ *
+ * - 取樣執行緒是唯一寫入者,讀取端以 per-slot 序號驗證取得一致的
+ *   快照,讀取不會阻塞取樣,取樣也不會等待讀取端
+ * - 越過閾值 (含遲滯區間) 時在取樣執行緒中呼叫回呼
+ * - 最近 N 個樣本的 min/max/mean 在讀取端依快照計算
+ */
+
+#ifndef ADC_MONITOR_H
+#define ADC_MONITOR_H
+
+#include "gaming_common.h"
+
+// ========================================
+// ADC Monitor 配置
+// ========================================
+
+// 預設取樣間隔
+#define ADC_MONITOR_DEFAULT_INTERVAL_MS 100
+
+// 預設環形緩衝區大小 (會向上取整為 2 的冪次)
+#define ADC_MONITOR_DEFAULT_RING_SIZE   256
+
+// 環形緩衝區大小上限
+#define ADC_MONITOR_MAX_RING_SIZE       65536
+
+// 每個監測器的閾值數量上限
+#define ADC_MONITOR_MAX_THRESHOLDS      8
+
+/**
+ * @brief 取樣函數
+ *
+ * @param device 設備路徑
+ * @param user_data 呼叫端資料
+ * @return >= 0 樣本值, < 0 讀取失敗
+ */
+typedef int (*adc_monitor_read_fn)(const char *device, void *user_data);
+
+typedef struct {
+    const char *device;          ///< ADC 設備路徑,NULL 則使用 DEVICE_ADC
+    int interval_ms;             ///< 取樣間隔,0 則使用 ADC_MONITOR_DEFAULT_INTERVAL_MS
+    unsigned int ring_size;      ///< 緩衝樣本數,0 則使用 ADC_MONITOR_DEFAULT_RING_SIZE
+    adc_monitor_read_fn read;    ///< 取樣函數,NULL 則使用 hal_ops->adc_read
+    void *read_user_data;        ///< 傳給取樣函數的資料
+} adc_monitor_config_t;
+
+typedef struct {
+    uint64_t timestamp_ms;       ///< CLOCK_MONOTONIC 毫秒
+    int value;                   ///< ADC 值
+} adc_sample_t;
+
+typedef struct {
+    int count;                   ///< 視窗內的樣本數
+    int min;
+    int max;
+    int mean;                    ///< 四捨五入的整數平均
+    uint64_t first_ms;           ///< 視窗內最舊樣本的時間
+    uint64_t last_ms;            ///< 視窗內最新樣本的時間
+} adc_monitor_stats_t;
+
+typedef enum {
+    ADC_CROSS_RISING = 0,        ///< 由下往上越過 threshold + hysteresis
+    ADC_CROSS_FALLING            ///< 由上往下越過 threshold - hysteresis
+} adc_cross_t;
+
+/**
+ * @brief 閾值回呼 (在取樣執行緒中執行,應盡快返回)
+ *
+ * @param threshold 觸發的閾值
+ * @param direction 越過方向
+ * @param sample 觸發的樣本
+ * @param user_data 註冊時提供的資料
+ */
+typedef void (*adc_monitor_cb_t)(int threshold, adc_cross_t direction,
+                                 const adc_sample_t *sample, void *user_data);
+
+typedef struct adc_monitor adc_monitor_t;
+
+// ========================================
+// ADC Monitor 公開函數
+// ========================================
+
+/**
+ * @brief 建立監測器 (尚未開始取樣)
+ *
+ * @param config 配置,NULL 則全部使用預設值
+ * @return 監測器, NULL 表示參數錯誤或記憶體不足
+ */
+adc_monitor_t* adc_monitor_create(const adc_monitor_config_t *config);
+
+/**
+ * @brief 停止並釋放監測器
+ */
+void adc_monitor_destroy(adc_monitor_t *monitor);
+
+/**
+ * @brief 註冊閾值回呼
+ *
+ * 必須在 adc_monitor_start() 之前註冊。
+ * 第一個樣本只用來決定初始狀態,不會觸發回呼
+ *
+ * @param threshold 閾值
+ * @param hysteresis 遲滯區間 (>= 0)
+ * @param callback 回呼
+ * @param user_data 呼叫端資料
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_NO_MEMORY 已達 ADC_MONITOR_MAX_THRESHOLDS
+ * @return GAMING_ERROR_ALREADY_EXISTS 監測器已在執行
+ */
+int adc_monitor_add_threshold(adc_monitor_t *monitor, int threshold, int hysteresis,
+                              adc_monitor_cb_t callback, void *user_data);
+
+/**
+ * @brief 開始背景取樣
+ *
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_ALREADY_EXISTS 已在執行
+ * @return GAMING_ERROR_NOT_INITIALIZED 沒有取樣函數且 HAL 未初始化
+ * @return GAMING_ERROR 建立執行緒失敗
+ */
+int adc_monitor_start(adc_monitor_t *monitor);
+
+/**
+ * @brief 停止背景取樣 (緩衝區內容保留)
+ */
+void adc_monitor_stop(adc_monitor_t *monitor);
+
+/**
+ * @brief 取得最新的樣本
+ *
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_FOUND 尚無樣本
+ */
+int adc_monitor_latest(const adc_monitor_t *monitor, adc_sample_t *sample);
+
+/**
+ * @brief 複製最近的樣本 (舊 → 新)
+ *
+ * @param samples 輸出陣列
+ * @param max_samples 最多複製的樣本數
+ * @return >= 0 複製的樣本數
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ */
+int adc_monitor_snapshot(const adc_monitor_t *monitor, adc_sample_t *samples,
+                         int max_samples);
+
+/**
+ * @brief 計算最近 window 個樣本的統計
+ *
+ * @param window 視窗大小 (樣本數),0 則使用整個緩衝區
+ * @param stats 輸出統計
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_FOUND 尚無樣本
+ */
+int adc_monitor_get_stats(const adc_monitor_t *monitor, int window,
+                          adc_monitor_stats_t *stats);
+
+/**
+ * @brief 取得累計取樣數與讀取失敗數
+ */
+void adc_monitor_get_counters(const adc_monitor_t *monitor, uint32_t *samples,
+                              uint32_t *errors);
+
+#endif // ADC_MONITOR_H
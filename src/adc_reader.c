@@ -5,8 +5,10 @@
  */
 
 #include "adc_reader.h"
+#include "config_parser.h"
 #include "hal_interface.h"
-#include <stdio.h>
+#include "logger.h"
+#include <stdlib.h>
 #include <string.h>
 
 // ========================================
@@ -19,6 +21,24 @@ static bool adc_reader_initialized = false;
 // 快取的裝置類型
 static device_type_t cached_device_type = DEVICE_TYPE_UNKNOWN;
 
+// 預設值與舊版行為相同: 單次讀取、無遲滯
+static const adc_reader_config_t default_config = {
+    .device = DEVICE_ADC,
+    .threshold = ADC_THRESHOLD_CLIENT_SERVER,
+    .hysteresis = 0,
+    .samples = 1,
+    .filter = ADC_FILTER_MEDIAN,
+};
+
+// 目前的取樣與判定參數
+static adc_reader_config_t adc_config = {
+    .device = DEVICE_ADC,
+    .threshold = ADC_THRESHOLD_CLIENT_SERVER,
+    .hysteresis = 0,
+    .samples = 1,
+    .filter = ADC_FILTER_MEDIAN,
+};
+
 // ========================================
 // 內部函數
 // ========================================
@@ -32,21 +52,78 @@ static bool is_initialized(void) {
     return adc_reader_initialized;
 }
 
+/**
+ * @brief 小陣列插入排序 (樣本數 <= ADC_READER_MAX_SAMPLES)
+ */
+static void sort_samples(int *samples, int count) {
+    for (int i = 1; i < count; i++) {
+        int value = samples[i];
+        int j = i - 1;
+        while (j >= 0 && samples[j] > value) {
+            samples[j + 1] = samples[j];
+            j--;
+        }
+        samples[j + 1] = value;
+    }
+}
+
+/**
+ * @brief 解析非負整數選項
+ * @return >= 0 數值, -1 格式錯誤
+ */
+static int parse_option_int(const char *value) {
+    char *end;
+    long n = strtol(value, &end, 10);
+    if (end == value || *end != '\0' || n < 0 || n > 65535) {
+        return -1;
+    }
+    return (int)n;
+}
+
+/**
+ * @brief UCI 選項回呼 (gaming.hardware)
+ */
+static void load_adc_option(const char *option, const char *value, void *user_data) {
+    adc_reader_config_t *config = user_data;
+    int n;
+
+    if (strcmp(option, UCI_OPTION_ADC_DEVICE) == 0) {
+        strncpy(config->device, value, sizeof(config->device) - 1);
+        config->device[sizeof(config->device) - 1] = '\0';
+    } else if (strcmp(option, UCI_OPTION_ADC_THRESHOLD) == 0) {
+        if ((n = parse_option_int(value)) >= 0) {
+            config->threshold = n;
+        }
+    } else if (strcmp(option, UCI_OPTION_ADC_HYSTERESIS) == 0) {
+        if ((n = parse_option_int(value)) >= 0) {
+            config->hysteresis = n;
+        }
+    } else if (strcmp(option, UCI_OPTION_ADC_SAMPLES) == 0) {
+        if ((n = parse_option_int(value)) >= 1 && n <= ADC_READER_MAX_SAMPLES) {
+            config->samples = n;
+        }
+    } else if (strcmp(option, UCI_OPTION_ADC_FILTER) == 0) {
+        if (strcmp(value, "median") == 0) {
+            config->filter = ADC_FILTER_MEDIAN;
+        } else if (strcmp(value, "mean") == 0) {
+            config->filter = ADC_FILTER_TRIMMED_MEAN;
+        }
+    }
+}
+
 // ========================================
 // 公開函數實作
 // ========================================
 
 int adc_reader_init(void) {
     if (is_initialized()) {
-        #ifdef DEBUG
-        printf("[ADC Reader] Already initialized\n");
-        #endif
+        logger_mod(LOG_MODULE_ADC, LOG_LEVEL_DEBUG, "Already initialized");
         return GAMING_OK;
     }
 
     // 檢查 HAL 是否可用
     if (hal_ops == NULL) {
-        fprintf(stderr, "[ADC Reader] HAL not initialized\n");
+        logger_mod(LOG_MODULE_ADC, LOG_LEVEL_ERROR, "HAL not initialized");
         return GAMING_ERROR_HAL_FAILED;
     }
 
@@ -54,9 +131,11 @@ int adc_reader_init(void) {
     adc_reader_initialized = true;
     cached_device_type = DEVICE_TYPE_UNKNOWN;
 
-    #ifdef DEBUG
-    printf("[ADC Reader] Initialized successfully\n");
-    #endif
+    // 載入 UCI 參數；UCI 不可用時沿用預設值
+    adc_config = default_config;
+    adc_reader_load_config();
+
+    logger_mod(LOG_MODULE_ADC, LOG_LEVEL_DEBUG, "Initialized successfully");
 
     return GAMING_OK;
 }
@@ -66,18 +145,21 @@ void adc_reader_cleanup(void) {
         return;
     }
 
+    // 關閉常駐的 ADC 設備
+    if (hal_ops != NULL && hal_ops->adc_close != NULL) {
+        hal_ops->adc_close();
+    }
+
     // 清除快取
     cached_device_type = DEVICE_TYPE_UNKNOWN;
     adc_reader_initialized = false;
 
-    #ifdef DEBUG
-    printf("[ADC Reader] Cleaned up\n");
-    #endif
+    logger_mod(LOG_MODULE_ADC, LOG_LEVEL_DEBUG, "Cleaned up");
 }
 
 int adc_reader_read_raw(const char *device) {
     if (!is_initialized()) {
-        fprintf(stderr, "[ADC Reader] Not initialized\n");
+        logger_mod(LOG_MODULE_ADC, LOG_LEVEL_ERROR, "Not initialized");
         return ADC_READER_ERROR_NOT_INIT;
     }
 
@@ -86,54 +168,171 @@ int adc_reader_read_raw(const char *device) {
 
     // 透過 HAL 讀取 ADC
     if (hal_ops == NULL || hal_ops->adc_read == NULL) {
-        fprintf(stderr, "[ADC Reader] HAL adc_read not available\n");
+        logger_mod(LOG_MODULE_ADC, LOG_LEVEL_ERROR, "HAL adc_read not available");
         return ADC_READER_ERROR;
     }
 
     int adc_value = hal_ops->adc_read(adc_device);
     
     if (adc_value < 0) {
-        fprintf(stderr, "[ADC Reader] Failed to read ADC from %s\n", adc_device);
+        logger_mod(LOG_MODULE_ADC, LOG_LEVEL_ERROR, "Failed to read ADC from %s", adc_device);
         return ADC_READER_ERROR_IO;
     }
 
-    #ifdef DEBUG
-    printf("[ADC Reader] Read ADC value: %d from %s\n", adc_value, adc_device);
-    #endif
+    logger_mod(LOG_MODULE_ADC, LOG_LEVEL_DEBUG, "Read ADC value: %d from %s", adc_value, adc_device);
 
     return adc_value;
 }
 
+int adc_reader_filter_samples(int *samples, int count, adc_filter_t filter) {
+    if (samples == NULL || count <= 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    sort_samples(samples, count);
+
+    if (filter == ADC_FILTER_TRIMMED_MEAN) {
+        // 頭尾各去掉 1/4,剩下的四捨五入取平均
+        int trim = count / 4;
+        int kept = count - 2 * trim;
+        long sum = 0;
+        for (int i = trim; i < count - trim; i++) {
+            sum += samples[i];
+        }
+        return (int)((sum + kept / 2) / kept);
+    }
+
+    if (count % 2 == 0) {
+        return (samples[count / 2 - 1] + samples[count / 2]) / 2;
+    }
+    return samples[count / 2];
+}
+
+int adc_reader_read_filtered(const char *device) {
+    if (!is_initialized()) {
+        logger_mod(LOG_MODULE_ADC, LOG_LEVEL_ERROR, "Not initialized");
+        return ADC_READER_ERROR_NOT_INIT;
+    }
+
+    const char *adc_device = (device != NULL) ? device : adc_config.device;
+    int count = adc_config.samples;
+
+    if (count <= 1) {
+        return adc_reader_read_raw(adc_device);
+    }
+
+    if (hal_ops == NULL) {
+        logger_mod(LOG_MODULE_ADC, LOG_LEVEL_ERROR, "HAL not available");
+        return ADC_READER_ERROR;
+    }
+
+    int samples[ADC_READER_MAX_SAMPLES];
+    int got;
+
+    if (hal_ops->adc_read_burst != NULL) {
+        got = hal_ops->adc_read_burst(adc_device, samples, count);
+    } else {
+        // HAL 沒有連續取樣時逐次讀取
+        for (got = 0; got < count; got++) {
+            int value = adc_reader_read_raw(adc_device);
+            if (value < 0) {
+                break;
+            }
+            samples[got] = value;
+        }
+    }
+
+    if (got <= 0) {
+        logger_mod(LOG_MODULE_ADC, LOG_LEVEL_ERROR, "Failed to read ADC samples from %s", adc_device);
+        return ADC_READER_ERROR_IO;
+    }
+
+    int value = adc_reader_filter_samples(samples, got, adc_config.filter);
+
+    logger_mod(LOG_MODULE_ADC, LOG_LEVEL_DEBUG, "Filtered ADC value: %d (%d samples) from %s",
+               value, got, adc_device);
+
+    return value;
+}
+
+device_type_t adc_reader_classify(int adc_value, device_type_t previous) {
+    int threshold = adc_config.threshold;
+
+    if (previous == DEVICE_TYPE_CLIENT) {
+        threshold += adc_config.hysteresis;
+    } else if (previous == DEVICE_TYPE_SERVER) {
+        threshold -= adc_config.hysteresis;
+    }
+
+    return (adc_value < threshold) ? DEVICE_TYPE_CLIENT : DEVICE_TYPE_SERVER;
+}
+
+int adc_reader_set_config(const adc_reader_config_t *config) {
+    if (config == NULL ||
+        config->samples < 1 || config->samples > ADC_READER_MAX_SAMPLES ||
+        config->threshold < 0 || config->hysteresis < 0 ||
+        (config->filter != ADC_FILTER_MEDIAN && config->filter != ADC_FILTER_TRIMMED_MEAN) ||
+        config->device[0] == '\0') {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    adc_config = *config;
+    adc_config.device[sizeof(adc_config.device) - 1] = '\0';
+
+    return GAMING_OK;
+}
+
+void adc_reader_get_config(adc_reader_config_t *config) {
+    if (config != NULL) {
+        *config = adc_config;
+    }
+}
+
+int adc_reader_load_config(void) {
+    adc_reader_config_t config = adc_config;
+
+    int ret = config_parser_init();
+    if (ret != GAMING_OK) {
+        return ret;
+    }
+
+    ret = config_parser_foreach_option(UCI_CONFIG_GAMING, UCI_SECTION_HARDWARE,
+                                       load_adc_option, &config);
+    if (ret < 0) {
+        return ret;
+    }
+
+    adc_config = config;
+
+    logger_mod(LOG_MODULE_ADC, LOG_LEVEL_DEBUG,
+               "Config: threshold=%d hysteresis=%d samples=%d filter=%s",
+               adc_config.threshold, adc_config.hysteresis, adc_config.samples,
+               adc_config.filter == ADC_FILTER_MEDIAN ? "median" : "mean");
+
+    return GAMING_OK;
+}
+
 device_type_t adc_reader_detect_device_type(void) {
     if (!is_initialized()) {
-        fprintf(stderr, "[ADC Reader] Not initialized\n");
+        logger_mod(LOG_MODULE_ADC, LOG_LEVEL_ERROR, "Not initialized");
         return DEVICE_TYPE_UNKNOWN;
     }
 
-    // 讀取 ADC 值
-    int adc_value = adc_reader_read_raw(NULL);
+    // 讀取 (濾波後的) ADC 值
+    int adc_value = adc_reader_read_filtered(NULL);
     
     if (adc_value < 0) {
-        fprintf(stderr, "[ADC Reader] Failed to read ADC for device type detection\n");
+        logger_mod(LOG_MODULE_ADC, LOG_LEVEL_ERROR, "Failed to read ADC for device type detection");
         return DEVICE_TYPE_UNKNOWN;
     }
 
-    // 根據 ADC 閾值判定裝置類型
-    device_type_t device_type;
-    
-    if (adc_value < ADC_THRESHOLD_CLIENT_SERVER) {
-        device_type = DEVICE_TYPE_CLIENT;
-        #ifdef DEBUG
-        printf("[ADC Reader] Detected Client device (ADC=%d < %d)\n", 
-               adc_value, ADC_THRESHOLD_CLIENT_SERVER);
-        #endif
-    } else {
-        device_type = DEVICE_TYPE_SERVER;
-        #ifdef DEBUG
-        printf("[ADC Reader] Detected Server device (ADC=%d >= %d)\n", 
-               adc_value, ADC_THRESHOLD_CLIENT_SERVER);
-        #endif
-    }
+    // 根據 ADC 閾值 (含遲滯區間) 判定裝置類型
+    device_type_t device_type = adc_reader_classify(adc_value, cached_device_type);
+
+    logger_mod(LOG_MODULE_ADC, LOG_LEVEL_DEBUG,
+               "Detected %s device (ADC=%d, threshold=%d, hysteresis=%d)",
+               adc_reader_get_type_string(device_type), adc_value,
+               adc_config.threshold, adc_config.hysteresis);
 
     // 自動快取結果
     adc_reader_cache_device_type(device_type);
@@ -143,42 +342,36 @@ device_type_t adc_reader_detect_device_type(void) {
 
 int adc_reader_cache_device_type(device_type_t type) {
     if (!is_initialized()) {
-        fprintf(stderr, "[ADC Reader] Not initialized\n");
+        logger_mod(LOG_MODULE_ADC, LOG_LEVEL_ERROR, "Not initialized");
         return GAMING_ERROR_NOT_INITIALIZED;
     }
 
     // 驗證裝置類型
     if (type != DEVICE_TYPE_CLIENT && type != DEVICE_TYPE_SERVER) {
-        fprintf(stderr, "[ADC Reader] Invalid device type: %d\n", type);
+        logger_mod(LOG_MODULE_ADC, LOG_LEVEL_ERROR, "Invalid device type: %d", type);
         return GAMING_ERROR_INVALID_PARAM;
     }
 
     cached_device_type = type;
 
-    #ifdef DEBUG
-    printf("[ADC Reader] Cached device type: %s\n", 
-           adc_reader_get_type_string(type));
-    #endif
+    logger_mod(LOG_MODULE_ADC, LOG_LEVEL_DEBUG, "Cached device type: %s",
+               adc_reader_get_type_string(type));
 
     return GAMING_OK;
 }
 
 device_type_t adc_reader_get_cached_device_type(void) {
     if (!is_initialized()) {
-        #ifdef DEBUG
-        printf("[ADC Reader] Not initialized, returning UNKNOWN\n");
-        #endif
+        logger_mod(LOG_MODULE_ADC, LOG_LEVEL_DEBUG, "Not initialized, returning UNKNOWN");
         return DEVICE_TYPE_UNKNOWN;
     }
 
-    #ifdef DEBUG
     if (cached_device_type != DEVICE_TYPE_UNKNOWN) {
-        printf("[ADC Reader] Returning cached type: %s\n", 
-               adc_reader_get_type_string(cached_device_type));
+        logger_mod(LOG_MODULE_ADC, LOG_LEVEL_DEBUG, "Returning cached type: %s",
+                   adc_reader_get_type_string(cached_device_type));
     } else {
-        printf("[ADC Reader] Cache is empty, returning UNKNOWN\n");
+        logger_mod(LOG_MODULE_ADC, LOG_LEVEL_DEBUG, "Cache is empty, returning UNKNOWN");
     }
-    #endif
 
     return cached_device_type;
 }
@@ -190,9 +383,7 @@ void adc_reader_clear_cache(void) {
 
     cached_device_type = DEVICE_TYPE_UNKNOWN;
 
-    #ifdef DEBUG
-    printf("[ADC Reader] Cache cleared\n");
-    #endif
+    logger_mod(LOG_MODULE_ADC, LOG_LEVEL_DEBUG, "Cache cleared");
 }
 
 const char* adc_reader_get_type_string(device_type_t type) {
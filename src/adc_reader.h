@@ -30,6 +30,29 @@
 #define ADC_READER_ERROR_IO         -2
 #define ADC_READER_ERROR_NOT_INIT   -3
 
+// ========================================
+// 取樣與濾波配置
+// ========================================
+
+// 單次偵測的取樣數上限
+#define ADC_READER_MAX_SAMPLES      32
+
+// ADC 設備路徑長度上限
+#define ADC_READER_DEVICE_MAX       64
+
+typedef enum {
+    ADC_FILTER_MEDIAN = 0,       ///< 中位數 (預設)
+    ADC_FILTER_TRIMMED_MEAN      ///< 去掉頭尾各 1/4 後取平均
+} adc_filter_t;
+
+typedef struct {
+    char device[ADC_READER_DEVICE_MAX];  ///< ADC 設備路徑
+    int threshold;                       ///< Client/Server 分界值
+    int hysteresis;                      ///< 遲滯區間 (threshold ± hysteresis)
+    int samples;                         ///< 每次偵測的取樣數 (1 - ADC_READER_MAX_SAMPLES)
+    adc_filter_t filter;                 ///< 濾波方式
+} adc_reader_config_t;
+
 // ========================================
 // ADC Reader 公開函數
 // ========================================
@@ -69,12 +92,76 @@ void adc_reader_cleanup(void);
  */
 int adc_reader_read_raw(const char *device);
 
+/**
+ * @brief 連續取樣並濾波
+ * 
+ * 依配置一次取 samples 個樣本 (設備保持開啟),
+ * 以中位數或去頭尾平均濾除雜訊。samples 為 1 時等同 adc_reader_read_raw()
+ * 
+ * @param device ADC 設備路徑,若為 NULL 則使用配置中的路徑
+ * @return >= 0 濾波後的 ADC 值
+ * @return < 0 讀取失敗
+ */
+int adc_reader_read_filtered(const char *device);
+
+/**
+ * @brief 對樣本做濾波 (整數運算)
+ * 
+ * @param samples 樣本陣列,會被就地排序
+ * @param count 樣本數
+ * @param filter 濾波方式
+ * @return >= 0 濾波結果
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ */
+int adc_reader_filter_samples(int *samples, int count, adc_filter_t filter);
+
+/**
+ * @brief 依閾值與遲滯區間判定裝置類型
+ * 
+ * 先前已判定為 Client 時,ADC 必須 >= threshold + hysteresis 才改判 Server;
+ * 先前為 Server 時,ADC 必須 < threshold - hysteresis 才改判 Client;
+ * 先前未知時直接與 threshold 比較
+ * 
+ * @param adc_value ADC 值
+ * @param previous 先前判定的類型
+ * @return DEVICE_TYPE_CLIENT 或 DEVICE_TYPE_SERVER
+ */
+device_type_t adc_reader_classify(int adc_value, device_type_t previous);
+
+/**
+ * @brief 設定取樣與判定參數
+ * 
+ * @param config 新配置
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數超出範圍
+ */
+int adc_reader_set_config(const adc_reader_config_t *config);
+
+/**
+ * @brief 取得目前的取樣與判定參數
+ * 
+ * @param config 輸出配置
+ */
+void adc_reader_get_config(adc_reader_config_t *config);
+
+/**
+ * @brief 從 UCI (gaming.hardware) 載入取樣與判定參數
+ * 
+ * 只讀取一次整個區段;UCI 不可用或選項無效時保留目前的值
+ * 
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_FOUND 區段不存在
+ */
+int adc_reader_load_config(void);
+
 /**
  * @brief 偵測裝置類型
  * 
- * 根據 ADC 值判定裝置類型:
- * - ADC < ADC_THRESHOLD_CLIENT_SERVER (512) → Client 裝置
- * - ADC >= ADC_THRESHOLD_CLIENT_SERVER (512) → Server 裝置
+ * 根據 (濾波後的) ADC 值判定裝置類型:
+ * - ADC < threshold (預設 ADC_THRESHOLD_CLIENT_SERVER) → Client 裝置
+ * - ADC >= threshold → Server 裝置
+ * 
+ * 已有快取結果時套用遲滯區間,避免雜訊造成類型來回切換
  * 
  * @return DEVICE_TYPE_CLIENT Client 裝置 (原 Travel Router)
  * @return DEVICE_TYPE_SERVER Server 裝置 (原 Home Router)
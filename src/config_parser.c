@@ -11,6 +11,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <pthread.h>
 
 // ========================================
 // 內部狀態
@@ -18,6 +19,11 @@
 
 static bool config_parser_initialized = false;
 
+// 重新載入回呼 (執行時先複製一份,回呼中可再註冊)
+static config_reload_cb_t reload_hooks[CONFIG_PARSER_MAX_RELOAD_HOOKS];
+static int reload_hook_count = 0;
+static pthread_mutex_t reload_lock = PTHREAD_MUTEX_INITIALIZER;
+
 // ========================================
 // 內部輔助函數
 // ========================================
@@ -162,6 +168,64 @@ int config_parser_set_bool(const char *config_name,
                                     value ? "1" : "0");
 }
 
+int config_parser_foreach_option(const char *config_name,
+                                 const char *section,
+                                 config_option_cb_t callback,
+                                 void *user_data) {
+    if (!config_parser_initialized) {
+        return GAMING_ERROR_NOT_INITIALIZED;
+    }
+
+    if (config_name == NULL || section == NULL || callback == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    char command[256];
+    snprintf(command, sizeof(command), "uci -q show %s.%s 2>/dev/null",
+             config_name, section);
+
+    FILE *fp = popen(command, "r");
+    if (fp == NULL) {
+        return GAMING_ERROR;
+    }
+
+    // 輸出格式: <config>.<section>.<option>='<value>'
+    char prefix[128];
+    int prefix_len = snprintf(prefix, sizeof(prefix), "%s.%s.",
+                              config_name, section);
+
+    char line[256];
+    int count = 0;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (strncmp(line, prefix, prefix_len) != 0) {
+            continue;  // 區段本身 (<config>.<section>=<type>)
+        }
+
+        char *option = line + prefix_len;
+        char *value = strchr(option, '=');
+        if (value == NULL) {
+            continue;
+        }
+        *value++ = '\0';
+
+        // 移除換行符與外層引號
+        size_t len = strlen(value);
+        while (len > 0 && (value[len - 1] == '\n' || value[len - 1] == '\r')) {
+            value[--len] = '\0';
+        }
+        if (len >= 2 && value[0] == '\'' && value[len - 1] == '\'') {
+            value[len - 1] = '\0';
+            value++;
+        }
+
+        callback(option, value, user_data);
+        count++;
+    }
+
+    pclose(fp);
+    return (count > 0) ? count : GAMING_ERROR_NOT_FOUND;
+}
+
 int config_parser_commit(const char *config_name) {
     if (!config_parser_initialized) {
         return GAMING_ERROR_NOT_INITIALIZED;
@@ -177,3 +241,61 @@ int config_parser_commit(const char *config_name) {
     int ret = system(command);
     return (ret == 0) ? GAMING_OK : GAMING_ERROR;
 }
+
+// ========================================
+// 設定重新載入
+// ========================================
+
+int config_parser_add_reload_hook(config_reload_cb_t callback) {
+    if (callback == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    int ret = GAMING_OK;
+    pthread_mutex_lock(&reload_lock);
+    for (int i = 0; i < reload_hook_count; i++) {
+        if (reload_hooks[i] == callback) {
+            pthread_mutex_unlock(&reload_lock);
+            return GAMING_OK;
+        }
+    }
+    if (reload_hook_count < CONFIG_PARSER_MAX_RELOAD_HOOKS) {
+        reload_hooks[reload_hook_count++] = callback;
+    } else {
+        ret = GAMING_ERROR_NO_MEMORY;
+    }
+    pthread_mutex_unlock(&reload_lock);
+    return ret;
+}
+
+void config_parser_remove_reload_hook(config_reload_cb_t callback) {
+    pthread_mutex_lock(&reload_lock);
+    for (int i = 0; i < reload_hook_count; i++) {
+        if (reload_hooks[i] == callback) {
+            memmove(&reload_hooks[i], &reload_hooks[i + 1],
+                    (size_t)(reload_hook_count - i - 1) * sizeof(reload_hooks[0]));
+            reload_hook_count--;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&reload_lock);
+}
+
+int config_parser_reload(void) {
+    config_reload_cb_t hooks[CONFIG_PARSER_MAX_RELOAD_HOOKS];
+    int count;
+
+    pthread_mutex_lock(&reload_lock);
+    count = reload_hook_count;
+    memcpy(hooks, reload_hooks, (size_t)count * sizeof(hooks[0]));
+    pthread_mutex_unlock(&reload_lock);
+
+    int result = GAMING_OK;
+    for (int i = 0; i < count; i++) {
+        int ret = hooks[i]();
+        if (ret != GAMING_OK && result == GAMING_OK) {
+            result = ret;
+        }
+    }
+    return result;
+}
@@ -30,9 +30,15 @@
 // 配置選項定義
 // ========================================
 
-// 通用選項
+// 通用選項 (gaming.core)
+#define UCI_SECTION_CORE        "core"
 #define UCI_OPTION_ENABLED      "enabled"
 #define UCI_OPTION_LOG_LEVEL    "log_level"
+#define UCI_OPTION_LOG_MODULES  "log_modules"
+#define UCI_OPTION_LOG_TARGET   "log_target"
+#define UCI_OPTION_LOG_FORMAT   "log_format"
+#define UCI_OPTION_LOG_FILE     "log_file"
+#define UCI_OPTION_LOG_FILE_SIZE "log_file_size"
 #define UCI_OPTION_DEVICE_TYPE  "device_type"
 
 // Client 選項
@@ -51,6 +57,17 @@
 #define UCI_OPTION_LED_PIN_G    "led_pin_g"
 #define UCI_OPTION_LED_PIN_B    "led_pin_b"
 
+// LED 顏色表 (config led 'colors')
+#define UCI_SECTION_LED_COLORS  "colors"
+
+// ADC 相關選項 (gaming.hardware)
+#define UCI_SECTION_HARDWARE      "hardware"
+#define UCI_OPTION_ADC_DEVICE     "adc_device"
+#define UCI_OPTION_ADC_THRESHOLD  "adc_threshold"
+#define UCI_OPTION_ADC_HYSTERESIS "adc_hysteresis"
+#define UCI_OPTION_ADC_SAMPLES    "adc_samples"
+#define UCI_OPTION_ADC_FILTER     "adc_filter"
+
 // ========================================
 // Config Parser 公開函數
 // ========================================
@@ -163,6 +180,36 @@ int config_parser_set_bool(const char *config_name,
                            const char *option,
                            bool value);
 
+/**
+ * @brief 選項遍歷回呼
+ *
+ * @param option 選項名稱
+ * @param value 選項值 (已去除引號)
+ * @param user_data 呼叫端資料
+ */
+typedef void (*config_option_cb_t)(const char *option,
+                                   const char *value,
+                                   void *user_data);
+
+/**
+ * @brief 一次讀取整個區段的所有選項
+ *
+ * 只執行一次 `uci show`,適合在初始化時載入整張表
+ * (例如 LED 顏色表),避免逐一 `uci get` 造成多次 fork/exec
+ *
+ * @param config_name 配置文件名稱
+ * @param section 配置區段
+ * @param callback 每個選項呼叫一次
+ * @param user_data 傳給回呼的資料
+ * @return >= 0 讀到的選項數量
+ * @return GAMING_ERROR_NOT_FOUND 區段不存在
+ * @return GAMING_ERROR 其他錯誤
+ */
+int config_parser_foreach_option(const char *config_name,
+                                 const char *section,
+                                 config_option_cb_t callback,
+                                 void *user_data);
+
 /**
  * @brief 提交配置變更
  * 
@@ -174,4 +221,44 @@ int config_parser_set_bool(const char *config_name,
  */
 int config_parser_commit(const char *config_name);
 
+// ========================================
+// 設定重新載入
+// ========================================
+
+// 可註冊的重新載入回呼上限
+#define CONFIG_PARSER_MAX_RELOAD_HOOKS  8
+
+/**
+ * @brief 重新載入回呼 (例如 led_color_table_reload)
+ *
+ * @return GAMING_OK 成功,其他為錯誤碼
+ */
+typedef int (*config_reload_cb_t)(void);
+
+/**
+ * @brief 註冊設定變更時要執行的重新載入回呼
+ *
+ * 同一個回呼只會註冊一次
+ *
+ * @return GAMING_OK 成功 (或已註冊)
+ * @return GAMING_ERROR_INVALID_PARAM callback 為 NULL
+ * @return GAMING_ERROR_NO_MEMORY 已達 CONFIG_PARSER_MAX_RELOAD_HOOKS
+ */
+int config_parser_add_reload_hook(config_reload_cb_t callback);
+
+/**
+ * @brief 取消註冊重新載入回呼
+ */
+void config_parser_remove_reload_hook(config_reload_cb_t callback);
+
+/**
+ * @brief UCI 變更後重新載入所有已註冊的設定 (SIGHUP / reload_service 時呼叫)
+ *
+ * 依註冊順序執行每個回呼,某個回呼失敗時其餘回呼仍會執行
+ *
+ * @return GAMING_OK 全部成功
+ * @return 其他 第一個失敗回呼的錯誤碼
+ */
+int config_parser_reload(void);
+
 #endif // CONFIG_PARSER_H
@@ -0,0 +1,201 @@
+/**
+ * @file device_detect.c
+ * @brief 裝置類型判定實作
+ * @version 1.0.0
+ */
+
+#define _POSIX_C_SOURCE 200809L  // O_CLOEXEC
+
+#include "device_detect.h"
+#include "adc_reader.h"
+#include "config_parser.h"
+#include "hal_interface.h"
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+static const char* cache_path_or_default(const char *path) {
+    return path ? path : PATH_DEVICE_TYPE_CACHE;
+}
+
+// ========================================
+// 公開函數實作
+// ========================================
+
+device_type_t device_detect_parse_type(const char *text) {
+    if (text == NULL) {
+        return DEVICE_TYPE_UNKNOWN;
+    }
+
+    while (isspace((unsigned char)*text)) {
+        text++;
+    }
+
+    size_t len = strlen(text);
+    while (len > 0 && isspace((unsigned char)text[len - 1])) {
+        len--;
+    }
+
+    if (len == 6 && strncmp(text, "client", 6) == 0) {
+        return DEVICE_TYPE_CLIENT;
+    }
+    if (len == 6 && strncmp(text, "server", 6) == 0) {
+        return DEVICE_TYPE_SERVER;
+    }
+
+    return DEVICE_TYPE_UNKNOWN;
+}
+
+const char* device_detect_type_name(device_type_t type) {
+    switch (type) {
+        case DEVICE_TYPE_CLIENT:
+            return "client";
+        case DEVICE_TYPE_SERVER:
+            return "server";
+        case DEVICE_TYPE_UNKNOWN:
+        default:
+            return "unknown";
+    }
+}
+
+const char* device_detect_source_name(device_source_t source) {
+    switch (source) {
+        case DEVICE_SOURCE_CACHE:
+            return "cache";
+        case DEVICE_SOURCE_ADC:
+            return "adc";
+        case DEVICE_SOURCE_CONFIG:
+            return "config";
+        case DEVICE_SOURCE_NONE:
+        default:
+            return "none";
+    }
+}
+
+device_type_t device_detect_read_cache(const char *path) {
+    char buffer[32];
+
+    int fd = open(cache_path_or_default(path), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return DEVICE_TYPE_UNKNOWN;
+    }
+
+    ssize_t n = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (n <= 0) {
+        return DEVICE_TYPE_UNKNOWN;
+    }
+
+    buffer[n] = '\0';
+    return device_detect_parse_type(buffer);
+}
+
+int device_detect_write_cache(const char *path, device_type_t type) {
+    if (type != DEVICE_TYPE_CLIENT && type != DEVICE_TYPE_SERVER) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    const char *cache_path = cache_path_or_default(path);
+    char tmp_path[256];
+    char content[16];
+
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%d.tmp", cache_path, (int)getpid());
+    int len = snprintf(content, sizeof(content), "%s\n", device_detect_type_name(type));
+
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Device detect: Failed to create %s: %s\n",
+                tmp_path, strerror(errno));
+        return GAMING_ERROR_IO;
+    }
+
+    ssize_t written = write(fd, content, (size_t)len);
+    if (close(fd) != 0 || written != len) {
+        fprintf(stderr, "Device detect: Failed to write %s\n", tmp_path);
+        unlink(tmp_path);
+        return GAMING_ERROR_IO;
+    }
+
+    if (rename(tmp_path, cache_path) != 0) {
+        fprintf(stderr, "Device detect: Failed to rename to %s: %s\n",
+                cache_path, strerror(errno));
+        unlink(tmp_path);
+        return GAMING_ERROR_IO;
+    }
+
+    return GAMING_OK;
+}
+
+device_type_t device_detect_from_adc(void) {
+    if (hal_ops == NULL) {
+        return DEVICE_TYPE_UNKNOWN;
+    }
+
+    if (adc_reader_init() != GAMING_OK) {
+        return DEVICE_TYPE_UNKNOWN;
+    }
+
+    device_type_t type = adc_reader_detect_device_type();
+    adc_reader_cleanup();
+
+    return type;
+}
+
+device_type_t device_detect_from_config(void) {
+    char value[32];
+
+    if (config_parser_init() != GAMING_OK) {
+        return DEVICE_TYPE_UNKNOWN;
+    }
+
+    if (config_parser_get_string(UCI_CONFIG_GAMING, UCI_SECTION_CORE,
+                                 UCI_OPTION_DEVICE_TYPE,
+                                 value, sizeof(value)) != GAMING_OK) {
+        return DEVICE_TYPE_UNKNOWN;
+    }
+
+    return device_detect_parse_type(value);
+}
+
+device_type_t device_detect_run(const char *cache_path, device_source_t *source) {
+    device_source_t found = DEVICE_SOURCE_NONE;
+
+    // 優先級 1: 快取檔案 (不需要任何外部程式)
+    device_type_t type = device_detect_read_cache(cache_path);
+    if (type != DEVICE_TYPE_UNKNOWN) {
+        found = DEVICE_SOURCE_CACHE;
+    }
+
+    // 優先級 2: ADC 硬體判定
+    if (type == DEVICE_TYPE_UNKNOWN) {
+        type = device_detect_from_adc();
+        if (type != DEVICE_TYPE_UNKNOWN) {
+            found = DEVICE_SOURCE_ADC;
+        }
+    }
+
+    // 優先級 3: UCI 配置
+    if (type == DEVICE_TYPE_UNKNOWN) {
+        type = device_detect_from_config();
+        if (type != DEVICE_TYPE_UNKNOWN) {
+            found = DEVICE_SOURCE_CONFIG;
+        }
+    }
+
+    // 新判定的結果寫入快取,下次開機直接使用
+    if (found == DEVICE_SOURCE_ADC || found == DEVICE_SOURCE_CONFIG) {
+        device_detect_write_cache(cache_path, type);
+    }
+
+    if (source != NULL) {
+        *source = found;
+    }
+    return type;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file device_detect.h
+ * @brief 裝置類型判定 - 快取檔案 / ADC / UCI
+ * @version 1.0.0
+ *
+ * 取代 init script 中以 cat/tr/uci/logger 組成的判定流程,
+ * 依相同的優先順序在同一個行程內完成:
+ *   1. 快取檔案 (PATH_DEVICE_TYPE_CACHE)
+ *   2. ADC 硬體判定 (依 gaming.hardware 的取樣與濾波設定)
+ *   3. UCI 配置 (gaming.core.device_type)
+ * 由 ADC 或 UCI 得到的結果會以 tmp + rename 原子寫入快取檔案
+ */
+
+#ifndef DEVICE_DETECT_H
+#define DEVICE_DETECT_H
+
+#include "gaming_common.h"
+
+// ========================================
+// 判定來源
+// ========================================
+
+typedef enum {
+    DEVICE_SOURCE_NONE = 0,
+    DEVICE_SOURCE_CACHE,
+    DEVICE_SOURCE_ADC,
+    DEVICE_SOURCE_CONFIG
+} device_source_t;
+
+// ========================================
+// Device Detect 公開函數
+// ========================================
+
+/**
+ * @brief 解析裝置類型字串 ("client" / "server",前後空白忽略)
+ *
+ * @return DEVICE_TYPE_CLIENT / DEVICE_TYPE_SERVER, 無法辨識則 DEVICE_TYPE_UNKNOWN
+ */
+device_type_t device_detect_parse_type(const char *text);
+
+/**
+ * @brief 裝置類型轉為 init script 使用的小寫字串
+ *
+ * @return "client" / "server" / "unknown"
+ */
+const char* device_detect_type_name(device_type_t type);
+
+/**
+ * @brief 取得判定來源的名稱
+ */
+const char* device_detect_source_name(device_source_t source);
+
+/**
+ * @brief 讀取快取檔案
+ *
+ * @param path 快取路徑,NULL 則使用 PATH_DEVICE_TYPE_CACHE
+ * @return 快取的類型, 檔案不存在或內容無效則 DEVICE_TYPE_UNKNOWN
+ */
+device_type_t device_detect_read_cache(const char *path);
+
+/**
+ * @brief 原子寫入快取檔案
+ *
+ * 先寫入同目錄下的暫存檔再 rename,讀取端不會看到寫到一半的內容
+ *
+ * @param path 快取路徑,NULL 則使用 PATH_DEVICE_TYPE_CACHE
+ * @param type 裝置類型 (只接受 Client / Server)
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 類型無效
+ * @return GAMING_ERROR_IO 寫入失敗
+ */
+int device_detect_write_cache(const char *path, device_type_t type);
+
+/**
+ * @brief 以 ADC 判定 (需要 hal_ops 已初始化)
+ *
+ * @return 判定結果, 讀取失敗則 DEVICE_TYPE_UNKNOWN
+ */
+device_type_t device_detect_from_adc(void);
+
+/**
+ * @brief 讀取 UCI gaming.core.device_type
+ *
+ * @return 配置的類型, 未設定或無效則 DEVICE_TYPE_UNKNOWN
+ */
+device_type_t device_detect_from_config(void);
+
+/**
+ * @brief 依優先順序判定裝置類型
+ *
+ * @param cache_path 快取路徑,NULL 則使用 PATH_DEVICE_TYPE_CACHE
+ * @param source 輸出判定來源,可為 NULL
+ * @return 判定結果, 全部失敗則 DEVICE_TYPE_UNKNOWN
+ */
+device_type_t device_detect_run(const char *cache_path, device_source_t *source);
+
+#endif // DEVICE_DETECT_H
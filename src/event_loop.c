@@ -0,0 +1,561 @@
+/**
+ * @file event_loop.c
+ * @brief Event Loop 實作
+ * @version 1.0.0
+ *
+ * 所有來源 (使用者 fd、timerfd、signalfd、eventfd) 都放在以 fd 為索引的
+ * 陣列中,epoll 的 data 帶 fd 與註冊世代。來源在回呼中被移除或 fd 被
+ * 重新註冊時世代不同,同一批中舊的事件會被略過
+ */
+
+#define _GNU_SOURCE  // signalfd, NSIG
+
+#include "event_loop.h"
+#include "logger.h"
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+
+// ========================================
+// 內部資料
+// ========================================
+
+typedef enum {
+    SOURCE_NONE = 0,
+    SOURCE_FD,
+    SOURCE_TIMER,
+    SOURCE_SIGNAL,
+    SOURCE_WAKE,
+} source_kind_t;
+
+typedef struct {
+    uint8_t kind;
+    bool oneshot;           // 計時器只觸發一次
+    uint32_t events;        // 註冊的 EVENT_* 旗標
+    uint32_t gen;           // 註冊世代
+    union {
+        event_fd_cb fd;
+        event_timer_cb timer;
+    } cb;
+    void *user_data;
+} event_source_t;
+
+typedef struct {
+    event_signal_cb callback;
+    void *user_data;
+    bool was_blocked;       // 註冊前呼叫執行緒是否已封鎖此訊號,移除時據此還原
+} signal_handler_t;
+
+struct event_loop {
+    int epoll_fd;
+    int wake_fd;
+    int signal_fd;
+    sigset_t signal_mask;
+
+    event_source_t *sources;
+    int capacity;
+    int count;
+    uint32_t next_gen;
+
+    signal_handler_t signals[NSIG];
+
+    event_wakeup_cb wakeup_cb;
+    void *wakeup_user_data;
+    int stopping;
+};
+
+#define EVENT_VALID_MASK (EVENT_READ | EVENT_WRITE | EVENT_EDGE | EVENT_EXCLUSIVE)
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+static uint32_t to_epoll_events(uint32_t events) {
+    uint32_t ep = 0;
+    if (events & EVENT_READ) {
+        ep |= EPOLLIN;
+    }
+    if (events & EVENT_WRITE) {
+        ep |= EPOLLOUT;
+    }
+    if (events & EVENT_EDGE) {
+        ep |= EPOLLET;
+    }
+    if (events & EVENT_EXCLUSIVE) {
+        ep |= EPOLLEXCLUSIVE;
+    }
+    return ep;
+}
+
+static uint32_t from_epoll_events(uint32_t ep) {
+    uint32_t events = 0;
+    if (ep & EPOLLIN) {
+        events |= EVENT_READ;
+    }
+    if (ep & EPOLLOUT) {
+        events |= EVENT_WRITE;
+    }
+    if (ep & (EPOLLERR | EPOLLHUP)) {
+        events |= EVENT_ERROR;
+    }
+    return events;
+}
+
+/**
+ * @brief 確保陣列容得下 fd
+ */
+static bool ensure_capacity(event_loop_t *loop, int fd) {
+    if (fd < loop->capacity) {
+        return true;
+    }
+
+    int capacity = loop->capacity ? loop->capacity : 64;
+    while (capacity <= fd) {
+        capacity *= 2;
+    }
+
+    event_source_t *sources = realloc(loop->sources, (size_t)capacity * sizeof(*sources));
+    if (sources == NULL) {
+        return false;
+    }
+    memset(sources + loop->capacity, 0,
+           (size_t)(capacity - loop->capacity) * sizeof(*sources));
+
+    loop->sources = sources;
+    loop->capacity = capacity;
+    return true;
+}
+
+static event_source_t* find_source(const event_loop_t *loop, int fd, source_kind_t kind) {
+    if (fd < 0 || fd >= loop->capacity || loop->sources[fd].kind != kind) {
+        return NULL;
+    }
+    return &loop->sources[fd];
+}
+
+/**
+ * @brief 登記來源並加入 epoll
+ */
+static int register_source(event_loop_t *loop, int fd, source_kind_t kind, uint32_t events) {
+    if (!ensure_capacity(loop, fd)) {
+        return GAMING_ERROR_NO_MEMORY;
+    }
+    if (loop->sources[fd].kind != SOURCE_NONE) {
+        return GAMING_ERROR_ALREADY_EXISTS;
+    }
+
+    uint32_t gen = ++loop->next_gen;
+    struct epoll_event ev = {
+        .events = to_epoll_events(events),
+        .data.u64 = ((uint64_t)gen << 32) | (uint32_t)fd,
+    };
+    if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "epoll_ctl(ADD, %d): %s",
+                   fd, strerror(errno));
+        return GAMING_ERROR;
+    }
+
+    event_source_t *src = &loop->sources[fd];
+    memset(src, 0, sizeof(*src));
+    src->kind = (uint8_t)kind;
+    src->events = events;
+    src->gen = gen;
+    if (kind == SOURCE_FD || kind == SOURCE_TIMER) {
+        loop->count++;
+    }
+    return GAMING_OK;
+}
+
+static void unregister_source(event_loop_t *loop, int fd) {
+    event_source_t *src = &loop->sources[fd];
+
+    // fd 可能已被呼叫端關閉,EBADF 不影響結果
+    epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+    if (src->kind == SOURCE_FD || src->kind == SOURCE_TIMER) {
+        loop->count--;
+    }
+    memset(src, 0, sizeof(*src));
+}
+
+// ========================================
+// 事件分派
+// ========================================
+
+static void dispatch_timer(event_loop_t *loop, int fd) {
+    event_source_t *src = &loop->sources[fd];
+    uint64_t expirations = 0;
+
+    if (read(fd, &expirations, sizeof(expirations)) != (ssize_t)sizeof(expirations)) {
+        return;
+    }
+
+    event_timer_cb callback = src->cb.timer;
+    void *user_data = src->user_data;
+    if (src->oneshot) {
+        unregister_source(loop, fd);
+        close(fd);
+    }
+    callback(loop, fd, expirations, user_data);
+}
+
+static void dispatch_signals(event_loop_t *loop) {
+    struct signalfd_siginfo info;
+
+    while (read(loop->signal_fd, &info, sizeof(info)) == (ssize_t)sizeof(info)) {
+        int signo = (int)info.ssi_signo;
+        if (signo > 0 && signo < NSIG && loop->signals[signo].callback != NULL) {
+            loop->signals[signo].callback(loop, signo, loop->signals[signo].user_data);
+        }
+    }
+}
+
+/**
+ * @brief 還原訊號在註冊前的封鎖狀態 (只影響呼叫執行緒)
+ */
+static void restore_signal(const event_loop_t *loop, int signo) {
+    if (loop->signals[signo].was_blocked) {
+        return;
+    }
+
+    sigset_t single;
+    sigemptyset(&single);
+    sigaddset(&single, signo);
+    pthread_sigmask(SIG_UNBLOCK, &single, NULL);
+}
+
+static void dispatch_wakeup(event_loop_t *loop) {
+    uint64_t value;
+
+    if (read(loop->wake_fd, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_WARN, "event loop: wake read failed: %s",
+                   strerror(errno));
+    }
+    if (loop->wakeup_cb != NULL) {
+        loop->wakeup_cb(loop, loop->wakeup_user_data);
+    }
+}
+
+static void dispatch(event_loop_t *loop, const struct epoll_event *ev) {
+    int fd = (int)(uint32_t)ev->data.u64;
+    uint32_t gen = (uint32_t)(ev->data.u64 >> 32);
+
+    // 已在同一批中被移除或重新註冊
+    if (fd >= loop->capacity || loop->sources[fd].gen != gen) {
+        return;
+    }
+
+    event_source_t *src = &loop->sources[fd];
+    switch (src->kind) {
+        case SOURCE_FD:
+            src->cb.fd(loop, fd, from_epoll_events(ev->events), src->user_data);
+            break;
+        case SOURCE_TIMER:
+            dispatch_timer(loop, fd);
+            break;
+        case SOURCE_SIGNAL:
+            dispatch_signals(loop);
+            break;
+        case SOURCE_WAKE:
+            dispatch_wakeup(loop);
+            break;
+        default:
+            break;
+    }
+}
+
+// ========================================
+// 公開 API 實作
+// ========================================
+
+event_loop_t* event_loop_create(void) {
+    event_loop_t *loop = calloc(1, sizeof(*loop));
+    if (loop == NULL) {
+        return NULL;
+    }
+
+    loop->signal_fd = -1;
+    loop->wake_fd = -1;
+    sigemptyset(&loop->signal_mask);
+
+    loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (loop->epoll_fd < 0) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "epoll_create1: %s", strerror(errno));
+        free(loop);
+        return NULL;
+    }
+
+    loop->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (loop->wake_fd < 0 ||
+        register_source(loop, loop->wake_fd, SOURCE_WAKE, EVENT_READ) != GAMING_OK) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "event loop: eventfd setup failed");
+        event_loop_destroy(loop);
+        return NULL;
+    }
+
+    return loop;
+}
+
+void event_loop_destroy(event_loop_t *loop) {
+    if (loop == NULL) {
+        return;
+    }
+
+    for (int fd = 0; fd < loop->capacity; fd++) {
+        if (loop->sources[fd].kind == SOURCE_TIMER) {
+            close(fd);
+        }
+    }
+    if (loop->signal_fd >= 0) {
+        close(loop->signal_fd);
+    }
+    for (int signo = 1; signo < NSIG; signo++) {
+        if (loop->signals[signo].callback != NULL) {
+            restore_signal(loop, signo);
+        }
+    }
+    if (loop->wake_fd >= 0) {
+        close(loop->wake_fd);
+    }
+    close(loop->epoll_fd);
+
+    free(loop->sources);
+    free(loop);
+}
+
+int event_loop_add_fd(event_loop_t *loop, int fd, uint32_t events,
+                      event_fd_cb callback, void *user_data) {
+    if (loop == NULL || fd < 0 || callback == NULL || (events & ~EVENT_VALID_MASK) != 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    int ret = register_source(loop, fd, SOURCE_FD, events);
+    if (ret != GAMING_OK) {
+        return ret;
+    }
+
+    loop->sources[fd].cb.fd = callback;
+    loop->sources[fd].user_data = user_data;
+    return GAMING_OK;
+}
+
+int event_loop_modify_fd(event_loop_t *loop, int fd, uint32_t events) {
+    if (loop == NULL || (events & ~EVENT_VALID_MASK) != 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    event_source_t *src = find_source(loop, fd, SOURCE_FD);
+    if (src == NULL) {
+        return GAMING_ERROR_NOT_FOUND;
+    }
+    if (src->events == events) {
+        return GAMING_OK;
+    }
+    // epoll 不允許以 EPOLL_CTL_MOD 變更 EPOLLEXCLUSIVE
+    if ((src->events | events) & EVENT_EXCLUSIVE) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    struct epoll_event ev = {
+        .events = to_epoll_events(events),
+        .data.u64 = ((uint64_t)src->gen << 32) | (uint32_t)fd,
+    };
+    if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_MOD, fd, &ev) != 0) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "epoll_ctl(MOD, %d): %s",
+                   fd, strerror(errno));
+        return GAMING_ERROR;
+    }
+
+    src->events = events;
+    return GAMING_OK;
+}
+
+int event_loop_remove_fd(event_loop_t *loop, int fd) {
+    if (loop == NULL || find_source(loop, fd, SOURCE_FD) == NULL) {
+        return GAMING_ERROR_NOT_FOUND;
+    }
+
+    unregister_source(loop, fd);
+    return GAMING_OK;
+}
+
+int event_loop_add_timer(event_loop_t *loop, unsigned int initial_ms, unsigned int interval_ms,
+                         event_timer_cb callback, void *user_data) {
+    if (loop == NULL || initial_ms == 0 || callback == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "timerfd_create: %s", strerror(errno));
+        return GAMING_ERROR;
+    }
+
+    struct itimerspec spec = {
+        .it_value = { initial_ms / 1000, (long)(initial_ms % 1000) * 1000000L },
+        .it_interval = { interval_ms / 1000, (long)(interval_ms % 1000) * 1000000L },
+    };
+    int ret = GAMING_ERROR;
+    if (timerfd_settime(fd, 0, &spec, NULL) != 0 ||
+        (ret = register_source(loop, fd, SOURCE_TIMER, EVENT_READ)) != GAMING_OK) {
+        close(fd);
+        return ret;
+    }
+
+    event_source_t *src = &loop->sources[fd];
+    src->cb.timer = callback;
+    src->user_data = user_data;
+    src->oneshot = (interval_ms == 0);
+    return fd;
+}
+
+int event_loop_remove_timer(event_loop_t *loop, int timer_id) {
+    if (loop == NULL || find_source(loop, timer_id, SOURCE_TIMER) == NULL) {
+        return GAMING_ERROR_NOT_FOUND;
+    }
+
+    unregister_source(loop, timer_id);
+    close(timer_id);
+    return GAMING_OK;
+}
+
+int event_loop_add_signal(event_loop_t *loop, int signo, event_signal_cb callback,
+                          void *user_data) {
+    if (loop == NULL || signo <= 0 || signo >= NSIG || signo == SIGKILL || signo == SIGSTOP ||
+        callback == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    if (loop->signals[signo].callback != NULL) {
+        return GAMING_ERROR_ALREADY_EXISTS;
+    }
+
+    sigset_t mask = loop->signal_mask;
+    sigaddset(&mask, signo);
+
+    // 先封鎖,避免在 signalfd 接手前以預設動作處理
+    sigset_t single, saved;
+    sigemptyset(&single);
+    sigaddset(&single, signo);
+    pthread_sigmask(SIG_BLOCK, &single, &saved);
+
+    int fd = signalfd(loop->signal_fd, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (fd < 0) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "signalfd: %s", strerror(errno));
+        pthread_sigmask(SIG_SETMASK, &saved, NULL);
+        return GAMING_ERROR;
+    }
+    if (loop->signal_fd < 0) {
+        int ret = register_source(loop, fd, SOURCE_SIGNAL, EVENT_READ);
+        if (ret != GAMING_OK) {
+            close(fd);
+            pthread_sigmask(SIG_SETMASK, &saved, NULL);
+            return ret;
+        }
+        loop->signal_fd = fd;
+    }
+
+    loop->signal_mask = mask;
+    loop->signals[signo].callback = callback;
+    loop->signals[signo].user_data = user_data;
+    loop->signals[signo].was_blocked = sigismember(&saved, signo) == 1;
+    loop->count++;
+    return GAMING_OK;
+}
+
+int event_loop_remove_signal(event_loop_t *loop, int signo) {
+    if (loop == NULL || signo <= 0 || signo >= NSIG || loop->signals[signo].callback == NULL) {
+        return GAMING_ERROR_NOT_FOUND;
+    }
+
+    sigdelset(&loop->signal_mask, signo);
+    if (signalfd(loop->signal_fd, &loop->signal_mask, SFD_NONBLOCK | SFD_CLOEXEC) < 0) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_WARN, "signalfd: %s", strerror(errno));
+    }
+    restore_signal(loop, signo);
+
+    loop->signals[signo].callback = NULL;
+    loop->signals[signo].user_data = NULL;
+    loop->count--;
+    return GAMING_OK;
+}
+
+void event_loop_set_wakeup_handler(event_loop_t *loop, event_wakeup_cb callback,
+                                   void *user_data) {
+    if (loop == NULL) {
+        return;
+    }
+
+    loop->wakeup_cb = callback;
+    loop->wakeup_user_data = user_data;
+}
+
+void event_loop_wakeup(event_loop_t *loop) {
+    if (loop == NULL) {
+        return;
+    }
+
+    // 可能在訊號處理中: 保留 errno;計數器已滿 (EAGAIN) 時迴圈必定會被喚醒
+    int saved_errno = errno;
+    uint64_t one = 1;
+    ssize_t n = write(loop->wake_fd, &one, sizeof(one));
+    (void)n;
+    errno = saved_errno;
+}
+
+void event_loop_stop(event_loop_t *loop) {
+    if (loop == NULL) {
+        return;
+    }
+
+    __atomic_store_n(&loop->stopping, 1, __ATOMIC_RELEASE);
+    event_loop_wakeup(loop);
+}
+
+int event_loop_run_once(event_loop_t *loop, int timeout_ms) {
+    if (loop == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    struct epoll_event events[EVENT_LOOP_MAX_EVENTS];
+    int n = epoll_wait(loop->epoll_fd, events, EVENT_LOOP_MAX_EVENTS, timeout_ms);
+    if (n < 0) {
+        if (errno == EINTR) {
+            return 0;
+        }
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "epoll_wait: %s", strerror(errno));
+        return GAMING_ERROR;
+    }
+
+    for (int i = 0; i < n; i++) {
+        dispatch(loop, &events[i]);
+    }
+    return n;
+}
+
+int event_loop_run(event_loop_t *loop) {
+    if (loop == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    int result = GAMING_OK;
+    while (!__atomic_load_n(&loop->stopping, __ATOMIC_ACQUIRE)) {
+        if (event_loop_run_once(loop, -1) < 0) {
+            result = GAMING_ERROR;
+            break;
+        }
+    }
+
+    __atomic_store_n(&loop->stopping, 0, __ATOMIC_RELEASE);
+    return result;
+}
+
+int event_loop_source_count(const event_loop_t *loop) {
+    return loop ? loop->count : 0;
+}
@@ -0,0 +1,225 @@
+/**
+ * @file event_loop.h
+ * @brief Event Loop - 以 epoll 在單一執行緒多工處理 fd、計時器與訊號
+ * @version 1.0.0
+ *
+ * 取代每次呼叫 select()/poll() 檢查單一 fd 的輪詢迴圈:
+ *
+ * - fd 以 epoll 註冊回呼,可選 level 或 edge 觸發,不受 FD_SETSIZE 限制
+ * - 計時器使用 timerfd,到期前執行緒完全睡眠,閒置時不佔 CPU
+ * - 訊號以 signalfd 在迴圈中處理,回呼可安全呼叫任何函數
+ * - 其他執行緒以 event_loop_wakeup() / event_loop_stop() 經 eventfd 喚醒迴圈
+ *
+ * 除了 event_loop_wakeup() 與 event_loop_stop(),其他函數只能在
+ * 執行迴圈的執行緒中呼叫 (包含在回呼中新增或移除來源)
+ *
+ * 用法:
+ *   event_loop_t *loop = event_loop_create();
+ *   event_loop_add_fd(loop, sockfd, EVENT_READ, on_client, ctx);
+ *   event_loop_add_timer(loop, 1000, 1000, on_tick, ctx);
+ *   event_loop_add_signal(loop, SIGTERM, on_term, loop);
+ *   event_loop_run(loop);
+ *   event_loop_destroy(loop);
+ */
+
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include "gaming_common.h"
+
+// ========================================
+// Event Loop 配置
+// ========================================
+
+// 每次 epoll_wait 最多取回的事件數
+#define EVENT_LOOP_MAX_EVENTS   32
+
+// 事件旗標 (可組合)
+#define EVENT_READ    0x01u   ///< 可讀
+#define EVENT_WRITE   0x02u   ///< 可寫
+#define EVENT_ERROR   0x04u   ///< 錯誤或對端關閉 (回呼時才會出現,不需註冊)
+#define EVENT_EDGE    0x08u   ///< edge 觸發 (註冊時使用,回呼必須讀到 EAGAIN)
+#define EVENT_EXCLUSIVE 0x10u ///< 多個迴圈共用同一 fd 時只喚醒其中一個 (只能在註冊時使用)
+
+typedef struct event_loop event_loop_t;
+
+/**
+ * @brief fd 事件回呼
+ *
+ * @param loop 事件迴圈
+ * @param fd 觸發的 fd
+ * @param events 發生的事件 (EVENT_READ / EVENT_WRITE / EVENT_ERROR)
+ * @param user_data 註冊時提供的資料
+ */
+typedef void (*event_fd_cb)(event_loop_t *loop, int fd, uint32_t events, void *user_data);
+
+/**
+ * @brief 計時器回呼
+ *
+ * @param timer_id event_loop_add_timer() 回傳的編號
+ * @param expirations 上次回呼後到期的次數 (迴圈忙碌時可能大於 1)
+ */
+typedef void (*event_timer_cb)(event_loop_t *loop, int timer_id, uint64_t expirations,
+                               void *user_data);
+
+/**
+ * @brief 訊號回呼 (在迴圈執行緒中執行,不受 async-signal-safe 限制)
+ */
+typedef void (*event_signal_cb)(event_loop_t *loop, int signo, void *user_data);
+
+/**
+ * @brief 喚醒回呼: 其他執行緒呼叫 event_loop_wakeup() 後在迴圈中執行
+ */
+typedef void (*event_wakeup_cb)(event_loop_t *loop, void *user_data);
+
+// ========================================
+// Event Loop 公開函數
+// ========================================
+
+/**
+ * @brief 建立事件迴圈
+ *
+ * @return 事件迴圈, NULL 表示建立 epoll/eventfd 失敗或記憶體不足
+ */
+event_loop_t* event_loop_create(void);
+
+/**
+ * @brief 釋放事件迴圈
+ *
+ * 關閉計時器與內部 fd;以 event_loop_add_fd() 註冊的 fd 由呼叫端關閉。
+ * 註冊過的訊號維持封鎖
+ */
+void event_loop_destroy(event_loop_t *loop);
+
+/**
+ * @brief 註冊 fd
+ *
+ * @param fd 檔案描述符 (建議為非阻塞)
+ * @param events EVENT_READ / EVENT_WRITE,可加上 EVENT_EDGE 或 EVENT_EXCLUSIVE
+ * @param callback 事件回呼
+ * @param user_data 呼叫端資料
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_ALREADY_EXISTS fd 已註冊
+ * @return GAMING_ERROR_NO_MEMORY 記憶體不足
+ * @return GAMING_ERROR epoll_ctl 失敗 (例如一般檔案)
+ */
+int event_loop_add_fd(event_loop_t *loop, int fd, uint32_t events,
+                      event_fd_cb callback, void *user_data);
+
+/**
+ * @brief 修改已註冊 fd 關注的事件 (例如有資料待送時加上 EVENT_WRITE)
+ *
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_FOUND fd 未註冊
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤 (含 EVENT_EXCLUSIVE 的註冊不可修改)
+ * @return GAMING_ERROR epoll_ctl 失敗
+ */
+int event_loop_modify_fd(event_loop_t *loop, int fd, uint32_t events);
+
+/**
+ * @brief 移除 fd (不會關閉)
+ *
+ * 可在回呼中呼叫;同一批中尚未處理的事件不會再送到已移除的 fd
+ *
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_FOUND fd 未註冊
+ */
+int event_loop_remove_fd(event_loop_t *loop, int fd);
+
+/**
+ * @brief 新增計時器
+ *
+ * @param initial_ms 第一次到期的時間 (> 0)
+ * @param interval_ms 之後的週期,0 表示只觸發一次 (觸發後自動移除)
+ * @param callback 計時器回呼
+ * @param user_data 呼叫端資料
+ * @return > 0 計時器編號
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_NO_MEMORY 記憶體不足
+ * @return GAMING_ERROR 建立 timerfd 失敗
+ */
+int event_loop_add_timer(event_loop_t *loop, unsigned int initial_ms, unsigned int interval_ms,
+                         event_timer_cb callback, void *user_data);
+
+/**
+ * @brief 移除計時器 (可在回呼中呼叫)
+ *
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_FOUND 編號不存在
+ */
+int event_loop_remove_timer(event_loop_t *loop, int timer_id);
+
+/**
+ * @brief 以 signalfd 處理訊號
+ *
+ * 訊號只在呼叫執行緒中被封鎖 (pthread_sigmask),已存在的其他執行緒
+ * 不受影響,訊號仍可能送到它們並以原本的方式處理。請在建立其他
+ * 執行緒之前呼叫,讓新執行緒繼承封鎖狀態,之後改由迴圈送到回呼
+ *
+ * @param signo 訊號編號 (SIGKILL / SIGSTOP 不可用)
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_ALREADY_EXISTS 訊號已註冊
+ * @return GAMING_ERROR 建立 signalfd 失敗
+ */
+int event_loop_add_signal(event_loop_t *loop, int signo, event_signal_cb callback,
+                          void *user_data);
+
+/**
+ * @brief 停止以迴圈處理訊號
+ *
+ * 還原呼叫執行緒在 event_loop_add_signal() 之前的封鎖狀態: 原本未封鎖的
+ * 訊號會解除封鎖,恢復原本的處理方式 (預設動作或 sigaction 設定的處理函數),
+ * 尚未讀取的待處理訊號會立即以該方式送達;原本就封鎖的訊號維持封鎖。
+ * 與 event_loop_add_signal() 相同,其他執行緒的封鎖狀態不會改變。
+ * event_loop_destroy() 對仍註冊的訊號做相同的還原
+ *
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_FOUND 訊號未註冊
+ */
+int event_loop_remove_signal(event_loop_t *loop, int signo);
+
+/**
+ * @brief 設定喚醒回呼,NULL 則移除
+ */
+void event_loop_set_wakeup_handler(event_loop_t *loop, event_wakeup_cb callback,
+                                   void *user_data);
+
+/**
+ * @brief 從任何執行緒喚醒迴圈 (多次喚醒在處理前合併為一次)
+ *
+ * 只做一次 write(),也可在訊號處理函數中呼叫
+ */
+void event_loop_wakeup(event_loop_t *loop);
+
+/**
+ * @brief 要求 event_loop_run() 在目前這批事件處理完後返回 (任何執行緒皆可呼叫)
+ */
+void event_loop_stop(event_loop_t *loop);
+
+/**
+ * @brief 等待並處理一批事件
+ *
+ * @param timeout_ms 最長等待時間,-1 表示直到有事件
+ * @return >= 0 處理的事件數 (逾時為 0)
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR epoll_wait 失敗
+ */
+int event_loop_run_once(event_loop_t *loop, int timeout_ms);
+
+/**
+ * @brief 持續處理事件,直到 event_loop_stop()
+ *
+ * @return GAMING_OK 已停止
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR epoll_wait 失敗
+ */
+int event_loop_run(event_loop_t *loop);
+
+/**
+ * @brief 目前註冊的來源數 (fd + 計時器 + 訊號,不含內部喚醒)
+ */
+int event_loop_source_count(const event_loop_t *loop);
+
+#endif // EVENT_LOOP_H
@@ -0,0 +1,469 @@
+/**
+ * @file flight_recorder.c
+ * @brief Flight Recorder 實作
+ * @version 1.0.0
+ *
+ * 檔案內容: fr_header_t 之後緊接 slot_count 個 fr_slot_t。
+ * 寫入端以 head 原子遞增取得序號 idx,slot 的 seq 寫入中為 0,
+ * 寫入完成為 idx + 1;讀取端前後各讀一次 seq,不一致則略過該筆
+ */
+
+#define _GNU_SOURCE  // CLOCK_REALTIME_COARSE, sigaltstack
+
+#include "flight_recorder.h"
+#include "logger.h"
+#include "logger_binary.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// ========================================
+// 檔案格式
+// ========================================
+
+#define FR_MAGIC          "GFLIGHT1"
+#define FR_MAGIC_LEN      8
+#define FR_VERSION        1
+
+// 當機時印到 stderr 的最多筆數 (完整內容留在檔案中)
+#define FR_CRASH_DUMP_MAX 256
+
+typedef struct {
+    uint32_t seq;                               // 0 寫入中, idx + 1 完成
+    uint32_t sec;
+    uint16_t msec;
+    uint8_t level;
+    uint8_t nargs;
+    uint16_t fmt_len;
+    uint16_t payload_len;
+    char kinds[LOGGER_BIN_MAX_ARGS];
+    char fmt[FLIGHT_RECORDER_FMT_MAX];
+    uint8_t payload[FLIGHT_RECORDER_PAYLOAD_MAX];
+} fr_slot_t;
+
+typedef struct {
+    char magic[FR_MAGIC_LEN];
+    uint32_t version;
+    uint32_t slot_size;
+    uint32_t slot_count;
+    uint32_t pid;                               // 最後開啟的行程
+    uint32_t head;                              // 下一筆的序號
+    uint32_t crash_signal;                      // 當機訊號,0 表示正常
+    uint32_t reserved[8];
+} fr_header_t;
+
+// ========================================
+// 私有變數
+// ========================================
+
+static struct {
+    fr_header_t *header;
+    fr_slot_t *slots;
+    uint32_t mask;
+    size_t map_size;
+    int active;                 // 正在使用映射的執行緒數,close 等到歸零才 munmap
+} fr = { NULL, NULL, 0, 0, 0 };
+
+// 當機訊號處理使用的備用堆疊 (堆疊溢位時原本的堆疊不能用)
+static char crash_stack[64 * 1024];
+
+static const int crash_signals[] = { SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL };
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+static uint32_t round_up_pow2(uint32_t v) {
+    uint32_t n = 1;
+    while (n < v) {
+        n <<= 1;
+    }
+    return n;
+}
+
+static size_t mapping_size(uint32_t slots) {
+    return sizeof(fr_header_t) + (size_t)slots * sizeof(fr_slot_t);
+}
+
+static bool header_valid(const fr_header_t *header, size_t file_size) {
+    return memcmp(header->magic, FR_MAGIC, FR_MAGIC_LEN) == 0 &&
+           header->version == FR_VERSION &&
+           header->slot_size == sizeof(fr_slot_t) &&
+           header->slot_count > 0 &&
+           (header->slot_count & (header->slot_count - 1)) == 0 &&
+           mapping_size(header->slot_count) == file_size;
+}
+
+static void write_all(int fd, const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+}
+
+/**
+ * @brief 開始使用映射 (記錄或傾印)
+ *
+ * 先登記再讀取 header,與 flight_recorder_close() 的「先清除 header 再等待」
+ * 搭配 (皆為 SEQ_CST),close 不會在使用中解除映射
+ *
+ * @return header, NULL 表示未開啟 (此時不需呼叫 mapping_leave)
+ */
+static fr_header_t* mapping_enter(void) {
+    __atomic_add_fetch(&fr.active, 1, __ATOMIC_SEQ_CST);
+    fr_header_t *header = __atomic_load_n(&fr.header, __ATOMIC_SEQ_CST);
+    if (header == NULL) {
+        __atomic_sub_fetch(&fr.active, 1, __ATOMIC_RELEASE);
+    }
+    return header;
+}
+
+static void mapping_leave(void) {
+    __atomic_sub_fetch(&fr.active, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief UTC 時間字串 "YYYY-mm-dd HH:MM:SS.mmm"
+ *
+ * 不呼叫 localtime/gmtime (會取鎖),當機訊號處理中也能使用
+ */
+static void format_utc(uint32_t sec, unsigned int msec, char *out, size_t size) {
+    uint32_t days = sec / 86400;
+    uint32_t rem = sec % 86400;
+
+    // 由 1970-01-01 起的天數換算年月日 (civil from days)
+    int32_t z = (int32_t)days + 719468;
+    int32_t era = z / 146097;
+    uint32_t doe = (uint32_t)(z - era * 146097);
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int32_t year = (int32_t)yoe + era * 400;
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint32_t mp = (5 * doy + 2) / 153;
+    uint32_t day = doy - (153 * mp + 2) / 5 + 1;
+    uint32_t month = mp < 10 ? mp + 3 : mp - 9;
+    if (month <= 2) {
+        year++;
+    }
+
+    snprintf(out, size, "%04d-%02u-%02u %02u:%02u:%02u.%03u",
+             (int)year, month, day, rem / 3600, (rem / 60) % 60, rem % 60, msec);
+}
+
+/**
+ * @brief 以序號驗證讀出一致的 slot
+ * @return true 成功, false 已被覆寫或寫入中
+ */
+static bool read_slot(const fr_slot_t *slots, uint32_t mask, uint32_t idx, fr_slot_t *copy) {
+    const fr_slot_t *slot = &slots[idx & mask];
+
+    uint32_t seq1 = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+    if (seq1 != idx + 1) {
+        return false;
+    }
+    memcpy(copy, slot, sizeof(*copy));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    uint32_t seq2 = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+
+    return seq2 == seq1;
+}
+
+/**
+ * @brief 將映射內容以文字輸出 (舊 → 新)
+ * @return 輸出的筆數
+ */
+static int dump_mapping(const fr_header_t *header, const fr_slot_t *slots,
+                        int fd, unsigned int max_records) {
+    char line[LOGGER_MSG_MAX + 64];
+    char msg[LOGGER_MSG_MAX];
+    char fmt[FLIGHT_RECORDER_FMT_MAX + 1];
+    char timestamp[96];
+    fr_slot_t copy;
+
+    uint32_t mask = header->slot_count - 1;
+    uint32_t head = __atomic_load_n(&header->head, __ATOMIC_ACQUIRE);
+    uint32_t count = (head < header->slot_count) ? head : header->slot_count;
+    if (max_records > 0 && count > max_records) {
+        count = max_records;
+    }
+
+    int n = snprintf(line, sizeof(line),
+                     "# flight recorder: pid %u, %u records, signal %u (times in UTC)\n",
+                     header->pid, head, header->crash_signal);
+    write_all(fd, line, (size_t)n);
+
+    int written = 0;
+    for (uint32_t idx = head - count; idx != head; idx++) {
+        if (!read_slot(slots, mask, idx, &copy)) {
+            continue;
+        }
+
+        size_t fmt_len = copy.fmt_len < FLIGHT_RECORDER_FMT_MAX ?
+                         copy.fmt_len : FLIGHT_RECORDER_FMT_MAX;
+        size_t payload_len = copy.payload_len < FLIGHT_RECORDER_PAYLOAD_MAX ?
+                             copy.payload_len : FLIGHT_RECORDER_PAYLOAD_MAX;
+        int nargs = copy.nargs < LOGGER_BIN_MAX_ARGS ? copy.nargs : LOGGER_BIN_MAX_ARGS;
+        memcpy(fmt, copy.fmt, fmt_len);
+        fmt[fmt_len] = '\0';
+
+        logger_bin_format(fmt, copy.kinds, nargs, copy.payload, payload_len,
+                          msg, sizeof(msg));
+        format_utc(copy.sec, copy.msec, timestamp, sizeof(timestamp));
+
+        n = snprintf(line, sizeof(line), "[%s] [%s] %s\n", timestamp,
+                     logger_level_string((log_level_t)copy.level), msg);
+        if (n > (int)sizeof(line) - 1) {
+            n = (int)sizeof(line) - 1;
+            line[n - 1] = '\n';
+        }
+        write_all(fd, line, (size_t)n);
+        written++;
+    }
+
+    return written;
+}
+
+/**
+ * @brief 直接寫入一筆 (不經過 logger)
+ */
+static void record_direct(log_level_t level, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    flight_recorder_record(level, fmt, args);
+    va_end(args);
+}
+
+static void crash_handler(int sig) {
+    char msg[96];
+    fr_header_t *header = __atomic_load_n(&fr.header, __ATOMIC_ACQUIRE);
+
+    if (header != NULL) {
+        header->crash_signal = (uint32_t)sig;
+
+        int n = snprintf(msg, sizeof(msg),
+                         "*** fatal signal %d, flight recorder dump follows ***\n", sig);
+        write_all(STDERR_FILENO, msg, (size_t)n);
+        dump_mapping(header, fr.slots, STDERR_FILENO, FR_CRASH_DUMP_MAX);
+    }
+
+    // SA_RESETHAND 已恢復預設動作,重新送出訊號以產生正常的結束狀態
+    raise(sig);
+}
+
+// ========================================
+// 公開函數實作
+// ========================================
+
+int flight_recorder_open(const char *path, unsigned int slots) {
+    if (slots > FLIGHT_RECORDER_MAX_SLOTS) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    if (flight_recorder_is_open()) {
+        return GAMING_ERROR_ALREADY_EXISTS;
+    }
+
+    const char *file = path ? path : FLIGHT_RECORDER_DEFAULT_PATH;
+    uint32_t count = round_up_pow2(slots ? slots : FLIGHT_RECORDER_DEFAULT_SLOTS);
+    size_t size = mapping_size(count);
+
+    int fd = open(file, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Flight recorder: Failed to open %s: %s\n", file, strerror(errno));
+        return GAMING_ERROR_IO;
+    }
+
+    // 同樣格式的舊檔案 (例如 respawn 前的行程留下的) 保留內容
+    struct stat st;
+    bool keep = false;
+    fr_header_t old;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size == size &&
+        pread(fd, &old, sizeof(old), 0) == (ssize_t)sizeof(old) &&
+        header_valid(&old, size) && old.slot_count == count) {
+        keep = true;
+    }
+
+    if (!keep && (ftruncate(fd, 0) != 0 || ftruncate(fd, (off_t)size) != 0)) {
+        fprintf(stderr, "Flight recorder: Failed to size %s: %s\n", file, strerror(errno));
+        close(fd);
+        return GAMING_ERROR_IO;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Flight recorder: mmap %s failed: %s\n", file, strerror(errno));
+        return GAMING_ERROR_IO;
+    }
+
+    fr_header_t *header = map;
+    uint32_t previous_pid = 0;
+    uint32_t previous_signal = 0;
+    if (keep) {
+        previous_pid = header->pid;
+        previous_signal = header->crash_signal;
+    } else {
+        memcpy(header->magic, FR_MAGIC, FR_MAGIC_LEN);
+        header->version = FR_VERSION;
+        header->slot_size = sizeof(fr_slot_t);
+        header->slot_count = count;
+        header->head = 0;
+    }
+    header->pid = (uint32_t)getpid();
+    header->crash_signal = 0;
+
+    fr.slots = (fr_slot_t *)(header + 1);
+    fr.mask = count - 1;
+    fr.map_size = size;
+    __atomic_store_n(&fr.header, header, __ATOMIC_RELEASE);
+
+    if (keep) {
+        record_direct(LOG_LEVEL_INFO, "flight recorder reopened (previous pid %u, signal %u)",
+                      previous_pid, previous_signal);
+    }
+
+    logger_set_trace_hook(flight_recorder_record);
+    return GAMING_OK;
+}
+
+void flight_recorder_close(void) {
+    fr_header_t *header = __atomic_load_n(&fr.header, __ATOMIC_ACQUIRE);
+    if (header == NULL) {
+        return;
+    }
+
+    logger_set_trace_hook(NULL);
+    __atomic_store_n(&fr.header, NULL, __ATOMIC_SEQ_CST);
+
+    // 等待已取得 header 的記錄 / 傾印完成 (只需要寫完一個 slot)
+    while (__atomic_load_n(&fr.active, __ATOMIC_ACQUIRE) > 0) {
+        sched_yield();
+    }
+    munmap(header, fr.map_size);
+    fr.slots = NULL;
+}
+
+bool flight_recorder_is_open(void) {
+    return __atomic_load_n(&fr.header, __ATOMIC_ACQUIRE) != NULL;
+}
+
+void flight_recorder_record(log_level_t level, const char *fmt, va_list args) {
+    if (fmt == NULL) {
+        return;
+    }
+    fr_header_t *header = mapping_enter();
+    if (header == NULL) {
+        return;
+    }
+
+    uint32_t idx = __atomic_fetch_add(&header->head, 1, __ATOMIC_RELAXED);
+    fr_slot_t *slot = &((fr_slot_t *)(header + 1))[idx & fr.mask];
+
+    // 標記寫入中
+    __atomic_store_n(&slot->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    struct timespec ts;
+#ifdef CLOCK_REALTIME_COARSE
+    clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+#else
+    clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+
+    size_t fmt_len = strnlen(fmt, FLIGHT_RECORDER_FMT_MAX);
+    slot->sec = (uint32_t)ts.tv_sec;
+    slot->msec = (uint16_t)(ts.tv_nsec / 1000000L);
+    slot->level = (uint8_t)level;
+    slot->fmt_len = (uint16_t)fmt_len;
+    memcpy(slot->fmt, fmt, fmt_len);
+    slot->payload_len = (uint16_t)logger_bin_pack(fmt, args, slot->kinds, &slot->nargs,
+                                                  slot->payload,
+                                                  FLIGHT_RECORDER_PAYLOAD_MAX);
+
+    __atomic_store_n(&slot->seq, idx + 1, __ATOMIC_RELEASE);
+    mapping_leave();
+}
+
+int flight_recorder_dump_fd(int fd, unsigned int max_records) {
+    fr_header_t *header = mapping_enter();
+    if (header == NULL) {
+        return GAMING_ERROR_NOT_INITIALIZED;
+    }
+
+    int ret = dump_mapping(header, (fr_slot_t *)(header + 1), fd, max_records);
+    mapping_leave();
+    return ret;
+}
+
+int flight_recorder_dump_file(const char *path, int fd) {
+    const char *file = path ? path : FLIGHT_RECORDER_DEFAULT_PATH;
+
+    int in = open(file, O_RDONLY | O_CLOEXEC);
+    if (in < 0) {
+        fprintf(stderr, "Flight recorder: Failed to open %s: %s\n", file, strerror(errno));
+        return GAMING_ERROR_IO;
+    }
+
+    struct stat st;
+    if (fstat(in, &st) != 0 || (size_t)st.st_size < sizeof(fr_header_t)) {
+        close(in);
+        return GAMING_ERROR_IO;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_SHARED, in, 0);
+    close(in);
+    if (map == MAP_FAILED) {
+        return GAMING_ERROR_IO;
+    }
+
+    int ret = GAMING_ERROR_IO;
+    const fr_header_t *header = map;
+    if (header_valid(header, size)) {
+        ret = dump_mapping(header, (const fr_slot_t *)(header + 1), fd, 0);
+    }
+
+    munmap(map, size);
+    return ret;
+}
+
+int flight_recorder_install_crash_handler(void) {
+    stack_t ss;
+    struct sigaction sa;
+
+    memset(&ss, 0, sizeof(ss));
+    ss.ss_sp = crash_stack;
+    ss.ss_size = sizeof(crash_stack);
+    if (sigaltstack(&ss, NULL) != 0) {
+        fprintf(stderr, "Flight recorder: sigaltstack failed: %s\n", strerror(errno));
+        return GAMING_ERROR;
+    }
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = crash_handler;
+    sa.sa_flags = SA_ONSTACK | SA_RESETHAND;
+    sigemptyset(&sa.sa_mask);
+
+    for (size_t i = 0; i < sizeof(crash_signals) / sizeof(crash_signals[0]); i++) {
+        if (sigaction(crash_signals[i], &sa, NULL) != 0) {
+            fprintf(stderr, "Flight recorder: sigaction(%d) failed: %s\n",
+                    crash_signals[i], strerror(errno));
+            return GAMING_ERROR;
+        }
+    }
+
+    return GAMING_OK;
+}
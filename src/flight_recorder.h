@@ -0,0 +1,107 @@
+/**
+ * @file flight_recorder.h
+ * @brief Flight Recorder - 當機後仍可讀取的記憶體環形追蹤緩衝區
+ * @version 1.0.0
+ *
+ * 以檔案為後盾的共享映射 (MAP_SHARED,預設放在 /var/run 的 tmpfs) 保存
+ * 最近的日誌,包含目前等級不會輸出的 DEBUG:
+ *
+ * - 透過 logger 的追蹤掛勾接收每一筆日誌,只複製格式字串與原始參數,
+ *   不做 printf 格式化
+ * - 多執行緒以原子遞增取得位置,每個 slot 以序號標記寫入完成
+ * - 行程當機後映射內容仍留在檔案中,procd respawn 重新開啟時保留舊內容,
+ *   可用 gaming-flightdump 讀出
+ * - flight_recorder_install_crash_handler() 在 SIGSEGV/SIGABRT 等訊號時
+ *   把緩衝區印到 stderr 後再以預設動作結束
+ */
+
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include "gaming_common.h"
+#include <stdarg.h>
+
+// ========================================
+// Flight Recorder 配置
+// ========================================
+
+// 預設檔案路徑
+#define FLIGHT_RECORDER_DEFAULT_PATH   "/var/run/gaming.flight"
+
+// 預設 slot 數 (會向上取整為 2 的冪次)
+#define FLIGHT_RECORDER_DEFAULT_SLOTS  1024
+
+// slot 數上限
+#define FLIGHT_RECORDER_MAX_SLOTS      65536
+
+// 每筆記錄保存的格式字串與參數上限
+#define FLIGHT_RECORDER_FMT_MAX        96
+#define FLIGHT_RECORDER_PAYLOAD_MAX    120
+
+// ========================================
+// Flight Recorder 公開函數
+// ========================================
+
+/**
+ * @brief 開啟 (或建立) 記錄檔並掛到 logger
+ *
+ * 既有檔案的格式與大小相同時保留內容繼續寫入,否則重新初始化
+ *
+ * @param path 檔案路徑,NULL 則使用 FLIGHT_RECORDER_DEFAULT_PATH
+ * @param slots 記錄筆數,0 則使用 FLIGHT_RECORDER_DEFAULT_SLOTS
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_ALREADY_EXISTS 已開啟
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_IO 建立或映射檔案失敗
+ */
+int flight_recorder_open(const char *path, unsigned int slots);
+
+/**
+ * @brief 從 logger 移除並解除映射 (檔案保留)
+ *
+ * 會等待其他執行緒中進行中的記錄完成後才解除映射,日誌執行緒不需先停止
+ */
+void flight_recorder_close(void);
+
+/**
+ * @brief 是否已開啟
+ */
+bool flight_recorder_is_open(void);
+
+/**
+ * @brief 記錄一筆 (logger 追蹤掛勾,也可直接呼叫)
+ */
+void flight_recorder_record(log_level_t level, const char *fmt, va_list args);
+
+/**
+ * @brief 將目前映射中的記錄以文字寫到 fd (舊 → 新)
+ *
+ * 只使用 write(),可在當機訊號處理中呼叫
+ *
+ * @param fd 輸出檔案描述符
+ * @param max_records 最多輸出筆數,0 表示全部
+ * @return >= 0 輸出的筆數
+ * @return GAMING_ERROR_NOT_INITIALIZED 未開啟
+ */
+int flight_recorder_dump_fd(int fd, unsigned int max_records);
+
+/**
+ * @brief 讀取記錄檔並以文字寫到 fd (供 gaming-flightdump 使用)
+ *
+ * @param path 檔案路徑,NULL 則使用 FLIGHT_RECORDER_DEFAULT_PATH
+ * @param fd 輸出檔案描述符
+ * @return >= 0 輸出的筆數
+ * @return GAMING_ERROR_IO 無法讀取或格式錯誤
+ */
+int flight_recorder_dump_file(const char *path, int fd);
+
+/**
+ * @brief 安裝當機訊號處理 (SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL)
+ *
+ * 訊號發生時記下訊號編號,把緩衝區印到 stderr,再以預設動作結束
+ *
+ * @return GAMING_OK 成功, GAMING_ERROR 安裝失敗
+ */
+int flight_recorder_install_crash_handler(void);
+
+#endif // FLIGHT_RECORDER_H
@@ -49,6 +49,17 @@ typedef enum {
     PS5_STATE_OFF = 3,
 } ps5_state_t;
 
+// ========================================
+// VPN 狀態定義
+// ========================================
+typedef enum {
+    VPN_STATE_UNKNOWN = 0,
+    VPN_STATE_DISCONNECTED = 1,
+    VPN_STATE_CONNECTING = 2,
+    VPN_STATE_CONNECTED = 3,
+    VPN_STATE_ERROR = 4,
+} vpn_state_t;
+
 // ========================================
 // LED 顏色定義
 // ========================================
@@ -84,6 +95,7 @@ typedef struct {
 #define PATH_DEVICE_TYPE_CACHE  PATH_RUN_DIR "/gaming_device_type"
 #define PATH_VPN_SOCKET    PATH_RUN_DIR "/vpn_status.sock"
 #define PATH_BUTTON_SOCKET PATH_RUN_DIR "/gaming_button.sock"
+#define PATH_STATE_BUS_SOCKET   PATH_RUN_DIR "/gaming_bus.sock"
 #define PATH_PS5_IP_CACHE  PATH_RUN_DIR "/ps5_ip.cache"
 #define PATH_PS5_MAC_CACHE PATH_RUN_DIR "/ps5_mac.txt"
 
@@ -1,5 +1,6 @@
 #include "gpio_lib.h"
-#include <stdio.h>
+#include "logger.h"
+#include "logger_fields.h"
 #include <errno.h>
 
 // ========================================
@@ -15,50 +16,50 @@ extern hal_ops_t *hal_ops;
 
 int gpio_lib_init_output(int pin) {
     if (!hal_ops) {
-        fprintf(stderr, "GPIO lib not initialized (HAL is NULL)\n");
+        logger_mod(LOG_MODULE_GPIO, LOG_LEVEL_ERROR, "GPIO lib not initialized (HAL is NULL)");
         return GAMING_ERROR_NOT_INITIALIZED;
     }
     
     int ret = hal_ops->gpio_init(pin, HAL_GPIO_DIR_OUTPUT);
     if (ret < 0) {
-        fprintf(stderr, "Failed to init GPIO%d as output: %d\n", pin, ret);
+        logger_kv(LOG_MODULE_GPIO, LOG_LEVEL_ERROR, "Failed to init GPIO",
+                  LOG_KV_PIN(pin), LOG_KV_STR("dir", "output"), LOG_KV_INT("ret", ret));
         return GAMING_ERROR_HAL_FAILED;
     }
     
-    #ifdef DEBUG
-    printf("GPIO%d initialized as output\n", pin);
-    #endif
+    logger_kv(LOG_MODULE_GPIO, LOG_LEVEL_DEBUG, "GPIO initialized",
+              LOG_KV_PIN(pin), LOG_KV_STR("dir", "output"));
     
     return GAMING_OK;
 }
 
 int gpio_lib_init_input(int pin) {
     if (!hal_ops) {
-        fprintf(stderr, "GPIO lib not initialized (HAL is NULL)\n");
+        logger_mod(LOG_MODULE_GPIO, LOG_LEVEL_ERROR, "GPIO lib not initialized (HAL is NULL)");
         return GAMING_ERROR_NOT_INITIALIZED;
     }
     
     int ret = hal_ops->gpio_init(pin, HAL_GPIO_DIR_INPUT);
     if (ret < 0) {
-        fprintf(stderr, "Failed to init GPIO%d as input: %d\n", pin, ret);
+        logger_kv(LOG_MODULE_GPIO, LOG_LEVEL_ERROR, "Failed to init GPIO",
+                  LOG_KV_PIN(pin), LOG_KV_STR("dir", "input"), LOG_KV_INT("ret", ret));
         return GAMING_ERROR_HAL_FAILED;
     }
     
-    #ifdef DEBUG
-    printf("GPIO%d initialized as input\n", pin);
-    #endif
+    logger_kv(LOG_MODULE_GPIO, LOG_LEVEL_DEBUG, "GPIO initialized",
+              LOG_KV_PIN(pin), LOG_KV_STR("dir", "input"));
     
     return GAMING_OK;
 }
 
 int gpio_lib_init_input_irq(int pin, const char *edge) {
     if (!hal_ops) {
-        fprintf(stderr, "GPIO lib not initialized (HAL is NULL)\n");
+        logger_mod(LOG_MODULE_GPIO, LOG_LEVEL_ERROR, "GPIO lib not initialized (HAL is NULL)");
         return GAMING_ERROR_NOT_INITIALIZED;
     }
     
     if (!edge) {
-        fprintf(stderr, "Invalid edge parameter\n");
+        logger_mod(LOG_MODULE_GPIO, LOG_LEVEL_ERROR, "Invalid edge parameter");
         return GAMING_ERROR_INVALID_PARAM;
     }
     
@@ -72,7 +73,8 @@ int gpio_lib_init_input_irq(int pin, const char *edge) {
     if (hal_ops->gpio_set_edge) {
         ret = hal_ops->gpio_set_edge(pin, edge);
         if (ret < 0) {
-            fprintf(stderr, "Failed to set GPIO%d edge: %d\n", pin, ret);
+            logger_kv(LOG_MODULE_GPIO, LOG_LEVEL_ERROR, "Failed to set GPIO edge",
+                      LOG_KV_PIN(pin), LOG_KV_STR("edge", edge), LOG_KV_INT("ret", ret));
             return GAMING_ERROR_HAL_FAILED;
         }
     }
@@ -91,7 +93,9 @@ int gpio_lib_read(int pin) {
     
     int value = hal_ops->gpio_read(pin);
     if (value < 0) {
-        fprintf(stderr, "Failed to read GPIO%d: %d\n", pin, value);
+        // 輪詢迴圈中持續失敗時只輸出摘要,避免洗版
+        logger_kv_ratelimited(LOG_MODULE_GPIO, LOG_LEVEL_ERROR, "Failed to read GPIO",
+                              LOG_KV_PIN(pin), LOG_KV_INT("ret", value));
         return GAMING_ERROR_HAL_FAILED;
     }
     
@@ -106,7 +110,8 @@ int gpio_lib_write(int pin, int value) {
     hal_gpio_value_t hal_value = value ? HAL_GPIO_HIGH : HAL_GPIO_LOW;
     int ret = hal_ops->gpio_write(pin, hal_value);
     if (ret < 0) {
-        fprintf(stderr, "Failed to write GPIO%d: %d\n", pin, ret);
+        logger_kv_ratelimited(LOG_MODULE_GPIO, LOG_LEVEL_ERROR, "Failed to write GPIO",
+                              LOG_KV_PIN(pin), LOG_KV_INT("value", value), LOG_KV_INT("ret", ret));
         return GAMING_ERROR_HAL_FAILED;
     }
     
@@ -136,7 +141,8 @@ int gpio_lib_cleanup(int pin) {
     if (hal_ops->gpio_deinit) {
         int ret = hal_ops->gpio_deinit(pin);
         if (ret < 0) {
-            fprintf(stderr, "Failed to cleanup GPIO%d: %d\n", pin, ret);
+            logger_kv(LOG_MODULE_GPIO, LOG_LEVEL_ERROR, "Failed to cleanup GPIO",
+                      LOG_KV_PIN(pin), LOG_KV_INT("ret", ret));
             return GAMING_ERROR_HAL_FAILED;
         }
     }
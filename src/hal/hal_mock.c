@@ -32,10 +32,15 @@ static struct {
 } mock_gpio_state[MAX_GPIO_PINS];
 
 // ADC 狀態
+#define MAX_ADC_SEQUENCE 64
+
 static struct {
     int value;
     bool enabled;
-} mock_adc_state = {0, true};
+    int sequence[MAX_ADC_SEQUENCE];  // 連續取樣時依序返回 (模擬雜訊)
+    int sequence_len;
+    int sequence_pos;
+} mock_adc_state = {0, true, {0}, 0, 0};
 
 // PWM 狀態
 static struct {
@@ -248,11 +253,48 @@ static int mock_adc_read(const char *device) {
     
     mock_stats.adc_read_count++;
     
+    int value = mock_adc_state.value;
+    if (mock_adc_state.sequence_len > 0) {
+        value = mock_adc_state.sequence[mock_adc_state.sequence_pos];
+        mock_adc_state.sequence_pos = (mock_adc_state.sequence_pos + 1) % mock_adc_state.sequence_len;
+    }
+    
     #ifdef DEBUG
-    printf("Mock ADC read: %d\n", mock_adc_state.value);
+    printf("Mock ADC read: %d\n", value);
     #endif
     
-    return mock_adc_state.value;
+    return value;
+}
+
+/**
+ * @brief 連續讀取 ADC 樣本 (Mock)
+ * @param device ADC 設備路徑
+ * @param samples 輸出緩衝區
+ * @param count 樣本數
+ * @return 取得的樣本數, <0 失敗
+ */
+static int mock_adc_read_burst(const char *device, int *samples, int count) {
+    if (!samples || count <= 0) {
+        return -1;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        int value = mock_adc_read(device);
+        if (value < 0) {
+            return value;
+        }
+        samples[i] = value;
+    }
+    
+    return count;
+}
+
+/**
+ * @brief 關閉 ADC (Mock)
+ * @return 0
+ */
+static int mock_adc_close(void) {
+    return 0;
 }
 
 // ========================================
@@ -369,6 +411,8 @@ static hal_ops_t mock_hal_ops = {
     .gpio_write = mock_gpio_write,
     .gpio_set_edge = mock_gpio_set_edge,
     .adc_read = mock_adc_read,
+    .adc_read_burst = mock_adc_read_burst,
+    .adc_close = mock_adc_close,
     .pwm_init = mock_pwm_init,
     .pwm_set_duty = mock_pwm_set_duty,
     .pwm_deinit = mock_pwm_deinit,
@@ -400,6 +444,26 @@ void mock_hal_set_adc_value(int value) {
     #endif
 }
 
+/**
+ * @brief 設定 Mock ADC 連續取樣序列 (測試用，模擬雜訊)
+ * @param values 樣本序列, NULL 或 count 為 0 則清除序列
+ * @param count 樣本數 (最多 MAX_ADC_SEQUENCE)
+ */
+void mock_hal_set_adc_sequence(const int *values, int count) {
+    if (!values || count <= 0) {
+        mock_adc_state.sequence_len = 0;
+        mock_adc_state.sequence_pos = 0;
+        return;
+    }
+    
+    if (count > MAX_ADC_SEQUENCE) {
+        count = MAX_ADC_SEQUENCE;
+    }
+    memcpy(mock_adc_state.sequence, values, count * sizeof(int));
+    mock_adc_state.sequence_len = count;
+    mock_adc_state.sequence_pos = 0;
+}
+
 /**
  * @brief 設定 Mock GPIO 值 (測試用，模擬外部輸入)
  * @param pin GPIO 引腳編號
@@ -544,6 +608,8 @@ void mock_hal_reset(void) {
     // 重置 ADC 狀態
     mock_adc_state.value = 0;
     mock_adc_state.enabled = true;
+    mock_adc_state.sequence_len = 0;
+    mock_adc_state.sequence_pos = 0;
     
     // 重置 PWM 狀態
     for (int i = 0; i < MAX_PWM_CHANNELS; i++) {
@@ -10,7 +10,10 @@
  * @version 1.1 (Fixed to match hal_interface.h)
  */
 
+#define _GNU_SOURCE  /* O_CLOEXEC, pread, usleep */
+
 #include "../hal_interface.h"
+#include "../logger.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -18,6 +21,7 @@
 #include <unistd.h>
 #include <sys/stat.h>
 #include <errno.h>
+#include <pthread.h>
 
 /* GPIO sysfs paths */
 #define GPIO_SYSFS_PATH "/sys/class/gpio"
@@ -27,12 +31,8 @@
 /* ADC device path */
 #define ADC_DEVICE_PATH "/dev/ADC"
 
-/* Debug output */
-#ifdef DEBUG
-#define DEBUG_PRINT(fmt, ...) fprintf(stderr, "[HAL Real] " fmt "\n", ##__VA_ARGS__)
-#else
-#define DEBUG_PRINT(fmt, ...) do {} while(0)
-#endif
+/* Debug output (runtime level of the "hal" logger module) */
+#define DEBUG_PRINT(fmt, ...) logger_mod(LOG_MODULE_HAL, LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
 
 /* ============================================================================
  * GPIO Helper Functions
@@ -47,7 +47,8 @@ static int gpio_export(int pin) {
     
     fd = open(GPIO_EXPORT_PATH, O_WRONLY);
     if (fd < 0) {
-        fprintf(stderr, "[HAL Real] Failed to open GPIO export: %s\n", strerror(errno));
+        logger_mod(LOG_MODULE_HAL, LOG_LEVEL_ERROR,
+                   "Failed to open GPIO export: %s", strerror(errno));
         return -1;
     }
     
@@ -55,7 +56,8 @@ static int gpio_export(int pin) {
     if (write(fd, buf, strlen(buf)) < 0) {
         // Pin might already be exported, not necessarily an error
         if (errno != EBUSY) {
-            fprintf(stderr, "[HAL Real] Failed to export GPIO %d: %s\n", pin, strerror(errno));
+            logger_mod(LOG_MODULE_HAL, LOG_LEVEL_ERROR,
+                       "Failed to export GPIO %d: %s", pin, strerror(errno));
             close(fd);
             return -1;
         }
@@ -75,7 +77,8 @@ static int gpio_unexport(int pin) {
     
     fd = open(GPIO_UNEXPORT_PATH, O_WRONLY);
     if (fd < 0) {
-        fprintf(stderr, "[HAL Real] Failed to open GPIO unexport: %s\n", strerror(errno));
+        logger_mod(LOG_MODULE_HAL, LOG_LEVEL_ERROR,
+                   "Failed to open GPIO unexport: %s", strerror(errno));
         return -1;
     }
     
@@ -97,14 +100,14 @@ static int gpio_set_direction(int pin, const char *direction) {
     
     fd = open(path, O_WRONLY);
     if (fd < 0) {
-        fprintf(stderr, "[HAL Real] Failed to set GPIO %d direction: %s\n", 
-                pin, strerror(errno));
+        logger_mod(LOG_MODULE_HAL, LOG_LEVEL_ERROR, "Failed to set GPIO %d direction: %s",
+                   pin, strerror(errno));
         return -1;
     }
     
     if (write(fd, direction, strlen(direction)) < 0) {
-        fprintf(stderr, "[HAL Real] Failed to write GPIO %d direction: %s\n",
-                pin, strerror(errno));
+        logger_mod(LOG_MODULE_HAL, LOG_LEVEL_ERROR, "Failed to write GPIO %d direction: %s",
+                   pin, strerror(errno));
         close(fd);
         return -1;
     }
@@ -171,14 +174,14 @@ static int hal_real_gpio_read(int pin) {
     
     fd = open(path, O_RDONLY);
     if (fd < 0) {
-        fprintf(stderr, "[HAL Real] Failed to open GPIO %d for reading: %s\n",
-                pin, strerror(errno));
+        logger_mod_ratelimited(LOG_MODULE_HAL, LOG_LEVEL_ERROR,
+                               "Failed to open GPIO %d for reading: %s", pin, strerror(errno));
         return -1;
     }
     
     if (read(fd, &value, 1) != 1) {
-        fprintf(stderr, "[HAL Real] Failed to read GPIO %d: %s\n",
-                pin, strerror(errno));
+        logger_mod_ratelimited(LOG_MODULE_HAL, LOG_LEVEL_ERROR,
+                               "Failed to read GPIO %d: %s", pin, strerror(errno));
         close(fd);
         return -1;
     }
@@ -206,8 +209,8 @@ static int hal_real_gpio_write(int pin, hal_gpio_value_t value) {
     
     fd = open(path, O_WRONLY);
     if (fd < 0) {
-        fprintf(stderr, "[HAL Real] Failed to open GPIO %d for writing: %s\n",
-                pin, strerror(errno));
+        logger_mod_ratelimited(LOG_MODULE_HAL, LOG_LEVEL_ERROR,
+                               "Failed to open GPIO %d for writing: %s", pin, strerror(errno));
         return -1;
     }
     
@@ -215,8 +218,8 @@ static int hal_real_gpio_write(int pin, hal_gpio_value_t value) {
     buf[1] = '\0';
     
     if (write(fd, buf, 1) != 1) {
-        fprintf(stderr, "[HAL Real] Failed to write GPIO %d: %s\n",
-                pin, strerror(errno));
+        logger_mod_ratelimited(LOG_MODULE_HAL, LOG_LEVEL_ERROR,
+                               "Failed to write GPIO %d: %s", pin, strerror(errno));
         close(fd);
         return -1;
     }
@@ -243,14 +246,14 @@ static int hal_real_gpio_set_edge(int pin, const char *edge) {
     
     fd = open(path, O_WRONLY);
     if (fd < 0) {
-        fprintf(stderr, "[HAL Real] Failed to open GPIO %d edge: %s\n",
-                pin, strerror(errno));
+        logger_mod(LOG_MODULE_HAL, LOG_LEVEL_ERROR, "Failed to open GPIO %d edge: %s",
+                   pin, strerror(errno));
         return -1;
     }
     
     if (write(fd, edge, strlen(edge)) < 0) {
-        fprintf(stderr, "[HAL Real] Failed to set GPIO %d edge: %s\n",
-                pin, strerror(errno));
+        logger_mod(LOG_MODULE_HAL, LOG_LEVEL_ERROR, "Failed to set GPIO %d edge: %s",
+                   pin, strerror(errno));
         close(fd);
         return -1;
     }
@@ -264,41 +267,156 @@ static int hal_real_gpio_set_edge(int pin, const char *edge) {
  * ADC Operations
  * ========================================================================== */
 
+/* The ADC node is kept open between reads; reopening it for every sample
+ * costs an open/close pair per reading and dominates burst sampling. */
+static int adc_fd = -1;
+static char adc_fd_path[128];
+static int adc_fd_is_text;   /* IIO sysfs in_voltageX_raw: decimal text */
+static pthread_mutex_t adc_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Get the cached ADC fd, reopening it if the device path changed
+ *
+ * Must be called with adc_lock held.
+ */
+static int adc_get_fd(const char *adc_path) {
+    if (adc_fd >= 0 && strcmp(adc_fd_path, adc_path) == 0) {
+        return adc_fd;
+    }
+    
+    if (adc_fd >= 0) {
+        close(adc_fd);
+        adc_fd = -1;
+    }
+    
+    adc_fd = open(adc_path, O_RDONLY | O_CLOEXEC);
+    if (adc_fd < 0) {
+        logger_mod_ratelimited(LOG_MODULE_HAL, LOG_LEVEL_ERROR,
+                               "Failed to open ADC device %s: %s (hardware not ready)",
+                               adc_path, strerror(errno));
+        return -1;
+    }
+    
+    strncpy(adc_fd_path, adc_path, sizeof(adc_fd_path) - 1);
+    adc_fd_path[sizeof(adc_fd_path) - 1] = '\0';
+    
+    size_t len = strlen(adc_path);
+    adc_fd_is_text = (len > 4 && strcmp(adc_path + len - 4, "_raw") == 0);
+    DEBUG_PRINT("ADC device opened: %s", adc_path);
+    return adc_fd;
+}
+
+/**
+ * @brief Read one sample from the cached ADC fd
+ *
+ * Uses pread at offset 0 so seekable nodes return a fresh sample on every
+ * call; falls back to read() for nodes that are not seekable.
+ * IIO sysfs attributes (in_voltageX_raw) are decimal text and are re-read
+ * from offset 0 as well, which makes the kernel sample the channel again.
+ * Must be called with adc_lock held.
+ */
+static int adc_read_sample(int fd) {
+    unsigned short value;
+    ssize_t bytes_read;
+    
+    if (adc_fd_is_text) {
+        char text[16];
+        bytes_read = pread(fd, text, sizeof(text) - 1, 0);
+        if (bytes_read <= 0) {
+            logger_mod_ratelimited(LOG_MODULE_HAL, LOG_LEVEL_ERROR,
+                                   "Failed to read ADC value: %s", strerror(errno));
+            return -1;
+        }
+        text[bytes_read] = '\0';
+        return atoi(text);
+    }
+    
+    bytes_read = pread(fd, &value, sizeof(value), 0);
+    if (bytes_read < 0 && errno == ESPIPE) {
+        bytes_read = read(fd, &value, sizeof(value));
+    }
+    
+    if (bytes_read != sizeof(value)) {
+        logger_mod_ratelimited(LOG_MODULE_HAL, LOG_LEVEL_ERROR,
+                               "Failed to read ADC value: %s", strerror(errno));
+        return -1;
+    }
+    
+    return (int)value;
+}
+
 /**
  * @brief Read raw ADC value
  * 
  * @param device ADC device path (NULL to use default)
  * @return ADC value on success, -1 on failure
- * 
- * TODO: Implement actual ADC reading when hardware is available
  */
 static int hal_real_adc_read(const char *device) {
-    int fd;
-    unsigned short value;
-    ssize_t bytes_read;
-    
     DEBUG_PRINT("Reading ADC from device: %s", device ? device : ADC_DEVICE_PATH);
     
     const char *adc_path = device ? device : ADC_DEVICE_PATH;
     
-    fd = open(adc_path, O_RDONLY);
-    if (fd < 0) {
-        fprintf(stderr, "[HAL Real] Failed to open ADC device %s: %s\n",
-                adc_path, strerror(errno));
-        fprintf(stderr, "[HAL Real] ADC reading not available - hardware not ready\n");
+    pthread_mutex_lock(&adc_lock);
+    int fd = adc_get_fd(adc_path);
+    int value = (fd < 0) ? -1 : adc_read_sample(fd);
+    pthread_mutex_unlock(&adc_lock);
+    
+    if (value < 0) {
         return -1;
     }
     
-    bytes_read = read(fd, &value, sizeof(value));
-    close(fd);
-    
-    if (bytes_read != sizeof(value)) {
-        fprintf(stderr, "[HAL Real] Failed to read ADC value: %s\n", strerror(errno));
+    DEBUG_PRINT("ADC value read: %d", value);
+    return value;
+}
+
+/**
+ * @brief Read a burst of ADC samples without reopening the device
+ * 
+ * @param device ADC device path (NULL to use default)
+ * @param samples Output buffer
+ * @param count Number of samples to take
+ * @return Number of samples read on success, -1 on failure
+ */
+static int hal_real_adc_read_burst(const char *device, int *samples, int count) {
+    if (samples == NULL || count <= 0) {
         return -1;
     }
     
-    DEBUG_PRINT("ADC value read: %u", value);
-    return (int)value;
+    const char *adc_path = device ? device : ADC_DEVICE_PATH;
+    int n = 0;
+    
+    pthread_mutex_lock(&adc_lock);
+    int fd = adc_get_fd(adc_path);
+    if (fd >= 0) {
+        for (n = 0; n < count; n++) {
+            int value = adc_read_sample(fd);
+            if (value < 0) {
+                break;
+            }
+            samples[n] = value;
+        }
+    }
+    pthread_mutex_unlock(&adc_lock);
+    
+    DEBUG_PRINT("ADC burst read: %d/%d samples", n, count);
+    return (n > 0) ? n : -1;
+}
+
+/**
+ * @brief Close the cached ADC fd
+ * 
+ * @return 0 on success
+ */
+static int hal_real_adc_close(void) {
+    pthread_mutex_lock(&adc_lock);
+    if (adc_fd >= 0) {
+        close(adc_fd);
+        adc_fd = -1;
+        adc_fd_path[0] = '\0';
+        adc_fd_is_text = 0;
+    }
+    pthread_mutex_unlock(&adc_lock);
+    return 0;
 }
 
 /* ============================================================================
@@ -325,8 +443,8 @@ static int hal_real_pwm_init(int pin, int frequency) {
     
     // Software PWM implementation would require threading or timer
     // For now, just initialize the pin
-    fprintf(stderr, "[HAL Real] Software PWM not fully implemented\n");
-    fprintf(stderr, "[HAL Real] Using simple on/off control instead\n");
+    logger_mod(LOG_MODULE_HAL, LOG_LEVEL_WARN, "Software PWM not fully implemented");
+    logger_mod(LOG_MODULE_HAL, LOG_LEVEL_WARN, "Using simple on/off control instead");
     return 0;
 }
 
@@ -394,6 +512,8 @@ static hal_ops_t hal_real_ops = {
     .gpio_write = hal_real_gpio_write,
     .gpio_set_edge = hal_real_gpio_set_edge,
     .adc_read = hal_real_adc_read,
+    .adc_read_burst = hal_real_adc_read_burst,
+    .adc_close = hal_real_adc_close,
     .pwm_init = hal_real_pwm_init,
     .pwm_set_duty = hal_real_pwm_set_duty,
     .pwm_deinit = hal_real_pwm_deinit,
@@ -415,8 +535,8 @@ hal_ops_t* hal_get_real_ops(void) {
     // Check if GPIO sysfs is accessible
     struct stat st;
     if (stat(GPIO_SYSFS_PATH, &st) != 0) {
-        fprintf(stderr, "[HAL Real] GPIO sysfs not available: %s\n", strerror(errno));
-        fprintf(stderr, "[HAL Real] Make sure kernel has GPIO sysfs support\n");
+        logger_mod(LOG_MODULE_HAL, LOG_LEVEL_ERROR, "GPIO sysfs not available: %s", strerror(errno));
+        logger_mod(LOG_MODULE_HAL, LOG_LEVEL_ERROR, "Make sure kernel has GPIO sysfs support");
         return NULL;
     }
     
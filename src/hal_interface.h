@@ -32,6 +32,8 @@ int hal_gpio_set_edge(int pin, const char *edge);
 
 // ADC 操作
 int hal_adc_read(const char *device);
+int hal_adc_read_burst(const char *device, int *samples, int count);
+int hal_adc_close(void);
 
 // PWM 操作 (for LED)
 int hal_pwm_init(int pin, int frequency);
@@ -51,6 +53,8 @@ typedef struct {
     int (*gpio_write)(int pin, hal_gpio_value_t value);
     int (*gpio_set_edge)(int pin, const char *edge);
     int (*adc_read)(const char *device);
+    int (*adc_read_burst)(const char *device, int *samples, int count);
+    int (*adc_close)(void);
     int (*pwm_init)(int pin, int frequency);
     int (*pwm_set_duty)(int pin, int duty_percent);
     int (*pwm_deinit)(int pin);
@@ -73,6 +77,7 @@ void hal_cleanup(void);
 // ========================================
 #ifdef TEST
 void mock_hal_set_adc_value(int value);
+void mock_hal_set_adc_sequence(const int *values, int count);
 void mock_hal_set_gpio_value(int pin, hal_gpio_value_t value);
 int mock_hal_get_gpio_value(int pin);
 void mock_hal_reset(void);
@@ -0,0 +1,395 @@
+/**
+ * @file happy_eyeballs.c
+ * @brief Happy Eyeballs 實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE  // getaddrinfo, strtok_r
+
+#include "happy_eyeballs.h"
+#include "socket_helper.h"
+#include "logger.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+
+// ========================================
+// 私有變數
+// ========================================
+
+typedef struct {
+    uint64_t key;                   // 位址組的雜湊, 0 表示空項目
+    int family;                     // 勝出的協定
+    long long expires_ms;
+} cache_entry_t;
+
+static struct {
+    cache_entry_t entries[HAPPY_EYEBALLS_CACHE_SIZE];
+    pthread_mutex_t lock;
+} cache = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+static uint64_t fnv1a(uint64_t hash, const void *data, size_t len) {
+    const uint8_t *p = data;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief 以位址組識別對端 (只取協定、位址與埠號,不含填充欄位)
+ */
+static uint64_t peer_key(const happy_eyeballs_addr_t *addrs, int count) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (int i = 0; i < count; i++) {
+        const struct sockaddr *sa = (const struct sockaddr *)&addrs[i].addr;
+        hash = fnv1a(hash, &sa->sa_family, sizeof(sa->sa_family));
+        if (sa->sa_family == AF_INET6) {
+            const struct sockaddr_in6 *in6 = (const struct sockaddr_in6 *)sa;
+            hash = fnv1a(hash, &in6->sin6_addr, sizeof(in6->sin6_addr));
+            hash = fnv1a(hash, &in6->sin6_port, sizeof(in6->sin6_port));
+            hash = fnv1a(hash, &in6->sin6_scope_id, sizeof(in6->sin6_scope_id));
+        } else if (sa->sa_family == AF_INET) {
+            const struct sockaddr_in *in = (const struct sockaddr_in *)sa;
+            hash = fnv1a(hash, &in->sin_addr, sizeof(in->sin_addr));
+            hash = fnv1a(hash, &in->sin_port, sizeof(in->sin_port));
+        }
+    }
+    return hash ? hash : 1;
+}
+
+static int cache_get(uint64_t key) {
+    int family = AF_UNSPEC;
+    long long now = socket_helper_monotonic_ms();
+
+    pthread_mutex_lock(&cache.lock);
+    for (int i = 0; i < HAPPY_EYEBALLS_CACHE_SIZE; i++) {
+        if (cache.entries[i].key == key && cache.entries[i].expires_ms > now) {
+            family = cache.entries[i].family;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&cache.lock);
+    return family;
+}
+
+/**
+ * @brief 記錄勝出的協定,沒有空位時取代最早到期的項目
+ */
+static void cache_put(uint64_t key, int family) {
+    long long now = socket_helper_monotonic_ms();
+
+    pthread_mutex_lock(&cache.lock);
+    cache_entry_t *slot = &cache.entries[0];
+    for (int i = 0; i < HAPPY_EYEBALLS_CACHE_SIZE; i++) {
+        cache_entry_t *e = &cache.entries[i];
+        if (e->key == key) {
+            slot = e;
+            break;
+        }
+        if (e->expires_ms < slot->expires_ms) {
+            slot = e;
+        }
+    }
+    slot->key = key;
+    slot->family = family;
+    slot->expires_ms = now + HAPPY_EYEBALLS_CACHE_TTL_MS;
+    pthread_mutex_unlock(&cache.lock);
+}
+
+/**
+ * @brief 交錯排列: 偏好協定的第一個位址、另一協定的第一個位址、...
+ */
+static void order_by_family(happy_eyeballs_addr_t *addrs, int count, int preferred) {
+    happy_eyeballs_addr_t first[HAPPY_EYEBALLS_MAX_ADDRS];
+    happy_eyeballs_addr_t second[HAPPY_EYEBALLS_MAX_ADDRS];
+    int nfirst = 0;
+    int nsecond = 0;
+
+    for (int i = 0; i < count && i < HAPPY_EYEBALLS_MAX_ADDRS; i++) {
+        if (addrs[i].addr.ss_family == preferred) {
+            first[nfirst++] = addrs[i];
+        } else {
+            second[nsecond++] = addrs[i];
+        }
+    }
+
+    int n = 0;
+    for (int i = 0; i < nfirst || i < nsecond; i++) {
+        if (i < nfirst) {
+            addrs[n++] = first[i];
+        }
+        if (i < nsecond) {
+            addrs[n++] = second[i];
+        }
+    }
+}
+
+/**
+ * @brief 發起一個非阻塞連線
+ * @return >= 0 socket (*connected 表示已立即完成), -1 失敗 (errno 為錯誤)
+ */
+static int start_attempt(const happy_eyeballs_addr_t *target, bool *connected) {
+    int fd = socket(target->addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    *connected = false;
+    if (connect(fd, (const struct sockaddr *)&target->addr, target->len) == 0) {
+        *connected = true;
+        return fd;
+    }
+    if (errno == EINPROGRESS || errno == EINTR) {
+        return fd;
+    }
+
+    int err = errno;
+    close(fd);
+    errno = err;
+    return -1;
+}
+
+/**
+ * @brief 勝出的連線恢復為阻塞模式並記錄協定
+ */
+static int finish_winner(int fd, const happy_eyeballs_addr_t *target, uint64_t key, int attempts) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags >= 0) {
+        fcntl(fd, F_SETFL, flags & ~O_NONBLOCK);
+    }
+
+    cache_put(key, target->addr.ss_family);
+    logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_DEBUG,
+               "Happy eyeballs: connected via %s (%d attempts)",
+               target->addr.ss_family == AF_INET6 ? "IPv6" : "IPv4", attempts);
+    return fd;
+}
+
+// ========================================
+// Happy Eyeballs 公開函數
+// ========================================
+
+int happy_eyeballs_parse(const char *hosts, int port, happy_eyeballs_addr_t *addrs, int max) {
+    if (hosts == NULL || addrs == NULL || max <= 0 || port <= 0 || port > 65535) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    char *list = strdup(hosts);
+    if (list == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    char service[8];
+    snprintf(service, sizeof(service), "%d", port);
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_NUMERICHOST | AI_NUMERICSERV;
+
+    int count = 0;
+    char *save = NULL;
+    for (char *token = strtok_r(list, ", \t", &save); token != NULL;
+         token = strtok_r(NULL, ", \t", &save)) {
+        // IPv6 可寫成 [addr]
+        size_t len = strlen(token);
+        if (token[0] == '[' && len > 2 && token[len - 1] == ']') {
+            token[len - 1] = '\0';
+            token++;
+        }
+
+        struct addrinfo *result = NULL;
+        if (count >= max || getaddrinfo(token, service, &hints, &result) != 0) {
+            count = GAMING_ERROR_INVALID_PARAM;
+            break;
+        }
+        memset(&addrs[count], 0, sizeof(addrs[count]));
+        memcpy(&addrs[count].addr, result->ai_addr, result->ai_addrlen);
+        addrs[count].len = result->ai_addrlen;
+        count++;
+        freeaddrinfo(result);
+    }
+
+    free(list);
+    return (count == 0) ? GAMING_ERROR_INVALID_PARAM : count;
+}
+
+void happy_eyeballs_order(happy_eyeballs_addr_t *addrs, int count) {
+    if (addrs == NULL || count <= 1 || count > HAPPY_EYEBALLS_MAX_ADDRS) {
+        return;
+    }
+
+    int preferred = cache_get(peer_key(addrs, count));
+    order_by_family(addrs, count, preferred == AF_INET ? AF_INET : AF_INET6);
+}
+
+int happy_eyeballs_connect_addrs(const happy_eyeballs_addr_t *addrs, int count,
+                                 const happy_eyeballs_config_t *config) {
+    if (addrs == NULL || count <= 0 || count > HAPPY_EYEBALLS_MAX_ADDRS) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    happy_eyeballs_config_t defaults = HAPPY_EYEBALLS_CONFIG_INIT;
+    const happy_eyeballs_config_t *cfg = config ? config : &defaults;
+    int delay = (cfg->attempt_delay_ms > 0) ? cfg->attempt_delay_ms : 0;
+
+    // 快取以呼叫端給的順序識別對端,排序在副本上進行
+    uint64_t key = peer_key(addrs, count);
+    happy_eyeballs_addr_t targets[HAPPY_EYEBALLS_MAX_ADDRS];
+    memcpy(targets, addrs, sizeof(targets[0]) * (size_t)count);
+    int preferred = cache_get(key);
+    order_by_family(targets, count, preferred == AF_INET ? AF_INET : AF_INET6);
+
+    struct pollfd pfds[HAPPY_EYEBALLS_MAX_ADDRS];
+    int owner[HAPPY_EYEBALLS_MAX_ADDRS];       // pfds[i] 對應的 targets 索引
+    int nfds = 0;
+    int next = 0;
+    int last_err = ETIMEDOUT;
+    long long deadline = socket_helper_deadline_after(cfg->timeout_ms);
+    long long next_start = 0;
+
+    for (;;) {
+        long long now = socket_helper_monotonic_ms();
+        if (deadline >= 0 && now >= deadline) {
+            last_err = ETIMEDOUT;
+            break;
+        }
+
+        // 沒有進行中的嘗試或間隔已到時發起下一個
+        if (next < count && (nfds == 0 || now >= next_start)) {
+            bool connected;
+            int fd = start_attempt(&targets[next], &connected);
+            next++;
+            if (fd < 0) {
+                last_err = errno;
+                next_start = 0;
+                continue;
+            }
+            if (connected) {
+                for (int i = 0; i < nfds; i++) {
+                    close(pfds[i].fd);
+                }
+                return finish_winner(fd, &targets[next - 1], key, next);
+            }
+            pfds[nfds].fd = fd;
+            pfds[nfds].events = POLLOUT;
+            owner[nfds] = next - 1;
+            nfds++;
+            next_start = now + delay;
+            continue;
+        }
+
+        if (nfds == 0) {
+            break;
+        }
+
+        // 等到有嘗試完成、該發起下一個嘗試或到期
+        long long timeout = -1;
+        if (next < count) {
+            timeout = next_start - now;
+        }
+        if (deadline >= 0 && (timeout < 0 || deadline - now < timeout)) {
+            timeout = deadline - now;
+        }
+        int ret = poll(pfds, (nfds_t)nfds, (int)timeout);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            int err = errno;
+            logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "Happy eyeballs: poll: %s",
+                       strerror(err));
+            for (int i = 0; i < nfds; i++) {
+                close(pfds[i].fd);
+            }
+            errno = err;
+            return GAMING_ERROR_IO;
+        }
+        if (ret == 0) {
+            continue;
+        }
+
+        for (int i = 0; i < nfds; i++) {
+            if (pfds[i].revents == 0) {
+                continue;
+            }
+
+            int err = 0;
+            socklen_t len = sizeof(err);
+            if (getsockopt(pfds[i].fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0) {
+                err = errno;
+            }
+            if (err == 0 && (pfds[i].revents & POLLOUT)) {
+                int fd = pfds[i].fd;
+                int winner = owner[i];
+                for (int j = 0; j < nfds; j++) {
+                    if (j != i) {
+                        close(pfds[j].fd);
+                    }
+                }
+                return finish_winner(fd, &targets[winner], key, next);
+            }
+
+            // 失敗時立即發起下一個嘗試
+            last_err = err ? err : ECONNREFUSED;
+            close(pfds[i].fd);
+            nfds--;
+            pfds[i] = pfds[nfds];
+            owner[i] = owner[nfds];
+            i--;
+            next_start = 0;
+        }
+    }
+
+    for (int i = 0; i < nfds; i++) {
+        close(pfds[i].fd);
+    }
+    logger_mod_ratelimited(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR,
+                           "Happy eyeballs: %d addresses failed: %s", count, strerror(last_err));
+    errno = last_err;
+    return -1;
+}
+
+int happy_eyeballs_connect(const char *hosts, int port, const happy_eyeballs_config_t *config) {
+    happy_eyeballs_addr_t addrs[HAPPY_EYEBALLS_MAX_ADDRS];
+
+    int count = happy_eyeballs_parse(hosts, port, addrs, HAPPY_EYEBALLS_MAX_ADDRS);
+    if (count < 0) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "Invalid address list: %s",
+                   hosts ? hosts : "(null)");
+        errno = EINVAL;
+        return -1;
+    }
+
+    return happy_eyeballs_connect_addrs(addrs, count, config);
+}
+
+int happy_eyeballs_cache_lookup(const happy_eyeballs_addr_t *addrs, int count) {
+    if (addrs == NULL || count <= 0 || count > HAPPY_EYEBALLS_MAX_ADDRS) {
+        return AF_UNSPEC;
+    }
+
+    return cache_get(peer_key(addrs, count));
+}
+
+void happy_eyeballs_cache_clear(void) {
+    pthread_mutex_lock(&cache.lock);
+    memset(cache.entries, 0, sizeof(cache.entries));
+    pthread_mutex_unlock(&cache.lock);
+}
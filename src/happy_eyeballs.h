@@ -0,0 +1,121 @@
+/**
+ * @file happy_eyeballs.h
+ * @brief Happy Eyeballs - 雙協定 (IPv4 / IPv6) 並行 TCP 連線
+ * @version 1.0.0
+ *
+ * 依 RFC 8305 的方式連線到一組位址,連線時間取決於最快的路徑:
+ *
+ * - 位址依協定交錯排列 (IPv6, IPv4, IPv6, ...),先從偏好的協定開始
+ * - 每隔 attempt_delay_ms 以非阻塞 socket 發起下一個嘗試,
+ *   前一個嘗試失敗 (例如 RST) 時立即發起下一個,不等待間隔
+ * - 第一個完成的連線勝出,其他嘗試立即關閉
+ * - 每個對端 (同一組位址) 勝出的協定會被記住一段時間,
+ *   下次先嘗試該協定,避免每次都等待壞掉的 IPv6 或 IPv4 路徑
+ *
+ * 只接受數字位址 (不做 DNS 查詢),位址清單以逗號或空白分隔,
+ * IPv6 位址可加方括號,連結區域位址可帶介面 (fe80::1%br-lan)
+ *
+ * 用法:
+ *   int fd = happy_eyeballs_connect("192.168.8.1, fd00::1", 8080, NULL);
+ */
+
+#ifndef HAPPY_EYEBALLS_H
+#define HAPPY_EYEBALLS_H
+
+#include "gaming_common.h"
+#include <sys/socket.h>
+
+// ========================================
+// Happy Eyeballs 配置
+// ========================================
+
+// 發起下一個嘗試前的等待 (RFC 8305 建議 250 毫秒)
+#define HAPPY_EYEBALLS_DEFAULT_DELAY_MS     250
+
+// 預設整體期限 (毫秒)
+#define HAPPY_EYEBALLS_DEFAULT_TIMEOUT_MS   5000
+
+// 位址清單上限
+#define HAPPY_EYEBALLS_MAX_ADDRS            16
+
+// 勝出協定快取的項目數與有效期 (毫秒)
+#define HAPPY_EYEBALLS_CACHE_SIZE           32
+#define HAPPY_EYEBALLS_CACHE_TTL_MS         (10 * 60 * 1000)
+
+/**
+ * @brief 一個連線目標 (位址與埠號)
+ */
+typedef struct {
+    struct sockaddr_storage addr;
+    socklen_t len;
+} happy_eyeballs_addr_t;
+
+typedef struct {
+    int timeout_ms;             ///< 整體期限,-1 表示不限
+    int attempt_delay_ms;       ///< 發起下一個嘗試前的等待
+} happy_eyeballs_config_t;
+
+#define HAPPY_EYEBALLS_CONFIG_INIT {                    \
+    .timeout_ms = HAPPY_EYEBALLS_DEFAULT_TIMEOUT_MS,    \
+    .attempt_delay_ms = HAPPY_EYEBALLS_DEFAULT_DELAY_MS,\
+}
+
+// ========================================
+// Happy Eyeballs 公開函數
+// ========================================
+
+/**
+ * @brief 解析位址清單
+ *
+ * @param hosts 以逗號或空白分隔的 IPv4 / IPv6 位址
+ * @param port 埠號
+ * @param addrs 輸出的位址
+ * @param max addrs 的容量
+ * @return > 0 位址數量
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤、位址無效或超過 max
+ */
+int happy_eyeballs_parse(const char *hosts, int port, happy_eyeballs_addr_t *addrs, int max);
+
+/**
+ * @brief 依快取的偏好協定與協定交錯排列位址 (就地排序)
+ *
+ * 沒有快取時以 IPv6 優先;同一協定內維持原本的順序
+ */
+void happy_eyeballs_order(happy_eyeballs_addr_t *addrs, int count);
+
+/**
+ * @brief 並行連線到一組位址
+ *
+ * @param addrs 位址 (依原本順序作為同協定內的優先順序)
+ * @param count 位址數量 (1 - HAPPY_EYEBALLS_MAX_ADDRS)
+ * @param config 配置, NULL 使用預設值
+ * @return >= 0 已連線的 socket (阻塞模式)
+ * @return GAMING_ERROR_IO poll() 失敗 (errno 為 poll 的錯誤,進行中的嘗試已關閉)
+ * @return < 0 全部失敗或逾時 (errno 為最後的連線錯誤或 ETIMEDOUT)
+ */
+int happy_eyeballs_connect_addrs(const happy_eyeballs_addr_t *addrs, int count,
+                                 const happy_eyeballs_config_t *config);
+
+/**
+ * @brief 解析位址清單後並行連線
+ *
+ * @param hosts 以逗號或空白分隔的 IPv4 / IPv6 位址
+ * @param port 埠號
+ * @param config 配置, NULL 使用預設值
+ * @return 同 happy_eyeballs_connect_addrs(),位址無效時回傳 -1 (errno 為 EINVAL)
+ */
+int happy_eyeballs_connect(const char *hosts, int port, const happy_eyeballs_config_t *config);
+
+/**
+ * @brief 查詢一組位址快取的勝出協定
+ *
+ * @return AF_INET / AF_INET6, AF_UNSPEC 表示沒有快取或已過期
+ */
+int happy_eyeballs_cache_lookup(const happy_eyeballs_addr_t *addrs, int count);
+
+/**
+ * @brief 清除快取 (網路介面改變時呼叫)
+ */
+void happy_eyeballs_cache_clear(void);
+
+#endif // HAPPY_EYEBALLS_H
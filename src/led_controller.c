@@ -1,7 +1,12 @@
 
 #include "led_controller.h"
-#include <stdio.h>
+#include "config_parser.h"
+#include "logger.h"
+#include <stdlib.h>
+#include <string.h>
 #include <stdbool.h>
+#include <pthread.h>
+#include <sched.h>
 
 // ========================================
 // 內部狀態
@@ -13,6 +18,64 @@ static bool is_initialized = false;
 // 外部 hal_ops（由 hal_init.c 提供）
 extern hal_ops_t *hal_ops;
 
+// ========================================
+// 顏色表
+// ========================================
+
+// UCI 可設定的顏色（對應 config led 'colors' 的選項）
+typedef enum {
+    LED_SLOT_PS5_ON = 0,
+    LED_SLOT_PS5_STANDBY,
+    LED_SLOT_PS5_OFF,
+    LED_SLOT_SERVER_PS5_ON,
+    LED_SLOT_SERVER_PS5_STANDBY,
+    LED_SLOT_VPN_CONNECTING,
+    LED_SLOT_VPN_CONNECTED,
+    LED_SLOT_VPN_ERROR,
+    LED_SLOT_SYSTEM_ERROR,
+    LED_SLOT_SYSTEM_STARTUP,
+    LED_SLOT_COUNT
+} led_color_slot_t;
+
+// 選項名稱與預設值（UCI 沒設定時沿用原本的固定顏色）
+static const struct {
+    const char *option;
+    led_color_t fallback;
+} color_slots[LED_SLOT_COUNT] = {
+    [LED_SLOT_PS5_ON]             = { "ps5_on",             LED_COLOR_WHITE },
+    [LED_SLOT_PS5_STANDBY]        = { "ps5_standby",        LED_COLOR_ORANGE },
+    [LED_SLOT_PS5_OFF]            = { "ps5_off",            LED_COLOR_BLACK },
+    [LED_SLOT_SERVER_PS5_ON]      = { "server_ps5_on",      LED_COLOR_GREEN },
+    [LED_SLOT_SERVER_PS5_STANDBY] = { "server_ps5_standby", LED_COLOR_BLUE },
+    [LED_SLOT_VPN_CONNECTING]     = { "vpn_connecting",     LED_COLOR_BLUE },
+    [LED_SLOT_VPN_CONNECTED]      = { "vpn_connected",      LED_COLOR_GREEN },
+    [LED_SLOT_VPN_ERROR]          = { "vpn_error",          LED_COLOR_RED },
+    [LED_SLOT_SYSTEM_ERROR]       = { "system_error",       LED_COLOR_RED },
+    [LED_SLOT_SYSTEM_STARTUP]     = { "system_startup",     LED_COLOR_WHITE },
+};
+
+#define LED_TABLE_DEVICES  (DEVICE_TYPE_SERVER + 1)
+#define LED_TABLE_PS5      (PS5_STATE_OFF + 1)
+#define LED_TABLE_VPN      (VPN_STATE_ERROR + 1)
+
+// 展開後的狀態表：(裝置, PS5, VPN) → 顏色，另存系統顏色
+typedef struct {
+    led_color_t status[LED_TABLE_DEVICES][LED_TABLE_PS5][LED_TABLE_VPN];
+    led_color_t system_error;
+    led_color_t system_startup;
+} led_color_table_t;
+
+// 雙緩衝：reload 寫入未使用的那一份，再原子切換指標
+// 每份各有讀取計數，reload 要等舊讀者離開才能覆寫同一份
+static led_color_table_t color_tables[2];
+static led_color_table_t *active_table = NULL;
+static int table_readers[2];
+static pthread_mutex_t reload_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// 尚未載入時使用的編譯期預設顏色（只建立一次，之後唯讀）
+static led_color_table_t default_table;
+static pthread_once_t default_table_once = PTHREAD_ONCE_INIT;
+
 // ========================================
 // 內部輔助函數
 // ========================================
@@ -25,56 +88,171 @@ static hal_gpio_value_t color_to_gpio_value(uint8_t color) {
 // 設定單一 RGB 通道
 static int set_rgb_channel(int pin, uint8_t value) {
     if (!hal_ops) {
-        fprintf(stderr, "LED controller: HAL not initialized\n");
+        logger_mod(LOG_MODULE_LED, LOG_LEVEL_ERROR, "HAL not initialized");
         return GAMING_ERROR_NOT_INITIALIZED;
     }
     
     hal_gpio_value_t gpio_val = color_to_gpio_value(value);
     int ret = hal_ops->gpio_write(pin, gpio_val);
     if (ret < 0) {
-        fprintf(stderr, "LED controller: Failed to write GPIO%d\n", pin);
+        logger_mod(LOG_MODULE_LED, LOG_LEVEL_ERROR, "Failed to write GPIO%d", pin);
         return GAMING_ERROR_HAL_FAILED;
     }
     
     return GAMING_OK;
 }
 
+// UCI 選項回呼：只接受已知選項且格式正確的值
+static void load_color_option(const char *option, const char *value, void *user_data) {
+    led_color_t *palette = user_data;
+    
+    for (int i = 0; i < LED_SLOT_COUNT; i++) {
+        if (strcmp(option, color_slots[i].option) != 0) {
+            continue;
+        }
+        if (led_parse_color(value, &palette[i]) != GAMING_OK) {
+            logger_mod(LOG_MODULE_LED, LOG_LEVEL_WARN, "Invalid color %s='%s', using default",
+                       option, value);
+        }
+        return;
+    }
+}
+
+// 依狀態組合挑選調色盤中的顏色（只在 reload 時執行）
+static led_color_t resolve_status_color(const led_color_t *palette,
+                                        device_type_t device_type,
+                                        ps5_state_t ps5_state,
+                                        vpn_state_t vpn_state) {
+    if (device_type == DEVICE_TYPE_CLIENT) {
+        // Client 模式（原 Travel Router）
+        if (vpn_state == VPN_STATE_CONNECTING) {
+            return palette[LED_SLOT_VPN_CONNECTING];
+        }
+        if (vpn_state == VPN_STATE_ERROR) {
+            return palette[LED_SLOT_VPN_ERROR];
+        }
+        switch (ps5_state) {
+            case PS5_STATE_ON:
+                return palette[LED_SLOT_PS5_ON];
+            case PS5_STATE_STANDBY:
+                return palette[LED_SLOT_PS5_STANDBY];
+            default:
+                return (vpn_state == VPN_STATE_CONNECTED) ?
+                       palette[LED_SLOT_VPN_CONNECTED] : palette[LED_SLOT_PS5_OFF];
+        }
+    }
+    
+    if (device_type == DEVICE_TYPE_SERVER) {
+        // Server 模式（原 Home Router）
+        switch (ps5_state) {
+            case PS5_STATE_ON:
+                return palette[LED_SLOT_SERVER_PS5_ON];
+            case PS5_STATE_STANDBY:
+                return palette[LED_SLOT_SERVER_PS5_STANDBY];
+            default:
+                return palette[LED_SLOT_PS5_OFF];
+        }
+    }
+    
+    // 未知設備類型
+    return palette[LED_SLOT_SYSTEM_ERROR];
+}
+
+// 由調色盤展開整張狀態表
+static void build_table(led_color_table_t *table, const led_color_t *palette) {
+    for (int d = 0; d < LED_TABLE_DEVICES; d++) {
+        for (int p = 0; p < LED_TABLE_PS5; p++) {
+            for (int v = 0; v < LED_TABLE_VPN; v++) {
+                table->status[d][p][v] = resolve_status_color(palette,
+                                                              (device_type_t)d,
+                                                              (ps5_state_t)p,
+                                                              (vpn_state_t)v);
+            }
+        }
+    }
+    table->system_error = palette[LED_SLOT_SYSTEM_ERROR];
+    table->system_startup = palette[LED_SLOT_SYSTEM_STARTUP];
+}
+
+static void build_default_table(void) {
+    led_color_t palette[LED_SLOT_COUNT];
+    
+    for (int i = 0; i < LED_SLOT_COUNT; i++) {
+        palette[i] = color_slots[i].fallback;
+    }
+    build_table(&default_table, palette);
+}
+
+// 取得目前使用中的顏色表，用完以 table_release() 歸還
+// 尚未載入時不在熱路徑讀 UCI，改用編譯期預設顏色（回傳 -1 作為索引）
+static const led_color_table_t *table_acquire(int *index) {
+    for (;;) {
+        led_color_table_t *table = __atomic_load_n(&active_table, __ATOMIC_SEQ_CST);
+        if (table == NULL) {
+            logger_mod_ratelimited(LOG_MODULE_LED, LOG_LEVEL_ERROR,
+                                   "LED color table not loaded, using built-in colors");
+            pthread_once(&default_table_once, build_default_table);
+            *index = -1;
+            return &default_table;
+        }
+        
+        // 登記後再確認指標未被切換，否則 reload 可能已開始覆寫這一份
+        int i = (int)(table - color_tables);
+        __atomic_add_fetch(&table_readers[i], 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&active_table, __ATOMIC_SEQ_CST) == table) {
+            *index = i;
+            return table;
+        }
+        __atomic_sub_fetch(&table_readers[i], 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+static void table_release(int index) {
+    if (index >= 0) {
+        __atomic_sub_fetch(&table_readers[index], 1, __ATOMIC_RELEASE);
+    }
+}
+
 // ========================================
 // LED 控制器初始化
 // ========================================
 
 int led_controller_init(const led_config_t *config) {
     if (config == NULL) {
-        fprintf(stderr, "LED controller init: config is NULL\n");
+        logger_mod(LOG_MODULE_LED, LOG_LEVEL_ERROR, "Init: config is NULL");
         return GAMING_ERROR_INVALID_PARAM;
     }
     
     if (!hal_ops) {
-        fprintf(stderr, "LED controller init: HAL not initialized\n");
+        logger_mod(LOG_MODULE_LED, LOG_LEVEL_ERROR, "Init: HAL not initialized");
         return GAMING_ERROR_NOT_INITIALIZED;
     }
     
     // 保存配置
     current_config = *config;
     
+    // 載入顏色表（之後狀態更新只需查表），UCI 變更時隨 config_parser_reload() 重新載入
+    led_color_table_reload();
+    config_parser_add_reload_hook(led_color_table_reload);
+    
     // 初始化三個 GPIO 為輸出模式
     int ret;
     
     ret = hal_ops->gpio_init(config->pin_r, HAL_GPIO_DIR_OUTPUT);
     if (ret < 0) {
-        fprintf(stderr, "LED controller: Failed to init R pin\n");
+        logger_mod(LOG_MODULE_LED, LOG_LEVEL_ERROR, "Failed to init R pin");
         return GAMING_ERROR_HAL_FAILED;
     }
     
     ret = hal_ops->gpio_init(config->pin_g, HAL_GPIO_DIR_OUTPUT);
     if (ret < 0) {
-        fprintf(stderr, "LED controller: Failed to init G pin\n");
+        logger_mod(LOG_MODULE_LED, LOG_LEVEL_ERROR, "Failed to init G pin");
         return GAMING_ERROR_HAL_FAILED;
     }
     
     ret = hal_ops->gpio_init(config->pin_b, HAL_GPIO_DIR_OUTPUT);
     if (ret < 0) {
-        fprintf(stderr, "LED controller: Failed to init B pin\n");
+        logger_mod(LOG_MODULE_LED, LOG_LEVEL_ERROR, "Failed to init B pin");
         return GAMING_ERROR_HAL_FAILED;
     }
     
@@ -85,10 +263,8 @@ int led_controller_init(const led_config_t *config) {
     
     is_initialized = true;
     
-    #ifdef DEBUG
-    printf("LED controller initialized: R=%d, G=%d, B=%d\n",
-           config->pin_r, config->pin_g, config->pin_b);
-    #endif
+    logger_mod(LOG_MODULE_LED, LOG_LEVEL_DEBUG, "LED controller initialized: R=%d, G=%d, B=%d",
+               config->pin_r, config->pin_g, config->pin_b);
     
     return GAMING_OK;
 }
@@ -102,6 +278,8 @@ int led_controller_deinit(void) {
         return GAMING_ERROR_NOT_INITIALIZED;
     }
     
+    config_parser_remove_reload_hook(led_color_table_reload);
+    
     // 關閉所有 LED
     led_off();
     
@@ -123,7 +301,7 @@ int led_controller_deinit(void) {
 
 int led_set_color(uint8_t r, uint8_t g, uint8_t b) {
     if (!is_initialized) {
-        fprintf(stderr, "LED controller: Not initialized\n");
+        logger_mod(LOG_MODULE_LED, LOG_LEVEL_ERROR, "Not initialized");
         return GAMING_ERROR_NOT_INITIALIZED;
     }
     
@@ -147,9 +325,7 @@ int led_set_color(uint8_t r, uint8_t g, uint8_t b) {
         return ret;
     }
     
-    #ifdef DEBUG
-    printf("LED color set: R=%d, G=%d, B=%d\n", r, g, b);
-    #endif
+    logger_mod(LOG_MODULE_LED, LOG_LEVEL_DEBUG, "LED color set: R=%d, G=%d, B=%d", r, g, b);
     
     return GAMING_OK;
 }
@@ -167,61 +343,138 @@ int led_off(void) {
 // ========================================
 
 int led_set_status(device_type_t device_type, ps5_state_t ps5_state) {
+    return led_set_status_ex(device_type, ps5_state, VPN_STATE_UNKNOWN);
+}
+
+int led_set_status_ex(device_type_t device_type, ps5_state_t ps5_state,
+                      vpn_state_t vpn_state) {
     if (!is_initialized) {
         return GAMING_ERROR_NOT_INITIALIZED;
     }
     
-    led_color_t color;
+    return led_set_color_preset(led_get_status_color(device_type, ps5_state, vpn_state));
+}
+
+int led_show_error(void) {
+    // 簡單實作：顯示 system_error 顏色（預設紅色）
+    // TODO: 實作閃爍效果（需要定時器或狀態機）
+    int index;
+    led_color_t color = table_acquire(&index)->system_error;
+    table_release(index);
+    return led_set_color_preset(color);
+}
+
+int led_show_booting(void) {
+    // 簡單實作：顯示 system_startup 顏色（預設白色）
+    // TODO: 實作呼吸燈效果（需要 PWM 或狀態機）
+    int index;
+    led_color_t color = table_acquire(&index)->system_startup;
+    table_release(index);
+    return led_set_color_preset(color);
+}
+
+// ========================================
+// LED 顏色表
+// ========================================
+
+int led_parse_color(const char *str, led_color_t *color) {
+    if (str == NULL || color == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    
+    long rgb[3];
+    const char *p = str;
     
-    // 根據設備類型和 PS5 狀態決定 LED 顏色
-    if (device_type == DEVICE_TYPE_CLIENT) {
-        // Client 模式（原 Travel Router）
-        switch (ps5_state) {
-            case PS5_STATE_ON:
-                color = LED_COLOR_WHITE;    // PS5 開機：白色
-                break;
-            case PS5_STATE_STANDBY:
-                color = LED_COLOR_ORANGE;   // PS5 待機：橙色
-                break;
-            case PS5_STATE_OFF:
-            case PS5_STATE_UNKNOWN:
-            default:
-                color = LED_COLOR_BLACK;    // PS5 關機或未知：關閉
-                break;
+    for (int i = 0; i < 3; i++) {
+        char *end;
+        
+        while (*p == ' ' || *p == '\t') {
+            p++;
         }
-    } else if (device_type == DEVICE_TYPE_SERVER) {
-        // Server 模式（原 Home Router）
-        switch (ps5_state) {
-            case PS5_STATE_ON:
-                color = LED_COLOR_GREEN;    // PS5 開機：綠色
-                break;
-            case PS5_STATE_STANDBY:
-                color = LED_COLOR_BLUE;     // PS5 待機：藍色
-                break;
-            case PS5_STATE_OFF:
-            case PS5_STATE_UNKNOWN:
-            default:
-                color = LED_COLOR_BLACK;    // PS5 關機或未知：關閉
-                break;
+        if (*p < '0' || *p > '9') {
+            return GAMING_ERROR_INVALID_PARAM;
+        }
+        rgb[i] = strtol(p, &end, 10);
+        if (rgb[i] > 255) {
+            return GAMING_ERROR_INVALID_PARAM;
+        }
+        p = end;
+        while (*p == ' ' || *p == '\t') {
+            p++;
+        }
+        
+        // 前兩個值後面必須是逗號，最後一個值後面必須結束
+        if (i < 2) {
+            if (*p != ',') {
+                return GAMING_ERROR_INVALID_PARAM;
+            }
+            p++;
+        } else if (*p != '\0') {
+            return GAMING_ERROR_INVALID_PARAM;
         }
-    } else {
-        // 未知設備類型
-        color = LED_COLOR_RED;  // 紅色表示錯誤
     }
     
-    return led_set_color_preset(color);
+    color->r = (uint8_t)rgb[0];
+    color->g = (uint8_t)rgb[1];
+    color->b = (uint8_t)rgb[2];
+    
+    return GAMING_OK;
 }
 
-int led_show_error(void) {
-    // 簡單實作：顯示紅色
-    // TODO: 實作閃爍效果（需要定時器或狀態機）
-    return led_set_color_preset(LED_COLOR_RED);
+int led_color_table_reload(void) {
+    led_color_t palette[LED_SLOT_COUNT];
+    
+    for (int i = 0; i < LED_SLOT_COUNT; i++) {
+        palette[i] = color_slots[i].fallback;
+    }
+    
+    // 一次讀完整個區段；UCI 不可用時保留預設顏色
+    int ret = config_parser_init();
+    if (ret == GAMING_OK) {
+        ret = config_parser_foreach_option(UCI_CONFIG_GAMING, UCI_SECTION_LED_COLORS,
+                                           load_color_option, palette);
+    }
+    
+    // 寫入目前未使用的那一份，完成後再切換
+    // 連續 reload 時，上一次切換前取得這一份的讀者可能還在查表，先等它們離開
+    pthread_mutex_lock(&reload_lock);
+    led_color_table_t *current = __atomic_load_n(&active_table, __ATOMIC_SEQ_CST);
+    int next_index = (current == &color_tables[0]) ? 1 : 0;
+    led_color_table_t *next = &color_tables[next_index];
+    
+    while (__atomic_load_n(&table_readers[next_index], __ATOMIC_SEQ_CST) > 0) {
+        sched_yield();
+    }
+    
+    build_table(next, palette);
+    __atomic_store_n(&active_table, next, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&reload_lock);
+    
+    logger_mod(LOG_MODULE_LED, LOG_LEVEL_DEBUG,
+               "LED color table loaded (%s)", (ret > 0) ? "UCI" : "defaults");
+    
+    return GAMING_OK;
 }
 
-int led_show_booting(void) {
-    // 簡單實作：顯示白色
-    // TODO: 實作呼吸燈效果（需要 PWM 或狀態機）
-    return led_set_color_preset(LED_COLOR_WHITE);
+led_color_t led_get_status_color(device_type_t device_type,
+                                 ps5_state_t ps5_state,
+                                 vpn_state_t vpn_state) {
+    // 超出範圍的狀態視為未知
+    if ((unsigned)device_type >= LED_TABLE_DEVICES) {
+        device_type = DEVICE_TYPE_UNKNOWN;
+    }
+    if ((unsigned)ps5_state >= LED_TABLE_PS5) {
+        ps5_state = PS5_STATE_UNKNOWN;
+    }
+    if ((unsigned)vpn_state >= LED_TABLE_VPN) {
+        vpn_state = VPN_STATE_UNKNOWN;
+    }
+    
+    int index;
+    const led_color_table_t *table = table_acquire(&index);
+    led_color_t color = table->status[device_type][ps5_state][vpn_state];
+    table_release(index);
+    return color;
 }
 
 // ========================================
@@ -265,7 +518,7 @@ int led_rainbow(int duration_ms) {
     // 暫時未實作
     (void)duration_ms;
     
-    fprintf(stderr, "LED rainbow effect not yet implemented\n");
+    logger_mod(LOG_MODULE_LED, LOG_LEVEL_WARN, "Rainbow effect not yet implemented");
     return GAMING_ERROR;
 }
 
@@ -43,15 +43,44 @@ int led_off(void);
 // LED 狀態指示
 // ========================================
 
-// 根據系統狀態設定 LED
+// 根據系統狀態設定 LED（VPN 狀態視為未知）
 int led_set_status(device_type_t device_type, ps5_state_t ps5_state);
 
+// 根據系統狀態（含 VPN）設定 LED，只做一次顏色表查表
+int led_set_status_ex(device_type_t device_type, ps5_state_t ps5_state,
+                      vpn_state_t vpn_state);
+
 // 顯示錯誤狀態（紅色閃爍）
 int led_show_error(void);
 
 // 顯示啟動中（白色呼吸燈）
 int led_show_booting(void);
 
+// ========================================
+// LED 顏色表（UCI: config led 'colors'）
+// ========================================
+
+// 解析 "R,G,B" 字串（各 0-255）
+int led_parse_color(const char *str, led_color_t *color);
+
+// 從 UCI 重新載入顏色表
+// 新表建好後才原子切換，讀取端不會看到一半的表；可與查表及其他 reload 並行呼叫。
+// led_controller_init() 會註冊到 config_parser_reload()，設定變更時
+// (例如 SIGHUP / reload_service) 呼叫 config_parser_reload() 即可
+// 尚未載入就查表時使用編譯期預設顏色並記錄錯誤，不會在查表時讀取 UCI
+int led_color_table_reload(void);
+
+// 查詢狀態對應的顏色
+// 規則:
+//   - 未知裝置: system_error
+//   - Client: VPN 連線中/錯誤優先 (vpn_connecting / vpn_error)，
+//     其次 PS5 開機/待機 (ps5_on / ps5_standby)，
+//     PS5 關機時若 VPN 已連線顯示 vpn_connected，否則 ps5_off
+//   - Server: server_ps5_on / server_ps5_standby / ps5_off，不看 VPN
+led_color_t led_get_status_color(device_type_t device_type,
+                                 ps5_state_t ps5_state,
+                                 vpn_state_t vpn_state);
+
 // ========================================
 // LED 特效（可選）
 // ========================================
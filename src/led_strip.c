@@ -0,0 +1,246 @@
+/**
+ * @file led_strip.c
+ * @brief 可定址 LED 燈條驅動實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE  // O_CLOEXEC
+
+#include "led_strip.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+
+// ========================================
+// 內部狀態
+// ========================================
+
+struct led_strip {
+    int fd;
+    int num_leds;
+    bool dirty;
+    led_color_t *pixels;  // 幀緩衝
+    uint8_t *tx;          // 已編碼的 SPI 資料 (含幀尾 reset)
+    size_t tx_len;
+};
+
+// 位元組 → 3 個 SPI 位元組的查表 (每個位元 0 → 100, 1 → 110)
+static uint8_t encode_lut[256][3];
+static pthread_once_t encode_lut_once = PTHREAD_ONCE_INIT;
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+static void build_encode_lut(void) {
+    for (int value = 0; value < 256; value++) {
+        uint32_t bits = 0;
+
+        // 由最高位元開始,每個位元展開為 3 個 SPI 位元
+        for (int bit = 7; bit >= 0; bit--) {
+            bits = (bits << 3) | (((value >> bit) & 1) ? 0x6 : 0x4);
+        }
+
+        encode_lut[value][0] = (uint8_t)(bits >> 16);
+        encode_lut[value][1] = (uint8_t)(bits >> 8);
+        encode_lut[value][2] = (uint8_t)bits;
+    }
+}
+
+static inline void encode_pixel(led_color_t color, uint8_t *out) {
+    // WS2812 的傳送順序為 G, R, B
+    memcpy(out, encode_lut[color.g], 3);
+    memcpy(out + 3, encode_lut[color.r], 3);
+    memcpy(out + 6, encode_lut[color.b], 3);
+}
+
+static bool color_equal(led_color_t a, led_color_t b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+static int configure_spi(int fd, uint32_t speed_hz) {
+    uint8_t mode = SPI_MODE_0;
+    uint8_t bits = 8;
+
+    if (ioctl(fd, SPI_IOC_WR_MODE, &mode) < 0 ||
+        ioctl(fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 ||
+        ioctl(fd, SPI_IOC_WR_MAX_SPEED_HZ, &speed_hz) < 0) {
+        // 一般檔案 (測試替身) 不支援 SPI ioctl
+        if (errno == ENOTTY) {
+            return 0;
+        }
+        return -1;
+    }
+
+    return 0;
+}
+
+// ========================================
+// 公開函數實作
+// ========================================
+
+size_t led_strip_frame_size(int num_leds) {
+    if (num_leds <= 0) {
+        return 0;
+    }
+    return (size_t)num_leds * LED_STRIP_BYTES_PER_LED + LED_STRIP_RESET_BYTES;
+}
+
+void led_strip_encode(const led_color_t *pixels, int count, uint8_t *out) {
+    pthread_once(&encode_lut_once, build_encode_lut);
+
+    for (int i = 0; i < count; i++) {
+        encode_pixel(pixels[i], out + (size_t)i * LED_STRIP_BYTES_PER_LED);
+    }
+}
+
+led_strip_t* led_strip_open(const led_strip_config_t *config) {
+    if (config == NULL || config->num_leds <= 0 ||
+        config->num_leds > LED_STRIP_MAX_LEDS) {
+        fprintf(stderr, "LED strip: Invalid config\n");
+        return NULL;
+    }
+
+    pthread_once(&encode_lut_once, build_encode_lut);
+
+    const char *device = config->spi_device ? config->spi_device : LED_STRIP_DEFAULT_DEVICE;
+    uint32_t speed_hz = config->speed_hz ? config->speed_hz : LED_STRIP_DEFAULT_SPEED_HZ;
+
+    led_strip_t *strip = calloc(1, sizeof(*strip));
+    if (strip == NULL) {
+        return NULL;
+    }
+
+    strip->num_leds = config->num_leds;
+    strip->tx_len = led_strip_frame_size(config->num_leds);
+    strip->pixels = calloc((size_t)config->num_leds, sizeof(led_color_t));
+    strip->tx = calloc(1, strip->tx_len);  // reset 區段保持為 0
+    if (strip->pixels == NULL || strip->tx == NULL) {
+        free(strip->pixels);
+        free(strip->tx);
+        free(strip);
+        return NULL;
+    }
+
+    strip->fd = open(device, O_WRONLY | O_CLOEXEC);
+    if (strip->fd < 0) {
+        fprintf(stderr, "LED strip: Failed to open %s: %s\n", device, strerror(errno));
+        free(strip->pixels);
+        free(strip->tx);
+        free(strip);
+        return NULL;
+    }
+
+    if (configure_spi(strip->fd, speed_hz) < 0) {
+        fprintf(stderr, "LED strip: Failed to configure %s: %s\n", device, strerror(errno));
+        led_strip_close(strip);
+        return NULL;
+    }
+
+    // 初始幀為全黑,第一次 show 時送出
+    led_strip_encode(strip->pixels, strip->num_leds, strip->tx);
+    strip->dirty = true;
+
+    #ifdef DEBUG
+    printf("LED strip opened: %s, %d LEDs, %u Hz\n", device, strip->num_leds, speed_hz);
+    #endif
+
+    return strip;
+}
+
+void led_strip_close(led_strip_t *strip) {
+    if (strip == NULL) {
+        return;
+    }
+
+    if (strip->fd >= 0) {
+        close(strip->fd);
+    }
+    free(strip->pixels);
+    free(strip->tx);
+    free(strip);
+}
+
+int led_strip_get_count(const led_strip_t *strip) {
+    return strip ? strip->num_leds : 0;
+}
+
+int led_strip_set_pixel(led_strip_t *strip, int index, led_color_t color) {
+    if (strip == NULL || index < 0 || index >= strip->num_leds) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    if (color_equal(strip->pixels[index], color)) {
+        return GAMING_OK;
+    }
+
+    // 設定時即編碼,show 只需要一次 write
+    strip->pixels[index] = color;
+    encode_pixel(color, strip->tx + (size_t)index * LED_STRIP_BYTES_PER_LED);
+    strip->dirty = true;
+
+    return GAMING_OK;
+}
+
+int led_strip_get_pixel(const led_strip_t *strip, int index, led_color_t *color) {
+    if (strip == NULL || color == NULL || index < 0 || index >= strip->num_leds) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    *color = strip->pixels[index];
+    return GAMING_OK;
+}
+
+int led_strip_fill(led_strip_t *strip, led_color_t color) {
+    if (strip == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    for (int i = 0; i < strip->num_leds; i++) {
+        led_strip_set_pixel(strip, i, color);
+    }
+
+    return GAMING_OK;
+}
+
+int led_strip_set_pixels(led_strip_t *strip, const led_color_t *pixels, int count) {
+    if (strip == NULL || pixels == NULL || count < 0 || count > strip->num_leds) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    for (int i = 0; i < count; i++) {
+        led_strip_set_pixel(strip, i, pixels[i]);
+    }
+
+    return GAMING_OK;
+}
+
+int led_strip_show(led_strip_t *strip) {
+    if (strip == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    if (!strip->dirty) {
+        return 0;
+    }
+
+    ssize_t written;
+    do {
+        written = write(strip->fd, strip->tx, strip->tx_len);
+    } while (written < 0 && errno == EINTR);
+
+    if (written != (ssize_t)strip->tx_len) {
+        fprintf(stderr, "LED strip: Failed to write frame (%zd/%zu): %s\n",
+                written, strip->tx_len, strerror(errno));
+        return GAMING_ERROR_IO;
+    }
+
+    strip->dirty = false;
+    return 1;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file led_strip.h
+ * @brief 可定址 LED 燈條驅動 (WS2812 系列, 透過 spidev)
+ * @version 1.0.0
+ *
+ * 部分機種使用 WS2812 類型的 LED 燈條取代單顆 RGB LED。
+ * 以 SPI MOSI 產生 WS2812 波形: SPI 時脈 2.4 MHz 時,
+ * 每個 WS2812 位元展開為 3 個 SPI 位元 (0 → 100, 1 → 110),
+ * 每個顏色位元組對應 3 個 SPI 位元組,由查表完成展開。
+ *
+ * 每一幀只呼叫一次 write();沒有變更的幀不會送出。
+ */
+
+#ifndef LED_STRIP_H
+#define LED_STRIP_H
+
+#include "gaming_common.h"
+#include <stddef.h>
+
+// ========================================
+// LED Strip 配置
+// ========================================
+
+// 預設 SPI 裝置
+#define LED_STRIP_DEFAULT_DEVICE   "/dev/spidev0.0"
+
+// 預設 SPI 時脈 (每個 WS2812 位元 = 3 個 SPI 位元 ≈ 1.25 us)
+#define LED_STRIP_DEFAULT_SPEED_HZ 2400000
+
+// 燈珠數量上限
+#define LED_STRIP_MAX_LEDS         1024
+
+// 每顆燈珠的 SPI 位元組數 (G, R, B 各 3 bytes)
+#define LED_STRIP_BYTES_PER_LED    9
+
+// 幀尾的低電位 reset 位元組數 (2.4 MHz 下約 300 us, 滿足 WS2812B >= 280 us)
+#define LED_STRIP_RESET_BYTES      90
+
+typedef struct {
+    const char *spi_device;  ///< spidev 路徑,NULL 則使用 LED_STRIP_DEFAULT_DEVICE
+    int num_leds;            ///< 燈珠數量 (1 - LED_STRIP_MAX_LEDS)
+    uint32_t speed_hz;       ///< SPI 時脈,0 則使用 LED_STRIP_DEFAULT_SPEED_HZ
+} led_strip_config_t;
+
+typedef struct led_strip led_strip_t;
+
+// ========================================
+// LED Strip 公開函數
+// ========================================
+
+/**
+ * @brief 開啟燈條
+ *
+ * 開啟 spidev 並設定 SPI 模式與時脈。若路徑是一般檔案
+ * (測試用替身),SPI ioctl 會被略過。
+ *
+ * @param config 燈條配置
+ * @return 燈條控制代碼, NULL 表示失敗
+ *
+ * @note spidev 單次傳輸上限預設為 4096 bytes (模組參數 spidev.bufsiz),
+ *       燈珠數多於約 440 顆時需要調高
+ */
+led_strip_t* led_strip_open(const led_strip_config_t *config);
+
+/**
+ * @brief 關閉燈條並釋放資源
+ */
+void led_strip_close(led_strip_t *strip);
+
+/**
+ * @brief 取得燈珠數量
+ */
+int led_strip_get_count(const led_strip_t *strip);
+
+/**
+ * @brief 設定單顆燈珠顏色 (只更新幀緩衝,不送出)
+ *
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤或索引超出範圍
+ */
+int led_strip_set_pixel(led_strip_t *strip, int index, led_color_t color);
+
+/**
+ * @brief 讀取幀緩衝中單顆燈珠顏色
+ */
+int led_strip_get_pixel(const led_strip_t *strip, int index, led_color_t *color);
+
+/**
+ * @brief 將整條燈設為同一顏色
+ */
+int led_strip_fill(led_strip_t *strip, led_color_t color);
+
+/**
+ * @brief 以整個陣列更新幀緩衝
+ *
+ * @param pixels 顏色陣列
+ * @param count 數量 (不可超過燈珠數量)
+ */
+int led_strip_set_pixels(led_strip_t *strip, const led_color_t *pixels, int count);
+
+/**
+ * @brief 送出目前的幀
+ *
+ * 幀沒有變更時直接返回,不做任何 I/O
+ *
+ * @return 1 已送出一幀
+ * @return 0 幀未變更,略過
+ * @return GAMING_ERROR_IO 寫入失敗
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ */
+int led_strip_show(led_strip_t *strip);
+
+/**
+ * @brief 將顏色編碼為 SPI 波形 (GRB 順序)
+ *
+ * @param pixels 顏色陣列
+ * @param count 數量
+ * @param out 輸出緩衝區,至少 count * LED_STRIP_BYTES_PER_LED bytes
+ */
+void led_strip_encode(const led_color_t *pixels, int count, uint8_t *out);
+
+/**
+ * @brief 計算一幀 (含 reset) 的位元組數
+ */
+size_t led_strip_frame_size(int num_leds);
+
+#endif // LED_STRIP_H
@@ -0,0 +1,398 @@
+/**
+ * @file led_worker.c
+ * @brief LED 非同步工作執行緒實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE  // eventfd
+
+#include "led_worker.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+// ========================================
+// 命令定義
+// ========================================
+
+#define CACHE_LINE_SIZE 64
+
+typedef enum {
+    LED_CMD_COLOR = 0,
+    LED_CMD_STATUS,
+    LED_CMD_BLINK,
+    LED_CMD_BREATHE,
+} led_cmd_type_t;
+
+typedef struct {
+    uint8_t type;
+    led_color_t color;
+    uint8_t device_type;
+    uint8_t ps5_state;
+    uint8_t vpn_state;
+    int32_t times;
+    int32_t interval_ms;
+} led_cmd_t;
+
+// ========================================
+// 內部狀態
+// ========================================
+
+// 計數器使用 32 位元,在 32 位元 MIPS 上也能原生原子存取
+// 生產者與消費者各自寫的欄位放在不同 cache line,避免互相干擾
+static struct {
+    // 生產者 (呼叫端) 寫入
+    uint32_t head __attribute__((aligned(CACHE_LINE_SIZE)));
+    uint32_t submitted;
+    uint32_t dropped;
+    int producers;          // 正在 push_command() 中的呼叫端,stop 等它們離開才釋放佇列
+
+    // 消費者 (LED 執行緒) 寫入
+    uint32_t tail __attribute__((aligned(CACHE_LINE_SIZE)));
+    uint32_t coalesced;
+    uint32_t applied;
+    int sleeping;
+
+    // 啟動後唯讀
+    led_cmd_t *ring __attribute__((aligned(CACHE_LINE_SIZE)));
+    uint32_t mask;
+    int wake_fd;
+    int running;
+    pthread_t thread;
+} worker = { .wake_fd = -1 };
+
+// 閃爍效果狀態 (只有 LED 執行緒存取)
+typedef struct {
+    bool active;
+    bool lit;
+    led_color_t color;
+    int remaining;      // 剩餘切換次數, < 0 表示無限
+    int interval_ms;
+    long long next_ms;
+} led_effect_t;
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+static long long now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static uint32_t round_up_pow2(uint32_t v) {
+    uint32_t n = 1;
+    while (n < v) {
+        n <<= 1;
+    }
+    return n;
+}
+
+static void counter_inc(uint32_t *counter, uint32_t n) {
+    // 每個計數器只有一個寫入者,其他執行緒只讀
+    __atomic_store_n(counter, *counter + n, __ATOMIC_RELAXED);
+}
+
+static int push_locked(const led_cmd_t *cmd) {
+    uint32_t head = worker.head;
+    uint32_t tail = __atomic_load_n(&worker.tail, __ATOMIC_ACQUIRE);
+
+    if (head - tail > worker.mask) {
+        counter_inc(&worker.dropped, 1);
+        return GAMING_ERROR_NO_MEMORY;
+    }
+
+    worker.ring[head & worker.mask] = *cmd;
+    __atomic_store_n(&worker.head, head + 1, __ATOMIC_RELEASE);
+    counter_inc(&worker.submitted, 1);
+
+    // 只有執行緒真的睡著時才需要 syscall 喚醒
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&worker.sleeping, __ATOMIC_RELAXED)) {
+        uint64_t one = 1;
+        if (write(worker.wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+            fprintf(stderr, "LED worker: Failed to wake thread\n");
+        }
+    }
+
+    return GAMING_OK;
+}
+
+static int push_command(const led_cmd_t *cmd) {
+    // 先登記再檢查 running: stop 清除 running 後會等登記歸零才釋放佇列,
+    // 與 stop 競爭的呼叫端不是看到 running == 0 而離開,就是在釋放前完成寫入
+    __atomic_add_fetch(&worker.producers, 1, __ATOMIC_SEQ_CST);
+    int ret = GAMING_ERROR_NOT_INITIALIZED;
+    if (__atomic_load_n(&worker.running, __ATOMIC_SEQ_CST)) {
+        ret = push_locked(cmd);
+    }
+    __atomic_sub_fetch(&worker.producers, 1, __ATOMIC_RELEASE);
+    return ret;
+}
+
+static void apply_command(const led_cmd_t *cmd, led_effect_t *effect,
+                          led_color_t *steady) {
+    effect->active = false;
+
+    switch (cmd->type) {
+        case LED_CMD_COLOR:
+            *steady = cmd->color;
+            led_set_color_preset(cmd->color);
+            break;
+
+        case LED_CMD_STATUS:
+            *steady = led_get_status_color((device_type_t)cmd->device_type,
+                                           (ps5_state_t)cmd->ps5_state,
+                                           (vpn_state_t)cmd->vpn_state);
+            led_set_color_preset(*steady);
+            break;
+
+        case LED_CMD_BLINK:
+            // 亮/滅各算一次切換,結束後回到原本的顏色
+            effect->active = true;
+            effect->lit = true;
+            effect->color = cmd->color;
+            effect->remaining = (cmd->times > 0) ? cmd->times * 2 - 1 : -1;
+            effect->interval_ms = cmd->interval_ms;
+            effect->next_ms = now_ms() + cmd->interval_ms;
+            led_set_color_preset(cmd->color);
+            break;
+
+        case LED_CMD_BREATHE:
+            *steady = cmd->color;
+            led_breathe(cmd->color, cmd->interval_ms);
+            break;
+
+        default:
+            return;
+    }
+
+    counter_inc(&worker.applied, 1);
+}
+
+static void step_effect(led_effect_t *effect, led_color_t steady) {
+    if (effect->remaining == 0) {
+        effect->active = false;
+        led_set_color_preset(steady);
+        return;
+    }
+
+    effect->lit = !effect->lit;
+    led_set_color_preset(effect->lit ? effect->color : LED_COLOR_BLACK);
+
+    if (effect->remaining > 0) {
+        effect->remaining--;
+    }
+    effect->next_ms += effect->interval_ms;
+}
+
+static void *worker_main(void *arg) {
+    led_effect_t effect = { .active = false };
+    led_color_t steady = LED_COLOR_BLACK;
+
+    (void)arg;
+
+    while (__atomic_load_n(&worker.running, __ATOMIC_ACQUIRE)) {
+        uint32_t tail = worker.tail;
+        uint32_t head = __atomic_load_n(&worker.head, __ATOMIC_ACQUIRE);
+
+        // 合併: 只套用最新一筆,其餘計為 coalesced
+        if (head != tail) {
+            led_cmd_t cmd = worker.ring[(head - 1) & worker.mask];
+            __atomic_store_n(&worker.tail, head, __ATOMIC_RELEASE);
+            counter_inc(&worker.coalesced, head - tail - 1);
+            apply_command(&cmd, &effect, &steady);
+        }
+
+        int timeout_ms = -1;
+        if (effect.active) {
+            long long wait = effect.next_ms - now_ms();
+            if (wait <= 0) {
+                step_effect(&effect, steady);
+                continue;
+            }
+            timeout_ms = (int)wait;
+        }
+
+        // 宣告即將睡眠後再檢查一次佇列,避免遺失喚醒
+        __atomic_store_n(&worker.sleeping, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&worker.head, __ATOMIC_ACQUIRE) != worker.tail ||
+            !__atomic_load_n(&worker.running, __ATOMIC_ACQUIRE)) {
+            __atomic_store_n(&worker.sleeping, 0, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        struct pollfd pfd = { .fd = worker.wake_fd, .events = POLLIN };
+        if (poll(&pfd, 1, timeout_ms) > 0) {
+            uint64_t value;
+            if (read(worker.wake_fd, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+                fprintf(stderr, "LED worker: Failed to read wake event\n");
+            }
+        }
+        __atomic_store_n(&worker.sleeping, 0, __ATOMIC_RELAXED);
+    }
+
+    return NULL;
+}
+
+// ========================================
+// 公開函數實作
+// ========================================
+
+int led_worker_start(unsigned int queue_depth) {
+    if (__atomic_load_n(&worker.running, __ATOMIC_ACQUIRE)) {
+        return GAMING_ERROR_ALREADY_EXISTS;
+    }
+
+    if (queue_depth == 0) {
+        queue_depth = LED_WORKER_DEFAULT_DEPTH;
+    }
+    if (queue_depth > LED_WORKER_MAX_DEPTH) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint32_t capacity = round_up_pow2(queue_depth);
+    led_cmd_t *ring = calloc(capacity, sizeof(led_cmd_t));
+    if (ring == NULL) {
+        return GAMING_ERROR_NO_MEMORY;
+    }
+
+    int wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0) {
+        fprintf(stderr, "LED worker: eventfd failed: %s\n", strerror(errno));
+        free(ring);
+        return GAMING_ERROR;
+    }
+
+    worker.head = 0;
+    worker.tail = 0;
+    worker.submitted = 0;
+    worker.dropped = 0;
+    worker.coalesced = 0;
+    worker.applied = 0;
+    worker.sleeping = 0;
+    worker.ring = ring;
+    worker.mask = capacity - 1;
+    worker.wake_fd = wake_fd;
+    __atomic_store_n(&worker.running, 1, __ATOMIC_RELEASE);
+
+    int ret = pthread_create(&worker.thread, NULL, worker_main, NULL);
+    if (ret != 0) {
+        fprintf(stderr, "LED worker: pthread_create failed: %s\n", strerror(ret));
+        __atomic_store_n(&worker.running, 0, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&worker.producers, __ATOMIC_SEQ_CST) > 0) {
+            sched_yield();
+        }
+        close(wake_fd);
+        worker.wake_fd = -1;
+        free(ring);
+        worker.ring = NULL;
+        return GAMING_ERROR;
+    }
+
+    #ifdef DEBUG
+    printf("LED worker started (depth=%u)\n", capacity);
+    #endif
+
+    return GAMING_OK;
+}
+
+void led_worker_stop(void) {
+    if (!__atomic_load_n(&worker.running, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    __atomic_store_n(&worker.running, 0, __ATOMIC_SEQ_CST);
+
+    // 等待已通過 running 檢查的呼叫端寫完 (它們也會用到 wake_fd)
+    while (__atomic_load_n(&worker.producers, __ATOMIC_SEQ_CST) > 0) {
+        sched_yield();
+    }
+
+    uint64_t one = 1;
+    if (write(worker.wake_fd, &one, sizeof(one)) < 0) {
+        fprintf(stderr, "LED worker: Failed to wake thread for stop\n");
+    }
+    pthread_join(worker.thread, NULL);
+
+    close(worker.wake_fd);
+    worker.wake_fd = -1;
+    free(worker.ring);
+    worker.ring = NULL;
+}
+
+bool led_worker_is_running(void) {
+    return __atomic_load_n(&worker.running, __ATOMIC_ACQUIRE) != 0;
+}
+
+int led_worker_set_color(uint8_t r, uint8_t g, uint8_t b) {
+    led_cmd_t cmd = {
+        .type = LED_CMD_COLOR,
+        .color = { r, g, b },
+    };
+    return push_command(&cmd);
+}
+
+int led_worker_set_status(device_type_t device_type, ps5_state_t ps5_state,
+                          vpn_state_t vpn_state) {
+    led_cmd_t cmd = {
+        .type = LED_CMD_STATUS,
+        .device_type = (uint8_t)device_type,
+        .ps5_state = (uint8_t)ps5_state,
+        .vpn_state = (uint8_t)vpn_state,
+    };
+    return push_command(&cmd);
+}
+
+int led_worker_blink(led_color_t color, int times, int interval_ms) {
+    if (interval_ms <= 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    led_cmd_t cmd = {
+        .type = LED_CMD_BLINK,
+        .color = color,
+        .times = times,
+        .interval_ms = interval_ms,
+    };
+    return push_command(&cmd);
+}
+
+int led_worker_breathe(led_color_t color, int duration_ms) {
+    led_cmd_t cmd = {
+        .type = LED_CMD_BREATHE,
+        .color = color,
+        .interval_ms = duration_ms,
+    };
+    return push_command(&cmd);
+}
+
+void led_worker_get_stats(led_worker_stats_t *stats) {
+    if (stats == NULL) {
+        return;
+    }
+
+    // 先讀消費端的 tail 再讀生產端的 head,確保 head >= tail (否則相減會溢位);
+    // 兩次讀取之間雙方都可能前進,因此仍以容量為上限
+    uint32_t tail = __atomic_load_n(&worker.tail, __ATOMIC_ACQUIRE);
+    uint32_t head = __atomic_load_n(&worker.head, __ATOMIC_ACQUIRE);
+
+    stats->submitted = __atomic_load_n(&worker.submitted, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&worker.dropped, __ATOMIC_RELAXED);
+    stats->coalesced = __atomic_load_n(&worker.coalesced, __ATOMIC_RELAXED);
+    stats->applied = __atomic_load_n(&worker.applied, __ATOMIC_RELAXED);
+    stats->capacity = worker.ring ? worker.mask + 1 : 0;
+    stats->depth = head - tail;
+    if (stats->depth > stats->capacity) {
+        stats->depth = stats->capacity;
+    }
+}
@@ -0,0 +1,111 @@
+/**
+ * @file led_worker.h
+ * @brief LED 非同步工作執行緒
+ * @version 1.0.0
+ *
+ * led_set_color() 會同步寫 sysfs,在按鈕或網路路徑上直接呼叫會帶來
+ * 數毫秒的抖動。非同步模式下,呼叫端只把命令放進無鎖的單一生產者
+ * 環形佇列 (SPSC),由 LED 執行緒合併後只套用最新的一筆。
+ *
+ * 注意: 佇列只支援「單一」生產者執行緒,多個執行緒送命令時
+ *       需由呼叫端自行序列化
+ */
+
+#ifndef LED_WORKER_H
+#define LED_WORKER_H
+
+#include "gaming_common.h"
+#include "led_controller.h"
+
+// ========================================
+// LED Worker 配置
+// ========================================
+
+// 預設佇列深度 (會向上取整為 2 的冪次)
+#define LED_WORKER_DEFAULT_DEPTH 16
+
+// 佇列深度上限
+#define LED_WORKER_MAX_DEPTH 1024
+
+// ========================================
+// 統計資訊
+// ========================================
+
+typedef struct {
+    uint32_t submitted;   ///< 成功放入佇列的命令數
+    uint32_t dropped;     ///< 佇列滿而丟棄的命令數
+    uint32_t coalesced;   ///< 被較新命令覆蓋、未套用的命令數
+    uint32_t applied;     ///< 實際套用到 LED 的命令數
+    uint32_t depth;       ///< 目前佇列中的命令數
+    uint32_t capacity;    ///< 佇列容量
+} led_worker_stats_t;
+
+// ========================================
+// LED Worker 公開函數
+// ========================================
+
+/**
+ * @brief 啟動 LED 工作執行緒
+ *
+ * LED 控制器必須先以 led_controller_init() 初始化
+ *
+ * @param queue_depth 佇列深度,0 則使用 LED_WORKER_DEFAULT_DEPTH
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_ALREADY_EXISTS 已在執行
+ * @return GAMING_ERROR_INVALID_PARAM 深度超過上限
+ * @return GAMING_ERROR_NO_MEMORY 配置佇列失敗
+ * @return GAMING_ERROR 建立執行緒失敗
+ */
+int led_worker_start(unsigned int queue_depth);
+
+/**
+ * @brief 停止 LED 工作執行緒
+ *
+ * 佇列中尚未處理的命令會被丟棄。可與送命令的執行緒並行呼叫:
+ * 會等正在放入佇列的命令完成後才釋放佇列,之後的命令回傳
+ * GAMING_ERROR_NOT_INITIALIZED
+ */
+void led_worker_stop(void);
+
+/**
+ * @brief 工作執行緒是否在執行
+ */
+bool led_worker_is_running(void);
+
+/**
+ * @brief 送出顏色命令 (不阻塞)
+ *
+ * @return GAMING_OK 已放入佇列
+ * @return GAMING_ERROR_NOT_INITIALIZED 執行緒未啟動
+ * @return GAMING_ERROR_NO_MEMORY 佇列已滿,命令被丟棄
+ */
+int led_worker_set_color(uint8_t r, uint8_t g, uint8_t b);
+
+/**
+ * @brief 送出狀態命令 (查表由工作執行緒完成)
+ */
+int led_worker_set_status(device_type_t device_type, ps5_state_t ps5_state,
+                          vpn_state_t vpn_state);
+
+/**
+ * @brief 送出閃爍命令
+ *
+ * @param color 顏色
+ * @param times 閃爍次數,<= 0 表示持續閃爍直到下一個命令
+ * @param interval_ms 亮/滅各自的時間
+ */
+int led_worker_blink(led_color_t color, int times, int interval_ms);
+
+/**
+ * @brief 送出呼吸燈命令
+ */
+int led_worker_breathe(led_color_t color, int duration_ms);
+
+/**
+ * @brief 取得統計資訊
+ *
+ * @param stats 輸出統計
+ */
+void led_worker_get_stats(led_worker_stats_t *stats);
+
+#endif // LED_WORKER_H
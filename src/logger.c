@@ -4,22 +4,182 @@
  * @version 1.0.0
  */
 
-#define _GNU_SOURCE  // 需要這個才能使用 vsyslog
+#define _GNU_SOURCE  // 需要這個才能使用 eventfd, sendmmsg
 
 #include "logger.h"
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <strings.h>
 #include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
 
 // ========================================
 // 私有變數
 // ========================================
 
+#define CACHE_LINE_SIZE 64
+
+// 寫入執行緒每批最多處理的筆數
+#define LOGGER_WRITE_BATCH 32
+
 static bool logger_initialized = false;
 static char logger_ident[64] = "gaming";
 static log_level_t current_log_level = LOG_LEVEL_INFO;
 static log_target_t current_log_target = LOG_TARGET_CONSOLE;
+static log_format_t current_log_format = LOG_FORMAT_TEXT;
+
+// 未初始化時高於所有等級,巨集的內聯檢查就會擋下全部呼叫
+#define LOGGER_LEVEL_DISABLED (LOG_LEVEL_ERROR + 1)
+int logger_active_level = LOGGER_LEVEL_DISABLED;
+
+// 追蹤掛勾 (flight recorder): 設定後所有等級都會先交給它
+static logger_trace_fn trace_hook = NULL;
+
+// 未初始化時模組仍輸出 WARNING 以上到 stderr
+#define LOGGER_LEVEL_FALLBACK LOG_LEVEL_WARN
+
+// 各模組設定的等級 (LOG_LEVEL_INHERIT 跟隨全域) 與巨集使用的內聯門檻
+static int module_levels[LOG_MODULE_COUNT] = {
+    [0 ... LOG_MODULE_COUNT - 1] = LOG_LEVEL_INHERIT
+};
+int logger_module_active_level[LOG_MODULE_COUNT] = {
+    [LOG_MODULE_CORE] = LOGGER_LEVEL_DISABLED,
+    [1 ... LOG_MODULE_COUNT - 1] = LOGGER_LEVEL_FALLBACK
+};
+
+// 訊號切換的全部 DEBUG 狀態
+static int debug_override = 0;
+
+static const char *const module_names[LOG_MODULE_COUNT] = {
+    "core", "gpio", "led", "adc", "hal", "socket"
+};
+
+// 訊息前的標籤,一般呼叫 (core) 不加
+static const char *const module_tags[LOG_MODULE_COUNT] = {
+    "", "[gpio] ", "[led] ", "[adc] ", "[hal] ", "[socket] "
+};
+
+// 佇列中的一筆日誌 (已格式化)
+typedef struct {
+    uint32_t seq;         // 位置序號 (有界 MPMC 佇列的 cell 狀態)
+    uint8_t level;
+    uint16_t len;
+    uint16_t msec;
+    time_t sec;
+    char msg[LOGGER_MSG_MAX];
+} log_record_t;
+
+// 時間戳記: 秒以下只取到毫秒,粗粒度時鐘不需要進入核心
+#ifdef CLOCK_REALTIME_COARSE
+#define LOGGER_CLOCK CLOCK_REALTIME_COARSE
+#else
+#define LOGGER_CLOCK CLOCK_REALTIME
+#endif
+
+// "YYYY-mm-dd HH:MM:SS" 的長度
+#define TIMESTAMP_PREFIX_LEN 19
+
+// syslog 佇列滿時的等待上限: 呼叫端只等一下,寫入執行緒可以等久一點
+#define SYSLOG_WAIT_CALLER_MS  5
+#define SYSLOG_WAIT_WRITER_MS  200
+
+// 直接寫入 /dev/log 的 datagram socket (取代 openlog/vsyslog)
+static struct {
+    pthread_mutex_t lock;
+    int fd;
+    bool enabled;
+    char path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+    // 依等級預先組好的 "<pri>ident[pid]: " 標頭
+    char header[LOG_LEVEL_ERROR + 1][96];
+    size_t header_len[LOG_LEVEL_ERROR + 1];
+    uint32_t sent;
+    uint32_t dropped;
+    uint32_t reconnects;
+} syslog_out = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .fd = -1,
+    .path = LOGGER_SYSLOG_PATH,
+};
+
+// 檔案輸出: 使用者空間緩衝區,由 lock 保護
+static struct {
+    pthread_mutex_t lock;
+    int fd;
+    char path[128];
+    char *buffer;
+    size_t buffer_size;
+    size_t len;
+    size_t file_size;
+    size_t max_size;
+    unsigned int max_files;
+    unsigned int flush_interval_ms;
+    log_file_sync_t sync;
+    uint32_t last_flush_ms;
+    uint32_t lines;
+    uint32_t writes;
+    uint32_t syncs;
+    uint32_t rotations;
+    uint32_t errors;
+} file_out = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .fd = -1,
+    .path = LOGGER_FILE_DEFAULT_PATH,
+    .buffer_size = LOGGER_FILE_DEFAULT_BUFFER,
+    .max_size = LOGGER_FILE_DEFAULT_SIZE,
+    .max_files = LOGGER_FILE_DEFAULT_FILES,
+    .flush_interval_ms = LOGGER_FILE_DEFAULT_FLUSH_MS,
+    .sync = LOG_FILE_SYNC_ERROR,
+};
+
+// 計數器使用 32 位元,在 32 位元 MIPS 上也能原生原子存取
+static struct {
+    // 生產者 (多個呼叫端執行緒) 寫入
+    uint32_t enqueue_pos __attribute__((aligned(CACHE_LINE_SIZE)));
+    uint32_t enqueued;
+    uint32_t dropped;
+
+    // 寫入執行緒寫入
+    uint32_t dequeue_pos __attribute__((aligned(CACHE_LINE_SIZE)));
+    uint32_t written;
+    uint32_t batches;
+    int sleeping;
+
+    // 啟動後唯讀
+    log_record_t *ring __attribute__((aligned(CACHE_LINE_SIZE)));
+    uint32_t mask;
+    log_overflow_t overflow;
+    int wake_fd;
+    int running;
+    pthread_t thread;
+
+    // logger_flush() 等待寫入進度
+    pthread_mutex_t flush_lock;
+    pthread_cond_t flush_cond;
+} async_log = {
+    .wake_fd = -1,
+    .flush_lock = PTHREAD_MUTEX_INITIALIZER,
+    .flush_cond = PTHREAD_COND_INITIALIZER,
+};
+
+// 每個執行緒自己的格式化緩衝區,格式化時不需要任何鎖
+static __thread char tls_format_buffer[LOGGER_MSG_MAX];
+
+// 每個執行緒快取目前這一秒的時間字串,秒數改變時才重新產生
+static __thread time_t tls_ts_sec;
+static __thread bool tls_ts_valid;
+static __thread char tls_ts_prefix[TIMESTAMP_PREFIX_LEN + 1];
 
 // ========================================
 // 私有函數
@@ -43,51 +203,827 @@ static int log_level_to_syslog_priority(log_level_t level) {
     }
 }
 
+static bool is_valid_level(log_level_t level) {
+    return (int)level >= LOG_LEVEL_DEBUG && (int)level <= LOG_LEVEL_ERROR;
+}
+
+static bool is_valid_module(log_module_t module) {
+    return (int)module >= LOG_MODULE_CORE && (int)module < LOG_MODULE_COUNT;
+}
+
+static bool is_valid_target(log_target_t target) {
+    return (int)target >= LOG_TARGET_SYSLOG && (int)target <= LOG_TARGET_FILE;
+}
+
+static bool target_has_console(log_target_t target) {
+    return target == LOG_TARGET_CONSOLE || target == LOG_TARGET_BOTH;
+}
+
+static bool target_has_syslog(log_target_t target) {
+    return target == LOG_TARGET_SYSLOG || target == LOG_TARGET_BOTH;
+}
+
+static bool target_has_file(log_target_t target) {
+    return target == LOG_TARGET_FILE;
+}
+
 /**
- * @brief 取得當前時間字串
+ * @brief 產生 "YYYY-mm-dd HH:MM:SS.mmm" 時間字串 (不含結尾 '\0')
+ * 
+ * 秒數部分每個執行緒每秒只呼叫一次 localtime_r/strftime,
+ * 毫秒以整數運算直接填入
+ * 
+ * @return 寫入的位元組數
  */
-static void get_timestamp(char *buffer, size_t size) {
-    time_t now = time(NULL);
-    struct tm *tm_info = localtime(&now);
-    strftime(buffer, size, "%Y-%m-%d %H:%M:%S", tm_info);
+static size_t format_timestamp(time_t sec, unsigned int msec, char *out) {
+    if (!tls_ts_valid || sec != tls_ts_sec) {
+        struct tm tm_info;
+        localtime_r(&sec, &tm_info);
+        if (strftime(tls_ts_prefix, sizeof(tls_ts_prefix),
+                     "%Y-%m-%d %H:%M:%S", &tm_info) != TIMESTAMP_PREFIX_LEN) {
+            memset(tls_ts_prefix, '?', TIMESTAMP_PREFIX_LEN);
+        }
+        tls_ts_sec = sec;
+        tls_ts_valid = true;
+    }
+
+    memcpy(out, tls_ts_prefix, TIMESTAMP_PREFIX_LEN);
+    out[TIMESTAMP_PREFIX_LEN] = '.';
+    out[TIMESTAMP_PREFIX_LEN + 1] = (char)('0' + msec / 100);
+    out[TIMESTAMP_PREFIX_LEN + 2] = (char)('0' + (msec / 10) % 10);
+    out[TIMESTAMP_PREFIX_LEN + 3] = (char)('0' + msec % 10);
+    return TIMESTAMP_PREFIX_LEN + 4;
+}
+
+static void current_time(time_t *sec, uint16_t *msec) {
+    struct timespec ts;
+    clock_gettime(LOGGER_CLOCK, &ts);
+    *sec = ts.tv_sec;
+    *msec = (uint16_t)(ts.tv_nsec / 1000000L);
+}
+
+static uint32_t monotonic_ms(void) {
+    struct timespec ts;
+#ifdef CLOCK_MONOTONIC_COARSE
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (uint32_t)ts.tv_sec * 1000u + (uint32_t)(ts.tv_nsec / 1000000L);
 }
 
 /**
- * @brief 輸出日誌到 console
+ * @brief 組出 console 的一行輸出: "[時間] [等級] 訊息\n"
+ * @return 寫入的位元組數 (空間不足時截斷訊息,保留換行)
  */
-static void log_to_console(log_level_t level, const char *fmt, va_list args) {
-    char timestamp[32];
-    get_timestamp(timestamp, sizeof(timestamp));
-    
+static size_t format_console_line(char *out, size_t size, log_level_t level,
+                                  time_t sec, unsigned int msec,
+                                  const char *msg, size_t msg_len) {
     const char *level_str = logger_level_string(level);
-    
-    fprintf(stderr, "[%s] [%s] ", timestamp, level_str);
-    vfprintf(stderr, fmt, args);
-    fprintf(stderr, "\n");
+    size_t level_len = strlen(level_str);
+    // "[" + 時間 + "] [" + 等級 + "] " + "\n"
+    size_t fixed = 1 + TIMESTAMP_PREFIX_LEN + 4 + 3 + level_len + 2 + 1;
+
+    if (size < fixed + 1) {
+        return 0;
+    }
+    if (msg_len > size - fixed - 1) {
+        msg_len = size - fixed - 1;
+    }
+
+    char *p = out;
+    *p++ = '[';
+    p += format_timestamp(sec, msec, p);
+    memcpy(p, "] [", 3);
+    p += 3;
+    memcpy(p, level_str, level_len);
+    p += level_len;
+    *p++ = ']';
+    *p++ = ' ';
+    memcpy(p, msg, msg_len);
+    p += msg_len;
+    *p++ = '\n';
+    *p = '\0';
+
+    return (size_t)(p - out);
+}
+
+// ========================================
+// syslog 傳輸 (/dev/log datagram)
+// ========================================
+
+static void syslog_build_headers(void) {
+    int pid = (int)getpid();
+
+    for (int level = LOG_LEVEL_DEBUG; level <= LOG_LEVEL_ERROR; level++) {
+        int pri = LOG_USER | log_level_to_syslog_priority((log_level_t)level);
+        int n = snprintf(syslog_out.header[level], sizeof(syslog_out.header[level]),
+                         "<%d>%s[%d]: ", pri, logger_ident, pid);
+        syslog_out.header_len[level] = (n > 0 && (size_t)n < sizeof(syslog_out.header[level]))
+                                       ? (size_t)n : 0;
+    }
+}
+
+/**
+ * @brief 建立並連接 datagram socket (需持有 syslog_out.lock)
+ */
+static void syslog_connect_locked(void) {
+    struct sockaddr_un addr;
+
+    if (syslog_out.fd >= 0) {
+        close(syslog_out.fd);
+        syslog_out.fd = -1;
+    }
+
+    size_t path_len = strnlen(syslog_out.path, sizeof(addr.sun_path));
+    if (path_len >= sizeof(addr.sun_path)) {
+        return;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, syslog_out.path, path_len + 1);
+
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return;
+    }
+
+    syslog_out.fd = fd;
+}
+
+static void syslog_open(void) {
+    pthread_mutex_lock(&syslog_out.lock);
+    syslog_build_headers();
+    syslog_connect_locked();
+    syslog_out.enabled = true;
+    pthread_mutex_unlock(&syslog_out.lock);
+}
+
+static void syslog_close(void) {
+    pthread_mutex_lock(&syslog_out.lock);
+    if (syslog_out.fd >= 0) {
+        close(syslog_out.fd);
+        syslog_out.fd = -1;
+    }
+    syslog_out.enabled = false;
+    pthread_mutex_unlock(&syslog_out.lock);
+}
+
+/**
+ * @brief 錯誤是否表示 syslogd 已重啟 (舊 socket 失效,需要重新連接)
+ */
+static bool syslog_peer_gone(int err) {
+    return err == ECONNREFUSED || err == ENOTCONN || err == ENOENT ||
+           err == EBADF || err == EPIPE || err == EDESTADDRREQ;
+}
+
+/**
+ * @brief 批次送出多筆日誌 (需持有 syslog_out.lock)
+ * 
+ * syslogd 重啟時重新連接後重送;接收佇列滿時最多等待 wait_ms,
+ * 逾時則丟棄剩下的日誌並計數
+ */
+static void syslog_send_locked(struct mmsghdr *msgs, unsigned int count, int wait_ms) {
+    unsigned int done = 0;
+    bool reconnected = false;
+
+    while (done < count) {
+        if (syslog_out.fd < 0) {
+            if (reconnected) {
+                break;
+            }
+            syslog_connect_locked();
+            syslog_out.reconnects++;
+            reconnected = true;
+            continue;
+        }
+
+        int n = sendmmsg(syslog_out.fd, msgs + done, count - done, MSG_NOSIGNAL);
+        if (n > 0) {
+            done += (unsigned int)n;
+            continue;
+        }
+
+        int err = errno;
+        if (err == EINTR) {
+            continue;
+        }
+        if (err == EAGAIN && wait_ms > 0) {
+            struct pollfd pfd = { .fd = syslog_out.fd, .events = POLLOUT };
+            if (poll(&pfd, 1, wait_ms) > 0) {
+                continue;
+            }
+            break;
+        }
+        if (syslog_peer_gone(err) && !reconnected) {
+            syslog_connect_locked();
+            syslog_out.reconnects++;
+            reconnected = true;
+            continue;
+        }
+        break;
+    }
+
+    __atomic_add_fetch(&syslog_out.sent, done, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&syslog_out.dropped, count - done, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 設定一筆 "標頭 + 訊息" 的 datagram
+ */
+static void syslog_prepare(struct mmsghdr *msg, struct iovec *iov, log_level_t level,
+                           const char *text, size_t len) {
+    iov[0].iov_base = syslog_out.header[level];
+    iov[0].iov_len = syslog_out.header_len[level];
+    iov[1].iov_base = (void *)text;
+    iov[1].iov_len = len;
+
+    memset(msg, 0, sizeof(*msg));
+    msg->msg_hdr.msg_iov = iov;
+    msg->msg_hdr.msg_iovlen = 2;
+}
+
+static void syslog_send_one(log_level_t level, const char *msg, size_t len) {
+    struct mmsghdr mmsg;
+    struct iovec iov[2];
+
+    pthread_mutex_lock(&syslog_out.lock);
+    if (syslog_out.enabled) {
+        syslog_prepare(&mmsg, iov, level, msg, len);
+        syslog_send_locked(&mmsg, 1, SYSLOG_WAIT_CALLER_MS);
+    }
+    pthread_mutex_unlock(&syslog_out.lock);
+}
+
+// ========================================
+// 檔案輸出 (緩衝寫入與大小輪替)
+// ========================================
+
+/**
+ * @brief 依序改名 path.N-1 → path.N ... path → path.1,再建立新檔 (需持有 file_out.lock)
+ */
+static void file_rotate_locked(void) {
+    char from[sizeof(file_out.path) + 16];
+    char to[sizeof(file_out.path) + 16];
+
+    close(file_out.fd);
+    for (unsigned int i = file_out.max_files; i > 1; i--) {
+        snprintf(from, sizeof(from), "%s.%u", file_out.path, i - 1);
+        snprintf(to, sizeof(to), "%s.%u", file_out.path, i);
+        rename(from, to);
+    }
+    snprintf(to, sizeof(to), "%s.1", file_out.path);
+    rename(file_out.path, to);
+
+    file_out.fd = open(file_out.path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    file_out.file_size = 0;
+    file_out.rotations++;
+}
+
+/**
+ * @brief 寫入一段資料,超過大小上限時先輪替 (需持有 file_out.lock)
+ */
+static void file_write_locked(const char *data, size_t len) {
+    if (file_out.fd >= 0 && file_out.file_size > 0 &&
+        file_out.file_size + len > file_out.max_size) {
+        file_rotate_locked();
+    }
+    if (file_out.fd < 0) {
+        file_out.errors++;
+        return;
+    }
+
+    size_t offset = 0;
+    while (offset < len) {
+        ssize_t n = write(file_out.fd, data + offset, len - offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            file_out.errors++;
+            break;
+        }
+        offset += (size_t)n;
+    }
+
+    file_out.file_size += offset;
+    file_out.writes++;
+}
+
+/**
+ * @brief 寫出緩衝區,必要時 fdatasync (需持有 file_out.lock)
+ */
+static void file_flush_locked(bool sync) {
+    if (file_out.len > 0) {
+        file_write_locked(file_out.buffer, file_out.len);
+        __atomic_store_n(&file_out.len, 0, __ATOMIC_RELAXED);
+    }
+    if (sync && file_out.fd >= 0) {
+        fdatasync(file_out.fd);
+        file_out.syncs++;
+    }
+    file_out.last_flush_ms = monotonic_ms();
+}
+
+static int file_open(void) {
+    int result = GAMING_OK;
+
+    pthread_mutex_lock(&file_out.lock);
+    if (file_out.fd >= 0) {
+        file_flush_locked(false);
+        close(file_out.fd);
+        file_out.fd = -1;
+    }
+
+    if (file_out.buffer == NULL) {
+        file_out.buffer = malloc(file_out.buffer_size);
+    }
+    if (file_out.buffer == NULL) {
+        result = GAMING_ERROR_NO_MEMORY;
+    } else {
+        file_out.fd = open(file_out.path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        struct stat st;
+        if (file_out.fd < 0) {
+            fprintf(stderr, "Logger: Failed to open %s: %s\n", file_out.path, strerror(errno));
+            result = GAMING_ERROR_IO;
+        } else if (fstat(file_out.fd, &st) == 0) {
+            file_out.file_size = (size_t)st.st_size;
+        }
+    }
+
+    file_out.len = 0;
+    file_out.last_flush_ms = monotonic_ms();
+    pthread_mutex_unlock(&file_out.lock);
+    return result;
+}
+
+static void file_close(void) {
+    pthread_mutex_lock(&file_out.lock);
+    if (file_out.fd >= 0) {
+        file_flush_locked(false);
+        close(file_out.fd);
+        file_out.fd = -1;
+    }
+    free(file_out.buffer);
+    file_out.buffer = NULL;
+    file_out.len = 0;
+    pthread_mutex_unlock(&file_out.lock);
+}
+
+/**
+ * @brief 將已格式化的行放入緩衝區
+ * 
+ * 緩衝區滿時寫出;ERROR 一律立即寫出,依 sync 策略再 fdatasync (或每次都 fdatasync);
+ * 距離上次寫出超過間隔時也寫出
+ * 
+ * @param max_level 這段資料中最高的等級
+ * @param count 行數
+ */
+static void file_append(log_level_t max_level, const char *data, size_t len, uint32_t count) {
+    pthread_mutex_lock(&file_out.lock);
+    if (file_out.fd < 0 || file_out.buffer == NULL) {
+        file_out.errors++;
+        pthread_mutex_unlock(&file_out.lock);
+        return;
+    }
+
+    if (len > file_out.buffer_size - file_out.len) {
+        file_flush_locked(false);
+    }
+    if (len > file_out.buffer_size) {
+        // 比整個緩衝區還大: 直接寫入
+        file_write_locked(data, len);
+    } else {
+        memcpy(file_out.buffer + file_out.len, data, len);
+        __atomic_store_n(&file_out.len, file_out.len + len, __ATOMIC_RELAXED);
+    }
+    file_out.lines += count;
+
+    bool sync = file_out.sync == LOG_FILE_SYNC_ALWAYS ||
+                (file_out.sync == LOG_FILE_SYNC_ERROR && max_level >= LOG_LEVEL_ERROR);
+    if (sync) {
+        file_flush_locked(true);
+    } else if (max_level >= LOG_LEVEL_ERROR ||
+               monotonic_ms() - file_out.last_flush_ms >= file_out.flush_interval_ms) {
+        // 同步模式沒有計時器,閒置前的最後一筆 ERROR 不能留在緩衝區
+        file_flush_locked(false);
+    }
+    pthread_mutex_unlock(&file_out.lock);
+}
+
+/**
+ * @brief 緩衝區停留超過間隔時寫出 (寫入執行緒閒置時呼叫)
+ */
+static void file_tick(void) {
+    pthread_mutex_lock(&file_out.lock);
+    if (file_out.len > 0 &&
+        monotonic_ms() - file_out.last_flush_ms >= file_out.flush_interval_ms) {
+        file_flush_locked(false);
+    }
+    pthread_mutex_unlock(&file_out.lock);
+}
+
+/**
+ * @brief 寫入執行緒的睡眠上限: 緩衝區有資料時到下次該寫出的時間,否則無限
+ */
+static int file_poll_timeout(void) {
+    if (!target_has_file(current_log_target) ||
+        __atomic_load_n(&file_out.len, __ATOMIC_RELAXED) == 0) {
+        return -1;
+    }
+
+    uint32_t waited = monotonic_ms() - file_out.last_flush_ms;
+    if (waited >= file_out.flush_interval_ms) {
+        return 0;
+    }
+    return (int)(file_out.flush_interval_ms - waited);
+}
+
+/**
+ * @brief 同步輸出一筆已格式化的日誌
+ */
+static void write_record(log_level_t level, time_t sec, unsigned int msec,
+                         const char *msg, size_t msg_len) {
+    if (target_has_console(current_log_target)) {
+        char line[LOGGER_MSG_MAX + 64];
+        size_t len = format_console_line(line, sizeof(line), level, sec, msec,
+                                         msg, msg_len);
+        fwrite(line, 1, len, stderr);
+    }
+
+    if (target_has_syslog(current_log_target)) {
+        syslog_send_one(level, msg, msg_len);
+    }
+
+    if (target_has_file(current_log_target)) {
+        char line[LOGGER_MSG_MAX + 64];
+        size_t len = format_console_line(line, sizeof(line), level, sec, msec,
+                                         msg, msg_len);
+        file_append(level, line, len, 1);
+    }
+}
+
+static uint32_t round_up_pow2(uint32_t v) {
+    uint32_t n = 1;
+    while (n < v) {
+        n <<= 1;
+    }
+    return n;
+}
+
+static void wake_writer(void) {
+    uint64_t one = 1;
+    if (write(async_log.wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        fprintf(stderr, "Logger: Failed to wake writer thread\n");
+    }
 }
 
 /**
- * @brief 輸出日誌到 syslog
+ * @brief 放入非同步佇列 (有界多生產者佇列,每個 cell 以序號表示狀態)
+ * @return true 成功, false 佇列已滿
  */
-static void log_to_syslog(log_level_t level, const char *fmt, va_list args) {
-    int priority = log_level_to_syslog_priority(level);
-    vsyslog(priority, fmt, args);
+static bool try_enqueue(log_level_t level, time_t sec, uint16_t msec,
+                        const char *msg, size_t len) {
+    uint32_t pos = __atomic_load_n(&async_log.enqueue_pos, __ATOMIC_RELAXED);
+
+    for (;;) {
+        log_record_t *cell = &async_log.ring[pos & async_log.mask];
+        uint32_t seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        int32_t diff = (int32_t)(seq - pos);
+
+        if (diff == 0) {
+            // cell 空著: 搶下這個位置
+            if (__atomic_compare_exchange_n(&async_log.enqueue_pos, &pos, pos + 1,
+                                            true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                cell->level = (uint8_t)level;
+                cell->sec = sec;
+                cell->msec = msec;
+                cell->len = (uint16_t)len;
+                memcpy(cell->msg, msg, len + 1);
+                __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+            // CAS 失敗時 pos 已更新為最新值,重試
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = __atomic_load_n(&async_log.enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void async_submit(log_level_t level, time_t sec, uint16_t msec,
+                         const char *msg, size_t len) {
+    while (!try_enqueue(level, sec, msec, msg, len)) {
+        if (async_log.overflow == LOG_OVERFLOW_DROP) {
+            __atomic_add_fetch(&async_log.dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+
+        // 阻塞模式: 叫醒寫入執行緒後稍候再試
+        wake_writer();
+        struct timespec ts = { 0, 100000L };
+        nanosleep(&ts, NULL);
+
+        if (!__atomic_load_n(&async_log.running, __ATOMIC_ACQUIRE)) {
+            write_record(level, sec, msec, msg, len);
+            return;
+        }
+    }
+
+    __atomic_add_fetch(&async_log.enqueued, 1, __ATOMIC_RELAXED);
+
+    // 只有寫入執行緒真的睡著時才需要 syscall 喚醒
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&async_log.sleeping, __ATOMIC_RELAXED)) {
+        wake_writer();
+    }
+}
+
+/**
+ * @brief 所有日誌函數的共同出口: 格式化一次,再同步輸出或放入佇列
+ */
+static void log_emit(log_module_t module, log_level_t level, const char *fmt, va_list args) {
+    char *msg = tls_format_buffer;
+    size_t tag_len = strlen(module_tags[module]);
+    memcpy(msg, module_tags[module], tag_len);
+
+    int n = vsnprintf(msg + tag_len, LOGGER_MSG_MAX - tag_len, fmt, args);
+    if (n < 0) {
+        return;
+    }
+
+    size_t len = tag_len + (size_t)n;
+    if (len > LOGGER_MSG_MAX - 1) {
+        len = LOGGER_MSG_MAX - 1;
+    }
+    time_t sec;
+    uint16_t msec;
+    current_time(&sec, &msec);
+
+    if (__atomic_load_n(&async_log.running, __ATOMIC_ACQUIRE)) {
+        async_submit(level, sec, msec, msg, len);
+    } else {
+        write_record(level, sec, msec, msg, len);
+    }
+}
+
+/**
+ * @brief 已組好的訊息的出口: 截斷後直接同步輸出或放入佇列
+ */
+static void log_emit_raw(log_level_t level, const char *msg, size_t len) {
+    if (len > LOGGER_MSG_MAX - 1) {
+        len = LOGGER_MSG_MAX - 1;
+    }
+
+    // 佇列與 console 格式化都以 '\0' 結尾的訊息為前提
+    char *buf = tls_format_buffer;
+    if (msg != buf) {
+        memcpy(buf, msg, len);
+    }
+    buf[len] = '\0';
+
+    time_t sec;
+    uint16_t msec;
+    current_time(&sec, &msec);
+
+    if (__atomic_load_n(&async_log.running, __ATOMIC_ACQUIRE)) {
+        async_submit(level, sec, msec, buf, len);
+    } else {
+        write_record(level, sec, msec, buf, len);
+    }
+}
+
+/**
+ * @brief 取出並輸出一批日誌 (只有寫入執行緒呼叫)
+ * @return 處理的筆數
+ */
+static int drain_batch(void) {
+    static char out[LOGGER_WRITE_BATCH * (LOGGER_MSG_MAX + 64)];
+    static struct mmsghdr msgs[LOGGER_WRITE_BATCH];
+    static struct iovec iovs[LOGGER_WRITE_BATCH][2];
+    size_t out_len = 0;
+    int count = 0;
+    uint32_t start = async_log.dequeue_pos;
+    uint32_t pos = start;
+    bool console = target_has_console(current_log_target);
+    bool use_syslog = target_has_syslog(current_log_target);
+    bool to_file = target_has_file(current_log_target);
+    log_level_t max_level = LOG_LEVEL_DEBUG;
+
+    while (count < LOGGER_WRITE_BATCH) {
+        log_record_t *cell = &async_log.ring[pos & async_log.mask];
+        if (__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) != pos + 1) {
+            break;
+        }
+
+        log_level_t level = (log_level_t)cell->level;
+        if (level > max_level) {
+            max_level = level;
+        }
+        if (console || to_file) {
+            out_len += format_console_line(out + out_len, sizeof(out) - out_len,
+                                           level, cell->sec, cell->msec,
+                                           cell->msg, cell->len);
+        }
+        if (use_syslog) {
+            syslog_prepare(&msgs[count], iovs[count], level, cell->msg, cell->len);
+        }
+
+        pos++;
+        count++;
+    }
+
+    if (count == 0) {
+        return 0;
+    }
+
+    // 檔案: 一批放入緩衝區一次
+    if (to_file) {
+        file_append(max_level, out, out_len, (uint32_t)count);
+    }
+
+    // console 一批只做一次 write()
+    size_t offset = 0;
+    while (console && offset < out_len) {
+        ssize_t n = write(STDERR_FILENO, out + offset, out_len - offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        offset += (size_t)n;
+    }
+
+    // syslog 一批只做一次 sendmmsg()
+    if (use_syslog) {
+        pthread_mutex_lock(&syslog_out.lock);
+        if (syslog_out.enabled) {
+            syslog_send_locked(msgs, (unsigned int)count, SYSLOG_WAIT_WRITER_MS);
+        }
+        pthread_mutex_unlock(&syslog_out.lock);
+    }
+
+    // 送出後才釋放 cell 給下一輪的生產者 (datagram 直接引用 cell 內容)
+    for (uint32_t p = start; p != pos; p++) {
+        log_record_t *cell = &async_log.ring[p & async_log.mask];
+        __atomic_store_n(&cell->seq, p + async_log.mask + 1, __ATOMIC_RELEASE);
+    }
+
+    // 更新進度並通知等待 logger_flush() 的執行緒
+    pthread_mutex_lock(&async_log.flush_lock);
+    async_log.dequeue_pos = pos;
+    __atomic_store_n(&async_log.written, async_log.written + (uint32_t)count,
+                     __ATOMIC_RELAXED);
+    __atomic_store_n(&async_log.batches, async_log.batches + 1, __ATOMIC_RELAXED);
+    pthread_cond_broadcast(&async_log.flush_cond);
+    pthread_mutex_unlock(&async_log.flush_lock);
+
+    return count;
+}
+
+static bool queue_has_pending(void) {
+    uint32_t pos = async_log.dequeue_pos;
+    log_record_t *cell = &async_log.ring[pos & async_log.mask];
+    return __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) == pos + 1;
+}
+
+static void *writer_main(void *arg) {
+    (void)arg;
+
+    for (;;) {
+        if (drain_batch() > 0) {
+            continue;
+        }
+
+        // 停止時先把佇列清空再離開
+        if (!__atomic_load_n(&async_log.running, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+
+        // 宣告即將睡眠後再檢查一次佇列,避免遺失喚醒
+        __atomic_store_n(&async_log.sleeping, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (queue_has_pending() || !__atomic_load_n(&async_log.running, __ATOMIC_ACQUIRE)) {
+            __atomic_store_n(&async_log.sleeping, 0, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        // 檔案緩衝區有資料時最多睡到該寫出的時間
+        struct pollfd pfd = { .fd = async_log.wake_fd, .events = POLLIN };
+        if (poll(&pfd, 1, file_poll_timeout()) > 0) {
+            uint64_t value;
+            if (read(async_log.wake_fd, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+                fprintf(stderr, "Logger: Failed to read wake event\n");
+            }
+        }
+        __atomic_store_n(&async_log.sleeping, 0, __ATOMIC_RELAXED);
+
+        if (target_has_file(current_log_target)) {
+            file_tick();
+        }
+    }
+
+    return NULL;
 }
 
 // ========================================
 // 公開 API 實作
 // ========================================
 
+/**
+ * @brief 模組實際輸出的等級門檻 (已初始化時)
+ */
+static int module_threshold(log_module_t module) {
+    if (__atomic_load_n(&debug_override, __ATOMIC_RELAXED)) {
+        return LOG_LEVEL_DEBUG;
+    }
+
+    int level = __atomic_load_n(&module_levels[module], __ATOMIC_RELAXED);
+    return (level == LOG_LEVEL_INHERIT) ? (int)current_log_level : level;
+}
+
+/**
+ * @brief 重新計算巨集使用的內聯等級門檻
+ * 
+ * 有追蹤掛勾時所有等級都要進入 logger_vlog(),輸出與否再依目前等級判斷。
+ * 只做原子讀寫,訊號處理函數中也可以呼叫
+ */
+static void update_active_level(void) {
+    for (int m = 0; m < LOG_MODULE_COUNT; m++) {
+        int level;
+        if (logger_initialized) {
+            level = module_threshold((log_module_t)m);
+        } else {
+            level = (m == LOG_MODULE_CORE) ? LOGGER_LEVEL_DISABLED : LOGGER_LEVEL_FALLBACK;
+        }
+        if (trace_hook != NULL) {
+            level = LOG_LEVEL_DEBUG;
+        }
+        __atomic_store_n(&logger_module_active_level[m], level, __ATOMIC_RELAXED);
+    }
+
+    __atomic_store_n(&logger_active_level,
+                     __atomic_load_n(&logger_module_active_level[LOG_MODULE_CORE],
+                                     __ATOMIC_RELAXED),
+                     __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief logger 未初始化時模組訊息的後備輸出: "[模組] 訊息\n" 寫到 stderr
+ */
+static void fallback_stderr(log_module_t module, const char *fmt, va_list args) {
+    char *msg = tls_format_buffer;
+    size_t tag_len = strlen(module_tags[module]);
+    memcpy(msg, module_tags[module], tag_len);
+
+    int n = vsnprintf(msg + tag_len, LOGGER_MSG_MAX - tag_len - 1, fmt, args);
+    if (n < 0) {
+        return;
+    }
+
+    size_t len = tag_len + (size_t)n;
+    if (len > LOGGER_MSG_MAX - 2) {
+        len = LOGGER_MSG_MAX - 2;
+    }
+    msg[len++] = '\n';
+    fwrite(msg, 1, len, stderr);
+}
+
+static void debug_signal_handler(int sig) {
+    int saved_errno = errno;
+    __atomic_xor_fetch(&debug_override, 1, __ATOMIC_RELAXED);
+    update_active_level();
+    errno = saved_errno;
+}
+
 int logger_init(const char *ident, log_level_t level, log_target_t target) {
     // 驗證參數
-    if (level < LOG_LEVEL_ERROR || level > LOG_LEVEL_DEBUG) {
+    if (!is_valid_level(level)) {
         return GAMING_ERROR_INVALID_PARAM;
     }
-    
-    if (target < LOG_TARGET_SYSLOG || target > LOG_TARGET_BOTH) {
+
+    if (!is_valid_target(target)) {
         return GAMING_ERROR_INVALID_PARAM;
     }
-    
+
+    // 檔案無法開啟時初始化失敗,不改變任何設定
+    if (target_has_file(target)) {
+        int ret = file_open();
+        if (ret != GAMING_OK) {
+            return ret;
+        }
+    } else {
+        file_close();
+    }
+
     // 設定識別字
     if (ident != NULL) {
         strncpy(logger_ident, ident, sizeof(logger_ident) - 1);
@@ -95,18 +1031,19 @@ int logger_init(const char *ident, log_level_t level, log_target_t target) {
     } else {
         strcpy(logger_ident, "gaming");
     }
-    
+
     // 設定日誌等級和目標
     current_log_level = level;
     current_log_target = target;
-    
+
     // 如果需要 syslog,開啟它
-    if (target == LOG_TARGET_SYSLOG || target == LOG_TARGET_BOTH) {
-        openlog(logger_ident, LOG_PID | LOG_CONS, LOG_USER);
+    if (target_has_syslog(target)) {
+        syslog_open();
     }
-    
+
     logger_initialized = true;
-    
+    update_active_level();
+
     return GAMING_OK;
 }
 
@@ -114,22 +1051,202 @@ void logger_cleanup(void) {
     if (!logger_initialized) {
         return;
     }
-    
+
+    // 先輸出佇列中的日誌
+    logger_async_stop();
+
     // 如果有開啟 syslog,關閉它
-    if (current_log_target == LOG_TARGET_SYSLOG || 
-        current_log_target == LOG_TARGET_BOTH) {
-        closelog();
+    if (target_has_syslog(current_log_target)) {
+        syslog_close();
     }
-    
+
+    // 寫出檔案緩衝區並關閉
+    file_close();
+
     logger_initialized = false;
+    update_active_level();
+}
+
+int logger_async_start(const logger_async_config_t *config) {
+    if (!logger_initialized) {
+        return GAMING_ERROR_NOT_INITIALIZED;
+    }
+    if (__atomic_load_n(&async_log.running, __ATOMIC_ACQUIRE)) {
+        return GAMING_ERROR_ALREADY_EXISTS;
+    }
+
+    unsigned int depth = LOGGER_DEFAULT_QUEUE_DEPTH;
+    log_overflow_t overflow = LOG_OVERFLOW_DROP;
+    if (config != NULL) {
+        if (config->queue_depth > LOGGER_MAX_QUEUE_DEPTH ||
+            (config->overflow != LOG_OVERFLOW_DROP &&
+             config->overflow != LOG_OVERFLOW_BLOCK)) {
+            return GAMING_ERROR_INVALID_PARAM;
+        }
+        if (config->queue_depth > 0) {
+            depth = config->queue_depth;
+        }
+        overflow = config->overflow;
+    }
+
+    // 至少 2 格,序號才能區分「空」與「滿」
+    uint32_t capacity = round_up_pow2(depth < 2 ? 2 : depth);
+    log_record_t *ring = calloc(capacity, sizeof(log_record_t));
+    if (ring == NULL) {
+        return GAMING_ERROR_NO_MEMORY;
+    }
+    for (uint32_t i = 0; i < capacity; i++) {
+        ring[i].seq = i;
+    }
+
+    int wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0) {
+        fprintf(stderr, "Logger: eventfd failed: %s\n", strerror(errno));
+        free(ring);
+        return GAMING_ERROR;
+    }
+
+    async_log.enqueue_pos = 0;
+    async_log.dequeue_pos = 0;
+    async_log.enqueued = 0;
+    async_log.dropped = 0;
+    async_log.written = 0;
+    async_log.batches = 0;
+    async_log.sleeping = 0;
+    async_log.ring = ring;
+    async_log.mask = capacity - 1;
+    async_log.overflow = overflow;
+    async_log.wake_fd = wake_fd;
+    __atomic_store_n(&async_log.running, 1, __ATOMIC_RELEASE);
+
+    int ret = pthread_create(&async_log.thread, NULL, writer_main, NULL);
+    if (ret != 0) {
+        fprintf(stderr, "Logger: pthread_create failed: %s\n", strerror(ret));
+        __atomic_store_n(&async_log.running, 0, __ATOMIC_RELEASE);
+        close(wake_fd);
+        async_log.wake_fd = -1;
+        free(ring);
+        async_log.ring = NULL;
+        return GAMING_ERROR;
+    }
+
+    return GAMING_OK;
+}
+
+void logger_async_stop(void) {
+    if (!__atomic_load_n(&async_log.running, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    // 寫入執行緒清空佇列後才會結束
+    __atomic_store_n(&async_log.running, 0, __ATOMIC_RELEASE);
+    wake_writer();
+    pthread_join(async_log.thread, NULL);
+
+    close(async_log.wake_fd);
+    async_log.wake_fd = -1;
+    free(async_log.ring);
+    async_log.ring = NULL;
+}
+
+int logger_set_syslog_path(const char *path) {
+    if (path == NULL || strlen(path) >= sizeof(syslog_out.path)) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&syslog_out.lock);
+    strcpy(syslog_out.path, path);
+    if (syslog_out.enabled) {
+        syslog_connect_locked();
+    }
+    pthread_mutex_unlock(&syslog_out.lock);
+
+    return GAMING_OK;
+}
+
+int logger_set_file(const logger_file_config_t *config) {
+    logger_file_config_t defaults = { 0 };
+    if (config == NULL) {
+        config = &defaults;
+    }
+
+    const char *path = config->path ? config->path : LOGGER_FILE_DEFAULT_PATH;
+    if (path[0] == '\0' || strlen(path) >= sizeof(file_out.path) ||
+        ((int)config->sync < LOG_FILE_SYNC_ERROR || (int)config->sync > LOG_FILE_SYNC_ALWAYS)) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&file_out.lock);
+    bool reopen = (file_out.fd >= 0);
+    if (reopen) {
+        file_flush_locked(false);
+        close(file_out.fd);
+        file_out.fd = -1;
+    }
+
+    strcpy(file_out.path, path);
+    size_t buffer_size = config->buffer_size ? config->buffer_size : LOGGER_FILE_DEFAULT_BUFFER;
+    if (buffer_size != file_out.buffer_size) {
+        free(file_out.buffer);
+        file_out.buffer = NULL;
+        file_out.buffer_size = buffer_size;
+    }
+    file_out.max_size = config->max_size ? config->max_size : LOGGER_FILE_DEFAULT_SIZE;
+    file_out.max_files = config->max_files ? config->max_files : LOGGER_FILE_DEFAULT_FILES;
+    file_out.flush_interval_ms = config->flush_interval_ms ?
+                                 config->flush_interval_ms : LOGGER_FILE_DEFAULT_FLUSH_MS;
+    file_out.sync = config->sync;
+    pthread_mutex_unlock(&file_out.lock);
+
+    return reopen ? file_open() : GAMING_OK;
+}
+
+void logger_get_file_stats(logger_file_stats_t *stats) {
+    if (stats == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&file_out.lock);
+    stats->lines = file_out.lines;
+    stats->writes = file_out.writes;
+    stats->syncs = file_out.syncs;
+    stats->rotations = file_out.rotations;
+    stats->errors = file_out.errors;
+    pthread_mutex_unlock(&file_out.lock);
+}
+
+void logger_get_syslog_stats(logger_syslog_stats_t *stats) {
+    if (stats == NULL) {
+        return;
+    }
+
+    stats->sent = __atomic_load_n(&syslog_out.sent, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&syslog_out.dropped, __ATOMIC_RELAXED);
+    stats->reconnects = __atomic_load_n(&syslog_out.reconnects, __ATOMIC_RELAXED);
+}
+
+bool logger_is_async(void) {
+    return __atomic_load_n(&async_log.running, __ATOMIC_ACQUIRE) != 0;
+}
+
+void logger_get_async_stats(logger_async_stats_t *stats) {
+    if (stats == NULL) {
+        return;
+    }
+
+    stats->enqueued = __atomic_load_n(&async_log.enqueued, __ATOMIC_RELAXED);
+    stats->written = __atomic_load_n(&async_log.written, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&async_log.dropped, __ATOMIC_RELAXED);
+    stats->batches = __atomic_load_n(&async_log.batches, __ATOMIC_RELAXED);
 }
 
 int logger_set_level(log_level_t level) {
-    if (level < LOG_LEVEL_ERROR || level > LOG_LEVEL_DEBUG) {
+    if (!is_valid_level(level)) {
         return GAMING_ERROR_INVALID_PARAM;
     }
-    
+
     current_log_level = level;
+    update_active_level();
     return GAMING_OK;
 }
 
@@ -137,153 +1254,305 @@ log_level_t logger_get_level(void) {
     return current_log_level;
 }
 
+int logger_set_module_level(log_module_t module, int level) {
+    if (!is_valid_module(module) ||
+        (level != LOG_LEVEL_INHERIT && !is_valid_level((log_level_t)level))) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    __atomic_store_n(&module_levels[module], level, __ATOMIC_RELAXED);
+    update_active_level();
+    return GAMING_OK;
+}
+
+int logger_get_module_level(log_module_t module) {
+    if (!is_valid_module(module)) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    return __atomic_load_n(&module_levels[module], __ATOMIC_RELAXED);
+}
+
+int logger_apply_module_levels(const char *spec) {
+    int levels[LOG_MODULE_COUNT];
+    char buffer[LOGGER_MSG_MAX];
+    char *save = NULL;
+
+    for (int m = 0; m < LOG_MODULE_COUNT; m++) {
+        levels[m] = LOG_LEVEL_INHERIT;
+    }
+
+    if (spec != NULL) {
+        if (strlen(spec) >= sizeof(buffer)) {
+            return GAMING_ERROR_INVALID_PARAM;
+        }
+        strcpy(buffer, spec);
+
+        // 先全部解析,有錯誤時不做任何變更
+        for (char *item = strtok_r(buffer, " ,\t\n", &save); item != NULL;
+             item = strtok_r(NULL, " ,\t\n", &save)) {
+            char *eq = strchr(item, '=');
+            if (eq == NULL) {
+                return GAMING_ERROR_INVALID_PARAM;
+            }
+            *eq = '\0';
+
+            int level = (strcasecmp(eq + 1, "inherit") == 0) ?
+                        LOG_LEVEL_INHERIT : logger_level_from_name(eq + 1);
+            if (level == GAMING_ERROR_INVALID_PARAM) {
+                return GAMING_ERROR_INVALID_PARAM;
+            }
+
+            if (strcmp(item, "*") == 0) {
+                for (int m = 0; m < LOG_MODULE_COUNT; m++) {
+                    levels[m] = level;
+                }
+            } else {
+                int module = logger_module_from_name(item);
+                if (module < 0) {
+                    return GAMING_ERROR_INVALID_PARAM;
+                }
+                levels[module] = level;
+            }
+        }
+    }
+
+    for (int m = 0; m < LOG_MODULE_COUNT; m++) {
+        __atomic_store_n(&module_levels[m], levels[m], __ATOMIC_RELAXED);
+    }
+    update_active_level();
+    return GAMING_OK;
+}
+
+int logger_install_debug_signal(int signo) {
+    struct sigaction sa;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = debug_signal_handler;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+
+    if (sigaction(signo, &sa, NULL) != 0) {
+        return GAMING_ERROR;
+    }
+    return GAMING_OK;
+}
+
+bool logger_debug_override_active(void) {
+    return __atomic_load_n(&debug_override, __ATOMIC_RELAXED) != 0;
+}
+
 int logger_set_target(log_target_t target) {
-    if (target < LOG_TARGET_SYSLOG || target > LOG_TARGET_BOTH) {
+    if (!is_valid_target(target)) {
         return GAMING_ERROR_INVALID_PARAM;
     }
-    
+
+    // 改為輸出到檔案: 先開啟,失敗時維持原本的目標
+    if (!target_has_file(current_log_target) && target_has_file(target)) {
+        int ret = file_open();
+        if (ret != GAMING_OK) {
+            file_close();
+            return ret;
+        }
+    }
+
     // 如果從不需要 syslog 改為需要,開啟它
-    if ((current_log_target == LOG_TARGET_CONSOLE) &&
-        (target == LOG_TARGET_SYSLOG || target == LOG_TARGET_BOTH)) {
-        openlog(logger_ident, LOG_PID | LOG_CONS, LOG_USER);
+    if (!target_has_syslog(current_log_target) && target_has_syslog(target)) {
+        syslog_open();
     }
-    
+
     // 如果從需要 syslog 改為不需要,關閉它
-    if ((current_log_target == LOG_TARGET_SYSLOG || 
-         current_log_target == LOG_TARGET_BOTH) &&
-        (target == LOG_TARGET_CONSOLE)) {
-        closelog();
+    if (target_has_syslog(current_log_target) && !target_has_syslog(target)) {
+        syslog_close();
     }
-    
+
+    log_target_t previous = current_log_target;
     current_log_target = target;
+
+    // 不再輸出到檔案: 寫出緩衝區並關閉
+    if (target_has_file(previous) && !target_has_file(target)) {
+        file_close();
+    }
     return GAMING_OK;
 }
 
+int logger_set_format(log_format_t format) {
+    if ((int)format < LOG_FORMAT_TEXT || (int)format > LOG_FORMAT_JSON) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    current_log_format = format;
+    return GAMING_OK;
+}
+
+log_format_t logger_get_format(void) {
+    return current_log_format;
+}
+
 log_target_t logger_get_target(void) {
     return current_log_target;
 }
 
 bool logger_should_log(log_level_t level) {
+    // 等級數字越大,越嚴重
+    // ERROR=3, WARN=2, INFO=1, DEBUG=0
+    // 如果設定為 INFO,則只輸出 ERROR, WARN, INFO
     if (!logger_initialized) {
         return false;
     }
-    
-    // 等級數字越大,越詳細
-    // ERROR=3, WARN=2, INFO=1, DEBUG=0
-    // 如果設定為 INFO,則只輸出 ERROR, WARN, INFO
-    return (level >= current_log_level);
+    return (int)level >= module_threshold(LOG_MODULE_CORE);
 }
 
-void logger_log(log_level_t level, const char *fmt, ...) {
-    if (!logger_initialized || !logger_should_log(level)) {
+void logger_set_trace_hook(logger_trace_fn hook) {
+    trace_hook = hook;
+    update_active_level();
+}
+
+void logger_module_vlog(log_module_t module, log_level_t level, const char *fmt, va_list args) {
+    if (!is_valid_module(module) || !LOGGER_MODULE_ENABLED(module, level)) {
         return;
     }
-    
-    va_list args;
-    
-    // 輸出到 console
-    if (current_log_target == LOG_TARGET_CONSOLE || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_console(level, fmt, args);
-        va_end(args);
-    }
-    
-    // 輸出到 syslog
-    if (current_log_target == LOG_TARGET_SYSLOG || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_syslog(level, fmt, args);
-        va_end(args);
-    }
-}
-
-void logger_error(const char *fmt, ...) {
-    if (!logger_initialized || !logger_should_log(LOG_LEVEL_ERROR)) {
-        return;
+
+    logger_trace_fn hook = trace_hook;
+    if (hook != NULL) {
+        va_list trace_args;
+        va_copy(trace_args, args);
+        hook(level, fmt, trace_args);
+        va_end(trace_args);
     }
-    
-    va_list args;
-    
-    if (current_log_target == LOG_TARGET_CONSOLE || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_console(LOG_LEVEL_ERROR, fmt, args);
-        va_end(args);
+
+    if (!logger_initialized) {
+        if (module != LOG_MODULE_CORE && (int)level >= LOGGER_LEVEL_FALLBACK) {
+            fallback_stderr(module, fmt, args);
+        }
+        return;
     }
-    
-    if (current_log_target == LOG_TARGET_SYSLOG || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_syslog(LOG_LEVEL_ERROR, fmt, args);
-        va_end(args);
+
+    if ((int)level >= module_threshold(module)) {
+        log_emit(module, level, fmt, args);
     }
 }
 
-void logger_warning(const char *fmt, ...) {
-    if (!logger_initialized || !logger_should_log(LOG_LEVEL_WARN)) {  // ← 使用 LOG_LEVEL_WARN
-        return;
-    }
-    
+static void trace_message(logger_trace_fn hook, log_level_t level, const char *fmt, ...) {
     va_list args;
-    
-    if (current_log_target == LOG_TARGET_CONSOLE || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_console(LOG_LEVEL_WARN, fmt, args);  // ← 使用 LOG_LEVEL_WARN
-        va_end(args);
+    va_start(args, fmt);
+    hook(level, fmt, args);
+    va_end(args);
+}
+
+void logger_module_write(log_module_t module, log_level_t level, const char *msg, size_t len) {
+    if (!is_valid_module(module) || msg == NULL || !LOGGER_MODULE_ENABLED(module, level)) {
+        return;
     }
-    
-    if (current_log_target == LOG_TARGET_SYSLOG || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_syslog(LOG_LEVEL_WARN, fmt, args);  // ← 使用 LOG_LEVEL_WARN
-        va_end(args);
+
+    logger_trace_fn hook = trace_hook;
+    if (hook != NULL) {
+        trace_message(hook, level, "%.*s", (int)len, msg);
     }
-}
 
-void logger_info(const char *fmt, ...) {
-    if (!logger_initialized || !logger_should_log(LOG_LEVEL_INFO)) {
+    if (!logger_initialized) {
+        if (module != LOG_MODULE_CORE && (int)level >= LOGGER_LEVEL_FALLBACK) {
+            fwrite(msg, 1, len, stderr);
+            fputc('\n', stderr);
+        }
         return;
     }
-    
+
+    if ((int)level >= module_threshold(module)) {
+        log_emit_raw(level, msg, len);
+    }
+}
+
+void logger_vlog(log_level_t level, const char *fmt, va_list args) {
+    logger_module_vlog(LOG_MODULE_CORE, level, fmt, args);
+}
+
+void logger_module_log(log_module_t module, log_level_t level, const char *fmt, ...) {
     va_list args;
-    
-    if (current_log_target == LOG_TARGET_CONSOLE || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_console(LOG_LEVEL_INFO, fmt, args);
-        va_end(args);
+    va_start(args, fmt);
+    logger_module_vlog(module, level, fmt, args);
+    va_end(args);
+}
+
+// 以下函數名稱加括號,避免被 logger.h 中的同名巨集展開
+// 保留給取函數位址或未使用巨集的呼叫端
+
+void (logger_log)(log_level_t level, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    logger_vlog(level, fmt, args);
+    va_end(args);
+}
+
+void (logger_error)(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    logger_vlog(LOG_LEVEL_ERROR, fmt, args);
+    va_end(args);
+}
+
+void (logger_warning)(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    logger_vlog(LOG_LEVEL_WARN, fmt, args);  // ← 使用 LOG_LEVEL_WARN
+    va_end(args);
+}
+
+void (logger_info)(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    logger_vlog(LOG_LEVEL_INFO, fmt, args);
+    va_end(args);
+}
+
+void (logger_debug)(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    logger_vlog(LOG_LEVEL_DEBUG, fmt, args);
+    va_end(args);
+}
+
+int logger_ratelimit_check(logger_ratelimit_t *rl, unsigned int rate, unsigned int burst) {
+    if (rl == NULL || rate == 0 || burst == 0) {
+        return 0;
     }
-    
-    if (current_log_target == LOG_TARGET_SYSLOG || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_syslog(LOG_LEVEL_INFO, fmt, args);
-        va_end(args);
+
+    uint32_t now = monotonic_ms();
+    int result;
+
+    while (__atomic_test_and_set(&rl->lock, __ATOMIC_ACQUIRE)) {
+        // 臨界區只有幾個整數運算,直接自旋
     }
-}
 
-void logger_debug(const char *fmt, ...) {
-    if (!logger_initialized || !logger_should_log(LOG_LEVEL_DEBUG)) {
-        return;
+    if (!rl->primed) {
+        rl->tokens = burst;
+        rl->last_ms = now;
+        rl->primed = true;
     }
-    
-    va_list args;
-    
-    if (current_log_target == LOG_TARGET_CONSOLE || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_console(LOG_LEVEL_DEBUG, fmt, args);
-        va_end(args);
+
+    // 依經過時間補充,只推進實際換到 token 的時間,保留不足一筆的餘數
+    uint32_t elapsed = now - rl->last_ms;
+    uint64_t refill = (uint64_t)elapsed * rate / 1000u;
+    if (refill > 0) {
+        if (rl->tokens + refill >= burst) {
+            rl->tokens = burst;
+            rl->last_ms = now;
+        } else {
+            rl->tokens += (uint32_t)refill;
+            rl->last_ms += (uint32_t)(refill * 1000u / rate);
+        }
     }
-    
-    if (current_log_target == LOG_TARGET_SYSLOG || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_syslog(LOG_LEVEL_DEBUG, fmt, args);
-        va_end(args);
+
+    if (rl->tokens > 0) {
+        rl->tokens--;
+        result = (int)rl->suppressed;
+        rl->suppressed = 0;
+    } else {
+        rl->suppressed++;
+        result = -1;
     }
+
+    __atomic_clear(&rl->lock, __ATOMIC_RELEASE);
+    return result;
 }
 
 const char* logger_level_string(log_level_t level) {
@@ -301,9 +1570,66 @@ const char* logger_level_string(log_level_t level) {
     }
 }
 
+int logger_level_from_name(const char *name) {
+    if (name == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    if (strcasecmp(name, "error") == 0) {
+        return LOG_LEVEL_ERROR;
+    }
+    if (strcasecmp(name, "warn") == 0 || strcasecmp(name, "warning") == 0) {
+        return LOG_LEVEL_WARN;
+    }
+    if (strcasecmp(name, "info") == 0) {
+        return LOG_LEVEL_INFO;
+    }
+    if (strcasecmp(name, "debug") == 0) {
+        return LOG_LEVEL_DEBUG;
+    }
+    return GAMING_ERROR_INVALID_PARAM;
+}
+
+const char* logger_module_name(log_module_t module) {
+    return is_valid_module(module) ? module_names[module] : "unknown";
+}
+
+int logger_module_from_name(const char *name) {
+    if (name == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    for (int m = 0; m < LOG_MODULE_COUNT; m++) {
+        if (strcasecmp(name, module_names[m]) == 0) {
+            return m;
+        }
+    }
+    return GAMING_ERROR_INVALID_PARAM;
+}
+
 void logger_flush(void) {
+    if (__atomic_load_n(&async_log.running, __ATOMIC_ACQUIRE)) {
+        // 等到呼叫前已放入佇列的日誌都輸出
+        uint32_t target = __atomic_load_n(&async_log.enqueue_pos, __ATOMIC_ACQUIRE);
+        wake_writer();
+
+        pthread_mutex_lock(&async_log.flush_lock);
+        while ((int32_t)(async_log.dequeue_pos - target) < 0 &&
+               __atomic_load_n(&async_log.running, __ATOMIC_ACQUIRE)) {
+            pthread_cond_wait(&async_log.flush_cond, &async_log.flush_lock);
+        }
+        pthread_mutex_unlock(&async_log.flush_lock);
+    }
+
     // Console 輸出立即刷新
     fflush(stderr);
-    
+
+    // 檔案緩衝區寫出 (不 fdatasync)
+    pthread_mutex_lock(&file_out.lock);
+    if (file_out.fd >= 0) {
+        file_flush_locked(false);
+    }
+    pthread_mutex_unlock(&file_out.lock);
+
     // syslog 不需要手動刷新
 }
@@ -4,6 +4,26 @@
  * @version 1.0.0
  * 
  * 提供統一的日誌系統,支援輸出到 syslog 和 console
+ * Console 格式: "[YYYY-mm-dd HH:MM:SS.mmm] [LEVEL] 訊息"
+ * 
+ * 非同步模式 (logger_async_start) 下,呼叫端只在自己的執行緒緩衝區
+ * 格式化訊息並放入有界的多生產者環形佇列,由單一寫入執行緒批次輸出,
+ * syslogd 卡住時不會拖慢呼叫端
+ * 
+ * syslog 輸出不經過 libc 的 vsyslog: 直接保持一個連接到 /dev/log 的
+ * 非阻塞 datagram socket,標頭 "<pri>ident[pid]: " 預先組好,
+ * 非同步模式下一批日誌以一次 sendmmsg() 送出,syslogd 重啟後自動重新連接
+ * 
+ * 檔案輸出 (LOG_TARGET_FILE) 先累積在使用者空間緩衝區,緩衝區滿、
+ * 超過寫入間隔或遇到 ERROR 時才一次 write(),只有 ERROR 會 fdatasync,
+ * 減少對 flash 的寫入次數;檔案超過大小上限時以 rename 輪替
+ * 
+ * 結構化日誌 (logger_fields.h) 依 logger_set_format() 輸出 logfmt 或 JSON,
+ * 經由 logger_module_write() 以已組好的訊息進入同一條輸出路徑
+ * 
+ * 函式庫各模組 (GPIO, LED, ADC, HAL, socket) 以 logger_mod() 輸出,
+ * 訊息前加上 "[模組] " 標籤,每個模組可在執行期各自設定等級
+ * (logger_set_module_level / logger_apply_module_levels / 訊號切換)
  */
 
 #ifndef LOGGER_H
@@ -11,7 +31,9 @@
 
 #include "gaming_common.h"
 #include <syslog.h>
+#include <stdarg.h>
 #include <stdbool.h>
+#include <stdio.h>
 
 // ========================================
 // 日誌目標定義
@@ -21,8 +43,130 @@ typedef enum {
     LOG_TARGET_SYSLOG = 0,   ///< 只輸出到 syslog
     LOG_TARGET_CONSOLE = 1,  ///< 只輸出到 console (stderr)
     LOG_TARGET_BOTH = 2,     ///< 同時輸出到 syslog 和 console
+    LOG_TARGET_FILE = 3,     ///< 只輸出到檔案 (見 logger_set_file)
 } log_target_t;
 
+// 結構化日誌的編碼格式 (見 logger_fields.h)
+typedef enum {
+    LOG_FORMAT_TEXT = 0,     ///< "[模組] 訊息 key=value",給人閱讀 (預設)
+    LOG_FORMAT_LOGFMT = 1,   ///< "level=info module=gpio msg=\"...\" key=value"
+    LOG_FORMAT_JSON = 2,     ///< {"level":"info","module":"gpio","msg":"...","key":value}
+} log_format_t;
+
+// 單筆日誌訊息長度上限 (超過會被截斷)
+#define LOGGER_MSG_MAX              256
+
+// syslog socket 預設路徑
+#define LOGGER_SYSLOG_PATH          "/dev/log"
+
+// 重複訊息限速預設值: 每秒補充的筆數與最多連續輸出的筆數
+#define LOGGER_RATELIMIT_RATE       5
+#define LOGGER_RATELIMIT_BURST      10
+
+// 檔案輸出預設值
+#define LOGGER_FILE_DEFAULT_PATH    "/tmp/gaming.log"
+#define LOGGER_FILE_DEFAULT_BUFFER  (64 * 1024)
+#define LOGGER_FILE_DEFAULT_SIZE    (512 * 1024)
+#define LOGGER_FILE_DEFAULT_FILES   1
+#define LOGGER_FILE_DEFAULT_FLUSH_MS 5000
+
+// 非同步佇列預設深度與上限 (會向上取整為 2 的冪次)
+#define LOGGER_DEFAULT_QUEUE_DEPTH  256
+#define LOGGER_MAX_QUEUE_DEPTH      65536
+
+// ========================================
+// 非同步模式配置
+// ========================================
+
+typedef enum {
+    LOG_OVERFLOW_DROP = 0,   ///< 佇列滿時丟棄並計數 (呼叫端不會等待)
+    LOG_OVERFLOW_BLOCK = 1,  ///< 佇列滿時等待寫入執行緒騰出空間
+} log_overflow_t;
+
+typedef struct {
+    unsigned int queue_depth;  ///< 佇列深度,0 則使用 LOGGER_DEFAULT_QUEUE_DEPTH
+    log_overflow_t overflow;   ///< 佇列滿時的處理方式
+} logger_async_config_t;
+
+typedef struct {
+    uint32_t enqueued;   ///< 放入佇列的筆數
+    uint32_t written;    ///< 寫入執行緒已輸出的筆數
+    uint32_t dropped;    ///< 佇列滿而丟棄的筆數
+    uint32_t batches;    ///< 寫入執行緒的批次數
+} logger_async_stats_t;
+
+/**
+ * @brief 單一呼叫點的限速狀態 (token bucket)
+ * 
+ * 由限速巨集以 static 變數放在呼叫點,不需要查表
+ */
+typedef struct {
+    unsigned char lock;      ///< 自旋鎖
+    bool primed;             ///< 是否已初始化 tokens
+    uint32_t tokens;         ///< 剩餘可輸出的筆數
+    uint32_t suppressed;     ///< 目前累計被抑制的筆數
+    uint32_t last_ms;        ///< 上次補充的時間 (CLOCK_MONOTONIC 毫秒)
+} logger_ratelimit_t;
+
+#define LOGGER_RATELIMIT_INIT { 0, false, 0, 0, 0 }
+
+// ========================================
+// 檔案輸出配置
+// ========================================
+
+typedef enum {
+    LOG_FILE_SYNC_ERROR = 0,   ///< 只有 ERROR 立即寫入並 fdatasync (預設)
+    LOG_FILE_SYNC_NEVER = 1,   ///< 從不 fdatasync,交給核心回寫
+    LOG_FILE_SYNC_ALWAYS = 2,  ///< 每次寫入後都 fdatasync
+} log_file_sync_t;
+
+typedef struct {
+    const char *path;                ///< 檔案路徑,NULL 則使用 LOGGER_FILE_DEFAULT_PATH
+    size_t buffer_size;              ///< 緩衝區大小,0 則使用 LOGGER_FILE_DEFAULT_BUFFER
+    size_t max_size;                 ///< 超過此大小時輪替,0 則使用 LOGGER_FILE_DEFAULT_SIZE
+    unsigned int max_files;          ///< 保留的舊檔數 (path.1 ...),0 則使用 LOGGER_FILE_DEFAULT_FILES
+    unsigned int flush_interval_ms;  ///< 緩衝區最長停留時間,0 則使用 LOGGER_FILE_DEFAULT_FLUSH_MS
+    log_file_sync_t sync;            ///< fdatasync 策略
+} logger_file_config_t;
+
+/*
+ * flush_interval_ms 的計時由 async 寫入執行緒負責 (logger_async_start())。
+ * 同步模式沒有計時器,間隔只在下一筆日誌時檢查: 閒置的程序會把
+ * 最後幾筆 INFO/WARN 留在緩衝區直到下一筆日誌、logger_flush() 或
+ * logger_cleanup()。ERROR 在兩種模式下都立即寫出。
+ */
+
+typedef struct {
+    uint32_t lines;      ///< 寫入緩衝區的行數
+    uint32_t writes;     ///< write() 次數
+    uint32_t syncs;      ///< fdatasync() 次數
+    uint32_t rotations;  ///< 輪替次數
+    uint32_t errors;     ///< 寫入失敗而丟棄的次數
+} logger_file_stats_t;
+
+// ========================================
+// 模組定義
+// ========================================
+
+typedef enum {
+    LOG_MODULE_CORE = 0,     ///< 一般呼叫 (logger_info 等,無標籤)
+    LOG_MODULE_GPIO = 1,     ///< gpio_lib
+    LOG_MODULE_LED = 2,      ///< led_controller
+    LOG_MODULE_ADC = 3,      ///< adc_reader
+    LOG_MODULE_HAL = 4,      ///< hal_real
+    LOG_MODULE_SOCKET = 5,   ///< socket_helper
+    LOG_MODULE_COUNT
+} log_module_t;
+
+// 模組等級設為此值時跟隨全域等級 (預設)
+#define LOG_LEVEL_INHERIT           (-1)
+
+typedef struct {
+    uint32_t sent;       ///< 已送到 syslogd 的筆數
+    uint32_t dropped;    ///< 無法送出 (syslogd 不在或佇列滿) 的筆數
+    uint32_t reconnects; ///< 重新連接 socket 的次數
+} logger_syslog_stats_t;
+
 // ========================================
 // 初始化與清理
 // ========================================
@@ -34,16 +178,57 @@ typedef enum {
  * @param level 初始日誌等級
  * @param target 日誌輸出目標
  * @return GAMING_OK 成功, GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_IO 無法開啟日誌檔案 (LOG_TARGET_FILE)
  */
 int logger_init(const char *ident, log_level_t level, log_target_t target);
 
 /**
  * @brief 清理日誌系統
  * 
- * 關閉 syslog 連接
+ * 停止非同步寫入執行緒 (先輸出佇列中的日誌),關閉 syslog 連接與日誌檔案
  */
 void logger_cleanup(void);
 
+// ========================================
+// 非同步模式
+// ========================================
+
+/**
+ * @brief 啟動非同步寫入執行緒
+ * 
+ * 必須在 logger_init() 之後呼叫
+ * 
+ * @param config 配置,NULL 則使用預設值 (LOGGER_DEFAULT_QUEUE_DEPTH, 丟棄)
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_INITIALIZED logger 未初始化
+ * @return GAMING_ERROR_ALREADY_EXISTS 已在非同步模式
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_NO_MEMORY 配置佇列失敗
+ * @return GAMING_ERROR 建立執行緒失敗
+ */
+int logger_async_start(const logger_async_config_t *config);
+
+/**
+ * @brief 停止非同步寫入執行緒,回到同步模式
+ * 
+ * 佇列中的日誌會先全部輸出
+ * 
+ * @note 呼叫時其他執行緒不應再寫日誌 (通常在程式結束前呼叫)
+ */
+void logger_async_stop(void);
+
+/**
+ * @brief 是否為非同步模式
+ */
+bool logger_is_async(void);
+
+/**
+ * @brief 取得非同步模式統計
+ * 
+ * @param stats 輸出統計
+ */
+void logger_get_async_stats(logger_async_stats_t *stats);
+
 // ========================================
 // 日誌等級控制
 // ========================================
@@ -68,6 +253,7 @@ log_level_t logger_get_level(void);
  * 
  * @param target 新的輸出目標
  * @return GAMING_OK 成功, GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_IO 無法開啟日誌檔案 (目標維持不變)
  */
 int logger_set_target(log_target_t target);
 
@@ -78,6 +264,60 @@ int logger_set_target(log_target_t target);
  */
 log_target_t logger_get_target(void);
 
+/**
+ * @brief 設定 syslog socket 路徑 (預設 LOGGER_SYSLOG_PATH)
+ * 
+ * 已輸出到 syslog 時會立即改連新路徑
+ * 
+ * @param path Unix datagram socket 路徑
+ * @return GAMING_OK 成功, GAMING_ERROR_INVALID_PARAM 參數錯誤或路徑太長
+ */
+int logger_set_syslog_path(const char *path);
+
+/**
+ * @brief 設定檔案輸出
+ * 
+ * 可在 logger_init() 之前呼叫;目前已輸出到檔案時會先寫出緩衝區,
+ * 再改用新的設定重新開啟
+ * 
+ * @param config 配置,NULL 則全部使用預設值
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤或路徑太長
+ * @return GAMING_ERROR_NO_MEMORY 配置緩衝區失敗
+ * @return GAMING_ERROR_IO 重新開啟檔案失敗
+ */
+int logger_set_file(const logger_file_config_t *config);
+
+/**
+ * @brief 設定結構化日誌的編碼格式 (預設 LOG_FORMAT_TEXT)
+ * 
+ * 只影響 logger_fields.h 的結構化日誌;一般 printf 式日誌不受影響。
+ * 輸出目標只有 console 時一律使用 LOG_FORMAT_TEXT,維持可讀性
+ * 
+ * @param format 編碼格式
+ * @return GAMING_OK 成功, GAMING_ERROR_INVALID_PARAM 參數錯誤
+ */
+int logger_set_format(log_format_t format);
+
+/**
+ * @brief 取得目前結構化日誌的編碼格式
+ */
+log_format_t logger_get_format(void);
+
+/**
+ * @brief 取得檔案輸出統計
+ * 
+ * @param stats 輸出統計
+ */
+void logger_get_file_stats(logger_file_stats_t *stats);
+
+/**
+ * @brief 取得 syslog 傳輸統計
+ * 
+ * @param stats 輸出統計
+ */
+void logger_get_syslog_stats(logger_syslog_stats_t *stats);
+
 /**
  * @brief 檢查是否應該輸出指定等級的日誌
  * 
@@ -90,6 +330,29 @@ bool logger_should_log(log_level_t level);
 // 日誌輸出函數
 // ========================================
 
+/**
+ * @brief 共用的日誌輸出實作,所有輸出函數與巨集最後都呼叫這裡
+ * 
+ * @param level 日誌等級 (低於目前等級時直接返回)
+ * @param fmt printf 格式字串
+ * @param args 可變參數
+ */
+void logger_vlog(log_level_t level, const char *fmt, va_list args)
+    __attribute__((format(printf, 2, 0)));
+
+/**
+ * @brief 追蹤掛勾: 每一筆日誌 (不論目前等級) 都會先以原始參數呼叫
+ */
+typedef void (*logger_trace_fn)(log_level_t level, const char *fmt, va_list args);
+
+/**
+ * @brief 設定追蹤掛勾 (例如 flight recorder),NULL 則移除
+ * 
+ * 設定後 DEBUG 等低等級的呼叫也會進入 logger_vlog(),
+ * 但仍只有達到目前等級的日誌會格式化輸出
+ */
+void logger_set_trace_hook(logger_trace_fn hook);
+
 /**
  * @brief 通用日誌輸出函數
  * 
@@ -136,6 +399,168 @@ void logger_info(const char *fmt, ...)
 void logger_debug(const char *fmt, ...) 
     __attribute__((format(printf, 1, 2)));
 
+// ========================================
+// 日誌輸出巨集
+// ========================================
+
+/*
+ * 與上方函數同名的巨集: 先在呼叫端檢查等級,未通過時參數完全不會被運算。
+ * 以 -DLOGGER_MIN_LEVEL=<等級> 編譯時,低於該等級的呼叫在編譯期就被移除,
+ * 例如 -DLOGGER_MIN_LEVEL=1 (LOG_LEVEL_INFO) 會移除所有 logger_debug()。
+ * 需要函數位址時使用 (logger_info) 這類加括號的寫法。
+ */
+
+// 編譯期最低等級 (預設全部保留)
+#ifndef LOGGER_MIN_LEVEL
+#define LOGGER_MIN_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+// 巨集內聯檢查的門檻: 一般為目前等級,未初始化時高於 LOG_LEVEL_ERROR,
+// 設定追蹤掛勾時為 LOG_LEVEL_DEBUG。請以 logger_set_level() 修改
+extern int logger_active_level;
+
+#define LOGGER_ENABLED(level) \
+    ((int)(level) >= (int)LOGGER_MIN_LEVEL && (int)(level) >= logger_active_level)
+
+#define LOGGER_EMIT(level, likely, ...) \
+    do { \
+        if ((int)(level) >= (int)LOGGER_MIN_LEVEL && \
+            __builtin_expect((int)(level) >= logger_active_level, likely)) { \
+            (logger_log)(level, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define logger_log(level, ...)  LOGGER_EMIT(level, 1, __VA_ARGS__)
+#define logger_error(...)       LOGGER_EMIT(LOG_LEVEL_ERROR, 1, __VA_ARGS__)
+#define logger_warning(...)     LOGGER_EMIT(LOG_LEVEL_WARN, 1, __VA_ARGS__)
+#define logger_info(...)        LOGGER_EMIT(LOG_LEVEL_INFO, 0, __VA_ARGS__)
+#define logger_debug(...)       LOGGER_EMIT(LOG_LEVEL_DEBUG, 0, __VA_ARGS__)
+
+// ========================================
+// 重複訊息限速
+// ========================================
+
+/**
+ * @brief 限速檢查 (token bucket)
+ * 
+ * 每秒補充 rate 筆,最多累積 burst 筆。允許輸出時回傳先前被抑制的筆數
+ * 並歸零,呼叫端可據此印出一行 "last message repeated N times"
+ * 
+ * @param rl 呼叫點的限速狀態
+ * @param rate 每秒補充的筆數 (> 0)
+ * @param burst 最多連續輸出的筆數 (> 0)
+ * @return >= 0 允許輸出 (值為先前被抑制的筆數), < 0 本筆應抑制
+ */
+int logger_ratelimit_check(logger_ratelimit_t *rl, unsigned int rate, unsigned int burst);
+
+// 呼叫點層級的限速請使用 logger_mod_ratelimited() (見下方模組日誌)
+
+// ========================================
+// 模組日誌
+// ========================================
+
+/**
+ * @brief 設定模組的日誌等級
+ * 
+ * @param module 模組
+ * @param level 日誌等級,或 LOG_LEVEL_INHERIT 跟隨全域等級
+ * @return GAMING_OK 成功, GAMING_ERROR_INVALID_PARAM 參數錯誤
+ */
+int logger_set_module_level(log_module_t module, int level);
+
+/**
+ * @brief 取得模組設定的日誌等級
+ * 
+ * @return 日誌等級,LOG_LEVEL_INHERIT 表示跟隨全域等級,模組錯誤時為 GAMING_ERROR_INVALID_PARAM
+ */
+int logger_get_module_level(log_module_t module);
+
+/**
+ * @brief 依設定字串一次設定多個模組等級
+ * 
+ * 格式為以空白或逗號分隔的 "模組=等級",例如 "gpio=debug socket=error"。
+ * 等級可為 error, warn, warning, info, debug 或 inherit;
+ * "*" 代表全部模組。有任何一項無法解析時不做任何變更
+ * 
+ * @param spec 設定字串,NULL 或空字串表示全部恢復為 inherit
+ * @return GAMING_OK 成功, GAMING_ERROR_INVALID_PARAM 格式錯誤
+ */
+int logger_apply_module_levels(const char *spec);
+
+/**
+ * @brief 安裝切換除錯輸出的訊號處理
+ * 
+ * 收到訊號時在「全部模組 DEBUG」與原本的設定之間切換,不需重新啟動。
+ * 處理函數只做原子寫入,可安全地在任何時間點觸發
+ * 
+ * @param signo 訊號編號 (例如 SIGUSR1)
+ * @return GAMING_OK 成功, GAMING_ERROR 安裝失敗
+ */
+int logger_install_debug_signal(int signo);
+
+/**
+ * @brief 是否處於訊號切換的全部 DEBUG 狀態
+ */
+bool logger_debug_override_active(void);
+
+/**
+ * @brief 模組的日誌輸出實作
+ * 
+ * logger 未初始化時 WARNING 以上仍以 "[模組] 訊息" 寫到 stderr,
+ * 函式庫在沒有 logger 的程式中使用時錯誤不會消失
+ */
+void logger_module_vlog(log_module_t module, log_level_t level, const char *fmt, va_list args)
+    __attribute__((format(printf, 3, 0)));
+
+void logger_module_log(log_module_t module, log_level_t level, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+/**
+ * @brief 輸出已組好的訊息 (不經過 printf 格式化,也不加模組標籤)
+ * 
+ * 等級檢查、追蹤掛勾與未初始化時的 stderr 後備都與 logger_module_vlog() 相同
+ * 
+ * @param msg 訊息 (超過 LOGGER_MSG_MAX - 1 會被截斷)
+ * @param len 訊息長度
+ */
+void logger_module_write(log_module_t module, log_level_t level, const char *msg, size_t len);
+
+// 各模組的內聯等級門檻 (包含未初始化時的 stderr 後備與追蹤掛勾)
+extern int logger_module_active_level[LOG_MODULE_COUNT];
+
+#define LOGGER_MODULE_ENABLED(module, level) \
+    ((int)(level) >= (int)LOGGER_MIN_LEVEL && \
+     (int)(level) >= logger_module_active_level[(module)])
+
+/*
+ * 模組日誌巨集,等級檢查與 logger_info() 等相同,未通過時參數不會被運算:
+ * 
+ *   logger_mod(LOG_MODULE_GPIO, LOG_LEVEL_ERROR, "Failed to init GPIO%d: %d", pin, ret);
+ *   logger_mod_ratelimited(LOG_MODULE_HAL, LOG_LEVEL_ERROR, "read GPIO %d failed", pin);
+ */
+#define logger_mod(module, level, ...) \
+    do { \
+        if (LOGGER_MODULE_ENABLED(module, level)) { \
+            (logger_module_log)(module, level, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define logger_mod_ratelimited(module, level, ...) \
+    do { \
+        static logger_ratelimit_t logger_rl_ = LOGGER_RATELIMIT_INIT; \
+        if (LOGGER_MODULE_ENABLED(module, level)) { \
+            int logger_rl_n_ = logger_ratelimit_check(&logger_rl_, LOGGER_RATELIMIT_RATE, \
+                                                      LOGGER_RATELIMIT_BURST); \
+            if (logger_rl_n_ > 0) { \
+                (logger_module_log)(module, level, "last message repeated %d times", \
+                                    logger_rl_n_); \
+            } \
+            if (logger_rl_n_ >= 0) { \
+                (logger_module_log)(module, level, __VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
 // ========================================
 // 輔助函數
 // ========================================
@@ -148,10 +573,31 @@ void logger_debug(const char *fmt, ...)
  */
 const char* logger_level_string(log_level_t level);
 
+/**
+ * @brief 由名稱取得日誌等級 (不分大小寫)
+ * 
+ * @param name "error", "warn", "warning", "info", "debug"
+ * @return 日誌等級, GAMING_ERROR_INVALID_PARAM 無法辨識
+ */
+int logger_level_from_name(const char *name);
+
+/**
+ * @brief 取得模組名稱 ("core", "gpio", "led", "adc", "hal", "socket")
+ */
+const char* logger_module_name(log_module_t module);
+
+/**
+ * @brief 由名稱取得模組
+ * 
+ * @return 模組, GAMING_ERROR_INVALID_PARAM 無法辨識
+ */
+int logger_module_from_name(const char *name);
+
 /**
  * @brief 刷新日誌緩衝區
  * 
- * 確保所有日誌都已寫入
+ * 確保所有日誌都已寫入。非同步模式下會等待寫入執行緒輸出
+ * 呼叫前已放入佇列的所有日誌;檔案輸出會寫出緩衝區 (不做 fdatasync)
  */
 void logger_flush(void);
 
@@ -0,0 +1,881 @@
+/**
+ * @file logger_binary.c
+ * @brief 二進位日誌實作
+ * @version 1.0.0
+ *
+ * 檔案格式 (整數皆為寫入端的位元組順序):
+ *   檔頭:     "GBL1" | u16 位元組順序標記 0x0102 | u16 保留
+ *   定義記錄: u8 1 | u16 id | u8 level | u32 line | u8 nargs | kinds[nargs]
+ *             | u16 fmt_len | fmt | u16 file_len | file
+ *   日誌記錄: u8 2 | u16 id | u32 sec | u16 msec | u16 len | payload[len]
+ *
+ * payload 依 kinds 順序排列: 'i' 4 位元組整數, 'I' 8 位元組整數,
+ * 'd' 8 位元組 double, 'p' 8 位元組指標, 's' u16 長度 + 字串內容,
+ * 'n' (%n) 不佔空間
+ */
+
+#define _GNU_SOURCE  // CLOCK_REALTIME_COARSE
+
+#include "logger_binary.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// ========================================
+// 檔案格式定義
+// ========================================
+
+#define BIN_MAGIC            "GBL1"
+#define BIN_MAGIC_LEN        4
+#define BIN_BYTE_ORDER_MARK  0x0102
+#define BIN_HEADER_LEN       8
+
+#define REC_SITE             1
+#define REC_LOG              2
+
+// 日誌記錄的固定部分: type + id + sec + msec + len
+#define REC_LOG_HEADER_LEN   11
+
+// 定義記錄中格式字串與檔名的長度上限
+#define SITE_FMT_MAX         1024
+#define SITE_FILE_MAX        128
+
+// 參數類型
+#define KIND_INT32           'i'
+#define KIND_INT64           'I'
+#define KIND_DOUBLE          'd'
+#define KIND_LONG_DOUBLE     'D'   // 只在記憶體中使用,檔案中記為 'd'
+#define KIND_POINTER         'p'
+#define KIND_STRING          's'
+#define KIND_NONE            'n'
+
+#ifdef CLOCK_REALTIME_COARSE
+#define LOGGER_BIN_CLOCK CLOCK_REALTIME_COARSE
+#else
+#define LOGGER_BIN_CLOCK CLOCK_REALTIME
+#endif
+
+// ========================================
+// 私有變數
+// ========================================
+
+static pthread_mutex_t bin_lock = PTHREAD_MUTEX_INITIALIZER;
+static int bin_fd = -1;
+static uint32_t bin_generation = 0;   // 每次開啟檔案加一,定義記錄需要重寫
+static uint16_t bin_next_id = 1;
+static uint8_t bin_buffer[LOGGER_BIN_BUFFER_SIZE];
+static size_t bin_used = 0;
+
+// ========================================
+// 格式字串解析 (寫入端與解碼端共用)
+// ========================================
+
+typedef struct {
+    char spec[32];      // 去掉長度修飾詞的轉換規格,例如 "%-8.3" (不含轉換字元)
+    size_t spec_len;
+    int width_star;     // 寬度為 '*'
+    int prec_star;      // 精度為 '*'
+    char conv;          // 轉換字元, 0 表示格式字串結束
+    size_t int_size;    // 整數參數的大小
+    int long_double;    // 'L' 修飾詞
+} format_spec_t;
+
+static void spec_append(format_spec_t *spec, const char *text, size_t len) {
+    if (spec->spec_len + len < sizeof(spec->spec)) {
+        memcpy(spec->spec + spec->spec_len, text, len);
+        spec->spec_len += len;
+        spec->spec[spec->spec_len] = '\0';
+    }
+}
+
+/**
+ * @brief 解析一個 '%' 之後的轉換規格
+ * @return 轉換規格之後的位置
+ */
+static const char* parse_spec(const char *p, format_spec_t *spec) {
+    size_t n;
+
+    memset(spec, 0, sizeof(*spec));
+    spec->int_size = sizeof(int);
+    spec_append(spec, "%", 1);
+
+    n = strspn(p, "-+ #0'");
+    spec_append(spec, p, n);
+    p += n;
+
+    if (*p == '*') {
+        spec->width_star = 1;
+        p++;
+    } else {
+        n = strspn(p, "0123456789");
+        spec_append(spec, p, n);
+        p += n;
+    }
+
+    if (*p == '.') {
+        spec_append(spec, ".", 1);
+        p++;
+        if (*p == '*') {
+            spec->prec_star = 1;
+            p++;
+        } else {
+            n = strspn(p, "0123456789");
+            spec_append(spec, p, n);
+            p += n;
+        }
+    }
+
+    switch (*p) {
+        case 'h':
+            p++;
+            if (*p == 'h') {
+                p++;
+            }
+            break;
+        case 'l':
+            p++;
+            spec->int_size = sizeof(long);
+            if (*p == 'l') {
+                p++;
+                spec->int_size = sizeof(long long);
+            }
+            break;
+        case 'z':
+            p++;
+            spec->int_size = sizeof(size_t);
+            break;
+        case 'j':
+            p++;
+            spec->int_size = sizeof(intmax_t);
+            break;
+        case 't':
+            p++;
+            spec->int_size = sizeof(ptrdiff_t);
+            break;
+        case 'L':
+            p++;
+            spec->long_double = 1;
+            break;
+        default:
+            break;
+    }
+
+    spec->conv = *p;
+    return (*p != '\0') ? p + 1 : p;
+}
+
+static char conversion_kind(const format_spec_t *spec) {
+    switch (spec->conv) {
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X': case 'c':
+            return (spec->int_size > 4) ? KIND_INT64 : KIND_INT32;
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+            return spec->long_double ? KIND_LONG_DOUBLE : KIND_DOUBLE;
+        case 's':
+            return KIND_STRING;
+        case 'p':
+            return KIND_POINTER;
+        case 'n':
+            return KIND_NONE;
+        default:
+            return 0;
+    }
+}
+
+// ========================================
+// 寫入端
+// ========================================
+
+/**
+ * @brief 解析格式字串中每個參數的類型
+ * @return 參數數量
+ */
+static int parse_kinds(const char *fmt, char *kinds) {
+    const char *p = fmt;
+    int nargs = 0;
+    format_spec_t spec;
+
+    while (*p != '\0') {
+        if (*p++ != '%') {
+            continue;
+        }
+        if (*p == '%') {
+            p++;
+            continue;
+        }
+
+        p = parse_spec(p, &spec);
+        if (spec.width_star && nargs < LOGGER_BIN_MAX_ARGS) {
+            kinds[nargs++] = KIND_INT32;
+        }
+        if (spec.prec_star && nargs < LOGGER_BIN_MAX_ARGS) {
+            kinds[nargs++] = KIND_INT32;
+        }
+        char kind = conversion_kind(&spec);
+        if (kind != 0 && nargs < LOGGER_BIN_MAX_ARGS) {
+            kinds[nargs++] = kind;
+        }
+    }
+
+    return nargs;
+}
+
+static void register_site(logger_bin_site_t *site) {
+    pthread_mutex_lock(&bin_lock);
+
+    if (site->id == 0 && bin_next_id != 0) {
+        site->nargs = (uint8_t)parse_kinds(site->fmt, site->kinds);
+        // 編號用完 (65535 個呼叫點) 後 bin_next_id 歸零,之後的呼叫點改走文字日誌
+        __atomic_store_n(&site->id, bin_next_id++, __ATOMIC_RELEASE);
+    }
+
+    pthread_mutex_unlock(&bin_lock);
+}
+
+static int flush_locked(void) {
+    size_t offset = 0;
+
+    while (offset < bin_used) {
+        ssize_t n = write(bin_fd, bin_buffer + offset, bin_used - offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            bin_used = 0;
+            return GAMING_ERROR_IO;
+        }
+        offset += (size_t)n;
+    }
+
+    bin_used = 0;
+    return GAMING_OK;
+}
+
+static void append_locked(const void *data, size_t len) {
+    if (bin_used + len > sizeof(bin_buffer)) {
+        flush_locked();
+    }
+    memcpy(bin_buffer + bin_used, data, len);
+    bin_used += len;
+}
+
+static void append_site_locked(logger_bin_site_t *site) {
+    uint8_t header[13];
+    uint32_t line = (uint32_t)site->line;
+    uint16_t fmt_len = (uint16_t)strnlen(site->fmt, SITE_FMT_MAX);
+    const char *file = strrchr(site->file, '/');
+    file = file ? file + 1 : site->file;
+    uint16_t file_len = (uint16_t)strnlen(file, SITE_FILE_MAX);
+    char kinds[LOGGER_BIN_MAX_ARGS];
+
+    header[0] = REC_SITE;
+    memcpy(header + 1, &site->id, 2);
+    header[3] = (uint8_t)site->level;
+    memcpy(header + 4, &line, 4);
+    header[8] = site->nargs;
+
+    for (int i = 0; i < site->nargs; i++) {
+        kinds[i] = (site->kinds[i] == KIND_LONG_DOUBLE) ? KIND_DOUBLE : site->kinds[i];
+    }
+
+    append_locked(header, 9);
+    append_locked(kinds, site->nargs);
+    append_locked(&fmt_len, 2);
+    append_locked(site->fmt, fmt_len);
+    append_locked(&file_len, 2);
+    append_locked(file, file_len);
+
+    site->generation = bin_generation;
+}
+
+/**
+ * @brief 依參數類型複製原始參數
+ * @param max payload 空間
+ * @return payload 長度
+ */
+static size_t pack_kinds(const char *kinds, int nargs, va_list args,
+                         uint8_t *payload, size_t max) {
+    size_t len = 0;
+
+    for (int i = 0; i < nargs; i++) {
+        // 固定長度參數放不下時,後面的參數解碼時顯示為 "?"
+        if (kinds[i] != KIND_STRING && kinds[i] != KIND_NONE && len + 8 > max) {
+            break;
+        }
+
+        switch (kinds[i]) {
+            case KIND_INT32: {
+                int32_t v = (int32_t)va_arg(args, int);
+                memcpy(payload + len, &v, 4);
+                len += 4;
+                break;
+            }
+            case KIND_INT64: {
+                int64_t v = (int64_t)va_arg(args, long long);
+                memcpy(payload + len, &v, 8);
+                len += 8;
+                break;
+            }
+            case KIND_DOUBLE: {
+                double v = va_arg(args, double);
+                memcpy(payload + len, &v, 8);
+                len += 8;
+                break;
+            }
+            case KIND_LONG_DOUBLE: {
+                double v = (double)va_arg(args, long double);
+                memcpy(payload + len, &v, 8);
+                len += 8;
+                break;
+            }
+            case KIND_POINTER: {
+                uint64_t v = (uint64_t)(uintptr_t)va_arg(args, void *);
+                memcpy(payload + len, &v, 8);
+                len += 8;
+                break;
+            }
+            case KIND_STRING: {
+                const char *s = va_arg(args, const char *);
+                if (s == NULL) {
+                    s = "(null)";
+                }
+                // 保留後續參數的空間 (每個最多 8 位元組或一個空字串)
+                size_t reserve = len + 2 + (size_t)(nargs - i - 1) * 8;
+                if (reserve > max) {
+                    return len;
+                }
+                size_t room = max - reserve;
+                uint16_t slen = (uint16_t)strnlen(s, room < LOGGER_BIN_MAX_STRING ?
+                                                     room : LOGGER_BIN_MAX_STRING);
+                memcpy(payload + len, &slen, 2);
+                memcpy(payload + len + 2, s, slen);
+                len += 2 + (size_t)slen;
+                break;
+            }
+            case KIND_NONE:
+            default:
+                (void)va_arg(args, void *);
+                break;
+        }
+    }
+
+    return len;
+}
+
+// ========================================
+// 寫入端公開函數
+// ========================================
+
+int logger_bin_open(const char *path) {
+    if (path == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Logger binary: Failed to open %s: %s\n", path, strerror(errno));
+        return GAMING_ERROR_IO;
+    }
+
+    uint8_t header[BIN_HEADER_LEN] = {0};
+    uint16_t mark = BIN_BYTE_ORDER_MARK;
+    memcpy(header, BIN_MAGIC, BIN_MAGIC_LEN);
+    memcpy(header + BIN_MAGIC_LEN, &mark, 2);
+
+    if (write(fd, header, sizeof(header)) != (ssize_t)sizeof(header)) {
+        fprintf(stderr, "Logger binary: Failed to write header to %s\n", path);
+        close(fd);
+        return GAMING_ERROR_IO;
+    }
+
+    logger_bin_close();
+
+    pthread_mutex_lock(&bin_lock);
+    bin_used = 0;
+    bin_generation++;
+    __atomic_store_n(&bin_fd, fd, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&bin_lock);
+
+    return GAMING_OK;
+}
+
+void logger_bin_close(void) {
+    pthread_mutex_lock(&bin_lock);
+    if (bin_fd >= 0) {
+        flush_locked();
+        close(bin_fd);
+        __atomic_store_n(&bin_fd, -1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&bin_lock);
+}
+
+int logger_bin_flush(void) {
+    int ret = GAMING_OK;
+
+    pthread_mutex_lock(&bin_lock);
+    if (bin_fd >= 0) {
+        ret = flush_locked();
+    }
+    pthread_mutex_unlock(&bin_lock);
+
+    return ret;
+}
+
+bool logger_bin_is_open(void) {
+    return __atomic_load_n(&bin_fd, __ATOMIC_ACQUIRE) >= 0;
+}
+
+void logger_bin_write(logger_bin_site_t *site, const char *fmt, ...) {
+    va_list args;
+
+    if (__atomic_load_n(&site->id, __ATOMIC_ACQUIRE) == 0 && logger_bin_is_open()) {
+        register_site(site);
+    }
+
+    // 未開啟檔案或呼叫點編號已用完: 改走文字日誌
+    if (!logger_bin_is_open() || __atomic_load_n(&site->id, __ATOMIC_ACQUIRE) == 0) {
+        va_start(args, fmt);
+        logger_vlog(site->level, fmt, args);
+        va_end(args);
+        return;
+    }
+
+    uint8_t record[REC_LOG_HEADER_LEN + LOGGER_BIN_MAX_PAYLOAD];
+    struct timespec ts;
+    clock_gettime(LOGGER_BIN_CLOCK, &ts);
+
+    va_start(args, fmt);
+    uint16_t len = (uint16_t)pack_kinds(site->kinds, site->nargs, args,
+                                        record + REC_LOG_HEADER_LEN, LOGGER_BIN_MAX_PAYLOAD);
+    va_end(args);
+
+    uint32_t sec = (uint32_t)ts.tv_sec;
+    uint16_t msec = (uint16_t)(ts.tv_nsec / 1000000L);
+    record[0] = REC_LOG;
+    memcpy(record + 1, &site->id, 2);
+    memcpy(record + 3, &sec, 4);
+    memcpy(record + 7, &msec, 2);
+    memcpy(record + 9, &len, 2);
+
+    pthread_mutex_lock(&bin_lock);
+    if (bin_fd >= 0) {
+        if (site->generation != bin_generation) {
+            append_site_locked(site);
+        }
+        append_locked(record, REC_LOG_HEADER_LEN + (size_t)len);
+
+        // ERROR 立即寫入,當機前的最後一筆不會留在緩衝區
+        if (site->level >= LOG_LEVEL_ERROR) {
+            flush_locked();
+        }
+    }
+    pthread_mutex_unlock(&bin_lock);
+}
+
+// ========================================
+// 解碼端
+// ========================================
+
+typedef struct {
+    int defined;
+    uint8_t level;
+    uint8_t nargs;
+    char kinds[LOGGER_BIN_MAX_ARGS];
+    char fmt[SITE_FMT_MAX + 1];
+} decoded_site_t;
+
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    size_t pos;
+    int swap;
+} payload_reader_t;
+
+static uint16_t swap16(uint16_t v) {
+    return (uint16_t)((v >> 8) | (v << 8));
+}
+
+static uint32_t swap32(uint32_t v) {
+    return ((v >> 24) & 0xff) | ((v >> 8) & 0xff00) |
+           ((v << 8) & 0xff0000) | (v << 24);
+}
+
+static uint64_t swap64(uint64_t v) {
+    return ((uint64_t)swap32((uint32_t)v) << 32) | swap32((uint32_t)(v >> 32));
+}
+
+static uint16_t load16(const uint8_t *p, int swap) {
+    uint16_t v;
+    memcpy(&v, p, 2);
+    return swap ? swap16(v) : v;
+}
+
+static uint32_t load32(const uint8_t *p, int swap) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return swap ? swap32(v) : v;
+}
+
+static uint64_t load64(const uint8_t *p, int swap) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return swap ? swap64(v) : v;
+}
+
+static int read_exact(FILE *in, void *buf, size_t len) {
+    return (len == 0 || fread(buf, 1, len, in) == len) ? 0 : -1;
+}
+
+static void out_append(char *out, size_t size, size_t *used, const char *text, size_t len) {
+    if (*used + len >= size) {
+        len = size - *used - 1;
+    }
+    memcpy(out + *used, text, len);
+    *used += len;
+    out[*used] = '\0';
+}
+
+static int next_int32(payload_reader_t *r, int32_t *v) {
+    if (r->pos + 4 > r->len) {
+        return -1;
+    }
+    *v = (int32_t)load32(r->data + r->pos, r->swap);
+    r->pos += 4;
+    return 0;
+}
+
+/**
+ * @brief 以一個轉換規格格式化一個參數
+ */
+static void format_argument(const format_spec_t *spec, char kind, payload_reader_t *r,
+                            int width, int prec, char *text, size_t size) {
+    char fmt[80];
+    char star[24] = "";
+    size_t n = strlen(spec->spec);
+
+    // '*' 的值直接寫入規格字串
+    memcpy(fmt, spec->spec, n + 1);
+    if (spec->width_star) {
+        size_t flags = strspn(fmt + 1, "-+ #0'") + 1;
+        snprintf(star, sizeof(star), "%d", width);
+        memmove(fmt + flags + strlen(star), fmt + flags, n - flags + 1);
+        memcpy(fmt + flags, star, strlen(star));
+        n = strlen(fmt);
+    }
+    if (spec->prec_star) {
+        snprintf(fmt + n, sizeof(fmt) - n, "%d", prec);
+        n = strlen(fmt);
+    }
+
+    text[0] = '\0';
+    switch (kind) {
+        case KIND_INT32: {
+            int32_t v;
+            if (next_int32(r, &v) == 0) {
+                snprintf(fmt + n, sizeof(fmt) - n, "%c", spec->conv);
+                snprintf(text, size, fmt, (int)v);
+            }
+            break;
+        }
+        case KIND_INT64:
+            if (r->pos + 8 <= r->len) {
+                long long v = (long long)load64(r->data + r->pos, r->swap);
+                r->pos += 8;
+                snprintf(fmt + n, sizeof(fmt) - n, "ll%c", spec->conv);
+                snprintf(text, size, fmt, v);
+            }
+            break;
+        case KIND_DOUBLE:
+            if (r->pos + 8 <= r->len) {
+                uint64_t bits = load64(r->data + r->pos, r->swap);
+                double v;
+                memcpy(&v, &bits, 8);
+                r->pos += 8;
+                snprintf(fmt + n, sizeof(fmt) - n, "%c", spec->conv);
+                snprintf(text, size, fmt, v);
+            }
+            break;
+        case KIND_POINTER:
+            if (r->pos + 8 <= r->len) {
+                unsigned long long v = (unsigned long long)load64(r->data + r->pos, r->swap);
+                r->pos += 8;
+                snprintf(text, size, "0x%llx", v);
+            }
+            break;
+        case KIND_STRING:
+            if (r->pos + 2 <= r->len) {
+                uint16_t slen = load16(r->data + r->pos, r->swap);
+                if (r->pos + 2 + slen <= r->len) {
+                    char str[LOGGER_BIN_MAX_PAYLOAD + 1];
+                    memcpy(str, r->data + r->pos + 2, slen);
+                    str[slen] = '\0';
+                    r->pos += 2 + (size_t)slen;
+                    snprintf(fmt + n, sizeof(fmt) - n, "s");
+                    snprintf(text, size, fmt, str);
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief 略過一個參數 (類型與格式字串不符時,維持之後參數的位置)
+ */
+static void skip_argument(char kind, payload_reader_t *r) {
+    size_t n = 0;
+
+    switch (kind) {
+        case KIND_INT32:
+            n = 4;
+            break;
+        case KIND_INT64:
+        case KIND_DOUBLE:
+        case KIND_POINTER:
+            n = 8;
+            break;
+        case KIND_STRING:
+            if (r->pos + 2 <= r->len) {
+                n = 2 + (size_t)load16(r->data + r->pos, r->swap);
+            }
+            break;
+        default:
+            break;
+    }
+    r->pos = (r->pos + n <= r->len) ? r->pos + n : r->len;
+}
+
+/**
+ * @brief 依定義記錄的格式字串還原訊息
+ *
+ * kinds 來自檔案或記憶體快照,可能已損毀: 每個參數的類型必須與
+ * 格式字串的轉換一致才格式化,否則輸出 "?";%n 一律不格式化
+ */
+static void format_message(const char *fmt, const char *kinds, int nargs,
+                           payload_reader_t *r, char *out, size_t size) {
+    const char *p = fmt;
+    size_t used = 0;
+    int arg = 0;
+    format_spec_t spec;
+    char text[LOGGER_BIN_MAX_PAYLOAD + 64];
+
+    out[0] = '\0';
+    while (*p != '\0') {
+        const char *percent = strchr(p, '%');
+        if (percent == NULL) {
+            out_append(out, size, &used, p, strlen(p));
+            break;
+        }
+
+        out_append(out, size, &used, p, (size_t)(percent - p));
+        p = percent + 1;
+        if (*p == '%') {
+            out_append(out, size, &used, "%", 1);
+            p++;
+            continue;
+        }
+
+        p = parse_spec(p, &spec);
+        int32_t width = 0;
+        int32_t prec = 0;
+        if (spec.width_star && arg < nargs) {
+            arg++;
+            next_int32(r, &width);
+        }
+        if (spec.prec_star && arg < nargs) {
+            arg++;
+            next_int32(r, &prec);
+        }
+
+        char expected = conversion_kind(&spec);
+        if (expected == 0) {
+            continue;
+        }
+        if (expected == KIND_LONG_DOUBLE) {
+            expected = KIND_DOUBLE;
+        }
+        if (arg >= nargs) {
+            out_append(out, size, &used, "?", 1);
+            continue;
+        }
+
+        char kind = kinds[arg++];
+        if (kind == KIND_NONE && expected == KIND_NONE) {
+            continue;
+        }
+        if (kind != expected) {
+            skip_argument(kind, r);
+            out_append(out, size, &used, "?", 1);
+            continue;
+        }
+        format_argument(&spec, kind, r, width, prec, text, sizeof(text));
+        out_append(out, size, &used, text, strlen(text));
+    }
+}
+
+static int decode_site(FILE *in, int swap, decoded_site_t *sites) {
+    uint8_t header[8];
+    uint8_t len_buf[2];
+
+    if (read_exact(in, header, 8) != 0) {
+        return -1;
+    }
+
+    uint16_t id = load16(header, swap);
+    decoded_site_t *site = &sites[id];
+    site->level = header[2];
+    site->nargs = header[7];
+    if (site->nargs > LOGGER_BIN_MAX_ARGS ||
+        read_exact(in, site->kinds, site->nargs) != 0 ||
+        read_exact(in, len_buf, 2) != 0) {
+        return -1;
+    }
+
+    uint16_t fmt_len = load16(len_buf, swap);
+    if (fmt_len > SITE_FMT_MAX || read_exact(in, site->fmt, fmt_len) != 0) {
+        return -1;
+    }
+    site->fmt[fmt_len] = '\0';
+
+    // 不採用檔案記錄的參數類型,由格式字串重新推導 (與寫入端相同的規則)
+    site->nargs = (uint8_t)parse_kinds(site->fmt, site->kinds);
+    for (int i = 0; i < site->nargs; i++) {
+        if (site->kinds[i] == KIND_LONG_DOUBLE) {
+            site->kinds[i] = KIND_DOUBLE;
+        }
+    }
+
+    // 原始檔名目前只用於除錯,解碼時略過
+    char file[SITE_FILE_MAX];
+    if (read_exact(in, len_buf, 2) != 0) {
+        return -1;
+    }
+    uint16_t file_len = load16(len_buf, swap);
+    if (file_len > SITE_FILE_MAX || read_exact(in, file, file_len) != 0) {
+        return -1;
+    }
+
+    site->defined = 1;
+    return 0;
+}
+
+int logger_bin_decode(FILE *in, FILE *out) {
+    if (in == NULL || out == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint8_t header[BIN_HEADER_LEN];
+    if (read_exact(in, header, sizeof(header)) != 0 ||
+        memcmp(header, BIN_MAGIC, BIN_MAGIC_LEN) != 0) {
+        return GAMING_ERROR_IO;
+    }
+
+    uint16_t mark;
+    memcpy(&mark, header + BIN_MAGIC_LEN, 2);
+    int swap;
+    if (mark == BIN_BYTE_ORDER_MARK) {
+        swap = 0;
+    } else if (mark == swap16(BIN_BYTE_ORDER_MARK)) {
+        swap = 1;
+    } else {
+        return GAMING_ERROR_IO;
+    }
+
+    // id 為 u16,直接以 id 為索引
+    decoded_site_t *sites = calloc(65536, sizeof(decoded_site_t));
+    if (sites == NULL) {
+        return GAMING_ERROR_NO_MEMORY;
+    }
+
+    int count = 0;
+    int result = 0;
+    uint8_t type;
+    uint8_t rec[REC_LOG_HEADER_LEN - 1];
+    uint8_t payload[LOGGER_BIN_MAX_PAYLOAD];
+    char msg[LOGGER_MSG_MAX * 4];
+
+    // 結尾不完整的記錄 (例如寫到一半當機) 直接結束
+    while (result == 0 && read_exact(in, &type, 1) == 0) {
+        if (type == REC_SITE) {
+            if (decode_site(in, swap, sites) != 0) {
+                break;
+            }
+            continue;
+        }
+        if (type != REC_LOG) {
+            result = GAMING_ERROR_IO;
+            break;
+        }
+
+        if (read_exact(in, rec, sizeof(rec)) != 0) {
+            break;
+        }
+        uint16_t id = load16(rec, swap);
+        time_t sec = (time_t)load32(rec + 2, swap);
+        uint16_t msec = load16(rec + 6, swap);
+        uint16_t len = load16(rec + 8, swap);
+        if (len > sizeof(payload)) {
+            result = GAMING_ERROR_IO;
+            break;
+        }
+        if (read_exact(in, payload, len) != 0) {
+            break;
+        }
+
+        char timestamp[32];
+        struct tm tm_info;
+        localtime_r(&sec, &tm_info);
+        strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &tm_info);
+
+        const decoded_site_t *site = &sites[id];
+        if (!site->defined) {
+            fprintf(out, "[%s.%03u] [UNKNOWN] <undefined site %u>\n",
+                    timestamp, (unsigned)msec, (unsigned)id);
+        } else {
+            payload_reader_t reader = { payload, len, 0, swap };
+            format_message(site->fmt, site->kinds, site->nargs, &reader, msg, sizeof(msg));
+            fprintf(out, "[%s.%03u] [%s] %s\n", timestamp, (unsigned)msec,
+                    logger_level_string((log_level_t)site->level), msg);
+        }
+        count++;
+    }
+
+    free(sites);
+    return (result != 0) ? result : count;
+}
+
+// ========================================
+// 共用編碼函數
+// ========================================
+
+size_t logger_bin_pack(const char *fmt, va_list args, char *kinds, uint8_t *nargs,
+                       uint8_t *payload, size_t size) {
+    int count = parse_kinds(fmt, kinds);
+    size_t len = pack_kinds(kinds, count, args, payload, size);
+
+    // long double 已轉為 double 儲存
+    for (int i = 0; i < count; i++) {
+        if (kinds[i] == KIND_LONG_DOUBLE) {
+            kinds[i] = KIND_DOUBLE;
+        }
+    }
+
+    *nargs = (uint8_t)count;
+    return len;
+}
+
+void logger_bin_format(const char *fmt, const char *kinds, int nargs,
+                       const uint8_t *payload, size_t len, char *out, size_t size) {
+    payload_reader_t reader = { payload, len, 0, 0 };
+
+    if (size == 0) {
+        return;
+    }
+    format_message(fmt, kinds, nargs, &reader, out, size);
+}
@@ -0,0 +1,160 @@
+/**
+ * @file logger_binary.h
+ * @brief 二進位日誌 - 延後格式化,離線解碼
+ * @version 1.0.0
+ *
+ * 呼叫端不做 printf 格式化,只記錄呼叫點編號、時間戳記與原始參數位元組,
+ * 文字在事後由 gaming-logdecode (或 logger_bin_decode) 還原。
+ *
+ * - 每個呼叫點是一個 static 描述子,第一次呼叫時登記並解析格式字串,
+ *   之後每筆日誌只複製參數
+ * - 格式字串與呼叫位置只在檔案中出現一次 (定義記錄),每筆日誌只存編號,
+ *   檔案比文字日誌小很多,適合空間有限的 /tmp
+ * - 檔案以寫入端的位元組順序儲存並在檔頭標記,big-endian 路由器產生的
+ *   檔案可在 little-endian 主機上解碼
+ * - 未開啟二進位檔案時,自動改走一般的文字日誌
+ *
+ * 用法:
+ *   logger_bin_open("/tmp/gaming.blog");
+ *   LOGGER_BIN(LOG_LEVEL_DEBUG, "rssi=%d ch=%u name=%s", rssi, ch, name);
+ *   logger_bin_close();
+ */
+
+#ifndef LOGGER_BINARY_H
+#define LOGGER_BINARY_H
+
+#include "gaming_common.h"
+#include "logger.h"
+#include <stdio.h>
+
+// ========================================
+// 二進位日誌配置
+// ========================================
+
+// 每個呼叫點最多記錄的參數數量 (含 '*' 寬度/精度)
+#define LOGGER_BIN_MAX_ARGS      16
+
+// 字串參數最多記錄的位元組數
+#define LOGGER_BIN_MAX_STRING    128
+
+// 單筆記錄的參數資料上限
+#define LOGGER_BIN_MAX_PAYLOAD   512
+
+// 寫入緩衝區大小 (滿了或遇到 ERROR 才寫入檔案)
+#define LOGGER_BIN_BUFFER_SIZE   4096
+
+/**
+ * @brief 呼叫點描述子 (由 LOGGER_BIN 巨集以 static 變數產生)
+ */
+typedef struct {
+    const char *fmt;                        ///< 格式字串
+    const char *file;                       ///< 原始檔
+    int line;                               ///< 行號
+    log_level_t level;                      ///< 日誌等級
+    uint16_t id;                            ///< 登記後的編號,0 表示尚未登記
+    uint8_t nargs;                          ///< 參數數量
+    char kinds[LOGGER_BIN_MAX_ARGS];        ///< 每個參數的類型
+    uint32_t generation;                    ///< 已寫入定義的檔案代號
+} logger_bin_site_t;
+
+// 取出 __VA_ARGS__ 的第一個參數 (格式字串)
+#define LOGGER_BIN_FMT_(fmt, ...) fmt
+
+/**
+ * @brief 記錄一筆二進位日誌
+ *
+ * 格式字串必須是字串常值。等級檢查與 logger.h 的巨集相同,
+ * 未通過時參數不會被運算
+ */
+#define LOGGER_BIN(level, ...) \
+    do { \
+        static logger_bin_site_t logger_bin_site_ = { \
+            LOGGER_BIN_FMT_(__VA_ARGS__, 0), __FILE__, __LINE__, level, 0, 0, {0}, 0 \
+        }; \
+        if (LOGGER_ENABLED(level)) { \
+            logger_bin_write(&logger_bin_site_, __VA_ARGS__); \
+        } \
+    } while (0)
+
+// ========================================
+// Logger Binary 公開函數
+// ========================================
+
+/**
+ * @brief 開啟二進位日誌檔案 (覆寫既有內容)
+ *
+ * 已開啟的檔案會先關閉
+ *
+ * @param path 檔案路徑
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_IO 開啟或寫入檔頭失敗
+ */
+int logger_bin_open(const char *path);
+
+/**
+ * @brief 寫出緩衝區並關閉檔案
+ */
+void logger_bin_close(void);
+
+/**
+ * @brief 將緩衝區寫入檔案
+ *
+ * @return GAMING_OK 成功, GAMING_ERROR_IO 寫入失敗
+ */
+int logger_bin_flush(void);
+
+/**
+ * @brief 是否已開啟二進位日誌檔案
+ */
+bool logger_bin_is_open(void);
+
+/**
+ * @brief 記錄一筆日誌 (供 LOGGER_BIN 巨集使用)
+ *
+ * 未開啟檔案時改以 logger_vlog() 輸出文字
+ */
+void logger_bin_write(logger_bin_site_t *site, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief 將二進位日誌解碼為文字
+ *
+ * 輸出格式與 console 相同: "[YYYY-mm-dd HH:MM:SS.mmm] [LEVEL] 訊息"
+ *
+ * @param in 二進位日誌
+ * @param out 文字輸出
+ * @return >= 0 解碼的日誌筆數
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_IO 檔頭錯誤或內容損毀
+ */
+int logger_bin_decode(FILE *in, FILE *out);
+
+// ========================================
+// 共用編碼函數 (flight recorder 等模組使用)
+// ========================================
+
+/**
+ * @brief 解析格式字串並複製原始參數 (不做格式化)
+ *
+ * @param fmt 格式字串
+ * @param args 可變參數
+ * @param kinds 輸出參數類型,至少 LOGGER_BIN_MAX_ARGS 個
+ * @param nargs 輸出參數數量
+ * @param payload 輸出參數資料
+ * @param size payload 空間 (字串會被截斷以放入)
+ * @return payload 長度
+ */
+size_t logger_bin_pack(const char *fmt, va_list args, char *kinds, uint8_t *nargs,
+                       uint8_t *payload, size_t size);
+
+/**
+ * @brief 以 logger_bin_pack() 的結果還原訊息文字 (同一台機器的位元組順序)
+ *
+ * @param out 輸出字串 (一定以 '\0' 結尾)
+ * @param size 輸出空間
+ */
+void logger_bin_format(const char *fmt, const char *kinds, int nargs,
+                       const uint8_t *payload, size_t len, char *out, size_t size);
+
+#endif // LOGGER_BINARY_H
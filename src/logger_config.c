@@ -0,0 +1,137 @@
+/**
+ * @file logger_config.c
+ * @brief Logger UCI 設定載入實作
+ * @version 1.0.0
+ */
+
+#include "logger_config.h"
+#include "logger.h"
+#include "config_parser.h"
+#include <stdlib.h>
+#include <string.h>
+
+static int target_from_name(const char *name) {
+    if (strcmp(name, "syslog") == 0) {
+        return LOG_TARGET_SYSLOG;
+    } else if (strcmp(name, "console") == 0) {
+        return LOG_TARGET_CONSOLE;
+    } else if (strcmp(name, "both") == 0) {
+        return LOG_TARGET_BOTH;
+    } else if (strcmp(name, "file") == 0) {
+        return LOG_TARGET_FILE;
+    }
+    return -1;
+}
+
+static int format_from_name(const char *name) {
+    if (strcmp(name, "text") == 0) {
+        return LOG_FORMAT_TEXT;
+    } else if (strcmp(name, "logfmt") == 0) {
+        return LOG_FORMAT_LOGFMT;
+    } else if (strcmp(name, "json") == 0) {
+        return LOG_FORMAT_JSON;
+    }
+    return -1;
+}
+
+/**
+ * @brief 套用 log_file / log_file_size (size 單位為 KB)
+ */
+static int apply_file_config(void) {
+    char path[LOGGER_MSG_MAX];
+    char value[32];
+    logger_file_config_t config = { 0 };
+
+    if (config_parser_get_string(UCI_CONFIG_GAMING, UCI_SECTION_CORE, UCI_OPTION_LOG_FILE,
+                                 path, sizeof(path)) == GAMING_OK && path[0] != '\0') {
+        config.path = path;
+    }
+
+    if (config_parser_get_string(UCI_CONFIG_GAMING, UCI_SECTION_CORE, UCI_OPTION_LOG_FILE_SIZE,
+                                 value, sizeof(value)) == GAMING_OK) {
+        char *end = NULL;
+        unsigned long kb = strtoul(value, &end, 10);
+        if (end == value || *end != '\0' || kb == 0) {
+            logger_warning("Ignoring invalid %s '%s'", UCI_OPTION_LOG_FILE_SIZE, value);
+            return GAMING_ERROR_INVALID_PARAM;
+        }
+        config.max_size = (size_t)kb * 1024;
+    }
+
+    int ret = logger_set_file(&config);
+    if (ret == GAMING_ERROR_INVALID_PARAM) {
+        logger_warning("Ignoring invalid %s '%s'", UCI_OPTION_LOG_FILE,
+                       config.path ? config.path : "");
+    }
+    return ret;
+}
+
+int logger_config_reload(void) {
+    char value[LOGGER_MSG_MAX];
+    int result = GAMING_OK;
+
+    int ret = config_parser_init();
+    if (ret != GAMING_OK) {
+        return ret;
+    }
+
+    // 之後的 UCI 變更由 config_parser_reload() 一併套用 (重複註冊不會新增)
+    config_parser_add_reload_hook(logger_config_reload);
+
+    // 全域等級: 未設定時保留目前值
+    if (config_parser_get_string(UCI_CONFIG_GAMING, UCI_SECTION_CORE, UCI_OPTION_LOG_LEVEL,
+                                 value, sizeof(value)) == GAMING_OK) {
+        int level = logger_level_from_name(value);
+        if (level >= 0) {
+            logger_set_level((log_level_t)level);
+        } else {
+            logger_warning("Ignoring invalid %s '%s'", UCI_OPTION_LOG_LEVEL, value);
+            result = GAMING_ERROR_INVALID_PARAM;
+        }
+    }
+
+    // 模組等級: 未設定時全部跟隨全域等級
+    if (config_parser_get_string(UCI_CONFIG_GAMING, UCI_SECTION_CORE, UCI_OPTION_LOG_MODULES,
+                                 value, sizeof(value)) != GAMING_OK) {
+        value[0] = '\0';
+    }
+    if (logger_apply_module_levels(value) != GAMING_OK) {
+        logger_warning("Ignoring invalid %s '%s'", UCI_OPTION_LOG_MODULES, value);
+        result = GAMING_ERROR_INVALID_PARAM;
+    }
+
+    // 結構化日誌格式: 未設定時保留目前值
+    if (config_parser_get_string(UCI_CONFIG_GAMING, UCI_SECTION_CORE, UCI_OPTION_LOG_FORMAT,
+                                 value, sizeof(value)) == GAMING_OK) {
+        int format = format_from_name(value);
+        if (format >= 0) {
+            logger_set_format((log_format_t)format);
+        } else {
+            logger_warning("Ignoring invalid %s '%s'", UCI_OPTION_LOG_FORMAT, value);
+            result = GAMING_ERROR_INVALID_PARAM;
+        }
+    }
+
+    // 檔案設定需在切換目標前套用
+    ret = apply_file_config();
+    if (ret != GAMING_OK) {
+        result = ret;
+    }
+
+    // 輸出目標: 未設定時保留目前值
+    if (config_parser_get_string(UCI_CONFIG_GAMING, UCI_SECTION_CORE, UCI_OPTION_LOG_TARGET,
+                                 value, sizeof(value)) == GAMING_OK) {
+        int target = target_from_name(value);
+        if (target < 0) {
+            logger_warning("Ignoring invalid %s '%s'", UCI_OPTION_LOG_TARGET, value);
+            result = GAMING_ERROR_INVALID_PARAM;
+        } else {
+            ret = logger_set_target((log_target_t)target);
+            if (ret != GAMING_OK) {
+                result = ret;
+            }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file logger_config.h
+ * @brief Logger UCI 設定載入
+ * @version 1.0.0
+ * 
+ * 從 gaming.core 讀取日誌等級與輸出目標並套用到 logger,
+ * 供程式啟動與 reload (SIGHUP / reload_service) 時呼叫,不需重新啟動:
+ * 
+ *   config gaming 'core'
+ *       option log_level 'info'
+ *       option log_modules 'gpio=debug socket=error'
+ *       option log_target 'file'
+ *       option log_file '/tmp/gaming.log'
+ *       option log_file_size '512'
+ *       option log_format 'json'
+ */
+
+#ifndef LOGGER_CONFIG_H
+#define LOGGER_CONFIG_H
+
+#include "gaming_common.h"
+
+/**
+ * @brief 由 UCI 重新載入日誌等級
+ * 
+ * log_level / log_target / log_format 未設定時保留目前的設定;log_modules 未設定時
+ * 全部模組恢復跟隨全域等級;log_file / log_file_size 未設定時使用預設值。
+ * 設定值無法解析時保留原本的設定。第一次呼叫後會註冊到 config_parser_reload(),
+ * 之後與其他模組 (例如 LED 顏色表) 一起隨設定變更重新載入
+ * 
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 設定值格式錯誤 (已輸出警告)
+ * @return GAMING_ERROR_IO 日誌檔案無法開啟 (維持原本的輸出目標)
+ * @return 其他 config_parser_init() 的錯誤碼
+ */
+int logger_config_reload(void);
+
+#endif // LOGGER_CONFIG_H
@@ -0,0 +1,376 @@
+/**
+ * @file logger_fields.c
+ * @brief 結構化日誌實作
+ * @version 1.0.0
+ *
+ * 編碼以「項目」為單位 (訊息或一個欄位): 寫入前記下位置,
+ * 放不下時退回該位置並停止,輸出中不會出現半個欄位
+ */
+
+#include "logger_fields.h"
+#include <stdbool.h>
+#include <string.h>
+
+// ========================================
+// 內部資料
+// ========================================
+
+typedef struct {
+    char *p;
+    char *end;    ///< 可寫入的上限 (已扣除結尾保留的空間)
+    bool full;
+} kv_writer_t;
+
+static const char *const level_names[] = { "debug", "info", "warn", "error" };
+
+static const char *const error_names[] = {
+    "ok", "error", "invalid_param", "not_initialized", "hal_failed",
+    "timeout", "not_found", "already_exists", "no_memory", "io"
+};
+
+static __thread char tls_kv_buffer[LOGGER_MSG_MAX];
+
+// ========================================
+// 基本寫入函數
+// ========================================
+
+static void put_mem(kv_writer_t *w, const char *s, size_t n) {
+    if (w->full || (size_t)(w->end - w->p) < n) {
+        w->full = true;
+        return;
+    }
+    memcpy(w->p, s, n);
+    w->p += n;
+}
+
+static void put_char(kv_writer_t *w, char c) {
+    if (w->full || w->p >= w->end) {
+        w->full = true;
+        return;
+    }
+    *w->p++ = c;
+}
+
+static void put_str(kv_writer_t *w, const char *s) {
+    put_mem(w, s, strlen(s));
+}
+
+static void put_uint(kv_writer_t *w, uint64_t v) {
+    char digits[20];
+    size_t n = 0;
+
+    do {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+
+    if (w->full || (size_t)(w->end - w->p) < n) {
+        w->full = true;
+        return;
+    }
+    while (n > 0) {
+        *w->p++ = digits[--n];
+    }
+}
+
+static void put_int(kv_writer_t *w, int64_t v) {
+    if (v < 0) {
+        put_char(w, '-');
+        put_uint(w, (uint64_t)0 - (uint64_t)v);
+    } else {
+        put_uint(w, (uint64_t)v);
+    }
+}
+
+/**
+ * @brief 以 us / ms / s 顯示時間長度,小數固定 3 位
+ */
+static void put_duration(kv_writer_t *w, uint64_t us) {
+    static const char *const units[] = { "ms", "s" };
+    uint64_t div = 1000;
+    int unit = 0;
+
+    if (us < 1000) {
+        put_uint(w, us);
+        put_mem(w, "us", 2);
+        return;
+    }
+    if (us >= 1000000) {
+        div = 1000000;
+        unit = 1;
+    }
+
+    uint64_t frac = (us % div) * 1000 / div;
+    put_uint(w, us / div);
+    put_char(w, '.');
+    put_char(w, (char)('0' + frac / 100));
+    put_char(w, (char)('0' + frac / 10 % 10));
+    put_char(w, (char)('0' + frac % 10));
+    put_str(w, units[unit]);
+}
+
+static const char hex_digits[] = "0123456789abcdef";
+
+/**
+ * @brief 需要跳脫的字元: " \ 與控制字元
+ */
+static bool is_special(unsigned char c) {
+    return c < 0x20 || c == '"' || c == '\\';
+}
+
+/**
+ * @brief 寫入跳脫後的字串內容 (不含引號),不需跳脫的片段整段複製
+ *
+ * @param json true 時其他控制字元寫成 \u00XX,否則原樣保留
+ */
+static void put_escaped(kv_writer_t *w, const char *s, bool json) {
+    const unsigned char *c = (const unsigned char *)s;
+
+    while (*c != '\0' && !w->full) {
+        const unsigned char *run = c;
+        while (*c != '\0' && !is_special(*c)) {
+            c++;
+        }
+        put_mem(w, (const char *)run, (size_t)(c - run));
+        if (*c == '\0') {
+            break;
+        }
+
+        switch (*c) {
+            case '"':  put_mem(w, "\\\"", 2); break;
+            case '\\': put_mem(w, "\\\\", 2); break;
+            case '\n': put_mem(w, "\\n", 2); break;
+            case '\r': put_mem(w, "\\r", 2); break;
+            case '\t': put_mem(w, "\\t", 2); break;
+            default:
+                if (json) {
+                    char esc[6] = { '\\', 'u', '0', '0', hex_digits[*c >> 4], hex_digits[*c & 0xf] };
+                    put_mem(w, esc, sizeof(esc));
+                } else {
+                    put_char(w, (char)*c);
+                }
+                break;
+        }
+        c++;
+    }
+}
+
+/**
+ * @brief JSON 字串 (含引號)
+ */
+static void put_json_string(kv_writer_t *w, const char *s) {
+    put_char(w, '"');
+    put_escaped(w, s, true);
+    put_char(w, '"');
+}
+
+/**
+ * @brief logfmt 字串值: 含空白、= 或需跳脫的字元時加引號
+ */
+static void put_logfmt_string(kv_writer_t *w, const char *s) {
+    const unsigned char *c = (const unsigned char *)s;
+    while (*c > ' ' && *c != '=' && !is_special(*c)) {
+        c++;
+    }
+
+    if (*c == '\0' && c != (const unsigned char *)s) {
+        put_mem(w, s, (size_t)(c - (const unsigned char *)s));
+        return;
+    }
+
+    put_char(w, '"');
+    put_escaped(w, s, false);
+    put_char(w, '"');
+}
+
+// ========================================
+// 欄位編碼
+// ========================================
+
+static void put_value(kv_writer_t *w, log_format_t format, const log_kv_t *field) {
+    bool json = (format == LOG_FORMAT_JSON);
+
+    switch (field->type) {
+        case LOG_KV_TYPE_INT:
+        case LOG_KV_TYPE_PIN:
+            put_int(w, field->value.i);
+            break;
+
+        case LOG_KV_TYPE_UINT:
+            put_uint(w, field->value.u);
+            break;
+
+        case LOG_KV_TYPE_STR:
+            if (field->value.s == NULL) {
+                put_mem(w, "null", 4);
+            } else if (json) {
+                put_json_string(w, field->value.s);
+            } else {
+                put_logfmt_string(w, field->value.s);
+            }
+            break;
+
+        case LOG_KV_TYPE_DURATION:
+            if (json) {
+                put_uint(w, field->value.u);
+            } else {
+                put_duration(w, field->value.u);
+            }
+            break;
+
+        case LOG_KV_TYPE_ERROR: {
+            const char *name = logger_kv_error_name((int)field->value.i);
+            if (name == NULL) {
+                put_int(w, field->value.i);
+            } else if (json) {
+                put_json_string(w, name);
+            } else {
+                put_str(w, name);
+            }
+            break;
+        }
+
+        default:
+            put_mem(w, "null", 4);
+            break;
+    }
+}
+
+static void put_field(kv_writer_t *w, log_format_t format, const log_kv_t *field) {
+    if (format == LOG_FORMAT_JSON) {
+        // key 為不需跳脫的字串常值
+        put_mem(w, ",\"", 2);
+        put_str(w, field->key);
+        put_mem(w, "\":", 2);
+    } else {
+        put_char(w, ' ');
+        put_str(w, field->key);
+        put_char(w, '=');
+    }
+    put_value(w, format, field);
+}
+
+/**
+ * @brief 訊息本身與 level / module 等固定欄位
+ */
+static void put_header(kv_writer_t *w, log_format_t format,
+                       log_module_t module, log_level_t level, const char *msg) {
+    const char *level_name = level_names[level];
+    const char *module_name = logger_module_name(module);
+
+    switch (format) {
+        case LOG_FORMAT_LOGFMT:
+            put_mem(w, "level=", 6);
+            put_str(w, level_name);
+            put_mem(w, " module=", 8);
+            put_str(w, module_name);
+            if (msg != NULL) {
+                put_mem(w, " msg=", 5);
+                put_logfmt_string(w, msg);
+            }
+            break;
+
+        case LOG_FORMAT_JSON:
+            put_mem(w, "{\"level\":\"", 10);
+            put_str(w, level_name);
+            put_mem(w, "\",\"module\":\"", 12);
+            put_str(w, module_name);
+            put_char(w, '"');
+            if (msg != NULL) {
+                put_mem(w, ",\"msg\":", 7);
+                put_json_string(w, msg);
+            }
+            break;
+
+        default:
+            // 與 logger_mod() 相同的 "[模組] 訊息"
+            if (module != LOG_MODULE_CORE) {
+                put_char(w, '[');
+                put_str(w, module_name);
+                put_mem(w, "] ", 2);
+            }
+            if (msg != NULL) {
+                put_str(w, msg);
+            }
+            break;
+    }
+}
+
+// ========================================
+// 公開 API 實作
+// ========================================
+
+const char* logger_kv_error_name(int code) {
+    if (code > 0 || code < GAMING_ERROR_IO) {
+        return NULL;
+    }
+    return error_names[-code];
+}
+
+size_t logger_kv_encode(log_format_t format, char *out, size_t size,
+                        log_module_t module, log_level_t level, const char *msg,
+                        const log_kv_t *fields, size_t count) {
+    if (out == NULL || size == 0) {
+        return 0;
+    }
+    out[0] = '\0';
+
+    if ((int)format < LOG_FORMAT_TEXT || (int)format > LOG_FORMAT_JSON ||
+        (int)module < 0 || module >= LOG_MODULE_COUNT ||
+        (int)level < LOG_LEVEL_DEBUG || (int)level > LOG_LEVEL_ERROR) {
+        return 0;
+    }
+
+    // 結尾保留 '\0',JSON 另外保留 '}'
+    size_t reserve = (format == LOG_FORMAT_JSON) ? 2 : 1;
+    if (size <= reserve) {
+        return 0;
+    }
+    kv_writer_t w = { out, out + size - reserve, false };
+
+    put_header(&w, format, module, level, msg);
+    if (w.full) {
+        // 訊息放不下: 只保留固定欄位
+        w.p = out;
+        w.full = false;
+        put_header(&w, format, module, level, NULL);
+        if (w.full) {
+            out[0] = '\0';
+            return 0;
+        }
+    }
+
+    if (count > LOGGER_KV_MAX_FIELDS) {
+        count = LOGGER_KV_MAX_FIELDS;
+    }
+    for (size_t i = 0; fields != NULL && i < count; i++) {
+        char *mark = w.p;
+        put_field(&w, format, &fields[i]);
+        if (w.full) {
+            w.p = mark;
+            break;
+        }
+    }
+
+    if (format == LOG_FORMAT_JSON) {
+        *w.p++ = '}';
+    }
+    *w.p = '\0';
+    return (size_t)(w.p - out);
+}
+
+void logger_kv_write(log_module_t module, log_level_t level, const char *msg,
+                     const log_kv_t *fields, size_t count) {
+    log_format_t format = logger_get_format();
+
+    // 只輸出到 console 時維持給人閱讀的格式
+    if (logger_get_target() == LOG_TARGET_CONSOLE) {
+        format = LOG_FORMAT_TEXT;
+    }
+
+    size_t len = logger_kv_encode(format, tls_kv_buffer, sizeof(tls_kv_buffer),
+                                  module, level, msg, fields, count);
+    if (len > 0) {
+        logger_module_write(module, level, tls_kv_buffer, len);
+    }
+}
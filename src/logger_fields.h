@@ -0,0 +1,135 @@
+/**
+ * @file logger_fields.h
+ * @brief 結構化日誌 - 型別化的 key/value 欄位
+ * @version 1.0.0
+ *
+ * 呼叫端不寫 printf 格式字串,而是傳入固定訊息與型別化欄位,
+ * 依 logger_set_format() 直接編碼為文字、logfmt 或 JSON,
+ * 分析端不需要再用正規表示式拆解訊息:
+ *
+ *   logger_kv(LOG_MODULE_GPIO, LOG_LEVEL_ERROR, "write failed",
+ *             LOG_KV_PIN(pin), LOG_KV_INT("ret", ret));
+ *
+ *   text:   [gpio] write failed pin=17 ret=-5
+ *   logfmt: level=error module=gpio msg="write failed" pin=17 ret=-5
+ *   json:   {"level":"error","module":"gpio","msg":"write failed","pin":17,"ret":-5}
+ *
+ * - 欄位放在呼叫端堆疊上,編碼寫入執行緒區域緩衝區,不配置記憶體
+ * - 每種型別有專用的寫入函數,不經過 vsnprintf
+ * - 等級檢查與 logger_mod() 相同,未通過時欄位不會被運算
+ * - 放不下的欄位整個省略,JSON 一定保持完整
+ */
+
+#ifndef LOGGER_FIELDS_H
+#define LOGGER_FIELDS_H
+
+#include "gaming_common.h"
+#include "logger.h"
+
+// ========================================
+// 欄位定義
+// ========================================
+
+typedef enum {
+    LOG_KV_TYPE_INT = 0,        ///< 有號整數
+    LOG_KV_TYPE_UINT = 1,       ///< 無號整數
+    LOG_KV_TYPE_STR = 2,        ///< 字串 (NULL 輸出為 null)
+    LOG_KV_TYPE_PIN = 3,        ///< GPIO 腳位,key 固定為 "pin"
+    LOG_KV_TYPE_DURATION = 4,   ///< 時間長度 (微秒),文字顯示為 us/ms/s,JSON 為微秒數
+    LOG_KV_TYPE_ERROR = 5,      ///< GAMING_* 錯誤碼,key 固定為 "error",輸出名稱
+} log_kv_type_t;
+
+typedef struct {
+    const char *key;
+    log_kv_type_t type;
+    union {
+        int64_t i;
+        uint64_t u;
+        const char *s;
+    } value;
+} log_kv_t;
+
+// 欄位建構巨集 (key 必須是不需跳脫的字串常值)
+#define LOG_KV_INT(k, v)          ((log_kv_t){ .key = (k), .type = LOG_KV_TYPE_INT, .value.i = (v) })
+#define LOG_KV_UINT(k, v)         ((log_kv_t){ .key = (k), .type = LOG_KV_TYPE_UINT, .value.u = (v) })
+#define LOG_KV_STR(k, v)          ((log_kv_t){ .key = (k), .type = LOG_KV_TYPE_STR, .value.s = (v) })
+#define LOG_KV_PIN(v)             ((log_kv_t){ .key = "pin", .type = LOG_KV_TYPE_PIN, .value.i = (v) })
+#define LOG_KV_DURATION_US(k, v)  ((log_kv_t){ .key = (k), .type = LOG_KV_TYPE_DURATION, .value.u = (v) })
+#define LOG_KV_ERROR(v)           ((log_kv_t){ .key = "error", .type = LOG_KV_TYPE_ERROR, .value.i = (v) })
+
+// 一筆日誌最多的欄位數
+#define LOGGER_KV_MAX_FIELDS  16
+
+// ========================================
+// 結構化日誌巨集
+// ========================================
+
+/**
+ * @brief 輸出一筆結構化日誌 (至少一個欄位)
+ */
+#define logger_kv(module, level, msg, ...) \
+    do { \
+        if (LOGGER_MODULE_ENABLED(module, level)) { \
+            const log_kv_t logger_kv_[] = { __VA_ARGS__ }; \
+            logger_kv_write(module, level, msg, logger_kv_, \
+                            sizeof(logger_kv_) / sizeof(logger_kv_[0])); \
+        } \
+    } while (0)
+
+/**
+ * @brief 限速版本,與 logger_mod_ratelimited() 相同規則;
+ *        恢復輸出時多一個 "suppressed" 欄位記錄被抑制的筆數
+ */
+#define logger_kv_ratelimited(module, level, msg, ...) \
+    do { \
+        static logger_ratelimit_t logger_rl_ = LOGGER_RATELIMIT_INIT; \
+        if (LOGGER_MODULE_ENABLED(module, level)) { \
+            int logger_rl_n_ = logger_ratelimit_check(&logger_rl_, LOGGER_RATELIMIT_RATE, \
+                                                      LOGGER_RATELIMIT_BURST); \
+            if (logger_rl_n_ >= 0) { \
+                const log_kv_t logger_kv_[] = { \
+                    __VA_ARGS__, LOG_KV_INT("suppressed", logger_rl_n_) \
+                }; \
+                size_t logger_kv_n_ = sizeof(logger_kv_) / sizeof(logger_kv_[0]); \
+                logger_kv_write(module, level, msg, logger_kv_, \
+                                logger_rl_n_ > 0 ? logger_kv_n_ : logger_kv_n_ - 1); \
+            } \
+        } \
+    } while (0)
+
+// ========================================
+// Logger Fields 公開函數
+// ========================================
+
+/**
+ * @brief 依目前格式編碼並輸出 (供 logger_kv 巨集使用)
+ *
+ * @param module 模組
+ * @param level 日誌等級
+ * @param msg 固定訊息,NULL 則省略
+ * @param fields 欄位陣列
+ * @param count 欄位數 (超過 LOGGER_KV_MAX_FIELDS 的部分省略)
+ */
+void logger_kv_write(log_module_t module, log_level_t level, const char *msg,
+                     const log_kv_t *fields, size_t count);
+
+/**
+ * @brief 將一筆結構化日誌編碼到緩衝區
+ *
+ * @param format 編碼格式
+ * @param out 輸出緩衝區 (一定以 '\0' 結尾)
+ * @param size 緩衝區大小
+ * @return 編碼後的長度 (不含 '\0'),size 太小無法放入任何內容時為 0
+ */
+size_t logger_kv_encode(log_format_t format, char *out, size_t size,
+                        log_module_t module, log_level_t level, const char *msg,
+                        const log_kv_t *fields, size_t count);
+
+/**
+ * @brief 取得 GAMING_* 錯誤碼的簡短名稱 (例如 GAMING_ERROR_IO → "io")
+ *
+ * @return 名稱,不認得的錯誤碼為 NULL
+ */
+const char* logger_kv_error_name(int code);
+
+#endif // LOGGER_FIELDS_H
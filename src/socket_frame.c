@@ -0,0 +1,370 @@
+/**
+ * @file socket_frame.c
+ * @brief Socket Frame 實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE  // MSG_MORE
+
+#include "socket_frame.h"
+#include "socket_helper.h"
+#include "logger.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+// ========================================
+// 內部資料
+// ========================================
+
+// 每次 sendmsg 最多送出的訊息數 (每則佔兩個 iovec)
+#define FRAME_BATCH_MAX 64
+
+struct socket_frame_reader {
+    uint8_t *buf;           // 跨越呼叫的不完整訊息 (含標頭)
+    size_t len;
+    size_t cap;
+    size_t max_payload;
+};
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+static uint32_t decode_header(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+/**
+ * @brief 送出 iovec 陣列,部分寫入時往前推進 (會修改 iov)
+ */
+static int send_iov(int sockfd, struct iovec *iov, int iovcnt, int flags, long long deadline) {
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+
+    while (iovcnt > 0) {
+        msg.msg_iov = iov;
+        msg.msg_iovlen = (size_t)iovcnt;
+
+        ssize_t n = sendmsg(sockfd, &msg, flags | MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                logger_mod_ratelimited(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR,
+                                       "frame send on fd %d: %s", sockfd, strerror(errno));
+                return GAMING_ERROR_IO;
+            }
+
+            int remaining = socket_helper_remaining_ms(deadline);
+            if (remaining == 0) {
+                return GAMING_ERROR_TIMEOUT;
+            }
+            socket_helper_is_writable(sockfd, remaining);
+            continue;
+        }
+
+        // 略過已送完的 iovec,調整送到一半的那一個
+        size_t sent = (size_t)n;
+        while (iovcnt > 0 && sent >= iov->iov_len) {
+            sent -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (uint8_t *)iov->iov_base + sent;
+            iov->iov_len -= sent;
+        }
+    }
+
+    return GAMING_OK;
+}
+
+static bool reader_reserve(socket_frame_reader_t *reader, size_t need) {
+    if (need <= reader->cap) {
+        return true;
+    }
+
+    size_t cap = reader->cap ? reader->cap : 256;
+    while (cap < need) {
+        cap *= 2;
+    }
+    uint8_t *buf = realloc(reader->buf, cap);
+    if (buf == NULL) {
+        return false;
+    }
+    reader->buf = buf;
+    reader->cap = cap;
+    return true;
+}
+
+static int reader_stash(socket_frame_reader_t *reader, const uint8_t *data, size_t len) {
+    if (len == 0) {
+        return GAMING_OK;
+    }
+    if (!reader_reserve(reader, reader->len + len)) {
+        return GAMING_ERROR_NO_MEMORY;
+    }
+    memcpy(reader->buf + reader->len, data, len);
+    reader->len += len;
+    return GAMING_OK;
+}
+
+static int check_length(const socket_frame_reader_t *reader, uint32_t len) {
+    if (len > reader->max_payload) {
+        logger_mod_ratelimited(LOG_MODULE_SOCKET, LOG_LEVEL_WARN,
+                               "frame too large: %u > %zu", len, reader->max_payload);
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    return GAMING_OK;
+}
+
+// ========================================
+// 送出
+// ========================================
+
+void socket_frame_encode_header(uint8_t header[SOCKET_FRAME_HEADER_SIZE], uint32_t len) {
+    header[0] = (uint8_t)(len >> 24);
+    header[1] = (uint8_t)(len >> 16);
+    header[2] = (uint8_t)(len >> 8);
+    header[3] = (uint8_t)len;
+}
+
+int socket_frame_send(int sockfd, const void *payload, size_t len, uint32_t flags,
+                      int timeout_ms) {
+    if (sockfd < 0 || (payload == NULL && len > 0) || len > UINT32_MAX) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint8_t header[SOCKET_FRAME_HEADER_SIZE];
+    socket_frame_encode_header(header, (uint32_t)len);
+
+    struct iovec iov[2] = {
+        { .iov_base = header, .iov_len = sizeof(header) },
+        { .iov_base = (void *)payload, .iov_len = len },
+    };
+    int msg_flags = (flags & SOCKET_FRAME_MORE) ? MSG_MORE : 0;
+
+    return send_iov(sockfd, iov, len > 0 ? 2 : 1, msg_flags,
+                    socket_helper_deadline_after(timeout_ms));
+}
+
+int socket_frame_send_batch(int sockfd, const socket_frame_msg_t *msgs, size_t count,
+                            int timeout_ms) {
+    if (sockfd < 0 || (msgs == NULL && count > 0)) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if ((msgs[i].data == NULL && msgs[i].len > 0) || msgs[i].len > UINT32_MAX) {
+            return GAMING_ERROR_INVALID_PARAM;
+        }
+    }
+
+    uint8_t headers[FRAME_BATCH_MAX][SOCKET_FRAME_HEADER_SIZE];
+    struct iovec iov[FRAME_BATCH_MAX * 2];
+    long long deadline = socket_helper_deadline_after(timeout_ms);
+
+    for (size_t start = 0; start < count; start += FRAME_BATCH_MAX) {
+        size_t n = count - start;
+        if (n > FRAME_BATCH_MAX) {
+            n = FRAME_BATCH_MAX;
+        }
+
+        int iovcnt = 0;
+        for (size_t i = 0; i < n; i++) {
+            const socket_frame_msg_t *m = &msgs[start + i];
+            socket_frame_encode_header(headers[i], (uint32_t)m->len);
+            iov[iovcnt].iov_base = headers[i];
+            iov[iovcnt].iov_len = SOCKET_FRAME_HEADER_SIZE;
+            iovcnt++;
+            if (m->len > 0) {
+                iov[iovcnt].iov_base = (void *)m->data;
+                iov[iovcnt].iov_len = m->len;
+                iovcnt++;
+            }
+        }
+
+        // 後面還有批次時先不推送
+        int flags = (start + n < count) ? MSG_MORE : 0;
+        int ret = send_iov(sockfd, iov, iovcnt, flags, deadline);
+        if (ret != GAMING_OK) {
+            return ret;
+        }
+    }
+
+    return GAMING_OK;
+}
+
+// ========================================
+// 接收
+// ========================================
+
+int socket_frame_recv(int sockfd, void *buffer, size_t size, size_t *len, int timeout_ms) {
+    if (sockfd < 0 || (buffer == NULL && size > 0) || len == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint8_t header[SOCKET_FRAME_HEADER_SIZE];
+    long long deadline = socket_helper_deadline_after(timeout_ms);
+
+    int ret = socket_helper_recv_all(sockfd, header, sizeof(header), timeout_ms);
+    if (ret != GAMING_OK) {
+        return ret;
+    }
+
+    uint32_t frame_len = decode_header(header);
+    if (frame_len > size) {
+        // payload 留在 socket 中,串流已不同步: 呼叫端必須關閉連線
+        logger_mod_ratelimited(LOG_MODULE_SOCKET, LOG_LEVEL_WARN,
+                               "frame too large: %u > %zu", frame_len, size);
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    ret = socket_helper_recv_all(sockfd, buffer, frame_len, socket_helper_remaining_ms(deadline));
+    if (ret != GAMING_OK) {
+        return ret;
+    }
+
+    *len = frame_len;
+    return GAMING_OK;
+}
+
+socket_frame_reader_t* socket_frame_reader_create(size_t max_payload) {
+    socket_frame_reader_t *reader = calloc(1, sizeof(*reader));
+    if (reader == NULL) {
+        return NULL;
+    }
+
+    reader->max_payload = max_payload ? max_payload : SOCKET_FRAME_DEFAULT_MAX;
+    return reader;
+}
+
+void socket_frame_reader_destroy(socket_frame_reader_t *reader) {
+    if (reader == NULL) {
+        return;
+    }
+    free(reader->buf);
+    free(reader);
+}
+
+/**
+ * @brief 依序交出 [*p, *p + *len) 中的完整訊息,返回時指向剩餘資料
+ */
+static int deliver(socket_frame_reader_t *reader, const uint8_t **p, size_t *len,
+                   socket_frame_cb callback, void *user_data, bool *too_large) {
+    *too_large = false;
+    while (*len >= SOCKET_FRAME_HEADER_SIZE) {
+        uint32_t frame_len = decode_header(*p);
+        int ret = check_length(reader, frame_len);
+        if (ret != GAMING_OK) {
+            // 與 callback 的錯誤區分: 串流已不同步,剩餘資料不再保留
+            *too_large = true;
+            return ret;
+        }
+        if (*len - SOCKET_FRAME_HEADER_SIZE < frame_len) {
+            break;
+        }
+
+        const uint8_t *payload = *p + SOCKET_FRAME_HEADER_SIZE;
+        *p = payload + frame_len;
+        *len -= SOCKET_FRAME_HEADER_SIZE + frame_len;
+
+        ret = callback(payload, frame_len, user_data);
+        if (ret != GAMING_OK) {
+            return ret;
+        }
+    }
+    return GAMING_OK;
+}
+
+int socket_frame_reader_feed(socket_frame_reader_t *reader, const void *data, size_t len,
+                             socket_frame_cb callback, void *user_data) {
+    if (reader == NULL || (data == NULL && len > 0) || callback == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    const uint8_t *p = data;
+    bool too_large;
+    int ret;
+
+    // 上次 callback 回傳錯誤時暫存區可能還有完整訊息
+    if (reader->len >= SOCKET_FRAME_HEADER_SIZE) {
+        const uint8_t *q = reader->buf;
+        size_t qlen = reader->len;
+        ret = deliver(reader, &q, &qlen, callback, user_data, &too_large);
+        memmove(reader->buf, q, qlen);
+        reader->len = qlen;
+        if (too_large) {
+            return ret;
+        }
+        if (ret != GAMING_OK) {
+            return (reader_stash(reader, p, len) == GAMING_OK) ? ret : GAMING_ERROR_NO_MEMORY;
+        }
+    }
+
+    // 補齊上次留下的不完整訊息
+    if (reader->len > 0) {
+        if (reader->len < SOCKET_FRAME_HEADER_SIZE) {
+            size_t n = SOCKET_FRAME_HEADER_SIZE - reader->len;
+            if (n > len) {
+                n = len;
+            }
+            ret = reader_stash(reader, p, n);
+            if (ret != GAMING_OK) {
+                return ret;
+            }
+            p += n;
+            len -= n;
+            if (reader->len < SOCKET_FRAME_HEADER_SIZE) {
+                return GAMING_OK;
+            }
+        }
+
+        uint32_t frame_len = decode_header(reader->buf);
+        ret = check_length(reader, frame_len);
+        if (ret != GAMING_OK) {
+            return ret;
+        }
+
+        size_t missing = SOCKET_FRAME_HEADER_SIZE + frame_len - reader->len;
+        size_t n = (missing < len) ? missing : len;
+        ret = reader_stash(reader, p, n);
+        if (ret != GAMING_OK) {
+            return ret;
+        }
+        p += n;
+        len -= n;
+        if (n < missing) {
+            return GAMING_OK;
+        }
+
+        reader->len = 0;
+        ret = callback(reader->buf + SOCKET_FRAME_HEADER_SIZE, frame_len, user_data);
+        if (ret != GAMING_OK) {
+            return (reader_stash(reader, p, len) == GAMING_OK) ? ret : GAMING_ERROR_NO_MEMORY;
+        }
+    }
+
+    // 完整的訊息直接從輸入資料交出,只暫存最後不完整的部分
+    ret = deliver(reader, &p, &len, callback, user_data, &too_large);
+    if (too_large) {
+        return ret;
+    }
+    if (reader_stash(reader, p, len) != GAMING_OK) {
+        return GAMING_ERROR_NO_MEMORY;
+    }
+    return ret;
+}
+
+size_t socket_frame_reader_pending(const socket_frame_reader_t *reader) {
+    return reader ? reader->len : 0;
+}
+
+void socket_frame_reader_reset(socket_frame_reader_t *reader) {
+    if (reader != NULL) {
+        reader->len = 0;
+    }
+}
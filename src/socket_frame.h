@@ -0,0 +1,141 @@
+/**
+ * @file socket_frame.h
+ * @brief Socket Frame - 長度前綴的訊息分框
+ * @version 1.0.0
+ *
+ * 串流 socket 上每則訊息的格式:
+ *
+ *   +----------------------+------------------+
+ *   | 長度 (4 bytes, 網路序) | payload (長度 bytes) |
+ *   +----------------------+------------------+
+ *
+ * 送出: 標頭與 payload 以同一次 sendmsg() 的 scatter-gather 送出,
+ * payload 不需複製到暫存區。多則小訊息可用 socket_frame_send_batch()
+ * 一次送出,或以 SOCKET_FRAME_MORE (MSG_MORE) 讓 kernel 先合併再送
+ *
+ * 接收: 阻塞式的 socket_frame_recv(),或以 socket_frame_reader_t
+ * 把任意切割的資料 (例如 socket_server 的 on_data) 重組為完整訊息
+ *
+ * 所有期限皆為毫秒,-1 表示不限
+ */
+
+#ifndef SOCKET_FRAME_H
+#define SOCKET_FRAME_H
+
+#include "gaming_common.h"
+#include <sys/types.h>
+
+// ========================================
+// Socket Frame 配置
+// ========================================
+
+// 標頭長度
+#define SOCKET_FRAME_HEADER_SIZE    4
+
+// 預設單則訊息上限,超過視為協定錯誤
+#define SOCKET_FRAME_DEFAULT_MAX    (64 * 1024)
+
+// 送出旗標
+#define SOCKET_FRAME_MORE   0x01u   ///< 之後還有訊息,kernel 可先保留不送 (MSG_MORE)
+
+typedef struct {
+    const void *data;
+    size_t len;
+} socket_frame_msg_t;
+
+typedef struct socket_frame_reader socket_frame_reader_t;
+
+/**
+ * @brief 收到完整訊息的回呼 (payload 只在回呼期間有效)
+ *
+ * @return GAMING_OK 繼續處理,其他值則停止並由 feed 回傳
+ */
+typedef int (*socket_frame_cb)(const uint8_t *payload, size_t len, void *user_data);
+
+// ========================================
+// 送出
+// ========================================
+
+/**
+ * @brief 寫入標頭
+ */
+void socket_frame_encode_header(uint8_t header[SOCKET_FRAME_HEADER_SIZE], uint32_t len);
+
+/**
+ * @brief 送出一則訊息
+ *
+ * @param flags 0 或 SOCKET_FRAME_MORE
+ * @param timeout_ms 整體期限(毫秒)
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_TIMEOUT 期限內未送完 (串流已不同步,應關閉連線)
+ * @return GAMING_ERROR_IO 連線錯誤
+ */
+int socket_frame_send(int sockfd, const void *payload, size_t len, uint32_t flags,
+                      int timeout_ms);
+
+/**
+ * @brief 以最少的系統呼叫送出多則訊息
+ *
+ * @return 同 socket_frame_send()
+ */
+int socket_frame_send_batch(int sockfd, const socket_frame_msg_t *msgs, size_t count,
+                            int timeout_ms);
+
+// ========================================
+// 接收
+// ========================================
+
+/**
+ * @brief 阻塞接收一則訊息
+ *
+ * @param buffer 接收緩衝區
+ * @param size 緩衝區大小 (也是可接受的最大長度)
+ * @param len 輸出: payload 長度
+ * @param timeout_ms 整體期限(毫秒)
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤或訊息超過緩衝區 (payload 未讀取,
+ *         串流已不同步,必須關閉 socket,不可再呼叫 socket_frame_recv())
+ * @return GAMING_ERROR_TIMEOUT 期限內未收完
+ * @return GAMING_ERROR_IO 連線錯誤或對端關閉
+ */
+int socket_frame_recv(int sockfd, void *buffer, size_t size, size_t *len, int timeout_ms);
+
+/**
+ * @brief 建立重組器
+ *
+ * @param max_payload 單則訊息上限,0 使用 SOCKET_FRAME_DEFAULT_MAX
+ * @return 重組器, NULL 表示記憶體不足
+ */
+socket_frame_reader_t* socket_frame_reader_create(size_t max_payload);
+
+/**
+ * @brief 釋放重組器
+ */
+void socket_frame_reader_destroy(socket_frame_reader_t *reader);
+
+/**
+ * @brief 加入收到的資料,每組成一則完整訊息就呼叫 callback
+ *
+ * 資料中完整的訊息直接以原指標交給 callback,只有跨越呼叫的部分會被複製
+ *
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤或訊息超過上限 (應關閉連線)
+ * @return GAMING_ERROR_NO_MEMORY 記憶體不足
+ * @return 其他 callback 回傳的錯誤 (該則訊息視為已處理,剩餘資料保留到下次呼叫,
+ *         callback 回傳 GAMING_ERROR_INVALID_PARAM 時也相同)
+ */
+int socket_frame_reader_feed(socket_frame_reader_t *reader, const void *data, size_t len,
+                             socket_frame_cb callback, void *user_data);
+
+/**
+ * @brief 目前暫存、尚未組成完整訊息的位元組數
+ */
+size_t socket_frame_reader_pending(const socket_frame_reader_t *reader);
+
+/**
+ * @brief 清除暫存資料 (重新連線時使用)
+ */
+void socket_frame_reader_reset(socket_frame_reader_t *reader);
+
+#endif // SOCKET_FRAME_H
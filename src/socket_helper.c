@@ -4,15 +4,126 @@
  * @version 1.0.0
  */
 
+#define _GNU_SOURCE  // SO_REUSEPORT, SO_PRIORITY, IPV6_TCLASS
+
 #include "socket_helper.h"
-#include <stdio.h>
+#include "logger.h"
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
-#include <sys/select.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/time.h>
 #include <arpa/inet.h>
+#include <netinet/tcp.h>
+
+// ========================================
+// 預設選項組合
+// ========================================
+
+static const socket_options_t profiles[SOCKET_PROFILE_COUNT] = {
+    // 控制通道: 小訊息立即送出與確認,約 8 秒偵測到斷線,
+    // 限制 kernel 中未送出的資料量,避免舊狀態排在新狀態前面
+    [SOCKET_PROFILE_INTERACTIVE] = {
+        .nodelay = 1,
+        .quickack = 1,
+        .user_timeout_ms = 5000,
+        .keepalive_idle_s = 5,
+        .keepalive_intvl_s = 1,
+        .keepalive_cnt = 3,
+        .notsent_lowat = 16384,
+        .sndbuf = SOCKET_OPT_UNSET,
+        .rcvbuf = SOCKET_OPT_UNSET,
+        .priority = 6,
+        .dscp = SOCKET_DSCP_EF,
+    },
+    // 大量傳輸: 固定的大緩衝區,標記為低優先,不與遊戲流量競爭
+    [SOCKET_PROFILE_BULK] = {
+        .nodelay = SOCKET_OPT_UNSET,
+        .quickack = SOCKET_OPT_UNSET,
+        .user_timeout_ms = 30000,
+        .keepalive_idle_s = 60,
+        .keepalive_intvl_s = 10,
+        .keepalive_cnt = 5,
+        .notsent_lowat = SOCKET_OPT_UNSET,
+        .sndbuf = 262144,
+        .rcvbuf = 262144,
+        .priority = 0,
+        .dscp = SOCKET_DSCP_CS1,
+    },
+};
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+/**
+ * @brief 以 poll() 等待單一 fd (select() 無法處理 >= FD_SETSIZE 的 fd)
+ */
+static bool wait_fd(int sockfd, short events, int timeout_ms) {
+    struct pollfd pfd = { .fd = sockfd, .events = events };
+
+    int ret;
+    do {
+        ret = poll(&pfd, 1, timeout_ms);
+    } while (ret < 0 && errno == EINTR);
+
+    // 與 select() 相同: 錯誤或對端關閉時也視為可讀/可寫,讓呼叫端讀到錯誤
+    return ret > 0 && (pfd.revents & (events | POLLERR | POLLHUP)) != 0 &&
+           (pfd.revents & POLLNVAL) == 0;
+}
+
+/**
+ * @brief 以非阻塞 connect() 在期限內完成連線,完成後恢復原本的阻塞模式
+ * 
+ * @return 0 成功, -1 失敗 (errno 為連線錯誤或 ETIMEDOUT)
+ */
+static int connect_with_deadline(int sockfd, const struct sockaddr *addr, socklen_t addrlen,
+                                 int timeout_ms) {
+    int flags = fcntl(sockfd, F_GETFL, 0);
+    if (flags < 0 || fcntl(sockfd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        return -1;
+    }
+
+    long long deadline = socket_helper_deadline_after(timeout_ms);
+    int err = 0;
+
+    // 非阻塞 connect 被信號中斷時連線仍在背景進行,與 EINPROGRESS 相同處理
+    if (connect(sockfd, addr, addrlen) < 0) {
+        if (errno != EINPROGRESS && errno != EINTR) {
+            err = errno;
+        } else {
+            while (!wait_fd(sockfd, POLLOUT, socket_helper_remaining_ms(deadline))) {
+                if (socket_helper_remaining_ms(deadline) == 0) {
+                    err = ETIMEDOUT;
+                    break;
+                }
+            }
+            socklen_t len = sizeof(err);
+            if (err == 0 && getsockopt(sockfd, SOL_SOCKET, SO_ERROR, &err, &len) < 0) {
+                err = errno;
+            }
+        }
+    }
+
+    fcntl(sockfd, F_SETFL, flags);
+    errno = err;
+    return (err == 0) ? 0 : -1;
+}
+
+/**
+ * @brief 設置單一整數選項,失敗時記錄警告
+ */
+static bool set_int_opt(int sockfd, int level, int name, int value, const char *label) {
+    if (setsockopt(sockfd, level, name, &value, sizeof(value)) < 0) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_WARN,
+                   "setsockopt(%s=%d): %s", label, value, strerror(errno));
+        return false;
+    }
+    return true;
+}
 
 // ========================================
 // Unix Socket 函數
@@ -24,9 +135,9 @@ int socket_helper_create_unix(const char *path) {
     }
 
     // 建立 socket
-    int sockfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    int sockfd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
     if (sockfd < 0) {
-        perror("socket");
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "socket(AF_UNIX): %s", strerror(errno));
         return -1;
     }
 
@@ -41,14 +152,14 @@ int socket_helper_create_unix(const char *path) {
 
     // 綁定
     if (bind(sockfd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        perror("bind");
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "bind %s: %s", path, strerror(errno));
         close(sockfd);
         return -1;
     }
 
     // 監聽
     if (listen(sockfd, SOCKET_DEFAULT_BACKLOG) < 0) {
-        perror("listen");
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "listen %s: %s", path, strerror(errno));
         close(sockfd);
         return -1;
     }
@@ -62,9 +173,9 @@ int socket_helper_connect_unix(const char *path) {
     }
 
     // 建立 socket
-    int sockfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    int sockfd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
     if (sockfd < 0) {
-        perror("socket");
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "socket(AF_UNIX): %s", strerror(errno));
         return -1;
     }
 
@@ -76,7 +187,8 @@ int socket_helper_connect_unix(const char *path) {
 
     // 連接
     if (connect(sockfd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        perror("connect");
+        logger_mod_ratelimited(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR,
+                               "connect %s: %s", path, strerror(errno));
         close(sockfd);
         return -1;
     }
@@ -94,9 +206,9 @@ int socket_helper_create_tcp_server(int port, int backlog) {
     }
 
     // 建立 socket
-    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    int sockfd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
     if (sockfd < 0) {
-        perror("socket");
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "socket(AF_INET): %s", strerror(errno));
         return -1;
     }
 
@@ -112,7 +224,7 @@ int socket_helper_create_tcp_server(int port, int backlog) {
 
     // 綁定
     if (bind(sockfd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        perror("bind");
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "bind port %d: %s", port, strerror(errno));
         close(sockfd);
         return -1;
     }
@@ -120,7 +232,7 @@ int socket_helper_create_tcp_server(int port, int backlog) {
     // 監聽
     int listen_backlog = (backlog > 0) ? backlog : SOCKET_DEFAULT_BACKLOG;
     if (listen(sockfd, listen_backlog) < 0) {
-        perror("listen");
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "listen port %d: %s", port, strerror(errno));
         close(sockfd);
         return -1;
     }
@@ -129,14 +241,18 @@ int socket_helper_create_tcp_server(int port, int backlog) {
 }
 
 int socket_helper_connect_tcp(const char *host, int port) {
+    return socket_helper_connect_tcp_timeout(host, port, -1);
+}
+
+int socket_helper_connect_tcp_timeout(const char *host, int port, int timeout_ms) {
     if (host == NULL || port <= 0 || port > 65535) {
         return -1;
     }
 
     // 建立 socket
-    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    int sockfd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
     if (sockfd < 0) {
-        perror("socket");
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "socket(AF_INET): %s", strerror(errno));
         return -1;
     }
 
@@ -147,15 +263,18 @@ int socket_helper_connect_tcp(const char *host, int port) {
     addr.sin_port = htons(port);
 
     if (inet_pton(AF_INET, host, &addr.sin_addr) <= 0) {
-        perror("inet_pton");
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "Invalid IPv4 address: %s", host);
         close(sockfd);
         return -1;
     }
 
     // 連接
-    if (connect(sockfd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        perror("connect");
+    if (connect_with_deadline(sockfd, (struct sockaddr*)&addr, sizeof(addr), timeout_ms) < 0) {
+        int err = errno;
+        logger_mod_ratelimited(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR,
+                               "connect %s:%d: %s", host, port, strerror(err));
         close(sockfd);
+        errno = err;
         return -1;
     }
 
@@ -171,17 +290,27 @@ int socket_helper_set_timeout(int sockfd, int timeout_sec) {
         return GAMING_ERROR_INVALID_PARAM;
     }
 
+    return socket_helper_set_timeout_ms(sockfd, timeout_sec * 1000);
+}
+
+int socket_helper_set_timeout_ms(int sockfd, int timeout_ms) {
+    if (sockfd < 0 || timeout_ms < 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
     struct timeval timeout;
-    timeout.tv_sec = timeout_sec;
-    timeout.tv_usec = 0;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_usec = (timeout_ms % 1000) * 1000;
 
     if (setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) < 0) {
-        perror("setsockopt(SO_RCVTIMEO)");
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR,
+                   "setsockopt(SO_RCVTIMEO): %s", strerror(errno));
         return GAMING_ERROR;
     }
 
     if (setsockopt(sockfd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) < 0) {
-        perror("setsockopt(SO_SNDTIMEO)");
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR,
+                   "setsockopt(SO_SNDTIMEO): %s", strerror(errno));
         return GAMING_ERROR;
     }
 
@@ -195,12 +324,12 @@ int socket_helper_set_nonblocking(int sockfd) {
 
     int flags = fcntl(sockfd, F_GETFL, 0);
     if (flags < 0) {
-        perror("fcntl(F_GETFL)");
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "fcntl(F_GETFL): %s", strerror(errno));
         return GAMING_ERROR;
     }
 
     if (fcntl(sockfd, F_SETFL, flags | O_NONBLOCK) < 0) {
-        perror("fcntl(F_SETFL)");
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "fcntl(F_SETFL): %s", strerror(errno));
         return GAMING_ERROR;
     }
 
@@ -214,13 +343,144 @@ int socket_helper_set_reuseaddr(int sockfd) {
 
     int optval = 1;
     if (setsockopt(sockfd, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval)) < 0) {
-        perror("setsockopt(SO_REUSEADDR)");
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR,
+                   "setsockopt(SO_REUSEADDR): %s", strerror(errno));
+        return GAMING_ERROR;
+    }
+
+    return GAMING_OK;
+}
+
+int socket_helper_set_reuseport(int sockfd) {
+    if (sockfd < 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    int optval = 1;
+    if (setsockopt(sockfd, SOL_SOCKET, SO_REUSEPORT, &optval, sizeof(optval)) < 0) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR,
+                   "setsockopt(SO_REUSEPORT): %s", strerror(errno));
         return GAMING_ERROR;
     }
 
     return GAMING_OK;
 }
 
+int socket_helper_set_nodelay(int sockfd, bool enable) {
+    if (sockfd < 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    return set_int_opt(sockfd, IPPROTO_TCP, TCP_NODELAY, enable ? 1 : 0, "TCP_NODELAY")
+           ? GAMING_OK : GAMING_ERROR;
+}
+
+int socket_helper_set_quickack(int sockfd, bool enable) {
+    if (sockfd < 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    return set_int_opt(sockfd, IPPROTO_TCP, TCP_QUICKACK, enable ? 1 : 0, "TCP_QUICKACK")
+           ? GAMING_OK : GAMING_ERROR;
+}
+
+int socket_helper_profile_options(socket_profile_t profile, socket_options_t *options) {
+    if ((unsigned)profile >= SOCKET_PROFILE_COUNT || options == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    *options = profiles[profile];
+    return GAMING_OK;
+}
+
+int socket_helper_apply_options(int sockfd, const socket_options_t *options) {
+    if (sockfd < 0 || options == NULL || options->dscp > 63) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    struct sockaddr_storage addr;
+    socklen_t addrlen = sizeof(addr);
+    int type = 0;
+    socklen_t typelen = sizeof(type);
+    if (getsockname(sockfd, (struct sockaddr*)&addr, &addrlen) < 0 ||
+        getsockopt(sockfd, SOL_SOCKET, SO_TYPE, &type, &typelen) < 0) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "getsockname: %s", strerror(errno));
+        return GAMING_ERROR;
+    }
+
+    bool inet = (addr.ss_family == AF_INET || addr.ss_family == AF_INET6);
+    bool tcp = inet && type == SOCK_STREAM;
+    bool ok = true;
+    const socket_options_t *o = options;
+
+    // 一般 socket 選項 (Unix socket 也適用)
+    if (o->sndbuf >= 0) {
+        ok &= set_int_opt(sockfd, SOL_SOCKET, SO_SNDBUF, o->sndbuf, "SO_SNDBUF");
+    }
+    if (o->rcvbuf >= 0) {
+        ok &= set_int_opt(sockfd, SOL_SOCKET, SO_RCVBUF, o->rcvbuf, "SO_RCVBUF");
+    }
+
+    // IP 層: DSCP 在 TOS / Traffic Class 的高 6 位元
+    if (inet && o->dscp >= 0) {
+        if (addr.ss_family == AF_INET6) {
+            ok &= set_int_opt(sockfd, IPPROTO_IPV6, IPV6_TCLASS, o->dscp << 2, "IPV6_TCLASS");
+        } else {
+            ok &= set_int_opt(sockfd, IPPROTO_IP, IP_TOS, o->dscp << 2, "IP_TOS");
+        }
+    }
+
+    // 設置 IP_TOS 時 kernel 會依 TOS 改寫優先權,因此最後設置
+    if (o->priority >= 0) {
+        ok &= set_int_opt(sockfd, SOL_SOCKET, SO_PRIORITY, o->priority, "SO_PRIORITY");
+    }
+
+    if (!tcp) {
+        return ok ? GAMING_OK : GAMING_ERROR;
+    }
+
+    // TCP 層
+    if (o->nodelay >= 0) {
+        ok &= set_int_opt(sockfd, IPPROTO_TCP, TCP_NODELAY, o->nodelay, "TCP_NODELAY");
+    }
+    if (o->quickack >= 0) {
+        ok &= set_int_opt(sockfd, IPPROTO_TCP, TCP_QUICKACK, o->quickack, "TCP_QUICKACK");
+    }
+    if (o->user_timeout_ms >= 0) {
+        ok &= set_int_opt(sockfd, IPPROTO_TCP, TCP_USER_TIMEOUT, o->user_timeout_ms,
+                          "TCP_USER_TIMEOUT");
+    }
+    if (o->keepalive_idle_s > 0 || o->keepalive_intvl_s > 0 || o->keepalive_cnt > 0) {
+        ok &= set_int_opt(sockfd, SOL_SOCKET, SO_KEEPALIVE, 1, "SO_KEEPALIVE");
+    }
+    if (o->keepalive_idle_s > 0) {
+        ok &= set_int_opt(sockfd, IPPROTO_TCP, TCP_KEEPIDLE, o->keepalive_idle_s, "TCP_KEEPIDLE");
+    }
+    if (o->keepalive_intvl_s > 0) {
+        ok &= set_int_opt(sockfd, IPPROTO_TCP, TCP_KEEPINTVL, o->keepalive_intvl_s,
+                          "TCP_KEEPINTVL");
+    }
+    if (o->keepalive_cnt > 0) {
+        ok &= set_int_opt(sockfd, IPPROTO_TCP, TCP_KEEPCNT, o->keepalive_cnt, "TCP_KEEPCNT");
+    }
+#ifdef TCP_NOTSENT_LOWAT
+    if (o->notsent_lowat > 0) {
+        ok &= set_int_opt(sockfd, IPPROTO_TCP, TCP_NOTSENT_LOWAT, o->notsent_lowat,
+                          "TCP_NOTSENT_LOWAT");
+    }
+#endif
+
+    return ok ? GAMING_OK : GAMING_ERROR;
+}
+
+int socket_helper_apply_profile(int sockfd, socket_profile_t profile) {
+    if ((unsigned)profile >= SOCKET_PROFILE_COUNT) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    return socket_helper_apply_options(sockfd, &profiles[profile]);
+}
+
 // ========================================
 // Socket I/O 函數
 // ========================================
@@ -241,6 +501,73 @@ ssize_t socket_helper_recv(int sockfd, void *buffer, size_t len) {
     return recv(sockfd, buffer, len, 0);
 }
 
+int socket_helper_send_all(int sockfd, const void *data, size_t len, int timeout_ms) {
+    if (sockfd < 0 || (data == NULL && len > 0)) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    const uint8_t *p = data;
+    long long deadline = socket_helper_deadline_after(timeout_ms);
+
+    while (len > 0) {
+        ssize_t n = send(sockfd, p, len, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n > 0) {
+            p += n;
+            len -= (size_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            return GAMING_ERROR_IO;
+        }
+
+        int remaining = socket_helper_remaining_ms(deadline);
+        if (remaining == 0) {
+            return GAMING_ERROR_TIMEOUT;
+        }
+        wait_fd(sockfd, POLLOUT, remaining);
+    }
+
+    return GAMING_OK;
+}
+
+int socket_helper_recv_all(int sockfd, void *buffer, size_t len, int timeout_ms) {
+    if (sockfd < 0 || (buffer == NULL && len > 0)) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint8_t *p = buffer;
+    long long deadline = socket_helper_deadline_after(timeout_ms);
+
+    while (len > 0) {
+        ssize_t n = recv(sockfd, p, len, MSG_DONTWAIT);
+        if (n > 0) {
+            p += n;
+            len -= (size_t)n;
+            continue;
+        }
+        if (n == 0) {
+            return GAMING_ERROR_IO;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            return GAMING_ERROR_IO;
+        }
+
+        int remaining = socket_helper_remaining_ms(deadline);
+        if (remaining == 0) {
+            return GAMING_ERROR_TIMEOUT;
+        }
+        wait_fd(sockfd, POLLIN, remaining);
+    }
+
+    return GAMING_OK;
+}
+
 void socket_helper_close(int sockfd) {
     if (sockfd >= 0) {
         close(sockfd);
@@ -256,17 +583,7 @@ bool socket_helper_is_readable(int sockfd, int timeout_ms) {
         return false;
     }
 
-    fd_set readfds;
-    FD_ZERO(&readfds);
-    FD_SET(sockfd, &readfds);
-
-    struct timeval timeout;
-    timeout.tv_sec = timeout_ms / 1000;
-    timeout.tv_usec = (timeout_ms % 1000) * 1000;
-
-    int ret = select(sockfd + 1, &readfds, NULL, NULL, &timeout);
-    
-    return (ret > 0 && FD_ISSET(sockfd, &readfds));
+    return wait_fd(sockfd, POLLIN, timeout_ms);
 }
 
 bool socket_helper_is_writable(int sockfd, int timeout_ms) {
@@ -274,15 +591,27 @@ bool socket_helper_is_writable(int sockfd, int timeout_ms) {
         return false;
     }
 
-    fd_set writefds;
-    FD_ZERO(&writefds);
-    FD_SET(sockfd, &writefds);
+    return wait_fd(sockfd, POLLOUT, timeout_ms);
+}
 
-    struct timeval timeout;
-    timeout.tv_sec = timeout_ms / 1000;
-    timeout.tv_usec = (timeout_ms % 1000) * 1000;
+// ========================================
+// 期限
+// ========================================
+
+long long socket_helper_monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
 
-    int ret = select(sockfd + 1, NULL, &writefds, NULL, &timeout);
-    
-    return (ret > 0 && FD_ISSET(sockfd, &writefds));
+long long socket_helper_deadline_after(int timeout_ms) {
+    return (timeout_ms < 0) ? -1 : socket_helper_monotonic_ms() + timeout_ms;
+}
+
+int socket_helper_remaining_ms(long long deadline) {
+    if (deadline < 0) {
+        return -1;
+    }
+    long long left = deadline - socket_helper_monotonic_ms();
+    return (left > 0) ? (int)left : 0;
 }
@@ -5,6 +5,13 @@
  * 
  * 提供 Socket 通訊的輔助函數
  * 包含 Unix domain socket 和 TCP socket 的基本操作
+ * 
+ * is_readable / is_writable 只適合偶爾檢查單一 fd;
+ * 同時處理多個 fd 或計時器時請使用 event_loop.h,
+ * 需要接受大量連線的伺服器請使用 socket_server.h
+ * 
+ * 低延遲調校 (TCP_NODELAY、keepalive、DSCP 等) 以 socket_helper_apply_profile()
+ * 一次套用,或以 socket_options_t 個別指定
  */
 
 #ifndef SOCKET_HELPER_H
@@ -37,6 +44,55 @@ typedef enum {
 // 預設連接佇列長度
 #define SOCKET_DEFAULT_BACKLOG 5
 
+// socket_options_t 中表示「不變更」的值
+#define SOCKET_OPT_UNSET (-1)
+
+// DSCP 標記 (RFC 4594)
+#define SOCKET_DSCP_CS1  8       // 低優先 (背景傳輸)
+#define SOCKET_DSCP_AF41 34      // 互動式視訊
+#define SOCKET_DSCP_EF   46      // 加速轉送 (語音、遊戲控制)
+
+// ========================================
+// Socket 調校選項
+// ========================================
+
+/**
+ * @brief 預設的選項組合
+ */
+typedef enum {
+    SOCKET_PROFILE_INTERACTIVE = 0,  ///< 控制通道: 關閉 Nagle、快速 ACK、快速偵測斷線、DSCP EF
+    SOCKET_PROFILE_BULK,             ///< 大量傳輸 (日誌、韌體): 大緩衝區、DSCP CS1
+    SOCKET_PROFILE_COUNT
+} socket_profile_t;
+
+/**
+ * @brief 個別 socket 選項,SOCKET_OPT_UNSET 表示維持 kernel 預設
+ * 
+ * TCP / IP 層的選項只套用在 TCP socket,Unix socket 只套用緩衝區與優先權
+ */
+typedef struct {
+    int nodelay;            ///< TCP_NODELAY: 1 關閉 Nagle
+    int quickack;           ///< TCP_QUICKACK: 1 立即 ACK (kernel 可能自行關閉,見 socket_helper_set_quickack)
+    int user_timeout_ms;    ///< TCP_USER_TIMEOUT: 送出的資料多久未被確認就中斷連線
+    int keepalive_idle_s;   ///< 閒置多久開始送 keepalive (同時開啟 SO_KEEPALIVE)
+    int keepalive_intvl_s;  ///< keepalive 間隔
+    int keepalive_cnt;      ///< 幾次無回應視為斷線
+    int notsent_lowat;      ///< TCP_NOTSENT_LOWAT: 未送出資料超過此值時不再回報可寫
+    int sndbuf;             ///< SO_SNDBUF (kernel 會加倍以容納管理資料)
+    int rcvbuf;             ///< SO_RCVBUF
+    int priority;           ///< SO_PRIORITY: 0-6 (超過 6 需要 CAP_NET_ADMIN)
+    int dscp;               ///< IP_TOS / IPV6_TCLASS 的 DSCP 值 (0-63)
+} socket_options_t;
+
+#define SOCKET_OPTIONS_INIT {                                                   \
+    .nodelay = SOCKET_OPT_UNSET, .quickack = SOCKET_OPT_UNSET,                  \
+    .user_timeout_ms = SOCKET_OPT_UNSET, .keepalive_idle_s = SOCKET_OPT_UNSET,  \
+    .keepalive_intvl_s = SOCKET_OPT_UNSET, .keepalive_cnt = SOCKET_OPT_UNSET,   \
+    .notsent_lowat = SOCKET_OPT_UNSET, .sndbuf = SOCKET_OPT_UNSET,              \
+    .rcvbuf = SOCKET_OPT_UNSET, .priority = SOCKET_OPT_UNSET,                   \
+    .dscp = SOCKET_OPT_UNSET,                                                   \
+}
+
 // ========================================
 // Socket Helper 公開函數
 // ========================================
@@ -72,6 +128,8 @@ int socket_helper_connect_unix(const char *path);
 /**
  * @brief 連接到 TCP socket (client)
  * 
+ * 只接受 IPv4 位址;IPv6 或多個位址請使用 happy_eyeballs_connect()
+ * 
  * @param host 主機位址
  * @param port 埠號
  * @return >= 0 Socket 檔案描述符
@@ -79,6 +137,20 @@ int socket_helper_connect_unix(const char *path);
  */
 int socket_helper_connect_tcp(const char *host, int port);
 
+/**
+ * @brief 在期限內連接到 TCP socket (client)
+ * 
+ * 以非阻塞 connect() 等待連線完成,對端無回應時不會卡在 kernel 的 SYN 重送
+ * (約兩分鐘);回傳的 socket 為阻塞模式
+ * 
+ * @param host IPv4 位址
+ * @param port 埠號
+ * @param timeout_ms 期限(毫秒),-1 表示不限
+ * @return >= 0 Socket 檔案描述符
+ * @return < 0 連接失敗或逾時 (errno 為 ETIMEDOUT)
+ */
+int socket_helper_connect_tcp_timeout(const char *host, int port, int timeout_ms);
+
 /**
  * @brief 設置 socket 超時時間
  * 
@@ -89,6 +161,16 @@ int socket_helper_connect_tcp(const char *host, int port);
  */
 int socket_helper_set_timeout(int sockfd, int timeout_sec);
 
+/**
+ * @brief 設置 socket 超時時間 (毫秒)
+ * 
+ * @param sockfd Socket 檔案描述符
+ * @param timeout_ms 超時時間(毫秒),0 表示不超時
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR 失敗
+ */
+int socket_helper_set_timeout_ms(int sockfd, int timeout_ms);
+
 /**
  * @brief 設置 socket 為非阻塞模式
  * 
@@ -107,6 +189,71 @@ int socket_helper_set_nonblocking(int sockfd);
  */
 int socket_helper_set_reuseaddr(int sockfd);
 
+/**
+ * @brief 設置 SO_REUSEPORT,讓多個 socket 綁定同一埠號並由 kernel 分配連線
+ * 
+ * @param sockfd Socket 檔案描述符 (需在 bind 之前設置)
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR 失敗 (kernel 不支援)
+ */
+int socket_helper_set_reuseport(int sockfd);
+
+/**
+ * @brief 設置 TCP_NODELAY (關閉 Nagle,小封包立即送出)
+ * 
+ * @param sockfd TCP socket
+ * @param enable true 關閉 Nagle
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR 失敗
+ */
+int socket_helper_set_nodelay(int sockfd, bool enable);
+
+/**
+ * @brief 設置 TCP_QUICKACK (收到資料立即 ACK,不延遲)
+ * 
+ * kernel 會在連線狀態改變時自行關閉,需要持續生效時應在每次 recv 後再呼叫
+ * 
+ * @param sockfd TCP socket
+ * @param enable true 立即 ACK
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR 失敗
+ */
+int socket_helper_set_quickack(int sockfd, bool enable);
+
+/**
+ * @brief 取得預設選項組合的內容
+ * 
+ * @param profile 選項組合
+ * @param options 輸出的選項
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ */
+int socket_helper_profile_options(socket_profile_t profile, socket_options_t *options);
+
+/**
+ * @brief 套用個別選項
+ * 
+ * 會嘗試套用所有指定的選項,單一選項失敗時記錄警告並繼續
+ * 
+ * @param sockfd Socket 檔案描述符
+ * @param options 選項 (SOCKET_OPT_UNSET 的欄位不變更)
+ * @return GAMING_OK 全部成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR 至少一個選項套用失敗
+ */
+int socket_helper_apply_options(int sockfd, const socket_options_t *options);
+
+/**
+ * @brief 套用預設選項組合
+ * 
+ * 連線建立後呼叫 (client 在 connect 之後,server 在 accept 之後)
+ * 
+ * @param sockfd Socket 檔案描述符
+ * @param profile 選項組合
+ * @return 同 socket_helper_apply_options()
+ */
+int socket_helper_apply_profile(int sockfd, socket_profile_t profile);
+
 /**
  * @brief 發送資料
  * 
@@ -129,6 +276,37 @@ ssize_t socket_helper_send(int sockfd, const void *data, size_t len);
  */
 ssize_t socket_helper_recv(int sockfd, void *buffer, size_t len);
 
+/**
+ * @brief 發送全部資料
+ * 
+ * 處理部分寫入、EINTR 與 EAGAIN (阻塞或非阻塞 socket 皆可),
+ * 在期限內送完 len 位元組
+ * 
+ * @param sockfd Socket 檔案描述符
+ * @param data 資料指標
+ * @param len 資料長度
+ * @param timeout_ms 整體期限(毫秒),-1 表示不限
+ * @return GAMING_OK 全部送出
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_TIMEOUT 期限內未送完
+ * @return GAMING_ERROR_IO 連線錯誤
+ */
+int socket_helper_send_all(int sockfd, const void *data, size_t len, int timeout_ms);
+
+/**
+ * @brief 接收剛好 len 位元組
+ * 
+ * @param sockfd Socket 檔案描述符
+ * @param buffer 接收緩衝區
+ * @param len 要接收的位元組數
+ * @param timeout_ms 整體期限(毫秒),-1 表示不限
+ * @return GAMING_OK 已收滿
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_TIMEOUT 期限內未收滿
+ * @return GAMING_ERROR_IO 連線錯誤或對端在收滿前關閉
+ */
+int socket_helper_recv_all(int sockfd, void *buffer, size_t len, int timeout_ms);
+
 /**
  * @brief 關閉 socket
  * 
@@ -156,4 +334,29 @@ bool socket_helper_is_readable(int sockfd, int timeout_ms);
  */
 bool socket_helper_is_writable(int sockfd, int timeout_ms);
 
+// ========================================
+// 期限 (整體逾時的共用計算)
+// ========================================
+
+/**
+ * @brief 單調時鐘 (CLOCK_MONOTONIC) 的毫秒數
+ */
+long long socket_helper_monotonic_ms(void);
+
+/**
+ * @brief 期限的絕對時間
+ * 
+ * @param timeout_ms 逾時(毫秒),-1 表示不限
+ * @return 期限 (socket_helper_monotonic_ms() 的時間基準),-1 表示不限
+ */
+long long socket_helper_deadline_after(int timeout_ms);
+
+/**
+ * @brief 距離期限的毫秒數 (poll 用)
+ * 
+ * @param deadline socket_helper_deadline_after() 的回傳值
+ * @return -1 不限, 0 已到期, > 0 剩餘毫秒數
+ */
+int socket_helper_remaining_ms(long long deadline);
+
 #endif // SOCKET_HELPER_H
@@ -0,0 +1,784 @@
+/**
+ * @file socket_server.c
+ * @brief Socket Server 實作
+ * @version 1.0.0
+ *
+ * 連線在回呼中被關閉時只做標記,回到事件處理函數後才真正釋放,
+ * 回呼返回後不會再存取已釋放的連線
+ */
+
+#define _GNU_SOURCE  // accept4
+
+#include "socket_server.h"
+#include "event_loop.h"
+#include "logger.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+
+// ========================================
+// 內部資料
+// ========================================
+
+// 單一連線最多暫存的未送出資料,超過時 socket_conn_send 回傳錯誤
+#define SOCKET_CONN_MAX_PENDING (256 * 1024)
+
+// socket_conn_sendv 最多的片段數
+#define SOCKET_CONN_MAX_IOV     8
+
+typedef struct server_worker server_worker_t;
+
+typedef struct post_task {
+    socket_server_task_fn fn;
+    void *user_data;
+    struct post_task *next;
+} post_task_t;
+
+struct socket_conn {
+    server_worker_t *worker;
+    int fd;
+
+    uint8_t *out;           // 未送出的資料 [out_off, out_len)
+    size_t out_off;
+    size_t out_len;
+    size_t out_cap;
+
+    int depth;              // 正在執行此連線回呼的層數
+    bool opened;            // on_accept 已接受 (關閉時需呼叫 on_close)
+    bool closed;
+    void *data;
+
+    socket_conn_t *prev;
+    socket_conn_t *next;
+};
+
+struct server_worker {
+    socket_server_t *server;
+    int index;
+    int listen_fd;
+    int reserve_fd;         // fd 用盡時暫時釋放,用來接受並關閉連線
+    event_loop_t *loop;
+    pthread_t thread;
+    socket_conn_t *conns;
+
+    pthread_mutex_t task_lock;  // 保護 tasks 與 accepting_tasks
+    post_task_t *task_head;
+    post_task_t *task_tail;
+    bool accepting_tasks;
+
+    uint8_t buffer[SOCKET_SERVER_READ_BUFFER_SIZE];
+};
+
+struct socket_server {
+    socket_server_config_t config;
+    char path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+    int shared_fd;          // Unix: 所有 worker 共用的監聽 socket
+    int port;
+    bool running;
+
+    uint64_t accepted;
+    uint64_t rejected;
+    uint32_t active;
+
+    server_worker_t workers[SOCKET_SERVER_MAX_WORKERS];
+};
+
+// ========================================
+// 監聽 socket
+// ========================================
+
+static int listen_unix(const char *path, int backlog) {
+    struct sockaddr_un addr;
+    size_t path_len = strnlen(path, sizeof(addr.sun_path));
+    if (path_len >= sizeof(addr.sun_path)) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "Socket path too long: %s", path);
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path, path_len + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "socket(AF_UNIX): %s", strerror(errno));
+        return -1;
+    }
+
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, backlog) < 0) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "listen %s: %s", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int listen_tcp(const char *bind_addr, int port, int backlog) {
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind_addr != NULL && inet_pton(AF_INET, bind_addr, &addr.sin_addr) <= 0) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "Invalid IPv4 address: %s", bind_addr);
+        return -1;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "socket(AF_INET): %s", strerror(errno));
+        return -1;
+    }
+
+    socket_helper_set_reuseaddr(fd);
+    if (socket_helper_set_reuseport(fd) != GAMING_OK) {
+        close(fd);
+        return -1;
+    }
+
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, backlog) < 0) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "listen port %d: %s", port, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int bound_port(int fd) {
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+
+    if (getsockname(fd, (struct sockaddr *)&addr, &len) < 0) {
+        return -1;
+    }
+    return ntohs(addr.sin_port);
+}
+
+// ========================================
+// 連線處理
+// ========================================
+
+static void conn_finalize(socket_conn_t *conn) {
+    server_worker_t *worker = conn->worker;
+    socket_server_t *server = worker->server;
+
+    event_loop_remove_fd(worker->loop, conn->fd);
+
+    if (conn->prev != NULL) {
+        conn->prev->next = conn->next;
+    } else {
+        worker->conns = conn->next;
+    }
+    if (conn->next != NULL) {
+        conn->next->prev = conn->prev;
+    }
+
+    if (conn->opened) {
+        if (server->config.on_close != NULL) {
+            server->config.on_close(conn, server->config.user_data);
+        }
+        __atomic_sub_fetch(&server->active, 1, __ATOMIC_RELAXED);
+    } else {
+        __atomic_add_fetch(&server->rejected, 1, __ATOMIC_RELAXED);
+    }
+
+    close(conn->fd);
+    free(conn->out);
+    free(conn);
+}
+
+/**
+ * @brief 標記關閉;不在此連線的回呼中時立即釋放
+ */
+static void conn_mark_closed(socket_conn_t *conn) {
+    conn->closed = true;
+    if (conn->depth == 0) {
+        conn_finalize(conn);
+    }
+}
+
+/**
+ * @brief 暫存未送出的資料
+ */
+static int conn_buffer(socket_conn_t *conn, const uint8_t *data, size_t len) {
+    size_t pending = conn->out_len - conn->out_off;
+
+    // 已送出的部分移到前面再擴充
+    if (conn->out_off > 0) {
+        memmove(conn->out, conn->out + conn->out_off, pending);
+        conn->out_off = 0;
+        conn->out_len = pending;
+    }
+    if (pending + len > conn->out_cap) {
+        size_t cap = conn->out_cap ? conn->out_cap : SOCKET_SERVER_READ_BUFFER_SIZE;
+        while (cap < pending + len) {
+            cap *= 2;
+        }
+        uint8_t *out = realloc(conn->out, cap);
+        if (out == NULL) {
+            return GAMING_ERROR_NO_MEMORY;
+        }
+        conn->out = out;
+        conn->out_cap = cap;
+    }
+
+    memcpy(conn->out + conn->out_len, data, len);
+    conn->out_len += len;
+    return GAMING_OK;
+}
+
+/**
+ * @brief 可寫時送出暫存資料,送完後停止關注 EVENT_WRITE
+ */
+static void conn_flush(socket_conn_t *conn) {
+    while (conn->out_off < conn->out_len) {
+        ssize_t n = send(conn->fd, conn->out + conn->out_off, conn->out_len - conn->out_off,
+                         MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                conn->closed = true;
+            }
+            return;
+        }
+        conn->out_off += (size_t)n;
+    }
+
+    conn->out_off = 0;
+    conn->out_len = 0;
+    event_loop_modify_fd(conn->worker->loop, conn->fd, EVENT_READ);
+}
+
+static void conn_read(socket_conn_t *conn) {
+    server_worker_t *worker = conn->worker;
+    socket_server_t *server = worker->server;
+
+    ssize_t n = recv(conn->fd, worker->buffer, sizeof(worker->buffer), 0);
+    if (n > 0) {
+        server->config.on_data(conn, worker->buffer, (size_t)n, server->config.user_data);
+    } else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        conn->closed = true;
+    }
+}
+
+static void on_conn_event(event_loop_t *loop, int fd, uint32_t events, void *user_data) {
+    socket_conn_t *conn = user_data;
+
+    conn->depth++;
+    if (events & EVENT_WRITE) {
+        conn_flush(conn);
+    }
+    if (!conn->closed && (events & (EVENT_READ | EVENT_ERROR))) {
+        conn_read(conn);
+    }
+    conn->depth--;
+
+    if (conn->closed && conn->depth == 0) {
+        conn_finalize(conn);
+    }
+}
+
+static void conn_open(server_worker_t *worker, int fd) {
+    socket_server_t *server = worker->server;
+
+    socket_conn_t *conn = calloc(1, sizeof(*conn));
+    if (conn == NULL ||
+        event_loop_add_fd(worker->loop, fd, EVENT_READ, on_conn_event, conn) != GAMING_OK) {
+        free(conn);
+        close(fd);
+        __atomic_add_fetch(&server->rejected, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    conn->worker = worker;
+    conn->fd = fd;
+    conn->next = worker->conns;
+    if (worker->conns != NULL) {
+        worker->conns->prev = conn;
+    }
+    worker->conns = conn;
+
+    if (server->config.type == SOCKET_TYPE_TCP) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    __atomic_add_fetch(&server->accepted, 1, __ATOMIC_RELAXED);
+
+    int ret = GAMING_OK;
+    if (server->config.on_accept != NULL) {
+        conn->depth++;
+        ret = server->config.on_accept(conn, server->config.user_data);
+        conn->depth--;
+    }
+
+    if (ret != GAMING_OK || conn->closed) {
+        conn_finalize(conn);
+        return;
+    }
+    conn->opened = true;
+    __atomic_add_fetch(&server->active, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief fd 用盡時釋放保留的 fd 接受並關閉一個連線,
+ *        否則監聽 socket 持續可讀,level 觸發會讓迴圈空轉
+ */
+static void shed_connection(server_worker_t *worker) {
+    logger_mod_ratelimited(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "accept: %s", strerror(errno));
+
+    if (worker->reserve_fd < 0) {
+        return;
+    }
+    close(worker->reserve_fd);
+    int fd = accept4(worker->listen_fd, NULL, NULL, SOCK_CLOEXEC);
+    if (fd >= 0) {
+        close(fd);
+        __atomic_add_fetch(&worker->server->rejected, 1, __ATOMIC_RELAXED);
+    }
+    worker->reserve_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+}
+
+static void on_listen_event(event_loop_t *loop, int fd, uint32_t events, void *user_data) {
+    server_worker_t *worker = user_data;
+    int batch = worker->server->config.accept_batch;
+
+    for (int i = 0; i < batch; i++) {
+        int conn_fd = accept4(fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (conn_fd >= 0) {
+            conn_open(worker, conn_fd);
+            continue;
+        }
+
+        switch (errno) {
+            case EINTR:
+            case ECONNABORTED:
+            case EPROTO:
+                continue;
+            case EAGAIN:
+#if EWOULDBLOCK != EAGAIN
+            case EWOULDBLOCK:
+#endif
+                return;
+            case EMFILE:
+            case ENFILE:
+                shed_connection(worker);
+                return;
+            default:
+                logger_mod_ratelimited(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR,
+                                       "accept: %s", strerror(errno));
+                return;
+        }
+    }
+}
+
+// ========================================
+// Worker
+// ========================================
+
+/**
+ * @brief 取出目前所有工作後依序執行 (執行中新加入的工作留到下次)
+ */
+static void worker_run_tasks(server_worker_t *worker) {
+    pthread_mutex_lock(&worker->task_lock);
+    post_task_t *task = worker->task_head;
+    worker->task_head = NULL;
+    worker->task_tail = NULL;
+    pthread_mutex_unlock(&worker->task_lock);
+
+    while (task != NULL) {
+        post_task_t *next = task->next;
+        task->fn(worker->server, worker->index, task->user_data);
+        free(task);
+        task = next;
+    }
+}
+
+static void on_worker_wakeup(event_loop_t *loop, void *user_data) {
+    worker_run_tasks(user_data);
+}
+
+static void worker_set_accepting(server_worker_t *worker, bool accepting) {
+    pthread_mutex_lock(&worker->task_lock);
+    worker->accepting_tasks = accepting;
+    pthread_mutex_unlock(&worker->task_lock);
+}
+
+static void* worker_main(void *arg) {
+    server_worker_t *worker = arg;
+
+    event_loop_run(worker->loop);
+    return NULL;
+}
+
+static void worker_close_conns(server_worker_t *worker) {
+    while (worker->conns != NULL) {
+        socket_conn_t *conn = worker->conns;
+        conn->depth = 0;
+        conn->closed = true;
+        conn_finalize(conn);
+    }
+}
+
+static int worker_init(socket_server_t *server, int index) {
+    server_worker_t *worker = &server->workers[index];
+    const socket_server_config_t *config = &server->config;
+
+    worker->server = server;
+    worker->index = index;
+    worker->reserve_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    pthread_mutex_init(&worker->task_lock, NULL);
+
+    worker->loop = event_loop_create();
+    if (worker->loop == NULL) {
+        return GAMING_ERROR;
+    }
+    event_loop_set_wakeup_handler(worker->loop, on_worker_wakeup, worker);
+
+    uint32_t events = EVENT_READ;
+    if (config->type == SOCKET_TYPE_UNIX) {
+        worker->listen_fd = server->shared_fd;
+        events |= EVENT_EXCLUSIVE;
+    } else {
+        // 第一個 worker 綁定後其他 worker 使用相同埠號 (port 0 時由系統分配)
+        int port = (index == 0) ? config->port : server->port;
+        worker->listen_fd = listen_tcp(config->bind_addr, port, config->backlog);
+        if (worker->listen_fd < 0) {
+            return GAMING_ERROR;
+        }
+        if (index == 0) {
+            server->port = bound_port(worker->listen_fd);
+        }
+    }
+
+    return event_loop_add_fd(worker->loop, worker->listen_fd, events, on_listen_event, worker);
+}
+
+// ========================================
+// 公開 API 實作
+// ========================================
+
+socket_server_t* socket_server_create(const socket_server_config_t *config) {
+    if (config == NULL || config->on_data == NULL ||
+        config->workers < 1 || config->workers > SOCKET_SERVER_MAX_WORKERS) {
+        return NULL;
+    }
+    if (config->type == SOCKET_TYPE_UNIX) {
+        if (config->path == NULL || config->path[0] == '\0' ||
+            strlen(config->path) >= sizeof(((struct sockaddr_un *)0)->sun_path)) {
+            return NULL;
+        }
+    } else if (config->type != SOCKET_TYPE_TCP || config->port < 0 || config->port > 65535) {
+        return NULL;
+    }
+
+    socket_server_t *server = calloc(1, sizeof(*server));
+    if (server == NULL) {
+        return NULL;
+    }
+
+    server->config = *config;
+    server->config.path = NULL;
+    server->shared_fd = -1;
+    if (server->config.backlog <= 0) {
+        server->config.backlog = SOCKET_SERVER_DEFAULT_BACKLOG;
+    }
+    if (server->config.accept_batch <= 0) {
+        server->config.accept_batch = SOCKET_SERVER_DEFAULT_ACCEPT_BATCH;
+    }
+    for (int i = 0; i < SOCKET_SERVER_MAX_WORKERS; i++) {
+        server->workers[i].listen_fd = -1;
+        server->workers[i].reserve_fd = -1;
+    }
+
+    if (config->type == SOCKET_TYPE_UNIX) {
+        strncpy(server->path, config->path, sizeof(server->path) - 1);
+        server->shared_fd = listen_unix(server->path, server->config.backlog);
+        if (server->shared_fd < 0) {
+            socket_server_destroy(server);
+            return NULL;
+        }
+    }
+
+    for (int i = 0; i < config->workers; i++) {
+        if (worker_init(server, i) != GAMING_OK) {
+            socket_server_destroy(server);
+            return NULL;
+        }
+    }
+
+    if (config->type == SOCKET_TYPE_UNIX) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_INFO, "server listening on %s (%d workers)",
+                   server->path, config->workers);
+    } else {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_INFO, "server listening on port %d (%d workers)",
+                   server->port, config->workers);
+    }
+    return server;
+}
+
+int socket_server_start(socket_server_t *server) {
+    if (server == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    if (server->running) {
+        return GAMING_ERROR_ALREADY_EXISTS;
+    }
+
+    for (int i = 0; i < server->config.workers; i++) {
+        server_worker_t *worker = &server->workers[i];
+        if (pthread_create(&worker->thread, NULL, worker_main, worker) != 0) {
+            logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "server: failed to start worker %d", i);
+            for (int j = 0; j < i; j++) {
+                worker_set_accepting(&server->workers[j], false);
+                event_loop_stop(server->workers[j].loop);
+                pthread_join(server->workers[j].thread, NULL);
+                worker_run_tasks(&server->workers[j]);
+            }
+            return GAMING_ERROR;
+        }
+        worker_set_accepting(worker, true);
+    }
+
+    server->running = true;
+    return GAMING_OK;
+}
+
+void socket_server_stop(socket_server_t *server) {
+    if (server == NULL || !server->running) {
+        return;
+    }
+
+    for (int i = 0; i < server->config.workers; i++) {
+        worker_set_accepting(&server->workers[i], false);
+        event_loop_stop(server->workers[i].loop);
+    }
+    for (int i = 0; i < server->config.workers; i++) {
+        pthread_join(server->workers[i].thread, NULL);
+    }
+    server->running = false;
+
+    // worker 已結束,在呼叫端執行緒完成剩下的工作並關閉連線
+    for (int i = 0; i < server->config.workers; i++) {
+        worker_run_tasks(&server->workers[i]);
+        worker_close_conns(&server->workers[i]);
+    }
+}
+
+void socket_server_destroy(socket_server_t *server) {
+    if (server == NULL) {
+        return;
+    }
+
+    socket_server_stop(server);
+
+    for (int i = 0; i < SOCKET_SERVER_MAX_WORKERS; i++) {
+        server_worker_t *worker = &server->workers[i];
+        if (worker->loop != NULL) {
+            worker_close_conns(worker);
+            event_loop_destroy(worker->loop);
+        }
+        if (worker->listen_fd >= 0 && worker->listen_fd != server->shared_fd) {
+            close(worker->listen_fd);
+        }
+        if (worker->reserve_fd >= 0) {
+            close(worker->reserve_fd);
+        }
+        if (worker->server != NULL) {
+            pthread_mutex_destroy(&worker->task_lock);
+        }
+    }
+
+    if (server->shared_fd >= 0) {
+        close(server->shared_fd);
+        unlink(server->path);
+    }
+    free(server);
+}
+
+int socket_server_get_port(const socket_server_t *server) {
+    if (server == NULL || server->config.type != SOCKET_TYPE_TCP) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    return server->port;
+}
+
+int socket_server_get_stats(const socket_server_t *server, socket_server_stats_t *stats) {
+    if (server == NULL || stats == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    stats->accepted = __atomic_load_n(&server->accepted, __ATOMIC_RELAXED);
+    stats->rejected = __atomic_load_n(&server->rejected, __ATOMIC_RELAXED);
+    stats->active = __atomic_load_n(&server->active, __ATOMIC_RELAXED);
+    return GAMING_OK;
+}
+
+int socket_server_worker_count(const socket_server_t *server) {
+    return server ? server->config.workers : 0;
+}
+
+int socket_server_post(socket_server_t *server, int worker, socket_server_task_fn fn,
+                       void *user_data) {
+    if (server == NULL || fn == NULL || worker < 0 || worker >= server->config.workers) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    post_task_t *task = malloc(sizeof(*task));
+    if (task == NULL) {
+        return GAMING_ERROR_NO_MEMORY;
+    }
+    task->fn = fn;
+    task->user_data = user_data;
+    task->next = NULL;
+
+    server_worker_t *w = &server->workers[worker];
+    pthread_mutex_lock(&w->task_lock);
+    if (!w->accepting_tasks) {
+        pthread_mutex_unlock(&w->task_lock);
+        free(task);
+        return GAMING_ERROR_NOT_INITIALIZED;
+    }
+    if (w->task_tail != NULL) {
+        w->task_tail->next = task;
+    } else {
+        w->task_head = task;
+    }
+    w->task_tail = task;
+    pthread_mutex_unlock(&w->task_lock);
+
+    event_loop_wakeup(w->loop);
+    return GAMING_OK;
+}
+
+// ========================================
+// 連線函數
+// ========================================
+
+int socket_conn_fd(const socket_conn_t *conn) {
+    return conn ? conn->fd : -1;
+}
+
+int socket_conn_worker(const socket_conn_t *conn) {
+    return conn ? conn->worker->index : -1;
+}
+
+int socket_conn_send(socket_conn_t *conn, const void *data, size_t len) {
+    struct iovec iov = { .iov_base = (void *)data, .iov_len = len };
+
+    if (data == NULL && len > 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    return socket_conn_sendv(conn, &iov, 1);
+}
+
+int socket_conn_sendv(socket_conn_t *conn, const struct iovec *iov, int iovcnt) {
+    if (conn == NULL || iov == NULL || iovcnt < 1 || iovcnt > SOCKET_CONN_MAX_IOV) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    if (conn->closed) {
+        return GAMING_ERROR_IO;
+    }
+
+    struct iovec vec[SOCKET_CONN_MAX_IOV];
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        if (iov[i].iov_base == NULL && iov[i].iov_len > 0) {
+            return GAMING_ERROR_INVALID_PARAM;
+        }
+        vec[i] = iov[i];
+        total += iov[i].iov_len;
+    }
+    if (total == 0) {
+        return GAMING_OK;
+    }
+
+    // 先確認最壞情況下暫存得下,避免送出一半後才失敗
+    if (socket_conn_pending(conn) + total > SOCKET_CONN_MAX_PENDING) {
+        logger_mod_ratelimited(LOG_MODULE_SOCKET, LOG_LEVEL_WARN,
+                               "conn %d: send buffer full (%zu bytes pending)",
+                               conn->fd, socket_conn_pending(conn));
+        return GAMING_ERROR_NO_MEMORY;
+    }
+
+    struct iovec *v = vec;
+    int count = iovcnt;
+
+    // 已有暫存資料時直接排在後面,維持順序
+    if (conn->out_len == 0) {
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+
+        while (count > 0) {
+            msg.msg_iov = v;
+            msg.msg_iovlen = (size_t)count;
+            ssize_t n = sendmsg(conn->fd, &msg, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                }
+                conn_mark_closed(conn);
+                return GAMING_ERROR_IO;
+            }
+
+            size_t sent = (size_t)n;
+            while (count > 0 && sent >= v->iov_len) {
+                sent -= v->iov_len;
+                v++;
+                count--;
+            }
+            if (count > 0) {
+                v->iov_base = (uint8_t *)v->iov_base + sent;
+                v->iov_len -= sent;
+            }
+        }
+        if (count == 0) {
+            return GAMING_OK;
+        }
+    }
+
+    bool was_empty = (conn->out_len == 0);
+    for (int i = 0; i < count; i++) {
+        if (conn_buffer(conn, v[i].iov_base, v[i].iov_len) != GAMING_OK) {
+            // 串流已缺資料,只能關閉;回傳 IO 與「暫存已達上限 (連線仍在)」區分
+            conn_mark_closed(conn);
+            return GAMING_ERROR_IO;
+        }
+    }
+    if (was_empty) {
+        event_loop_modify_fd(conn->worker->loop, conn->fd, EVENT_READ | EVENT_WRITE);
+    }
+    return GAMING_OK;
+}
+
+size_t socket_conn_pending(const socket_conn_t *conn) {
+    return conn ? conn->out_len - conn->out_off : 0;
+}
+
+void socket_conn_close(socket_conn_t *conn) {
+    if (conn == NULL || conn->closed) {
+        return;
+    }
+    conn_mark_closed(conn);
+}
+
+void socket_conn_set_data(socket_conn_t *conn, void *data) {
+    if (conn != NULL) {
+        conn->data = data;
+    }
+}
+
+void* socket_conn_get_data(const socket_conn_t *conn) {
+    return conn ? conn->data : NULL;
+}
@@ -0,0 +1,221 @@
+/**
+ * @file socket_server.h
+ * @brief Socket Server - 非阻塞 Unix/TCP 伺服器與多執行緒 worker
+ * @version 1.0.0
+ *
+ * 每個 worker 是一個執行緒加上自己的 event_loop:
+ *
+ * - TCP: 每個 worker 各自建立監聽 socket 並設定 SO_REUSEPORT,
+ *   由 kernel 依連線雜湊分配到各 worker,accept 不需互相競爭
+ * - Unix: 不支援 SO_REUSEPORT,所有 worker 共用同一監聽 socket,
+ *   以 EVENT_EXCLUSIVE 註冊,新連線只喚醒一個 worker
+ *
+ * 監聽 socket 為非阻塞,每次可讀時以 accept4(SOCK_NONBLOCK | SOCK_CLOEXEC)
+ * 連續接受最多 accept_batch 個連線。連線之後只由接受它的 worker 處理,
+ * 所有回呼都在該 worker 執行緒中執行,socket_conn_* 函數也只能在其中呼叫
+ *
+ * 用法:
+ *   socket_server_config_t config = SOCKET_SERVER_CONFIG_INIT;
+ *   config.type = SOCKET_TYPE_TCP;
+ *   config.port = 8080;
+ *   config.workers = 2;
+ *   config.on_data = on_data;
+ *   socket_server_t *server = socket_server_create(&config);
+ *   socket_server_start(server);
+ *   ...
+ *   socket_server_destroy(server);
+ */
+
+#ifndef SOCKET_SERVER_H
+#define SOCKET_SERVER_H
+
+#include "gaming_common.h"
+#include "socket_helper.h"
+#include <sys/types.h>
+#include <sys/uio.h>
+
+// ========================================
+// Socket Server 配置
+// ========================================
+
+// 預設連接佇列長度 (kernel 會再以 net.core.somaxconn 限制)
+#define SOCKET_SERVER_DEFAULT_BACKLOG       128
+
+// 每次可讀時最多 accept 的連線數 (避免大量連線時餓死既有連線)
+#define SOCKET_SERVER_DEFAULT_ACCEPT_BATCH  16
+
+// worker 數上限
+#define SOCKET_SERVER_MAX_WORKERS           16
+
+// 每次 recv 的緩衝區大小
+#define SOCKET_SERVER_READ_BUFFER_SIZE      SOCKET_DEFAULT_BUFFER_SIZE
+
+typedef struct socket_server socket_server_t;
+typedef struct socket_conn socket_conn_t;
+
+/**
+ * @brief 新連線回呼
+ *
+ * @return GAMING_OK 接受連線,其他值則立即關閉 (不會呼叫 on_close)
+ */
+typedef int (*socket_server_accept_cb)(socket_conn_t *conn, void *user_data);
+
+/**
+ * @brief 收到資料回呼
+ *
+ * data 指向 worker 的接收緩衝區,只在回呼期間有效,可就地修改 (例如解碼)
+ */
+typedef void (*socket_server_data_cb)(socket_conn_t *conn, uint8_t *data, size_t len,
+                                      void *user_data);
+
+/**
+ * @brief socket_server_post() 的工作函數 (在 worker 執行緒中執行)
+ */
+typedef void (*socket_server_task_fn)(socket_server_t *server, int worker, void *user_data);
+
+/**
+ * @brief 連線關閉回呼 (對端關閉、錯誤或 socket_conn_close(),之後 conn 即失效)
+ */
+typedef void (*socket_server_close_cb)(socket_conn_t *conn, void *user_data);
+
+typedef struct {
+    socket_type_t type;
+    const char *path;               ///< Unix socket 路徑
+    const char *bind_addr;          ///< TCP 綁定的 IPv4 位址,NULL 表示所有介面
+    int port;                       ///< TCP 埠號,0 表示由系統分配 (以 socket_server_get_port 取得)
+    int backlog;                    ///< 連接佇列長度,<= 0 使用預設值
+    int workers;                    ///< worker 數 (1 ~ SOCKET_SERVER_MAX_WORKERS)
+    int accept_batch;               ///< 每次可讀時最多 accept 的數量,<= 0 使用預設值
+
+    socket_server_accept_cb on_accept;  ///< 可為 NULL
+    socket_server_data_cb on_data;      ///< 必填
+    socket_server_close_cb on_close;    ///< 可為 NULL
+    void *user_data;
+} socket_server_config_t;
+
+#define SOCKET_SERVER_CONFIG_INIT { \
+    .type = SOCKET_TYPE_TCP,        \
+    .workers = 1,                   \
+}
+
+typedef struct {
+    uint64_t accepted;              ///< 累計接受的連線
+    uint64_t rejected;              ///< on_accept 拒絕或資源不足而關閉的連線
+    uint32_t active;                ///< 目前連線數
+} socket_server_stats_t;
+
+// ========================================
+// Socket Server 公開函數
+// ========================================
+
+/**
+ * @brief 建立伺服器並開始監聽 (尚未接受連線)
+ *
+ * @return 伺服器, NULL 表示參數錯誤或建立監聽 socket 失敗
+ */
+socket_server_t* socket_server_create(const socket_server_config_t *config);
+
+/**
+ * @brief 啟動 worker 執行緒開始接受連線
+ *
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_ALREADY_EXISTS 已啟動
+ * @return GAMING_ERROR 建立執行緒失敗
+ */
+int socket_server_start(socket_server_t *server);
+
+/**
+ * @brief 停止 worker 並關閉所有連線 (每個連線都會呼叫 on_close)
+ *
+ * 不可在 worker 回呼中呼叫
+ */
+void socket_server_stop(socket_server_t *server);
+
+/**
+ * @brief 停止並釋放伺服器,Unix socket 檔案會被刪除
+ */
+void socket_server_destroy(socket_server_t *server);
+
+/**
+ * @brief 實際監聽的 TCP 埠號
+ *
+ * @return > 0 埠號, GAMING_ERROR_INVALID_PARAM 參數錯誤或非 TCP
+ */
+int socket_server_get_port(const socket_server_t *server);
+
+/**
+ * @brief 取得統計 (任何執行緒皆可呼叫)
+ */
+int socket_server_get_stats(const socket_server_t *server, socket_server_stats_t *stats);
+
+/**
+ * @brief worker 數
+ */
+int socket_server_worker_count(const socket_server_t *server);
+
+/**
+ * @brief 在指定 worker 執行緒中執行 fn (任何執行緒皆可呼叫)
+ *
+ * 其他執行緒要存取連線 (例如廣播) 時使用。工作依加入順序執行;
+ * 停止時尚未執行的工作會在 socket_server_stop() 的呼叫端執行緒中執行
+ *
+ * @return GAMING_OK 已排入
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_NOT_INITIALIZED 伺服器未啟動
+ * @return GAMING_ERROR_NO_MEMORY 記憶體不足
+ */
+int socket_server_post(socket_server_t *server, int worker, socket_server_task_fn fn,
+                       void *user_data);
+
+// ========================================
+// 連線函數 (只能在連線所屬的 worker 執行緒中呼叫)
+// ========================================
+
+/**
+ * @brief 連線的 socket fd
+ */
+int socket_conn_fd(const socket_conn_t *conn);
+
+/**
+ * @brief 處理連線的 worker 編號 (0 ~ workers - 1)
+ */
+int socket_conn_worker(const socket_conn_t *conn);
+
+/**
+ * @brief 送出資料
+ *
+ * socket 緩衝區已滿時剩餘資料會暫存在連線中,可寫時自動送出
+ *
+ * @return GAMING_OK 已送出或已暫存
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_NO_MEMORY 暫存已達上限 (對端讀取太慢,未送出任何資料,連線仍開啟)
+ * @return GAMING_ERROR_IO 連線錯誤或暫存配置失敗 (連線已關閉,不在回呼中時
+ *         on_close 已執行,之後不可再存取 conn)
+ */
+int socket_conn_send(socket_conn_t *conn, const void *data, size_t len);
+
+/**
+ * @brief 以 scatter-gather 送出多段資料 (例如標頭 + payload,不需先合併)
+ *
+ * @return 同 socket_conn_send()
+ */
+int socket_conn_sendv(socket_conn_t *conn, const struct iovec *iov, int iovcnt);
+
+/**
+ * @brief 尚未送出的暫存位元組數
+ */
+size_t socket_conn_pending(const socket_conn_t *conn);
+
+/**
+ * @brief 關閉連線並呼叫 on_close (可在回呼中呼叫)
+ */
+void socket_conn_close(socket_conn_t *conn);
+
+/**
+ * @brief 設定/取得連線的呼叫端資料
+ */
+void socket_conn_set_data(socket_conn_t *conn, void *data);
+void* socket_conn_get_data(const socket_conn_t *conn);
+
+#endif // SOCKET_SERVER_H
@@ -0,0 +1,752 @@
+/**
+ * @file state_bus.c
+ * @brief State Bus 實作
+ * @version 1.0.0
+ *
+ * broker 只有一個執行緒與一個 event_loop,所有訂閱者都在其中處理,
+ * 訊息的參考計數與佇列都不需要鎖。其他執行緒的 state_bus_publish()
+ * 經由 pending 串列交給 broker 執行緒
+ *
+ * 訂閱者的佇列存放訊息指標,不複製內容: 一則訊息發布給 N 個訂閱者
+ * 只配置一次,最後一個訂閱者送完時釋放
+ */
+
+#define _GNU_SOURCE  // accept4, MSG_NOSIGNAL
+
+#include "state_bus.h"
+#include "event_loop.h"
+#include "socket_frame.h"
+#include "socket_helper.h"
+#include "logger.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// ========================================
+// 內部資料
+// ========================================
+
+// 訊息標頭: frame 長度 + op + 主題
+#define BUS_HEADER_SIZE     (SOCKET_FRAME_HEADER_SIZE + 2)
+
+// 每次 sendmsg 最多合併的訊息數
+#define BUS_MAX_IOV         16
+
+// 每次可讀時最多 accept 的連線數
+#define BUS_ACCEPT_BATCH    16
+
+// 每次 recv 的緩衝區大小
+#define BUS_READ_SIZE       4096
+
+/**
+ * @brief 編碼完成、可直接寫出的訊息 (含 frame 標頭)
+ */
+typedef struct bus_msg {
+    int refs;
+    state_topic_t topic;
+    struct bus_msg *next;       // pending 串列
+    size_t len;
+    uint8_t data[];
+} bus_msg_t;
+
+typedef struct subscriber {
+    state_bus_t *bus;
+    int fd;
+    uint32_t topics;
+    socket_frame_reader_t *reader;
+
+    int head;                   // 佇列 (環狀) 起點
+    int count;
+    size_t offset;              // queue[head] 已送出的位元組
+    bool want_write;            // 已註冊 EVENT_WRITE
+    bool in_read;               // 正在處理此訂閱者送來的訊息
+    bool closed;                // in_read 期間被關閉,返回後釋放
+
+    struct subscriber *prev;
+    struct subscriber *next;
+    bus_msg_t *queue[];
+} subscriber_t;
+
+struct state_bus {
+    state_bus_config_t config;
+    char path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+    int listen_fd;
+    event_loop_t *loop;
+    pthread_t thread;
+    bool running;
+
+    pthread_mutex_t lock;       // 保護 pending 與 accepting
+    bus_msg_t *pending_head;
+    bus_msg_t *pending_tail;
+    bool accepting;
+
+    bus_msg_t *last[STATE_TOPIC_COUNT];     // 各主題最新的訊息
+    subscriber_t *subs;
+
+    uint64_t published;
+    uint64_t delivered;
+    uint64_t dropped;
+    uint64_t disconnected;
+    uint32_t subscribers;
+};
+
+// ========================================
+// 訊息
+// ========================================
+
+static bus_msg_t* msg_create(int op, int topic, const void *data, size_t len) {
+    bus_msg_t *msg = malloc(sizeof(*msg) + BUS_HEADER_SIZE + len);
+    if (msg == NULL) {
+        return NULL;
+    }
+
+    msg->refs = 1;
+    msg->topic = (state_topic_t)topic;
+    msg->next = NULL;
+    msg->len = BUS_HEADER_SIZE + len;
+    socket_frame_encode_header(msg->data, (uint32_t)(len + 2));
+    msg->data[SOCKET_FRAME_HEADER_SIZE] = (uint8_t)op;
+    msg->data[SOCKET_FRAME_HEADER_SIZE + 1] = (uint8_t)topic;
+    if (len > 0) {
+        memcpy(msg->data + BUS_HEADER_SIZE, data, len);
+    }
+    return msg;
+}
+
+static void msg_release(bus_msg_t *msg) {
+    if (msg != NULL && --msg->refs == 0) {
+        free(msg);
+    }
+}
+
+// ========================================
+// 訂閱者
+// ========================================
+
+static void sub_free(subscriber_t *sub) {
+    state_bus_t *bus = sub->bus;
+    int cap = bus->config.queue_len;
+
+    event_loop_remove_fd(bus->loop, sub->fd);
+    close(sub->fd);
+
+    for (int i = 0; i < sub->count; i++) {
+        msg_release(sub->queue[(sub->head + i) % cap]);
+    }
+    socket_frame_reader_destroy(sub->reader);
+
+    if (sub->prev != NULL) {
+        sub->prev->next = sub->next;
+    } else {
+        bus->subs = sub->next;
+    }
+    if (sub->next != NULL) {
+        sub->next->prev = sub->prev;
+    }
+
+    free(sub);
+    __atomic_sub_fetch(&bus->subscribers, 1, __ATOMIC_RELAXED);
+}
+
+static void sub_close(subscriber_t *sub) {
+    if (sub->in_read) {
+        sub->closed = true;
+    } else {
+        sub_free(sub);
+    }
+}
+
+static void sub_set_write(subscriber_t *sub, bool want_write) {
+    if (sub->want_write != want_write) {
+        sub->want_write = want_write;
+        event_loop_modify_fd(sub->bus->loop, sub->fd,
+                             EVENT_READ | (want_write ? EVENT_WRITE : 0));
+    }
+}
+
+static void sub_pop(subscriber_t *sub) {
+    msg_release(sub->queue[sub->head]);
+    sub->head = (sub->head + 1) % sub->bus->config.queue_len;
+    sub->count--;
+    sub->offset = 0;
+}
+
+/**
+ * @brief 以 sendmsg 一次寫出佇列中的多則訊息,直到寫完或 EAGAIN
+ *
+ * @return GAMING_OK 成功 (可能尚有資料等待可寫), GAMING_ERROR_IO 連線錯誤
+ */
+static int sub_flush(subscriber_t *sub) {
+    int cap = sub->bus->config.queue_len;
+
+    while (sub->count > 0) {
+        struct iovec iov[BUS_MAX_IOV];
+        int n = 0;
+
+        for (; n < sub->count && n < BUS_MAX_IOV; n++) {
+            bus_msg_t *msg = sub->queue[(sub->head + n) % cap];
+            size_t off = (n == 0) ? sub->offset : 0;
+            iov[n].iov_base = msg->data + off;
+            iov[n].iov_len = msg->len - off;
+        }
+
+        struct msghdr mh = { .msg_iov = iov, .msg_iovlen = (size_t)n };
+        ssize_t sent = sendmsg(sub->fd, &mh, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                sub_set_write(sub, true);
+                return GAMING_OK;
+            }
+            return GAMING_ERROR_IO;
+        }
+
+        size_t left = (size_t)sent;
+        while (left > 0) {
+            size_t rest = sub->queue[sub->head]->len - sub->offset;
+            if (left < rest) {
+                sub->offset += left;
+                break;
+            }
+            left -= rest;
+            sub_pop(sub);
+        }
+    }
+
+    sub_set_write(sub, false);
+    return GAMING_OK;
+}
+
+/**
+ * @brief 放入訂閱者佇列 (尚未寫出),佇列已滿時依 overflow 策略處理
+ */
+static void sub_enqueue(subscriber_t *sub, bus_msg_t *msg) {
+    state_bus_t *bus = sub->bus;
+    int cap = bus->config.queue_len;
+
+    if (sub->closed) {
+        return;
+    }
+
+    if (sub->count == cap) {
+        switch (bus->config.overflow) {
+            case STATE_BUS_DROP_OLDEST:
+                if (sub->offset == 0) {
+                    sub_pop(sub);
+                } else if (cap > 1) {
+                    // 最舊的一則已送出一部分,保留它,丟掉下一則
+                    int second = (sub->head + 1) % cap;
+                    msg_release(sub->queue[second]);
+                    sub->queue[second] = sub->queue[sub->head];
+                    sub->head = second;
+                    sub->count--;
+                } else {
+                    __atomic_add_fetch(&bus->dropped, 1, __ATOMIC_RELAXED);
+                    return;
+                }
+                break;
+
+            case STATE_BUS_DROP_NEWEST:
+                __atomic_add_fetch(&bus->dropped, 1, __ATOMIC_RELAXED);
+                return;
+
+            case STATE_BUS_DISCONNECT:
+            default:
+                logger_mod_ratelimited(LOG_MODULE_SOCKET, LOG_LEVEL_WARN,
+                                       "state_bus: disconnecting slow subscriber fd %d", sub->fd);
+                __atomic_add_fetch(&bus->disconnected, 1, __ATOMIC_RELAXED);
+                sub_close(sub);
+                return;
+        }
+        __atomic_add_fetch(&bus->dropped, 1, __ATOMIC_RELAXED);
+    }
+
+    msg->refs++;
+    sub->queue[(sub->head + sub->count) % cap] = msg;
+    sub->count++;
+    __atomic_add_fetch(&bus->delivered, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 把 msg 放入所有訂閱該主題的佇列,並更新最新值
+ */
+static void bus_fanout(state_bus_t *bus, bus_msg_t *msg) {
+    uint32_t mask = STATE_TOPIC_MASK(msg->topic);
+
+    msg->refs++;
+    msg_release(bus->last[msg->topic]);
+    bus->last[msg->topic] = msg;
+
+    for (subscriber_t *sub = bus->subs, *next; sub != NULL; sub = next) {
+        next = sub->next;
+        if (sub->topics & mask) {
+            sub_enqueue(sub, msg);
+        }
+    }
+    __atomic_add_fetch(&bus->published, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 寫出所有未等待可寫的佇列 (每個訂閱者一次 sendmsg)
+ */
+static void bus_flush_all(state_bus_t *bus) {
+    for (subscriber_t *sub = bus->subs, *next; sub != NULL; sub = next) {
+        next = sub->next;
+        if (sub->count > 0 && !sub->want_write && !sub->closed &&
+            sub_flush(sub) != GAMING_OK) {
+            __atomic_add_fetch(&bus->disconnected, 1, __ATOMIC_RELAXED);
+            sub_close(sub);
+        }
+    }
+}
+
+static int on_sub_frame(const uint8_t *payload, size_t len, void *user_data) {
+    subscriber_t *sub = user_data;
+    state_bus_t *bus = sub->bus;
+
+    if (len < 2) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    int op = payload[0];
+    int arg = payload[1];
+
+    switch (op) {
+        case STATE_BUS_OP_SUBSCRIBE: {
+            // 先確認,再補上各主題目前的狀態
+            bus_msg_t *ack = msg_create(STATE_BUS_OP_SUBSCRIBE, arg, NULL, 0);
+            if (ack == NULL) {
+                return GAMING_ERROR_NO_MEMORY;
+            }
+            sub->topics = (uint32_t)arg & STATE_TOPIC_ALL;
+            sub_enqueue(sub, ack);
+            msg_release(ack);
+            for (int t = 0; t < STATE_TOPIC_COUNT; t++) {
+                if ((sub->topics & STATE_TOPIC_MASK(t)) && bus->last[t] != NULL) {
+                    sub_enqueue(sub, bus->last[t]);
+                }
+            }
+            return GAMING_OK;
+        }
+
+        case STATE_BUS_OP_PUBLISH: {
+            if (arg >= STATE_TOPIC_COUNT) {
+                return GAMING_ERROR_INVALID_PARAM;
+            }
+            bus_msg_t *msg = msg_create(STATE_BUS_OP_PUBLISH, arg, payload + 2, len - 2);
+            if (msg == NULL) {
+                return GAMING_ERROR_NO_MEMORY;
+            }
+            bus_fanout(bus, msg);
+            msg_release(msg);
+            return GAMING_OK;
+        }
+
+        default:
+            return GAMING_ERROR_INVALID_PARAM;
+    }
+}
+
+static void on_sub_event(event_loop_t *loop, int fd, uint32_t events, void *user_data) {
+    subscriber_t *sub = user_data;
+    state_bus_t *bus = sub->bus;
+
+    if ((events & EVENT_WRITE) && sub_flush(sub) != GAMING_OK) {
+        sub_free(sub);
+        return;
+    }
+    if (!(events & (EVENT_READ | EVENT_ERROR))) {
+        return;
+    }
+
+    uint8_t buffer[BUS_READ_SIZE];
+    ssize_t n = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return;
+    }
+    if (n <= 0) {
+        sub_free(sub);
+        return;
+    }
+
+    sub->in_read = true;
+    int ret = socket_frame_reader_feed(sub->reader, buffer, (size_t)n, on_sub_frame, sub);
+    sub->in_read = false;
+
+    if (ret != GAMING_OK || sub->closed) {
+        if (ret != GAMING_OK) {
+            logger_mod_ratelimited(LOG_MODULE_SOCKET, LOG_LEVEL_WARN,
+                                   "state_bus: invalid message from fd %d", fd);
+        }
+        sub_free(sub);
+    }
+    bus_flush_all(bus);
+}
+
+static void sub_open(state_bus_t *bus, int fd) {
+    subscriber_t *sub = calloc(1, sizeof(*sub) +
+                               (size_t)bus->config.queue_len * sizeof(bus_msg_t *));
+    if (sub == NULL) {
+        close(fd);
+        return;
+    }
+
+    sub->bus = bus;
+    sub->fd = fd;
+    sub->reader = socket_frame_reader_create(bus->config.max_payload + 2);
+    if (sub->reader == NULL ||
+        event_loop_add_fd(bus->loop, fd, EVENT_READ, on_sub_event, sub) != GAMING_OK) {
+        socket_frame_reader_destroy(sub->reader);
+        free(sub);
+        close(fd);
+        return;
+    }
+
+    sub->next = bus->subs;
+    if (sub->next != NULL) {
+        sub->next->prev = sub;
+    }
+    bus->subs = sub;
+    __atomic_add_fetch(&bus->subscribers, 1, __ATOMIC_RELAXED);
+}
+
+// ========================================
+// broker 執行緒
+// ========================================
+
+static void on_listen_event(event_loop_t *loop, int fd, uint32_t events, void *user_data) {
+    state_bus_t *bus = user_data;
+
+    for (int i = 0; i < BUS_ACCEPT_BATCH; i++) {
+        int conn_fd = accept4(fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (conn_fd >= 0) {
+            sub_open(bus, conn_fd);
+            continue;
+        }
+        if (errno == EINTR || errno == ECONNABORTED) {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            logger_mod_ratelimited(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR,
+                                   "state_bus accept: %s", strerror(errno));
+        }
+        return;
+    }
+}
+
+static bus_msg_t* take_pending(state_bus_t *bus) {
+    pthread_mutex_lock(&bus->lock);
+    bus_msg_t *head = bus->pending_head;
+    bus->pending_head = NULL;
+    bus->pending_tail = NULL;
+    pthread_mutex_unlock(&bus->lock);
+    return head;
+}
+
+/**
+ * @brief 發布其他執行緒排入的訊息,全部放入佇列後才寫出
+ */
+static void run_pending(state_bus_t *bus) {
+    bus_msg_t *msg = take_pending(bus);
+
+    while (msg != NULL) {
+        bus_msg_t *next = msg->next;
+        bus_fanout(bus, msg);
+        msg_release(msg);
+        msg = next;
+    }
+    bus_flush_all(bus);
+}
+
+static void on_bus_wakeup(event_loop_t *loop, void *user_data) {
+    run_pending(user_data);
+}
+
+static void* bus_main(void *arg) {
+    state_bus_t *bus = arg;
+    event_loop_run(bus->loop);
+    return NULL;
+}
+
+// ========================================
+// Broker 公開函數
+// ========================================
+
+state_bus_t* state_bus_create(const state_bus_config_t *config) {
+    // 佇列至少要放得下訂閱確認與各主題的最新狀態
+    if (config == NULL || config->path == NULL ||
+        strlen(config->path) >= sizeof(((struct sockaddr_un *)0)->sun_path) ||
+        config->queue_len < STATE_TOPIC_COUNT + 1 || config->max_payload == 0 ||
+        config->overflow > STATE_BUS_DISCONNECT) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "state_bus_create: invalid config");
+        return NULL;
+    }
+
+    state_bus_t *bus = calloc(1, sizeof(*bus));
+    if (bus == NULL) {
+        return NULL;
+    }
+
+    bus->config = *config;
+    strcpy(bus->path, config->path);
+    bus->config.path = bus->path;
+    pthread_mutex_init(&bus->lock, NULL);
+
+    bus->loop = event_loop_create();
+    bus->listen_fd = socket_helper_create_unix(bus->path);
+    if (bus->loop == NULL || bus->listen_fd < 0 ||
+        socket_helper_set_nonblocking(bus->listen_fd) != GAMING_OK ||
+        event_loop_add_fd(bus->loop, bus->listen_fd, EVENT_READ, on_listen_event, bus) != GAMING_OK) {
+        if (bus->listen_fd >= 0) {
+            close(bus->listen_fd);
+            unlink(bus->path);
+        }
+        event_loop_destroy(bus->loop);
+        pthread_mutex_destroy(&bus->lock);
+        free(bus);
+        return NULL;
+    }
+    event_loop_set_wakeup_handler(bus->loop, on_bus_wakeup, bus);
+
+    logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_INFO, "state_bus listening on %s", bus->path);
+    return bus;
+}
+
+int state_bus_start(state_bus_t *bus) {
+    if (bus == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    if (bus->running) {
+        return GAMING_ERROR_ALREADY_EXISTS;
+    }
+
+    pthread_mutex_lock(&bus->lock);
+    bus->accepting = true;
+    pthread_mutex_unlock(&bus->lock);
+
+    if (pthread_create(&bus->thread, NULL, bus_main, bus) != 0) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "state_bus: pthread_create failed");
+        pthread_mutex_lock(&bus->lock);
+        bus->accepting = false;
+        pthread_mutex_unlock(&bus->lock);
+        return GAMING_ERROR;
+    }
+
+    bus->running = true;
+    return GAMING_OK;
+}
+
+void state_bus_stop(state_bus_t *bus) {
+    if (bus == NULL || !bus->running) {
+        return;
+    }
+
+    pthread_mutex_lock(&bus->lock);
+    bus->accepting = false;
+    pthread_mutex_unlock(&bus->lock);
+
+    event_loop_stop(bus->loop);
+    pthread_join(bus->thread, NULL);
+    bus->running = false;
+
+    // 已排入的訊息仍更新最新值,重新啟動後的訂閱者會收到
+    run_pending(bus);
+    while (bus->subs != NULL) {
+        sub_free(bus->subs);
+    }
+}
+
+void state_bus_destroy(state_bus_t *bus) {
+    if (bus == NULL) {
+        return;
+    }
+
+    state_bus_stop(bus);
+    for (int t = 0; t < STATE_TOPIC_COUNT; t++) {
+        msg_release(bus->last[t]);
+    }
+
+    event_loop_destroy(bus->loop);
+    close(bus->listen_fd);
+    unlink(bus->path);
+    pthread_mutex_destroy(&bus->lock);
+    free(bus);
+}
+
+int state_bus_publish(state_bus_t *bus, state_topic_t topic, const void *data, size_t len) {
+    if (bus == NULL || (unsigned)topic >= STATE_TOPIC_COUNT || (data == NULL && len > 0) ||
+        len > bus->config.max_payload) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    bus_msg_t *msg = msg_create(STATE_BUS_OP_PUBLISH, topic, data, len);
+    if (msg == NULL) {
+        return GAMING_ERROR_NO_MEMORY;
+    }
+
+    pthread_mutex_lock(&bus->lock);
+    if (!bus->accepting) {
+        pthread_mutex_unlock(&bus->lock);
+        free(msg);
+        return GAMING_ERROR_NOT_INITIALIZED;
+    }
+    if (bus->pending_tail != NULL) {
+        bus->pending_tail->next = msg;
+    } else {
+        bus->pending_head = msg;
+    }
+    bus->pending_tail = msg;
+    pthread_mutex_unlock(&bus->lock);
+
+    event_loop_wakeup(bus->loop);
+    return GAMING_OK;
+}
+
+int state_bus_get_stats(const state_bus_t *bus, state_bus_stats_t *stats) {
+    if (bus == NULL || stats == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    stats->published = __atomic_load_n(&bus->published, __ATOMIC_RELAXED);
+    stats->delivered = __atomic_load_n(&bus->delivered, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&bus->dropped, __ATOMIC_RELAXED);
+    stats->disconnected = __atomic_load_n(&bus->disconnected, __ATOMIC_RELAXED);
+    stats->subscribers = __atomic_load_n(&bus->subscribers, __ATOMIC_RELAXED);
+    return GAMING_OK;
+}
+
+// ========================================
+// 客戶端
+// ========================================
+
+// 連線時等待訂閱確認的期限
+#define CLIENT_SUBSCRIBE_TIMEOUT_MS 1000
+
+struct state_bus_client {
+    int fd;
+    socket_frame_reader_t *reader;
+};
+
+typedef struct {
+    state_bus_message_cb callback;
+    void *user_data;
+} client_dispatch_t;
+
+state_bus_client_t* state_bus_client_connect(const char *path, uint32_t topics) {
+    if (path == NULL || (topics & ~STATE_TOPIC_ALL) != 0) {
+        return NULL;
+    }
+
+    state_bus_client_t *client = calloc(1, sizeof(*client));
+    if (client == NULL) {
+        return NULL;
+    }
+
+    client->reader = socket_frame_reader_create(0);
+    client->fd = socket_helper_connect_unix(path);
+    if (client->reader == NULL || client->fd < 0) {
+        state_bus_client_close(client);
+        return NULL;
+    }
+
+    if (topics != 0) {
+        uint8_t request[2] = { STATE_BUS_OP_SUBSCRIBE, (uint8_t)topics };
+        uint8_t ack[2];
+        size_t len = 0;
+
+        // 確認之後的訊息留在 socket 中,由 state_bus_client_read 讀取
+        if (socket_frame_send(client->fd, request, sizeof(request), 0,
+                              CLIENT_SUBSCRIBE_TIMEOUT_MS) != GAMING_OK ||
+            socket_frame_recv(client->fd, ack, sizeof(ack), &len,
+                              CLIENT_SUBSCRIBE_TIMEOUT_MS) != GAMING_OK ||
+            len != sizeof(ack) || ack[0] != STATE_BUS_OP_SUBSCRIBE) {
+            logger_mod_ratelimited(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR,
+                                   "state_bus: subscribe to %s failed", path);
+            state_bus_client_close(client);
+            return NULL;
+        }
+    }
+
+    return client;
+}
+
+void state_bus_client_close(state_bus_client_t *client) {
+    if (client == NULL) {
+        return;
+    }
+    if (client->fd >= 0) {
+        close(client->fd);
+    }
+    socket_frame_reader_destroy(client->reader);
+    free(client);
+}
+
+int state_bus_client_fd(const state_bus_client_t *client) {
+    return (client != NULL) ? client->fd : -1;
+}
+
+int state_bus_client_publish(state_bus_client_t *client, state_topic_t topic,
+                             const void *data, size_t len, int timeout_ms) {
+    if (client == NULL || (unsigned)topic >= STATE_TOPIC_COUNT || (data == NULL && len > 0)) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint8_t local[256];
+    uint8_t *payload = (len + 2 <= sizeof(local)) ? local : malloc(len + 2);
+    if (payload == NULL) {
+        return GAMING_ERROR_NO_MEMORY;
+    }
+
+    payload[0] = STATE_BUS_OP_PUBLISH;
+    payload[1] = (uint8_t)topic;
+    if (len > 0) {
+        memcpy(payload + 2, data, len);
+    }
+    int ret = socket_frame_send(client->fd, payload, len + 2, 0, timeout_ms);
+
+    if (payload != local) {
+        free(payload);
+    }
+    return ret;
+}
+
+static int on_client_frame(const uint8_t *payload, size_t len, void *user_data) {
+    client_dispatch_t *dispatch = user_data;
+
+    if (len < 2 || payload[0] != STATE_BUS_OP_PUBLISH || payload[1] >= STATE_TOPIC_COUNT) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    if (dispatch->callback != NULL) {
+        dispatch->callback((state_topic_t)payload[1], payload + 2, len - 2, dispatch->user_data);
+    }
+    return GAMING_OK;
+}
+
+int state_bus_client_read(state_bus_client_t *client, state_bus_message_cb callback,
+                          void *user_data, int timeout_ms) {
+    if (client == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    if (!socket_helper_is_readable(client->fd, timeout_ms)) {
+        return GAMING_ERROR_TIMEOUT;
+    }
+
+    uint8_t buffer[BUS_READ_SIZE];
+    ssize_t n = recv(client->fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return GAMING_ERROR_TIMEOUT;
+    }
+    if (n <= 0) {
+        return GAMING_ERROR_IO;
+    }
+
+    client_dispatch_t dispatch = { .callback = callback, .user_data = user_data };
+    return socket_frame_reader_feed(client->reader, buffer, (size_t)n, on_client_frame, &dispatch);
+}
@@ -0,0 +1,190 @@
+/**
+ * @file state_bus.h
+ * @brief State Bus - Unix socket 發布/訂閱狀態匯流排
+ * @version 1.0.0
+ *
+ * 取代各程序之間零散的狀態 socket (vpn_status.sock、gaming_button.sock 等):
+ * client / server / VPN helper / UI 都連到同一個 broker,依主題訂閱
+ *
+ * - 每則發布的訊息只編碼一次,以參考計數的緩衝區放入所有訂閱者的佇列,
+ *   寫出時以 sendmsg() 一次送出佇列中多則訊息,socket 為非阻塞
+ * - 每個訂閱者的佇列長度有上限,滿了依 overflow 策略處理慢速訂閱者
+ * - broker 保留每個主題最新的訊息,新訂閱者會先收到目前狀態
+ *
+ * 線路格式為 socket_frame 的長度前綴訊息,payload 為
+ * [op (1 byte)][主題或主題遮罩 (1 byte)][資料]
+ *
+ * 用法 (broker):
+ *   state_bus_config_t config = STATE_BUS_CONFIG_INIT;
+ *   state_bus_t *bus = state_bus_create(&config);
+ *   state_bus_start(bus);
+ *   state_bus_publish(bus, STATE_TOPIC_PS5, "on", 2);
+ *
+ * 用法 (訂閱者):
+ *   state_bus_client_t *client = state_bus_client_connect(PATH_STATE_BUS_SOCKET,
+ *                                    STATE_TOPIC_MASK(STATE_TOPIC_VPN));
+ *   state_bus_client_read(client, on_message, NULL, 1000);
+ */
+
+#ifndef STATE_BUS_H
+#define STATE_BUS_H
+
+#include "gaming_common.h"
+#include <sys/types.h>
+
+// ========================================
+// State Bus 配置
+// ========================================
+
+// 預設單則訊息資料上限
+#define STATE_BUS_DEFAULT_MAX_PAYLOAD   1024
+
+// 預設每個訂閱者的佇列長度
+#define STATE_BUS_DEFAULT_QUEUE_LEN     64
+
+// 線路 op
+#define STATE_BUS_OP_SUBSCRIBE  1   ///< 訂閱 (主題欄位為遮罩),broker 以相同 frame 確認
+#define STATE_BUS_OP_PUBLISH    2   ///< 發布 / 投遞
+
+typedef enum {
+    STATE_TOPIC_PS5 = 0,        ///< PS5 電源 / 網路狀態
+    STATE_TOPIC_VPN,            ///< VPN 連線狀態
+    STATE_TOPIC_BUTTON,         ///< 按鈕事件
+    STATE_TOPIC_LED,            ///< LED 狀態
+    STATE_TOPIC_COUNT
+} state_topic_t;
+
+#define STATE_TOPIC_MASK(topic) (1u << (topic))
+#define STATE_TOPIC_ALL         ((1u << STATE_TOPIC_COUNT) - 1)
+
+/**
+ * @brief 訂閱者佇列已滿時的處理方式
+ */
+typedef enum {
+    STATE_BUS_DROP_OLDEST = 0,  ///< 丟掉最舊的一則 (狀態只需要最新值)
+    STATE_BUS_DROP_NEWEST,      ///< 丟掉新訊息 (事件需要保持順序時)
+    STATE_BUS_DISCONNECT,       ///< 中斷該訂閱者,由其重新連線後取得最新狀態
+} state_bus_overflow_t;
+
+typedef struct state_bus state_bus_t;
+typedef struct state_bus_client state_bus_client_t;
+
+typedef struct {
+    const char *path;               ///< Unix socket 路徑
+    int queue_len;                  ///< 每個訂閱者的佇列長度
+    state_bus_overflow_t overflow;  ///< 佇列已滿時的策略
+    size_t max_payload;             ///< 單則訊息資料上限
+} state_bus_config_t;
+
+#define STATE_BUS_CONFIG_INIT {                         \
+    .path = PATH_STATE_BUS_SOCKET,                      \
+    .queue_len = STATE_BUS_DEFAULT_QUEUE_LEN,           \
+    .overflow = STATE_BUS_DROP_OLDEST,                  \
+    .max_payload = STATE_BUS_DEFAULT_MAX_PAYLOAD,       \
+}
+
+typedef struct {
+    uint64_t published;             ///< 累計發布的訊息
+    uint64_t delivered;             ///< 累計放入訂閱者佇列的次數
+    uint64_t dropped;               ///< 因佇列已滿而丟棄的次數
+    uint64_t disconnected;          ///< 因佇列已滿或寫入錯誤而中斷的訂閱者
+    uint32_t subscribers;           ///< 目前連線數
+} state_bus_stats_t;
+
+/**
+ * @brief 收到訊息回呼 (data 只在回呼期間有效)
+ */
+typedef void (*state_bus_message_cb)(state_topic_t topic, const uint8_t *data, size_t len,
+                                     void *user_data);
+
+// ========================================
+// Broker 公開函數
+// ========================================
+
+/**
+ * @brief 建立 broker 並開始監聽
+ *
+ * @return broker, NULL 表示參數錯誤或監聽失敗
+ */
+state_bus_t* state_bus_create(const state_bus_config_t *config);
+
+/**
+ * @brief 啟動 broker 執行緒
+ *
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_ALREADY_EXISTS 已啟動
+ * @return GAMING_ERROR 建立執行緒失敗
+ */
+int state_bus_start(state_bus_t *bus);
+
+/**
+ * @brief 停止 broker 並中斷所有連線
+ */
+void state_bus_stop(state_bus_t *bus);
+
+/**
+ * @brief 停止並釋放 broker,socket 檔案會被刪除
+ */
+void state_bus_destroy(state_bus_t *bus);
+
+/**
+ * @brief 由 broker 所在程序發布 (任何執行緒皆可呼叫)
+ *
+ * @return GAMING_OK 已排入
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤或超過 max_payload
+ * @return GAMING_ERROR_NOT_INITIALIZED broker 未啟動
+ * @return GAMING_ERROR_NO_MEMORY 記憶體不足
+ */
+int state_bus_publish(state_bus_t *bus, state_topic_t topic, const void *data, size_t len);
+
+/**
+ * @brief 取得統計 (任何執行緒皆可呼叫)
+ */
+int state_bus_get_stats(const state_bus_t *bus, state_bus_stats_t *stats);
+
+// ========================================
+// 客戶端公開函數
+// ========================================
+
+/**
+ * @brief 連線到 broker 並訂閱
+ *
+ * 回傳時訂閱已生效,之後發布的訊息都會收到
+ *
+ * @param topics 主題遮罩 (STATE_TOPIC_MASK 的組合),0 表示只發布不訂閱
+ * @return 客戶端, NULL 表示連線或訂閱失敗
+ */
+state_bus_client_t* state_bus_client_connect(const char *path, uint32_t topics);
+
+/**
+ * @brief 關閉連線並釋放
+ */
+void state_bus_client_close(state_bus_client_t *client);
+
+/**
+ * @brief 連線的 socket fd (加入呼叫端的 event_loop 時使用)
+ */
+int state_bus_client_fd(const state_bus_client_t *client);
+
+/**
+ * @brief 發布訊息
+ *
+ * @return 同 socket_frame_send() (超過 broker 的 max_payload 時 broker 會中斷連線)
+ */
+int state_bus_client_publish(state_bus_client_t *client, state_topic_t topic,
+                             const void *data, size_t len, int timeout_ms);
+
+/**
+ * @brief 等待並讀取一次,每則完整訊息呼叫 callback
+ *
+ * @param timeout_ms 等待可讀的期限(毫秒),0 表示不等待
+ * @return GAMING_OK 已讀取 (可能尚未組成完整訊息)
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤或收到無效訊息
+ * @return GAMING_ERROR_TIMEOUT 期限內沒有資料
+ * @return GAMING_ERROR_IO 連線錯誤或 broker 已關閉
+ */
+int state_bus_client_read(state_bus_client_t *client, state_bus_message_cb callback,
+                          void *user_data, int timeout_ms);
+
+#endif // STATE_BUS_H
@@ -0,0 +1,389 @@
+/**
+ * @file status_shm.c
+ * @brief Status SHM 實作
+ * @version 1.0.0
+ *
+ * 檔案內容: 64 bytes 的 shm_header_t 之後緊接 status_shm_data_t。
+ * 同一行程中的多個寫入執行緒以 mutex 互斥,跨行程只有 daemon 一個寫入端;
+ * 讀取端完全不取鎖
+ */
+
+#define _GNU_SOURCE  // CLOCK_REALTIME_COARSE
+
+#include "status_shm.h"
+#include "logger.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// ========================================
+// 檔案格式
+// ========================================
+
+#define SHM_MAGIC         "GSTATUS1"
+#define SHM_MAGIC_LEN     8
+#define SHM_VERSION       1
+
+// 讀取端連續重試多少次後讓出 CPU (寫入端可能被搶占)
+#define SHM_SPIN_BEFORE_YIELD   100
+
+typedef struct {
+    char magic[SHM_MAGIC_LEN];
+    uint32_t version;
+    uint32_t data_size;
+    uint32_t writer_pid;                        // 最後開啟的 daemon
+    uint32_t seq;                               // 奇數更新中, 偶數完成
+    uint32_t reserved[10];                      // 補齊 64 bytes,資料從新的 cache line 開始
+} shm_header_t;
+
+typedef struct {
+    shm_header_t header;
+    status_shm_data_t data;
+} shm_segment_t;
+
+struct status_shm_reader {
+    const shm_segment_t *seg;
+};
+
+// ========================================
+// 私有變數
+// ========================================
+
+static struct {
+    shm_segment_t *seg;
+    pthread_mutex_t lock;                       // 保護 seg 與寫入
+    int writing;                                // write_begin 成功後到 write_end 前為 1
+    pthread_t writer;                           // 持有 lock 的 write_begin 呼叫執行緒
+} shm = { NULL, PTHREAD_MUTEX_INITIALIZER, 0, 0 };
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+static bool header_valid(const shm_header_t *header) {
+    return memcmp(header->magic, SHM_MAGIC, SHM_MAGIC_LEN) == 0 &&
+           header->version == SHM_VERSION &&
+           header->data_size == sizeof(status_shm_data_t);
+}
+
+static uint64_t realtime_ms(void) {
+    struct timespec ts;
+#ifdef CLOCK_REALTIME_COARSE
+    clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+#else
+    clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)(ts.tv_nsec / 1000000L);
+}
+
+/**
+ * @brief 標記更新中 (序號變為奇數)
+ *
+ * 前一個寫入端在更新中當掉時序號已是奇數,維持不變
+ */
+static void seq_begin(shm_segment_t *seg) {
+    uint32_t seq = __atomic_load_n(&seg->header.seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&seg->header.seq, seq | 1u, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void seq_end(shm_segment_t *seg) {
+    seg->data.updated_ms = realtime_ms();
+    uint32_t seq = __atomic_load_n(&seg->header.seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&seg->header.seq, seq + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief 取得寫入鎖
+ * @return 映射, NULL 表示未開啟 (此時不持有鎖)
+ */
+static shm_segment_t* write_lock(void) {
+    pthread_mutex_lock(&shm.lock);
+    if (shm.seg == NULL) {
+        pthread_mutex_unlock(&shm.lock);
+        return NULL;
+    }
+    return shm.seg;
+}
+
+static void write_unlock(void) {
+    pthread_mutex_unlock(&shm.lock);
+}
+
+/**
+ * @brief 開啟狀態檔,格式不同時刪除重建 (舊讀取端保留舊檔案,不會讀到截斷的映射)
+ */
+static int open_segment_file(const char *file, bool *reuse) {
+    int fd = open(file, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat st;
+    shm_header_t old;
+    memset(&st, 0, sizeof(st));
+    *reuse = fstat(fd, &st) == 0 && (size_t)st.st_size == sizeof(shm_segment_t) &&
+             pread(fd, &old, sizeof(old), 0) == (ssize_t)sizeof(old) && header_valid(&old);
+    if (*reuse || st.st_size == 0) {
+        return fd;
+    }
+
+    close(fd);
+    unlink(file);
+    return open(file, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+}
+
+// ========================================
+// 寫入端公開函數
+// ========================================
+
+int status_shm_open(const char *path) {
+    const char *file = path ? path : STATUS_SHM_DEFAULT_PATH;
+    bool reuse = false;
+
+    pthread_mutex_lock(&shm.lock);
+    if (shm.seg != NULL) {
+        pthread_mutex_unlock(&shm.lock);
+        return GAMING_ERROR_ALREADY_EXISTS;
+    }
+
+    int fd = open_segment_file(file, &reuse);
+    if (fd < 0 || (!reuse && ftruncate(fd, sizeof(shm_segment_t)) != 0)) {
+        logger_error("Status shm: Failed to create %s: %s", file, strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+        }
+        pthread_mutex_unlock(&shm.lock);
+        return GAMING_ERROR_IO;
+    }
+
+    void *map = mmap(NULL, sizeof(shm_segment_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        logger_error("Status shm: mmap %s failed: %s", file, strerror(errno));
+        pthread_mutex_unlock(&shm.lock);
+        return GAMING_ERROR_IO;
+    }
+
+    // 沿用的檔案可能正被讀取,以一次更新清除舊狀態;新檔案最後才寫入 magic
+    shm_segment_t *seg = map;
+    if (reuse) {
+        seq_begin(seg);
+        memset(&seg->data, 0, sizeof(seg->data));
+        seg->header.writer_pid = (uint32_t)getpid();
+        seq_end(seg);
+    } else {
+        seg->header.version = SHM_VERSION;
+        seg->header.data_size = sizeof(status_shm_data_t);
+        seg->header.writer_pid = (uint32_t)getpid();
+        seg->data.updated_ms = realtime_ms();
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        memcpy(seg->header.magic, SHM_MAGIC, SHM_MAGIC_LEN);
+    }
+
+    shm.seg = seg;
+    pthread_mutex_unlock(&shm.lock);
+    return GAMING_OK;
+}
+
+void status_shm_close(void) {
+    pthread_mutex_lock(&shm.lock);
+    if (shm.seg != NULL) {
+        munmap(shm.seg, sizeof(shm_segment_t));
+        shm.seg = NULL;
+    }
+    pthread_mutex_unlock(&shm.lock);
+}
+
+bool status_shm_is_open(void) {
+    pthread_mutex_lock(&shm.lock);
+    bool open = (shm.seg != NULL);
+    pthread_mutex_unlock(&shm.lock);
+    return open;
+}
+
+status_shm_data_t* status_shm_write_begin(void) {
+    shm_segment_t *seg = write_lock();
+    if (seg == NULL) {
+        return NULL;
+    }
+
+    seq_begin(seg);
+    shm.writer = pthread_self();
+    __atomic_store_n(&shm.writing, 1, __ATOMIC_RELEASE);
+    return &seg->data;
+}
+
+int status_shm_write_end(void) {
+    // 沒有成功的 write_begin (或由其他執行緒呼叫) 時未持有 lock,不可解鎖
+    if (!__atomic_load_n(&shm.writing, __ATOMIC_ACQUIRE) ||
+        !pthread_equal(shm.writer, pthread_self())) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    __atomic_store_n(&shm.writing, 0, __ATOMIC_RELAXED);
+    seq_end(shm.seg);
+    write_unlock();
+    return GAMING_OK;
+}
+
+int status_shm_set_device_type(device_type_t type) {
+    shm_segment_t *seg = write_lock();
+    if (seg == NULL) {
+        return GAMING_ERROR_NOT_INITIALIZED;
+    }
+
+    if (seg->data.device_type != (uint32_t)type) {
+        seq_begin(seg);
+        seg->data.device_type = (uint32_t)type;
+        seq_end(seg);
+    }
+    write_unlock();
+    return GAMING_OK;
+}
+
+int status_shm_set_ps5_state(ps5_state_t state) {
+    shm_segment_t *seg = write_lock();
+    if (seg == NULL) {
+        return GAMING_ERROR_NOT_INITIALIZED;
+    }
+
+    if (seg->data.ps5_state != (uint32_t)state) {
+        seq_begin(seg);
+        seg->data.ps5_state = (uint32_t)state;
+        seq_end(seg);
+    }
+    write_unlock();
+    return GAMING_OK;
+}
+
+int status_shm_set_vpn_state(vpn_state_t state) {
+    shm_segment_t *seg = write_lock();
+    if (seg == NULL) {
+        return GAMING_ERROR_NOT_INITIALIZED;
+    }
+
+    if (seg->data.vpn_state != (uint32_t)state) {
+        seq_begin(seg);
+        seg->data.vpn_state = (uint32_t)state;
+        seq_end(seg);
+    }
+    write_unlock();
+    return GAMING_OK;
+}
+
+int status_shm_set_led(led_color_t color) {
+    shm_segment_t *seg = write_lock();
+    if (seg == NULL) {
+        return GAMING_ERROR_NOT_INITIALIZED;
+    }
+
+    if (memcmp(&seg->data.led, &color, sizeof(color)) != 0) {
+        seq_begin(seg);
+        seg->data.led = color;
+        seq_end(seg);
+    }
+    write_unlock();
+    return GAMING_OK;
+}
+
+int status_shm_add_counter(status_counter_t counter, uint64_t delta) {
+    if ((unsigned)counter >= STATUS_COUNTER_COUNT) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    shm_segment_t *seg = write_lock();
+    if (seg == NULL) {
+        return GAMING_ERROR_NOT_INITIALIZED;
+    }
+
+    if (delta != 0) {
+        seq_begin(seg);
+        seg->data.counters[counter] += delta;
+        seq_end(seg);
+    }
+    write_unlock();
+    return GAMING_OK;
+}
+
+// ========================================
+// 讀取端公開函數
+// ========================================
+
+status_shm_reader_t* status_shm_reader_open(const char *path) {
+    const char *file = path ? path : STATUS_SHM_DEFAULT_PATH;
+
+    int fd = open(file, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size != sizeof(shm_segment_t)) {
+        close(fd);
+        return NULL;
+    }
+
+    void *map = mmap(NULL, sizeof(shm_segment_t), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+
+    const shm_segment_t *seg = map;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    status_shm_reader_t *reader = header_valid(&seg->header) ? malloc(sizeof(*reader)) : NULL;
+    if (reader == NULL) {
+        munmap(map, sizeof(shm_segment_t));
+        return NULL;
+    }
+
+    reader->seg = seg;
+    return reader;
+}
+
+void status_shm_reader_close(status_shm_reader_t *reader) {
+    if (reader == NULL) {
+        return;
+    }
+    munmap((void *)reader->seg, sizeof(shm_segment_t));
+    free(reader);
+}
+
+int status_shm_read(const status_shm_reader_t *reader, status_shm_data_t *status) {
+    if (reader == NULL || status == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    const shm_segment_t *seg = reader->seg;
+    for (int i = 0; i < STATUS_SHM_READ_RETRIES; i++) {
+        uint32_t seq1 = __atomic_load_n(&seg->header.seq, __ATOMIC_ACQUIRE);
+        if ((seq1 & 1u) == 0) {
+            memcpy(status, &seg->data, sizeof(*status));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            uint32_t seq2 = __atomic_load_n(&seg->header.seq, __ATOMIC_RELAXED);
+            if (seq2 == seq1) {
+                return GAMING_OK;
+            }
+        }
+        if (i % SHM_SPIN_BEFORE_YIELD == SHM_SPIN_BEFORE_YIELD - 1) {
+            sched_yield();
+        }
+    }
+
+    return GAMING_ERROR_TIMEOUT;
+}
+
+uint32_t status_shm_sequence(const status_shm_reader_t *reader) {
+    if (reader == NULL) {
+        return 0;
+    }
+    return __atomic_load_n(&reader->seg->header.seq, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,157 @@
+/**
+ * @file status_shm.h
+ * @brief Status SHM - 以 seqlock 保護的共享記憶體狀態區
+ * @version 1.0.0
+ *
+ * daemon 把目前狀態 (裝置類型、PS5、VPN、LED 顏色、計數器) 寫在
+ * /var/run 的固定格式共享映射中,LuCI、CLI 與其他程序直接映射讀取,
+ * 不需透過 socket 詢問:
+ *
+ * - 寫入端 (daemon) 以 seqlock 更新: 序號為奇數表示更新中,完成後加一為偶數
+ * - 讀取端只做一般的記憶體讀取,序號前後一致且為偶數才採用,否則重讀,
+ *   不需系統呼叫,也不會阻擋寫入端
+ * - 值沒有改變的更新不會遞增序號,輪詢端可用 status_shm_sequence() 判斷是否變化
+ *
+ * 用法 (daemon):
+ *   status_shm_open(NULL);
+ *   status_shm_set_vpn_state(VPN_STATE_CONNECTED);
+ *
+ * 用法 (讀取端):
+ *   status_shm_reader_t *reader = status_shm_reader_open(NULL);
+ *   status_shm_data_t status;
+ *   status_shm_read(reader, &status);
+ */
+
+#ifndef STATUS_SHM_H
+#define STATUS_SHM_H
+
+#include "gaming_common.h"
+
+// ========================================
+// Status SHM 配置
+// ========================================
+
+// 預設檔案路徑
+#define STATUS_SHM_DEFAULT_PATH     "/var/run/gaming.status"
+
+// 讀取端等待寫入完成的最多重試次數 (寫入端在更新中當掉時不會無限等待)
+#define STATUS_SHM_READ_RETRIES     10000
+
+typedef enum {
+    STATUS_COUNTER_BUTTON_PRESSES = 0,  ///< 按鈕按下次數
+    STATUS_COUNTER_PS5_WAKEUPS,         ///< 喚醒 PS5 次數
+    STATUS_COUNTER_VPN_RECONNECTS,      ///< VPN 重新連線次數
+    STATUS_COUNTER_ERRORS,              ///< 錯誤次數
+    STATUS_COUNTER_COUNT
+} status_counter_t;
+
+/**
+ * @brief 共享的狀態內容 (固定格式,只使用固定寬度型別)
+ */
+typedef struct {
+    uint32_t device_type;               ///< device_type_t
+    uint32_t ps5_state;                 ///< ps5_state_t
+    uint32_t vpn_state;                 ///< vpn_state_t
+    led_color_t led;                    ///< 目前 LED 顏色
+    uint8_t reserved;
+    uint64_t updated_ms;                ///< 最後更新時間 (UNIX 毫秒)
+    uint64_t counters[STATUS_COUNTER_COUNT];
+} status_shm_data_t;
+
+typedef struct status_shm_reader status_shm_reader_t;
+
+// ========================================
+// 寫入端公開函數 (daemon)
+// ========================================
+
+/**
+ * @brief 建立 (或重新初始化) 狀態檔並映射
+ *
+ * 既有檔案格式相同時沿用同一個檔案,已開啟的讀取端會看到新內容;
+ * 格式不同時刪除後重建
+ *
+ * @param path 檔案路徑,NULL 則使用 STATUS_SHM_DEFAULT_PATH
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_ALREADY_EXISTS 已開啟
+ * @return GAMING_ERROR_IO 建立或映射檔案失敗
+ */
+int status_shm_open(const char *path);
+
+/**
+ * @brief 解除映射 (檔案保留,讀取端仍可讀到最後的狀態)
+ */
+void status_shm_close(void);
+
+/**
+ * @brief 是否已開啟
+ */
+bool status_shm_is_open(void);
+
+/**
+ * @brief 開始一次包含多個欄位的更新
+ *
+ * 必須與 status_shm_write_end() 成對呼叫,期間不可呼叫其他 status_shm_* 寫入函數
+ *
+ * @return 可寫入的狀態, NULL 表示未開啟
+ */
+status_shm_data_t* status_shm_write_begin(void);
+
+/**
+ * @brief 結束更新並更新 updated_ms
+ *
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 此執行緒沒有成功呼叫 status_shm_write_begin()
+ */
+int status_shm_write_end(void);
+
+/**
+ * @brief 更新單一欄位 (值相同時不寫入)
+ *
+ * @return GAMING_OK 成功, GAMING_ERROR_NOT_INITIALIZED 未開啟
+ */
+int status_shm_set_device_type(device_type_t type);
+int status_shm_set_ps5_state(ps5_state_t state);
+int status_shm_set_vpn_state(vpn_state_t state);
+int status_shm_set_led(led_color_t color);
+
+/**
+ * @brief 計數器加上 delta
+ *
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 計數器無效
+ * @return GAMING_ERROR_NOT_INITIALIZED 未開啟
+ */
+int status_shm_add_counter(status_counter_t counter, uint64_t delta);
+
+// ========================================
+// 讀取端公開函數
+// ========================================
+
+/**
+ * @brief 以唯讀方式映射狀態檔
+ *
+ * @param path 檔案路徑,NULL 則使用 STATUS_SHM_DEFAULT_PATH
+ * @return 讀取端, NULL 表示檔案不存在或格式不符
+ */
+status_shm_reader_t* status_shm_reader_open(const char *path);
+
+/**
+ * @brief 解除映射並釋放
+ */
+void status_shm_reader_close(status_shm_reader_t *reader);
+
+/**
+ * @brief 讀出一致的狀態快照 (不使用系統呼叫)
+ *
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_TIMEOUT 重試 STATUS_SHM_READ_RETRIES 次仍在更新中
+ */
+int status_shm_read(const status_shm_reader_t *reader, status_shm_data_t *status);
+
+/**
+ * @brief 目前的更新序號 (每次更新加 2),與上次不同表示狀態已改變
+ */
+uint32_t status_shm_sequence(const status_shm_reader_t *reader);
+
+#endif // STATUS_SHM_H
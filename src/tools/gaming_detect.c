@@ -0,0 +1,65 @@
+/**
+ * @file gaming_detect.c
+ * @brief gaming-detect - 開機時判定裝置類型
+ * @version 1.0.0
+ *
+ * 供 /etc/init.d/gaming 使用:在同一個行程內依序檢查快取檔案、
+ * ADC 與 UCI,將結果 (client / server / unknown) 印到 stdout。
+ *
+ * 用法: gaming-detect [-c cache_path] [-v]
+ *   -c  快取檔案路徑 (預設 /var/run/gaming_device_type)
+ *   -v  將判定來源印到 stderr
+ *
+ * 結束碼: 0 判定成功, 1 無法判定, 2 參數錯誤
+ */
+
+#define _POSIX_C_SOURCE 200809L  // getopt
+
+#include "../device_detect.h"
+#include "../hal_interface.h"
+#include <stdio.h>
+#include <unistd.h>
+
+extern hal_ops_t* hal_get_real_ops(void);
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-c cache_path] [-v]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    const char *cache_path = NULL;
+    int verbose = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c:vh")) != -1) {
+        switch (opt) {
+            case 'c':
+                cache_path = optarg;
+                break;
+            case 'v':
+                verbose = 1;
+                break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+
+    // 直接取用真實硬體的 HAL (hal_init 會在 stdout 輸出訊息)
+    hal_ops = hal_get_real_ops();
+
+    device_source_t source;
+    device_type_t type = device_detect_run(cache_path, &source);
+
+    if (hal_ops != NULL && hal_ops->adc_close != NULL) {
+        hal_ops->adc_close();
+    }
+
+    if (verbose) {
+        fprintf(stderr, "gaming-detect: %s (source: %s)\n",
+                device_detect_type_name(type), device_detect_source_name(source));
+    }
+
+    printf("%s\n", device_detect_type_name(type));
+    return (type == DEVICE_TYPE_UNKNOWN) ? 1 : 0;
+}
@@ -0,0 +1,33 @@
+/**
+ * @file gaming_flightdump.c
+ * @brief gaming-flightdump - 印出 flight recorder 的內容
+ * @version 1.0.0
+ *
+ * 行程當機或被 procd 重新啟動後,讀取記錄檔中最近的日誌 (含 DEBUG)。
+ *
+ * 用法: gaming-flightdump [file]
+ *   file  記錄檔路徑 (預設 /var/run/gaming.flight)
+ *
+ * 結束碼: 0 成功, 1 無法讀取或格式錯誤, 2 參數錯誤
+ */
+
+#include "../flight_recorder.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+int main(int argc, char *argv[]) {
+    if (argc > 2 || (argc == 2 && strcmp(argv[1], "-h") == 0)) {
+        fprintf(stderr, "Usage: %s [file]\n", argv[0]);
+        return 2;
+    }
+
+    const char *path = (argc == 2) ? argv[1] : NULL;
+    if (flight_recorder_dump_file(path, STDOUT_FILENO) < 0) {
+        fprintf(stderr, "gaming-flightdump: cannot read flight recorder %s\n",
+                path ? path : FLIGHT_RECORDER_DEFAULT_PATH);
+        return 1;
+    }
+
+    return 0;
+}
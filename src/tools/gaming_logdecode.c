@@ -0,0 +1,46 @@
+/**
+ * @file gaming_logdecode.c
+ * @brief gaming-logdecode - 將二進位日誌還原為文字
+ * @version 1.0.0
+ *
+ * 可在路由器上或開發主機上執行,檔案的位元組順序會自動判斷。
+ *
+ * 用法: gaming-logdecode [file]
+ *   file  二進位日誌檔案,省略則從 stdin 讀取
+ *
+ * 結束碼: 0 成功, 1 檔案格式錯誤, 2 參數錯誤或無法開啟檔案
+ */
+
+#include "../logger_binary.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+int main(int argc, char *argv[]) {
+    FILE *in = stdin;
+
+    if (argc > 2 || (argc == 2 && strcmp(argv[1], "-h") == 0)) {
+        fprintf(stderr, "Usage: %s [file]\n", argv[0]);
+        return 2;
+    }
+
+    if (argc == 2) {
+        in = fopen(argv[1], "rb");
+        if (in == NULL) {
+            fprintf(stderr, "gaming-logdecode: %s: %s\n", argv[1], strerror(errno));
+            return 2;
+        }
+    }
+
+    int count = logger_bin_decode(in, stdout);
+
+    if (in != stdin) {
+        fclose(in);
+    }
+
+    if (count < 0) {
+        fprintf(stderr, "gaming-logdecode: invalid or corrupted binary log\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,1050 @@
+/**
+ * @file websocket_server.c
+ * @brief WebSocket Server 實作
+ * @version 1.0.0
+ *
+ * 每個客戶端最多從池中借用兩個區塊: raw 放跨越 recv 的不完整資料
+ * (握手請求或 frame),msg 放尚未收齊的分段訊息。資料完整到達時
+ * 直接在 socket_server 的接收緩衝區中解除遮罩並交給回呼,不需複製
+ */
+
+#define _GNU_SOURCE  // strcasestr
+
+#include "websocket_server.h"
+#include "socket_server.h"
+#include "logger.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// ========================================
+// 內部資料
+// ========================================
+
+#define WS_GUID             "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+#define WS_MAX_HEADER       14      // 2 + 8 (長度) + 4 (遮罩)
+#define WS_PATH_MAX         128
+
+typedef enum {
+    WS_STATE_HANDSHAKE = 0,
+    WS_STATE_OPEN,
+    WS_STATE_CLOSING,
+} ws_state_t;
+
+typedef struct pool_block {
+    struct pool_block *next;
+} pool_block_t;
+
+/**
+ * @brief 固定大小區塊池: 釋放的區塊留在 free list 重複使用
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    pool_block_t *free_list;
+    size_t block_size;
+    int outstanding;
+    int limit;
+} ws_pool_t;
+
+struct websocket_client {
+    websocket_server_t *server;
+    socket_conn_t *conn;
+    int worker;
+    uint8_t state;
+    bool opened;                // 已呼叫 on_open
+
+    uint8_t *raw;               // 不完整的握手或 frame
+    size_t raw_len;
+    uint8_t *msg;               // 分段訊息
+    size_t msg_len;
+    int msg_opcode;             // 0 表示不在分段訊息中
+
+    void *data;
+    websocket_client_t *prev;
+    websocket_client_t *next;
+};
+
+struct websocket_server {
+    websocket_config_t config;
+    char path[WS_PATH_MAX];
+    socket_server_t *sock;
+    ws_pool_t pool;
+
+    int connections;            // 含握手中
+    int open_clients;
+
+    // 各 worker 的客戶端串列,只在該 worker 執行緒中存取
+    websocket_client_t *clients[SOCKET_SERVER_MAX_WORKERS];
+};
+
+typedef struct {
+    websocket_server_t *server;
+    int refs;
+    size_t len;
+    uint8_t data[];
+} ws_shared_frame_t;
+
+// ========================================
+// SHA-1 / base64
+// ========================================
+
+#define ROL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+static void sha1_block(uint32_t h[5], const uint8_t block[64]) {
+    uint32_t w[80];
+
+    for (int i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)block[i * 4] << 24) | ((uint32_t)block[i * 4 + 1] << 16) |
+               ((uint32_t)block[i * 4 + 2] << 8) | block[i * 4 + 3];
+    }
+    for (int i = 16; i < 80; i++) {
+        w[i] = ROL32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+        uint32_t f, k;
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+        uint32_t t = ROL32(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = ROL32(b, 30);
+        b = a;
+        a = t;
+    }
+
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+}
+
+static void sha1(const uint8_t *data, size_t len, uint8_t digest[20]) {
+    uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+    uint8_t block[64];
+    size_t i = 0;
+
+    for (; i + 64 <= len; i += 64) {
+        sha1_block(h, data + i);
+    }
+
+    // 補位: 0x80、0、64 位元長度
+    size_t rest = len - i;
+    memset(block, 0, sizeof(block));
+    memcpy(block, data + i, rest);
+    block[rest] = 0x80;
+    if (rest >= 56) {
+        sha1_block(h, block);
+        memset(block, 0, sizeof(block));
+    }
+    uint64_t bits = (uint64_t)len * 8;
+    for (int j = 0; j < 8; j++) {
+        block[63 - j] = (uint8_t)(bits >> (j * 8));
+    }
+    sha1_block(h, block);
+
+    for (int j = 0; j < 5; j++) {
+        digest[j * 4] = (uint8_t)(h[j] >> 24);
+        digest[j * 4 + 1] = (uint8_t)(h[j] >> 16);
+        digest[j * 4 + 2] = (uint8_t)(h[j] >> 8);
+        digest[j * 4 + 3] = (uint8_t)h[j];
+    }
+}
+
+static void base64_encode(const uint8_t *in, size_t len, char *out) {
+    static const char table[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t i = 0;
+
+    for (; i + 3 <= len; i += 3) {
+        uint32_t v = ((uint32_t)in[i] << 16) | ((uint32_t)in[i + 1] << 8) | in[i + 2];
+        *out++ = table[v >> 18];
+        *out++ = table[(v >> 12) & 0x3f];
+        *out++ = table[(v >> 6) & 0x3f];
+        *out++ = table[v & 0x3f];
+    }
+    if (i < len) {
+        uint32_t v = (uint32_t)in[i] << 16;
+        if (i + 1 < len) {
+            v |= (uint32_t)in[i + 1] << 8;
+        }
+        *out++ = table[v >> 18];
+        *out++ = table[(v >> 12) & 0x3f];
+        *out++ = (i + 1 < len) ? table[(v >> 6) & 0x3f] : '=';
+        *out++ = '=';
+    }
+    *out = '\0';
+}
+
+// ========================================
+// 區塊池
+// ========================================
+
+static void pool_init(ws_pool_t *pool, size_t block_size, int limit) {
+    pthread_mutex_init(&pool->lock, NULL);
+    pool->free_list = NULL;
+    pool->block_size = block_size;
+    pool->outstanding = 0;
+    pool->limit = limit;
+}
+
+static void pool_cleanup(ws_pool_t *pool) {
+    while (pool->free_list != NULL) {
+        pool_block_t *block = pool->free_list;
+        pool->free_list = block->next;
+        free(block);
+    }
+    pthread_mutex_destroy(&pool->lock);
+}
+
+static uint8_t* pool_get(ws_pool_t *pool) {
+    pool_block_t *block = NULL;
+
+    pthread_mutex_lock(&pool->lock);
+    if (pool->outstanding < pool->limit) {
+        block = pool->free_list;
+        if (block != NULL) {
+            pool->free_list = block->next;
+        } else {
+            block = malloc(pool->block_size);
+        }
+        if (block != NULL) {
+            pool->outstanding++;
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return (uint8_t *)block;
+}
+
+static void pool_put(ws_pool_t *pool, uint8_t *ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+
+    pool_block_t *block = (pool_block_t *)(void *)ptr;
+    pthread_mutex_lock(&pool->lock);
+    block->next = pool->free_list;
+    pool->free_list = block;
+    pool->outstanding--;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// ========================================
+// 協定輔助函數
+// ========================================
+
+int websocket_accept_key(const char *key, char out[WEBSOCKET_ACCEPT_KEY_SIZE]) {
+    char buffer[128];
+    uint8_t digest[20];
+
+    if (key == NULL || out == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    int n = snprintf(buffer, sizeof(buffer), "%s" WS_GUID, key);
+    if (n < 0 || (size_t)n >= sizeof(buffer)) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    sha1((const uint8_t *)buffer, (size_t)n, digest);
+    base64_encode(digest, sizeof(digest), out);
+    return GAMING_OK;
+}
+
+void websocket_mask(uint8_t *data, size_t len, const uint8_t key[4], size_t offset) {
+    uint8_t k[4];
+    size_t i = 0;
+
+    for (int j = 0; j < 4; j++) {
+        k[j] = key[(offset + (size_t)j) & 3];
+    }
+
+    // 先逐 byte 處理到 8 bytes 對齊,再一次處理一個 64 位元字
+    while (i < len && ((uintptr_t)(data + i) & 7) != 0) {
+        data[i] ^= k[i & 3];
+        i++;
+    }
+
+    uint8_t pattern[8];
+    uint64_t word;
+    for (int j = 0; j < 8; j++) {
+        pattern[j] = k[(i + (size_t)j) & 3];
+    }
+    memcpy(&word, pattern, sizeof(word));
+
+    for (; i + 8 <= len; i += 8) {
+        uint64_t v;
+        memcpy(&v, data + i, sizeof(v));
+        v ^= word;
+        memcpy(data + i, &v, sizeof(v));
+    }
+
+    for (; i < len; i++) {
+        data[i] ^= k[i & 3];
+    }
+}
+
+size_t websocket_encode_header(uint8_t *header, int opcode, bool fin, size_t len) {
+    header[0] = (uint8_t)((fin ? 0x80 : 0) | (opcode & 0x0f));
+
+    if (len < 126) {
+        header[1] = (uint8_t)len;
+        return 2;
+    }
+    if (len <= 0xffff) {
+        header[1] = 126;
+        header[2] = (uint8_t)(len >> 8);
+        header[3] = (uint8_t)len;
+        return 4;
+    }
+
+    header[1] = 127;
+    for (int i = 0; i < 8; i++) {
+        header[2 + i] = (uint8_t)((uint64_t)len >> ((7 - i) * 8));
+    }
+    return 10;
+}
+
+// ========================================
+// 送出
+// ========================================
+
+static int send_frame(websocket_client_t *client, int opcode, const void *data, size_t len) {
+    uint8_t header[10];
+    struct iovec iov[2] = {
+        { .iov_base = header, .iov_len = websocket_encode_header(header, opcode, true, len) },
+        { .iov_base = (void *)data, .iov_len = len },
+    };
+
+    return socket_conn_sendv(client->conn, iov, len > 0 ? 2 : 1);
+}
+
+static void close_with_code(websocket_client_t *client, uint16_t code) {
+    uint8_t payload[2] = { (uint8_t)(code >> 8), (uint8_t)code };
+
+    if (client->state == WS_STATE_OPEN &&
+        send_frame(client, WEBSOCKET_OPCODE_CLOSE, payload, sizeof(payload)) == GAMING_ERROR_IO) {
+        // 連線已關閉,不在回呼中時 client 已被釋放
+        return;
+    }
+    client->state = WS_STATE_CLOSING;
+
+    // 不在回呼中時會立即釋放 client,之後不可再存取
+    socket_conn_close(client->conn);
+}
+
+static void send_http_error(websocket_client_t *client, const char *status) {
+    char response[160];
+    int n = snprintf(response, sizeof(response),
+                     "HTTP/1.1 %s\r\n"
+                     "Sec-WebSocket-Version: 13\r\n"
+                     "Content-Length: 0\r\n"
+                     "Connection: close\r\n\r\n", status);
+
+    socket_conn_send(client->conn, response, (size_t)n);
+    client->state = WS_STATE_CLOSING;
+    socket_conn_close(client->conn);
+}
+
+// ========================================
+// 握手
+// ========================================
+
+static char* trim(char *s) {
+    while (*s == ' ' || *s == '\t') {
+        s++;
+    }
+    char *end = s + strlen(s);
+    while (end > s && (end[-1] == ' ' || end[-1] == '\t')) {
+        *--end = '\0';
+    }
+    return s;
+}
+
+/**
+ * @brief 解析握手請求 (就地修改 request)
+ *
+ * @return NULL 成功並填入 key,否則為 HTTP 錯誤狀態
+ */
+static const char* parse_handshake(const websocket_server_t *server, char *request,
+                                   const char **key) {
+    char *saveptr = NULL;
+    char *line = strtok_r(request, "\r\n", &saveptr);
+
+    // 請求行: GET <path> HTTP/1.1
+    if (line == NULL || strncmp(line, "GET ", 4) != 0) {
+        return "400 Bad Request";
+    }
+    char *target = line + 4;
+    char *version = strchr(target, ' ');
+    if (version == NULL || strcmp(version + 1, "HTTP/1.1") != 0) {
+        return "400 Bad Request";
+    }
+    *version = '\0';
+    size_t path_len = strlen(server->path);
+    if (strncmp(target, server->path, path_len) != 0 ||
+        (target[path_len] != '\0' && target[path_len] != '?')) {
+        return "404 Not Found";
+    }
+
+    bool upgrade = false;
+    bool connection = false;
+    bool version_ok = false;
+    *key = NULL;
+
+    while ((line = strtok_r(NULL, "\r\n", &saveptr)) != NULL) {
+        char *colon = strchr(line, ':');
+        if (colon == NULL) {
+            continue;
+        }
+        *colon = '\0';
+        char *name = trim(line);
+        char *value = trim(colon + 1);
+
+        if (strcasecmp(name, "Upgrade") == 0) {
+            upgrade = (strcasestr(value, "websocket") != NULL);
+        } else if (strcasecmp(name, "Connection") == 0) {
+            connection = (strcasestr(value, "upgrade") != NULL);
+        } else if (strcasecmp(name, "Sec-WebSocket-Key") == 0) {
+            *key = value;
+        } else if (strcasecmp(name, "Sec-WebSocket-Version") == 0) {
+            version_ok = (strcmp(value, "13") == 0);
+        }
+    }
+
+    if (!upgrade || !connection || *key == NULL || strlen(*key) != 24) {
+        return "400 Bad Request";
+    }
+    if (!version_ok) {
+        return "426 Upgrade Required";
+    }
+    return NULL;
+}
+
+/**
+ * @brief 累積握手請求,收齊後回應
+ *
+ * @return 已使用的輸入位元組數,-1 表示連線已關閉
+ */
+static ssize_t handle_handshake(websocket_client_t *client, const uint8_t *data, size_t len) {
+    websocket_server_t *server = client->server;
+
+    if (client->raw == NULL) {
+        client->raw = pool_get(&server->pool);
+        if (client->raw == NULL) {
+            send_http_error(client, "503 Service Unavailable");
+            return -1;
+        }
+    }
+
+    size_t space = WEBSOCKET_HANDSHAKE_MAX - client->raw_len;
+    size_t n = (len < space) ? len : space;
+    memcpy(client->raw + client->raw_len, data, n);
+    client->raw_len += n;
+    client->raw[client->raw_len] = '\0';
+
+    char *request = (char *)client->raw;
+    char *end = strstr(request, "\r\n\r\n");
+    if (end == NULL) {
+        if (client->raw_len >= WEBSOCKET_HANDSHAKE_MAX) {
+            send_http_error(client, "431 Request Header Fields Too Large");
+            return -1;
+        }
+        return (ssize_t)n;
+    }
+
+    size_t header_len = (size_t)(end - request) + 4;
+    size_t leftover = client->raw_len - header_len;
+    *end = '\0';
+
+    const char *key = NULL;
+    const char *status = parse_handshake(server, request, &key);
+    if (status != NULL) {
+        logger_mod_ratelimited(LOG_MODULE_SOCKET, LOG_LEVEL_WARN,
+                               "websocket handshake rejected: %s", status);
+        send_http_error(client, status);
+        return -1;
+    }
+
+    char accept[WEBSOCKET_ACCEPT_KEY_SIZE];
+    char response[160];
+    websocket_accept_key(key, accept);
+    int rn = snprintf(response, sizeof(response),
+                      "HTTP/1.1 101 Switching Protocols\r\n"
+                      "Upgrade: websocket\r\n"
+                      "Connection: Upgrade\r\n"
+                      "Sec-WebSocket-Accept: %s\r\n\r\n", accept);
+    if (socket_conn_send(client->conn, response, (size_t)rn) != GAMING_OK) {
+        return -1;
+    }
+
+    // 請求之後緊接著的 frame 留在 raw 中
+    memmove(client->raw, client->raw + header_len, leftover);
+    client->raw_len = leftover;
+
+    client->state = WS_STATE_OPEN;
+    client->opened = true;
+    __atomic_add_fetch(&server->open_clients, 1, __ATOMIC_RELAXED);
+    if (server->config.on_open != NULL) {
+        server->config.on_open(client, server->config.user_data);
+    }
+    return (ssize_t)n;
+}
+
+// ========================================
+// Frame 解析
+// ========================================
+
+/**
+ * @brief 檢查 UTF-8 (RFC 3629: 拒絕過長編碼、代理對與超過 U+10FFFF 的碼位)
+ */
+static bool utf8_valid(const uint8_t *s, size_t len) {
+    size_t i = 0;
+
+    while (i < len) {
+        uint8_t c = s[i];
+        if (c < 0x80) {
+            i++;
+            continue;
+        }
+
+        size_t n;
+        uint8_t lo = 0x80, hi = 0xbf;   // 第二個 byte 的範圍
+        if (c >= 0xc2 && c <= 0xdf) {
+            n = 1;
+        } else if (c >= 0xe0 && c <= 0xef) {
+            n = 2;
+            if (c == 0xe0) {
+                lo = 0xa0;
+            } else if (c == 0xed) {
+                hi = 0x9f;
+            }
+        } else if (c >= 0xf0 && c <= 0xf4) {
+            n = 3;
+            if (c == 0xf0) {
+                lo = 0x90;
+            } else if (c == 0xf4) {
+                hi = 0x8f;
+            }
+        } else {
+            return false;
+        }
+
+        if (len - i - 1 < n || s[i + 1] < lo || s[i + 1] > hi) {
+            return false;
+        }
+        for (size_t j = 2; j <= n; j++) {
+            if ((s[i + j] & 0xc0) != 0x80) {
+                return false;
+            }
+        }
+        i += n + 1;
+    }
+    return true;
+}
+
+/**
+ * @brief 對端可送出的關閉代碼 (RFC 6455 7.4)
+ */
+static bool close_code_valid(uint16_t code) {
+    if (code >= 3000 && code <= 4999) {
+        return true;
+    }
+    // 1004 保留,1005 / 1006 不可出現在 close frame 中
+    return code >= 1000 && code <= 1011 && code != 1004 && code != 1005 && code != 1006;
+}
+
+static void deliver_message(websocket_client_t *client, int opcode,
+                            const uint8_t *data, size_t len) {
+    websocket_server_t *server = client->server;
+
+    if (opcode == WEBSOCKET_OPCODE_TEXT && !utf8_valid(data, len)) {
+        close_with_code(client, WEBSOCKET_CLOSE_INVALID_DATA);
+        return;
+    }
+
+    if (server->config.on_message != NULL) {
+        server->config.on_message(client, opcode, data, len, server->config.user_data);
+    }
+}
+
+/**
+ * @brief 處理一個完整且已解除遮罩的 frame
+ */
+static void handle_frame(websocket_client_t *client, bool fin, int opcode,
+                         const uint8_t *payload, size_t len) {
+    websocket_server_t *server = client->server;
+
+    switch (opcode) {
+        case 0x0:   // 延續
+            if (client->msg_opcode == 0) {
+                close_with_code(client, WEBSOCKET_CLOSE_PROTOCOL_ERROR);
+                return;
+            }
+            if (client->msg_len + len > server->config.max_message) {
+                close_with_code(client, WEBSOCKET_CLOSE_TOO_BIG);
+                return;
+            }
+            memcpy(client->msg + client->msg_len, payload, len);
+            client->msg_len += len;
+            if (fin) {
+                deliver_message(client, client->msg_opcode, client->msg, client->msg_len);
+                pool_put(&server->pool, client->msg);
+                client->msg = NULL;
+                client->msg_len = 0;
+                client->msg_opcode = 0;
+            }
+            break;
+
+        case WEBSOCKET_OPCODE_TEXT:
+        case WEBSOCKET_OPCODE_BINARY:
+            if (client->msg_opcode != 0) {
+                close_with_code(client, WEBSOCKET_CLOSE_PROTOCOL_ERROR);
+                return;
+            }
+            if (fin) {
+                deliver_message(client, opcode, payload, len);
+                return;
+            }
+            client->msg = pool_get(&server->pool);
+            if (client->msg == NULL) {
+                close_with_code(client, WEBSOCKET_CLOSE_TOO_BIG);
+                return;
+            }
+            memcpy(client->msg, payload, len);
+            client->msg_len = len;
+            client->msg_opcode = opcode;
+            break;
+
+        case WEBSOCKET_OPCODE_PING:
+            send_frame(client, WEBSOCKET_OPCODE_PONG, payload, len);
+            break;
+
+        case WEBSOCKET_OPCODE_PONG:
+            break;
+
+        case WEBSOCKET_OPCODE_CLOSE: {
+            // 沒有代碼時回 1000;只有 1 byte、代碼不可用或原因不是 UTF-8 時回 1002
+            uint16_t code = WEBSOCKET_CLOSE_NORMAL;
+            if (len == 1) {
+                code = WEBSOCKET_CLOSE_PROTOCOL_ERROR;
+            } else if (len >= 2) {
+                code = (uint16_t)((payload[0] << 8) | payload[1]);
+                if (!close_code_valid(code) || !utf8_valid(payload + 2, len - 2)) {
+                    code = WEBSOCKET_CLOSE_PROTOCOL_ERROR;
+                }
+            }
+            close_with_code(client, code);
+            break;
+        }
+
+        default:
+            close_with_code(client, WEBSOCKET_CLOSE_PROTOCOL_ERROR);
+            break;
+    }
+}
+
+/**
+ * @brief 處理 buf 中所有完整的 frame (就地解除遮罩)
+ *
+ * @return 已處理的位元組數,-1 表示連線已關閉
+ */
+static ssize_t consume_frames(websocket_client_t *client, uint8_t *buf, size_t len) {
+    size_t max_message = client->server->config.max_message;
+    size_t off = 0;
+
+    while (client->state == WS_STATE_OPEN) {
+        uint8_t *p = buf + off;
+        size_t avail = len - off;
+        if (avail < 2) {
+            break;
+        }
+
+        bool fin = (p[0] & 0x80) != 0;
+        int opcode = p[0] & 0x0f;
+        uint64_t payload_len = p[1] & 0x7f;
+        size_t header = 2;
+
+        // 客戶端送出的 frame 必須加遮罩,且不使用保留位元
+        if ((p[0] & 0x70) != 0 || (p[1] & 0x80) == 0) {
+            close_with_code(client, WEBSOCKET_CLOSE_PROTOCOL_ERROR);
+            return -1;
+        }
+
+        if (payload_len == 126) {
+            if (avail < 4) {
+                break;
+            }
+            payload_len = ((uint64_t)p[2] << 8) | p[3];
+            header = 4;
+        } else if (payload_len == 127) {
+            if (avail < 10) {
+                break;
+            }
+            payload_len = 0;
+            for (int i = 0; i < 8; i++) {
+                payload_len = (payload_len << 8) | p[2 + i];
+            }
+            header = 10;
+        }
+
+        if ((opcode & 0x08) && (!fin || payload_len > 125)) {
+            close_with_code(client, WEBSOCKET_CLOSE_PROTOCOL_ERROR);
+            return -1;
+        }
+        if (payload_len > max_message) {
+            close_with_code(client, WEBSOCKET_CLOSE_TOO_BIG);
+            return -1;
+        }
+
+        header += 4;
+        if (avail < header + payload_len) {
+            break;
+        }
+
+        uint8_t *payload = p + header;
+        websocket_mask(payload, (size_t)payload_len, p + header - 4, 0);
+        handle_frame(client, fin, opcode, payload, (size_t)payload_len);
+        off += header + (size_t)payload_len;
+    }
+
+    return (client->state == WS_STATE_OPEN) ? (ssize_t)off : -1;
+}
+
+/**
+ * @brief 處理收到的資料: 有暫存時先補進 raw,否則直接在輸入上解析
+ */
+static void feed_frames(websocket_client_t *client, uint8_t *data, size_t len) {
+    websocket_server_t *server = client->server;
+    size_t block = server->pool.block_size;
+
+    while (client->raw_len > 0) {
+        size_t n = block - client->raw_len;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(client->raw + client->raw_len, data, n);
+        client->raw_len += n;
+        data += n;
+        len -= n;
+
+        ssize_t used = consume_frames(client, client->raw, client->raw_len);
+        if (used < 0) {
+            return;
+        }
+        if (used == 0) {
+            if (client->raw_len == block) {
+                // 區塊已滿仍無完整 frame (不應發生: 長度已限制在 max_message)
+                close_with_code(client, WEBSOCKET_CLOSE_TOO_BIG);
+                return;
+            }
+            // frame 尚未完整,輸入已全部放入 raw
+            break;
+        }
+        memmove(client->raw, client->raw + used, client->raw_len - (size_t)used);
+        client->raw_len -= (size_t)used;
+        if (len == 0) {
+            break;
+        }
+    }
+
+    if (len > 0) {
+        ssize_t used = consume_frames(client, data, len);
+        if (used < 0) {
+            return;
+        }
+        data += used;
+        len -= (size_t)used;
+    }
+
+    if (len > 0) {
+        if (client->raw == NULL) {
+            client->raw = pool_get(&server->pool);
+            if (client->raw == NULL) {
+                close_with_code(client, WEBSOCKET_CLOSE_TOO_BIG);
+                return;
+            }
+        }
+        memcpy(client->raw + client->raw_len, data, len);
+        client->raw_len += len;
+    }
+
+    if (client->raw_len == 0 && client->raw != NULL) {
+        pool_put(&server->pool, client->raw);
+        client->raw = NULL;
+    }
+}
+
+// ========================================
+// socket_server 回呼
+// ========================================
+
+static int on_conn_accept(socket_conn_t *conn, void *user_data) {
+    websocket_server_t *server = user_data;
+
+    if (__atomic_add_fetch(&server->connections, 1, __ATOMIC_RELAXED) > server->config.max_clients) {
+        __atomic_sub_fetch(&server->connections, 1, __ATOMIC_RELAXED);
+        logger_mod_ratelimited(LOG_MODULE_SOCKET, LOG_LEVEL_WARN,
+                               "websocket: too many clients (%d)", server->config.max_clients);
+        return GAMING_ERROR;
+    }
+
+    websocket_client_t *client = calloc(1, sizeof(*client));
+    if (client == NULL) {
+        __atomic_sub_fetch(&server->connections, 1, __ATOMIC_RELAXED);
+        return GAMING_ERROR_NO_MEMORY;
+    }
+
+    client->server = server;
+    client->conn = conn;
+    client->worker = socket_conn_worker(conn);
+    client->next = server->clients[client->worker];
+    if (client->next != NULL) {
+        client->next->prev = client;
+    }
+    server->clients[client->worker] = client;
+
+    socket_conn_set_data(conn, client);
+    return GAMING_OK;
+}
+
+static void on_conn_data(socket_conn_t *conn, uint8_t *data, size_t len, void *user_data) {
+    websocket_client_t *client = socket_conn_get_data(conn);
+
+    if (client->state == WS_STATE_HANDSHAKE) {
+        ssize_t used = handle_handshake(client, data, len);
+        if (used < 0 || client->state != WS_STATE_OPEN) {
+            return;
+        }
+        data += used;
+        len -= (size_t)used;
+    }
+
+    if (client->state == WS_STATE_OPEN) {
+        feed_frames(client, data, len);
+    }
+}
+
+static void on_conn_close(socket_conn_t *conn, void *user_data) {
+    websocket_server_t *server = user_data;
+    websocket_client_t *client = socket_conn_get_data(conn);
+
+    if (client->opened) {
+        if (server->config.on_close != NULL) {
+            server->config.on_close(client, server->config.user_data);
+        }
+        __atomic_sub_fetch(&server->open_clients, 1, __ATOMIC_RELAXED);
+    }
+
+    if (client->prev != NULL) {
+        client->prev->next = client->next;
+    } else {
+        server->clients[client->worker] = client->next;
+    }
+    if (client->next != NULL) {
+        client->next->prev = client->prev;
+    }
+
+    pool_put(&server->pool, client->raw);
+    pool_put(&server->pool, client->msg);
+    free(client);
+    __atomic_sub_fetch(&server->connections, 1, __ATOMIC_RELAXED);
+}
+
+static void release_frame(ws_shared_frame_t *frame) {
+    if (__atomic_sub_fetch(&frame->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(frame);
+    }
+}
+
+static void broadcast_task(socket_server_t *sock, int worker, void *user_data) {
+    ws_shared_frame_t *frame = user_data;
+    websocket_client_t *client = frame->server->clients[worker];
+
+    // 關閉連線會立即把它移出串列,先取得下一個
+    while (client != NULL) {
+        websocket_client_t *next = client->next;
+
+        // 只有 NO_MEMORY (暫存已達上限) 時連線仍在;IO 錯誤時連線已關閉,client 已被釋放
+        if (client->state == WS_STATE_OPEN &&
+            socket_conn_send(client->conn, frame->data, frame->len) == GAMING_ERROR_NO_MEMORY) {
+            logger_mod_ratelimited(LOG_MODULE_SOCKET, LOG_LEVEL_WARN,
+                                   "websocket: dropping slow client on fd %d",
+                                   socket_conn_fd(client->conn));
+            client->state = WS_STATE_CLOSING;
+            socket_conn_close(client->conn);
+        }
+        client = next;
+    }
+
+    release_frame(frame);
+}
+
+// ========================================
+// WebSocket Server 公開函數
+// ========================================
+
+websocket_server_t* websocket_server_create(const websocket_config_t *config) {
+    if (config == NULL || config->path == NULL || config->path[0] != '/' ||
+        strlen(config->path) >= WS_PATH_MAX || config->port < 0 || config->port > 65535 ||
+        config->max_clients <= 0 || config->max_message == 0) {
+        logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "websocket_server_create: invalid config");
+        return NULL;
+    }
+
+    websocket_server_t *server = calloc(1, sizeof(*server));
+    if (server == NULL) {
+        return NULL;
+    }
+
+    server->config = *config;
+    strcpy(server->path, config->path);
+    server->config.path = server->path;
+
+    // 每個客戶端最多同時借用 raw 與 msg 兩個區塊
+    size_t block_size = config->max_message + WS_MAX_HEADER;
+    if (block_size < WEBSOCKET_HANDSHAKE_MAX + 1) {
+        block_size = WEBSOCKET_HANDSHAKE_MAX + 1;
+    }
+    pool_init(&server->pool, block_size, config->max_clients * 2);
+
+    socket_server_config_t sc = SOCKET_SERVER_CONFIG_INIT;
+    sc.type = SOCKET_TYPE_TCP;
+    sc.bind_addr = config->bind_addr;
+    sc.port = config->port;
+    sc.workers = config->workers;
+    sc.on_accept = on_conn_accept;
+    sc.on_data = on_conn_data;
+    sc.on_close = on_conn_close;
+    sc.user_data = server;
+
+    server->sock = socket_server_create(&sc);
+    if (server->sock == NULL) {
+        pool_cleanup(&server->pool);
+        free(server);
+        return NULL;
+    }
+
+    logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_INFO, "websocket server on port %d%s",
+               socket_server_get_port(server->sock), server->path);
+    return server;
+}
+
+int websocket_server_start(websocket_server_t *server) {
+    if (server == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    return socket_server_start(server->sock);
+}
+
+void websocket_server_stop(websocket_server_t *server) {
+    if (server == NULL) {
+        return;
+    }
+    socket_server_stop(server->sock);
+}
+
+void websocket_server_destroy(websocket_server_t *server) {
+    if (server == NULL) {
+        return;
+    }
+
+    socket_server_destroy(server->sock);
+    pool_cleanup(&server->pool);
+    free(server);
+}
+
+int websocket_server_get_port(const websocket_server_t *server) {
+    if (server == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    return socket_server_get_port(server->sock);
+}
+
+int websocket_server_client_count(const websocket_server_t *server) {
+    if (server == NULL) {
+        return 0;
+    }
+    return __atomic_load_n(&server->open_clients, __ATOMIC_RELAXED);
+}
+
+int websocket_server_broadcast(websocket_server_t *server, int opcode,
+                               const void *data, size_t len) {
+    if (server == NULL || (data == NULL && len > 0) ||
+        (opcode != WEBSOCKET_OPCODE_TEXT && opcode != WEBSOCKET_OPCODE_BINARY)) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    int workers = socket_server_worker_count(server->sock);
+    uint8_t header[10];
+    size_t header_len = websocket_encode_header(header, opcode, true, len);
+
+    ws_shared_frame_t *frame = malloc(sizeof(*frame) + header_len + len);
+    if (frame == NULL) {
+        return GAMING_ERROR_NO_MEMORY;
+    }
+    frame->server = server;
+    frame->refs = workers;
+    frame->len = header_len + len;
+    memcpy(frame->data, header, header_len);
+    if (len > 0) {
+        memcpy(frame->data + header_len, data, len);
+    }
+
+    int result = GAMING_OK;
+    for (int i = 0; i < workers; i++) {
+        int ret = socket_server_post(server->sock, i, broadcast_task, frame);
+        if (ret != GAMING_OK) {
+            result = ret;
+            release_frame(frame);
+        }
+    }
+
+    return result;
+}
+
+// ========================================
+// 客戶端函數
+// ========================================
+
+int websocket_send(websocket_client_t *client, int opcode, const void *data, size_t len) {
+    if (client == NULL || (data == NULL && len > 0)) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    if (client->state != WS_STATE_OPEN) {
+        return GAMING_ERROR_IO;
+    }
+    return send_frame(client, opcode, data, len);
+}
+
+void websocket_close(websocket_client_t *client, uint16_t code) {
+    if (client == NULL || client->state == WS_STATE_CLOSING) {
+        return;
+    }
+    close_with_code(client, code);
+}
+
+void websocket_client_set_data(websocket_client_t *client, void *data) {
+    if (client != NULL) {
+        client->data = data;
+    }
+}
+
+void* websocket_client_get_data(const websocket_client_t *client) {
+    return (client != NULL) ? client->data : NULL;
+}
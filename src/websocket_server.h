@@ -0,0 +1,209 @@
+/**
+ * @file websocket_server.h
+ * @brief WebSocket Server - RFC 6455 伺服器 (WEBSOCKET_PATH 端點)
+ * @version 1.0.0
+ *
+ * 建立在 socket_server 之上,用來把 PS5 / VPN 狀態推送給瀏覽器與 App:
+ *
+ * - 握手: 內建 SHA-1 / base64 計算 Sec-WebSocket-Accept,不依賴外部函式庫
+ * - 收到的 frame 在接收緩衝區中就地解除遮罩 (一次處理 8 bytes)
+ * - 只有跨越多次 recv 的 frame 與分段訊息需要緩衝區,
+ *   緩衝區由固定大小的池配置,閒置連線不佔額外記憶體
+ * - 廣播只編碼一次,同一份 frame 送給所有客戶端
+ *
+ * 支援 text / binary / ping / pong / close 與分段訊息;
+ * 不支援擴充 (permessage-deflate) 與子協定,text 訊息不檢查 UTF-8
+ *
+ * 用法:
+ *   websocket_config_t config = WEBSOCKET_CONFIG_INIT;
+ *   config.on_message = on_message;
+ *   websocket_server_t *ws = websocket_server_create(&config);
+ *   websocket_server_start(ws);
+ *   websocket_server_broadcast(ws, WEBSOCKET_OPCODE_TEXT, json, len);
+ */
+
+#ifndef WEBSOCKET_SERVER_H
+#define WEBSOCKET_SERVER_H
+
+#include "gaming_common.h"
+#include <sys/types.h>
+
+// ========================================
+// WebSocket 配置
+// ========================================
+
+// 預設單則訊息上限 (分段訊息合併後的大小)
+#define WEBSOCKET_DEFAULT_MAX_MESSAGE   4096
+
+// 預設最大連線數
+#define WEBSOCKET_DEFAULT_MAX_CLIENTS   64
+
+// 握手請求上限
+#define WEBSOCKET_HANDSHAKE_MAX         4096
+
+// Sec-WebSocket-Accept 長度 (base64 的 SHA-1,含結尾 '\0')
+#define WEBSOCKET_ACCEPT_KEY_SIZE       29
+
+// Opcode
+#define WEBSOCKET_OPCODE_TEXT           0x1
+#define WEBSOCKET_OPCODE_BINARY         0x2
+#define WEBSOCKET_OPCODE_CLOSE          0x8
+#define WEBSOCKET_OPCODE_PING           0x9
+#define WEBSOCKET_OPCODE_PONG           0xA
+
+// 關閉代碼
+#define WEBSOCKET_CLOSE_NORMAL          1000
+#define WEBSOCKET_CLOSE_GOING_AWAY      1001
+#define WEBSOCKET_CLOSE_PROTOCOL_ERROR  1002
+#define WEBSOCKET_CLOSE_INVALID_DATA    1007    ///< 文字訊息不是有效的 UTF-8
+#define WEBSOCKET_CLOSE_TOO_BIG         1009
+
+typedef struct websocket_server websocket_server_t;
+typedef struct websocket_client websocket_client_t;
+
+/**
+ * @brief 握手完成回呼
+ */
+typedef void (*websocket_open_cb)(websocket_client_t *client, void *user_data);
+
+/**
+ * @brief 收到完整訊息回呼 (data 只在回呼期間有效)
+ *
+ * @param opcode WEBSOCKET_OPCODE_TEXT 或 WEBSOCKET_OPCODE_BINARY
+ */
+typedef void (*websocket_message_cb)(websocket_client_t *client, int opcode,
+                                     const uint8_t *data, size_t len, void *user_data);
+
+/**
+ * @brief 連線關閉回呼 (只有握手完成的客戶端會收到)
+ */
+typedef void (*websocket_close_cb)(websocket_client_t *client, void *user_data);
+
+typedef struct {
+    const char *bind_addr;          ///< 綁定的 IPv4 位址,NULL 表示所有介面
+    int port;                       ///< 埠號,0 表示由系統分配
+    const char *path;               ///< 端點路徑
+    int workers;                    ///< worker 執行緒數
+    int max_clients;                ///< 最大連線數 (含握手中)
+    size_t max_message;             ///< 單則訊息上限
+
+    websocket_open_cb on_open;      ///< 可為 NULL
+    websocket_message_cb on_message;    ///< 可為 NULL
+    websocket_close_cb on_close;    ///< 可為 NULL
+    void *user_data;
+} websocket_config_t;
+
+#define WEBSOCKET_CONFIG_INIT {                         \
+    .port = WEBSOCKET_PORT,                             \
+    .path = WEBSOCKET_PATH,                             \
+    .workers = 1,                                       \
+    .max_clients = WEBSOCKET_DEFAULT_MAX_CLIENTS,       \
+    .max_message = WEBSOCKET_DEFAULT_MAX_MESSAGE,       \
+}
+
+// ========================================
+// WebSocket Server 公開函數
+// ========================================
+
+/**
+ * @brief 建立伺服器並開始監聽
+ *
+ * @return 伺服器, NULL 表示參數錯誤或監聽失敗
+ */
+websocket_server_t* websocket_server_create(const websocket_config_t *config);
+
+/**
+ * @brief 啟動 worker 開始接受連線
+ *
+ * @return 同 socket_server_start()
+ */
+int websocket_server_start(websocket_server_t *server);
+
+/**
+ * @brief 停止並關閉所有連線
+ */
+void websocket_server_stop(websocket_server_t *server);
+
+/**
+ * @brief 停止並釋放伺服器
+ */
+void websocket_server_destroy(websocket_server_t *server);
+
+/**
+ * @brief 實際監聽的埠號
+ */
+int websocket_server_get_port(const websocket_server_t *server);
+
+/**
+ * @brief 握手完成的客戶端數 (任何執行緒皆可呼叫)
+ */
+int websocket_server_client_count(const websocket_server_t *server);
+
+/**
+ * @brief 廣播給所有握手完成的客戶端 (任何執行緒皆可呼叫)
+ *
+ * frame 只編碼一次,各 worker 共用。對端讀取太慢、暫存已滿的客戶端會被關閉
+ *
+ * @param opcode WEBSOCKET_OPCODE_TEXT 或 WEBSOCKET_OPCODE_BINARY
+ * @return GAMING_OK 已排入所有 worker
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_NOT_INITIALIZED 伺服器未啟動
+ * @return GAMING_ERROR_NO_MEMORY 記憶體不足
+ */
+int websocket_server_broadcast(websocket_server_t *server, int opcode,
+                               const void *data, size_t len);
+
+// ========================================
+// 客戶端函數 (只能在回呼所在的 worker 執行緒中呼叫)
+// ========================================
+
+/**
+ * @brief 送出訊息
+ *
+ * @return GAMING_OK 已送出或已暫存
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_IO 連線已關閉
+ * @return GAMING_ERROR_NO_MEMORY 暫存已滿 (連線仍開啟)
+ */
+int websocket_send(websocket_client_t *client, int opcode, const void *data, size_t len);
+
+/**
+ * @brief 送出 close frame 並關閉連線
+ */
+void websocket_close(websocket_client_t *client, uint16_t code);
+
+/**
+ * @brief 設定/取得客戶端的呼叫端資料
+ */
+void websocket_client_set_data(websocket_client_t *client, void *data);
+void* websocket_client_get_data(const websocket_client_t *client);
+
+// ========================================
+// 協定輔助函數
+// ========================================
+
+/**
+ * @brief 計算 Sec-WebSocket-Accept
+ *
+ * @param key 客戶端的 Sec-WebSocket-Key
+ * @param out 輸出 (WEBSOCKET_ACCEPT_KEY_SIZE bytes)
+ * @return GAMING_OK 成功, GAMING_ERROR_INVALID_PARAM 參數錯誤
+ */
+int websocket_accept_key(const char *key, char out[WEBSOCKET_ACCEPT_KEY_SIZE]);
+
+/**
+ * @brief 以 4 bytes 的遮罩就地 XOR (遮罩與解除遮罩相同)
+ *
+ * @param offset data 在整個 payload 中的起始位置 (決定遮罩的相位)
+ */
+void websocket_mask(uint8_t *data, size_t len, const uint8_t key[4], size_t offset);
+
+/**
+ * @brief 編碼伺服器送出的 frame 標頭 (不加遮罩)
+ *
+ * @param header 輸出,至少 10 bytes
+ * @return 標頭長度 (2 / 4 / 10)
+ */
+size_t websocket_encode_header(uint8_t *header, int opcode, bool fin, size_t len);
+
+#endif // WEBSOCKET_SERVER_H
@@ -0,0 +1,234 @@
+/**
+ * @file test_adc_iio.c
+ * @brief ADC IIO 後端單元測試
+ *
+ * 在 /tmp 下建立假的 IIO sysfs 目錄樹與 /dev/iio:deviceN 替身檔案,
+ * 驗證單次讀取、scan element 設定與緩衝資料解碼
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "unity.h"
+#include "adc_iio.h"
+#include "gaming_common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// ========================================
+// 假的 IIO 目錄樹
+// ========================================
+
+#define FAKE_ROOT      "/tmp/test_adc_iio"
+#define FAKE_SYSFS     FAKE_ROOT "/sys"
+#define FAKE_DEV       FAKE_ROOT "/dev"
+#define FAKE_DEVICE    FAKE_SYSFS "/iio:device0"
+#define FAKE_SCAN      FAKE_DEVICE "/scan_elements"
+#define FAKE_CHARDEV   FAKE_DEV "/iio:device0"
+
+static void write_file(const char *path, const char *content) {
+    FILE *fp = fopen(path, "w");
+    if (fp) {
+        fputs(content, fp);
+        fclose(fp);
+    }
+}
+
+static void read_file(const char *path, char *buffer, size_t size) {
+    buffer[0] = '\0';
+    FILE *fp = fopen(path, "r");
+    if (fp) {
+        if (fgets(buffer, (int)size, fp) == NULL) {
+            buffer[0] = '\0';
+        }
+        fclose(fp);
+    }
+    buffer[strcspn(buffer, "\n")] = '\0';
+}
+
+static void write_chardev(const uint8_t *data, size_t size) {
+    FILE *fp = fopen(FAKE_CHARDEV, "wb");
+    if (fp) {
+        fwrite(data, 1, size, fp);
+        fclose(fp);
+    }
+}
+
+void setUp(void) {
+    mkdir(FAKE_ROOT, 0755);
+    mkdir(FAKE_SYSFS, 0755);
+    mkdir(FAKE_DEV, 0755);
+    mkdir(FAKE_DEVICE, 0755);
+    mkdir(FAKE_DEVICE "/buffer", 0755);
+    mkdir(FAKE_SCAN, 0755);
+
+    write_file(FAKE_DEVICE "/name", "mt7621-adc\n");
+    write_file(FAKE_DEVICE "/in_voltage0_raw", "734\n");
+    write_file(FAKE_DEVICE "/buffer/enable", "0\n");
+    write_file(FAKE_DEVICE "/buffer/length", "2\n");
+    write_file(FAKE_DEVICE "/buffer/watermark", "1\n");
+    write_file(FAKE_SCAN "/in_voltage0_en", "0\n");
+    write_file(FAKE_SCAN "/in_voltage0_type", "le:u12/16>>0\n");
+    write_file(FAKE_SCAN "/in_voltage1_en", "1\n");
+    write_file(FAKE_SCAN "/in_voltage1_type", "le:u12/16>>0\n");
+    write_file(FAKE_SCAN "/in_timestamp_en", "1\n");
+    write_chardev(NULL, 0);
+
+    adc_iio_set_roots(FAKE_SYSFS, FAKE_DEV);
+}
+
+void tearDown(void) {
+    adc_iio_set_roots(NULL, NULL);
+    if (system("rm -rf " FAKE_ROOT) != 0) {
+        // 清理失敗不影響測試結果
+    }
+}
+
+// ========================================
+// sysfs 單次讀取測試
+// ========================================
+
+void test_adc_iio_find_device_by_name(void) {
+    TEST_ASSERT_EQUAL_INT(0, adc_iio_find_device("mt7621-adc"));
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_NOT_FOUND, adc_iio_find_device("no-such-adc"));
+}
+
+void test_adc_iio_read_raw(void) {
+    TEST_ASSERT_EQUAL_INT(734, adc_iio_read_raw(0, 0));
+}
+
+void test_adc_iio_read_raw_missing_channel(void) {
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_IO, adc_iio_read_raw(0, 7));
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM, adc_iio_read_raw(-1, 0));
+}
+
+// ========================================
+// scan type 解析與解碼測試
+// ========================================
+
+void test_adc_iio_parse_type_le_unsigned(void) {
+    adc_iio_scan_type_t type;
+
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, adc_iio_parse_type("le:u12/16>>4", &type));
+    TEST_ASSERT_FALSE(type.big_endian);
+    TEST_ASSERT_FALSE(type.is_signed);
+    TEST_ASSERT_EQUAL_UINT8(12, type.realbits);
+    TEST_ASSERT_EQUAL_UINT8(16, type.storagebits);
+    TEST_ASSERT_EQUAL_UINT8(4, type.shift);
+}
+
+void test_adc_iio_parse_type_be_signed_repeat(void) {
+    adc_iio_scan_type_t type;
+
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, adc_iio_parse_type("be:s24/32X2>>8", &type));
+    TEST_ASSERT_TRUE(type.big_endian);
+    TEST_ASSERT_TRUE(type.is_signed);
+    TEST_ASSERT_EQUAL_UINT8(24, type.realbits);
+    TEST_ASSERT_EQUAL_UINT8(32, type.storagebits);
+    TEST_ASSERT_EQUAL_UINT8(8, type.shift);
+}
+
+void test_adc_iio_parse_type_invalid(void) {
+    adc_iio_scan_type_t type;
+
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM, adc_iio_parse_type("xx:u12/16", &type));
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM, adc_iio_parse_type("le:u20/16", &type));
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM, adc_iio_parse_type("le:u12/12", &type));
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM, adc_iio_parse_type(NULL, &type));
+}
+
+void test_adc_iio_decode_shift_and_mask(void) {
+    adc_iio_scan_type_t type;
+    adc_iio_parse_type("le:u12/16>>4", &type);
+
+    // 0xABC0 >> 4 = 0xABC
+    const uint8_t le[2] = { 0xC0, 0xAB };
+    TEST_ASSERT_EQUAL_INT(0xABC, adc_iio_decode_sample(&type, le));
+
+    adc_iio_parse_type("be:u12/16>>0", &type);
+    const uint8_t be[2] = { 0xF1, 0x23 };  // 高 4 位元不屬於樣本
+    TEST_ASSERT_EQUAL_INT(0x123, adc_iio_decode_sample(&type, be));
+}
+
+void test_adc_iio_decode_signed(void) {
+    adc_iio_scan_type_t type;
+    adc_iio_parse_type("le:s12/16>>0", &type);
+
+    const uint8_t minus_one[2] = { 0xFF, 0x0F };
+    const uint8_t minimum[2] = { 0x00, 0x08 };
+    TEST_ASSERT_EQUAL_INT(-1, adc_iio_decode_sample(&type, minus_one));
+    TEST_ASSERT_EQUAL_INT(-2048, adc_iio_decode_sample(&type, minimum));
+}
+
+// ========================================
+// 緩衝模式測試
+// ========================================
+
+void test_adc_iio_buffer_open_configures_scan_elements(void) {
+    adc_iio_buffer_config_t config = {
+        .device = 0, .channel = 0, .buffer_length = 512, .watermark = 64,
+    };
+    char value[32];
+
+    adc_iio_buffer_t *buffer = adc_iio_buffer_open(&config);
+    TEST_ASSERT_NOT_NULL(buffer);
+
+    // 只啟用指定通道,其他通道與 timestamp 停用
+    read_file(FAKE_SCAN "/in_voltage0_en", value, sizeof(value));
+    TEST_ASSERT_EQUAL_STRING("1", value);
+    read_file(FAKE_SCAN "/in_voltage1_en", value, sizeof(value));
+    TEST_ASSERT_EQUAL_STRING("0", value);
+    read_file(FAKE_SCAN "/in_timestamp_en", value, sizeof(value));
+    TEST_ASSERT_EQUAL_STRING("0", value);
+
+    read_file(FAKE_DEVICE "/buffer/length", value, sizeof(value));
+    TEST_ASSERT_EQUAL_STRING("512", value);
+    read_file(FAKE_DEVICE "/buffer/watermark", value, sizeof(value));
+    TEST_ASSERT_EQUAL_STRING("64", value);
+    read_file(FAKE_DEVICE "/buffer/enable", value, sizeof(value));
+    TEST_ASSERT_EQUAL_STRING("1", value);
+
+    adc_iio_buffer_close(buffer);
+
+    read_file(FAKE_DEVICE "/buffer/enable", value, sizeof(value));
+    TEST_ASSERT_EQUAL_STRING("0", value);
+}
+
+void test_adc_iio_buffer_read_many_samples_per_call(void) {
+    adc_iio_buffer_config_t config = { .device = 0, .channel = 0 };
+    uint8_t raw[200 * 2];
+    int samples[256];
+
+    for (int i = 0; i < 200; i++) {
+        raw[i * 2] = (uint8_t)(i & 0xFF);
+        raw[i * 2 + 1] = (uint8_t)(i >> 8);
+    }
+    write_chardev(raw, sizeof(raw));
+
+    adc_iio_buffer_t *buffer = adc_iio_buffer_open(&config);
+    TEST_ASSERT_NOT_NULL(buffer);
+
+    int count = adc_iio_buffer_read(buffer, samples, 256, 0);
+
+    TEST_ASSERT_EQUAL_INT(200, count);
+    TEST_ASSERT_EQUAL_INT(0, samples[0]);
+    TEST_ASSERT_EQUAL_INT(199, samples[199]);
+
+    adc_iio_buffer_close(buffer);
+}
+
+void test_adc_iio_buffer_open_missing_type(void) {
+    adc_iio_buffer_config_t config = { .device = 0, .channel = 5 };
+
+    TEST_ASSERT_NULL(adc_iio_buffer_open(&config));
+    TEST_ASSERT_NULL(adc_iio_buffer_open(NULL));
+}
+
+void test_adc_iio_buffer_read_invalid_param(void) {
+    int samples[4];
+
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM,
+                          adc_iio_buffer_read(NULL, samples, 4, 0));
+}
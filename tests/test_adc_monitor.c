@@ -0,0 +1,236 @@
+/**
+ * @file test_adc_monitor.c
+ * @brief ADC Monitor 單元測試
+ *
+ * 以腳本化的取樣函數取代 HAL,驗證環形緩衝、閾值回呼與視窗統計
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "unity.h"
+#include "adc_monitor.h"
+#include "hal_interface.h"
+#include "gaming_common.h"
+#include <string.h>
+#include <time.h>
+
+// ========================================
+// 測試用的 HAL 與取樣來源
+// ========================================
+
+hal_ops_t *hal_ops = NULL;
+
+#define SCRIPT_MAX 64
+
+typedef struct {
+    int values[SCRIPT_MAX];
+    int count;
+    volatile int pos;   // 已讀取次數
+} sample_script_t;
+
+typedef struct {
+    volatile int count;
+    int thresholds[16];
+    adc_cross_t directions[16];
+    int values[16];
+} cross_log_t;
+
+static sample_script_t script;
+static cross_log_t crossings;
+static adc_monitor_t *monitor;
+
+// 依腳本返回樣本,腳本用完後停在最後一個值
+static int scripted_read(const char *device, void *user_data) {
+    sample_script_t *s = user_data;
+    int index = (s->pos < s->count) ? s->pos : s->count - 1;
+    int value = s->values[index];
+    __atomic_add_fetch(&s->pos, 1, __ATOMIC_RELEASE);
+    return value;
+}
+
+static void record_crossing(int threshold, adc_cross_t direction,
+                            const adc_sample_t *sample, void *user_data) {
+    cross_log_t *log = user_data;
+    int i = log->count;
+    if (i < 16) {
+        log->thresholds[i] = threshold;
+        log->directions[i] = direction;
+        log->values[i] = sample->value;
+        __atomic_store_n(&log->count, i + 1, __ATOMIC_RELEASE);
+    }
+}
+
+static void set_script(const int *values, int count) {
+    memcpy(script.values, values, count * sizeof(int));
+    script.count = count;
+    script.pos = 0;
+}
+
+static adc_monitor_t* create_scripted_monitor(unsigned int ring_size) {
+    adc_monitor_config_t config = {
+        .device = "/dev/test_adc",
+        .interval_ms = 1,
+        .ring_size = ring_size,
+        .read = scripted_read,
+        .read_user_data = &script,
+    };
+    return adc_monitor_create(&config);
+}
+
+// 等待取樣執行緒讀完腳本
+static void wait_for_reads(int reads) {
+    for (int i = 0; i < 2000; i++) {
+        if (__atomic_load_n(&script.pos, __ATOMIC_ACQUIRE) >= reads) {
+            return;
+        }
+        struct timespec ts = { 0, 1000000L };
+        nanosleep(&ts, NULL);
+    }
+}
+
+void setUp(void)
+{
+    memset(&script, 0, sizeof(script));
+    memset(&crossings, 0, sizeof(crossings));
+    monitor = NULL;
+    hal_ops = NULL;
+}
+
+void tearDown(void)
+{
+    adc_monitor_destroy(monitor);
+}
+
+// ========================================
+// 建立與啟動測試
+// ========================================
+
+void test_adc_monitor_create_invalid_config(void)
+{
+    adc_monitor_config_t config = { .ring_size = ADC_MONITOR_MAX_RING_SIZE + 1 };
+    TEST_ASSERT_NULL(adc_monitor_create(&config));
+
+    config.ring_size = 0;
+    config.interval_ms = -1;
+    TEST_ASSERT_NULL(adc_monitor_create(&config));
+}
+
+void test_adc_monitor_start_without_hal(void)
+{
+    monitor = adc_monitor_create(NULL);
+    TEST_ASSERT_NOT_NULL(monitor);
+
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_NOT_INITIALIZED, adc_monitor_start(monitor));
+}
+
+void test_adc_monitor_no_samples_yet(void)
+{
+    adc_sample_t sample;
+    adc_monitor_stats_t stats;
+
+    monitor = create_scripted_monitor(8);
+
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_NOT_FOUND, adc_monitor_latest(monitor, &sample));
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_NOT_FOUND, adc_monitor_get_stats(monitor, 0, &stats));
+}
+
+// ========================================
+// 環形緩衝測試
+// ========================================
+
+void test_adc_monitor_snapshot_keeps_newest_in_order(void)
+{
+    int values[20];
+    adc_sample_t samples[16];
+
+    for (int i = 0; i < 20; i++) {
+        values[i] = 100 + i;
+    }
+    set_script(values, 20);
+
+    monitor = create_scripted_monitor(8);
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, adc_monitor_start(monitor));
+    wait_for_reads(20);
+    adc_monitor_stop(monitor);
+
+    // 環形緩衝只保留最新的 8 個 (含腳本結束後重複的最後值)
+    int count = adc_monitor_snapshot(monitor, samples, 16);
+    TEST_ASSERT_EQUAL_INT(8, count);
+    for (int i = 1; i < count; i++) {
+        TEST_ASSERT_TRUE(samples[i].value >= samples[i - 1].value);
+        TEST_ASSERT_TRUE(samples[i].timestamp_ms >= samples[i - 1].timestamp_ms);
+    }
+    TEST_ASSERT_EQUAL_INT(119, samples[count - 1].value);
+
+    adc_sample_t latest;
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, adc_monitor_latest(monitor, &latest));
+    TEST_ASSERT_EQUAL_INT(119, latest.value);
+}
+
+void test_adc_monitor_window_stats(void)
+{
+    const int values[] = { 10, 50, 30, 20, 40 };
+    adc_monitor_stats_t stats;
+    uint32_t total;
+
+    set_script(values, 5);
+
+    monitor = create_scripted_monitor(64);
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, adc_monitor_start(monitor));
+    wait_for_reads(5);
+    adc_monitor_stop(monitor);
+
+    adc_monitor_get_counters(monitor, &total, NULL);
+    TEST_ASSERT_TRUE(total >= 5);
+
+    // 最舊的 5 個樣本在視窗之外時,視窗內只剩重複的最後值
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, adc_monitor_get_stats(monitor, 1, &stats));
+    TEST_ASSERT_EQUAL_INT(1, stats.count);
+    TEST_ASSERT_EQUAL_INT(40, stats.min);
+    TEST_ASSERT_EQUAL_INT(40, stats.max);
+
+    // 整個緩衝區: min/max 涵蓋全部腳本值
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, adc_monitor_get_stats(monitor, 0, &stats));
+    TEST_ASSERT_EQUAL_INT((int)total, stats.count);
+    TEST_ASSERT_EQUAL_INT(10, stats.min);
+    TEST_ASSERT_EQUAL_INT(50, stats.max);
+    TEST_ASSERT_TRUE(stats.last_ms >= stats.first_ms);
+}
+
+// ========================================
+// 閾值回呼測試
+// ========================================
+
+void test_adc_monitor_threshold_crossings_with_hysteresis(void)
+{
+    // 在 500 ± 10 附近擺動的雜訊不應觸發,只有明確越過才觸發
+    const int values[] = { 400, 505, 495, 509, 511, 505, 491, 495, 489, 480 };
+    set_script(values, 10);
+
+    monitor = create_scripted_monitor(64);
+    TEST_ASSERT_EQUAL_INT(GAMING_OK,
+                          adc_monitor_add_threshold(monitor, 500, 10, record_crossing, &crossings));
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, adc_monitor_start(monitor));
+    wait_for_reads(10);
+    adc_monitor_stop(monitor);
+
+    TEST_ASSERT_EQUAL_INT(2, crossings.count);
+    TEST_ASSERT_EQUAL_INT(ADC_CROSS_RISING, crossings.directions[0]);
+    TEST_ASSERT_EQUAL_INT(511, crossings.values[0]);
+    TEST_ASSERT_EQUAL_INT(ADC_CROSS_FALLING, crossings.directions[1]);
+    TEST_ASSERT_EQUAL_INT(489, crossings.values[1]);
+}
+
+void test_adc_monitor_add_threshold_while_running(void)
+{
+    const int values[] = { 1 };
+    set_script(values, 1);
+
+    monitor = create_scripted_monitor(8);
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM,
+                          adc_monitor_add_threshold(monitor, 1, 0, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, adc_monitor_start(monitor));
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_ALREADY_EXISTS,
+                          adc_monitor_add_threshold(monitor, 1, 0, record_crossing, &crossings));
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_ALREADY_EXISTS, adc_monitor_start(monitor));
+}
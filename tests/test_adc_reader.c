@@ -12,6 +12,8 @@
 #include "unity.h"
 #include "mock_hal_interface.h"
 #include "adc_reader.h"
+#include "config_parser.h"
+#include "logger.h"
 #include "gaming_common.h"
 #include <string.h>
 
@@ -313,3 +315,128 @@ void test_adc_reader_full_flow_server(void)
     device_type_t cached_type = adc_reader_get_cached_device_type();
     TEST_ASSERT_EQUAL(DEVICE_TYPE_SERVER, cached_type);
 }
+
+// ========================================
+// 濾波與遲滯測試
+// ========================================
+
+static void use_test_config(int samples, int hysteresis, adc_filter_t filter)
+{
+    adc_reader_config_t config;
+    adc_reader_get_config(&config);
+    strcpy(config.device, DEVICE_ADC);
+    config.threshold = ADC_THRESHOLD_CLIENT_SERVER;
+    config.hysteresis = hysteresis;
+    config.samples = samples;
+    config.filter = filter;
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, adc_reader_set_config(&config));
+}
+
+void test_adc_reader_filter_median_odd(void)
+{
+    int samples[] = { 500, 1023, 498, 0, 502 };
+    
+    int value = adc_reader_filter_samples(samples, 5, ADC_FILTER_MEDIAN);
+    
+    TEST_ASSERT_EQUAL_INT(500, value);
+}
+
+void test_adc_reader_filter_median_even(void)
+{
+    int samples[] = { 10, 40, 20, 30 };
+    
+    int value = adc_reader_filter_samples(samples, 4, ADC_FILTER_MEDIAN);
+    
+    TEST_ASSERT_EQUAL_INT(25, value);
+}
+
+void test_adc_reader_filter_trimmed_mean_drops_outliers(void)
+{
+    // 8 個樣本頭尾各去掉 2 個 (0, 1 與 1000, 1023)
+    int samples[] = { 1023, 500, 0, 502, 1000, 504, 1, 506 };
+    
+    int value = adc_reader_filter_samples(samples, 8, ADC_FILTER_TRIMMED_MEAN);
+    
+    TEST_ASSERT_EQUAL_INT(503, value);
+}
+
+void test_adc_reader_filter_invalid_param(void)
+{
+    int samples[] = { 1 };
+    
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM,
+                          adc_reader_filter_samples(NULL, 1, ADC_FILTER_MEDIAN));
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM,
+                          adc_reader_filter_samples(samples, 0, ADC_FILTER_MEDIAN));
+}
+
+void test_adc_reader_classify_with_hysteresis(void)
+{
+    use_test_config(1, 16, ADC_FILTER_MEDIAN);
+    
+    // 無先前結果: 直接與閾值比較
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_CLIENT, adc_reader_classify(511, DEVICE_TYPE_UNKNOWN));
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_SERVER, adc_reader_classify(512, DEVICE_TYPE_UNKNOWN));
+    
+    // Client 需到 threshold + hysteresis 才改判 Server
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_CLIENT, adc_reader_classify(527, DEVICE_TYPE_CLIENT));
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_SERVER, adc_reader_classify(528, DEVICE_TYPE_CLIENT));
+    
+    // Server 需低於 threshold - hysteresis 才改判 Client
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_SERVER, adc_reader_classify(496, DEVICE_TYPE_SERVER));
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_CLIENT, adc_reader_classify(495, DEVICE_TYPE_SERVER));
+}
+
+void test_adc_reader_set_config_invalid(void)
+{
+    adc_reader_config_t config;
+    adc_reader_get_config(&config);
+    
+    config.samples = 0;
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM, adc_reader_set_config(&config));
+    
+    config.samples = ADC_READER_MAX_SAMPLES + 1;
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM, adc_reader_set_config(&config));
+    
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM, adc_reader_set_config(NULL));
+}
+
+void test_adc_reader_read_filtered_uses_burst(void)
+{
+    int burst[] = { 300, 1023, 301, 299, 302 };
+    
+    test_hal_ops_instance.adc_read_burst = hal_adc_read_burst;
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, adc_reader_init());
+    use_test_config(5, 0, ADC_FILTER_MEDIAN);
+    
+    // 一次 burst 讀取,不逐次開關設備
+    hal_adc_read_burst_ExpectAndReturn(DEVICE_ADC, NULL, 5, 5);
+    hal_adc_read_burst_IgnoreArg_samples();
+    hal_adc_read_burst_ReturnArrayThruPtr_samples(burst, 5);
+    
+    TEST_ASSERT_EQUAL_INT(301, adc_reader_read_filtered(NULL));
+    
+    adc_reader_cleanup();
+    test_hal_ops_instance.adc_read_burst = NULL;
+}
+
+void test_adc_reader_detect_does_not_flap_near_threshold(void)
+{
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, adc_reader_init());
+    use_test_config(1, 16, ADC_FILTER_MEDIAN);
+    
+    hal_adc_read_ExpectAndReturn(DEVICE_ADC, 500);
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_CLIENT, adc_reader_detect_device_type());
+    
+    // 雜訊在閾值附近擺動,判定維持不變
+    hal_adc_read_ExpectAndReturn(DEVICE_ADC, 520);
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_CLIENT, adc_reader_detect_device_type());
+    hal_adc_read_ExpectAndReturn(DEVICE_ADC, 505);
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_CLIENT, adc_reader_detect_device_type());
+    
+    // 明確越過遲滯區間才切換
+    hal_adc_read_ExpectAndReturn(DEVICE_ADC, 600);
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_SERVER, adc_reader_detect_device_type());
+    
+    adc_reader_cleanup();
+}
@@ -114,6 +114,48 @@ void test_config_parser_commit_null_param(void) {
     TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, result);
 }
 
+// ========================================
+// 重新載入回呼測試
+// ========================================
+
+static int reload_a_calls;
+static int reload_b_calls;
+
+static int reload_a(void) {
+    reload_a_calls++;
+    return GAMING_OK;
+}
+
+static int reload_b(void) {
+    reload_b_calls++;
+    return GAMING_ERROR_INVALID_PARAM;
+}
+
+void test_config_parser_reload_runs_hooks(void) {
+    reload_a_calls = 0;
+    reload_b_calls = 0;
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, config_parser_add_reload_hook(NULL));
+    TEST_ASSERT_EQUAL(GAMING_OK, config_parser_add_reload_hook(reload_b));
+    TEST_ASSERT_EQUAL(GAMING_OK, config_parser_add_reload_hook(reload_a));
+    // 重複註冊只執行一次
+    TEST_ASSERT_EQUAL(GAMING_OK, config_parser_add_reload_hook(reload_a));
+
+    // 失敗的回呼不影響其他回呼
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, config_parser_reload());
+    TEST_ASSERT_EQUAL(1, reload_a_calls);
+    TEST_ASSERT_EQUAL(1, reload_b_calls);
+
+    config_parser_remove_reload_hook(reload_b);
+    TEST_ASSERT_EQUAL(GAMING_OK, config_parser_reload());
+    TEST_ASSERT_EQUAL(2, reload_a_calls);
+    TEST_ASSERT_EQUAL(1, reload_b_calls);
+
+    config_parser_remove_reload_hook(reload_a);
+    TEST_ASSERT_EQUAL(GAMING_OK, config_parser_reload());
+    TEST_ASSERT_EQUAL(2, reload_a_calls);
+}
+
 // ========================================
 // 完整流程測試
 // ========================================
@@ -0,0 +1,134 @@
+/**
+ * @file test_device_detect.c
+ * @brief Device Detect 單元測試
+ *
+ * 驗證快取檔案的讀寫與判定優先順序 (HAL 未初始化時略過 ADC)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "unity.h"
+#include "device_detect.h"
+#include "adc_reader.h"
+#include "config_parser.h"
+#include "logger.h"
+#include "hal_interface.h"
+#include "gaming_common.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// ========================================
+// 測試設置
+// ========================================
+
+hal_ops_t *hal_ops = NULL;
+
+#define TEST_CACHE_PATH "/tmp/test_device_detect_cache"
+
+static void write_cache_text(const char *text) {
+    FILE *fp = fopen(TEST_CACHE_PATH, "w");
+    if (fp) {
+        fputs(text, fp);
+        fclose(fp);
+    }
+}
+
+void setUp(void)
+{
+    hal_ops = NULL;
+    remove(TEST_CACHE_PATH);
+}
+
+void tearDown(void)
+{
+    remove(TEST_CACHE_PATH);
+}
+
+// ========================================
+// 字串轉換測試
+// ========================================
+
+void test_device_detect_parse_type(void)
+{
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_CLIENT, device_detect_parse_type("client"));
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_SERVER, device_detect_parse_type("  server\n"));
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_UNKNOWN, device_detect_parse_type("Client"));
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_UNKNOWN, device_detect_parse_type("clientx"));
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_UNKNOWN, device_detect_parse_type(""));
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_UNKNOWN, device_detect_parse_type(NULL));
+}
+
+void test_device_detect_type_name(void)
+{
+    TEST_ASSERT_EQUAL_STRING("client", device_detect_type_name(DEVICE_TYPE_CLIENT));
+    TEST_ASSERT_EQUAL_STRING("server", device_detect_type_name(DEVICE_TYPE_SERVER));
+    TEST_ASSERT_EQUAL_STRING("unknown", device_detect_type_name(DEVICE_TYPE_UNKNOWN));
+}
+
+// ========================================
+// 快取檔案測試
+// ========================================
+
+void test_device_detect_read_cache_missing(void)
+{
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_UNKNOWN, device_detect_read_cache(TEST_CACHE_PATH));
+}
+
+void test_device_detect_read_cache_invalid(void)
+{
+    write_cache_text("router\n");
+
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_UNKNOWN, device_detect_read_cache(TEST_CACHE_PATH));
+}
+
+void test_device_detect_write_cache_roundtrip(void)
+{
+    TEST_ASSERT_EQUAL_INT(GAMING_OK,
+                          device_detect_write_cache(TEST_CACHE_PATH, DEVICE_TYPE_SERVER));
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_SERVER, device_detect_read_cache(TEST_CACHE_PATH));
+
+    // 覆寫既有快取
+    TEST_ASSERT_EQUAL_INT(GAMING_OK,
+                          device_detect_write_cache(TEST_CACHE_PATH, DEVICE_TYPE_CLIENT));
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_CLIENT, device_detect_read_cache(TEST_CACHE_PATH));
+
+    // 不留下暫存檔
+    char tmp_path[256];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%d.tmp", TEST_CACHE_PATH, (int)getpid());
+    TEST_ASSERT_NOT_EQUAL(0, access(tmp_path, F_OK));
+}
+
+void test_device_detect_write_cache_rejects_unknown(void)
+{
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM,
+                          device_detect_write_cache(TEST_CACHE_PATH, DEVICE_TYPE_UNKNOWN));
+    TEST_ASSERT_NOT_EQUAL(0, access(TEST_CACHE_PATH, F_OK));
+}
+
+void test_device_detect_write_cache_bad_directory(void)
+{
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_IO,
+                          device_detect_write_cache("/tmp/nonexistent_dir/cache",
+                                                    DEVICE_TYPE_CLIENT));
+}
+
+// ========================================
+// 判定流程測試
+// ========================================
+
+void test_device_detect_run_prefers_cache(void)
+{
+    device_source_t source = DEVICE_SOURCE_NONE;
+    write_cache_text("client\n");
+
+    device_type_t type = device_detect_run(TEST_CACHE_PATH, &source);
+
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_CLIENT, type);
+    TEST_ASSERT_EQUAL(DEVICE_SOURCE_CACHE, source);
+}
+
+void test_device_detect_from_adc_without_hal(void)
+{
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_UNKNOWN, device_detect_from_adc());
+}
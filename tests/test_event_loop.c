@@ -0,0 +1,491 @@
+/**
+ * @file test_event_loop.c
+ * @brief Event Loop 單元測試
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "unity.h"
+#include "event_loop.h"
+#include "logger.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+
+// ========================================
+// 測試輔助
+// ========================================
+
+static event_loop_t *loop = NULL;
+static int pipe_fds[2] = { -1, -1 };
+
+typedef struct {
+    int calls;
+    int last_fd;
+    uint32_t last_events;
+    uint64_t expirations;
+    int bytes;
+} counter_t;
+
+static long long now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void make_pipe(void) {
+    TEST_ASSERT_EQUAL(0, pipe(pipe_fds));
+    fcntl(pipe_fds[0], F_SETFL, O_NONBLOCK);
+}
+
+/**
+ * @brief 執行迴圈直到 condition 成立或逾時
+ */
+static void run_until(const int *value, int expected, int timeout_ms) {
+    long long deadline = now_ms() + timeout_ms;
+    while (*value < expected && now_ms() < deadline) {
+        event_loop_run_once(loop, 10);
+    }
+}
+
+static void on_count(event_loop_t *l, int fd, uint32_t events, void *user_data) {
+    counter_t *c = user_data;
+    c->calls++;
+    c->last_fd = fd;
+    c->last_events = events;
+}
+
+// 只讀一個位元組: level 模式會繼續通知,edge 模式不會
+static void on_read_one(event_loop_t *l, int fd, uint32_t events, void *user_data) {
+    counter_t *c = user_data;
+    char ch;
+    c->calls++;
+    if (read(fd, &ch, 1) == 1) {
+        c->bytes++;
+    }
+}
+
+static void on_timer(event_loop_t *l, int timer_id, uint64_t expirations, void *user_data) {
+    counter_t *c = user_data;
+    c->calls++;
+    c->last_fd = timer_id;
+    c->expirations += expirations;
+}
+
+void setUp(void) {
+    loop = event_loop_create();
+    TEST_ASSERT_NOT_NULL(loop);
+}
+
+void tearDown(void) {
+    event_loop_destroy(loop);
+    loop = NULL;
+    for (int i = 0; i < 2; i++) {
+        if (pipe_fds[i] >= 0) {
+            close(pipe_fds[i]);
+            pipe_fds[i] = -1;
+        }
+    }
+}
+
+// ========================================
+// fd 註冊測試
+// ========================================
+
+void test_event_loop_add_fd_invalid_params(void) {
+    counter_t c = { 0 };
+    make_pipe();
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, event_loop_add_fd(NULL, pipe_fds[0], EVENT_READ, on_count, &c));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, event_loop_add_fd(loop, -1, EVENT_READ, on_count, &c));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, event_loop_add_fd(loop, pipe_fds[0], EVENT_READ, NULL, &c));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, event_loop_add_fd(loop, pipe_fds[0], 0x100, on_count, &c));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_add_fd(loop, pipe_fds[0], EVENT_READ, on_count, &c));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_ALREADY_EXISTS,
+                      event_loop_add_fd(loop, pipe_fds[0], EVENT_READ, on_count, &c));
+    TEST_ASSERT_EQUAL(1, event_loop_source_count(loop));
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_NOT_FOUND, event_loop_remove_fd(loop, pipe_fds[1]));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_NOT_FOUND, event_loop_modify_fd(loop, pipe_fds[1], EVENT_WRITE));
+}
+
+void test_event_loop_regular_file_rejected(void) {
+    counter_t c = { 0 };
+    int fd = open("/dev/null", O_RDONLY);
+    TEST_ASSERT_TRUE(fd >= 0);
+
+    // /dev/null 是字元裝置,epoll 不支援
+    TEST_ASSERT_EQUAL(GAMING_ERROR, event_loop_add_fd(loop, fd, EVENT_READ, on_count, &c));
+    TEST_ASSERT_EQUAL(0, event_loop_source_count(loop));
+    close(fd);
+}
+
+void test_event_loop_fd_readable(void) {
+    counter_t c = { 0 };
+    make_pipe();
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_add_fd(loop, pipe_fds[0], EVENT_READ, on_count, &c));
+
+    // 沒有資料時逾時返回 0
+    TEST_ASSERT_EQUAL(0, event_loop_run_once(loop, 0));
+    TEST_ASSERT_EQUAL(0, c.calls);
+
+    TEST_ASSERT_EQUAL(1, write(pipe_fds[1], "x", 1));
+    TEST_ASSERT_EQUAL(1, event_loop_run_once(loop, 100));
+    TEST_ASSERT_EQUAL(1, c.calls);
+    TEST_ASSERT_EQUAL(pipe_fds[0], c.last_fd);
+    TEST_ASSERT_EQUAL_HEX32(EVENT_READ, c.last_events);
+}
+
+void test_event_loop_level_vs_edge(void) {
+    counter_t level = { 0 };
+    counter_t edge = { 0 };
+    int sv[2];
+    make_pipe();
+    TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sv));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_add_fd(loop, pipe_fds[0], EVENT_READ, on_read_one, &level));
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_add_fd(loop, sv[0], EVENT_READ | EVENT_EDGE,
+                                                   on_read_one, &edge));
+
+    TEST_ASSERT_EQUAL(3, write(pipe_fds[1], "abc", 3));
+    TEST_ASSERT_EQUAL(3, write(sv[1], "abc", 3));
+    for (int i = 0; i < 5; i++) {
+        event_loop_run_once(loop, 10);
+    }
+
+    // level: 每次還有資料就通知;edge: 只在新資料到達時通知一次
+    TEST_ASSERT_EQUAL(3, level.bytes);
+    TEST_ASSERT_EQUAL(1, edge.calls);
+    TEST_ASSERT_EQUAL(1, edge.bytes);
+
+    close(sv[0]);
+    close(sv[1]);
+}
+
+void test_event_loop_modify_fd_write(void) {
+    counter_t c = { 0 };
+    make_pipe();
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_add_fd(loop, pipe_fds[1], 0, on_count, &c));
+
+    TEST_ASSERT_EQUAL(0, event_loop_run_once(loop, 0));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_modify_fd(loop, pipe_fds[1], EVENT_WRITE));
+    TEST_ASSERT_EQUAL(1, event_loop_run_once(loop, 100));
+    TEST_ASSERT_EQUAL_HEX32(EVENT_WRITE, c.last_events);
+}
+
+void test_event_loop_exclusive_cannot_be_modified(void) {
+    counter_t c = { 0 };
+    make_pipe();
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_add_fd(loop, pipe_fds[0], EVENT_READ | EVENT_EXCLUSIVE,
+                                                   on_count, &c));
+
+    TEST_ASSERT_EQUAL(1, write(pipe_fds[1], "x", 1));
+    TEST_ASSERT_EQUAL(1, event_loop_run_once(loop, 100));
+    TEST_ASSERT_EQUAL_HEX32(EVENT_READ, c.last_events);
+
+    // EPOLLEXCLUSIVE 不能以 EPOLL_CTL_MOD 變更
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, event_loop_modify_fd(loop, pipe_fds[0], EVENT_READ));
+}
+
+void test_event_loop_peer_close_reports_error(void) {
+    counter_t c = { 0 };
+    make_pipe();
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_add_fd(loop, pipe_fds[0], EVENT_READ, on_count, &c));
+
+    close(pipe_fds[1]);
+    pipe_fds[1] = -1;
+
+    TEST_ASSERT_EQUAL(1, event_loop_run_once(loop, 100));
+    TEST_ASSERT_TRUE(c.last_events & EVENT_ERROR);
+}
+
+static int remove_pair[2] = { -1, -1 };
+
+// 移除自己與另一個 fd
+static void on_remove_both(event_loop_t *l, int fd, uint32_t events, void *user_data) {
+    counter_t *c = user_data;
+    c->calls++;
+    event_loop_remove_fd(l, remove_pair[0]);
+    event_loop_remove_fd(l, remove_pair[1]);
+}
+
+void test_event_loop_remove_inside_callback(void) {
+    counter_t c = { 0 };
+    int sv[2];
+    make_pipe();
+    TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+
+    remove_pair[0] = pipe_fds[0];
+    remove_pair[1] = sv[0];
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_add_fd(loop, pipe_fds[0], EVENT_READ, on_remove_both, &c));
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_add_fd(loop, sv[0], EVENT_READ, on_remove_both, &c));
+    TEST_ASSERT_EQUAL(1, write(pipe_fds[1], "x", 1));
+    TEST_ASSERT_EQUAL(1, write(sv[1], "x", 1));
+
+    // 兩個 fd 在同一批就緒,先處理的回呼移除兩者,另一個事件必須被略過
+    TEST_ASSERT_EQUAL(2, event_loop_run_once(loop, 100));
+    TEST_ASSERT_EQUAL(1, c.calls);
+    TEST_ASSERT_EQUAL(0, event_loop_source_count(loop));
+
+    // 同一個 fd 號碼重新註冊後正常運作
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_add_fd(loop, sv[0], EVENT_READ, on_count, &c));
+    TEST_ASSERT_EQUAL(1, event_loop_run_once(loop, 100));
+    TEST_ASSERT_EQUAL(2, c.calls);
+
+    close(sv[0]);
+    close(sv[1]);
+}
+
+void test_event_loop_fd_above_fd_setsize(void) {
+    struct rlimit rl;
+    counter_t c = { 0 };
+    int high_fd = FD_SETSIZE + 32;
+
+    if (getrlimit(RLIMIT_NOFILE, &rl) != 0 || rl.rlim_cur <= (rlim_t)high_fd) {
+        TEST_IGNORE_MESSAGE("RLIMIT_NOFILE too low for fd above FD_SETSIZE");
+    }
+
+    make_pipe();
+    TEST_ASSERT_EQUAL(high_fd, dup2(pipe_fds[0], high_fd));
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_add_fd(loop, high_fd, EVENT_READ, on_count, &c));
+
+    TEST_ASSERT_EQUAL(1, write(pipe_fds[1], "x", 1));
+    TEST_ASSERT_EQUAL(1, event_loop_run_once(loop, 100));
+    TEST_ASSERT_EQUAL(high_fd, c.last_fd);
+
+    event_loop_remove_fd(loop, high_fd);
+    close(high_fd);
+}
+
+// ========================================
+// 計時器測試
+// ========================================
+
+void test_event_loop_timer_invalid_params(void) {
+    counter_t c = { 0 };
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, event_loop_add_timer(loop, 0, 10, on_timer, &c));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, event_loop_add_timer(loop, 10, 10, NULL, &c));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_NOT_FOUND, event_loop_remove_timer(loop, 12345));
+}
+
+void test_event_loop_oneshot_timer(void) {
+    counter_t c = { 0 };
+    long long start = now_ms();
+
+    int id = event_loop_add_timer(loop, 20, 0, on_timer, &c);
+    TEST_ASSERT_TRUE(id > 0);
+    TEST_ASSERT_EQUAL(1, event_loop_source_count(loop));
+
+    run_until(&c.calls, 1, 1000);
+    TEST_ASSERT_EQUAL(1, c.calls);
+    TEST_ASSERT_EQUAL(id, c.last_fd);
+    TEST_ASSERT_TRUE(now_ms() - start >= 19);
+
+    // 觸發後自動移除
+    TEST_ASSERT_EQUAL(0, event_loop_source_count(loop));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_NOT_FOUND, event_loop_remove_timer(loop, id));
+}
+
+void test_event_loop_periodic_timer(void) {
+    counter_t c = { 0 };
+
+    int id = event_loop_add_timer(loop, 5, 5, on_timer, &c);
+    TEST_ASSERT_TRUE(id > 0);
+
+    run_until(&c.calls, 3, 1000);
+    TEST_ASSERT_TRUE(c.calls >= 3);
+
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_remove_timer(loop, id));
+    int calls = c.calls;
+    event_loop_run_once(loop, 20);
+    TEST_ASSERT_EQUAL(calls, c.calls);
+}
+
+void test_event_loop_timer_reports_missed_expirations(void) {
+    counter_t c = { 0 };
+
+    TEST_ASSERT_TRUE(event_loop_add_timer(loop, 2, 2, on_timer, &c) > 0);
+
+    // 迴圈忙碌時到期次數累積在 timerfd
+    usleep(20000);
+    TEST_ASSERT_EQUAL(1, event_loop_run_once(loop, 100));
+    TEST_ASSERT_EQUAL(1, c.calls);
+    TEST_ASSERT_TRUE(c.expirations >= 5);
+}
+
+// ========================================
+// 訊號與喚醒測試
+// ========================================
+
+static void on_signal(event_loop_t *l, int signo, void *user_data) {
+    counter_t *c = user_data;
+    c->calls++;
+    c->last_fd = signo;
+}
+
+void test_event_loop_signal(void) {
+    counter_t c = { 0 };
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, event_loop_add_signal(loop, SIGKILL, on_signal, &c));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, event_loop_add_signal(loop, 0, on_signal, &c));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_add_signal(loop, SIGUSR2, on_signal, &c));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_ALREADY_EXISTS, event_loop_add_signal(loop, SIGUSR2, on_signal, &c));
+    TEST_ASSERT_EQUAL(1, event_loop_source_count(loop));
+
+    // 已封鎖,不會以預設動作結束程式
+    TEST_ASSERT_EQUAL(0, kill(getpid(), SIGUSR2));
+    run_until(&c.calls, 1, 1000);
+    TEST_ASSERT_EQUAL(1, c.calls);
+    TEST_ASSERT_EQUAL(SIGUSR2, c.last_fd);
+
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_remove_signal(loop, SIGUSR2));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_NOT_FOUND, event_loop_remove_signal(loop, SIGUSR2));
+    TEST_ASSERT_EQUAL(0, event_loop_source_count(loop));
+}
+
+static volatile sig_atomic_t handled_signo;
+
+static void record_signal(int signo) {
+    handled_signo = signo;
+}
+
+void test_event_loop_remove_signal_unblocks(void) {
+    counter_t c = { 0 };
+    struct sigaction sa, old_sa;
+    sigset_t blocked;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = record_signal;
+    sigaction(SIGUSR2, &sa, &old_sa);
+    handled_signo = 0;
+
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_add_signal(loop, SIGUSR2, on_signal, &c));
+    pthread_sigmask(SIG_BLOCK, NULL, &blocked);
+    TEST_ASSERT_TRUE(sigismember(&blocked, SIGUSR2));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_remove_signal(loop, SIGUSR2));
+    pthread_sigmask(SIG_BLOCK, NULL, &blocked);
+    TEST_ASSERT_FALSE(sigismember(&blocked, SIGUSR2));
+
+    // 移除後回到 sigaction 設定的處理函數,不再經過迴圈
+    TEST_ASSERT_EQUAL(0, raise(SIGUSR2));
+    TEST_ASSERT_EQUAL(SIGUSR2, handled_signo);
+    event_loop_run_once(loop, 0);
+    TEST_ASSERT_EQUAL(0, c.calls);
+
+    sigaction(SIGUSR2, &old_sa, NULL);
+}
+
+void test_event_loop_remove_signal_keeps_caller_block(void) {
+    counter_t c = { 0 };
+    sigset_t single, blocked;
+
+    // 註冊前已封鎖的訊號,移除或銷毀迴圈後仍維持封鎖
+    sigemptyset(&single);
+    sigaddset(&single, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &single, NULL);
+
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_add_signal(loop, SIGUSR1, on_signal, &c));
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_remove_signal(loop, SIGUSR1));
+    pthread_sigmask(SIG_BLOCK, NULL, &blocked);
+    TEST_ASSERT_TRUE(sigismember(&blocked, SIGUSR1));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_add_signal(loop, SIGUSR1, on_signal, &c));
+    event_loop_destroy(loop);
+    loop = event_loop_create();
+    TEST_ASSERT_NOT_NULL(loop);
+    pthread_sigmask(SIG_BLOCK, NULL, &blocked);
+    TEST_ASSERT_TRUE(sigismember(&blocked, SIGUSR1));
+
+    pthread_sigmask(SIG_UNBLOCK, &single, NULL);
+}
+
+void test_event_loop_destroy_unblocks_registered_signal(void) {
+    counter_t c = { 0 };
+    sigset_t blocked;
+
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_add_signal(loop, SIGUSR2, on_signal, &c));
+    event_loop_destroy(loop);
+    loop = event_loop_create();
+    TEST_ASSERT_NOT_NULL(loop);
+
+    pthread_sigmask(SIG_BLOCK, NULL, &blocked);
+    TEST_ASSERT_FALSE(sigismember(&blocked, SIGUSR2));
+}
+
+static void on_wakeup(event_loop_t *l, void *user_data) {
+    counter_t *c = user_data;
+    c->calls++;
+}
+
+static void *wake_from_thread(void *arg) {
+    usleep(10000);
+    event_loop_wakeup(arg);
+    event_loop_wakeup(arg);
+    return NULL;
+}
+
+static void *stop_from_thread(void *arg) {
+    usleep(10000);
+    event_loop_stop(arg);
+    return NULL;
+}
+
+void test_event_loop_cross_thread_wakeup(void) {
+    counter_t c = { 0 };
+    pthread_t thread;
+
+    event_loop_set_wakeup_handler(loop, on_wakeup, &c);
+    pthread_create(&thread, NULL, wake_from_thread, loop);
+    pthread_join(thread, NULL);
+
+    // 兩次喚醒合併為一次回呼
+    TEST_ASSERT_EQUAL(1, event_loop_run_once(loop, 1000));
+    TEST_ASSERT_EQUAL(1, c.calls);
+    TEST_ASSERT_EQUAL(0, event_loop_run_once(loop, 0));
+}
+
+void test_event_loop_run_until_stop(void) {
+    counter_t c = { 0 };
+    pthread_t thread;
+
+    TEST_ASSERT_TRUE(event_loop_add_timer(loop, 1, 1, on_timer, &c) > 0);
+    pthread_create(&thread, NULL, stop_from_thread, loop);
+
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_run(loop));
+    pthread_join(thread, NULL);
+    TEST_ASSERT_TRUE(c.calls > 0);
+
+    // 停止後可再次執行
+    event_loop_stop(loop);
+    TEST_ASSERT_EQUAL(GAMING_OK, event_loop_run(loop));
+}
+
+void test_event_loop_idle_uses_no_cpu(void) {
+    struct timespec cpu_start, cpu_end;
+    counter_t c = { 0 };
+
+    TEST_ASSERT_TRUE(event_loop_add_timer(loop, 100, 0, on_timer, &c) > 0);
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_start);
+    run_until(&c.calls, 1, 1000);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_end);
+
+    // 等待 100 ms 期間執行緒睡在 epoll_wait,CPU 時間應遠小於牆上時間
+    long long cpu_us = (cpu_end.tv_sec - cpu_start.tv_sec) * 1000000LL +
+                       (cpu_end.tv_nsec - cpu_start.tv_nsec) / 1000;
+    TEST_ASSERT_EQUAL(1, c.calls);
+    TEST_ASSERT_TRUE(cpu_us < 20000);
+}
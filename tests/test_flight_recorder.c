@@ -0,0 +1,380 @@
+/**
+ * @file test_flight_recorder.c
+ * @brief Flight Recorder 單元測試
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "unity.h"
+#include "flight_recorder.h"
+#include "logger.h"
+#include "logger_binary.h"
+#include <string.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// ========================================
+// 測試輔助
+// ========================================
+
+#define TEST_FLIGHT_PATH  "/tmp/test_flight_recorder.flight"
+#define TEST_DUMP_PATH    "/tmp/test_flight_recorder.txt"
+
+static char dumped[65536];
+static int saved_stderr = -1;
+
+static void silence_stderr(void) {
+    fflush(stderr);
+    saved_stderr = dup(STDERR_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd >= 0) {
+        dup2(null_fd, STDERR_FILENO);
+        close(null_fd);
+    }
+}
+
+static void restore_stderr(void) {
+    if (saved_stderr >= 0) {
+        fflush(stderr);
+        dup2(saved_stderr, STDERR_FILENO);
+        close(saved_stderr);
+        saved_stderr = -1;
+    }
+}
+
+static void read_dump(void) {
+    int fd = open(TEST_DUMP_PATH, O_RDONLY);
+    TEST_ASSERT_TRUE(fd >= 0);
+    ssize_t n = read(fd, dumped, sizeof(dumped) - 1);
+    close(fd);
+    dumped[n > 0 ? n : 0] = '\0';
+}
+
+/**
+ * @brief 以 dump_fd 輸出目前映射內容到 dumped,回傳筆數
+ */
+static int dump_open(void) {
+    int fd = open(TEST_DUMP_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    TEST_ASSERT_TRUE(fd >= 0);
+    int count = flight_recorder_dump_fd(fd, 0);
+    close(fd);
+    read_dump();
+    return count;
+}
+
+/**
+ * @brief 以 dump_file 讀取記錄檔到 dumped,回傳筆數
+ */
+static int dump_path(const char *path) {
+    int fd = open(TEST_DUMP_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    TEST_ASSERT_TRUE(fd >= 0);
+    int count = flight_recorder_dump_file(path, fd);
+    close(fd);
+    read_dump();
+    return count;
+}
+
+static int count_lines(const char *text) {
+    int lines = 0;
+    for (const char *p = text; *p; p++) {
+        if (*p == '\n') {
+            lines++;
+        }
+    }
+    return lines;
+}
+
+static void record(log_level_t level, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    flight_recorder_record(level, fmt, args);
+    va_end(args);
+}
+
+void setUp(void) {
+    unlink(TEST_FLIGHT_PATH);
+    logger_init("test-flight", LOG_LEVEL_INFO, LOG_TARGET_CONSOLE);
+}
+
+void tearDown(void) {
+    flight_recorder_close();
+    logger_cleanup();
+    restore_stderr();
+    unlink(TEST_FLIGHT_PATH);
+    unlink(TEST_DUMP_PATH);
+}
+
+// ========================================
+// 開啟/關閉測試
+// ========================================
+
+void test_flight_recorder_open_close(void) {
+    TEST_ASSERT_FALSE(flight_recorder_is_open());
+    TEST_ASSERT_EQUAL(GAMING_OK, flight_recorder_open(TEST_FLIGHT_PATH, 16));
+    TEST_ASSERT_TRUE(flight_recorder_is_open());
+
+    struct stat st;
+    TEST_ASSERT_EQUAL(0, stat(TEST_FLIGHT_PATH, &st));
+    TEST_ASSERT_TRUE(st.st_size > 0);
+
+    flight_recorder_close();
+    TEST_ASSERT_FALSE(flight_recorder_is_open());
+
+    // 檔案在關閉後保留
+    TEST_ASSERT_EQUAL(0, stat(TEST_FLIGHT_PATH, &st));
+}
+
+void test_flight_recorder_open_twice(void) {
+    TEST_ASSERT_EQUAL(GAMING_OK, flight_recorder_open(TEST_FLIGHT_PATH, 16));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_ALREADY_EXISTS, flight_recorder_open(TEST_FLIGHT_PATH, 16));
+}
+
+void test_flight_recorder_open_invalid(void) {
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM,
+                      flight_recorder_open(TEST_FLIGHT_PATH, FLIGHT_RECORDER_MAX_SLOTS + 1));
+
+    silence_stderr();
+    TEST_ASSERT_EQUAL(GAMING_ERROR_IO, flight_recorder_open("/nonexistent/dir/x.flight", 16));
+    restore_stderr();
+
+    TEST_ASSERT_FALSE(flight_recorder_is_open());
+}
+
+void test_flight_recorder_dump_not_open(void) {
+    TEST_ASSERT_EQUAL(GAMING_ERROR_NOT_INITIALIZED, flight_recorder_dump_fd(STDOUT_FILENO, 0));
+}
+
+// ========================================
+// 記錄測試
+// ========================================
+
+void test_flight_recorder_captures_debug_below_level(void) {
+    TEST_ASSERT_EQUAL(GAMING_OK, flight_recorder_open(TEST_FLIGHT_PATH, 16));
+
+    // 目前等級為 INFO,DEBUG 不會輸出到 console 但仍要進入 flight recorder
+    silence_stderr();
+    logger_debug("rssi=%d if=%s", -42, "wlan0");
+    logger_info("channel %u", 36u);
+    restore_stderr();
+
+    TEST_ASSERT_EQUAL(2, dump_open());
+    TEST_ASSERT_NOT_NULL(strstr(dumped, "[DEBUG] rssi=-42 if=wlan0\n"));
+    TEST_ASSERT_NOT_NULL(strstr(dumped, "[INFO] channel 36\n"));
+    TEST_ASSERT_NOT_NULL(strstr(dumped, "# flight recorder: pid "));
+}
+
+void test_flight_recorder_not_recording_after_close(void) {
+    TEST_ASSERT_EQUAL(GAMING_OK, flight_recorder_open(TEST_FLIGHT_PATH, 16));
+    silence_stderr();
+    logger_info("before close");
+    flight_recorder_close();
+    logger_info("after close");
+    restore_stderr();
+
+    TEST_ASSERT_EQUAL(1, dump_path(TEST_FLIGHT_PATH));
+    TEST_ASSERT_NOT_NULL(strstr(dumped, "before close"));
+    TEST_ASSERT_NULL(strstr(dumped, "after close"));
+}
+
+void test_flight_recorder_wraparound_keeps_newest(void) {
+    TEST_ASSERT_EQUAL(GAMING_OK, flight_recorder_open(TEST_FLIGHT_PATH, 8));
+
+    for (int i = 0; i < 20; i++) {
+        record(LOG_LEVEL_DEBUG, "event %d", i);
+    }
+
+    TEST_ASSERT_EQUAL(8, dump_open());
+    TEST_ASSERT_EQUAL(9, count_lines(dumped));
+    TEST_ASSERT_NULL(strstr(dumped, "event 11\n"));
+    TEST_ASSERT_NOT_NULL(strstr(dumped, "event 12\n"));
+    TEST_ASSERT_NOT_NULL(strstr(dumped, "event 19\n"));
+
+    // 舊 → 新
+    TEST_ASSERT_TRUE(strstr(dumped, "event 12\n") < strstr(dumped, "event 19\n"));
+}
+
+void test_flight_recorder_slots_round_up(void) {
+    TEST_ASSERT_EQUAL(GAMING_OK, flight_recorder_open(TEST_FLIGHT_PATH, 5));
+
+    for (int i = 0; i < 10; i++) {
+        record(LOG_LEVEL_INFO, "event %d", i);
+    }
+
+    TEST_ASSERT_EQUAL(8, dump_open());
+}
+
+void test_flight_recorder_long_string_truncated(void) {
+    char big[400];
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+
+    TEST_ASSERT_EQUAL(GAMING_OK, flight_recorder_open(TEST_FLIGHT_PATH, 8));
+    record(LOG_LEVEL_WARN, "name=%s end=%d", big, 7);
+
+    TEST_ASSERT_EQUAL(1, dump_open());
+    TEST_ASSERT_NOT_NULL(strstr(dumped, "[WARNING] name=xxx"));
+    TEST_ASSERT_NULL(strstr(dumped, big));
+    TEST_ASSERT_NOT_NULL(strstr(dumped, " end=7\n"));
+}
+
+// ========================================
+// 重新開啟測試
+// ========================================
+
+void test_flight_recorder_reopen_preserves_contents(void) {
+    TEST_ASSERT_EQUAL(GAMING_OK, flight_recorder_open(TEST_FLIGHT_PATH, 16));
+    record(LOG_LEVEL_DEBUG, "before restart %d", 1);
+    flight_recorder_close();
+
+    TEST_ASSERT_EQUAL(GAMING_OK, flight_recorder_open(TEST_FLIGHT_PATH, 16));
+    record(LOG_LEVEL_DEBUG, "after restart %d", 2);
+
+    TEST_ASSERT_EQUAL(3, dump_open());
+    const char *before = strstr(dumped, "before restart 1\n");
+    const char *marker = strstr(dumped, "flight recorder reopened (previous pid ");
+    const char *after = strstr(dumped, "after restart 2\n");
+    TEST_ASSERT_NOT_NULL(before);
+    TEST_ASSERT_NOT_NULL(marker);
+    TEST_ASSERT_NOT_NULL(after);
+    TEST_ASSERT_TRUE(before < marker && marker < after);
+}
+
+void test_flight_recorder_reopen_other_size_reinitializes(void) {
+    TEST_ASSERT_EQUAL(GAMING_OK, flight_recorder_open(TEST_FLIGHT_PATH, 16));
+    record(LOG_LEVEL_DEBUG, "old geometry");
+    flight_recorder_close();
+
+    TEST_ASSERT_EQUAL(GAMING_OK, flight_recorder_open(TEST_FLIGHT_PATH, 32));
+    TEST_ASSERT_EQUAL(0, dump_open());
+    TEST_ASSERT_NULL(strstr(dumped, "old geometry"));
+}
+
+void test_flight_recorder_dump_file_rejects_garbage(void) {
+    int fd = open(TEST_FLIGHT_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    TEST_ASSERT_TRUE(fd >= 0);
+    char junk[256];
+    memset(junk, 'j', sizeof(junk));
+    TEST_ASSERT_EQUAL((ssize_t)sizeof(junk), write(fd, junk, sizeof(junk)));
+    close(fd);
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_IO, dump_path(TEST_FLIGHT_PATH));
+
+    silence_stderr();
+    TEST_ASSERT_EQUAL(GAMING_ERROR_IO, dump_path("/tmp/test_flight_recorder.missing"));
+    restore_stderr();
+}
+
+// ========================================
+// 當機測試
+// ========================================
+
+void test_flight_recorder_crash_dumps_and_keeps_file(void) {
+    fflush(stdout);
+    fflush(stderr);
+
+    pid_t pid = fork();
+    TEST_ASSERT_TRUE(pid >= 0);
+
+    if (pid == 0) {
+        int fd = open(TEST_DUMP_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        dup2(fd, STDERR_FILENO);
+        close(fd);
+
+        if (flight_recorder_open(TEST_FLIGHT_PATH, 64) != GAMING_OK ||
+            flight_recorder_install_crash_handler() != GAMING_OK) {
+            _exit(1);
+        }
+        logger_debug("last words %d", 99);
+        abort();
+    }
+
+    int status = 0;
+    TEST_ASSERT_EQUAL(pid, waitpid(pid, &status, 0));
+    TEST_ASSERT_TRUE(WIFSIGNALED(status));
+    TEST_ASSERT_EQUAL(SIGABRT, WTERMSIG(status));
+
+    // 當機時印到 stderr
+    read_dump();
+    TEST_ASSERT_NOT_NULL(strstr(dumped, "*** fatal signal 6"));
+    TEST_ASSERT_NOT_NULL(strstr(dumped, "[DEBUG] last words 99\n"));
+
+    // 記錄檔保留內容與訊號編號
+    TEST_ASSERT_EQUAL(1, dump_path(TEST_FLIGHT_PATH));
+    TEST_ASSERT_NOT_NULL(strstr(dumped, "signal 6 "));
+    TEST_ASSERT_NOT_NULL(strstr(dumped, "[DEBUG] last words 99\n"));
+}
+
+// ========================================
+// 多執行緒測試
+// ========================================
+
+#define THREAD_COUNT      4
+#define RECORDS_PER_THREAD 1000
+
+static void* writer_thread(void *arg) {
+    int id = *(int *)arg;
+    for (int i = 0; i < RECORDS_PER_THREAD; i++) {
+        logger_debug("thread %d record %d", id, i);
+    }
+    return NULL;
+}
+
+void test_flight_recorder_concurrent_writers(void) {
+    pthread_t threads[THREAD_COUNT];
+    int ids[THREAD_COUNT];
+
+    TEST_ASSERT_EQUAL(GAMING_OK,
+                      flight_recorder_open(TEST_FLIGHT_PATH, THREAD_COUNT * RECORDS_PER_THREAD));
+
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        ids[i] = i;
+        TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, writer_thread, &ids[i]));
+    }
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    int fd = open(TEST_DUMP_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL(THREAD_COUNT * RECORDS_PER_THREAD, flight_recorder_dump_fd(fd, 0));
+    close(fd);
+}
+
+static volatile int stop_writers = 0;
+
+static void* busy_writer_thread(void *arg) {
+    int id = *(int *)arg;
+    for (int i = 0; !__atomic_load_n(&stop_writers, __ATOMIC_RELAXED); i++) {
+        record(LOG_LEVEL_INFO, "thread %d record %d %s", id, i, "payload");
+    }
+    return NULL;
+}
+
+void test_flight_recorder_close_while_writing(void) {
+    pthread_t threads[THREAD_COUNT];
+    int ids[THREAD_COUNT];
+
+    // 日誌執行緒仍在寫入時反覆開啟/關閉,不可寫入已解除的映射
+    stop_writers = 0;
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        ids[i] = i;
+        TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, busy_writer_thread, &ids[i]));
+    }
+    for (int round = 0; round < 200; round++) {
+        TEST_ASSERT_EQUAL(GAMING_OK, flight_recorder_open(TEST_FLIGHT_PATH, 64));
+        usleep(100);
+        flight_recorder_close();
+    }
+    __atomic_store_n(&stop_writers, 1, __ATOMIC_RELAXED);
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    TEST_ASSERT_FALSE(flight_recorder_is_open());
+}
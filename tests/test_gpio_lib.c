@@ -12,6 +12,8 @@
 #include "unity.h"
 #include "mock_hal_interface.h"
 #include "gpio_lib.h"
+#include "logger.h"
+#include "logger_fields.h"
 #include "gaming_common.h"
 
 // ========================================
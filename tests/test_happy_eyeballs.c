@@ -0,0 +1,340 @@
+/**
+ * @file test_happy_eyeballs.c
+ * @brief Happy Eyeballs 單元測試
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "unity.h"
+#include "happy_eyeballs.h"
+#include "socket_helper.h"
+#include "logger.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+// ========================================
+// 測試輔助
+// ========================================
+
+#define MAX_FILLERS 4
+
+static int fillers[MAX_FILLERS];
+static int nfillers = 0;
+
+static long long now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief 產生 loopback 位址 (port 0 表示由 kernel 指定)
+ */
+static happy_eyeballs_addr_t loopback(int family, int port) {
+    happy_eyeballs_addr_t a;
+    memset(&a, 0, sizeof(a));
+    if (family == AF_INET6) {
+        struct sockaddr_in6 *in6 = (struct sockaddr_in6 *)&a.addr;
+        in6->sin6_family = AF_INET6;
+        in6->sin6_addr = in6addr_loopback;
+        in6->sin6_port = htons(port);
+        a.len = sizeof(*in6);
+    } else {
+        struct sockaddr_in *in = (struct sockaddr_in *)&a.addr;
+        in->sin_family = AF_INET;
+        in->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        in->sin_port = htons(port);
+        a.len = sizeof(*in);
+    }
+    return a;
+}
+
+static int addr_port(const happy_eyeballs_addr_t *a) {
+    if (a->addr.ss_family == AF_INET6) {
+        return ntohs(((const struct sockaddr_in6 *)&a->addr)->sin6_port);
+    }
+    return ntohs(((const struct sockaddr_in *)&a->addr)->sin_port);
+}
+
+/**
+ * @brief 在 loopback 監聽,*target 為可連線的位址
+ */
+static int listen_on(int family, happy_eyeballs_addr_t *target) {
+    *target = loopback(family, 0);
+    int fd = socket(family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || bind(fd, (struct sockaddr *)&target->addr, target->len) < 0 ||
+        listen(fd, 8) < 0 || getsockname(fd, (struct sockaddr *)&target->addr, &target->len) < 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief 取得一個沒有監聽的埠號 (連線會被拒絕)
+ */
+static happy_eyeballs_addr_t refused(int family) {
+    happy_eyeballs_addr_t target;
+    int fd = listen_on(family, &target);
+    close(fd);
+    return target;
+}
+
+/**
+ * @brief 建立不回應的監聽端: 填滿 backlog 為 0 的佇列,之後的 SYN 會被丟棄
+ * @return 監聽 fd, -1 表示無法模擬 (呼叫端應略過測試)
+ */
+static int listen_unresponsive(happy_eyeballs_addr_t *target) {
+    int fd = listen_on(AF_INET, target);
+    if (fd < 0 || listen(fd, 0) < 0) {
+        return -1;
+    }
+
+    for (nfillers = 0; nfillers < MAX_FILLERS; nfillers++) {
+        int filler = socket_helper_connect_tcp_timeout("127.0.0.1", addr_port(target), 100);
+        if (filler < 0) {
+            return fd;
+        }
+        fillers[nfillers] = filler;
+    }
+    close(fd);
+    return -1;
+}
+
+static int peer_family(int fd, int *port) {
+    struct sockaddr_storage peer;
+    socklen_t len = sizeof(peer);
+    if (getpeername(fd, (struct sockaddr *)&peer, &len) < 0) {
+        return AF_UNSPEC;
+    }
+    happy_eyeballs_addr_t a = { .addr = peer, .len = len };
+    *port = addr_port(&a);
+    return peer.ss_family;
+}
+
+void setUp(void) {
+    happy_eyeballs_cache_clear();
+    nfillers = 0;
+}
+
+void tearDown(void) {
+    for (int i = 0; i < nfillers; i++) {
+        close(fillers[i]);
+    }
+    nfillers = 0;
+}
+
+// ========================================
+// 位址解析與排序
+// ========================================
+
+void test_happy_eyeballs_parse_mixed_list(void) {
+    happy_eyeballs_addr_t addrs[4];
+
+    int count = happy_eyeballs_parse("192.168.8.1, [fd00::1] ::1", 8080, addrs, 4);
+    TEST_ASSERT_EQUAL(3, count);
+    TEST_ASSERT_EQUAL(AF_INET, addrs[0].addr.ss_family);
+    TEST_ASSERT_EQUAL(AF_INET6, addrs[1].addr.ss_family);
+    TEST_ASSERT_EQUAL(AF_INET6, addrs[2].addr.ss_family);
+    TEST_ASSERT_EQUAL(sizeof(struct sockaddr_in), addrs[0].len);
+    TEST_ASSERT_EQUAL(8080, addr_port(&addrs[0]));
+    TEST_ASSERT_EQUAL(8080, addr_port(&addrs[1]));
+}
+
+void test_happy_eyeballs_parse_invalid(void) {
+    happy_eyeballs_addr_t addrs[2];
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, happy_eyeballs_parse(NULL, 80, addrs, 2));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, happy_eyeballs_parse("", 80, addrs, 2));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, happy_eyeballs_parse(" , ", 80, addrs, 2));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM,
+                      happy_eyeballs_parse("router.lan", 80, addrs, 2));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, happy_eyeballs_parse("::1", 0, addrs, 2));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM,
+                      happy_eyeballs_parse("10.0.0.1,10.0.0.2,10.0.0.3", 80, addrs, 2));
+}
+
+void test_happy_eyeballs_order_interleaves_ipv6_first(void) {
+    happy_eyeballs_addr_t addrs[4];
+    TEST_ASSERT_EQUAL(4, happy_eyeballs_parse("10.0.0.1 10.0.0.2 fd00::1 fd00::2", 80, addrs, 4));
+
+    happy_eyeballs_order(addrs, 4);
+
+    char text[INET6_ADDRSTRLEN];
+    TEST_ASSERT_EQUAL(AF_INET6, addrs[0].addr.ss_family);
+    inet_ntop(AF_INET6, &((struct sockaddr_in6 *)&addrs[0].addr)->sin6_addr, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("fd00::1", text);
+    TEST_ASSERT_EQUAL(AF_INET, addrs[1].addr.ss_family);
+    inet_ntop(AF_INET, &((struct sockaddr_in *)&addrs[1].addr)->sin_addr, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("10.0.0.1", text);
+    TEST_ASSERT_EQUAL(AF_INET6, addrs[2].addr.ss_family);
+    TEST_ASSERT_EQUAL(AF_INET, addrs[3].addr.ss_family);
+}
+
+// ========================================
+// 連線測試
+// ========================================
+
+void test_happy_eyeballs_connect_invalid_params(void) {
+    happy_eyeballs_addr_t addrs[1];
+
+    TEST_ASSERT_LESS_THAN(0, happy_eyeballs_connect(NULL, 80, NULL));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    TEST_ASSERT_LESS_THAN(0, happy_eyeballs_connect("not-an-ip", 80, NULL));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    TEST_ASSERT_LESS_THAN(0, happy_eyeballs_connect_addrs(addrs, 0, NULL));
+    TEST_ASSERT_LESS_THAN(0, happy_eyeballs_connect_addrs(NULL, 1, NULL));
+}
+
+void test_happy_eyeballs_connect_literal(void) {
+    happy_eyeballs_addr_t target;
+    int listen_fd = listen_on(AF_INET, &target);
+    TEST_ASSERT_TRUE(listen_fd >= 0);
+
+    int fd = happy_eyeballs_connect("127.0.0.1", addr_port(&target), NULL);
+    TEST_ASSERT_TRUE(fd >= 0);
+
+    // 回傳的 socket 為阻塞模式,勝出的協定被記住
+    TEST_ASSERT_EQUAL(0, fcntl(fd, F_GETFL, 0) & O_NONBLOCK);
+    TEST_ASSERT_EQUAL(AF_INET, happy_eyeballs_cache_lookup(&target, 1));
+
+    close(fd);
+    close(listen_fd);
+}
+
+void test_happy_eyeballs_prefers_ipv6_when_both_work(void) {
+    happy_eyeballs_addr_t addrs[2];
+    int fd4 = listen_on(AF_INET, &addrs[0]);
+    int fd6 = listen_on(AF_INET6, &addrs[1]);
+    if (fd6 < 0) {
+        close(fd4);
+        TEST_IGNORE_MESSAGE("IPv6 loopback not available");
+    }
+
+    int fd = happy_eyeballs_connect_addrs(addrs, 2, NULL);
+    TEST_ASSERT_TRUE(fd >= 0);
+    int port;
+    TEST_ASSERT_EQUAL(AF_INET6, peer_family(fd, &port));
+    TEST_ASSERT_EQUAL(AF_INET6, happy_eyeballs_cache_lookup(addrs, 2));
+
+    close(fd);
+    close(fd4);
+    close(fd6);
+}
+
+void test_happy_eyeballs_falls_back_and_caches_family(void) {
+    happy_eyeballs_addr_t addrs[2];
+    int fd4 = listen_on(AF_INET, &addrs[0]);
+    TEST_ASSERT_TRUE(fd4 >= 0);
+    addrs[1] = refused(AF_INET6);
+
+    // IPv6 被拒絕 (或沒有 IPv6) 後立即改用 IPv4,不等待間隔
+    happy_eyeballs_config_t config = HAPPY_EYEBALLS_CONFIG_INIT;
+    config.attempt_delay_ms = 1000;
+    long long start = now_ms();
+    int fd = happy_eyeballs_connect_addrs(addrs, 2, &config);
+    long long elapsed = now_ms() - start;
+
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_TRUE(elapsed < 500);
+    int port;
+    TEST_ASSERT_EQUAL(AF_INET, peer_family(fd, &port));
+    TEST_ASSERT_EQUAL(AF_INET, happy_eyeballs_cache_lookup(addrs, 2));
+
+    // 之後以 IPv4 優先排列
+    happy_eyeballs_addr_t ordered[2] = { addrs[0], addrs[1] };
+    happy_eyeballs_order(ordered, 2);
+    TEST_ASSERT_EQUAL(AF_INET, ordered[0].addr.ss_family);
+
+    happy_eyeballs_cache_clear();
+    TEST_ASSERT_EQUAL(AF_UNSPEC, happy_eyeballs_cache_lookup(addrs, 2));
+
+    close(fd);
+    close(fd4);
+}
+
+void test_happy_eyeballs_all_refused(void) {
+    happy_eyeballs_addr_t addrs[2] = { refused(AF_INET), refused(AF_INET) };
+
+    int fd = happy_eyeballs_connect_addrs(addrs, 2, NULL);
+    TEST_ASSERT_LESS_THAN(0, fd);
+    TEST_ASSERT_EQUAL(ECONNREFUSED, errno);
+    TEST_ASSERT_EQUAL(AF_UNSPEC, happy_eyeballs_cache_lookup(addrs, 2));
+}
+
+void test_happy_eyeballs_timeout(void) {
+    happy_eyeballs_addr_t target;
+    int listen_fd = listen_unresponsive(&target);
+    if (listen_fd < 0) {
+        TEST_IGNORE_MESSAGE("kernel accepted all connections, cannot provoke SYN drop");
+    }
+
+    happy_eyeballs_config_t config = HAPPY_EYEBALLS_CONFIG_INIT;
+    config.timeout_ms = 200;
+    long long start = now_ms();
+    int fd = happy_eyeballs_connect_addrs(&target, 1, &config);
+    long long elapsed = now_ms() - start;
+
+    TEST_ASSERT_LESS_THAN(0, fd);
+    TEST_ASSERT_EQUAL(ETIMEDOUT, errno);
+    TEST_ASSERT_INT_WITHIN(150, 250, elapsed);
+
+    close(listen_fd);
+}
+
+// ========================================
+// 效能測試
+// ========================================
+
+void test_happy_eyeballs_benchmark_unresponsive_first_path(void) {
+    happy_eyeballs_addr_t addrs[2];
+    int hang_fd = listen_unresponsive(&addrs[0]);
+    if (hang_fd < 0) {
+        TEST_IGNORE_MESSAGE("kernel accepted all connections, cannot provoke SYN drop");
+    }
+    int good_fd = listen_on(AF_INET, &addrs[1]);
+    TEST_ASSERT_TRUE(good_fd >= 0);
+
+    // 依序連線: 必須等第一個位址逾時
+    char msg[160];
+    long long start = now_ms();
+    int fd = socket_helper_connect_tcp_timeout("127.0.0.1", addr_port(&addrs[0]), 1000);
+    if (fd < 0) {
+        fd = socket_helper_connect_tcp_timeout("127.0.0.1", addr_port(&addrs[1]), 1000);
+    }
+    long long sequential = now_ms() - start;
+    TEST_ASSERT_TRUE(fd >= 0);
+    close(fd);
+
+    // 並行: 間隔後發起第二個嘗試,由可用的路徑勝出
+    happy_eyeballs_config_t config = HAPPY_EYEBALLS_CONFIG_INIT;
+    config.timeout_ms = 1000;
+    config.attempt_delay_ms = 100;
+    start = now_ms();
+    fd = happy_eyeballs_connect_addrs(addrs, 2, &config);
+    long long raced = now_ms() - start;
+
+    TEST_ASSERT_TRUE(fd >= 0);
+    int port;
+    TEST_ASSERT_EQUAL(AF_INET, peer_family(fd, &port));
+    TEST_ASSERT_EQUAL(addr_port(&addrs[1]), port);
+    TEST_ASSERT_INT_WITHIN(80, 120, raced);
+
+    snprintf(msg, sizeof(msg),
+             "first address unresponsive: sequential %lld ms, happy eyeballs %lld ms "
+             "(attempt delay 100 ms)", sequential, raced);
+    TEST_MESSAGE(msg);
+
+    close(fd);
+    close(good_fd);
+    close(hang_fd);
+}
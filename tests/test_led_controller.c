@@ -14,7 +14,10 @@
 #include "unity.h"
 #include "mock_hal_interface.h"
 #include "led_controller.h"
+#include "config_parser.h"
+#include "logger.h"
 #include "gaming_common.h"
+#include <pthread.h>
 
 // ========================================
 // 測試設置
@@ -341,3 +344,143 @@ void test_led_controller_deinit_should_cleanup_all_pins(void)
     
     TEST_ASSERT_EQUAL_INT(GAMING_OK, result);
 }
+
+// ========================================
+// LED 顏色表測試
+// ========================================
+
+void test_led_parse_color_should_parse_rgb_string(void)
+{
+    led_color_t color;
+    
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, led_parse_color("255,165,0", &color));
+    TEST_ASSERT_EQUAL_UINT8(255, color.r);
+    TEST_ASSERT_EQUAL_UINT8(165, color.g);
+    TEST_ASSERT_EQUAL_UINT8(0, color.b);
+    
+    // 允許逗號前後空白
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, led_parse_color(" 1, 2 ,3", &color));
+    TEST_ASSERT_EQUAL_UINT8(1, color.r);
+    TEST_ASSERT_EQUAL_UINT8(2, color.g);
+    TEST_ASSERT_EQUAL_UINT8(3, color.b);
+}
+
+void test_led_parse_color_should_reject_invalid_strings(void)
+{
+    led_color_t color = {9, 9, 9};
+    
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM, led_parse_color("256,0,0", &color));
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM, led_parse_color("0,0", &color));
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM, led_parse_color("0,0,0,0", &color));
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM, led_parse_color("-1,0,0", &color));
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM, led_parse_color("red", &color));
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM, led_parse_color(NULL, &color));
+    
+    // 失敗時不修改輸出
+    TEST_ASSERT_EQUAL_UINT8(9, color.r);
+}
+
+void test_led_get_status_color_defaults_match_legacy_colors(void)
+{
+    // 測試環境沒有 UCI，應使用預設顏色
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, led_color_table_reload());
+    
+    led_color_t c = led_get_status_color(DEVICE_TYPE_CLIENT, PS5_STATE_STANDBY, VPN_STATE_UNKNOWN);
+    TEST_ASSERT_EQUAL_UINT8(255, c.r);
+    TEST_ASSERT_EQUAL_UINT8(165, c.g);
+    TEST_ASSERT_EQUAL_UINT8(0, c.b);
+    
+    c = led_get_status_color(DEVICE_TYPE_SERVER, PS5_STATE_ON, VPN_STATE_UNKNOWN);
+    TEST_ASSERT_EQUAL_UINT8(0, c.r);
+    TEST_ASSERT_EQUAL_UINT8(255, c.g);
+    TEST_ASSERT_EQUAL_UINT8(0, c.b);
+    
+    c = led_get_status_color(DEVICE_TYPE_UNKNOWN, PS5_STATE_ON, VPN_STATE_UNKNOWN);
+    TEST_ASSERT_EQUAL_UINT8(255, c.r);
+    TEST_ASSERT_EQUAL_UINT8(0, c.g);
+    TEST_ASSERT_EQUAL_UINT8(0, c.b);
+}
+
+void test_led_get_status_color_client_vpn_states(void)
+{
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, led_color_table_reload());
+    
+    // VPN 連線中優先於 PS5 狀態
+    led_color_t c = led_get_status_color(DEVICE_TYPE_CLIENT, PS5_STATE_ON, VPN_STATE_CONNECTING);
+    TEST_ASSERT_EQUAL_UINT8(0, c.r);
+    TEST_ASSERT_EQUAL_UINT8(0, c.g);
+    TEST_ASSERT_EQUAL_UINT8(255, c.b);
+    
+    // PS5 關機 + VPN 已連線 = 綠色
+    c = led_get_status_color(DEVICE_TYPE_CLIENT, PS5_STATE_OFF, VPN_STATE_CONNECTED);
+    TEST_ASSERT_EQUAL_UINT8(0, c.r);
+    TEST_ASSERT_EQUAL_UINT8(255, c.g);
+    TEST_ASSERT_EQUAL_UINT8(0, c.b);
+    
+    // 超出範圍的狀態視為未知
+    c = led_get_status_color((device_type_t)42, PS5_STATE_ON, VPN_STATE_UNKNOWN);
+    TEST_ASSERT_EQUAL_UINT8(255, c.r);
+    TEST_ASSERT_EQUAL_UINT8(0, c.g);
+}
+
+void test_led_set_status_ex_client_vpn_error_should_show_red(void)
+{
+    // 先初始化
+    hal_gpio_init_ExpectAndReturn(17, HAL_GPIO_DIR_OUTPUT, 0);
+    hal_gpio_init_ExpectAndReturn(18, HAL_GPIO_DIR_OUTPUT, 0);
+    hal_gpio_init_ExpectAndReturn(19, HAL_GPIO_DIR_OUTPUT, 0);
+    hal_gpio_write_ExpectAndReturn(17, HAL_GPIO_LOW, 0);
+    hal_gpio_write_ExpectAndReturn(18, HAL_GPIO_LOW, 0);
+    hal_gpio_write_ExpectAndReturn(19, HAL_GPIO_LOW, 0);
+    led_controller_init(&test_led_config);
+    
+    // Client + VPN 錯誤 = 紅色
+    hal_gpio_write_ExpectAndReturn(17, HAL_GPIO_HIGH, 0);
+    hal_gpio_write_ExpectAndReturn(18, HAL_GPIO_LOW, 0);
+    hal_gpio_write_ExpectAndReturn(19, HAL_GPIO_LOW, 0);
+    
+    int result = led_set_status_ex(DEVICE_TYPE_CLIENT, PS5_STATE_ON, VPN_STATE_ERROR);
+    
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, result);
+}
+
+// ========================================
+// 顏色表重新載入測試
+// ========================================
+
+static volatile int reload_readers_stop;
+static volatile int reload_readers_bad;
+
+static void *status_color_reader(void *arg)
+{
+    (void)arg;
+    while (!__atomic_load_n(&reload_readers_stop, __ATOMIC_RELAXED)) {
+        led_color_t c = led_get_status_color(DEVICE_TYPE_SERVER, PS5_STATE_ON, VPN_STATE_UNKNOWN);
+        if (c.r != 0 || c.g != 255 || c.b != 0) {
+            __atomic_store_n(&reload_readers_bad, 1, __ATOMIC_RELAXED);
+        }
+    }
+    return NULL;
+}
+
+void test_led_color_table_reload_while_reading(void)
+{
+    pthread_t readers[2];
+    
+    reload_readers_stop = 0;
+    reload_readers_bad = 0;
+    for (int i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&readers[i], NULL, status_color_reader, NULL));
+    }
+    
+    // 連續 reload 會輪流覆寫兩份表，必須等仍在查表的讀者離開
+    for (int i = 0; i < 200; i++) {
+        TEST_ASSERT_EQUAL_INT(GAMING_OK, led_color_table_reload());
+    }
+    
+    __atomic_store_n(&reload_readers_stop, 1, __ATOMIC_RELAXED);
+    for (int i = 0; i < 2; i++) {
+        pthread_join(readers[i], NULL);
+    }
+    TEST_ASSERT_EQUAL_INT(0, reload_readers_bad);
+}
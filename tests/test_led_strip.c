@@ -0,0 +1,245 @@
+/**
+ * @file test_led_strip.c
+ * @brief LED Strip 單元測試
+ *
+ * 以暫存檔取代 /dev/spidevX.Y,驗證寫出的 SPI 波形
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "unity.h"
+#include "led_strip.h"
+#include "gaming_common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/stat.h>
+
+// ========================================
+// 測試設置
+// ========================================
+
+#define TEST_SPIDEV_PATH "/tmp/test_led_strip_spidev"
+#define TEST_NUM_LEDS    8
+
+// 0x00 與 0xFF 展開後的 SPI 位元組
+static const uint8_t ENCODED_00[3] = { 0x92, 0x49, 0x24 };
+static const uint8_t ENCODED_FF[3] = { 0xDB, 0x6D, 0xB6 };
+
+static led_strip_t *strip;
+
+static led_strip_t* open_test_strip(int num_leds) {
+    led_strip_config_t config = {
+        .spi_device = TEST_SPIDEV_PATH,
+        .num_leds = num_leds,
+        .speed_hz = 0,
+    };
+    return led_strip_open(&config);
+}
+
+static long file_size(const char *path) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        return -1;
+    }
+    return (long)st.st_size;
+}
+
+static size_t read_file(const char *path, uint8_t *buffer, size_t size) {
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) {
+        return 0;
+    }
+    size_t n = fread(buffer, 1, size, fp);
+    fclose(fp);
+    return n;
+}
+
+void setUp(void) {
+    // 建立空的替身檔案
+    FILE *fp = fopen(TEST_SPIDEV_PATH, "wb");
+    if (fp) {
+        fclose(fp);
+    }
+    strip = NULL;
+}
+
+void tearDown(void) {
+    led_strip_close(strip);
+    remove(TEST_SPIDEV_PATH);
+}
+
+// ========================================
+// 開啟測試
+// ========================================
+
+void test_led_strip_open_success(void) {
+    strip = open_test_strip(TEST_NUM_LEDS);
+
+    TEST_ASSERT_NOT_NULL(strip);
+    TEST_ASSERT_EQUAL_INT(TEST_NUM_LEDS, led_strip_get_count(strip));
+}
+
+void test_led_strip_open_invalid_config(void) {
+    TEST_ASSERT_NULL(led_strip_open(NULL));
+    TEST_ASSERT_NULL(open_test_strip(0));
+    TEST_ASSERT_NULL(open_test_strip(LED_STRIP_MAX_LEDS + 1));
+}
+
+void test_led_strip_open_missing_device(void) {
+    led_strip_config_t config = {
+        .spi_device = "/tmp/nonexistent_dir/spidev9.9",
+        .num_leds = 1,
+    };
+
+    TEST_ASSERT_NULL(led_strip_open(&config));
+}
+
+// ========================================
+// 編碼測試
+// ========================================
+
+void test_led_strip_encode_grb_order(void) {
+    led_color_t pixel = { .r = 0xFF, .g = 0x00, .b = 0xFF };
+    uint8_t out[LED_STRIP_BYTES_PER_LED];
+
+    led_strip_encode(&pixel, 1, out);
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(ENCODED_00, out, 3);      // G
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(ENCODED_FF, out + 3, 3);  // R
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(ENCODED_FF, out + 6, 3);  // B
+}
+
+void test_led_strip_encode_bit_pattern(void) {
+    // 0xA5 = 1010 0101 → 110 100 110 100 100 110 100 110
+    led_color_t pixel = { .r = 0, .g = 0xA5, .b = 0 };
+    uint8_t out[LED_STRIP_BYTES_PER_LED];
+    const uint8_t expected[3] = { 0xD3, 0x49, 0xA6 };
+
+    led_strip_encode(&pixel, 1, out);
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, out, 3);
+}
+
+void test_led_strip_frame_size(void) {
+    TEST_ASSERT_EQUAL_size_t(0, led_strip_frame_size(0));
+    TEST_ASSERT_EQUAL_size_t(10 * LED_STRIP_BYTES_PER_LED + LED_STRIP_RESET_BYTES,
+                             led_strip_frame_size(10));
+}
+
+// ========================================
+// 幀緩衝與送出測試
+// ========================================
+
+void test_led_strip_show_writes_one_frame(void) {
+    strip = open_test_strip(TEST_NUM_LEDS);
+    TEST_ASSERT_NOT_NULL(strip);
+
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, led_strip_set_pixel(strip, 0, LED_COLOR_WHITE));
+    TEST_ASSERT_EQUAL_INT(1, led_strip_show(strip));
+
+    size_t frame = led_strip_frame_size(TEST_NUM_LEDS);
+    TEST_ASSERT_EQUAL_INT((long)frame, file_size(TEST_SPIDEV_PATH));
+
+    uint8_t buffer[512];
+    TEST_ASSERT_EQUAL_size_t(frame, read_file(TEST_SPIDEV_PATH, buffer, sizeof(buffer)));
+
+    // 第一顆為白色,第二顆為黑色,幀尾為 reset (全 0)
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(ENCODED_FF, buffer, 3);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(ENCODED_00, buffer + LED_STRIP_BYTES_PER_LED, 3);
+    for (size_t i = frame - LED_STRIP_RESET_BYTES; i < frame; i++) {
+        TEST_ASSERT_EQUAL_UINT8(0, buffer[i]);
+    }
+}
+
+void test_led_strip_show_skips_clean_frame(void) {
+    strip = open_test_strip(TEST_NUM_LEDS);
+    TEST_ASSERT_NOT_NULL(strip);
+
+    TEST_ASSERT_EQUAL_INT(1, led_strip_show(strip));
+    TEST_ASSERT_EQUAL_INT(0, led_strip_show(strip));
+
+    // 設定相同顏色不會讓幀變髒
+    led_strip_set_pixel(strip, 3, LED_COLOR_BLACK);
+    TEST_ASSERT_EQUAL_INT(0, led_strip_show(strip));
+
+    TEST_ASSERT_EQUAL_INT((long)led_strip_frame_size(TEST_NUM_LEDS),
+                          file_size(TEST_SPIDEV_PATH));
+
+    led_strip_set_pixel(strip, 3, LED_COLOR_RED);
+    TEST_ASSERT_EQUAL_INT(1, led_strip_show(strip));
+    TEST_ASSERT_EQUAL_INT((long)led_strip_frame_size(TEST_NUM_LEDS) * 2,
+                          file_size(TEST_SPIDEV_PATH));
+}
+
+void test_led_strip_set_pixel_out_of_range(void) {
+    strip = open_test_strip(TEST_NUM_LEDS);
+    TEST_ASSERT_NOT_NULL(strip);
+
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM, led_strip_set_pixel(strip, -1, LED_COLOR_RED));
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM,
+                          led_strip_set_pixel(strip, TEST_NUM_LEDS, LED_COLOR_RED));
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM, led_strip_set_pixel(NULL, 0, LED_COLOR_RED));
+}
+
+void test_led_strip_fill_and_get_pixel(void) {
+    led_color_t color;
+
+    strip = open_test_strip(TEST_NUM_LEDS);
+    TEST_ASSERT_NOT_NULL(strip);
+
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, led_strip_fill(strip, LED_COLOR_ORANGE));
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, led_strip_get_pixel(strip, TEST_NUM_LEDS - 1, &color));
+
+    TEST_ASSERT_EQUAL_UINT8(255, color.r);
+    TEST_ASSERT_EQUAL_UINT8(165, color.g);
+    TEST_ASSERT_EQUAL_UINT8(0, color.b);
+}
+
+void test_led_strip_set_pixels_too_many(void) {
+    led_color_t pixels[TEST_NUM_LEDS + 1] = {{0, 0, 0}};
+
+    strip = open_test_strip(TEST_NUM_LEDS);
+    TEST_ASSERT_NOT_NULL(strip);
+
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM,
+                          led_strip_set_pixels(strip, pixels, TEST_NUM_LEDS + 1));
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, led_strip_set_pixels(strip, pixels, TEST_NUM_LEDS));
+}
+
+// ========================================
+// 效能
+// ========================================
+
+void test_led_strip_throughput_benchmark(void) {
+    const int num_leds = 60;
+    const int frames = 2000;
+    led_color_t pixels[60];
+    struct timespec start, end;
+
+    led_strip_config_t config = {
+        .spi_device = "/dev/null",
+        .num_leds = num_leds,
+    };
+    strip = led_strip_open(&config);
+    TEST_ASSERT_NOT_NULL(strip);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int f = 0; f < frames; f++) {
+        for (int i = 0; i < num_leds; i++) {
+            pixels[i].r = (uint8_t)(f + i);
+            pixels[i].g = (uint8_t)(f * 3);
+            pixels[i].b = (uint8_t)(i * 7);
+        }
+        led_strip_set_pixels(strip, pixels, num_leds);
+        TEST_ASSERT_EQUAL_INT(1, led_strip_show(strip));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double sec = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    char msg[128];
+    snprintf(msg, sizeof(msg), "LED strip: %d LEDs, %.0f frames/s (encode + write)",
+             num_leds, frames / sec);
+    TEST_MESSAGE(msg);
+}
@@ -0,0 +1,271 @@
+/**
+ * @file test_led_worker.c
+ * @brief LED Worker 單元測試
+ *
+ * 使用計數型的假 HAL (不用 CMock,避免與工作執行緒的呼叫順序耦合)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "unity.h"
+#include "led_worker.h"
+#include "led_controller.h"
+#include "config_parser.h"
+#include "logger.h"
+#include "gaming_common.h"
+#include <pthread.h>
+#include <time.h>
+
+// ========================================
+// 測試用的 HAL
+// ========================================
+
+hal_ops_t *hal_ops = NULL;
+
+static hal_ops_t fake_hal_ops;
+static volatile int fake_gpio_values[64];
+static volatile int fake_write_delay_us;
+
+static int fake_gpio_init(int pin, hal_gpio_dir_t direction) {
+    return 0;
+}
+
+static int fake_gpio_deinit(int pin) {
+    return 0;
+}
+
+static int fake_gpio_write(int pin, hal_gpio_value_t value) {
+    if (fake_write_delay_us > 0) {
+        struct timespec ts = { 0, fake_write_delay_us * 1000L };
+        nanosleep(&ts, NULL);
+    }
+    fake_gpio_values[pin] = value;
+    return 0;
+}
+
+static const led_config_t test_led_config = {
+    .pin_r = 17,
+    .pin_g = 18,
+    .pin_b = 19
+};
+
+// 等待工作執行緒處理完佇列
+static void wait_until_idle(void) {
+    led_worker_stats_t stats;
+    for (int i = 0; i < 200; i++) {
+        led_worker_get_stats(&stats);
+        if (stats.depth == 0 &&
+            stats.applied + stats.coalesced == stats.submitted) {
+            return;
+        }
+        struct timespec ts = { 0, 1000000L };
+        nanosleep(&ts, NULL);
+    }
+}
+
+static void sleep_ms(int ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+void setUp(void)
+{
+    fake_hal_ops.gpio_init = fake_gpio_init;
+    fake_hal_ops.gpio_deinit = fake_gpio_deinit;
+    fake_hal_ops.gpio_write = fake_gpio_write;
+    hal_ops = &fake_hal_ops;
+    fake_write_delay_us = 0;
+
+    led_controller_init(&test_led_config);
+}
+
+void tearDown(void)
+{
+    led_worker_stop();
+    led_controller_deinit();
+}
+
+// ========================================
+// 啟動與停止
+// ========================================
+
+void test_led_worker_start_and_stop(void)
+{
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, led_worker_start(0));
+    TEST_ASSERT_TRUE(led_worker_is_running());
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_ALREADY_EXISTS, led_worker_start(0));
+
+    led_worker_stop();
+    TEST_ASSERT_FALSE(led_worker_is_running());
+}
+
+void test_led_worker_rounds_depth_to_power_of_two(void)
+{
+    led_worker_stats_t stats;
+
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, led_worker_start(5));
+    led_worker_get_stats(&stats);
+
+    TEST_ASSERT_EQUAL_UINT32(8, stats.capacity);
+}
+
+void test_led_worker_rejects_excessive_depth(void)
+{
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM,
+                          led_worker_start(LED_WORKER_MAX_DEPTH + 1));
+}
+
+void test_led_worker_submit_without_start_fails(void)
+{
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_NOT_INITIALIZED, led_worker_set_color(255, 0, 0));
+}
+
+// ========================================
+// 命令處理
+// ========================================
+
+void test_led_worker_applies_color(void)
+{
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, led_worker_start(0));
+
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, led_worker_set_color(255, 0, 255));
+    wait_until_idle();
+
+    TEST_ASSERT_EQUAL_INT(HAL_GPIO_HIGH, fake_gpio_values[17]);
+    TEST_ASSERT_EQUAL_INT(HAL_GPIO_LOW, fake_gpio_values[18]);
+    TEST_ASSERT_EQUAL_INT(HAL_GPIO_HIGH, fake_gpio_values[19]);
+}
+
+void test_led_worker_applies_status_lookup(void)
+{
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, led_worker_start(0));
+
+    // Server + PS5 ON = 綠色
+    led_worker_set_status(DEVICE_TYPE_SERVER, PS5_STATE_ON, VPN_STATE_UNKNOWN);
+    wait_until_idle();
+
+    TEST_ASSERT_EQUAL_INT(HAL_GPIO_LOW, fake_gpio_values[17]);
+    TEST_ASSERT_EQUAL_INT(HAL_GPIO_HIGH, fake_gpio_values[18]);
+    TEST_ASSERT_EQUAL_INT(HAL_GPIO_LOW, fake_gpio_values[19]);
+}
+
+void test_led_worker_coalesces_to_latest_command(void)
+{
+    led_worker_stats_t stats;
+
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, led_worker_start(64));
+
+    // 讓每次寫入變慢,確保命令在佇列中堆積
+    fake_write_delay_us = 2000;
+    for (int i = 0; i < 32; i++) {
+        led_worker_set_color((i & 1) ? 255 : 0, 0, 0);
+    }
+    led_worker_set_color(0, 0, 255);
+    wait_until_idle();
+    led_worker_get_stats(&stats);
+
+    TEST_ASSERT_EQUAL_UINT32(33, stats.submitted);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.dropped);
+    TEST_ASSERT_GREATER_THAN(0, stats.coalesced);
+    TEST_ASSERT_EQUAL_UINT32(stats.submitted, stats.applied + stats.coalesced);
+
+    // 最後套用的是最新的顏色
+    TEST_ASSERT_EQUAL_INT(HAL_GPIO_LOW, fake_gpio_values[17]);
+    TEST_ASSERT_EQUAL_INT(HAL_GPIO_HIGH, fake_gpio_values[19]);
+}
+
+void test_led_worker_counts_dropped_when_full(void)
+{
+    led_worker_stats_t stats;
+    int rejected = 0;
+
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, led_worker_start(2));
+
+    fake_write_delay_us = 5000;
+    for (int i = 0; i < 16; i++) {
+        if (led_worker_set_color(255, 255, 255) == GAMING_ERROR_NO_MEMORY) {
+            rejected++;
+        }
+    }
+    led_worker_get_stats(&stats);
+
+    TEST_ASSERT_GREATER_THAN(0, rejected);
+    TEST_ASSERT_EQUAL_UINT32(rejected, stats.dropped);
+    TEST_ASSERT_EQUAL_UINT32(16, stats.submitted + stats.dropped);
+}
+
+void test_led_worker_blink_restores_steady_color(void)
+{
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, led_worker_start(0));
+
+    led_worker_set_color(0, 255, 0);
+    wait_until_idle();
+
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, led_worker_blink(LED_COLOR_RED, 2, 5));
+    sleep_ms(100);
+
+    // 閃爍結束後回到綠色
+    TEST_ASSERT_EQUAL_INT(HAL_GPIO_LOW, fake_gpio_values[17]);
+    TEST_ASSERT_EQUAL_INT(HAL_GPIO_HIGH, fake_gpio_values[18]);
+}
+
+void test_led_worker_blink_invalid_interval(void)
+{
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, led_worker_start(0));
+
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_INVALID_PARAM, led_worker_blink(LED_COLOR_RED, 3, 0));
+}
+
+static volatile int producer_stop;
+
+static void *racing_producer(void *arg)
+{
+    (void)arg;
+    while (!producer_stop) {
+        led_worker_set_color(255, 0, 0);
+    }
+    return NULL;
+}
+
+void test_led_worker_stop_while_producer_pushes(void)
+{
+    pthread_t producer;
+
+    producer_stop = 0;
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&producer, NULL, racing_producer, NULL));
+
+    // 生產者持續送命令時反覆啟動與停止,佇列釋放後不可再被寫入
+    for (int i = 0; i < 200; i++) {
+        TEST_ASSERT_EQUAL_INT(GAMING_OK, led_worker_start(0));
+        led_worker_stop();
+    }
+
+    producer_stop = 1;
+    pthread_join(producer, NULL);
+    TEST_ASSERT_EQUAL_INT(GAMING_ERROR_NOT_INITIALIZED, led_worker_set_color(0, 0, 0));
+}
+
+// ========================================
+// 效能
+// ========================================
+
+void test_led_worker_submit_cost(void)
+{
+    struct timespec start, end;
+    const int iterations = 100000;
+
+    TEST_ASSERT_EQUAL_INT(GAMING_OK, led_worker_start(LED_WORKER_MAX_DEPTH));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < iterations; i++) {
+        led_worker_set_color((uint8_t)i, 0, 0);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+    char msg[96];
+    snprintf(msg, sizeof(msg), "led_worker_set_color: %.1f ns/call", ns / iterations);
+    TEST_MESSAGE(msg);
+
+    wait_until_idle();
+}
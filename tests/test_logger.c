@@ -4,9 +4,53 @@
  * @version 1.0.0
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "unity.h"
 #include "logger.h"
 #include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+// 大量輸出時將 stderr 導向 /dev/null,避免淹沒測試報告
+static int saved_stderr = -1;
+
+static void silence_stderr(void) {
+    fflush(stderr);
+    saved_stderr = dup(STDERR_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd >= 0) {
+        dup2(null_fd, STDERR_FILENO);
+        close(null_fd);
+    }
+}
+
+// 將 stderr 導向暫存檔,之後可讀回輸出內容
+static void capture_stderr(const char *path) {
+    fflush(stderr);
+    saved_stderr = dup(STDERR_FILENO);
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+        dup2(fd, STDERR_FILENO);
+        close(fd);
+    }
+}
+
+static void restore_stderr(void) {
+    if (saved_stderr >= 0) {
+        fflush(stderr);
+        dup2(saved_stderr, STDERR_FILENO);
+        close(saved_stderr);
+        saved_stderr = -1;
+    }
+}
 
 // ========================================
 // 測試前置/後置處理
@@ -20,6 +64,10 @@ void setUp(void) {
 void tearDown(void) {
     // 每個測試後清理 Logger
     logger_cleanup();
+    restore_stderr();
+    logger_set_syslog_path(LOGGER_SYSLOG_PATH);
+    logger_apply_module_levels(NULL);
+    logger_set_file(NULL);
 }
 
 // ========================================
@@ -148,6 +196,13 @@ void test_logger_set_all_targets(void) {
     
     TEST_ASSERT_EQUAL(GAMING_OK, logger_set_target(LOG_TARGET_BOTH));
     TEST_ASSERT_EQUAL(LOG_TARGET_BOTH, logger_get_target());
+
+    logger_file_config_t file = { .path = "/tmp/test_logger_targets.log" };
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_set_file(&file));
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_set_target(LOG_TARGET_FILE));
+    TEST_ASSERT_EQUAL(LOG_TARGET_FILE, logger_get_target());
+    logger_cleanup();
+    unlink("/tmp/test_logger_targets.log");
 }
 
 // ========================================
@@ -291,3 +346,960 @@ void test_logger_after_cleanup(void) {
     
     TEST_PASS();
 }
+
+// ========================================
+// 非同步模式測試
+// ========================================
+
+#define ASYNC_PRODUCERS          4
+#define ASYNC_MSGS_PER_PRODUCER  2000
+
+static void *async_producer(void *arg) {
+    int id = (int)(long)arg;
+    for (int i = 0; i < ASYNC_MSGS_PER_PRODUCER; i++) {
+        logger_info("producer %d message %d", id, i);
+    }
+    return NULL;
+}
+
+void test_logger_async_requires_init(void) {
+    TEST_ASSERT_EQUAL(GAMING_ERROR_NOT_INITIALIZED, logger_async_start(NULL));
+}
+
+void test_logger_async_start_stop(void) {
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_CONSOLE);
+
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_async_start(NULL));
+    TEST_ASSERT_TRUE(logger_is_async());
+    TEST_ASSERT_EQUAL(GAMING_ERROR_ALREADY_EXISTS, logger_async_start(NULL));
+
+    logger_async_stop();
+    TEST_ASSERT_FALSE(logger_is_async());
+}
+
+void test_logger_async_invalid_config(void) {
+    logger_async_config_t config = { .queue_depth = LOGGER_MAX_QUEUE_DEPTH + 1 };
+
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_CONSOLE);
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_async_start(&config));
+    TEST_ASSERT_FALSE(logger_is_async());
+}
+
+void test_logger_async_flush_drains_queue(void) {
+    logger_async_stats_t stats;
+
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_CONSOLE);
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_async_start(NULL));
+
+    silence_stderr();
+    for (int i = 0; i < 100; i++) {
+        logger_info("async message %d", i);
+    }
+    logger_debug("filtered before enqueue");
+    logger_flush();
+    restore_stderr();
+
+    logger_get_async_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(stats.enqueued, stats.written);
+    TEST_ASSERT_EQUAL_UINT32(100, stats.enqueued + stats.dropped);
+    TEST_ASSERT_TRUE(stats.batches > 0);
+}
+
+void test_logger_async_drop_policy_counts_drops(void) {
+    logger_async_config_t config = { .queue_depth = 2, .overflow = LOG_OVERFLOW_DROP };
+    logger_async_stats_t stats;
+
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_CONSOLE);
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_async_start(&config));
+
+    silence_stderr();
+    for (int i = 0; i < 5000; i++) {
+        logger_info("burst message %d", i);
+    }
+    logger_flush();
+    restore_stderr();
+
+    // 呼叫端從不等待: 放不下的筆數全部計入 dropped
+    logger_get_async_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(5000, stats.enqueued + stats.dropped);
+    TEST_ASSERT_TRUE(stats.dropped > 0);
+    TEST_ASSERT_EQUAL_UINT32(stats.enqueued, stats.written);
+}
+
+void test_logger_async_block_policy_multi_producer(void) {
+    logger_async_config_t config = { .queue_depth = 8, .overflow = LOG_OVERFLOW_BLOCK };
+    logger_async_stats_t stats;
+    pthread_t threads[ASYNC_PRODUCERS];
+
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_CONSOLE);
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_async_start(&config));
+
+    silence_stderr();
+    for (long i = 0; i < ASYNC_PRODUCERS; i++) {
+        pthread_create(&threads[i], NULL, async_producer, (void *)i);
+    }
+    for (int i = 0; i < ASYNC_PRODUCERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    logger_flush();
+    restore_stderr();
+
+    // 阻塞模式下不丟任何一筆
+    logger_get_async_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.dropped);
+    TEST_ASSERT_EQUAL_UINT32(ASYNC_PRODUCERS * ASYNC_MSGS_PER_PRODUCER, stats.enqueued);
+    TEST_ASSERT_EQUAL_UINT32(stats.enqueued, stats.written);
+}
+
+void test_logger_cleanup_stops_async(void) {
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_CONSOLE);
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_async_start(NULL));
+
+    logger_cleanup();
+
+    TEST_ASSERT_FALSE(logger_is_async());
+}
+
+// ========================================
+// 時間戳記格式測試
+// ========================================
+
+#define CAPTURE_PATH     "/tmp/test_logger_capture.txt"
+#define BENCHMARK_LINES  50000
+
+static void assert_digits(const char *p, int count) {
+    for (int i = 0; i < count; i++) {
+        TEST_ASSERT_TRUE(p[i] >= '0' && p[i] <= '9');
+    }
+}
+
+void test_logger_console_timestamp_has_milliseconds(void) {
+    char line[256] = {0};
+
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_CONSOLE);
+
+    capture_stderr(CAPTURE_PATH);
+    logger_info("timestamp check %d", 42);
+    logger_flush();
+    restore_stderr();
+
+    FILE *fp = fopen(CAPTURE_PATH, "r");
+    TEST_ASSERT_NOT_NULL(fp);
+    TEST_ASSERT_NOT_NULL(fgets(line, sizeof(line), fp));
+    fclose(fp);
+    unlink(CAPTURE_PATH);
+
+    // [YYYY-mm-dd HH:MM:SS.mmm] [INFO] timestamp check 42
+    TEST_ASSERT_EQUAL_INT('[', line[0]);
+    assert_digits(line + 1, 4);
+    TEST_ASSERT_EQUAL_INT('-', line[5]);
+    TEST_ASSERT_EQUAL_INT(' ', line[11]);
+    TEST_ASSERT_EQUAL_INT(':', line[14]);
+    TEST_ASSERT_EQUAL_INT('.', line[20]);
+    assert_digits(line + 21, 3);
+    TEST_ASSERT_EQUAL_STRING("] [INFO] timestamp check 42\n", line + 24);
+}
+
+void test_logger_async_timestamp_format(void) {
+    char line[256] = {0};
+
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_CONSOLE);
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_async_start(NULL));
+
+    capture_stderr(CAPTURE_PATH);
+    logger_warning("queued %s", "line");
+    logger_flush();
+    restore_stderr();
+
+    FILE *fp = fopen(CAPTURE_PATH, "r");
+    TEST_ASSERT_NOT_NULL(fp);
+    TEST_ASSERT_NOT_NULL(fgets(line, sizeof(line), fp));
+    fclose(fp);
+    unlink(CAPTURE_PATH);
+
+    TEST_ASSERT_EQUAL_INT('.', line[20]);
+    TEST_ASSERT_EQUAL_STRING("] [WARNING] queued line\n", line + 24);
+}
+
+// ========================================
+// 效能
+// ========================================
+
+static double elapsed_sec(const struct timespec *start, const struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// 舊版做法: 每一行都 time() + localtime() + strftime()
+static void reference_console_line(const char *fmt, int value) {
+    char timestamp[32];
+    char msg[LOGGER_MSG_MAX];
+    time_t now = time(NULL);
+    struct tm *tm_info = localtime(&now);
+
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", tm_info);
+    snprintf(msg, sizeof(msg), fmt, value);
+    fprintf(stderr, "[%s] [%s] %s\n", timestamp, "INFO", msg);
+}
+
+void test_logger_console_throughput_benchmark(void) {
+    struct timespec start, end;
+
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_CONSOLE);
+
+    silence_stderr();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < BENCHMARK_LINES; i++) {
+        reference_console_line("benchmark line %d", i);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double reference = BENCHMARK_LINES / elapsed_sec(&start, &end);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < BENCHMARK_LINES; i++) {
+        logger_info("benchmark line %d", i);
+    }
+    logger_flush();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double cached = BENCHMARK_LINES / elapsed_sec(&start, &end);
+    restore_stderr();
+
+    char msg[128];
+    snprintf(msg, sizeof(msg),
+             "Logger console: %.0f lines/s (per-line localtime %.0f lines/s)",
+             cached, reference);
+    TEST_MESSAGE(msg);
+}
+
+// ========================================
+// 重複訊息限速測試
+// ========================================
+
+static void sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static int count_lines(const char *path, const char *needle) {
+    char line[512];
+    int count = 0;
+    FILE *fp = fopen(path, "r");
+    TEST_ASSERT_NOT_NULL(fp);
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (strstr(line, needle) != NULL) {
+            count++;
+        }
+    }
+    fclose(fp);
+    return count;
+}
+
+void test_logger_ratelimit_burst_then_suppress(void) {
+    logger_ratelimit_t rl = LOGGER_RATELIMIT_INIT;
+
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL(0, logger_ratelimit_check(&rl, 1, 3));
+    }
+    for (int i = 0; i < 100; i++) {
+        TEST_ASSERT_TRUE(logger_ratelimit_check(&rl, 1, 3) < 0);
+    }
+}
+
+void test_logger_ratelimit_refill_reports_suppressed(void) {
+    logger_ratelimit_t rl = LOGGER_RATELIMIT_INIT;
+
+    TEST_ASSERT_EQUAL(0, logger_ratelimit_check(&rl, 20, 1));
+    for (int i = 0; i < 50; i++) {
+        TEST_ASSERT_TRUE(logger_ratelimit_check(&rl, 20, 1) < 0);
+    }
+
+    // 20 筆/秒: 等 100ms 後一定補回一筆
+    sleep_ms(100);
+    TEST_ASSERT_EQUAL(50, logger_ratelimit_check(&rl, 20, 1));
+    TEST_ASSERT_TRUE(logger_ratelimit_check(&rl, 20, 1) < 0);
+}
+
+void test_logger_ratelimit_invalid_params_allow(void) {
+    logger_ratelimit_t rl = LOGGER_RATELIMIT_INIT;
+
+    TEST_ASSERT_EQUAL(0, logger_ratelimit_check(NULL, 1, 1));
+    TEST_ASSERT_EQUAL(0, logger_ratelimit_check(&rl, 0, 1));
+    TEST_ASSERT_EQUAL(0, logger_ratelimit_check(&rl, 1, 0));
+}
+
+void test_logger_mod_ratelimited_summary_line(void) {
+    char expected[64];
+
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_CONSOLE);
+
+    capture_stderr(CAPTURE_PATH);
+    for (int round = 0; round < 2; round++) {
+        for (int i = 0; i < LOGGER_RATELIMIT_BURST + 40; i++) {
+            logger_mod_ratelimited(LOG_MODULE_ADC, LOG_LEVEL_ERROR, "ADC read failed");
+        }
+        // 等待補充至少一筆
+        sleep_ms(1000 / LOGGER_RATELIMIT_RATE + 50);
+    }
+    logger_flush();
+    restore_stderr();
+
+    snprintf(expected, sizeof(expected), "last message repeated %d times", 40);
+    TEST_ASSERT_EQUAL(1, count_lines(CAPTURE_PATH, expected));
+    unlink(CAPTURE_PATH);
+}
+
+// ========================================
+// syslog 傳輸測試 (以本地 datagram socket 代替 /dev/log)
+// ========================================
+
+#define TEST_DEVLOG_PATH   "/tmp/test_logger_devlog"
+#define SYSLOG_BURST       200
+
+static int open_fake_devlog(void) {
+    struct sockaddr_un addr;
+    int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    TEST_ASSERT_TRUE(fd >= 0);
+
+    unlink(TEST_DEVLOG_PATH);
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, TEST_DEVLOG_PATH, sizeof(addr.sun_path) - 1);
+    TEST_ASSERT_EQUAL(0, bind(fd, (struct sockaddr *)&addr, sizeof(addr)));
+    return fd;
+}
+
+static void close_fake_devlog(int fd) {
+    close(fd);
+    unlink(TEST_DEVLOG_PATH);
+}
+
+/**
+ * @brief 接收一個 datagram
+ * @return 長度, 逾時則 -1
+ */
+static int recv_datagram(int fd, char *buf, size_t size, int timeout_ms) {
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    if (poll(&pfd, 1, timeout_ms) <= 0) {
+        return -1;
+    }
+
+    ssize_t n = recv(fd, buf, size - 1, 0);
+    if (n < 0) {
+        return -1;
+    }
+    buf[n] = '\0';
+    return (int)n;
+}
+
+static void *devlog_reader(void *arg) {
+    int fd = *(int *)arg;
+    char buf[512];
+    long received = 0;
+
+    while (recv_datagram(fd, buf, sizeof(buf), 1000) > 0) {
+        received++;
+        if (received == SYSLOG_BURST) {
+            break;
+        }
+    }
+    return (void *)received;
+}
+
+void test_logger_syslog_datagram_format(void) {
+    char buf[256];
+    char expected[128];
+    int fd = open_fake_devlog();
+
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_set_syslog_path(TEST_DEVLOG_PATH));
+    logger_init("test-logger", LOG_LEVEL_DEBUG, LOG_TARGET_SYSLOG);
+
+    logger_info("hello %d", 1);
+    TEST_ASSERT_TRUE(recv_datagram(fd, buf, sizeof(buf), 1000) > 0);
+    // LOG_USER | LOG_INFO = 14
+    snprintf(expected, sizeof(expected), "<14>test-logger[%d]: hello 1", (int)getpid());
+    TEST_ASSERT_EQUAL_STRING(expected, buf);
+
+    logger_error("failed");
+    TEST_ASSERT_TRUE(recv_datagram(fd, buf, sizeof(buf), 1000) > 0);
+    // LOG_USER | LOG_ERR = 11
+    snprintf(expected, sizeof(expected), "<11>test-logger[%d]: failed", (int)getpid());
+    TEST_ASSERT_EQUAL_STRING(expected, buf);
+
+    close_fake_devlog(fd);
+}
+
+void test_logger_syslog_set_path_invalid(void) {
+    char long_path[256];
+    memset(long_path, 'x', sizeof(long_path) - 1);
+    long_path[sizeof(long_path) - 1] = '\0';
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_set_syslog_path(NULL));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_set_syslog_path(long_path));
+}
+
+void test_logger_syslog_reconnects_after_restart(void) {
+    char buf[512];
+    logger_syslog_stats_t before, after;
+    int fd = open_fake_devlog();
+
+    logger_set_syslog_path(TEST_DEVLOG_PATH);
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_SYSLOG);
+
+    logger_info("before restart");
+    TEST_ASSERT_TRUE(recv_datagram(fd, buf, sizeof(buf), 1000) > 0);
+
+    // 模擬 logd 重啟: 舊 socket 消失,同一路徑建立新的 socket
+    close_fake_devlog(fd);
+    fd = open_fake_devlog();
+
+    logger_get_syslog_stats(&before);
+    logger_info("after restart");
+    logger_get_syslog_stats(&after);
+
+    TEST_ASSERT_TRUE(recv_datagram(fd, buf, sizeof(buf), 1000) > 0);
+    TEST_ASSERT_NOT_NULL(strstr(buf, "after restart"));
+    TEST_ASSERT_EQUAL_UINT32(before.reconnects + 1, after.reconnects);
+    TEST_ASSERT_EQUAL_UINT32(before.sent + 1, after.sent);
+
+    close_fake_devlog(fd);
+}
+
+void test_logger_syslog_missing_daemon_drops(void) {
+    logger_syslog_stats_t before, after;
+
+    unlink(TEST_DEVLOG_PATH);
+    logger_set_syslog_path(TEST_DEVLOG_PATH);
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_SYSLOG);
+
+    logger_get_syslog_stats(&before);
+    logger_info("nobody listening");
+    logger_get_syslog_stats(&after);
+
+    TEST_ASSERT_EQUAL_UINT32(before.dropped + 1, after.dropped);
+    TEST_ASSERT_EQUAL_UINT32(before.sent, after.sent);
+}
+
+void test_logger_syslog_async_batches(void) {
+    logger_syslog_stats_t before, after;
+    logger_async_config_t config = { .queue_depth = 64, .overflow = LOG_OVERFLOW_BLOCK };
+    pthread_t reader;
+    void *received;
+    int fd = open_fake_devlog();
+
+    logger_set_syslog_path(TEST_DEVLOG_PATH);
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_SYSLOG);
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_async_start(&config));
+    logger_get_syslog_stats(&before);
+
+    // 接收佇列很小,寫入執行緒必須等待 socket 可寫而不是丟棄
+    pthread_create(&reader, NULL, devlog_reader, &fd);
+    for (int i = 0; i < SYSLOG_BURST; i++) {
+        logger_info("async syslog %d", i);
+    }
+    logger_flush();
+    pthread_join(reader, &received);
+
+    logger_get_syslog_stats(&after);
+    TEST_ASSERT_EQUAL(SYSLOG_BURST, (long)received);
+    TEST_ASSERT_EQUAL_UINT32(before.sent + SYSLOG_BURST, after.sent);
+    TEST_ASSERT_EQUAL_UINT32(before.dropped, after.dropped);
+
+    close_fake_devlog(fd);
+}
+
+// ========================================
+// 檔案輸出測試
+// ========================================
+
+#define TEST_LOG_FILE      "/tmp/test_logger_file.log"
+#define FILE_BENCH_LINES   20000
+
+static void remove_log_files(void) {
+    unlink(TEST_LOG_FILE);
+    unlink(TEST_LOG_FILE ".1");
+    unlink(TEST_LOG_FILE ".2");
+    unlink(TEST_LOG_FILE ".3");
+}
+
+static long file_size(const char *path) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        return -1;
+    }
+    return (long)st.st_size;
+}
+
+void test_logger_file_writes_after_flush(void) {
+    logger_file_config_t config = { .path = TEST_LOG_FILE, .sync = LOG_FILE_SYNC_NEVER };
+    logger_file_stats_t before, after;
+
+    remove_log_files();
+    logger_get_file_stats(&before);
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_set_file(&config));
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_FILE));
+
+    logger_info("file line %d", 1);
+    logger_warning("file line %d", 2);
+    logger_debug("filtered");
+
+    // 尚在緩衝區中
+    TEST_ASSERT_EQUAL(0, file_size(TEST_LOG_FILE));
+
+    logger_flush();
+    TEST_ASSERT_EQUAL(1, count_lines(TEST_LOG_FILE, "[INFO] file line 1"));
+    TEST_ASSERT_EQUAL(1, count_lines(TEST_LOG_FILE, "[WARNING] file line 2"));
+    TEST_ASSERT_EQUAL(0, count_lines(TEST_LOG_FILE, "filtered"));
+
+    logger_get_file_stats(&after);
+    TEST_ASSERT_EQUAL_UINT32(before.lines + 2, after.lines);
+    TEST_ASSERT_EQUAL_UINT32(before.writes + 1, after.writes);
+
+    logger_cleanup();
+    remove_log_files();
+}
+
+void test_logger_file_batches_writes(void) {
+    logger_file_config_t config = {
+        .path = TEST_LOG_FILE, .buffer_size = 4096, .sync = LOG_FILE_SYNC_NEVER,
+        .flush_interval_ms = 60000,
+    };
+    logger_file_stats_t before, after;
+
+    remove_log_files();
+    logger_set_file(&config);
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_FILE);
+    logger_get_file_stats(&before);
+
+    for (int i = 0; i < 500; i++) {
+        logger_info("batched line %d", i);
+    }
+    logger_flush();
+
+    // 每行約 50 位元組,4 KB 緩衝區約每 80 行才 write() 一次
+    logger_get_file_stats(&after);
+    TEST_ASSERT_EQUAL_UINT32(before.lines + 500, after.lines);
+    TEST_ASSERT_TRUE(after.writes - before.writes <= 10);
+    TEST_ASSERT_EQUAL_UINT32(before.syncs, after.syncs);
+    TEST_ASSERT_EQUAL(500, count_lines(TEST_LOG_FILE, "batched line"));
+
+    logger_cleanup();
+    remove_log_files();
+}
+
+void test_logger_file_syncs_on_error(void) {
+    logger_file_config_t config = { .path = TEST_LOG_FILE, .flush_interval_ms = 60000 };
+    logger_file_stats_t before, after;
+
+    remove_log_files();
+    logger_set_file(&config);
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_FILE);
+    logger_get_file_stats(&before);
+
+    logger_info("before error");
+    logger_get_file_stats(&after);
+    TEST_ASSERT_EQUAL_UINT32(before.syncs, after.syncs);
+
+    // ERROR 連同之前緩衝的內容立即寫入並 fdatasync
+    logger_error("disk must see this");
+    logger_get_file_stats(&after);
+    TEST_ASSERT_EQUAL_UINT32(before.syncs + 1, after.syncs);
+    TEST_ASSERT_EQUAL(1, count_lines(TEST_LOG_FILE, "before error"));
+    TEST_ASSERT_EQUAL(1, count_lines(TEST_LOG_FILE, "disk must see this"));
+
+    logger_cleanup();
+    remove_log_files();
+}
+
+void test_logger_file_sync_mode_writes_error_without_fsync(void) {
+    logger_file_config_t config = {
+        .path = TEST_LOG_FILE, .flush_interval_ms = 60000, .sync = LOG_FILE_SYNC_NEVER,
+    };
+    logger_file_stats_t before, after;
+
+    remove_log_files();
+    logger_set_file(&config);
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_FILE);
+    logger_get_file_stats(&before);
+
+    logger_info("buffered info");
+    TEST_ASSERT_EQUAL(0, file_size(TEST_LOG_FILE));
+
+    // 同步模式沒有計時器: ERROR 不等間隔也不等下一筆日誌
+    logger_error("idle after this");
+    TEST_ASSERT_EQUAL(1, count_lines(TEST_LOG_FILE, "buffered info"));
+    TEST_ASSERT_EQUAL(1, count_lines(TEST_LOG_FILE, "idle after this"));
+    logger_get_file_stats(&after);
+    TEST_ASSERT_EQUAL_UINT32(before.syncs, after.syncs);
+
+    logger_cleanup();
+    remove_log_files();
+}
+
+void test_logger_file_rotates_by_size(void) {
+    logger_file_config_t config = {
+        .path = TEST_LOG_FILE, .buffer_size = 256, .max_size = 1024, .max_files = 2,
+        .sync = LOG_FILE_SYNC_NEVER,
+    };
+    logger_file_stats_t before, after;
+
+    remove_log_files();
+    logger_set_file(&config);
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_FILE);
+    logger_get_file_stats(&before);
+
+    for (int i = 0; i < 200; i++) {
+        logger_info("rotating line %d", i);
+    }
+    logger_flush();
+
+    logger_get_file_stats(&after);
+    TEST_ASSERT_TRUE(after.rotations - before.rotations >= 2);
+    TEST_ASSERT_TRUE(file_size(TEST_LOG_FILE) <= 1024);
+    TEST_ASSERT_TRUE(file_size(TEST_LOG_FILE ".1") > 0);
+    TEST_ASSERT_TRUE(file_size(TEST_LOG_FILE ".2") > 0);
+    // 超過 max_files 的舊檔不保留
+    TEST_ASSERT_EQUAL(-1, file_size(TEST_LOG_FILE ".3"));
+    // 最新的一行在目前的檔案
+    TEST_ASSERT_EQUAL(1, count_lines(TEST_LOG_FILE, "rotating line 199"));
+
+    logger_cleanup();
+    remove_log_files();
+}
+
+void test_logger_file_async_time_flush(void) {
+    logger_file_config_t config = {
+        .path = TEST_LOG_FILE, .flush_interval_ms = 50, .sync = LOG_FILE_SYNC_NEVER,
+    };
+    logger_async_config_t async_config = { .queue_depth = 64, .overflow = LOG_OVERFLOW_BLOCK };
+
+    remove_log_files();
+    logger_set_file(&config);
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_FILE);
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_async_start(&async_config));
+
+    logger_info("idle flush");
+
+    // 不呼叫 logger_flush,寫入執行緒在間隔到期後自行寫出
+    int found = 0;
+    for (int i = 0; i < 100 && !found; i++) {
+        sleep_ms(10);
+        found = file_size(TEST_LOG_FILE) > 0;
+    }
+    TEST_ASSERT_TRUE(found);
+    TEST_ASSERT_EQUAL(1, count_lines(TEST_LOG_FILE, "idle flush"));
+
+    logger_cleanup();
+    remove_log_files();
+}
+
+void test_logger_file_open_failure(void) {
+    logger_file_config_t config = { .path = "/nonexistent-dir/gaming.log" };
+
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_set_file(&config));
+    silence_stderr();
+    TEST_ASSERT_EQUAL(GAMING_ERROR_IO,
+                      logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_FILE));
+
+    // 切換失敗時維持原本的目標
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_CONSOLE);
+    TEST_ASSERT_EQUAL(GAMING_ERROR_IO, logger_set_target(LOG_TARGET_FILE));
+    restore_stderr();
+    TEST_ASSERT_EQUAL(LOG_TARGET_CONSOLE, logger_get_target());
+}
+
+void test_logger_file_invalid_config(void) {
+    char long_path[256];
+    memset(long_path, 'x', sizeof(long_path) - 1);
+    long_path[sizeof(long_path) - 1] = '\0';
+
+    logger_file_config_t config = { .path = long_path };
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_set_file(&config));
+
+    config.path = "";
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_set_file(&config));
+
+    config.path = TEST_LOG_FILE;
+    config.sync = (log_file_sync_t)99;
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_set_file(&config));
+}
+
+static volatile int drain_running = 0;
+
+static void *devlog_drain(void *arg) {
+    int fd = *(int *)arg;
+    char buf[512];
+
+    while (__atomic_load_n(&drain_running, __ATOMIC_RELAXED)) {
+        recv_datagram(fd, buf, sizeof(buf), 20);
+    }
+    return NULL;
+}
+
+static double bench_target(log_target_t target, double *worst_us) {
+    struct timespec start, end, t0, t1;
+
+    logger_init("test-logger", LOG_LEVEL_INFO, target);
+    *worst_us = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < FILE_BENCH_LINES; i++) {
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        logger_info("benchmark line %d", i);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        double us = elapsed_sec(&t0, &t1) * 1e6;
+        if (us > *worst_us) {
+            *worst_us = us;
+        }
+    }
+    logger_flush();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    logger_cleanup();
+    return FILE_BENCH_LINES / elapsed_sec(&start, &end);
+}
+
+void test_logger_file_vs_syslog_benchmark(void) {
+    logger_file_config_t config = { .path = TEST_LOG_FILE, .max_size = 64 * 1024 * 1024 };
+    double file_worst, syslog_worst;
+    pthread_t reader;
+    int fd = open_fake_devlog();
+
+    remove_log_files();
+    logger_file_stats_t stats;
+    logger_get_file_stats(&stats);
+    unsigned int file_writes = (unsigned int)stats.writes;
+    logger_set_file(&config);
+    double file_rate = bench_target(LOG_TARGET_FILE, &file_worst);
+
+    logger_get_file_stats(&stats);
+    file_writes = (unsigned int)stats.writes - file_writes;
+
+    logger_set_syslog_path(TEST_DEVLOG_PATH);
+    __atomic_store_n(&drain_running, 1, __ATOMIC_RELAXED);
+    pthread_create(&reader, NULL, devlog_drain, &fd);
+    double syslog_rate = bench_target(LOG_TARGET_SYSLOG, &syslog_worst);
+    __atomic_store_n(&drain_running, 0, __ATOMIC_RELAXED);
+    pthread_join(reader, NULL);
+    close_fake_devlog(fd);
+
+    char msg[192];
+    snprintf(msg, sizeof(msg),
+             "Logger file: %.0f lines/s, worst %.1f us, %u writes "
+             "(syslog %.0f lines/s, worst %.1f us)",
+             file_rate, file_worst, file_writes, syslog_rate, syslog_worst);
+    TEST_MESSAGE(msg);
+
+    remove_log_files();
+}
+
+// ========================================
+// 模組日誌測試
+// ========================================
+
+void test_logger_module_level_set_get(void) {
+    TEST_ASSERT_EQUAL(LOG_LEVEL_INHERIT, logger_get_module_level(LOG_MODULE_GPIO));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_set_module_level(LOG_MODULE_GPIO, LOG_LEVEL_DEBUG));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_DEBUG, logger_get_module_level(LOG_MODULE_GPIO));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_set_module_level(LOG_MODULE_GPIO, LOG_LEVEL_INHERIT));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_INHERIT, logger_get_module_level(LOG_MODULE_GPIO));
+}
+
+void test_logger_module_level_invalid(void) {
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM,
+                      logger_set_module_level(LOG_MODULE_COUNT, LOG_LEVEL_INFO));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM,
+                      logger_set_module_level(LOG_MODULE_ADC, 42));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_get_module_level(LOG_MODULE_COUNT));
+}
+
+void test_logger_module_names(void) {
+    TEST_ASSERT_EQUAL_STRING("gpio", logger_module_name(LOG_MODULE_GPIO));
+    TEST_ASSERT_EQUAL_STRING("socket", logger_module_name(LOG_MODULE_SOCKET));
+    TEST_ASSERT_EQUAL(LOG_MODULE_HAL, logger_module_from_name("HAL"));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_module_from_name("wifi"));
+
+    TEST_ASSERT_EQUAL(LOG_LEVEL_WARN, logger_level_from_name("warning"));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_WARN, logger_level_from_name("warn"));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_DEBUG, logger_level_from_name("Debug"));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_level_from_name("loud"));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_level_from_name(NULL));
+}
+
+void test_logger_module_tag_and_per_module_level(void) {
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_CONSOLE);
+    logger_set_module_level(LOG_MODULE_GPIO, LOG_LEVEL_DEBUG);
+    logger_set_module_level(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR);
+
+    capture_stderr(CAPTURE_PATH);
+    logger_mod(LOG_MODULE_GPIO, LOG_LEVEL_DEBUG, "GPIO%d initialized as output", 5);
+    logger_mod(LOG_MODULE_ADC, LOG_LEVEL_DEBUG, "adc debug hidden");
+    logger_mod(LOG_MODULE_ADC, LOG_LEVEL_INFO, "adc info shown");
+    logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_WARN, "socket warn hidden");
+    logger_mod(LOG_MODULE_SOCKET, LOG_LEVEL_ERROR, "connect %s: %s", "/tmp/x", "refused");
+    logger_debug("core debug hidden");
+    logger_flush();
+    restore_stderr();
+
+    TEST_ASSERT_EQUAL(1, count_lines(CAPTURE_PATH, "[DEBUG] [gpio] GPIO5 initialized as output"));
+    TEST_ASSERT_EQUAL(1, count_lines(CAPTURE_PATH, "[INFO] [adc] adc info shown"));
+    TEST_ASSERT_EQUAL(1, count_lines(CAPTURE_PATH, "[ERROR] [socket] connect /tmp/x: refused"));
+    TEST_ASSERT_EQUAL(0, count_lines(CAPTURE_PATH, "hidden"));
+    unlink(CAPTURE_PATH);
+}
+
+void test_logger_module_skips_argument_evaluation(void) {
+    int evaluated = 0;
+    logger_init("test-logger", LOG_LEVEL_DEBUG, LOG_TARGET_CONSOLE);
+    logger_set_module_level(LOG_MODULE_LED, LOG_LEVEL_ERROR);
+
+    logger_mod(LOG_MODULE_LED, LOG_LEVEL_INFO, "count %d", ++evaluated);
+    TEST_ASSERT_EQUAL(0, evaluated);
+}
+
+void test_logger_apply_module_levels(void) {
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_apply_module_levels("gpio=debug, socket=error"));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_DEBUG, logger_get_module_level(LOG_MODULE_GPIO));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_ERROR, logger_get_module_level(LOG_MODULE_SOCKET));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_INHERIT, logger_get_module_level(LOG_MODULE_ADC));
+
+    // 整份設定取代先前的設定
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_apply_module_levels("*=warn adc=inherit"));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_WARN, logger_get_module_level(LOG_MODULE_GPIO));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_INHERIT, logger_get_module_level(LOG_MODULE_ADC));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_apply_module_levels(NULL));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_INHERIT, logger_get_module_level(LOG_MODULE_GPIO));
+}
+
+void test_logger_apply_module_levels_invalid_keeps_settings(void) {
+    logger_set_module_level(LOG_MODULE_HAL, LOG_LEVEL_DEBUG);
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_apply_module_levels("gpio=loud"));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_apply_module_levels("wifi=debug"));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_apply_module_levels("gpio"));
+
+    TEST_ASSERT_EQUAL(LOG_LEVEL_DEBUG, logger_get_module_level(LOG_MODULE_HAL));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_INHERIT, logger_get_module_level(LOG_MODULE_GPIO));
+}
+
+void test_logger_module_fallback_to_stderr_when_uninitialized(void) {
+    capture_stderr(CAPTURE_PATH);
+    logger_mod(LOG_MODULE_HAL, LOG_LEVEL_ERROR, "GPIO sysfs not available: %s", "ENOENT");
+    logger_mod(LOG_MODULE_HAL, LOG_LEVEL_INFO, "info hidden");
+    logger_error("core hidden");
+    restore_stderr();
+
+    TEST_ASSERT_EQUAL(1, count_lines(CAPTURE_PATH, "[hal] GPIO sysfs not available: ENOENT"));
+    TEST_ASSERT_EQUAL(0, count_lines(CAPTURE_PATH, "hidden"));
+    unlink(CAPTURE_PATH);
+}
+
+void test_logger_module_async(void) {
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_CONSOLE);
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_async_start(NULL));
+
+    capture_stderr(CAPTURE_PATH);
+    logger_mod(LOG_MODULE_ADC, LOG_LEVEL_WARN, "Failed to read ADC from %s", "/dev/ADC");
+    logger_flush();
+    restore_stderr();
+    logger_async_stop();
+
+    TEST_ASSERT_EQUAL(1, count_lines(CAPTURE_PATH, "[WARNING] [adc] Failed to read ADC from /dev/ADC"));
+    unlink(CAPTURE_PATH);
+}
+
+void test_logger_debug_signal_toggles_all_modules(void) {
+    logger_init("test-logger", LOG_LEVEL_INFO, LOG_TARGET_CONSOLE);
+    logger_set_module_level(LOG_MODULE_GPIO, LOG_LEVEL_ERROR);
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_install_debug_signal(SIGUSR1));
+    TEST_ASSERT_FALSE(logger_debug_override_active());
+
+    capture_stderr(CAPTURE_PATH);
+    logger_mod(LOG_MODULE_GPIO, LOG_LEVEL_DEBUG, "before signal");
+    raise(SIGUSR1);
+    logger_mod(LOG_MODULE_GPIO, LOG_LEVEL_DEBUG, "while debugging");
+    logger_debug("core while debugging");
+    raise(SIGUSR1);
+    logger_mod(LOG_MODULE_GPIO, LOG_LEVEL_DEBUG, "after signal");
+    logger_flush();
+    restore_stderr();
+
+    TEST_ASSERT_FALSE(logger_debug_override_active());
+    TEST_ASSERT_EQUAL(LOG_LEVEL_ERROR, logger_get_module_level(LOG_MODULE_GPIO));
+    TEST_ASSERT_EQUAL(2, count_lines(CAPTURE_PATH, "while debugging"));
+    TEST_ASSERT_EQUAL(0, count_lines(CAPTURE_PATH, "before signal"));
+    TEST_ASSERT_EQUAL(0, count_lines(CAPTURE_PATH, "after signal"));
+    unlink(CAPTURE_PATH);
+
+    signal(SIGUSR1, SIG_DFL);
+}
+
+// ========================================
+// 巨集前端測試
+// ========================================
+
+static int evaluated_count = 0;
+
+static int count_evaluation(void) {
+    return ++evaluated_count;
+}
+
+void test_logger_macro_skips_argument_evaluation(void) {
+    evaluated_count = 0;
+    logger_init("test-logger", LOG_LEVEL_WARN, LOG_TARGET_CONSOLE);
+
+    logger_debug("debug %d", count_evaluation());
+    logger_info("info %d", count_evaluation());
+    TEST_ASSERT_EQUAL(0, evaluated_count);
+
+    silence_stderr();
+    logger_warning("warning %d", count_evaluation());
+    logger_error("error %d", count_evaluation());
+    restore_stderr();
+    TEST_ASSERT_EQUAL(2, evaluated_count);
+}
+
+void test_logger_macro_disabled_before_init(void) {
+    evaluated_count = 0;
+
+    logger_error("error %d", count_evaluation());
+
+    TEST_ASSERT_EQUAL(0, evaluated_count);
+}
+
+void test_logger_functions_still_callable(void) {
+    void (*fn)(const char *, ...) = logger_info;
+    (void)fn;
+
+    logger_init("test-logger", LOG_LEVEL_DEBUG, LOG_TARGET_CONSOLE);
+
+    silence_stderr();
+    (logger_info)("direct call %d", 1);
+    (logger_log)(LOG_LEVEL_DEBUG, "direct call %d", 2);
+    restore_stderr();
+
+    TEST_ASSERT_NOT_NULL(fn);
+}
+
+// 以下測試以較高的編譯期最低等級展開巨集
+#undef LOGGER_MIN_LEVEL
+#define LOGGER_MIN_LEVEL LOG_LEVEL_WARN
+
+void test_logger_compile_time_min_level(void) {
+    evaluated_count = 0;
+    logger_init("test-logger", LOG_LEVEL_DEBUG, LOG_TARGET_CONSOLE);
+
+    // 執行期等級為 DEBUG,但 INFO/DEBUG 已在編譯期移除
+    logger_debug("debug %d", count_evaluation());
+    logger_info("info %d", count_evaluation());
+    TEST_ASSERT_EQUAL(0, evaluated_count);
+    TEST_ASSERT_FALSE(LOGGER_ENABLED(LOG_LEVEL_INFO));
+
+    silence_stderr();
+    logger_warning("warning %d", count_evaluation());
+    restore_stderr();
+    TEST_ASSERT_EQUAL(1, evaluated_count);
+}
@@ -0,0 +1,392 @@
+/**
+ * @file test_logger_binary.c
+ * @brief Logger Binary 單元測試
+ * @version 1.0.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "unity.h"
+#include "logger_binary.h"
+#include "logger.h"
+#include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// ========================================
+// 測試輔助
+// ========================================
+
+#define TEST_BIN_PATH   "/tmp/test_logger_binary.blog"
+#define TEST_TEXT_PATH  "/tmp/test_logger_binary.txt"
+
+static char decoded[8192];
+static int saved_stderr = -1;
+
+static void silence_stderr(void) {
+    fflush(stderr);
+    saved_stderr = dup(STDERR_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd >= 0) {
+        dup2(null_fd, STDERR_FILENO);
+        close(null_fd);
+    }
+}
+
+static void restore_stderr(void) {
+    if (saved_stderr >= 0) {
+        fflush(stderr);
+        dup2(saved_stderr, STDERR_FILENO);
+        close(saved_stderr);
+        saved_stderr = -1;
+    }
+}
+
+/**
+ * @brief 解碼檔案到 decoded,回傳筆數
+ */
+static int decode_file(const char *path) {
+    FILE *in = fopen(path, "rb");
+    FILE *out = fopen(TEST_TEXT_PATH, "w+");
+    TEST_ASSERT_NOT_NULL(in);
+    TEST_ASSERT_NOT_NULL(out);
+
+    int count = logger_bin_decode(in, out);
+
+    rewind(out);
+    size_t n = fread(decoded, 1, sizeof(decoded) - 1, out);
+    decoded[n] = '\0';
+
+    fclose(in);
+    fclose(out);
+    return count;
+}
+
+/**
+ * @brief 取得第 index 行去掉 "[時間] " 之後的內容
+ */
+static const char* decoded_line(int index, char *line, size_t size) {
+    const char *p = decoded;
+    for (int i = 0; i < index && p != NULL; i++) {
+        p = strchr(p, '\n');
+        if (p != NULL) {
+            p++;
+        }
+    }
+    TEST_ASSERT_NOT_NULL(p);
+
+    const char *start = strstr(p, "] [");
+    TEST_ASSERT_NOT_NULL(start);
+    start += 2;
+    const char *end = strchr(start, '\n');
+    size_t len = end ? (size_t)(end - start) : strlen(start);
+    if (len >= size) {
+        len = size - 1;
+    }
+    memcpy(line, start, len);
+    line[len] = '\0';
+    return line;
+}
+
+static long file_size(const char *path) {
+    struct stat st;
+    return (stat(path, &st) == 0) ? (long)st.st_size : -1;
+}
+
+void setUp(void) {
+    logger_init("test-binary", LOG_LEVEL_DEBUG, LOG_TARGET_CONSOLE);
+}
+
+void tearDown(void) {
+    logger_bin_close();
+    logger_cleanup();
+    restore_stderr();
+    unlink(TEST_BIN_PATH);
+    unlink(TEST_TEXT_PATH);
+}
+
+// ========================================
+// 開啟與關閉
+// ========================================
+
+void test_logger_bin_open_null_path(void) {
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_bin_open(NULL));
+}
+
+void test_logger_bin_open_bad_path(void) {
+    silence_stderr();
+    TEST_ASSERT_EQUAL(GAMING_ERROR_IO, logger_bin_open("/nonexistent/dir/log.blog"));
+    restore_stderr();
+    TEST_ASSERT_FALSE(logger_bin_is_open());
+}
+
+void test_logger_bin_open_close(void) {
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_bin_open(TEST_BIN_PATH));
+    TEST_ASSERT_TRUE(logger_bin_is_open());
+
+    logger_bin_close();
+    TEST_ASSERT_FALSE(logger_bin_is_open());
+    TEST_ASSERT_EQUAL(0, decode_file(TEST_BIN_PATH));
+}
+
+// ========================================
+// 編碼與解碼
+// ========================================
+
+void test_logger_bin_roundtrip_types(void) {
+    char line[256];
+
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_bin_open(TEST_BIN_PATH));
+    LOGGER_BIN(LOG_LEVEL_INFO, "int=%d neg=%i hex=0x%04x char=%c", 42, -7, 0xbeef, 'Z');
+    LOGGER_BIN(LOG_LEVEL_WARN, "long=%ld llong=%lld size=%zu", -123456L, 1LL << 40, (size_t)99);
+    LOGGER_BIN(LOG_LEVEL_DEBUG, "str=%s pad=[%-6s] prec=%.2s", "router", "ab", "xyz");
+    LOGGER_BIN(LOG_LEVEL_ERROR, "double=%.3f width=[%*d] pct=100%%", 3.14159, 5, 42);
+    logger_bin_close();
+
+    TEST_ASSERT_EQUAL(4, decode_file(TEST_BIN_PATH));
+    TEST_ASSERT_EQUAL_STRING("[INFO] int=42 neg=-7 hex=0xbeef char=Z",
+                             decoded_line(0, line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING("[WARNING] long=-123456 llong=1099511627776 size=99",
+                             decoded_line(1, line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING("[DEBUG] str=router pad=[ab    ] prec=xy",
+                             decoded_line(2, line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING("[ERROR] double=3.142 width=[   42] pct=100%",
+                             decoded_line(3, line, sizeof(line)));
+}
+
+void test_logger_bin_null_string(void) {
+    char line[128];
+    const char *missing = NULL;
+
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_bin_open(TEST_BIN_PATH));
+    LOGGER_BIN(LOG_LEVEL_INFO, "value %s", missing);
+    logger_bin_close();
+
+    TEST_ASSERT_EQUAL(1, decode_file(TEST_BIN_PATH));
+    TEST_ASSERT_EQUAL_STRING("[INFO] value (null)", decoded_line(0, line, sizeof(line)));
+}
+
+void test_logger_bin_long_string_truncated(void) {
+    char longstr[LOGGER_BIN_MAX_STRING * 2 + 1];
+    char line[512];
+
+    memset(longstr, 'a', sizeof(longstr) - 1);
+    longstr[sizeof(longstr) - 1] = '\0';
+
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_bin_open(TEST_BIN_PATH));
+    LOGGER_BIN(LOG_LEVEL_INFO, "%s|%d", longstr, 7);
+    logger_bin_close();
+
+    TEST_ASSERT_EQUAL(1, decode_file(TEST_BIN_PATH));
+    decoded_line(0, line, sizeof(line));
+    TEST_ASSERT_EQUAL(strlen("[INFO] ") + LOGGER_BIN_MAX_STRING + 2, strlen(line));
+    TEST_ASSERT_EQUAL_STRING("|7", line + strlen(line) - 2);
+}
+
+void test_logger_bin_same_site_reused(void) {
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_bin_open(TEST_BIN_PATH));
+    for (int i = 0; i < 100; i++) {
+        LOGGER_BIN(LOG_LEVEL_INFO, "iteration %d", i);
+    }
+    logger_bin_close();
+
+    TEST_ASSERT_EQUAL(100, decode_file(TEST_BIN_PATH));
+    TEST_ASSERT_NOT_NULL(strstr(decoded, "[INFO] iteration 0\n"));
+    TEST_ASSERT_NOT_NULL(strstr(decoded, "[INFO] iteration 99\n"));
+}
+
+void test_logger_bin_reopen_rewrites_definitions(void) {
+    char line[128];
+
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_bin_open(TEST_BIN_PATH));
+    for (int i = 0; i < 2; i++) {
+        LOGGER_BIN(LOG_LEVEL_INFO, "round %d", i);
+        // 第二輪寫入新檔案,呼叫點定義必須重新寫入
+        TEST_ASSERT_EQUAL(GAMING_OK, logger_bin_open(TEST_BIN_PATH));
+    }
+    logger_bin_close();
+
+    TEST_ASSERT_EQUAL(1, decode_file(TEST_BIN_PATH));
+    TEST_ASSERT_EQUAL_STRING("[INFO] round 1", decoded_line(0, line, sizeof(line)));
+}
+
+void test_logger_bin_filtered_level_not_recorded(void) {
+    static int evaluated = 0;
+
+    logger_set_level(LOG_LEVEL_WARN);
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_bin_open(TEST_BIN_PATH));
+    LOGGER_BIN(LOG_LEVEL_DEBUG, "skipped %d", ++evaluated);
+    LOGGER_BIN(LOG_LEVEL_WARN, "kept %d", ++evaluated);
+    logger_bin_close();
+
+    TEST_ASSERT_EQUAL(1, evaluated);
+    TEST_ASSERT_EQUAL(1, decode_file(TEST_BIN_PATH));
+}
+
+void test_logger_bin_falls_back_to_text_when_closed(void) {
+    FILE *fp;
+    char line[256] = {0};
+
+    fflush(stderr);
+    saved_stderr = dup(STDERR_FILENO);
+    int fd = open(TEST_TEXT_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    dup2(fd, STDERR_FILENO);
+    close(fd);
+
+    LOGGER_BIN(LOG_LEVEL_INFO, "text fallback %d", 5);
+    logger_flush();
+    restore_stderr();
+
+    fp = fopen(TEST_TEXT_PATH, "r");
+    TEST_ASSERT_NOT_NULL(fp);
+    TEST_ASSERT_NOT_NULL(fgets(line, sizeof(line), fp));
+    fclose(fp);
+    TEST_ASSERT_NOT_NULL(strstr(line, "[INFO] text fallback 5"));
+}
+
+void test_logger_bin_decode_rejects_bad_magic(void) {
+    FILE *fp = fopen(TEST_BIN_PATH, "wb");
+    TEST_ASSERT_NOT_NULL(fp);
+    fputs("NOTABLOG", fp);
+    fclose(fp);
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_IO, decode_file(TEST_BIN_PATH));
+}
+
+void test_logger_bin_decode_opposite_byte_order(void) {
+    // 以 big-endian 與 little-endian 手工組出同一筆記錄
+    static const uint8_t big_endian[] = {
+        'G', 'B', 'L', '1', 0x01, 0x02, 0x00, 0x00,
+        // 定義: id=1, level=INFO, line=10, nargs=2 ("is")
+        0x01, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x0a, 0x02, 'i', 's',
+        0x00, 0x0d, 'r', 's', 's', 'i', '=', '%', 'd', ' ', 'i', 'f', '=', '%', 's',
+        0x00, 0x03, 'x', '.', 'c',
+        // 日誌: id=1, sec=0, msec=5, len=4+2+4
+        0x02, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x0a,
+        0xff, 0xff, 0xff, 0xc4, 0x00, 0x04, 'w', 'l', 'a', 'n',
+    };
+    static const uint8_t little_endian[] = {
+        'G', 'B', 'L', '1', 0x02, 0x01, 0x00, 0x00,
+        0x01, 0x01, 0x00, 0x01, 0x0a, 0x00, 0x00, 0x00, 0x02, 'i', 's',
+        0x0d, 0x00, 'r', 's', 's', 'i', '=', '%', 'd', ' ', 'i', 'f', '=', '%', 's',
+        0x03, 0x00, 'x', '.', 'c',
+        0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x0a, 0x00,
+        0xc4, 0xff, 0xff, 0xff, 0x04, 0x00, 'w', 'l', 'a', 'n',
+    };
+    const uint8_t *images[] = { big_endian, little_endian };
+    const size_t sizes[] = { sizeof(big_endian), sizeof(little_endian) };
+    char line[128];
+
+    for (int i = 0; i < 2; i++) {
+        FILE *fp = fopen(TEST_BIN_PATH, "wb");
+        TEST_ASSERT_NOT_NULL(fp);
+        fwrite(images[i], 1, sizes[i], fp);
+        fclose(fp);
+
+        TEST_ASSERT_EQUAL(1, decode_file(TEST_BIN_PATH));
+        TEST_ASSERT_EQUAL_STRING("[INFO] rssi=-60 if=wlan", decoded_line(0, line, sizeof(line)));
+        TEST_ASSERT_NOT_NULL(strstr(decoded, ".005] "));
+    }
+}
+
+void test_logger_bin_decode_ignores_recorded_kinds(void) {
+    // 損毀的定義: 記錄的類型為 "ii",格式字串卻是 %s 與 %n;
+    // 解碼端以格式字串重新推導類型,不會把整數當成指標使用
+    static const uint8_t image[] = {
+        'G', 'B', 'L', '1', 0x02, 0x01, 0x00, 0x00,
+        0x01, 0x01, 0x00, 0x01, 0x0a, 0x00, 0x00, 0x00, 0x02, 'i', 'i',
+        0x09, 0x00, 'a', '=', '%', 's', ' ', 'b', '=', '%', 'n',
+        0x03, 0x00, 'x', '.', 'c',
+        0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x04, 0x00,
+        0x02, 0x00, 'o', 'k',
+    };
+    char line[128];
+
+    FILE *fp = fopen(TEST_BIN_PATH, "wb");
+    TEST_ASSERT_NOT_NULL(fp);
+    fwrite(image, 1, sizeof(image), fp);
+    fclose(fp);
+
+    TEST_ASSERT_EQUAL(1, decode_file(TEST_BIN_PATH));
+    TEST_ASSERT_EQUAL_STRING("[INFO] a=ok b=", decoded_line(0, line, sizeof(line)));
+}
+
+void test_logger_bin_format_rejects_mismatched_kinds(void) {
+    int32_t values[3] = { 0x1000, 0x2000, 42 };
+    char out[64];
+
+    // 類型與轉換不符的參數輸出 "?" 並略過,之後的參數仍對得上
+    logger_bin_format("%s %n %d", "iii", 3, (const uint8_t *)values, sizeof(values),
+                      out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("? ? 42", out);
+}
+
+void test_logger_bin_truncated_tail_ignored(void) {
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_bin_open(TEST_BIN_PATH));
+    LOGGER_BIN(LOG_LEVEL_INFO, "first %d", 1);
+    LOGGER_BIN(LOG_LEVEL_INFO, "second %s", "complete");
+    logger_bin_close();
+
+    // 模擬寫到一半斷電: 截掉最後幾個位元組
+    TEST_ASSERT_EQUAL(0, truncate(TEST_BIN_PATH, file_size(TEST_BIN_PATH) - 3));
+
+    TEST_ASSERT_EQUAL(1, decode_file(TEST_BIN_PATH));
+}
+
+// ========================================
+// 空間與效能
+// ========================================
+
+#define BENCHMARK_LINES 50000
+
+static double elapsed_sec(const struct timespec *start, const struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+void test_logger_bin_smaller_than_text(void) {
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_bin_open(TEST_BIN_PATH));
+    for (int i = 0; i < 1000; i++) {
+        LOGGER_BIN(LOG_LEVEL_DEBUG, "client %d rssi=%d channel=%u state=%s",
+                   i, -40 - (i % 30), (unsigned)(i % 13), "connected");
+    }
+    logger_bin_close();
+
+    TEST_ASSERT_EQUAL(1000, decode_file(TEST_BIN_PATH));
+    long binary = file_size(TEST_BIN_PATH);
+    long text = file_size(TEST_TEXT_PATH);
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "Binary log: %ld bytes, decoded text: %ld bytes", binary, text);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(binary * 2 < text);
+}
+
+void test_logger_bin_throughput_benchmark(void) {
+    struct timespec start, end;
+
+    silence_stderr();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < BENCHMARK_LINES; i++) {
+        logger_debug("client %d rssi=%d state=%s", i, -55, "connected");
+    }
+    logger_flush();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    restore_stderr();
+    double text = BENCHMARK_LINES / elapsed_sec(&start, &end);
+
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_bin_open(TEST_BIN_PATH));
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < BENCHMARK_LINES; i++) {
+        LOGGER_BIN(LOG_LEVEL_DEBUG, "client %d rssi=%d state=%s", i, -55, "connected");
+    }
+    logger_bin_close();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double binary = BENCHMARK_LINES / elapsed_sec(&start, &end);
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "Logger: binary %.0f lines/s, text console %.0f lines/s",
+             binary, text);
+    TEST_MESSAGE(msg);
+}
@@ -0,0 +1,165 @@
+/**
+ * @file test_logger_config.c
+ * @brief Logger UCI 設定載入單元測試
+ * @version 1.0.0
+ */
+
+#include "unity.h"
+#include "logger_config.h"
+#include "logger.h"
+#include "mock_config_parser.h"
+#include <string.h>
+#include <unistd.h>
+
+// ========================================
+// 測試輔助: 假的 UCI 內容
+// ========================================
+
+static const char *uci_log_level = NULL;
+static const char *uci_log_modules = NULL;
+static const char *uci_log_target = NULL;
+static const char *uci_log_file = NULL;
+static const char *uci_log_file_size = NULL;
+static const char *uci_log_format = NULL;
+
+static int fake_get_string(const char *config_name, const char *section, const char *option,
+                           char *buffer, size_t buffer_size, int cmock_num_calls) {
+    const char *value = NULL;
+
+    if (strcmp(option, UCI_OPTION_LOG_LEVEL) == 0) {
+        value = uci_log_level;
+    } else if (strcmp(option, UCI_OPTION_LOG_MODULES) == 0) {
+        value = uci_log_modules;
+    } else if (strcmp(option, UCI_OPTION_LOG_TARGET) == 0) {
+        value = uci_log_target;
+    } else if (strcmp(option, UCI_OPTION_LOG_FILE) == 0) {
+        value = uci_log_file;
+    } else if (strcmp(option, UCI_OPTION_LOG_FILE_SIZE) == 0) {
+        value = uci_log_file_size;
+    } else if (strcmp(option, UCI_OPTION_LOG_FORMAT) == 0) {
+        value = uci_log_format;
+    }
+
+    if (value == NULL) {
+        return GAMING_ERROR_NOT_FOUND;
+    }
+    strncpy(buffer, value, buffer_size - 1);
+    buffer[buffer_size - 1] = '\0';
+    return GAMING_OK;
+}
+
+void setUp(void) {
+    uci_log_level = NULL;
+    uci_log_modules = NULL;
+    uci_log_target = NULL;
+    uci_log_file = NULL;
+    uci_log_file_size = NULL;
+    uci_log_format = NULL;
+    logger_init("test-logger-config", LOG_LEVEL_INFO, LOG_TARGET_CONSOLE);
+    logger_apply_module_levels(NULL);
+
+    config_parser_init_IgnoreAndReturn(GAMING_OK);
+    config_parser_add_reload_hook_IgnoreAndReturn(GAMING_OK);
+    config_parser_get_string_Stub(fake_get_string);
+}
+
+void tearDown(void) {
+    logger_apply_module_levels(NULL);
+    logger_cleanup();
+    logger_set_file(NULL);
+    logger_set_format(LOG_FORMAT_TEXT);
+}
+
+// ========================================
+// 載入測試
+// ========================================
+
+void test_logger_config_reload_applies_levels(void) {
+    uci_log_level = "warn";
+    uci_log_modules = "gpio=debug socket=error";
+
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_config_reload());
+
+    TEST_ASSERT_EQUAL(LOG_LEVEL_WARN, logger_get_level());
+    TEST_ASSERT_EQUAL(LOG_LEVEL_DEBUG, logger_get_module_level(LOG_MODULE_GPIO));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_ERROR, logger_get_module_level(LOG_MODULE_SOCKET));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_INHERIT, logger_get_module_level(LOG_MODULE_ADC));
+}
+
+void test_logger_config_reload_missing_options(void) {
+    logger_set_level(LOG_LEVEL_DEBUG);
+    logger_set_module_level(LOG_MODULE_LED, LOG_LEVEL_ERROR);
+
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_config_reload());
+
+    // 未設定 log_level 保留目前值,未設定 log_modules 全部跟隨全域
+    TEST_ASSERT_EQUAL(LOG_LEVEL_DEBUG, logger_get_level());
+    TEST_ASSERT_EQUAL(LOG_LEVEL_INHERIT, logger_get_module_level(LOG_MODULE_LED));
+}
+
+void test_logger_config_reload_invalid_level(void) {
+    uci_log_level = "verbose";
+    uci_log_modules = "adc=debug";
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_config_reload());
+
+    TEST_ASSERT_EQUAL(LOG_LEVEL_INFO, logger_get_level());
+    TEST_ASSERT_EQUAL(LOG_LEVEL_DEBUG, logger_get_module_level(LOG_MODULE_ADC));
+}
+
+void test_logger_config_reload_invalid_modules_keeps_settings(void) {
+    logger_set_module_level(LOG_MODULE_HAL, LOG_LEVEL_DEBUG);
+    uci_log_level = "error";
+    uci_log_modules = "hal=debug wifi=info";
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_config_reload());
+
+    TEST_ASSERT_EQUAL(LOG_LEVEL_ERROR, logger_get_level());
+    TEST_ASSERT_EQUAL(LOG_LEVEL_DEBUG, logger_get_module_level(LOG_MODULE_HAL));
+}
+
+void test_logger_config_reload_parser_unavailable(void) {
+    config_parser_init_IgnoreAndReturn(GAMING_ERROR);
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR, logger_config_reload());
+    TEST_ASSERT_EQUAL(LOG_LEVEL_INFO, logger_get_level());
+}
+
+void test_logger_config_reload_file_target(void) {
+    uci_log_target = "file";
+    uci_log_file = "/tmp/test_logger_config.log";
+    uci_log_file_size = "64";
+
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_config_reload());
+    TEST_ASSERT_EQUAL(LOG_TARGET_FILE, logger_get_target());
+
+    logger_error("written to file");
+    TEST_ASSERT_EQUAL(0, access("/tmp/test_logger_config.log", F_OK));
+
+    // 改回 console 後關閉檔案
+    uci_log_target = "console";
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_config_reload());
+    TEST_ASSERT_EQUAL(LOG_TARGET_CONSOLE, logger_get_target());
+    unlink("/tmp/test_logger_config.log");
+}
+
+void test_logger_config_reload_invalid_target_keeps_target(void) {
+    uci_log_target = "network";
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_config_reload());
+    TEST_ASSERT_EQUAL(LOG_TARGET_CONSOLE, logger_get_target());
+
+    uci_log_target = "file";
+    uci_log_file_size = "big";
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_config_reload());
+}
+
+void test_logger_config_reload_format(void) {
+    uci_log_format = "json";
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_config_reload());
+    TEST_ASSERT_EQUAL(LOG_FORMAT_JSON, logger_get_format());
+
+    uci_log_format = "xml";
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_config_reload());
+    TEST_ASSERT_EQUAL(LOG_FORMAT_JSON, logger_get_format());
+}
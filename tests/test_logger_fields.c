@@ -0,0 +1,344 @@
+/**
+ * @file test_logger_fields.c
+ * @brief Logger Fields 結構化日誌單元測試
+ * @version 1.0.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "unity.h"
+#include "logger_fields.h"
+#include "logger.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// ========================================
+// 測試輔助
+// ========================================
+
+#define TEST_KV_FILE       "/tmp/test_logger_fields.log"
+#define KV_BENCH_RECORDS   200000
+
+static char out[LOGGER_MSG_MAX];
+static char file_text[4096];
+
+/**
+ * @brief 以檔案目標初始化 logger,輸出內容可讀回檢查
+ */
+static void init_file_logger(log_format_t format) {
+    logger_file_config_t config = { .path = TEST_KV_FILE, .sync = LOG_FILE_SYNC_NEVER };
+
+    unlink(TEST_KV_FILE);
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_set_file(&config));
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_init("test-kv", LOG_LEVEL_DEBUG, LOG_TARGET_FILE));
+    TEST_ASSERT_EQUAL(GAMING_OK, logger_set_format(format));
+}
+
+static const char *read_log_file(void) {
+    logger_flush();
+
+    FILE *fp = fopen(TEST_KV_FILE, "r");
+    TEST_ASSERT_NOT_NULL(fp);
+    size_t n = fread(file_text, 1, sizeof(file_text) - 1, fp);
+    file_text[n] = '\0';
+    fclose(fp);
+    return file_text;
+}
+
+void setUp(void) {
+    logger_cleanup();
+}
+
+void tearDown(void) {
+    logger_cleanup();
+    logger_set_format(LOG_FORMAT_TEXT);
+    logger_set_file(NULL);
+    unlink(TEST_KV_FILE);
+}
+
+// ========================================
+// 編碼測試
+// ========================================
+
+void test_logger_kv_encode_text(void) {
+    log_kv_t fields[] = { LOG_KV_PIN(17), LOG_KV_INT("ret", -5), LOG_KV_STR("edge", "both") };
+
+    size_t len = logger_kv_encode(LOG_FORMAT_TEXT, out, sizeof(out), LOG_MODULE_GPIO,
+                                  LOG_LEVEL_ERROR, "write failed", fields, 3);
+
+    TEST_ASSERT_EQUAL_STRING("[gpio] write failed pin=17 ret=-5 edge=both", out);
+    TEST_ASSERT_EQUAL(strlen(out), len);
+}
+
+void test_logger_kv_encode_text_core_has_no_tag(void) {
+    log_kv_t fields[] = { LOG_KV_UINT("clients", 3) };
+
+    logger_kv_encode(LOG_FORMAT_TEXT, out, sizeof(out), LOG_MODULE_CORE,
+                     LOG_LEVEL_INFO, "started", fields, 1);
+
+    TEST_ASSERT_EQUAL_STRING("started clients=3", out);
+}
+
+void test_logger_kv_encode_logfmt(void) {
+    log_kv_t fields[] = {
+        LOG_KV_PIN(17), LOG_KV_ERROR(GAMING_ERROR_HAL_FAILED), LOG_KV_STR("path", "/sys/class/gpio"),
+    };
+
+    logger_kv_encode(LOG_FORMAT_LOGFMT, out, sizeof(out), LOG_MODULE_GPIO,
+                     LOG_LEVEL_WARN, "write failed", fields, 3);
+
+    TEST_ASSERT_EQUAL_STRING(
+        "level=warn module=gpio msg=\"write failed\" pin=17 error=hal_failed path=/sys/class/gpio",
+        out);
+}
+
+void test_logger_kv_encode_json(void) {
+    log_kv_t fields[] = {
+        LOG_KV_PIN(4), LOG_KV_ERROR(GAMING_ERROR_IO), LOG_KV_DURATION_US("elapsed", 1500),
+        LOG_KV_STR("name", NULL),
+    };
+
+    logger_kv_encode(LOG_FORMAT_JSON, out, sizeof(out), LOG_MODULE_ADC,
+                     LOG_LEVEL_DEBUG, "sample", fields, 4);
+
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"level\":\"debug\",\"module\":\"adc\",\"msg\":\"sample\","
+        "\"pin\":4,\"error\":\"io\",\"elapsed\":1500,\"name\":null}",
+        out);
+}
+
+void test_logger_kv_encode_integer_limits(void) {
+    log_kv_t fields[] = {
+        LOG_KV_INT("min", INT64_MIN), LOG_KV_INT("zero", 0), LOG_KV_UINT("max", UINT64_MAX),
+    };
+
+    logger_kv_encode(LOG_FORMAT_LOGFMT, out, sizeof(out), LOG_MODULE_CORE,
+                     LOG_LEVEL_INFO, NULL, fields, 3);
+
+    TEST_ASSERT_EQUAL_STRING("level=info module=core min=-9223372036854775808 zero=0 "
+                             "max=18446744073709551615", out);
+}
+
+void test_logger_kv_encode_durations(void) {
+    log_kv_t fields[] = {
+        LOG_KV_DURATION_US("a", 999), LOG_KV_DURATION_US("b", 12345),
+        LOG_KV_DURATION_US("c", 2005000), LOG_KV_DURATION_US("d", 0),
+    };
+
+    logger_kv_encode(LOG_FORMAT_TEXT, out, sizeof(out), LOG_MODULE_CORE,
+                     LOG_LEVEL_INFO, "t", fields, 4);
+
+    TEST_ASSERT_EQUAL_STRING("t a=999us b=12.345ms c=2.005s d=0us", out);
+}
+
+void test_logger_kv_encode_escaping(void) {
+    log_kv_t fields[] = { LOG_KV_STR("s", "a \"b\"\\\n\x01") };
+
+    logger_kv_encode(LOG_FORMAT_JSON, out, sizeof(out), LOG_MODULE_CORE,
+                     LOG_LEVEL_INFO, "q\"", fields, 1);
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"level\":\"info\",\"module\":\"core\",\"msg\":\"q\\\"\",\"s\":\"a \\\"b\\\"\\\\\\n\\u0001\"}",
+        out);
+
+    logger_kv_encode(LOG_FORMAT_LOGFMT, out, sizeof(out), LOG_MODULE_CORE,
+                     LOG_LEVEL_INFO, "x=y", fields, 1);
+    TEST_ASSERT_EQUAL_STRING(
+        "level=info module=core msg=\"x=y\" s=\"a \\\"b\\\"\\\\\\n\x01\"", out);
+}
+
+void test_logger_kv_encode_unknown_error_is_numeric(void) {
+    log_kv_t fields[] = { LOG_KV_ERROR(-42), LOG_KV_ERROR(GAMING_OK) };
+
+    logger_kv_encode(LOG_FORMAT_JSON, out, sizeof(out), LOG_MODULE_CORE,
+                     LOG_LEVEL_ERROR, NULL, fields, 2);
+
+    TEST_ASSERT_EQUAL_STRING("{\"level\":\"error\",\"module\":\"core\",\"error\":-42,\"error\":\"ok\"}",
+                             out);
+    TEST_ASSERT_NULL(logger_kv_error_name(1));
+    TEST_ASSERT_EQUAL_STRING("timeout", logger_kv_error_name(GAMING_ERROR_TIMEOUT));
+}
+
+void test_logger_kv_encode_truncation_drops_whole_fields(void) {
+    char small[64];
+    log_kv_t fields[] = {
+        LOG_KV_INT("first", 1),
+        LOG_KV_STR("long", "this value does not fit in the remaining space"),
+        LOG_KV_INT("last", 3),
+    };
+
+    size_t len = logger_kv_encode(LOG_FORMAT_JSON, small, sizeof(small), LOG_MODULE_LED,
+                                  LOG_LEVEL_INFO, "m", fields, 3);
+
+    // JSON 仍然完整,放不下的欄位與之後的欄位整個省略
+    TEST_ASSERT_EQUAL_STRING("{\"level\":\"info\",\"module\":\"led\",\"msg\":\"m\",\"first\":1}", small);
+    TEST_ASSERT_EQUAL(strlen(small), len);
+    TEST_ASSERT_TRUE(len < sizeof(small));
+}
+
+void test_logger_kv_encode_long_message_keeps_header(void) {
+    char small[48];
+    char msg[128];
+    memset(msg, 'm', sizeof(msg) - 1);
+    msg[sizeof(msg) - 1] = '\0';
+
+    logger_kv_encode(LOG_FORMAT_JSON, small, sizeof(small), LOG_MODULE_HAL,
+                     LOG_LEVEL_WARN, msg, NULL, 0);
+
+    TEST_ASSERT_EQUAL_STRING("{\"level\":\"warn\",\"module\":\"hal\"}", small);
+}
+
+void test_logger_kv_encode_invalid_params(void) {
+    log_kv_t fields[] = { LOG_KV_INT("a", 1) };
+
+    TEST_ASSERT_EQUAL(0, logger_kv_encode(LOG_FORMAT_TEXT, NULL, 16, LOG_MODULE_CORE,
+                                          LOG_LEVEL_INFO, "m", fields, 1));
+    TEST_ASSERT_EQUAL(0, logger_kv_encode((log_format_t)9, out, sizeof(out), LOG_MODULE_CORE,
+                                          LOG_LEVEL_INFO, "m", fields, 1));
+    TEST_ASSERT_EQUAL_STRING("", out);
+    TEST_ASSERT_EQUAL(0, logger_kv_encode(LOG_FORMAT_TEXT, out, sizeof(out), LOG_MODULE_COUNT,
+                                          LOG_LEVEL_INFO, "m", fields, 1));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, logger_set_format((log_format_t)9));
+}
+
+// ========================================
+// 輸出測試
+// ========================================
+
+static int evaluated_count = 0;
+
+static int count_evaluation(void) {
+    return ++evaluated_count;
+}
+
+void test_logger_kv_writes_configured_format(void) {
+    init_file_logger(LOG_FORMAT_JSON);
+
+    logger_kv(LOG_MODULE_GPIO, LOG_LEVEL_ERROR, "write failed",
+              LOG_KV_PIN(17), LOG_KV_INT("ret", -5));
+
+    const char *text = read_log_file();
+    TEST_ASSERT_NOT_NULL(strstr(text,
+        "[ERROR] {\"level\":\"error\",\"module\":\"gpio\",\"msg\":\"write failed\","
+        "\"pin\":17,\"ret\":-5}\n"));
+}
+
+void test_logger_kv_logfmt_through_file(void) {
+    init_file_logger(LOG_FORMAT_LOGFMT);
+
+    logger_kv(LOG_MODULE_SOCKET, LOG_LEVEL_INFO, "connected",
+              LOG_KV_STR("peer", "/var/run/vpn.sock"), LOG_KV_DURATION_US("took", 2500));
+
+    const char *text = read_log_file();
+    TEST_ASSERT_NOT_NULL(strstr(text,
+        "[INFO] level=info module=socket msg=connected peer=/var/run/vpn.sock took=2.500ms\n"));
+}
+
+void test_logger_kv_console_stays_text(void) {
+    logger_init("test-kv", LOG_LEVEL_DEBUG, LOG_TARGET_CONSOLE);
+    logger_set_format(LOG_FORMAT_JSON);
+
+    // 只輸出到 console 時忽略 JSON 設定
+    fflush(stderr);
+    int saved = dup(STDERR_FILENO);
+    int fd = open(TEST_KV_FILE, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    TEST_ASSERT_TRUE(fd >= 0);
+    dup2(fd, STDERR_FILENO);
+    close(fd);
+
+    logger_kv(LOG_MODULE_LED, LOG_LEVEL_INFO, "on", LOG_KV_PIN(2));
+
+    fflush(stderr);
+    dup2(saved, STDERR_FILENO);
+    close(saved);
+
+    const char *text = read_log_file();
+    TEST_ASSERT_NOT_NULL(strstr(text, "[INFO] [led] on pin=2\n"));
+    TEST_ASSERT_NULL(strchr(text, '{'));
+}
+
+void test_logger_kv_skips_field_evaluation(void) {
+    init_file_logger(LOG_FORMAT_TEXT);
+    logger_set_module_level(LOG_MODULE_ADC, LOG_LEVEL_ERROR);
+
+    evaluated_count = 0;
+    logger_kv(LOG_MODULE_ADC, LOG_LEVEL_DEBUG, "sample", LOG_KV_INT("n", count_evaluation()));
+    TEST_ASSERT_EQUAL(0, evaluated_count);
+
+    logger_kv(LOG_MODULE_ADC, LOG_LEVEL_ERROR, "sample", LOG_KV_INT("n", count_evaluation()));
+    TEST_ASSERT_EQUAL(1, evaluated_count);
+    TEST_ASSERT_NOT_NULL(strstr(read_log_file(), "[adc] sample n=1"));
+
+    logger_apply_module_levels(NULL);
+}
+
+void test_logger_kv_ratelimited_reports_suppressed(void) {
+    init_file_logger(LOG_FORMAT_LOGFMT);
+
+    for (int i = 0; i < LOGGER_RATELIMIT_BURST + 5; i++) {
+        logger_kv_ratelimited(LOG_MODULE_GPIO, LOG_LEVEL_ERROR, "read failed", LOG_KV_PIN(7));
+    }
+
+    const char *text = read_log_file();
+    int lines = 0;
+    for (const char *p = text; (p = strstr(p, "msg=\"read failed\"")) != NULL; p++) {
+        lines++;
+    }
+    TEST_ASSERT_EQUAL(LOGGER_RATELIMIT_BURST, lines);
+    TEST_ASSERT_NULL(strstr(text, "suppressed="));
+}
+
+void test_logger_kv_uninitialized_falls_back_to_stderr(void) {
+    // 未初始化時只有 WARNING 以上的模組訊息會寫到 stderr,不應當機
+    logger_kv(LOG_MODULE_HAL, LOG_LEVEL_DEBUG, "ignored", LOG_KV_INT("a", 1));
+    TEST_ASSERT_FALSE(LOGGER_MODULE_ENABLED(LOG_MODULE_HAL, LOG_LEVEL_DEBUG));
+    TEST_ASSERT_TRUE(LOGGER_MODULE_ENABLED(LOG_MODULE_HAL, LOG_LEVEL_WARN));
+}
+
+// ========================================
+// 效能
+// ========================================
+
+static double elapsed_ns(const struct timespec *start, const struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec);
+}
+
+void test_logger_kv_encode_benchmark(void) {
+    struct timespec start, end;
+    volatile size_t sink = 0;
+    const char *edge = "both";
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < KV_BENCH_RECORDS; i++) {
+        sink += (size_t)snprintf(out, sizeof(out),
+                                 "[gpio] Failed to write GPIO%d: %d edge=%s took=%u.%03ums",
+                                 i & 63, -5, edge, (unsigned)(i % 1000), (unsigned)(i % 997));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double printf_ns = elapsed_ns(&start, &end) / KV_BENCH_RECORDS;
+
+    double encode_ns[3];
+    for (int f = LOG_FORMAT_TEXT; f <= LOG_FORMAT_JSON; f++) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < KV_BENCH_RECORDS; i++) {
+            log_kv_t fields[] = {
+                LOG_KV_PIN(i & 63), LOG_KV_ERROR(GAMING_ERROR_HAL_FAILED),
+                LOG_KV_STR("edge", edge), LOG_KV_DURATION_US("took", (uint64_t)i * 1000 + 997),
+            };
+            sink += logger_kv_encode((log_format_t)f, out, sizeof(out), LOG_MODULE_GPIO,
+                                     LOG_LEVEL_ERROR, "write failed", fields, 4);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        encode_ns[f] = elapsed_ns(&start, &end) / KV_BENCH_RECORDS;
+    }
+    TEST_ASSERT_TRUE(sink > 0);
+
+    char msg[160];
+    snprintf(msg, sizeof(msg),
+             "Logger fields encode: text %.0f ns, logfmt %.0f ns, json %.0f ns (snprintf %.0f ns)",
+             encode_ns[LOG_FORMAT_TEXT], encode_ns[LOG_FORMAT_LOGFMT], encode_ns[LOG_FORMAT_JSON],
+             printf_ns);
+    TEST_MESSAGE(msg);
+}
@@ -0,0 +1,410 @@
+/**
+ * @file test_socket_frame.c
+ * @brief Socket Frame 單元測試
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "unity.h"
+#include "socket_frame.h"
+#include "socket_helper.h"
+#include "logger.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+// ========================================
+// 測試輔助
+// ========================================
+
+static int sv[2] = { -1, -1 };
+static socket_frame_reader_t *reader = NULL;
+
+#define MAX_FRAMES 16
+
+typedef struct {
+    int count;
+    size_t lens[MAX_FRAMES];
+    char payloads[MAX_FRAMES][64];
+    int fail_at;            // 第幾則訊息回傳錯誤 (-1 表示不失敗)
+} frames_t;
+
+static frames_t got;
+
+static int on_frame(const uint8_t *payload, size_t len, void *user_data) {
+    frames_t *f = user_data;
+    if (f->count == f->fail_at) {
+        f->fail_at = -1;
+        return GAMING_ERROR;
+    }
+    if (f->count < MAX_FRAMES) {
+        f->lens[f->count] = len;
+        memcpy(f->payloads[f->count], payload, len < 63 ? len : 63);
+    }
+    f->count++;
+    return GAMING_OK;
+}
+
+/**
+ * @brief 組出 "標頭 + payload" 的線上格式
+ */
+static size_t encode(uint8_t *out, const char *payload) {
+    size_t len = strlen(payload);
+    socket_frame_encode_header(out, (uint32_t)len);
+    memcpy(out + SOCKET_FRAME_HEADER_SIZE, payload, len);
+    return SOCKET_FRAME_HEADER_SIZE + len;
+}
+
+static long long now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void setUp(void) {
+    TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+    reader = socket_frame_reader_create(0);
+    TEST_ASSERT_NOT_NULL(reader);
+    memset(&got, 0, sizeof(got));
+    got.fail_at = -1;
+}
+
+void tearDown(void) {
+    socket_frame_reader_destroy(reader);
+    reader = NULL;
+    close(sv[0]);
+    close(sv[1]);
+}
+
+// ========================================
+// 參數驗證測試
+// ========================================
+
+void test_socket_frame_invalid_params(void) {
+    char buffer[8];
+    size_t len;
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_frame_send(-1, "x", 1, 0, 100));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_frame_send(sv[0], NULL, 1, 0, 100));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_frame_send_batch(sv[0], NULL, 1, 100));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_frame_recv(-1, buffer, sizeof(buffer), &len, 100));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_frame_recv(sv[0], buffer, sizeof(buffer), NULL, 100));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_frame_reader_feed(NULL, "x", 1, on_frame, &got));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_frame_reader_feed(reader, "x", 1, NULL, &got));
+    TEST_ASSERT_EQUAL(0, socket_frame_reader_pending(NULL));
+    socket_frame_reader_destroy(NULL);
+}
+
+void test_socket_frame_header_is_big_endian(void) {
+    uint8_t header[SOCKET_FRAME_HEADER_SIZE];
+    socket_frame_encode_header(header, 0x01020304);
+
+    TEST_ASSERT_EQUAL_HEX8(0x01, header[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x02, header[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x03, header[2]);
+    TEST_ASSERT_EQUAL_HEX8(0x04, header[3]);
+}
+
+// ========================================
+// 送出/接收測試
+// ========================================
+
+void test_socket_frame_send_recv_roundtrip(void) {
+    char buffer[64];
+    size_t len = 0;
+
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_send(sv[0], "hello", 5, 0, 100));
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_send(sv[0], NULL, 0, 0, 100));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_recv(sv[1], buffer, sizeof(buffer), &len, 100));
+    TEST_ASSERT_EQUAL(5, len);
+    TEST_ASSERT_EQUAL_MEMORY("hello", buffer, 5);
+
+    // 空訊息
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_recv(sv[1], buffer, sizeof(buffer), &len, 100));
+    TEST_ASSERT_EQUAL(0, len);
+}
+
+void test_socket_frame_recv_timeout_in_ms(void) {
+    char buffer[16];
+    size_t len;
+
+    long long start = now_us();
+    TEST_ASSERT_EQUAL(GAMING_ERROR_TIMEOUT, socket_frame_recv(sv[1], buffer, sizeof(buffer), &len, 50));
+    long long elapsed = now_us() - start;
+
+    TEST_ASSERT_TRUE(elapsed >= 45000);
+    TEST_ASSERT_TRUE(elapsed < 500000);
+}
+
+void test_socket_frame_recv_too_large(void) {
+    char buffer[4];
+    size_t len;
+
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_send(sv[0], "too long", 8, 0, 100));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_frame_recv(sv[1], buffer, sizeof(buffer), &len, 100));
+}
+
+void test_socket_frame_recv_peer_closed_mid_frame(void) {
+    uint8_t wire[16];
+    char buffer[16];
+    size_t len;
+
+    size_t n = encode(wire, "truncated");
+    TEST_ASSERT_EQUAL(n - 3, write(sv[0], wire, n - 3));
+    close(sv[0]);
+    sv[0] = -1;
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_IO, socket_frame_recv(sv[1], buffer, sizeof(buffer), &len, 100));
+}
+
+void test_socket_frame_send_batch(void) {
+    socket_frame_msg_t msgs[100];
+    char texts[100][8];
+    char buffer[16];
+    size_t len;
+
+    // 超過單次 sendmsg 的數量,會分成多次並以 MSG_MORE 串接
+    for (int i = 0; i < 100; i++) {
+        snprintf(texts[i], sizeof(texts[i]), "m%d", i);
+        msgs[i].data = texts[i];
+        msgs[i].len = strlen(texts[i]);
+    }
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_send_batch(sv[0], msgs, 100, 100));
+
+    for (int i = 0; i < 100; i++) {
+        TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_recv(sv[1], buffer, sizeof(buffer), &len, 100));
+        TEST_ASSERT_EQUAL(strlen(texts[i]), len);
+        TEST_ASSERT_EQUAL_MEMORY(texts[i], buffer, len);
+    }
+}
+
+void test_socket_frame_send_more_flag(void) {
+    char buffer[16];
+    size_t len;
+
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_send(sv[0], "a", 1, SOCKET_FRAME_MORE, 100));
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_send(sv[0], "b", 1, 0, 100));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_recv(sv[1], buffer, sizeof(buffer), &len, 100));
+    TEST_ASSERT_EQUAL_MEMORY("a", buffer, 1);
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_recv(sv[1], buffer, sizeof(buffer), &len, 100));
+    TEST_ASSERT_EQUAL_MEMORY("b", buffer, 1);
+}
+
+static void* drain_thread(void *arg) {
+    static uint8_t sink[8192];
+    size_t *total = arg;
+    ssize_t n;
+
+    while ((n = read(sv[1], sink, sizeof(sink))) > 0) {
+        *total += (size_t)n;
+    }
+    return NULL;
+}
+
+void test_socket_frame_send_handles_partial_writes(void) {
+    static uint8_t payload[1024 * 1024];
+    size_t total = 0;
+    pthread_t thread;
+
+    // 大於 socket 緩衝區: sendmsg 會部分寫入,需等待可寫後繼續
+    memset(payload, 0xab, sizeof(payload));
+    pthread_create(&thread, NULL, drain_thread, &total);
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_send(sv[0], payload, sizeof(payload), 0, 2000));
+    shutdown(sv[0], SHUT_WR);
+    pthread_join(thread, NULL);
+
+    TEST_ASSERT_EQUAL(SOCKET_FRAME_HEADER_SIZE + sizeof(payload), total);
+}
+
+void test_socket_frame_send_timeout(void) {
+    static uint8_t payload[1024 * 1024];
+
+    // 對端不讀取,期限到時回傳逾時
+    long long start = now_us();
+    TEST_ASSERT_EQUAL(GAMING_ERROR_TIMEOUT, socket_frame_send(sv[0], payload, sizeof(payload), 0, 30));
+    TEST_ASSERT_TRUE(now_us() - start < 500000);
+}
+
+// ========================================
+// 重組測試
+// ========================================
+
+void test_socket_frame_reader_multiple_frames_in_one_chunk(void) {
+    uint8_t wire[64];
+    size_t n = encode(wire, "one");
+    n += encode(wire + n, "two");
+    n += encode(wire + n, "three");
+
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_reader_feed(reader, wire, n, on_frame, &got));
+    TEST_ASSERT_EQUAL(3, got.count);
+    TEST_ASSERT_EQUAL_STRING("one", got.payloads[0]);
+    TEST_ASSERT_EQUAL_STRING("two", got.payloads[1]);
+    TEST_ASSERT_EQUAL_STRING("three", got.payloads[2]);
+    TEST_ASSERT_EQUAL(0, socket_frame_reader_pending(reader));
+}
+
+void test_socket_frame_reader_byte_by_byte(void) {
+    uint8_t wire[64];
+    size_t n = encode(wire, "split");
+    n += encode(wire + n, "");
+    n += encode(wire + n, "frames");
+
+    for (size_t i = 0; i < n; i++) {
+        TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_reader_feed(reader, wire + i, 1, on_frame, &got));
+    }
+
+    TEST_ASSERT_EQUAL(3, got.count);
+    TEST_ASSERT_EQUAL_STRING("split", got.payloads[0]);
+    TEST_ASSERT_EQUAL(0, got.lens[1]);
+    TEST_ASSERT_EQUAL_STRING("frames", got.payloads[2]);
+    TEST_ASSERT_EQUAL(0, socket_frame_reader_pending(reader));
+}
+
+void test_socket_frame_reader_partial_then_complete(void) {
+    uint8_t wire[64];
+    size_t n = encode(wire, "abcdef");
+    n += encode(wire + n, "gh");
+
+    // 第一則的一半
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_reader_feed(reader, wire, 7, on_frame, &got));
+    TEST_ASSERT_EQUAL(0, got.count);
+    TEST_ASSERT_EQUAL(7, socket_frame_reader_pending(reader));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_reader_feed(reader, wire + 7, n - 7, on_frame, &got));
+    TEST_ASSERT_EQUAL(2, got.count);
+    TEST_ASSERT_EQUAL_STRING("abcdef", got.payloads[0]);
+    TEST_ASSERT_EQUAL_STRING("gh", got.payloads[1]);
+}
+
+void test_socket_frame_reader_rejects_oversize(void) {
+    uint8_t header[SOCKET_FRAME_HEADER_SIZE];
+    socket_frame_reader_t *small = socket_frame_reader_create(8);
+
+    socket_frame_encode_header(header, 9);
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM,
+                      socket_frame_reader_feed(small, header, sizeof(header), on_frame, &got));
+
+    // 標頭分兩次到達也要檢查
+    socket_frame_reader_reset(small);
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_reader_feed(small, header, 2, on_frame, &got));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM,
+                      socket_frame_reader_feed(small, header + 2, 2, on_frame, &got));
+    TEST_ASSERT_EQUAL(0, got.count);
+
+    socket_frame_reader_destroy(small);
+}
+
+void test_socket_frame_reader_callback_error_keeps_rest(void) {
+    uint8_t wire[64];
+    size_t n = encode(wire, "a");
+    n += encode(wire + n, "b");
+    n += encode(wire + n, "c");
+
+    // 第二則回傳錯誤: 第三則保留到下次 feed
+    got.fail_at = 1;
+    TEST_ASSERT_EQUAL(GAMING_ERROR, socket_frame_reader_feed(reader, wire, n, on_frame, &got));
+    TEST_ASSERT_EQUAL(1, got.count);
+    TEST_ASSERT_TRUE(socket_frame_reader_pending(reader) > 0);
+
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_reader_feed(reader, NULL, 0, on_frame, &got));
+    TEST_ASSERT_EQUAL(2, got.count);
+    TEST_ASSERT_EQUAL_STRING("c", got.payloads[1]);
+    TEST_ASSERT_EQUAL(0, socket_frame_reader_pending(reader));
+}
+
+static int reject_first(const uint8_t *payload, size_t len, void *user_data) {
+    frames_t *f = user_data;
+    if (f->fail_at >= 0) {
+        f->fail_at = -1;
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    return on_frame(payload, len, user_data);
+}
+
+void test_socket_frame_reader_callback_invalid_param_keeps_rest(void) {
+    uint8_t wire[64];
+    size_t n = encode(wire, "a");
+    n += encode(wire + n, "b");
+
+    // callback 回傳 INVALID_PARAM 不是長度錯誤,剩餘資料仍須保留
+    got.fail_at = 0;
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM,
+                      socket_frame_reader_feed(reader, wire, n, reject_first, &got));
+    TEST_ASSERT_TRUE(socket_frame_reader_pending(reader) > 0);
+
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_reader_feed(reader, NULL, 0, reject_first, &got));
+    TEST_ASSERT_EQUAL(1, got.count);
+    TEST_ASSERT_EQUAL_STRING("b", got.payloads[0]);
+}
+
+// ========================================
+// 效能測試
+// ========================================
+
+#define BENCH_MESSAGES  20000
+
+static void* bench_drain(void *arg) {
+    size_t *frames = arg;
+    uint8_t buffer[65536];
+    socket_frame_reader_t *r = socket_frame_reader_create(0);
+    frames_t f = { .fail_at = -1 };
+    ssize_t n;
+
+    while ((n = read(sv[1], buffer, sizeof(buffer))) > 0) {
+        socket_frame_reader_feed(r, buffer, (size_t)n, on_frame, &f);
+    }
+    *frames = (size_t)f.count;
+    socket_frame_reader_destroy(r);
+    return NULL;
+}
+
+static long long bench_run(bool batch) {
+    static socket_frame_msg_t msgs[32];
+    static char payload[64];
+    size_t frames = 0;
+    pthread_t thread;
+
+    close(sv[0]);
+    close(sv[1]);
+    TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+    for (int i = 0; i < 32; i++) {
+        msgs[i].data = payload;
+        msgs[i].len = sizeof(payload);
+    }
+
+    pthread_create(&thread, NULL, bench_drain, &frames);
+    long long start = now_us();
+    for (int i = 0; i < BENCH_MESSAGES; i += 32) {
+        if (batch) {
+            socket_frame_send_batch(sv[0], msgs, 32, 1000);
+        } else {
+            for (int j = 0; j < 32; j++) {
+                socket_frame_send(sv[0], payload, sizeof(payload), 0, 1000);
+            }
+        }
+    }
+    long long elapsed = now_us() - start;
+    shutdown(sv[0], SHUT_WR);
+    pthread_join(thread, NULL);
+
+    TEST_ASSERT_EQUAL((BENCH_MESSAGES + 31) / 32 * 32, frames);
+    return elapsed;
+}
+
+void test_socket_frame_benchmark_batch_vs_single(void) {
+    char msg[128];
+
+    long long single = bench_run(false);
+    long long batch = bench_run(true);
+
+    snprintf(msg, sizeof(msg), "64-byte frames: single %.0f ns/msg, batch(32) %.0f ns/msg",
+             single * 1000.0 / BENCH_MESSAGES, batch * 1000.0 / BENCH_MESSAGES);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(batch < single);
+}
@@ -4,9 +4,62 @@
  * @version 1.0.0
  */
 
+#define _GNU_SOURCE
+
 #include "unity.h"
 #include "socket_helper.h"
+#include "logger.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
 #include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <sys/resource.h>
+#include <sys/select.h>
+#include <sys/time.h>
+
+// ========================================
+// 測試輔助
+// ========================================
+
+static long long now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/**
+ * @brief 在 127.0.0.1 的隨機埠號監聽
+ */
+static int listen_loopback(int *port) {
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (fd < 0 || bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 8) < 0 ||
+        getsockname(fd, (struct sockaddr*)&addr, &len) < 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    *port = ntohs(addr.sin_port);
+    return fd;
+}
+
+static int get_int_opt(int fd, int level, int name) {
+    int value = -1;
+    socklen_t len = sizeof(value);
+    getsockopt(fd, level, name, &value, &len);
+    return value;
+}
 
 void setUp(void) {
     // 測試前清理
@@ -51,6 +104,78 @@ void test_socket_helper_connect_tcp_invalid_port(void) {
     TEST_ASSERT_LESS_THAN(0, sockfd2);
 }
 
+void test_socket_helper_connect_tcp_timeout_success(void) {
+    int port;
+    int listen_fd = listen_loopback(&port);
+    TEST_ASSERT_TRUE(listen_fd >= 0);
+
+    int fd = socket_helper_connect_tcp_timeout("127.0.0.1", port, 1000);
+    TEST_ASSERT_TRUE(fd >= 0);
+
+    // 回傳的 socket 恢復為阻塞模式
+    TEST_ASSERT_EQUAL(0, fcntl(fd, F_GETFL, 0) & O_NONBLOCK);
+
+    int peer = accept(listen_fd, NULL, NULL);
+    TEST_ASSERT_TRUE(peer >= 0);
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_helper_send_all(fd, "ping", 4, 100));
+    char buffer[4];
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_helper_recv_all(peer, buffer, 4, 100));
+    TEST_ASSERT_EQUAL_MEMORY("ping", buffer, 4);
+
+    close(peer);
+    close(fd);
+    close(listen_fd);
+}
+
+void test_socket_helper_connect_tcp_timeout_refused(void) {
+    int port;
+    int listen_fd = listen_loopback(&port);
+    TEST_ASSERT_TRUE(listen_fd >= 0);
+    close(listen_fd);
+
+    int fd = socket_helper_connect_tcp_timeout("127.0.0.1", port, 1000);
+    TEST_ASSERT_LESS_THAN(0, fd);
+    TEST_ASSERT_EQUAL(ECONNREFUSED, errno);
+}
+
+void test_socket_helper_connect_tcp_timeout_expires(void) {
+    int port;
+
+    // 填滿 backlog 為 0 的監聽佇列,之後的 SYN 會被丟棄,connect 不會完成
+    int listen_fd = listen_loopback(&port);
+    TEST_ASSERT_TRUE(listen_fd >= 0);
+    TEST_ASSERT_EQUAL(0, listen(listen_fd, 0));
+
+    int filler[4];
+    int nfill = 0;
+    long long start = 0;
+    int fd = -1;
+    for (int i = 0; i < 4; i++) {
+        start = now_us();
+        fd = socket_helper_connect_tcp_timeout("127.0.0.1", port, 200);
+        if (fd < 0) {
+            break;
+        }
+        filler[nfill++] = fd;
+    }
+    long long elapsed_ms = (now_us() - start) / 1000;
+
+    if (fd >= 0) {
+        for (int i = 0; i < nfill; i++) {
+            close(filler[i]);
+        }
+        close(listen_fd);
+        TEST_IGNORE_MESSAGE("kernel accepted all connections, cannot provoke SYN drop");
+    }
+    TEST_ASSERT_EQUAL(ETIMEDOUT, errno);
+    TEST_ASSERT_INT_WITHIN(150, 250, elapsed_ms);
+
+    for (int i = 0; i < nfill; i++) {
+        close(filler[i]);
+    }
+    close(listen_fd);
+}
+
 // ========================================
 // Socket 選項測試
 // ========================================
@@ -70,6 +195,100 @@ void test_socket_helper_set_reuseaddr_invalid_sockfd(void) {
     TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, result);
 }
 
+void test_socket_helper_set_reuseport_invalid_sockfd(void) {
+    int result = socket_helper_set_reuseport(-1);
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, result);
+}
+
+void test_socket_helper_apply_profile_invalid_params(void) {
+    socket_options_t options = SOCKET_OPTIONS_INIT;
+    int sv[2];
+    TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM,
+                      socket_helper_apply_profile(-1, SOCKET_PROFILE_INTERACTIVE));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM,
+                      socket_helper_apply_profile(sv[0], SOCKET_PROFILE_COUNT));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_helper_apply_options(sv[0], NULL));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM,
+                      socket_helper_profile_options(SOCKET_PROFILE_COUNT, &options));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM,
+                      socket_helper_profile_options(SOCKET_PROFILE_BULK, NULL));
+
+    options.dscp = 64;
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_helper_apply_options(sv[0], &options));
+
+    close(sv[0]);
+    close(sv[1]);
+}
+
+void test_socket_helper_apply_profile_interactive_tcp(void) {
+    socket_options_t expected;
+    int port;
+    int listen_fd = listen_loopback(&port);
+    TEST_ASSERT_TRUE(listen_fd >= 0);
+
+    int fd = socket_helper_connect_tcp("127.0.0.1", port);
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_helper_profile_options(SOCKET_PROFILE_INTERACTIVE,
+                                                               &expected));
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_helper_apply_profile(fd, SOCKET_PROFILE_INTERACTIVE));
+
+    TEST_ASSERT_EQUAL(1, get_int_opt(fd, IPPROTO_TCP, TCP_NODELAY));
+    TEST_ASSERT_EQUAL(expected.user_timeout_ms, get_int_opt(fd, IPPROTO_TCP, TCP_USER_TIMEOUT));
+    TEST_ASSERT_EQUAL(1, get_int_opt(fd, SOL_SOCKET, SO_KEEPALIVE));
+    TEST_ASSERT_EQUAL(expected.keepalive_idle_s, get_int_opt(fd, IPPROTO_TCP, TCP_KEEPIDLE));
+    TEST_ASSERT_EQUAL(expected.keepalive_intvl_s, get_int_opt(fd, IPPROTO_TCP, TCP_KEEPINTVL));
+    TEST_ASSERT_EQUAL(expected.keepalive_cnt, get_int_opt(fd, IPPROTO_TCP, TCP_KEEPCNT));
+    TEST_ASSERT_EQUAL(expected.priority, get_int_opt(fd, SOL_SOCKET, SO_PRIORITY));
+    TEST_ASSERT_EQUAL(SOCKET_DSCP_EF << 2, get_int_opt(fd, IPPROTO_IP, IP_TOS) & 0xFC);
+
+    close(fd);
+    close(listen_fd);
+}
+
+void test_socket_helper_apply_options_partial(void) {
+    socket_options_t options = SOCKET_OPTIONS_INIT;
+    int port;
+    int listen_fd = listen_loopback(&port);
+    TEST_ASSERT_TRUE(listen_fd >= 0);
+
+    int fd = socket_helper_connect_tcp("127.0.0.1", port);
+    TEST_ASSERT_TRUE(fd >= 0);
+    int tos_before = get_int_opt(fd, IPPROTO_IP, IP_TOS);
+
+    // 只變更指定的欄位,kernel 會把緩衝區加倍
+    options.sndbuf = 65536;
+    options.nodelay = 1;
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_helper_apply_options(fd, &options));
+    TEST_ASSERT_TRUE(get_int_opt(fd, SOL_SOCKET, SO_SNDBUF) >= 65536);
+    TEST_ASSERT_EQUAL(1, get_int_opt(fd, IPPROTO_TCP, TCP_NODELAY));
+    TEST_ASSERT_EQUAL(0, get_int_opt(fd, SOL_SOCKET, SO_KEEPALIVE));
+    TEST_ASSERT_EQUAL(tos_before, get_int_opt(fd, IPPROTO_IP, IP_TOS));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_helper_set_nodelay(fd, false));
+    TEST_ASSERT_EQUAL(0, get_int_opt(fd, IPPROTO_TCP, TCP_NODELAY));
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_helper_set_quickack(fd, true));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_helper_set_nodelay(-1, true));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_helper_set_quickack(-1, true));
+
+    close(fd);
+    close(listen_fd);
+}
+
+void test_socket_helper_apply_profile_unix_skips_tcp_options(void) {
+    int sv[2];
+    TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+
+    // TCP / IP 選項不適用 Unix socket,只套用緩衝區與優先權
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_helper_apply_profile(sv[0], SOCKET_PROFILE_INTERACTIVE));
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_helper_apply_profile(sv[0], SOCKET_PROFILE_BULK));
+    TEST_ASSERT_TRUE(get_int_opt(sv[0], SOL_SOCKET, SO_SNDBUF) >= 262144);
+
+    close(sv[0]);
+    close(sv[1]);
+}
+
 // ========================================
 // Socket I/O 測試
 // ========================================
@@ -100,6 +319,46 @@ void test_socket_helper_recv_invalid_params(void) {
     TEST_ASSERT_LESS_THAN(0, ret3);
 }
 
+void test_socket_helper_send_all_recv_all(void) {
+    int sv[2];
+    char buffer[8];
+    TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_helper_send_all(-1, "x", 1, 100));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_helper_recv_all(sv[1], NULL, 1, 100));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_helper_send_all(sv[0], "abc", 3, 100));
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_helper_send_all(sv[0], "defg", 4, 100));
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_helper_recv_all(sv[1], buffer, 7, 100));
+    TEST_ASSERT_EQUAL_MEMORY("abcdefg", buffer, 7);
+
+    // 資料不足時逾時,對端關閉時回傳 IO 錯誤
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_helper_send_all(sv[0], "hi", 2, 100));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_TIMEOUT, socket_helper_recv_all(sv[1], buffer, 4, 20));
+    close(sv[0]);
+    TEST_ASSERT_EQUAL(GAMING_ERROR_IO, socket_helper_recv_all(sv[1], buffer, 4, 100));
+
+    close(sv[1]);
+}
+
+void test_socket_helper_set_timeout_ms(void) {
+    int sv[2];
+    struct timeval tv;
+    socklen_t len = sizeof(tv);
+    TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_helper_set_timeout_ms(-1, 100));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_helper_set_timeout_ms(sv[0], -1));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_helper_set_timeout_ms(sv[0], 1250));
+    TEST_ASSERT_EQUAL(0, getsockopt(sv[0], SOL_SOCKET, SO_RCVTIMEO, &tv, &len));
+    TEST_ASSERT_EQUAL(1, tv.tv_sec);
+    TEST_ASSERT_INT_WITHIN(10000, 250000, tv.tv_usec);
+
+    close(sv[0]);
+    close(sv[1]);
+}
+
 void test_socket_helper_close_invalid_sockfd(void) {
     // 應該不會 crash
     socket_helper_close(-1);
@@ -120,6 +379,42 @@ void test_socket_helper_is_writable_invalid_sockfd(void) {
     TEST_ASSERT_FALSE(writable);
 }
 
+void test_socket_helper_is_readable_socketpair(void) {
+    int sv[2];
+    TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+
+    TEST_ASSERT_FALSE(socket_helper_is_readable(sv[0], 0));
+    TEST_ASSERT_TRUE(socket_helper_is_writable(sv[0], 0));
+
+    TEST_ASSERT_EQUAL(1, write(sv[1], "x", 1));
+    TEST_ASSERT_TRUE(socket_helper_is_readable(sv[0], 100));
+
+    close(sv[0]);
+    close(sv[1]);
+}
+
+void test_socket_helper_is_readable_above_fd_setsize(void) {
+    struct rlimit rl;
+    int sv[2];
+    int high_fd = FD_SETSIZE + 16;
+
+    // select() 無法處理超過 FD_SETSIZE 的 fd
+    if (getrlimit(RLIMIT_NOFILE, &rl) != 0 || rl.rlim_cur <= (rlim_t)high_fd) {
+        TEST_IGNORE_MESSAGE("RLIMIT_NOFILE too low for fd above FD_SETSIZE");
+    }
+
+    TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+    TEST_ASSERT_EQUAL(high_fd, dup2(sv[0], high_fd));
+
+    TEST_ASSERT_FALSE(socket_helper_is_readable(high_fd, 0));
+    TEST_ASSERT_EQUAL(1, write(sv[1], "x", 1));
+    TEST_ASSERT_TRUE(socket_helper_is_readable(high_fd, 100));
+
+    close(high_fd);
+    close(sv[0]);
+    close(sv[1]);
+}
+
 // ========================================
 // 完整流程測試 (簡化版)
 // ========================================
@@ -130,3 +425,88 @@ void test_socket_helper_complete_flow(void) {
     
     TEST_PASS();
 }
+
+// ========================================
+// 效能測試
+// ========================================
+
+#define BENCH_ROUNDS    20
+
+typedef struct {
+    int listen_fd;
+    int profile;            // -1 表示不套用
+} echo_ctx_t;
+
+/**
+ * @brief 回應端: 收到 8 bytes 後以一次寫入回覆
+ */
+static void* echo_thread(void *arg) {
+    echo_ctx_t *ctx = arg;
+    char buffer[8];
+    int fd = accept(ctx->listen_fd, NULL, NULL);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (ctx->profile >= 0) {
+        socket_helper_apply_profile(fd, (socket_profile_t)ctx->profile);
+    }
+    while (socket_helper_recv_all(fd, buffer, sizeof(buffer), 2000) == GAMING_OK) {
+        if (socket_helper_send_all(fd, buffer, sizeof(buffer), 2000) != GAMING_OK) {
+            break;
+        }
+    }
+    close(fd);
+    return NULL;
+}
+
+/**
+ * @brief 量測一次請求的往返時間 (標頭與內容分兩次寫入,是 Nagle 加延遲 ACK 的典型情境)
+ * @return 平均往返時間(微秒)
+ */
+static long long bench_rtt(int profile) {
+    echo_ctx_t ctx = { .profile = profile };
+    int port;
+    pthread_t thread;
+    char buffer[8];
+
+    ctx.listen_fd = listen_loopback(&port);
+    TEST_ASSERT_TRUE(ctx.listen_fd >= 0);
+    pthread_create(&thread, NULL, echo_thread, &ctx);
+
+    int fd = socket_helper_connect_tcp_timeout("127.0.0.1", port, 1000);
+    TEST_ASSERT_TRUE(fd >= 0);
+    if (profile >= 0) {
+        socket_helper_apply_profile(fd, (socket_profile_t)profile);
+    }
+
+    // 暖身,讓連線離開 kernel 初始的快速 ACK 模式
+    for (int i = 0; i < 4; i++) {
+        socket_helper_send_all(fd, "hdr!body", 8, 1000);
+        socket_helper_recv_all(fd, buffer, sizeof(buffer), 1000);
+    }
+
+    long long start = now_us();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        socket_helper_send_all(fd, "hdr!", 4, 1000);
+        socket_helper_send_all(fd, "body", 4, 1000);
+        TEST_ASSERT_EQUAL(GAMING_OK, socket_helper_recv_all(fd, buffer, sizeof(buffer), 1000));
+    }
+    long long elapsed = now_us() - start;
+
+    close(fd);
+    pthread_join(thread, NULL);
+    close(ctx.listen_fd);
+    return elapsed / BENCH_ROUNDS;
+}
+
+void test_socket_helper_benchmark_loopback_rtt(void) {
+    char msg[128];
+
+    long long plain = bench_rtt(-1);
+    long long tuned = bench_rtt(SOCKET_PROFILE_INTERACTIVE);
+
+    snprintf(msg, sizeof(msg), "loopback write-write-read RTT: default %lld us, interactive %lld us",
+             plain, tuned);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(tuned < plain);
+}
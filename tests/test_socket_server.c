@@ -0,0 +1,478 @@
+/**
+ * @file test_socket_server.c
+ * @brief Socket Server 單元測試
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "unity.h"
+#include "socket_server.h"
+#include "socket_helper.h"
+#include "event_loop.h"
+#include "logger.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TEST_UNIX_PATH "/tmp/test_socket_server.sock"
+
+// ========================================
+// 測試輔助
+// ========================================
+
+static socket_server_t *server = NULL;
+
+typedef struct {
+    int accepts;
+    int closes;
+    int reject;                 // on_accept 回傳錯誤
+    int close_on_data;          // 收到資料後關閉連線
+    int send_result;            // 在 worker 中呼叫的結果 (worker 執行緒不能直接 assert)
+    int worker_hits[SOCKET_SERVER_MAX_WORKERS];
+} server_ctx_t;
+
+static server_ctx_t ctx;
+
+static int on_accept(socket_conn_t *conn, void *user_data) {
+    server_ctx_t *c = user_data;
+    __atomic_add_fetch(&c->accepts, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&c->worker_hits[socket_conn_worker(conn)], 1, __ATOMIC_RELAXED);
+    return c->reject ? GAMING_ERROR : GAMING_OK;
+}
+
+// 回傳收到的資料;"big" 則回傳大量資料測試暫存
+static void on_echo(socket_conn_t *conn, uint8_t *data, size_t len, void *user_data) {
+    server_ctx_t *c = user_data;
+
+    if (len == 2 && memcmp(data, "iv", 2) == 0) {
+        struct iovec iov[3] = {
+            { .iov_base = "sc", .iov_len = 2 },
+            { .iov_base = "at", .iov_len = 2 },
+            { .iov_base = "ter", .iov_len = 3 },
+        };
+        c->send_result = socket_conn_sendv(conn, iov, 3);
+        return;
+    }
+
+    if (len == 3 && memcmp(data, "big", 3) == 0) {
+        static uint8_t big[200 * 1024];
+        for (size_t i = 0; i < sizeof(big); i++) {
+            big[i] = (uint8_t)(i % 251);
+        }
+        c->send_result = socket_conn_send(conn, big, sizeof(big));
+        return;
+    }
+
+    socket_conn_send(conn, data, len);
+    if (c->close_on_data) {
+        socket_conn_close(conn);
+        // 關閉後送出應失敗且不會使用已釋放的連線
+        c->send_result = socket_conn_send(conn, "x", 1);
+    }
+}
+
+static void on_close(socket_conn_t *conn, void *user_data) {
+    server_ctx_t *c = user_data;
+    __atomic_add_fetch(&c->closes, 1, __ATOMIC_RELAXED);
+}
+
+static socket_server_config_t make_config(socket_type_t type, int workers) {
+    socket_server_config_t config = SOCKET_SERVER_CONFIG_INIT;
+    config.type = type;
+    config.path = TEST_UNIX_PATH;
+    config.bind_addr = "127.0.0.1";
+    config.port = 0;
+    config.workers = workers;
+    config.on_accept = on_accept;
+    config.on_data = on_echo;
+    config.on_close = on_close;
+    config.user_data = &ctx;
+    return config;
+}
+
+static void start_server(socket_type_t type, int workers) {
+    socket_server_config_t config = make_config(type, workers);
+    server = socket_server_create(&config);
+    TEST_ASSERT_NOT_NULL(server);
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_server_start(server));
+}
+
+static int connect_client(void) {
+    int fd = socket_helper_connect_tcp("127.0.0.1", socket_server_get_port(server));
+    TEST_ASSERT_TRUE(fd >= 0);
+    socket_helper_set_timeout(fd, 2);
+    return fd;
+}
+
+static void wait_for(const int *value, int expected) {
+    for (int i = 0; i < 200 && __atomic_load_n(value, __ATOMIC_RELAXED) < expected; i++) {
+        usleep(5000);
+    }
+}
+
+static void assert_echo(int fd, const char *msg) {
+    char buffer[64];
+    size_t len = strlen(msg);
+
+    TEST_ASSERT_EQUAL((ssize_t)len, socket_helper_send(fd, msg, len));
+    TEST_ASSERT_EQUAL((ssize_t)len, recv(fd, buffer, sizeof(buffer), MSG_WAITALL));
+    TEST_ASSERT_EQUAL_MEMORY(msg, buffer, len);
+}
+
+static long long now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void setUp(void) {
+    memset(&ctx, 0, sizeof(ctx));
+    server = NULL;
+}
+
+void tearDown(void) {
+    socket_server_destroy(server);
+    server = NULL;
+}
+
+// ========================================
+// 參數驗證測試
+// ========================================
+
+void test_socket_server_create_invalid_params(void) {
+    socket_server_config_t config = make_config(SOCKET_TYPE_TCP, 1);
+
+    TEST_ASSERT_NULL(socket_server_create(NULL));
+
+    config.on_data = NULL;
+    TEST_ASSERT_NULL(socket_server_create(&config));
+
+    config = make_config(SOCKET_TYPE_TCP, 0);
+    TEST_ASSERT_NULL(socket_server_create(&config));
+    config.workers = SOCKET_SERVER_MAX_WORKERS + 1;
+    TEST_ASSERT_NULL(socket_server_create(&config));
+
+    config = make_config(SOCKET_TYPE_TCP, 1);
+    config.port = 70000;
+    TEST_ASSERT_NULL(socket_server_create(&config));
+
+    config = make_config(SOCKET_TYPE_UNIX, 1);
+    config.path = NULL;
+    TEST_ASSERT_NULL(socket_server_create(&config));
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_server_start(NULL));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_server_get_port(NULL));
+    socket_server_stop(NULL);
+    socket_server_destroy(NULL);
+}
+
+void test_socket_server_conn_null_safe(void) {
+    TEST_ASSERT_EQUAL(-1, socket_conn_fd(NULL));
+    TEST_ASSERT_EQUAL(-1, socket_conn_worker(NULL));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_conn_send(NULL, "x", 1));
+    TEST_ASSERT_EQUAL(0, socket_conn_pending(NULL));
+    TEST_ASSERT_NULL(socket_conn_get_data(NULL));
+    socket_conn_close(NULL);
+}
+
+void test_socket_server_start_twice(void) {
+    start_server(SOCKET_TYPE_TCP, 1);
+    TEST_ASSERT_EQUAL(GAMING_ERROR_ALREADY_EXISTS, socket_server_start(server));
+}
+
+// ========================================
+// 連線測試
+// ========================================
+
+void test_socket_server_tcp_echo(void) {
+    socket_server_stats_t stats;
+    start_server(SOCKET_TYPE_TCP, 1);
+    TEST_ASSERT_TRUE(socket_server_get_port(server) > 0);
+
+    int fd = connect_client();
+    assert_echo(fd, "hello");
+    assert_echo(fd, "world");
+
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_server_get_stats(server, &stats));
+    TEST_ASSERT_EQUAL(1, stats.accepted);
+    TEST_ASSERT_EQUAL(1, stats.active);
+
+    close(fd);
+    wait_for(&ctx.closes, 1);
+    TEST_ASSERT_EQUAL(1, ctx.closes);
+
+    socket_server_get_stats(server, &stats);
+    TEST_ASSERT_EQUAL(0, stats.active);
+}
+
+void test_socket_server_unix_shared_listener(void) {
+    int fds[8];
+    start_server(SOCKET_TYPE_UNIX, 2);
+    TEST_ASSERT_EQUAL(0, access(TEST_UNIX_PATH, F_OK));
+
+    for (int i = 0; i < 8; i++) {
+        fds[i] = socket_helper_connect_unix(TEST_UNIX_PATH);
+        TEST_ASSERT_TRUE(fds[i] >= 0);
+        socket_helper_set_timeout(fds[i], 2);
+    }
+    for (int i = 0; i < 8; i++) {
+        assert_echo(fds[i], "ping");
+        close(fds[i]);
+    }
+    TEST_ASSERT_EQUAL(8, ctx.accepts);
+
+    socket_server_destroy(server);
+    server = NULL;
+    TEST_ASSERT_NOT_EQUAL(0, access(TEST_UNIX_PATH, F_OK));
+}
+
+void test_socket_server_reuseport_spreads_connections(void) {
+    int fds[64];
+    int used = 0;
+    start_server(SOCKET_TYPE_TCP, 4);
+
+    for (int i = 0; i < 64; i++) {
+        fds[i] = connect_client();
+    }
+    wait_for(&ctx.accepts, 64);
+    for (int i = 0; i < 64; i++) {
+        close(fds[i]);
+    }
+
+    // kernel 依四元組雜湊分配,64 個連線不會全部落在同一個 worker
+    for (int i = 0; i < 4; i++) {
+        if (ctx.worker_hits[i] > 0) {
+            used++;
+        }
+    }
+    TEST_ASSERT_EQUAL(64, ctx.accepts);
+    TEST_ASSERT_TRUE(used > 1);
+}
+
+void test_socket_server_accept_rejected(void) {
+    socket_server_stats_t stats;
+    char ch;
+    ctx.reject = 1;
+    start_server(SOCKET_TYPE_TCP, 1);
+
+    int fd = connect_client();
+    TEST_ASSERT_EQUAL(0, recv(fd, &ch, 1, 0));
+    close(fd);
+
+    socket_server_get_stats(server, &stats);
+    TEST_ASSERT_EQUAL(1, stats.rejected);
+    TEST_ASSERT_EQUAL(0, stats.active);
+    TEST_ASSERT_EQUAL(0, ctx.closes);
+}
+
+void test_socket_server_close_inside_callback(void) {
+    char buffer[16];
+    ctx.close_on_data = 1;
+    start_server(SOCKET_TYPE_TCP, 1);
+
+    int fd = connect_client();
+    TEST_ASSERT_EQUAL(3, socket_helper_send(fd, "bye", 3));
+    TEST_ASSERT_EQUAL(3, recv(fd, buffer, sizeof(buffer), MSG_WAITALL));
+    TEST_ASSERT_EQUAL(0, recv(fd, buffer, sizeof(buffer), 0));
+    close(fd);
+
+    wait_for(&ctx.closes, 1);
+    TEST_ASSERT_EQUAL(1, ctx.closes);
+    TEST_ASSERT_EQUAL(GAMING_ERROR_IO, ctx.send_result);
+}
+
+void test_socket_server_buffered_send_keeps_order(void) {
+    static uint8_t buffer[200 * 1024];
+    size_t total = 0;
+    start_server(SOCKET_TYPE_TCP, 1);
+
+    int fd = connect_client();
+    TEST_ASSERT_EQUAL(3, socket_helper_send(fd, "big", 3));
+
+    // 超過 socket 緩衝區的部分由伺服器暫存並在可寫時送出
+    usleep(20000);
+    while (total < sizeof(buffer)) {
+        ssize_t n = recv(fd, buffer + total, sizeof(buffer) - total, 0);
+        TEST_ASSERT_TRUE(n > 0);
+        total += (size_t)n;
+    }
+    for (size_t i = 0; i < sizeof(buffer); i++) {
+        if (buffer[i] != (uint8_t)(i % 251)) {
+            TEST_FAIL_MESSAGE("buffered data out of order");
+        }
+    }
+    TEST_ASSERT_EQUAL(GAMING_OK, ctx.send_result);
+    close(fd);
+}
+
+void test_socket_server_stop_closes_connections(void) {
+    socket_server_stats_t stats;
+    start_server(SOCKET_TYPE_TCP, 2);
+
+    int fd1 = connect_client();
+    int fd2 = connect_client();
+    assert_echo(fd1, "a");
+    assert_echo(fd2, "b");
+
+    socket_server_stop(server);
+    TEST_ASSERT_EQUAL(2, ctx.closes);
+    socket_server_get_stats(server, &stats);
+    TEST_ASSERT_EQUAL(0, stats.active);
+
+    // 可再次啟動
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_server_start(server));
+    int fd3 = connect_client();
+    assert_echo(fd3, "c");
+
+    close(fd1);
+    close(fd2);
+    close(fd3);
+}
+
+void test_socket_server_sendv(void) {
+    char buffer[16];
+    start_server(SOCKET_TYPE_TCP, 1);
+
+    int fd = connect_client();
+    TEST_ASSERT_EQUAL(2, socket_helper_send(fd, "iv", 2));
+    TEST_ASSERT_EQUAL(7, recv(fd, buffer, 7, MSG_WAITALL));
+    TEST_ASSERT_EQUAL_MEMORY("scatter", buffer, 7);
+    TEST_ASSERT_EQUAL(GAMING_OK, ctx.send_result);
+    close(fd);
+}
+
+typedef struct {
+    int runs;
+    int worker;
+    pthread_t thread;
+} post_ctx_t;
+
+static void on_task(socket_server_t *s, int worker, void *user_data) {
+    post_ctx_t *p = user_data;
+    p->runs++;
+    p->worker = worker;
+    p->thread = pthread_self();
+}
+
+void test_socket_server_post_runs_in_worker(void) {
+    post_ctx_t post = { 0 };
+
+    socket_server_config_t config = make_config(SOCKET_TYPE_TCP, 2);
+    server = socket_server_create(&config);
+    TEST_ASSERT_EQUAL(2, socket_server_worker_count(server));
+
+    // 未啟動時不接受工作
+    TEST_ASSERT_EQUAL(GAMING_ERROR_NOT_INITIALIZED, socket_server_post(server, 0, on_task, &post));
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_server_start(server));
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_server_post(server, 2, on_task, &post));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, socket_server_post(server, 0, NULL, &post));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_server_post(server, 1, on_task, &post));
+    wait_for(&post.runs, 1);
+    TEST_ASSERT_EQUAL(1, post.runs);
+    TEST_ASSERT_EQUAL(1, post.worker);
+    TEST_ASSERT_FALSE(pthread_equal(post.thread, pthread_self()));
+}
+
+void test_socket_server_post_pending_tasks_run_on_stop(void) {
+    post_ctx_t post = { 0 };
+    start_server(SOCKET_TYPE_TCP, 1);
+
+    for (int i = 0; i < 100; i++) {
+        TEST_ASSERT_EQUAL(GAMING_OK, socket_server_post(server, 0, on_task, &post));
+    }
+    socket_server_stop(server);
+
+    // 停止時尚未執行的工作在呼叫端完成,不會遺失
+    TEST_ASSERT_EQUAL(100, post.runs);
+    TEST_ASSERT_EQUAL(GAMING_ERROR_NOT_INITIALIZED, socket_server_post(server, 0, on_task, &post));
+}
+
+// ========================================
+// 效能測試 (loopback)
+// ========================================
+
+#define BENCH_CLIENTS       4
+#define BENCH_CONNECTIONS   500     ///< 每個 client 執行緒
+
+typedef struct {
+    int port;
+    long long latency_us[BENCH_CONNECTIONS];
+} bench_client_t;
+
+static void* bench_client(void *arg) {
+    bench_client_t *client = arg;
+    char ch;
+
+    for (int i = 0; i < BENCH_CONNECTIONS; i++) {
+        long long start = now_us();
+        int fd = socket_helper_connect_tcp("127.0.0.1", client->port);
+        if (fd < 0) {
+            client->latency_us[i] = -1;
+            continue;
+        }
+        if (send(fd, "x", 1, 0) != 1 || recv(fd, &ch, 1, 0) != 1) {
+            client->latency_us[i] = -1;
+        } else {
+            client->latency_us[i] = now_us() - start;
+        }
+        close(fd);
+    }
+    return NULL;
+}
+
+static int cmp_ll(const void *a, const void *b) {
+    long long x = *(const long long *)a;
+    long long y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+void test_socket_server_benchmark_workers(void) {
+    static bench_client_t clients[BENCH_CLIENTS];
+    static long long all[BENCH_CLIENTS * BENCH_CONNECTIONS];
+    pthread_t threads[BENCH_CLIENTS];
+    char msg[128];
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    for (int workers = 1; workers <= 4; workers *= 2) {
+        if (workers > 1 && workers > cpus) {
+            break;
+        }
+
+        memset(&ctx, 0, sizeof(ctx));
+        start_server(SOCKET_TYPE_TCP, workers);
+
+        long long start = now_us();
+        for (int i = 0; i < BENCH_CLIENTS; i++) {
+            clients[i].port = socket_server_get_port(server);
+            pthread_create(&threads[i], NULL, bench_client, &clients[i]);
+        }
+        for (int i = 0; i < BENCH_CLIENTS; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        long long elapsed = now_us() - start;
+
+        int n = 0;
+        for (int i = 0; i < BENCH_CLIENTS; i++) {
+            for (int j = 0; j < BENCH_CONNECTIONS; j++) {
+                if (clients[i].latency_us[j] >= 0) {
+                    all[n++] = clients[i].latency_us[j];
+                }
+            }
+        }
+        TEST_ASSERT_EQUAL(BENCH_CLIENTS * BENCH_CONNECTIONS, n);
+        qsort(all, (size_t)n, sizeof(all[0]), cmp_ll);
+
+        snprintf(msg, sizeof(msg), "workers=%d: %.0f conn/s, p50 %lld us, p99 %lld us",
+                 workers, n * 1e6 / (double)elapsed, all[n / 2], all[n * 99 / 100]);
+        TEST_MESSAGE(msg);
+
+        socket_server_destroy(server);
+        server = NULL;
+    }
+}
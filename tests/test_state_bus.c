@@ -0,0 +1,460 @@
+/**
+ * @file test_state_bus.c
+ * @brief State Bus 單元測試
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "unity.h"
+#include "state_bus.h"
+#include "socket_frame.h"
+#include "socket_helper.h"
+#include "event_loop.h"
+#include "logger.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TEST_BUS_PATH "/tmp/test_state_bus.sock"
+
+// ========================================
+// 測試輔助
+// ========================================
+
+static state_bus_t *bus = NULL;
+
+typedef struct {
+    int count;
+    int topic_hits[STATE_TOPIC_COUNT];
+    state_topic_t last_topic;
+    char last_data[64];
+    size_t last_len;
+    uint32_t last_seq;
+    bool in_order;
+} recv_ctx_t;
+
+static void on_message(state_topic_t topic, const uint8_t *data, size_t len, void *user_data) {
+    recv_ctx_t *c = user_data;
+
+    c->count++;
+    c->topic_hits[topic]++;
+    c->last_topic = topic;
+    c->last_len = len;
+    memcpy(c->last_data, data, len < sizeof(c->last_data) ? len : sizeof(c->last_data));
+
+    // 序號測試的訊息以 4 bytes 序號開頭
+    if (len >= 4) {
+        uint32_t seq;
+        memcpy(&seq, data, sizeof(seq));
+        if (c->count > 1 && seq <= c->last_seq) {
+            c->in_order = false;
+        }
+        c->last_seq = seq;
+    }
+}
+
+static state_bus_config_t make_config(void) {
+    state_bus_config_t config = STATE_BUS_CONFIG_INIT;
+    config.path = TEST_BUS_PATH;
+    return config;
+}
+
+static void start_bus(const state_bus_config_t *config) {
+    bus = state_bus_create(config);
+    TEST_ASSERT_NOT_NULL(bus);
+    TEST_ASSERT_EQUAL(GAMING_OK, state_bus_start(bus));
+}
+
+static state_bus_client_t* subscribe(uint32_t topics) {
+    state_bus_client_t *client = state_bus_client_connect(TEST_BUS_PATH, topics);
+    TEST_ASSERT_NOT_NULL(client);
+    return client;
+}
+
+/**
+ * @brief 讀取直到收到 expected 則訊息或逾時
+ */
+static void read_until(state_bus_client_t *client, recv_ctx_t *c, int expected) {
+    for (int i = 0; i < 200 && c->count < expected; i++) {
+        int ret = state_bus_client_read(client, on_message, c, 1000);
+        if (ret != GAMING_OK) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 讀取直到 broker 關閉連線
+ *
+ * @return 最後一次 read 的結果
+ */
+static int read_until_closed(state_bus_client_t *client, recv_ctx_t *c) {
+    int ret = GAMING_OK;
+    while (ret == GAMING_OK) {
+        ret = state_bus_client_read(client, on_message, c, 1000);
+    }
+    return ret;
+}
+
+static void wait_published(uint64_t expected) {
+    state_bus_stats_t stats;
+    for (int i = 0; i < 400; i++) {
+        state_bus_get_stats(bus, &stats);
+        if (stats.published >= expected) {
+            return;
+        }
+        usleep(5000);
+    }
+}
+
+static void wait_subscribers(uint32_t expected) {
+    state_bus_stats_t stats;
+    for (int i = 0; i < 400; i++) {
+        state_bus_get_stats(bus, &stats);
+        if (stats.subscribers == expected) {
+            return;
+        }
+        usleep(5000);
+    }
+}
+
+static void publish_seq(uint32_t seq, size_t len) {
+    static uint8_t payload[32 * 1024];
+    memcpy(payload, &seq, sizeof(seq));
+    TEST_ASSERT_EQUAL(GAMING_OK, state_bus_publish(bus, STATE_TOPIC_VPN, payload, len));
+}
+
+static long long now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void setUp(void) {
+    bus = NULL;
+}
+
+void tearDown(void) {
+    state_bus_destroy(bus);
+    bus = NULL;
+}
+
+// ========================================
+// 參數驗證測試
+// ========================================
+
+void test_state_bus_create_invalid_params(void) {
+    state_bus_config_t config = make_config();
+
+    TEST_ASSERT_NULL(state_bus_create(NULL));
+
+    config.path = NULL;
+    TEST_ASSERT_NULL(state_bus_create(&config));
+
+    config = make_config();
+    config.queue_len = STATE_TOPIC_COUNT;
+    TEST_ASSERT_NULL(state_bus_create(&config));
+
+    config = make_config();
+    config.max_payload = 0;
+    TEST_ASSERT_NULL(state_bus_create(&config));
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, state_bus_start(NULL));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, state_bus_publish(NULL, STATE_TOPIC_PS5, "x", 1));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, state_bus_get_stats(NULL, NULL));
+    state_bus_stop(NULL);
+    state_bus_destroy(NULL);
+}
+
+void test_state_bus_client_invalid_params(void) {
+    TEST_ASSERT_NULL(state_bus_client_connect(NULL, STATE_TOPIC_ALL));
+    TEST_ASSERT_NULL(state_bus_client_connect(TEST_BUS_PATH, 0x100));
+    TEST_ASSERT_NULL(state_bus_client_connect("/tmp/test_state_bus_missing.sock", STATE_TOPIC_ALL));
+
+    TEST_ASSERT_EQUAL(-1, state_bus_client_fd(NULL));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM,
+                      state_bus_client_publish(NULL, STATE_TOPIC_PS5, "x", 1, 100));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, state_bus_client_read(NULL, on_message, NULL, 0));
+    state_bus_client_close(NULL);
+}
+
+void test_state_bus_publish_validation(void) {
+    static uint8_t big[STATE_BUS_DEFAULT_MAX_PAYLOAD + 1];
+    state_bus_config_t config = make_config();
+    bus = state_bus_create(&config);
+    TEST_ASSERT_NOT_NULL(bus);
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_NOT_INITIALIZED, state_bus_publish(bus, STATE_TOPIC_PS5, "x", 1));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, state_bus_start(bus));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_ALREADY_EXISTS, state_bus_start(bus));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, state_bus_publish(bus, STATE_TOPIC_COUNT, "x", 1));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM,
+                      state_bus_publish(bus, STATE_TOPIC_PS5, big, sizeof(big)));
+    TEST_ASSERT_EQUAL(GAMING_OK, state_bus_publish(bus, STATE_TOPIC_PS5, NULL, 0));
+}
+
+// ========================================
+// 發布/訂閱測試
+// ========================================
+
+void test_state_bus_fanout_filters_topics(void) {
+    recv_ctx_t ps5 = {0};
+    recv_ctx_t vpn = {0};
+    recv_ctx_t all = {0};
+    state_bus_config_t config = make_config();
+    start_bus(&config);
+
+    state_bus_client_t *a = subscribe(STATE_TOPIC_MASK(STATE_TOPIC_PS5));
+    state_bus_client_t *b = subscribe(STATE_TOPIC_MASK(STATE_TOPIC_VPN));
+    state_bus_client_t *c = subscribe(STATE_TOPIC_ALL);
+
+    TEST_ASSERT_EQUAL(GAMING_OK, state_bus_publish(bus, STATE_TOPIC_PS5, "on", 2));
+    TEST_ASSERT_EQUAL(GAMING_OK, state_bus_publish(bus, STATE_TOPIC_VPN, "up", 2));
+
+    read_until(a, &ps5, 1);
+    read_until(b, &vpn, 1);
+    read_until(c, &all, 2);
+
+    TEST_ASSERT_EQUAL(1, ps5.count);
+    TEST_ASSERT_EQUAL(STATE_TOPIC_PS5, ps5.last_topic);
+    TEST_ASSERT_EQUAL_MEMORY("on", ps5.last_data, 2);
+    TEST_ASSERT_EQUAL(1, vpn.count);
+    TEST_ASSERT_EQUAL(STATE_TOPIC_VPN, vpn.last_topic);
+    TEST_ASSERT_EQUAL_MEMORY("up", vpn.last_data, 2);
+    TEST_ASSERT_EQUAL(2, all.count);
+
+    // 沒有其他訊息
+    TEST_ASSERT_EQUAL(GAMING_ERROR_TIMEOUT, state_bus_client_read(a, on_message, &ps5, 50));
+
+    state_bus_stats_t stats;
+    TEST_ASSERT_EQUAL(GAMING_OK, state_bus_get_stats(bus, &stats));
+    TEST_ASSERT_EQUAL(2, stats.published);
+    TEST_ASSERT_EQUAL(3 + 4, stats.delivered);     // 3 個訂閱確認 + 4 次投遞
+    TEST_ASSERT_EQUAL(3, stats.subscribers);
+
+    state_bus_client_close(a);
+    state_bus_client_close(b);
+    state_bus_client_close(c);
+    wait_subscribers(0);
+    TEST_ASSERT_EQUAL(GAMING_OK, state_bus_get_stats(bus, &stats));
+    TEST_ASSERT_EQUAL(0, stats.subscribers);
+}
+
+void test_state_bus_client_publish(void) {
+    recv_ctx_t rx = {0};
+    state_bus_config_t config = make_config();
+    start_bus(&config);
+
+    state_bus_client_t *sub = subscribe(STATE_TOPIC_MASK(STATE_TOPIC_BUTTON));
+    state_bus_client_t *pub = subscribe(0);
+
+    TEST_ASSERT_EQUAL(GAMING_OK, state_bus_client_publish(pub, STATE_TOPIC_BUTTON, "press", 5, 1000));
+    TEST_ASSERT_EQUAL(GAMING_OK, state_bus_client_publish(pub, STATE_TOPIC_LED, "red", 3, 1000));
+    TEST_ASSERT_EQUAL(GAMING_OK, state_bus_client_publish(pub, STATE_TOPIC_BUTTON, "release", 7, 1000));
+
+    read_until(sub, &rx, 2);
+    TEST_ASSERT_EQUAL(2, rx.count);
+    TEST_ASSERT_EQUAL(2, rx.topic_hits[STATE_TOPIC_BUTTON]);
+    TEST_ASSERT_EQUAL(7, rx.last_len);
+    TEST_ASSERT_EQUAL_MEMORY("release", rx.last_data, 7);
+
+    // 只發布的客戶端不會收到訊息
+    TEST_ASSERT_EQUAL(GAMING_ERROR_TIMEOUT, state_bus_client_read(pub, on_message, &rx, 50));
+
+    state_bus_client_close(sub);
+    state_bus_client_close(pub);
+}
+
+void test_state_bus_late_subscriber_gets_last_value(void) {
+    recv_ctx_t rx = {0};
+    state_bus_config_t config = make_config();
+    start_bus(&config);
+
+    TEST_ASSERT_EQUAL(GAMING_OK, state_bus_publish(bus, STATE_TOPIC_PS5, "standby", 7));
+    TEST_ASSERT_EQUAL(GAMING_OK, state_bus_publish(bus, STATE_TOPIC_PS5, "on", 2));
+    TEST_ASSERT_EQUAL(GAMING_OK, state_bus_publish(bus, STATE_TOPIC_LED, "blue", 4));
+    wait_published(3);
+
+    state_bus_client_t *client = subscribe(STATE_TOPIC_MASK(STATE_TOPIC_PS5));
+    read_until(client, &rx, 1);
+    TEST_ASSERT_EQUAL(1, rx.count);
+    TEST_ASSERT_EQUAL(STATE_TOPIC_PS5, rx.last_topic);
+    TEST_ASSERT_EQUAL_MEMORY("on", rx.last_data, 2);
+    TEST_ASSERT_EQUAL(GAMING_ERROR_TIMEOUT, state_bus_client_read(client, on_message, &rx, 50));
+
+    state_bus_client_close(client);
+}
+
+void test_state_bus_invalid_client_message_disconnects(void) {
+    uint8_t bad[2] = { 0x7f, 0 };
+    recv_ctx_t rx = {0};
+    state_bus_config_t config = make_config();
+    start_bus(&config);
+
+    state_bus_client_t *client = subscribe(STATE_TOPIC_ALL);
+    TEST_ASSERT_EQUAL(GAMING_OK, socket_frame_send(state_bus_client_fd(client), bad, sizeof(bad),
+                                                   0, 1000));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_IO, read_until_closed(client, &rx));
+    wait_subscribers(0);
+
+    state_bus_client_close(client);
+}
+
+void test_state_bus_stop_and_restart_keeps_last_value(void) {
+    recv_ctx_t rx = {0};
+    state_bus_config_t config = make_config();
+    start_bus(&config);
+
+    state_bus_client_t *client = subscribe(STATE_TOPIC_ALL);
+    TEST_ASSERT_EQUAL(GAMING_OK, state_bus_publish(bus, STATE_TOPIC_VPN, "up", 2));
+    state_bus_stop(bus);
+
+    // 停止前排入的訊息仍會送出,之後連線被關閉
+    TEST_ASSERT_EQUAL(GAMING_ERROR_IO, read_until_closed(client, &rx));
+    TEST_ASSERT_EQUAL(1, rx.count);
+    state_bus_client_close(client);
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_NOT_INITIALIZED, state_bus_publish(bus, STATE_TOPIC_VPN, "x", 1));
+    TEST_ASSERT_EQUAL(GAMING_OK, state_bus_start(bus));
+
+    memset(&rx, 0, sizeof(rx));
+    client = subscribe(STATE_TOPIC_MASK(STATE_TOPIC_VPN));
+    read_until(client, &rx, 1);
+    TEST_ASSERT_EQUAL(1, rx.count);
+    TEST_ASSERT_EQUAL_MEMORY("up", rx.last_data, 2);
+    state_bus_client_close(client);
+}
+
+// ========================================
+// 慢速訂閱者測試
+// ========================================
+
+// 足以塞滿 socket 緩衝區與佇列的訊息量
+#define SLOW_MESSAGES   64
+#define SLOW_SIZE       (32 * 1024)
+
+static state_bus_client_t* flood_slow_subscriber(state_bus_overflow_t overflow) {
+    state_bus_config_t config = make_config();
+    config.queue_len = 8;
+    config.overflow = overflow;
+    config.max_payload = SLOW_SIZE;
+    start_bus(&config);
+
+    state_bus_client_t *client = subscribe(STATE_TOPIC_MASK(STATE_TOPIC_VPN));
+    for (uint32_t seq = 1; seq <= SLOW_MESSAGES; seq++) {
+        publish_seq(seq, SLOW_SIZE);
+    }
+    wait_published(SLOW_MESSAGES);
+    return client;
+}
+
+void test_state_bus_slow_subscriber_drop_oldest(void) {
+    recv_ctx_t rx = { .in_order = true };
+    state_bus_stats_t stats;
+    state_bus_client_t *client = flood_slow_subscriber(STATE_BUS_DROP_OLDEST);
+
+    TEST_ASSERT_EQUAL(GAMING_OK, state_bus_get_stats(bus, &stats));
+    TEST_ASSERT_TRUE(stats.dropped > 0);
+    TEST_ASSERT_EQUAL(0, stats.disconnected);
+
+    // 收到的序號遞增,最後一則一定是最新的
+    while (rx.last_seq != SLOW_MESSAGES &&
+           state_bus_client_read(client, on_message, &rx, 1000) == GAMING_OK) {
+    }
+    TEST_ASSERT_TRUE(rx.in_order);
+    TEST_ASSERT_EQUAL(SLOW_MESSAGES, rx.last_seq);
+    TEST_ASSERT_EQUAL(SLOW_MESSAGES - (int)stats.dropped, rx.count);
+
+    state_bus_client_close(client);
+}
+
+void test_state_bus_slow_subscriber_drop_newest(void) {
+    recv_ctx_t rx = { .in_order = true };
+    state_bus_stats_t stats;
+    state_bus_client_t *client = flood_slow_subscriber(STATE_BUS_DROP_NEWEST);
+
+    TEST_ASSERT_EQUAL(GAMING_OK, state_bus_get_stats(bus, &stats));
+    TEST_ASSERT_TRUE(stats.dropped > 0);
+
+    read_until(client, &rx, SLOW_MESSAGES - (int)stats.dropped);
+    TEST_ASSERT_TRUE(rx.in_order);
+    TEST_ASSERT_EQUAL(SLOW_MESSAGES - (int)stats.dropped, rx.count);
+    TEST_ASSERT_EQUAL(GAMING_ERROR_TIMEOUT, state_bus_client_read(client, on_message, &rx, 50));
+
+    state_bus_client_close(client);
+}
+
+void test_state_bus_slow_subscriber_disconnect(void) {
+    recv_ctx_t rx = { .in_order = true };
+    state_bus_stats_t stats;
+    state_bus_client_t *client = flood_slow_subscriber(STATE_BUS_DISCONNECT);
+
+    TEST_ASSERT_EQUAL(GAMING_OK, state_bus_get_stats(bus, &stats));
+    TEST_ASSERT_EQUAL(1, stats.disconnected);
+    TEST_ASSERT_EQUAL(0, stats.subscribers);
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_IO, read_until_closed(client, &rx));
+    TEST_ASSERT_TRUE(rx.count < SLOW_MESSAGES);
+    state_bus_client_close(client);
+}
+
+// ========================================
+// 效能測試
+// ========================================
+
+#define BENCH_MAX_SUBSCRIBERS   100
+#define BENCH_ROUNDS            200
+
+static int cmp_ll(const void *a, const void *b) {
+    long long x = *(const long long *)a;
+    long long y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+void test_state_bus_benchmark_fanout(void) {
+    static const int counts[] = { 1, 10, 100 };
+    static state_bus_client_t *clients[BENCH_MAX_SUBSCRIBERS];
+    static long long latency[BENCH_ROUNDS];
+    const char payload[] = "{\"ps5\":\"on\",\"vpn\":\"up\"}";
+    char msg[128];
+
+    state_bus_config_t config = make_config();
+    start_bus(&config);
+
+    for (size_t k = 0; k < ARRAY_SIZE(counts); k++) {
+        int n = counts[k];
+        for (int i = 0; i < n; i++) {
+            clients[i] = subscribe(STATE_TOPIC_MASK(STATE_TOPIC_PS5));
+            // 丟掉訂閱時補送的最新值
+            while (state_bus_client_read(clients[i], NULL, NULL, 20) == GAMING_OK) {
+            }
+        }
+
+        // 發布到最後一個訂閱者收到為止
+        for (int r = 0; r < BENCH_ROUNDS; r++) {
+            recv_ctx_t rx = {0};
+            long long start = now_us();
+            TEST_ASSERT_EQUAL(GAMING_OK, state_bus_publish(bus, STATE_TOPIC_PS5,
+                                                           payload, sizeof(payload)));
+            for (int i = 0; i < n; i++) {
+                read_until(clients[i], &rx, i + 1);
+            }
+            latency[r] = now_us() - start;
+            TEST_ASSERT_EQUAL(n, rx.count);
+        }
+        qsort(latency, BENCH_ROUNDS, sizeof(latency[0]), cmp_ll);
+
+        snprintf(msg, sizeof(msg), "fan-out to %d subscribers: p50 %lld us, p99 %lld us",
+                 n, latency[BENCH_ROUNDS / 2], latency[BENCH_ROUNDS * 99 / 100]);
+        TEST_MESSAGE(msg);
+
+        for (int i = 0; i < n; i++) {
+            state_bus_client_close(clients[i]);
+        }
+        wait_subscribers(0);
+    }
+}
@@ -0,0 +1,322 @@
+/**
+ * @file test_status_shm.c
+ * @brief Status SHM 單元測試
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "unity.h"
+#include "status_shm.h"
+#include "logger.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+// ========================================
+// 測試輔助
+// ========================================
+
+#define TEST_STATUS_PATH  "/tmp/test_status_shm.status"
+
+static status_shm_reader_t *reader = NULL;
+
+static void open_reader(void) {
+    reader = status_shm_reader_open(TEST_STATUS_PATH);
+    TEST_ASSERT_NOT_NULL(reader);
+}
+
+static void read_status(status_shm_data_t *status) {
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_read(reader, status));
+}
+
+static long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void setUp(void) {
+    unlink(TEST_STATUS_PATH);
+    reader = NULL;
+}
+
+void tearDown(void) {
+    status_shm_reader_close(reader);
+    reader = NULL;
+    status_shm_close();
+    unlink(TEST_STATUS_PATH);
+}
+
+// ========================================
+// 開啟/關閉測試
+// ========================================
+
+void test_status_shm_open_close(void) {
+    struct stat st;
+
+    TEST_ASSERT_FALSE(status_shm_is_open());
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_open(TEST_STATUS_PATH));
+    TEST_ASSERT_TRUE(status_shm_is_open());
+    TEST_ASSERT_EQUAL(GAMING_ERROR_ALREADY_EXISTS, status_shm_open(TEST_STATUS_PATH));
+
+    status_shm_close();
+    TEST_ASSERT_FALSE(status_shm_is_open());
+    TEST_ASSERT_EQUAL(0, stat(TEST_STATUS_PATH, &st));
+}
+
+void test_status_shm_not_open(void) {
+    TEST_ASSERT_NULL(status_shm_write_begin());
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, status_shm_write_end());
+    TEST_ASSERT_EQUAL(GAMING_ERROR_NOT_INITIALIZED, status_shm_set_ps5_state(PS5_STATE_ON));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_NOT_INITIALIZED, status_shm_set_led(LED_COLOR_RED));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_NOT_INITIALIZED,
+                      status_shm_add_counter(STATUS_COUNTER_ERRORS, 1));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM,
+                      status_shm_add_counter(STATUS_COUNTER_COUNT, 1));
+}
+
+void test_status_shm_reader_invalid(void) {
+    status_shm_data_t status;
+
+    TEST_ASSERT_NULL(status_shm_reader_open(TEST_STATUS_PATH));
+
+    // 格式不符的檔案
+    int fd = open(TEST_STATUS_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL(5, write(fd, "hello", 5));
+    close(fd);
+    TEST_ASSERT_NULL(status_shm_reader_open(TEST_STATUS_PATH));
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, status_shm_read(NULL, &status));
+    TEST_ASSERT_EQUAL(0, status_shm_sequence(NULL));
+    status_shm_reader_close(NULL);
+}
+
+// ========================================
+// 讀寫測試
+// ========================================
+
+void test_status_shm_set_and_read(void) {
+    status_shm_data_t status;
+
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_open(TEST_STATUS_PATH));
+    open_reader();
+
+    read_status(&status);
+    TEST_ASSERT_EQUAL(PS5_STATE_UNKNOWN, status.ps5_state);
+    TEST_ASSERT_TRUE(status.updated_ms > 0);
+
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_set_device_type(DEVICE_TYPE_SERVER));
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_set_ps5_state(PS5_STATE_STANDBY));
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_set_vpn_state(VPN_STATE_CONNECTED));
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_set_led(LED_COLOR_ORANGE));
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_add_counter(STATUS_COUNTER_BUTTON_PRESSES, 2));
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_add_counter(STATUS_COUNTER_BUTTON_PRESSES, 3));
+
+    read_status(&status);
+    TEST_ASSERT_EQUAL(DEVICE_TYPE_SERVER, status.device_type);
+    TEST_ASSERT_EQUAL(PS5_STATE_STANDBY, status.ps5_state);
+    TEST_ASSERT_EQUAL(VPN_STATE_CONNECTED, status.vpn_state);
+    TEST_ASSERT_EQUAL(255, status.led.r);
+    TEST_ASSERT_EQUAL(165, status.led.g);
+    TEST_ASSERT_EQUAL(0, status.led.b);
+    TEST_ASSERT_EQUAL(5, status.counters[STATUS_COUNTER_BUTTON_PRESSES]);
+    TEST_ASSERT_EQUAL(0, status.counters[STATUS_COUNTER_ERRORS]);
+}
+
+void test_status_shm_batch_update(void) {
+    status_shm_data_t status;
+
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_open(TEST_STATUS_PATH));
+    open_reader();
+    uint32_t seq = status_shm_sequence(reader);
+
+    status_shm_data_t *data = status_shm_write_begin();
+    TEST_ASSERT_NOT_NULL(data);
+    data->ps5_state = PS5_STATE_ON;
+    data->led = LED_COLOR_GREEN;
+    data->counters[STATUS_COUNTER_PS5_WAKEUPS]++;
+
+    // 更新中讀取端不會採用半套內容
+    TEST_ASSERT_EQUAL(seq + 1, status_shm_sequence(reader));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_TIMEOUT, status_shm_read(reader, &status));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_write_end());
+    TEST_ASSERT_EQUAL(seq + 2, status_shm_sequence(reader));
+    // 沒有對應的 write_begin
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, status_shm_write_end());
+    read_status(&status);
+    TEST_ASSERT_EQUAL(PS5_STATE_ON, status.ps5_state);
+    TEST_ASSERT_EQUAL(255, status.led.g);
+    TEST_ASSERT_EQUAL(1, status.counters[STATUS_COUNTER_PS5_WAKEUPS]);
+}
+
+void test_status_shm_unchanged_value_keeps_sequence(void) {
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_open(TEST_STATUS_PATH));
+    open_reader();
+
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_set_vpn_state(VPN_STATE_CONNECTING));
+    uint32_t seq = status_shm_sequence(reader);
+    TEST_ASSERT_EQUAL(0, seq & 1);
+
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_set_vpn_state(VPN_STATE_CONNECTING));
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_set_led(LED_COLOR_BLACK));
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_add_counter(STATUS_COUNTER_ERRORS, 0));
+    TEST_ASSERT_EQUAL(seq, status_shm_sequence(reader));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_set_vpn_state(VPN_STATE_CONNECTED));
+    TEST_ASSERT_EQUAL(seq + 2, status_shm_sequence(reader));
+}
+
+void test_status_shm_reopen_resets_for_existing_reader(void) {
+    status_shm_data_t status;
+
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_open(TEST_STATUS_PATH));
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_set_ps5_state(PS5_STATE_ON));
+    open_reader();
+    status_shm_close();
+
+    // daemon 結束後讀取端仍可讀到最後的狀態
+    read_status(&status);
+    TEST_ASSERT_EQUAL(PS5_STATE_ON, status.ps5_state);
+
+    // 重新啟動沿用同一個檔案,舊的讀取端看到重設後的內容
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_open(TEST_STATUS_PATH));
+    read_status(&status);
+    TEST_ASSERT_EQUAL(PS5_STATE_UNKNOWN, status.ps5_state);
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_set_ps5_state(PS5_STATE_OFF));
+    read_status(&status);
+    TEST_ASSERT_EQUAL(PS5_STATE_OFF, status.ps5_state);
+}
+
+void test_status_shm_reopen_recovers_interrupted_update(void) {
+    status_shm_data_t status;
+
+    // 模擬 daemon 在更新中當掉: 序號停在奇數
+    pid_t pid = fork();
+    TEST_ASSERT_TRUE(pid >= 0);
+    if (pid == 0) {
+        if (status_shm_open(TEST_STATUS_PATH) == GAMING_OK) {
+            status_shm_write_begin()->ps5_state = PS5_STATE_ON;
+        }
+        _exit(0);
+    }
+    waitpid(pid, NULL, 0);
+
+    open_reader();
+    TEST_ASSERT_EQUAL(1, status_shm_sequence(reader) & 1);
+    TEST_ASSERT_EQUAL(GAMING_ERROR_TIMEOUT, status_shm_read(reader, &status));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_open(TEST_STATUS_PATH));
+    TEST_ASSERT_EQUAL(0, status_shm_sequence(reader) & 1);
+    read_status(&status);
+    TEST_ASSERT_EQUAL(PS5_STATE_UNKNOWN, status.ps5_state);
+}
+
+void test_status_shm_replaces_incompatible_file(void) {
+    int fd = open(TEST_STATUS_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL(5, write(fd, "stale", 5));
+    close(fd);
+
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_open(TEST_STATUS_PATH));
+    open_reader();
+}
+
+// ========================================
+// 並行測試
+// ========================================
+
+#define STRESS_UPDATES  200000
+
+static volatile int stress_done;
+
+// 每次更新把所有計數器設為同一個值,讀取端檢查是否一致
+static void* stress_writer(void *arg) {
+    for (uint64_t i = 1; i <= STRESS_UPDATES; i++) {
+        status_shm_data_t *data = status_shm_write_begin();
+        for (int c = 0; c < STATUS_COUNTER_COUNT; c++) {
+            data->counters[c] = i;
+        }
+        data->ps5_state = (uint32_t)i;
+        status_shm_write_end();
+    }
+    __atomic_store_n(&stress_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+void test_status_shm_concurrent_reads_are_consistent(void) {
+    status_shm_data_t status;
+    pthread_t thread;
+    int torn = 0;
+    int reads = 0;
+
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_open(TEST_STATUS_PATH));
+    open_reader();
+
+    stress_done = 0;
+    pthread_create(&thread, NULL, stress_writer, NULL);
+    while (!__atomic_load_n(&stress_done, __ATOMIC_ACQUIRE)) {
+        if (status_shm_read(reader, &status) != GAMING_OK) {
+            continue;
+        }
+        reads++;
+        for (int c = 0; c < STATUS_COUNTER_COUNT; c++) {
+            if (status.counters[c] != status.ps5_state) {
+                torn++;
+            }
+        }
+    }
+    pthread_join(thread, NULL);
+
+    TEST_ASSERT_EQUAL(0, torn);
+    TEST_ASSERT_TRUE(reads > 0);
+    read_status(&status);
+    TEST_ASSERT_EQUAL(STRESS_UPDATES, status.counters[0]);
+}
+
+// ========================================
+// 效能測試
+// ========================================
+
+#define BENCH_READS     1000000
+#define BENCH_QUERIES   20000
+
+void test_status_shm_benchmark_read(void) {
+    status_shm_data_t status;
+    int sv[2];
+    char msg[128];
+
+    TEST_ASSERT_EQUAL(GAMING_OK, status_shm_open(TEST_STATUS_PATH));
+    open_reader();
+
+    long long start = now_ns();
+    for (int i = 0; i < BENCH_READS; i++) {
+        status_shm_read(reader, &status);
+    }
+    double shm_ns = (double)(now_ns() - start) / BENCH_READS;
+
+    // 對照: 以 socketpair 一問一答 (同一執行緒,不含排程延遲)
+    TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+    start = now_ns();
+    for (int i = 0; i < BENCH_QUERIES; i++) {
+        char query = 's';
+        TEST_ASSERT_EQUAL(1, write(sv[0], &query, 1));
+        TEST_ASSERT_EQUAL(1, read(sv[1], &query, 1));
+        TEST_ASSERT_EQUAL((ssize_t)sizeof(status), write(sv[1], &status, sizeof(status)));
+        TEST_ASSERT_EQUAL((ssize_t)sizeof(status), read(sv[0], &status, sizeof(status)));
+    }
+    double socket_ns = (double)(now_ns() - start) / BENCH_QUERIES;
+    close(sv[0]);
+    close(sv[1]);
+
+    snprintf(msg, sizeof(msg), "status read: shm %.1f ns, socket query %.0f ns", shm_ns, socket_ns);
+    TEST_MESSAGE(msg);
+}
@@ -0,0 +1,779 @@
+/**
+ * @file test_websocket_server.c
+ * @brief WebSocket Server 單元測試
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "unity.h"
+#include "websocket_server.h"
+#include "socket_server.h"
+#include "socket_helper.h"
+#include "event_loop.h"
+#include "logger.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// RFC 6455 1.3 的範例
+#define TEST_KEY        "dGhlIHNhbXBsZSBub25jZQ=="
+#define TEST_ACCEPT     "s3pPLMBiTxaQ9kYGzzhZRbK+xOo="
+
+// ========================================
+// 測試輔助
+// ========================================
+
+static websocket_server_t *server = NULL;
+
+typedef struct {
+    int opens;
+    int messages;
+    int closes;
+    int last_opcode;
+    size_t last_len;
+} ws_ctx_t;
+
+static ws_ctx_t ctx;
+
+static void on_open(websocket_client_t *client, void *user_data) {
+    ws_ctx_t *c = user_data;
+    __atomic_add_fetch(&c->opens, 1, __ATOMIC_RELAXED);
+}
+
+// 回傳收到的訊息;"bye" 則由伺服器關閉
+static void on_message(websocket_client_t *client, int opcode, const uint8_t *data,
+                       size_t len, void *user_data) {
+    ws_ctx_t *c = user_data;
+
+    c->last_opcode = opcode;
+    c->last_len = len;
+    __atomic_add_fetch(&c->messages, 1, __ATOMIC_RELAXED);
+
+    if (len == 3 && memcmp(data, "bye", 3) == 0) {
+        websocket_close(client, WEBSOCKET_CLOSE_GOING_AWAY);
+        return;
+    }
+    websocket_send(client, opcode, data, len);
+}
+
+static void on_close(websocket_client_t *client, void *user_data) {
+    ws_ctx_t *c = user_data;
+    __atomic_add_fetch(&c->closes, 1, __ATOMIC_RELAXED);
+}
+
+static websocket_config_t make_config(void) {
+    websocket_config_t config = WEBSOCKET_CONFIG_INIT;
+    config.bind_addr = "127.0.0.1";
+    config.port = 0;
+    config.on_open = on_open;
+    config.on_message = on_message;
+    config.on_close = on_close;
+    config.user_data = &ctx;
+    return config;
+}
+
+static void start_server(const websocket_config_t *config) {
+    server = websocket_server_create(config);
+    TEST_ASSERT_NOT_NULL(server);
+    TEST_ASSERT_EQUAL(GAMING_OK, websocket_server_start(server));
+}
+
+static void wait_for(const int *value, int expected) {
+    for (int i = 0; i < 200 && __atomic_load_n(value, __ATOMIC_RELAXED) < expected; i++) {
+        usleep(5000);
+    }
+}
+
+static int connect_raw(void) {
+    int fd = socket_helper_connect_tcp("127.0.0.1", websocket_server_get_port(server));
+    TEST_ASSERT_TRUE(fd >= 0);
+    socket_helper_set_timeout(fd, 2);
+    return fd;
+}
+
+/**
+ * @brief 讀取 HTTP 回應標頭 (逐 byte,避免讀走之後的 frame)
+ */
+static void read_response(int fd, char *buffer, size_t size) {
+    size_t len = 0;
+
+    while (len + 1 < size) {
+        TEST_ASSERT_EQUAL(1, recv(fd, buffer + len, 1, 0));
+        len++;
+        buffer[len] = '\0';
+        if (len >= 4 && strcmp(buffer + len - 4, "\r\n\r\n") == 0) {
+            return;
+        }
+    }
+    TEST_FAIL_MESSAGE("response too long");
+}
+
+static void send_request(int fd, const char *path) {
+    char request[256];
+    int n = snprintf(request, sizeof(request),
+                     "GET %s HTTP/1.1\r\n"
+                     "Host: 127.0.0.1\r\n"
+                     "upgrade: WebSocket\r\n"
+                     "Connection: keep-alive, Upgrade\r\n"
+                     "Sec-WebSocket-Key: " TEST_KEY "\r\n"
+                     "Sec-WebSocket-Version: 13\r\n\r\n", path);
+    TEST_ASSERT_EQUAL(n, socket_helper_send(fd, request, (size_t)n));
+}
+
+static int connect_client(void) {
+    char response[512];
+    int fd = connect_raw();
+
+    send_request(fd, "/gaming?client=app");
+    read_response(fd, response, sizeof(response));
+    TEST_ASSERT_NOT_NULL(strstr(response, "HTTP/1.1 101 "));
+    TEST_ASSERT_NOT_NULL(strstr(response, "Sec-WebSocket-Accept: " TEST_ACCEPT "\r\n"));
+    return fd;
+}
+
+/**
+ * @brief 編碼客戶端 frame (加遮罩)
+ */
+static size_t encode_client_frame(uint8_t *out, int opcode, bool fin,
+                                  const void *data, size_t len) {
+    static const uint8_t key[4] = { 0x12, 0x34, 0x56, 0x78 };
+    size_t n = websocket_encode_header(out, opcode, fin, len);
+
+    out[1] |= 0x80;
+    memcpy(out + n, key, 4);
+    n += 4;
+    memcpy(out + n, data, len);
+    websocket_mask(out + n, len, key, 0);
+    return n + len;
+}
+
+static void send_frame(int fd, int opcode, bool fin, const void *data, size_t len) {
+    static uint8_t frame[70000];
+    size_t n = encode_client_frame(frame, opcode, fin, data, len);
+    TEST_ASSERT_EQUAL((ssize_t)n, socket_helper_send(fd, frame, n));
+}
+
+/**
+ * @brief 接收伺服器 frame
+ *
+ * @return payload 長度
+ */
+static size_t recv_frame(int fd, int *opcode, uint8_t *buffer, size_t size) {
+    uint8_t header[10];
+
+    TEST_ASSERT_EQUAL(2, recv(fd, header, 2, MSG_WAITALL));
+    TEST_ASSERT_EQUAL(0, header[1] & 0x80);     // 伺服器不加遮罩
+    *opcode = header[0] & 0x0f;
+
+    size_t len = header[1] & 0x7f;
+    if (len == 126) {
+        TEST_ASSERT_EQUAL(2, recv(fd, header + 2, 2, MSG_WAITALL));
+        len = ((size_t)header[2] << 8) | header[3];
+    } else if (len == 127) {
+        TEST_ASSERT_EQUAL(8, recv(fd, header + 2, 8, MSG_WAITALL));
+        len = 0;
+        for (int i = 0; i < 8; i++) {
+            len = (len << 8) | header[2 + i];
+        }
+    }
+
+    TEST_ASSERT_TRUE(len <= size);
+    if (len > 0) {
+        TEST_ASSERT_EQUAL((ssize_t)len, recv(fd, buffer, len, MSG_WAITALL));
+    }
+    return len;
+}
+
+static void assert_close_code(int fd, uint16_t code) {
+    uint8_t payload[125];
+    int opcode = 0;
+
+    size_t len = recv_frame(fd, &opcode, payload, sizeof(payload));
+    TEST_ASSERT_EQUAL(WEBSOCKET_OPCODE_CLOSE, opcode);
+    TEST_ASSERT_TRUE(len >= 2);
+    TEST_ASSERT_EQUAL(code, (payload[0] << 8) | payload[1]);
+    TEST_ASSERT_EQUAL(0, recv(fd, payload, 1, 0));
+}
+
+static long long now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void setUp(void) {
+    memset(&ctx, 0, sizeof(ctx));
+    server = NULL;
+}
+
+void tearDown(void) {
+    websocket_server_destroy(server);
+    server = NULL;
+}
+
+// ========================================
+// 協定輔助函數測試
+// ========================================
+
+void test_websocket_accept_key_rfc_example(void) {
+    char accept[WEBSOCKET_ACCEPT_KEY_SIZE];
+
+    TEST_ASSERT_EQUAL(GAMING_OK, websocket_accept_key(TEST_KEY, accept));
+    TEST_ASSERT_EQUAL_STRING(TEST_ACCEPT, accept);
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, websocket_accept_key(NULL, accept));
+}
+
+void test_websocket_mask_round_trip(void) {
+    static const uint8_t key[4] = { 0xde, 0xad, 0xbe, 0xef };
+    uint8_t original[67];
+    uint8_t buffer[68];
+
+    for (size_t i = 0; i < sizeof(original); i++) {
+        original[i] = (uint8_t)(i * 7);
+    }
+
+    // 以非對齊的起點測試逐 byte 與 64 位元路徑
+    uint8_t *data = buffer + 1;
+    memcpy(data, original, sizeof(original));
+    websocket_mask(data, sizeof(original), key, 0);
+    for (size_t i = 0; i < sizeof(original); i++) {
+        TEST_ASSERT_EQUAL_HEX8(original[i] ^ key[i & 3], data[i]);
+    }
+
+    websocket_mask(data, sizeof(original), key, 0);
+    TEST_ASSERT_EQUAL_MEMORY(original, data, sizeof(original));
+}
+
+void test_websocket_mask_offset_continues_phase(void) {
+    static const uint8_t key[4] = { 1, 2, 3, 4 };
+    uint8_t whole[40];
+    uint8_t split[40];
+
+    memset(whole, 0xaa, sizeof(whole));
+    memset(split, 0xaa, sizeof(split));
+
+    websocket_mask(whole, sizeof(whole), key, 0);
+    websocket_mask(split, 13, key, 0);
+    websocket_mask(split + 13, sizeof(split) - 13, key, 13);
+    TEST_ASSERT_EQUAL_MEMORY(whole, split, sizeof(whole));
+}
+
+void test_websocket_encode_header_lengths(void) {
+    uint8_t header[10];
+
+    TEST_ASSERT_EQUAL(2, websocket_encode_header(header, WEBSOCKET_OPCODE_TEXT, true, 125));
+    TEST_ASSERT_EQUAL_HEX8(0x81, header[0]);
+    TEST_ASSERT_EQUAL(125, header[1]);
+
+    TEST_ASSERT_EQUAL(4, websocket_encode_header(header, WEBSOCKET_OPCODE_BINARY, false, 300));
+    TEST_ASSERT_EQUAL_HEX8(0x02, header[0]);
+    TEST_ASSERT_EQUAL(126, header[1]);
+    TEST_ASSERT_EQUAL(300, (header[2] << 8) | header[3]);
+
+    TEST_ASSERT_EQUAL(10, websocket_encode_header(header, WEBSOCKET_OPCODE_BINARY, true, 70000));
+    TEST_ASSERT_EQUAL(127, header[1]);
+    TEST_ASSERT_EQUAL(70000, (header[7] << 16) | (header[8] << 8) | header[9]);
+}
+
+// ========================================
+// 參數驗證測試
+// ========================================
+
+void test_websocket_server_create_invalid_params(void) {
+    websocket_config_t config = make_config();
+
+    TEST_ASSERT_NULL(websocket_server_create(NULL));
+
+    config.path = "gaming";
+    TEST_ASSERT_NULL(websocket_server_create(&config));
+
+    config = make_config();
+    config.max_clients = 0;
+    TEST_ASSERT_NULL(websocket_server_create(&config));
+
+    config = make_config();
+    config.max_message = 0;
+    TEST_ASSERT_NULL(websocket_server_create(&config));
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, websocket_server_start(NULL));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, websocket_server_broadcast(NULL, 1, "x", 1));
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM, websocket_send(NULL, 1, "x", 1));
+    TEST_ASSERT_NULL(websocket_client_get_data(NULL));
+    websocket_close(NULL, WEBSOCKET_CLOSE_NORMAL);
+    websocket_server_stop(NULL);
+    websocket_server_destroy(NULL);
+}
+
+// ========================================
+// 握手測試
+// ========================================
+
+void test_websocket_server_handshake(void) {
+    websocket_config_t config = make_config();
+    start_server(&config);
+
+    int fd = connect_client();
+    wait_for(&ctx.opens, 1);
+    TEST_ASSERT_EQUAL(1, ctx.opens);
+    TEST_ASSERT_EQUAL(1, websocket_server_client_count(server));
+
+    close(fd);
+    wait_for(&ctx.closes, 1);
+    TEST_ASSERT_EQUAL(1, ctx.closes);
+    TEST_ASSERT_EQUAL(0, websocket_server_client_count(server));
+}
+
+void test_websocket_server_handshake_wrong_path(void) {
+    char response[512];
+    websocket_config_t config = make_config();
+    start_server(&config);
+
+    int fd = connect_raw();
+    send_request(fd, "/other");
+    read_response(fd, response, sizeof(response));
+    TEST_ASSERT_NOT_NULL(strstr(response, "HTTP/1.1 404 "));
+    TEST_ASSERT_EQUAL(0, recv(fd, response, 1, 0));
+    close(fd);
+
+    TEST_ASSERT_EQUAL(0, ctx.opens);
+    TEST_ASSERT_EQUAL(0, ctx.closes);
+}
+
+void test_websocket_server_handshake_missing_key(void) {
+    char response[512];
+    const char *request = "GET /gaming HTTP/1.1\r\n"
+                          "Upgrade: websocket\r\n"
+                          "Connection: Upgrade\r\n"
+                          "Sec-WebSocket-Version: 13\r\n\r\n";
+    websocket_config_t config = make_config();
+    start_server(&config);
+
+    int fd = connect_raw();
+    // 分成兩次送出,測試跨越 recv 的累積
+    TEST_ASSERT_EQUAL(10, socket_helper_send(fd, request, 10));
+    usleep(10000);
+    TEST_ASSERT_EQUAL((ssize_t)strlen(request) - 10,
+                      socket_helper_send(fd, request + 10, strlen(request) - 10));
+    read_response(fd, response, sizeof(response));
+    TEST_ASSERT_NOT_NULL(strstr(response, "HTTP/1.1 400 "));
+    close(fd);
+}
+
+// ========================================
+// 訊息測試
+// ========================================
+
+void test_websocket_server_echo(void) {
+    uint8_t buffer[64];
+    int opcode = 0;
+    websocket_config_t config = make_config();
+    start_server(&config);
+
+    int fd = connect_client();
+    send_frame(fd, WEBSOCKET_OPCODE_TEXT, true, "hello", 5);
+    TEST_ASSERT_EQUAL(5, recv_frame(fd, &opcode, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL(WEBSOCKET_OPCODE_TEXT, opcode);
+    TEST_ASSERT_EQUAL_MEMORY("hello", buffer, 5);
+
+    send_frame(fd, WEBSOCKET_OPCODE_BINARY, true, "\x00\x01\x02", 3);
+    TEST_ASSERT_EQUAL(3, recv_frame(fd, &opcode, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL(WEBSOCKET_OPCODE_BINARY, opcode);
+    TEST_ASSERT_EQUAL_MEMORY("\x00\x01\x02", buffer, 3);
+    close(fd);
+}
+
+void test_websocket_server_frame_split_across_reads(void) {
+    static uint8_t payload[1000];
+    static uint8_t buffer[1000];
+    uint8_t frame[1100];
+    int opcode = 0;
+    websocket_config_t config = make_config();
+    start_server(&config);
+
+    for (size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = (uint8_t)i;
+    }
+
+    int fd = connect_client();
+    size_t n = encode_client_frame(frame, WEBSOCKET_OPCODE_BINARY, true, payload, sizeof(payload));
+    // 從標頭中間切開,分兩次送出
+    TEST_ASSERT_EQUAL(3, socket_helper_send(fd, frame, 3));
+    usleep(10000);
+    TEST_ASSERT_EQUAL((ssize_t)(n - 3), socket_helper_send(fd, frame + 3, n - 3));
+
+    TEST_ASSERT_EQUAL(sizeof(payload), recv_frame(fd, &opcode, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_MEMORY(payload, buffer, sizeof(payload));
+    close(fd);
+}
+
+void test_websocket_server_frame_after_handshake_same_packet(void) {
+    char request[512];
+    char response[512];
+    uint8_t buffer[16];
+    int opcode = 0;
+    websocket_config_t config = make_config();
+    start_server(&config);
+
+    int fd = connect_raw();
+    int n = snprintf(request, sizeof(request),
+                     "GET /gaming HTTP/1.1\r\n"
+                     "Upgrade: websocket\r\n"
+                     "Connection: Upgrade\r\n"
+                     "Sec-WebSocket-Key: " TEST_KEY "\r\n"
+                     "Sec-WebSocket-Version: 13\r\n\r\n");
+    n += (int)encode_client_frame((uint8_t *)request + n, WEBSOCKET_OPCODE_TEXT, true, "early", 5);
+    TEST_ASSERT_EQUAL(n, socket_helper_send(fd, request, (size_t)n));
+
+    read_response(fd, response, sizeof(response));
+    TEST_ASSERT_NOT_NULL(strstr(response, "HTTP/1.1 101 "));
+    TEST_ASSERT_EQUAL(5, recv_frame(fd, &opcode, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_MEMORY("early", buffer, 5);
+    close(fd);
+}
+
+void test_websocket_server_partial_frame_after_handshake_same_packet(void) {
+    char request[512];
+    char response[512];
+    uint8_t frame[32];
+    uint8_t buffer[16];
+    int opcode = 0;
+    websocket_config_t config = make_config();
+    start_server(&config);
+
+    // 請求之後只帶 frame 的前 3 bytes,其餘稍後送出
+    int fd = connect_raw();
+    int n = snprintf(request, sizeof(request),
+                     "GET /gaming HTTP/1.1\r\n"
+                     "Upgrade: websocket\r\n"
+                     "Connection: Upgrade\r\n"
+                     "Sec-WebSocket-Key: " TEST_KEY "\r\n"
+                     "Sec-WebSocket-Version: 13\r\n\r\n");
+    size_t frame_len = encode_client_frame(frame, WEBSOCKET_OPCODE_TEXT, true, "late", 4);
+    memcpy(request + n, frame, 3);
+    TEST_ASSERT_EQUAL(n + 3, socket_helper_send(fd, request, (size_t)n + 3));
+
+    read_response(fd, response, sizeof(response));
+    TEST_ASSERT_NOT_NULL(strstr(response, "HTTP/1.1 101 "));
+    usleep(10000);
+    TEST_ASSERT_EQUAL((ssize_t)(frame_len - 3), socket_helper_send(fd, frame + 3, frame_len - 3));
+
+    TEST_ASSERT_EQUAL(4, recv_frame(fd, &opcode, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL(WEBSOCKET_OPCODE_TEXT, opcode);
+    TEST_ASSERT_EQUAL_MEMORY("late", buffer, 4);
+    close(fd);
+}
+
+void test_websocket_server_fragmented_message(void) {
+    uint8_t buffer[64];
+    int opcode = 0;
+    websocket_config_t config = make_config();
+    start_server(&config);
+
+    int fd = connect_client();
+    send_frame(fd, WEBSOCKET_OPCODE_TEXT, false, "frag", 4);
+    // 分段之間可以穿插控制 frame
+    send_frame(fd, WEBSOCKET_OPCODE_PING, true, "p", 1);
+    send_frame(fd, 0x0, false, "men", 3);
+    send_frame(fd, 0x0, true, "ted", 3);
+
+    TEST_ASSERT_EQUAL(1, recv_frame(fd, &opcode, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL(WEBSOCKET_OPCODE_PONG, opcode);
+    TEST_ASSERT_EQUAL(10, recv_frame(fd, &opcode, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL(WEBSOCKET_OPCODE_TEXT, opcode);
+    TEST_ASSERT_EQUAL_MEMORY("fragmented", buffer, 10);
+    TEST_ASSERT_EQUAL(1, ctx.messages);
+    close(fd);
+}
+
+void test_websocket_server_ping_pong(void) {
+    uint8_t buffer[16];
+    int opcode = 0;
+    websocket_config_t config = make_config();
+    start_server(&config);
+
+    int fd = connect_client();
+    send_frame(fd, WEBSOCKET_OPCODE_PING, true, "abc", 3);
+    TEST_ASSERT_EQUAL(3, recv_frame(fd, &opcode, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL(WEBSOCKET_OPCODE_PONG, opcode);
+    TEST_ASSERT_EQUAL_MEMORY("abc", buffer, 3);
+    TEST_ASSERT_EQUAL(0, ctx.messages);
+    close(fd);
+}
+
+void test_websocket_server_client_close(void) {
+    uint8_t code[2] = { 0x03, 0xe8 };
+    websocket_config_t config = make_config();
+    start_server(&config);
+
+    int fd = connect_client();
+    send_frame(fd, WEBSOCKET_OPCODE_CLOSE, true, code, 2);
+    assert_close_code(fd, WEBSOCKET_CLOSE_NORMAL);
+    wait_for(&ctx.closes, 1);
+    TEST_ASSERT_EQUAL(1, ctx.closes);
+    close(fd);
+}
+
+void test_websocket_server_close_from_callback(void) {
+    websocket_config_t config = make_config();
+    start_server(&config);
+
+    int fd = connect_client();
+    send_frame(fd, WEBSOCKET_OPCODE_TEXT, true, "bye", 3);
+    assert_close_code(fd, WEBSOCKET_CLOSE_GOING_AWAY);
+    close(fd);
+}
+
+// ========================================
+// 協定錯誤測試
+// ========================================
+
+void test_websocket_server_invalid_utf8_rejected(void) {
+    static const uint8_t overlong[] = { 'o', 'k', 0xc0, 0xaf };
+    static const uint8_t surrogate[] = { 0xed, 0xa0, 0x80 };
+    uint8_t buffer[16];
+    int opcode = 0;
+    websocket_config_t config = make_config();
+    start_server(&config);
+
+    int fd = connect_client();
+    send_frame(fd, WEBSOCKET_OPCODE_TEXT, true, overlong, sizeof(overlong));
+    assert_close_code(fd, WEBSOCKET_CLOSE_INVALID_DATA);
+    close(fd);
+
+    // 分段訊息在組合完成後檢查
+    fd = connect_client();
+    send_frame(fd, WEBSOCKET_OPCODE_TEXT, false, surrogate, 1);
+    send_frame(fd, 0x0, true, surrogate + 1, 2);
+    assert_close_code(fd, WEBSOCKET_CLOSE_INVALID_DATA);
+    close(fd);
+
+    // 二進位訊息不檢查
+    fd = connect_client();
+    send_frame(fd, WEBSOCKET_OPCODE_BINARY, true, overlong, sizeof(overlong));
+    TEST_ASSERT_EQUAL(sizeof(overlong), recv_frame(fd, &opcode, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL(WEBSOCKET_OPCODE_BINARY, opcode);
+    close(fd);
+    TEST_ASSERT_EQUAL(1, ctx.messages);
+}
+
+void test_websocket_server_invalid_close_code_rejected(void) {
+    static const uint8_t reserved[2] = { 0x03, 0xed };     // 1005
+    static const uint8_t too_low[2] = { 0x03, 0xe7 };      // 999
+    static const uint8_t bad_reason[3] = { 0x03, 0xe8, 0xff };
+    websocket_config_t config = make_config();
+    start_server(&config);
+
+    int fd = connect_client();
+    send_frame(fd, WEBSOCKET_OPCODE_CLOSE, true, reserved, sizeof(reserved));
+    assert_close_code(fd, WEBSOCKET_CLOSE_PROTOCOL_ERROR);
+    close(fd);
+
+    fd = connect_client();
+    send_frame(fd, WEBSOCKET_OPCODE_CLOSE, true, too_low, sizeof(too_low));
+    assert_close_code(fd, WEBSOCKET_CLOSE_PROTOCOL_ERROR);
+    close(fd);
+
+    fd = connect_client();
+    send_frame(fd, WEBSOCKET_OPCODE_CLOSE, true, too_low, 1);
+    assert_close_code(fd, WEBSOCKET_CLOSE_PROTOCOL_ERROR);
+    close(fd);
+
+    fd = connect_client();
+    send_frame(fd, WEBSOCKET_OPCODE_CLOSE, true, bad_reason, sizeof(bad_reason));
+    assert_close_code(fd, WEBSOCKET_CLOSE_PROTOCOL_ERROR);
+    close(fd);
+}
+
+void test_websocket_server_unmasked_frame_rejected(void) {
+    uint8_t frame[16];
+    websocket_config_t config = make_config();
+    start_server(&config);
+
+    int fd = connect_client();
+    size_t n = websocket_encode_header(frame, WEBSOCKET_OPCODE_TEXT, true, 2);
+    memcpy(frame + n, "hi", 2);
+    TEST_ASSERT_EQUAL((ssize_t)n + 2, socket_helper_send(fd, frame, n + 2));
+
+    assert_close_code(fd, WEBSOCKET_CLOSE_PROTOCOL_ERROR);
+    TEST_ASSERT_EQUAL(0, ctx.messages);
+    close(fd);
+}
+
+void test_websocket_server_message_too_big(void) {
+    static uint8_t payload[200];
+    websocket_config_t config = make_config();
+    config.max_message = 100;
+    start_server(&config);
+
+    int fd = connect_client();
+    send_frame(fd, WEBSOCKET_OPCODE_BINARY, true, payload, sizeof(payload));
+    assert_close_code(fd, WEBSOCKET_CLOSE_TOO_BIG);
+    close(fd);
+
+    // 分段累計超過上限也一樣
+    fd = connect_client();
+    send_frame(fd, WEBSOCKET_OPCODE_BINARY, false, payload, 60);
+    send_frame(fd, 0x0, true, payload, 60);
+    assert_close_code(fd, WEBSOCKET_CLOSE_TOO_BIG);
+    close(fd);
+    TEST_ASSERT_EQUAL(0, ctx.messages);
+}
+
+void test_websocket_server_max_clients(void) {
+    char byte;
+    websocket_config_t config = make_config();
+    config.max_clients = 2;
+    start_server(&config);
+
+    int a = connect_client();
+    int b = connect_client();
+
+    int c = connect_raw();
+    TEST_ASSERT_EQUAL(0, recv(c, &byte, 1, 0));
+    close(c);
+
+    close(a);
+    wait_for(&ctx.closes, 1);
+    c = connect_client();
+    wait_for(&ctx.opens, 3);
+    TEST_ASSERT_EQUAL(2, websocket_server_client_count(server));
+
+    close(b);
+    close(c);
+}
+
+// ========================================
+// 廣播測試
+// ========================================
+
+void test_websocket_server_broadcast(void) {
+    enum { CLIENTS = 4 };
+    int fds[CLIENTS];
+    uint8_t buffer[64];
+    int opcode = 0;
+    websocket_config_t config = make_config();
+    config.workers = 2;
+    start_server(&config);
+
+    for (int i = 0; i < CLIENTS; i++) {
+        fds[i] = connect_client();
+    }
+    wait_for(&ctx.opens, CLIENTS);
+    TEST_ASSERT_EQUAL(CLIENTS, websocket_server_client_count(server));
+
+    TEST_ASSERT_EQUAL(GAMING_OK, websocket_server_broadcast(server, WEBSOCKET_OPCODE_TEXT,
+                                                            "{\"ps5\":\"on\"}", 12));
+    for (int i = 0; i < CLIENTS; i++) {
+        TEST_ASSERT_EQUAL(12, recv_frame(fds[i], &opcode, buffer, sizeof(buffer)));
+        TEST_ASSERT_EQUAL(WEBSOCKET_OPCODE_TEXT, opcode);
+        TEST_ASSERT_EQUAL_MEMORY("{\"ps5\":\"on\"}", buffer, 12);
+        close(fds[i]);
+    }
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_INVALID_PARAM,
+                      websocket_server_broadcast(server, WEBSOCKET_OPCODE_PING, "x", 1));
+}
+
+void test_websocket_server_broadcast_drops_slow_client(void) {
+    static uint8_t payload[64 * 1024];
+    websocket_config_t config = make_config();
+    start_server(&config);
+
+    // 客戶端不讀取,伺服器端暫存超過上限後應關閉連線
+    int fd = connect_client();
+    int rcvbuf = 4096;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    wait_for(&ctx.opens, 1);
+
+    memset(payload, 'x', sizeof(payload));
+    for (int i = 0; i < 100 && __atomic_load_n(&ctx.closes, __ATOMIC_RELAXED) == 0; i++) {
+        TEST_ASSERT_EQUAL(GAMING_OK, websocket_server_broadcast(server, WEBSOCKET_OPCODE_BINARY,
+                                                                payload, sizeof(payload)));
+    }
+    wait_for(&ctx.closes, 1);
+    TEST_ASSERT_EQUAL(1, ctx.closes);
+    TEST_ASSERT_EQUAL(0, websocket_server_client_count(server));
+    close(fd);
+}
+
+void test_websocket_server_broadcast_not_started(void) {
+    websocket_config_t config = make_config();
+    server = websocket_server_create(&config);
+    TEST_ASSERT_NOT_NULL(server);
+
+    TEST_ASSERT_EQUAL(GAMING_ERROR_NOT_INITIALIZED,
+                      websocket_server_broadcast(server, WEBSOCKET_OPCODE_TEXT, "x", 1));
+}
+
+// ========================================
+// 效能測試
+// ========================================
+
+#define BENCH_MASK_SIZE     (64 * 1024)
+#define BENCH_MASK_ROUNDS   200
+#define BENCH_CLIENTS       16
+#define BENCH_BROADCASTS    200
+
+void test_websocket_mask_benchmark(void) {
+    static uint8_t data[BENCH_MASK_SIZE];
+    static const uint8_t key[4] = { 1, 2, 3, 4 };
+    char msg[128];
+
+    // 逐 byte 的基準
+    long long start = now_us();
+    for (int r = 0; r < BENCH_MASK_ROUNDS; r++) {
+        for (size_t i = 0; i < sizeof(data); i++) {
+            ((volatile uint8_t *)data)[i] ^= key[i & 3];
+        }
+    }
+    long long bytewise = now_us() - start;
+
+    start = now_us();
+    for (int r = 0; r < BENCH_MASK_ROUNDS; r++) {
+        websocket_mask(data, sizeof(data), key, (size_t)r);
+    }
+    long long word = now_us() - start;
+
+    double mb = (double)BENCH_MASK_SIZE * BENCH_MASK_ROUNDS / (1024 * 1024);
+    snprintf(msg, sizeof(msg), "mask: bytewise %.0f MB/s, word %.0f MB/s",
+             mb * 1e6 / (double)(bytewise + 1), mb * 1e6 / (double)(word + 1));
+    TEST_MESSAGE(msg);
+}
+
+void test_websocket_server_broadcast_benchmark(void) {
+    int fds[BENCH_CLIENTS];
+    uint8_t buffer[256];
+    uint8_t payload[200];
+    char msg[128];
+    int opcode = 0;
+    websocket_config_t config = make_config();
+    start_server(&config);
+
+    memset(payload, 'x', sizeof(payload));
+    for (int i = 0; i < BENCH_CLIENTS; i++) {
+        fds[i] = connect_client();
+    }
+    wait_for(&ctx.opens, BENCH_CLIENTS);
+
+    long long start = now_us();
+    for (int b = 0; b < BENCH_BROADCASTS; b++) {
+        TEST_ASSERT_EQUAL(GAMING_OK, websocket_server_broadcast(server, WEBSOCKET_OPCODE_TEXT,
+                                                                payload, sizeof(payload)));
+        for (int i = 0; i < BENCH_CLIENTS; i++) {
+            TEST_ASSERT_EQUAL(sizeof(payload), recv_frame(fds[i], &opcode, buffer, sizeof(buffer)));
+        }
+    }
+    long long elapsed = now_us() - start;
+
+    snprintf(msg, sizeof(msg), "broadcast to %d clients: %.1f us per message",
+             BENCH_CLIENTS, (double)elapsed / BENCH_BROADCASTS);
+    TEST_MESSAGE(msg);
+
+    for (int i = 0; i < BENCH_CLIENTS; i++) {
+        close(fds[i]);
+    }
+}